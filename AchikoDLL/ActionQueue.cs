@@ -0,0 +1,276 @@
+﻿// ActionQueue.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's latency-compensated action queue
+// (ActionQueue.h)
+//
+// Responsibilities:
+// • Bot logic: Enqueue the next action as soon as it is decided — the
+//   native queue picks the submit time
+// • Game event hooks: report cast starts, readiness, failures and the
+//   client's latency figure (OnCastStart / OnReady / OnFailed / OnLatency)
+// • Submit thread: blocks natively until an action is due and hands it
+//   to the submitter the combat routine installed with Start()
+// • ACTION_REPORT: idle between chained casts, reactive vs queued
+//
+// Architecture:
+// • All timing lives natively — the 500 ms bot tick could never hit a
+//   window that is one round trip wide
+// • Observations are timestamped inside RemoteAchiko on arrival, so the
+//   callers pass only what happened, never when
+//
+// Critical Design Decisions:
+// • The submitter runs on the submit thread and must only send the action
+//   (or marshal it to whichever thread can) — anything slower shows up
+//   directly as idle time
+// • A submitter returning false = the client refused locally; reported
+//   as ActionFailReason.Local so the queue neither retries nor samples RTT
+// • Missing native exports = Start() returns false, everything else no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+using AchikoDLL.IPC;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors ActionFailReason in ActionQueue.h
+    public enum ActionFailReason
+    {
+        NotReady = 1,      // server: still casting / on GCD — retried
+        Rejected = 2,      // server: any other error — dropped
+        Local = 3          // never left the client — dropped
+    }
+
+    // Mirrors ActionSubmit in ActionQueue.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ActionSubmit
+    {
+        public uint ActionId;
+        public uint Attempt;           // 1 = first try
+        public ulong Arg;
+        public ulong DueNs;
+    }
+
+    // Mirrors ActionStats in ActionQueue.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ActionStats
+    {
+        public ulong Casts;
+        public ulong Chained;
+        public ulong IdleAvgNs;
+        public ulong IdleP50Ns;
+        public ulong IdleP95Ns;
+        public ulong IdleMaxNs;
+        public ulong EarlyRejects;
+        public ulong Rejects;
+        public ulong Timeouts;
+        public ulong Retries;
+        public ulong Dropped;
+        public ulong SrttNs;
+        public ulong RttvarNs;
+        public ulong LeadNs;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ActionQueue — static API, one queue per WoW process
+    // ═══════════════════════════════════════════════════════════════
+    public static class ActionQueue
+    {
+        public const int DefaultWindowMs = 400;   // kActionDefaultWindowNs
+        private const int WaitSliceMs = 250;       // submit thread re-checks _running
+
+        private static readonly object _lock = new object();
+        private static Thread _submitThread;
+        private static volatile bool _running;
+        private static Func<uint, ulong, bool> _submit;
+        private static int _windowMs = DefaultWindowMs;
+
+        public static bool IsRunning => _running;
+        public static int WindowMs => _windowMs;
+
+        // ═══════════════════════════════════════════════════════════════
+        // LIFETIME
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — install the submitter and start the submit thread
+        //
+        // Args:
+        //   submit - (actionId, arg) → true if the client sent it
+        //
+        // Returns:
+        //   false if RemoteAchiko.dll lacks the action queue exports
+        // ───────────────────────────────────────────────────────────────
+        public static bool Start(Func<uint, ulong, bool> submit)
+        {
+            if (submit == null)
+                throw new ArgumentNullException(nameof(submit));
+
+            lock (_lock)
+            {
+                _submit = submit;
+                if (_running)
+                    return true;
+
+                try { NativeMethods.AchikoActionSetWindow(_windowMs); }
+                catch (Exception) { return false; }   // DllNotFound / EntryPointNotFound
+
+                _running = true;
+                _submitThread = new Thread(SubmitLoop)
+                {
+                    IsBackground = true,
+                    Name = "AchikoDLL ActionQueue (Submit)",
+                    Priority = ThreadPriority.Highest
+                };
+                _submitThread.Start();
+                return true;
+            }
+        }
+
+        public static void Stop()
+        {
+            lock (_lock)
+            {
+                if (!_running)
+                    return;
+
+                _running = false;
+                try { NativeMethods.AchikoActionCancel(); }
+                catch (Exception) { }
+                _submitThread?.Join(2 * WaitSliceMs + 1000);
+                _submitThread = null;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // SetWindow — maximum lead before readiness; 0 = reactive (submit
+        // only once the client reports readiness — the comparison mode)
+        // ───────────────────────────────────────────────────────────────
+        public static bool SetWindow(int windowMs)
+        {
+            _windowMs = Math.Max(0, windowMs);
+            try
+            {
+                NativeMethods.AchikoActionSetWindow(_windowMs);
+                return true;
+            }
+            catch (Exception) { return false; }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // DECISIONS + OBSERVATIONS
+        // ═══════════════════════════════════════════════════════════════
+
+        // Replaces any queued action that has not been submitted yet
+        public static void Enqueue(uint actionId, ulong arg)
+        {
+            if (_running)
+                NativeMethods.AchikoActionEnqueue(actionId, arg);
+        }
+
+        public static void Cancel()
+        {
+            if (_running)
+                NativeMethods.AchikoActionCancel();
+        }
+
+        // A cast (castMs > 0) or instant (castMs = 0) started on the client
+        public static void OnCastStart(uint actionId, int castMs, int gcdMs)
+        {
+            if (_running)
+                NativeMethods.AchikoActionCastStart(actionId, castMs, gcdMs);
+        }
+
+        // Cast bar finished / GCD over
+        public static void OnReady()
+        {
+            if (_running)
+                NativeMethods.AchikoActionReady();
+        }
+
+        public static void OnFailed(uint actionId, ActionFailReason reason)
+        {
+            if (_running)
+                NativeMethods.AchikoActionFailed(actionId, (int)reason);
+        }
+
+        // The client's own round-trip figure, whenever it updates
+        public static void OnLatency(int rttMs)
+        {
+            if (_running)
+                NativeMethods.AchikoActionLatency(rttMs);
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORTING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — idle between chained casts, before (reactive) vs after
+        // (queued); null if the native queue is unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            ActionStats reactive, queued;
+            try
+            {
+                NativeMethods.AchikoActionStats(0, out reactive);
+                NativeMethods.AchikoActionStats(1, out queued);
+            }
+            catch (Exception) { return null; }
+
+            return new[]
+            {
+                $"window {_windowMs} ms ({(_windowMs > 0 ? "queued" : "reactive")}), submitter {(_running ? "running" : "not started")}, " +
+                    $"RTT {queued.SrttNs / 1e6:F1} ± {queued.RttvarNs / 1e6:F1} ms, lead {queued.LeadNs / 1e6:F1} ms",
+                FormatMode("before (reactive)", ref reactive),
+                FormatMode("after  (queued)  ", ref queued)
+            };
+        }
+
+        public static void ResetStats()
+        {
+            try { NativeMethods.AchikoActionResetStats(); }
+            catch (Exception) { }
+        }
+
+        private static string FormatMode(string label, ref ActionStats s)
+        {
+            return $"{label}: {s.Chained}/{s.Casts} chained casts, idle avg {s.IdleAvgNs / 1e6:F1} ms, " +
+                   $"p50 {s.IdleP50Ns / 1e6:F1} ms, p95 {s.IdleP95Ns / 1e6:F1} ms, max {s.IdleMaxNs / 1e6:F1} ms; " +
+                   $"early {s.EarlyRejects}, rejected {s.Rejects}, timeouts {s.Timeouts}, retries {s.Retries}, dropped {s.Dropped}";
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // SUBMIT THREAD
+        // ═══════════════════════════════════════════════════════════════
+
+        private static void SubmitLoop()
+        {
+            ActionSubmit action;
+
+            while (_running)
+            {
+                try
+                {
+                    if (NativeMethods.AchikoActionWait(out action, WaitSliceMs) == 0)
+                        continue;
+
+                    if (!_submit(action.ActionId, action.Arg))
+                        NativeMethods.AchikoActionFailed(action.ActionId, (int)ActionFailReason.Local);
+                }
+                catch (Exception ex)
+                {
+                    PipeClient.Log($"[ActionQueue] Submit error: {ex.Message}");
+                }
+            }
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
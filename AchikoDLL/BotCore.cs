@@ -14,8 +14,21 @@
 // Architecture:
 // • One thread per BotCore instance
 // • ManualResetEvent used for enable/disable signaling
-// • Tick interval fixed at 500ms for lightweight heartbeat
+// • Tick interval from bot.tick_ms (Config, default 500ms) — picked up
+//   mid-session when the config file is edited
 // • PipeClient used for all inter-process logging
+// • Tick phases traced as tick.wait / tick / tick.sleep (Tracer)
+// • Bot thread registered with the sampling profiler (Profiler)
+// • Heartbeat every iteration — the native watchdog reports a stuck loop
+//   with its stack (Watchdog); the hang timeout follows bot.tick_ms
+// • Every tick bracketed by GcScheduler.TickBegin / TickEnd — full GCs are
+//   steered out of combat ticks into the idle window after them
+// • Ticks publish the decision → effect latency summary (EffectLatency)
+// • Native per-tick results (TickArena spans) are released at tick end
+// • Hooks over their frame budget are logged once a second (HookMeter);
+//   budgets follow config reloads
+// • Watched calls of filtered game hooks are delivered once per tick
+//   (HookFilter.Drain), before the arena releases them
 //
 // Critical Design Decisions:
 // • Thread remains alive after Stop() for instant re-enable
@@ -26,6 +39,7 @@
 
 using System;
 using System.Threading;
+using AchikoDLL.Diagnostics;
 using AchikoDLL.IPC;
 
 namespace AchikoDLL
@@ -42,14 +56,43 @@ namespace AchikoDLL
         private Thread _botThread;                   // Background thread running BotLoop
         private volatile bool _running;              // True while thread is alive
         private volatile bool _enabledByUI;          // True if UI has enabled the bot
+        private volatile bool _inCombat;             // Combat state for GC steering
         private readonly ManualResetEvent _enabledEvent = new ManualResetEvent(false);
 
+        // Thread name in traces, profiles and hang reports
+        private const string LoopName = "AchikoBotCore Main Loop";
+
+        // ───────────────────────────────────────────────────────────────
+        // Trace span ids (0 if tracing unavailable)
+        // ───────────────────────────────────────────────────────────────
+        private static readonly ushort TraceTickWait = Tracer.Register("tick.wait", TraceCategory.Tick);
+        private static readonly ushort TraceTick = Tracer.Register("tick", TraceCategory.Tick);
+        private static readonly ushort TraceTickSleep = Tracer.Register("tick.sleep", TraceCategory.Tick);
+
+        // ───────────────────────────────────────────────────────────────
+        // Settings (Achiko.cfg)
+        // ───────────────────────────────────────────────────────────────
+        private static readonly ConfigKey TickIntervalMs = new ConfigKey("bot.tick_ms");
+
         // ───────────────────────────────────────────────────────────────
         // Public properties
         // ───────────────────────────────────────────────────────────────
         public bool IsEnabled => _enabledByUI;
         public bool IsRunning => _botThread != null && _botThread.IsAlive;
 
+        // ───────────────────────────────────────────────────────────────
+        // InCombat — combat state, read once per tick
+        //
+        // Notes:
+        //   Set by the COMBAT_ON / COMBAT_OFF commands until combat
+        //   detection reads the player's unit flags
+        // ───────────────────────────────────────────────────────────────
+        public bool InCombat
+        {
+            get { return _inCombat; }
+            set { _inCombat = value; }
+        }
+
         // ═══════════════════════════════════════════════════════════════
         // INITIALIZATION
         // ═══════════════════════════════════════════════════════════════
@@ -100,7 +143,7 @@ namespace AchikoDLL
                 _botThread = new Thread(BotLoop)
                 {
                     IsBackground = true,
-                    Name = "AchikoBotCore Main Loop",
+                    Name = LoopName,
                     Priority = ThreadPriority.AboveNormal
                 };
                 _botThread.Start();
@@ -148,7 +191,7 @@ namespace AchikoDLL
             if (_botThread != null && _botThread.IsAlive)
             {
                 if (!_botThread.Join(3000))
-                    PipeClient.Log("[BotCore] WARNING: Bot thread did not exit in 3s — abandoning");
+                    PipeClient.Log("[BotCore] WARNING: Bot thread did not exit in 3s — abandoning (the watchdog reports its stack if it stays stuck)");
                 else
                     PipeClient.Log("[BotCore] Bot thread terminated gracefully");
             }
@@ -168,33 +211,95 @@ namespace AchikoDLL
         //   • Skips logic if disabled
         //   • Auto-disables if pipe is broken
         //   • Logs each tick
-        //   • Sleeps 500ms between iterations
+        //   • Sleeps bot.tick_ms (50-5000, default 500ms) between iterations
         // ───────────────────────────────────────────────────────────────
         private void BotLoop()
         {
             PipeClient.Log("[BotCore] >>> Bot thread running — waiting for UI enable <<<");
+            Tracer.NameThread(LoopName);
+            Profiler.RegisterCurrentThread(LoopName);
+            int tickMs = Config.Int(TickIntervalMs, 500, 50, 5000);
+            int heartbeatTimeoutMs = HeartbeatTimeoutMs(tickMs);
+            Heartbeat heartbeat = Watchdog.RegisterCurrentThread(LoopName, heartbeatTimeoutMs);
 
             while (_running)
             {
+                heartbeat.Beat();
+
+                // bot.tick_ms can change mid-session — a long tick must not
+                // read as a hang, so re-register with a matching timeout
+                tickMs = Config.Int(TickIntervalMs, 500, 50, 5000);
+                if (HeartbeatTimeoutMs(tickMs) != heartbeatTimeoutMs)
+                {
+                    heartbeatTimeoutMs = HeartbeatTimeoutMs(tickMs);
+                    Watchdog.UnregisterCurrentThread();
+                    heartbeat = Watchdog.RegisterCurrentThread(LoopName, heartbeatTimeoutMs);
+                    heartbeat.Beat();
+                }
+
                 try
                 {
                     // Wait for enable signal (timeout for responsiveness)
-                    _enabledEvent.WaitOne(500);
+                    using (Tracer.Span(TraceTickWait))
+                        _enabledEvent.WaitOne(500);
 
                     if (!_running) break;
 
                     if (_enabledByUI)
                     {
-                        if (PipeClient.IsBroken)
+                        GcScheduler.TickBegin(_inCombat);
+                        try
                         {
-                            PipeClient.Log("[BotCore] CRITICAL: Pipe broken — auto-disabling bot");
-                            _enabledByUI = false;
-                            _enabledEvent.Reset();
-                            continue;
+                            using (Tracer.Span(TraceTick))
+                            {
+                                if (PipeClient.IsBroken)
+                                {
+                                    PipeClient.Log("[BotCore] CRITICAL: Pipe broken — auto-disabling bot");
+                                    _enabledByUI = false;
+                                    _enabledEvent.Reset();
+                                    continue;
+                                }
+
+                                // Heartbeat tick — actual bot logic placeholder
+                                // (non-critical and allocating: skipped while a full GC is imminent)
+                                if (!GcScheduler.GcImminent)
+                                    PipeClient.Log(_inCombat ? "[BotCore] Tick (combat)" : "[BotCore] Tick");
+
+                                // Edited settings went live (values are re-read lazily)
+                                if (Config.Poll())
+                                {
+                                    PipeClient.Log($"[BotCore] Config generation {Config.Generation} live — " +
+                                                   $"tick {Config.Int(TickIntervalMs, 500, 50, 5000)}ms");
+                                    HookMeter.ApplyBudgets();
+                                }
+
+                                // Hook budget alarms for Achikobuddy (every 1 s)
+                                HookMeter.PublishIfDue();
+
+                                // Decision → effect summary for Achikobuddy (every 5 s)
+                                EffectLatency.PublishIfDue();
+
+                                // Managed heap size in, trim requests out; address-space
+                                // summary for Achikobuddy (every 10 s / on pressure change)
+                                MemoryBudget.Tick();
+                                MemoryBudget.PublishIfDue();
+
+                                // Watched hook calls since the last tick, one batch
+                                HookFilter.Drain();
+                            }
                         }
+                        finally
+                        {
+                            // Snapshot spans taken this tick are stale from here
+                            TickArena.EndTick();
 
-                        // Heartbeat tick — actual bot logic placeholder
-                        PipeClient.Log("[BotCore] Tick");
+                            // Idle window — a deferred full GC may run here
+                            GcScheduler.TickEnd();
+                        }
+                    }
+                    else
+                    {
+                        GcScheduler.BotIdle();
                     }
                 }
                 catch (ThreadInterruptedException)
@@ -207,12 +312,22 @@ namespace AchikoDLL
                     PipeClient.Log($"[BotCore] Exception in BotLoop → {ex}");
                 }
 
-                Thread.Sleep(500); // Tick interval
+                using (Tracer.Span(TraceTickSleep))
+                    Thread.Sleep(tickMs); // Tick interval
             }
 
+            Watchdog.UnregisterCurrentThread();
+            Profiler.UnregisterCurrentThread();
             PipeClient.Log("[BotCore] Bot thread EXITED");
         }
 
+        // Silence that counts as a hang: three iterations (enable wait +
+        // tick + sleep), never below the watchdog default
+        private static int HeartbeatTimeoutMs(int tickMs)
+        {
+            return Math.Max(Watchdog.DefaultTimeoutMs, 3 * tickMs + 500);
+        }
+
         // ═══════════════════════════════════════════════════════════════
         // END OF BotCore.cs
         // ═══════════════════════════════════════════════════════════════
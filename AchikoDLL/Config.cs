@@ -0,0 +1,330 @@
+﻿// Config.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's hot-reloaded settings / offsets file
+// (ConfigStore.h)
+//
+// Responsibilities:
+// • Open() / Close(): watch Achiko.cfg (text) and Achiko.cfg.bin (compiled)
+//   next to AchikoDLL.dll
+// • Int() / Float() / Text(): typed reads by ConfigKey, with a fallback
+//   when the key is missing or there is no config
+// • Poll(): bot thread, once per tick — true when a new generation went
+//   live since the last call
+// • Reload() / Report(): CONFIG_RELOAD / CONFIG_REPORT
+//
+// Architecture:
+// • The values stay in the native mapping. A ConfigKey caches what it
+//   resolved to together with the generation it saw; a read is one load
+//   of the native generation word (through a pointer, no P/Invoke) and a
+//   compare. Only after a reload does the next read of each key binary
+//   search the new image
+// • Text format — sections prefix the names ("[bot]" + "tick_ms" =
+//   "bot.tick_ms"):
+//       [bot]
+//       tick_ms = 250                 # int
+//       [offsets]
+//       object_manager = 0x00B41414   # hex int
+//       [combat]
+//       rest_below = 0.45             # float
+//       name = "Achiko"               # string; true / false = 1 / 0
+//
+// Critical Design Decisions:
+// • Keys are hashed once, when the ConfigKey is created (static readonly
+//   fields) — same FNV-1a 64 over the UTF-8 name as ConfigKeyHash
+// • A key resolves to an immutable snapshot swapped in by reference, so
+//   reads from any thread see a consistent type / value pair
+// • Editing the text mid-session takes effect within ~0.5 s; a typo is
+//   rejected whole and logged by Report(), the old values stay live
+// • Missing native exports = every read returns its fallback
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors ConfigViewInfo in ConfigStore.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ConfigView
+    {
+        public ulong Entries;              // const ConfigEntry* (0 = no config)
+        public ulong Strings;              // string pool
+        public uint Count;
+        public uint StringBytes;
+        public uint Generation;
+        public uint Reserved;
+    }
+
+    // Mirrors ConfigStats in ConfigStore.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ConfigStats
+    {
+        public ulong Reloads;
+        public ulong Compiles;
+        public ulong Rejected;
+        public ulong LastReloadNs;
+        public ulong LastCompileNs;
+        public ulong MappedBytes;
+        public uint Generation;
+        public uint Entries;
+        public uint Retired;               // old images still mapped
+        public uint Reserved;
+    }
+
+    // Mirrors ConfigType in ConfigStore.h
+    public enum ConfigType : uint
+    {
+        Missing = 0,
+        Int = 1,
+        Float = 2,
+        String = 3
+    }
+
+    // Mirrors ConfigEntry in ConfigStore.h (read in place)
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct ConfigEntry
+    {
+        public ulong Key;
+        public ConfigType Type;
+        public uint Name;
+        public long Value;                 // int64 / double bits / pool offset
+        public uint Length;
+        public uint Reserved;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ConfigKey — a setting name, hashed once
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class ConfigKey
+    {
+        public readonly string Name;
+        internal readonly ulong Hash;
+        internal volatile ConfigValue Current;   // null until first read
+
+        public ConfigKey(string name)
+        {
+            Name = name;
+            Hash = Config.HashName(name);
+        }
+
+        public override string ToString() => Name;
+    }
+
+    // What a key resolved to in one generation
+    internal sealed class ConfigValue
+    {
+        public uint Generation;
+        public ConfigType Type;
+        public long Value;
+        public string Text;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // Config — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class Config
+    {
+        public const string TextFileName = "Achiko.cfg";
+        public const string BinaryFileName = "Achiko.cfg.bin";
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static volatile bool _open;
+        private static IntPtr _generationAddress;          // native uint, lives as long as the DLL
+        private static ConfigView _view;                   // guarded by _viewLock
+        private static readonly object _viewLock = new object();
+        private static uint _polled;                       // bot thread (Poll)
+
+        public static bool IsOpen => _open;
+
+        // Moves on every reload; 0 = no config was ever mapped
+        public static unsafe uint Generation =>
+            _generationAddress == IntPtr.Zero ? 0 : *(uint*)_generationAddress;
+
+        // ───────────────────────────────────────────────────────────────
+        // Open — map the config next to AchikoDLL.dll and start watching
+        //
+        // Returns:
+        //   false if exports are missing; a missing config file is fine
+        //   (every read returns its fallback until one appears)
+        // ───────────────────────────────────────────────────────────────
+        public static bool Open()
+        {
+            if (!_available || _open) return _open;
+
+            string dir = System.IO.Path.GetDirectoryName(typeof(Config).Assembly.Location);
+            try
+            {
+                _generationAddress = NativeMethods.AchikoConfigGenerationAddress();
+                _open = NativeMethods.AchikoConfigOpen(
+                    System.IO.Path.Combine(dir, BinaryFileName),
+                    System.IO.Path.Combine(dir, TextFileName)) != 0;
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                _generationAddress = IntPtr.Zero;
+            }
+            _polled = Generation;
+            return _open;
+        }
+
+        // Unmaps the config; keys fall back to their defaults
+        public static void Close()
+        {
+            if (!_open) return;
+            _open = false;
+            NativeMethods.AchikoConfigClose();
+        }
+
+        // Check the files now instead of at the next watcher poll
+        public static bool Reload()
+        {
+            return _open && NativeMethods.AchikoConfigReload() != 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Poll — bot thread, once per tick
+        //
+        // Returns:
+        //   true on the first call after a new generation went live
+        // ───────────────────────────────────────────────────────────────
+        public static bool Poll()
+        {
+            uint generation = Generation;
+            if (generation == _polled) return false;
+            _polled = generation;
+            return true;
+        }
+
+        public static bool Has(ConfigKey key) => Lookup(key).Type != ConfigType.Missing;
+
+        public static long Int(ConfigKey key, long fallback)
+        {
+            ConfigValue v = Lookup(key);
+            switch (v.Type)
+            {
+                case ConfigType.Int: return v.Value;
+                case ConfigType.Float: return (long)BitConverter.Int64BitsToDouble(v.Value);
+                default: return fallback;
+            }
+        }
+
+        // Int clamped to [min, max] — tick rates, thresholds
+        public static int Int(ConfigKey key, int fallback, int min, int max)
+        {
+            long value = Int(key, fallback);
+            return (int)Math.Max(min, Math.Min(max, value));
+        }
+
+        public static double Float(ConfigKey key, double fallback)
+        {
+            ConfigValue v = Lookup(key);
+            switch (v.Type)
+            {
+                case ConfigType.Int: return v.Value;
+                case ConfigType.Float: return BitConverter.Int64BitsToDouble(v.Value);
+                default: return fallback;
+            }
+        }
+
+        public static string Text(ConfigKey key, string fallback)
+        {
+            ConfigValue v = Lookup(key);
+            return v.Type == ConfigType.String ? v.Text : fallback;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — CONFIG_REPORT lines; null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available || !_open) return null;
+
+            ConfigStats s;
+            NativeMethods.AchikoConfigStats(out s);
+            var error = new StringBuilder(256);
+            NativeMethods.AchikoConfigLastError(error, error.Capacity);
+
+            return new[]
+            {
+                s.Generation == 0
+                    ? $"no config yet — write {TextFileName} next to AchikoDLL.dll"
+                    : $"generation {s.Generation}: {s.Entries} entries, {s.MappedBytes} bytes mapped, " +
+                      $"{s.Retired} retired images still mapped",
+                $"{s.Reloads} reloads (last live in {s.LastReloadNs / 1000.0:F0} µs), " +
+                    $"{s.Compiles} text compiles (last {s.LastCompileNs / 1000.0:F0} µs), {s.Rejected} rejected",
+                error.Length == 0 ? "last edit accepted" : "last edit rejected, old values kept: " + error
+            };
+        }
+
+        // FNV-1a 64 over the UTF-8 name — must match ConfigKeyHash
+        internal static ulong HashName(string name)
+        {
+            ulong hash = 14695981039346656037UL;
+            foreach (byte b in Encoding.UTF8.GetBytes(name ?? ""))
+            {
+                hash ^= b;
+                hash *= 1099511628211UL;
+            }
+            return hash;
+        }
+
+        private static ConfigValue Lookup(ConfigKey key)
+        {
+            uint generation = Generation;
+            ConfigValue current = key.Current;
+            if (current != null && current.Generation == generation)
+                return current;
+            return Resolve(key, generation);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Resolve — binary search the current image for key
+        //
+        // Notes:
+        //   • The view is refreshed only when the generation moved; a
+        //     swap between refresh and search is harmless (the old image
+        //     stays mapped for seconds) — the next read sees the newer
+        //     generation and resolves again
+        // ───────────────────────────────────────────────────────────────
+        private static unsafe ConfigValue Resolve(ConfigKey key, uint generation)
+        {
+            var value = new ConfigValue { Generation = generation };
+            lock (_viewLock)
+            {
+                if (_available && _generationAddress != IntPtr.Zero && _view.Generation != generation)
+                    NativeMethods.AchikoConfigView(out _view);
+                value.Generation = _view.Generation;
+
+                var entries = (ConfigEntry*)_view.Entries;
+                int lo = 0, hi = (int)_view.Count - 1;
+                while (entries != null && lo <= hi)
+                {
+                    int mid = (lo + hi) >> 1;
+                    ulong k = entries[mid].Key;
+                    if (k < key.Hash) lo = mid + 1;
+                    else if (k > key.Hash) hi = mid - 1;
+                    else
+                    {
+                        value.Type = entries[mid].Type;
+                        value.Value = entries[mid].Value;
+                        if (value.Type == ConfigType.String)
+                            value.Text = new string((sbyte*)_view.Strings + value.Value, 0,
+                                                    (int)entries[mid].Length, Encoding.UTF8);
+                        break;
+                    }
+                }
+            }
+            key.Current = value;
+            return value;
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
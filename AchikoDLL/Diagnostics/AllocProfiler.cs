@@ -0,0 +1,97 @@
+﻿// AllocProfiler.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for the CLR allocation profiler (AllocProfiler.h)
+//
+// Responsibilities:
+// • Tell whether the bootstrapper loaded the allocation profiler
+// • Reset the measurement window (PROFILE_ON)
+// • Fetch the top-allocator report for the UI log (ALLOC_REPORT)
+//
+// Architecture:
+// • The profiler itself is native and was attached by RemoteAchiko.dll
+//   before the CLR started — only when the launcher's "Profile
+//   allocations" box was ticked
+// • Sampling: one sample per ~64 KB allocated per thread, attributed to
+//   (type, allocating method, caller)
+//
+// Critical Design Decisions:
+// • The report is one UTF-8 block copied into a reused buffer; the
+//   caller logs it line by line
+// • Missing native exports = profiler off, same as Tracer / Profiler
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Text;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // ═══════════════════════════════════════════════════════════════
+    // AllocProfiler — static allocation-profiler API
+    // ═══════════════════════════════════════════════════════════════
+    public static class AllocProfiler
+    {
+        private const int ReportCapacity = 16 * 1024;
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static readonly object _reportLock = new object();
+        private static byte[] _reportBuffer;               // guarded by _reportLock
+
+        // ───────────────────────────────────────────────────────────────
+        // IsActive — profiler loaded by the CLR and sampling
+        // ───────────────────────────────────────────────────────────────
+        public static bool IsActive
+        {
+            get
+            {
+                if (!_available) return false;
+
+                try { return NativeMethods.AchikoAllocIsActive() != 0; }
+                catch (Exception)
+                {
+                    // DllNotFoundException / EntryPointNotFoundException
+                    _available = false;
+                    return false;
+                }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Reset — start a new measurement window
+        // ───────────────────────────────────────────────────────────────
+        public static void Reset()
+        {
+            if (!IsActive) return;
+
+            try { NativeMethods.AchikoAllocReset(); }
+            catch (Exception) { _available = false; }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — top allocators since the last Reset
+        //
+        // Returns:
+        //   Report lines (summary first), or an empty array if inactive
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report(int topN)
+        {
+            if (!IsActive) return new string[0];
+
+            lock (_reportLock)
+            {
+                if (_reportBuffer == null)
+                    _reportBuffer = new byte[ReportCapacity];
+
+                int length;
+                try { length = NativeMethods.AchikoAllocReport(_reportBuffer, _reportBuffer.Length, topN); }
+                catch (Exception) { return new string[0]; }
+
+                if (length <= 0) return new string[0];
+
+                return Encoding.UTF8.GetString(_reportBuffer, 0, length)
+                    .Split(new[] { '\n' }, StringSplitOptions.RemoveEmptyEntries);
+            }
+        }
+    }
+}
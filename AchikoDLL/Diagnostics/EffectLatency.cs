@@ -0,0 +1,223 @@
+﻿// EffectLatency.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's decision-to-effect tracker
+// (EffectTracker.h)
+//
+// Responsibilities:
+// • Decide(): stamp a decision where the bot makes it, keep the token
+// • Dispatched() / Executed(): optional stamps where the action leaves
+//   the bot's queue and where the game thread runs it
+// • Observe(): feed every player snapshot — the native side finds the
+//   decisions it completes (cast started, moved, target changed)
+// • Publish a one-line summary every 5 s — Achikobuddy shows it live and
+//   it lands in the session log with everything else
+//
+// Architecture:
+// • Matching, timing and histograms are native; this class only forwards
+//   tokens and formats reports
+// • Summary lines start with "[Effect] " — Main.xaml.cs picks them out of
+//   the log stream like it does pipe health
+//
+// Critical Design Decisions:
+// • Tokens are plain uints — safe to carry through queues and across
+//   threads, stale ones are ignored natively
+// • Nothing is published while no decision completed since the last line
+// • Missing native exports = Decide() returns 0, everything else no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using AchikoDLL.IPC;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // Mirrors EffectKind in EffectTracker.h
+    public enum EffectKind
+    {
+        Cast = 0,          // expect = spell id
+        Move = 1,          // expect unused
+        Target = 2         // expect = target GUID
+    }
+
+    // Mirrors EffectSnapshot in EffectTracker.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct EffectSnapshot
+    {
+        public ulong CastId;           // 0 = not casting
+        public ulong TargetGuid;
+        public float X;
+        public float Y;
+        public float Z;
+        public uint Reserved;
+    }
+
+    // Mirrors EffectKindStats in EffectTracker.h — per-stage arrays are
+    // queue, handoff, response, total
+    [StructLayout(LayoutKind.Sequential)]
+    public struct EffectKindStats
+    {
+        public ulong Completed;
+        public ulong Expired;
+        public ulong Pending;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)] public ulong[] Count;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)] public ulong[] P50Ns;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)] public ulong[] P90Ns;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)] public ulong[] P99Ns;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)] public ulong[] MaxNs;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // EffectLatency — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class EffectLatency
+    {
+        public const int PublishIntervalMs = 5000;
+
+        private const int StageQueue = 0;
+        private const int StageHandoff = 1;
+        private const int StageResponse = 2;
+        private const int StageTotal = 3;
+
+        private static readonly string[] KindNames = { "cast", "move", "target" };
+        private static readonly string[] StageNames = { "queue", "handoff", "response", "total" };
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static long _lastPublishTicks;              // bot thread only
+        private static ulong _lastPublishedCompleted;
+
+        // ═══════════════════════════════════════════════════════════════
+        // STAMPS
+        // ═══════════════════════════════════════════════════════════════
+
+        // Returns the decision's token (0 = not tracked)
+        public static uint Decide(EffectKind kind, ulong expect)
+        {
+            if (!_available) return 0;
+
+            try { return NativeMethods.AchikoEffectDecide((int)kind, expect); }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return 0;
+            }
+        }
+
+        public static void Dispatched(uint token)
+        {
+            if (_available && token != 0)
+                NativeMethods.AchikoEffectDispatched(token);
+        }
+
+        public static void Executed(uint token)
+        {
+            if (_available && token != 0)
+                NativeMethods.AchikoEffectExecuted(token);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Observe — one player snapshot
+        //
+        // Args:
+        //   takenTimestamp - Stopwatch.GetTimestamp() when it was read
+        //                    (0 = now); processing delay is not latency
+        // ───────────────────────────────────────────────────────────────
+        public static int Observe(ref EffectSnapshot snapshot, long takenTimestamp)
+        {
+            if (!_available) return 0;
+            return NativeMethods.AchikoEffectObserve(ref snapshot, takenTimestamp);
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORTING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // PublishIfDue — once per PublishIntervalMs, log the summary line
+        // if any decision completed since the last one (bot thread)
+        // ───────────────────────────────────────────────────────────────
+        public static void PublishIfDue()
+        {
+            if (!_available) return;
+
+            long now = Stopwatch.GetTimestamp();
+            if (now - _lastPublishTicks < Stopwatch.Frequency * PublishIntervalMs / 1000)
+                return;
+            _lastPublishTicks = now;
+
+            ulong completed = 0;
+            var stats = new EffectKindStats[KindNames.Length];
+            for (int k = 0; k < KindNames.Length; k++)
+            {
+                NativeMethods.AchikoEffectStats(k, out stats[k]);
+                completed += stats[k].Completed;
+            }
+
+            if (completed == _lastPublishedCompleted)
+                return;
+            _lastPublishedCompleted = completed;
+
+            PipeClient.Log("[Effect] " + Summary(stats));
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — full per-kind, per-stage distribution (EFFECT_REPORT);
+        // null if the tracker is unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            var lines = new string[KindNames.Length * (StageNames.Length + 1)];
+            int n = 0;
+            for (int k = 0; k < KindNames.Length; k++)
+            {
+                EffectKindStats s;
+                NativeMethods.AchikoEffectStats(k, out s);
+                lines[n++] = $"{KindNames[k]}: {s.Completed} completed, {s.Expired} without effect, {s.Pending} open";
+
+                for (int stage = 0; stage < StageNames.Length; stage++)
+                {
+                    lines[n++] = $"  {StageNames[stage],-8} n={s.Count[stage]}  p50 {Ms(s.P50Ns[stage])}  " +
+                                 $"p90 {Ms(s.P90Ns[stage])}  p99 {Ms(s.P99Ns[stage])}  max {Ms(s.MaxNs[stage])} ms";
+                }
+            }
+            return lines;
+        }
+
+        public static void Reset()
+        {
+            if (!_available) return;
+            NativeMethods.AchikoEffectReset();
+            _lastPublishedCompleted = 0;
+        }
+
+        // "cast 12: 85.0/120.0 ms (q 2.0 · h 16.5 · r 66.0) | ..." — p50 / p90
+        // total, then p50 per stage
+        private static string Summary(EffectKindStats[] stats)
+        {
+            var parts = new string[stats.Length];
+            for (int k = 0; k < stats.Length; k++)
+            {
+                EffectKindStats s = stats[k];
+                parts[k] = s.Completed == 0
+                    ? $"{KindNames[k]} –"
+                    : $"{KindNames[k]} {s.Completed}: {Ms(s.P50Ns[StageTotal])}/{Ms(s.P90Ns[StageTotal])} ms " +
+                      $"(q {Ms(s.P50Ns[StageQueue])} · h {Ms(s.P50Ns[StageHandoff])} · r {Ms(s.P50Ns[StageResponse])})";
+            }
+            return string.Join(" | ", parts);
+        }
+
+        private static string Ms(ulong ns)
+        {
+            return (ns / 1e6).ToString("F1");
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,267 @@
+﻿// HookMeter.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's hook cost accounting (HookMeter.h)
+//
+// Responsibilities:
+// • Register(): name a hook, get its id; the per-frame budget comes from
+//   Achiko.cfg ("hooks.budget_us", or "hooks.<name>.budget_us")
+// • Measure(): time one invocation of a managed hook body (GreyMagic
+//   detour handler) — `using (HookMeter.Measure(id)) { ... }`
+// • PublishIfDue(): bot thread — log hooks that went over budget since
+//   the last line, at most once per PublishIntervalMs
+// • Report() / Reset(): HOOK_REPORT / HOOK_RESET
+//
+// Architecture:
+// • Counting, frame accounting and alarms are native: per-thread counter
+//   blocks, summed when read. Native stubs record with HookScope and
+//   never cross into managed code to do it
+// • A managed hook body is one native → managed transition per call;
+//   Measure() reports it with the Stopwatch timestamps it took
+//
+// Critical Design Decisions:
+// • Measure() is a struct — no allocation in the hook
+// • Budgets are re-read when the config generation moves (ApplyBudgets,
+//   from BotCore) — tuning an alarm needs no reattach
+// • Without a frame hook (Register(..., frameHook: true)) there are no
+//   frames: totals and µs per second only, no alarms
+// • Missing native exports = Register() returns 0, everything no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using AchikoDLL.IPC;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // Mirrors HookStats in HookMeter.h
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct HookStats
+    {
+        public ulong Invocations;
+        public ulong TotalNs;
+        public ulong MaxNs;
+        public ulong Transitions;
+        public ulong Frames;
+        public ulong WorstFrameNs;
+        public ulong Alarms;
+        public ulong LastAlarmFrame;
+        public uint Id;
+        public uint BudgetUs;
+        public uint Flags;
+        public uint Threads;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 32)]
+        public string Name;
+    }
+
+    // Mirrors HookMeterSummary in HookMeter.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct HookMeterSummary
+    {
+        public ulong Frames;
+        public ulong HookNs;
+        public ulong WorstFrameNs;
+        public ulong SinceNs;
+        public ulong Alarms;
+        public ulong Dropped;
+        public uint Hooks;
+        public uint Threads;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // HookTiming — one managed hook invocation (Measure)
+    // ═══════════════════════════════════════════════════════════════
+    public struct HookTiming : IDisposable
+    {
+        private readonly uint _id;
+        private readonly long _start;
+
+        internal HookTiming(uint id)
+        {
+            _id = id;
+            _start = id != 0 ? Stopwatch.GetTimestamp() : 0;
+        }
+
+        public void Dispose()
+        {
+            if (_id != 0)
+                NativeMethods.AchikoHookRecord(_id, (ulong)_start, (ulong)Stopwatch.GetTimestamp(), 1);
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // HookMeter — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class HookMeter
+    {
+        public const int PublishIntervalMs = 1000;
+        public const int MaxHooks = 64;                    // kHookMaxHooks
+        private const int FrameFlag = 1;                   // HookFlag_Frame
+        private const long DefaultBudgetFallbackUs = 200;  // kHookDefaultBudgetUs
+
+        private static readonly ConfigKey DefaultBudgetUs = new ConfigKey("hooks.budget_us");
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static readonly object _lock = new object();
+        private static readonly Dictionary<uint, ConfigKey> _budgetKeys = new Dictionary<uint, ConfigKey>();
+        private static readonly ulong[] _publishedAlarms = new ulong[MaxHooks];   // bot thread
+        private static long _lastPublishTicks;
+
+        // ───────────────────────────────────────────────────────────────
+        // Register — a hook to account for
+        //
+        // Args:
+        //   frameHook - this hook runs once per frame (EndScene / Present):
+        //               each invocation ends a frame and budgets are
+        //               judged against frames
+        //
+        // Returns:
+        //   Hook id for Measure() (same name → same id), 0 if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static uint Register(string name, bool frameHook = false)
+        {
+            if (!_available || string.IsNullOrEmpty(name)) return 0;
+
+            var key = new ConfigKey("hooks." + name + ".budget_us");
+            uint id;
+            try
+            {
+                id = (uint)NativeMethods.AchikoHookRegister(name, Budget(key), frameHook ? (uint)FrameFlag : 0);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return 0;
+            }
+            if (id != 0)
+                lock (_lock) _budgetKeys[id] = key;
+            return id;
+        }
+
+        public static HookTiming Measure(uint id) => new HookTiming(_available ? id : 0);
+
+        // End a frame by hand when no frame hook is installed
+        public static void FrameEnd()
+        {
+            if (_available)
+                NativeMethods.AchikoHookFrameEnd();
+        }
+
+        // Re-read every budget from the config (after a reload)
+        public static void ApplyBudgets()
+        {
+            if (!_available) return;
+            lock (_lock)
+            {
+                foreach (KeyValuePair<uint, ConfigKey> hook in _budgetKeys)
+                    NativeMethods.AchikoHookSetBudget(hook.Key, Budget(hook.Value));
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORTING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // PublishIfDue — one "[Hooks]" line per hook that went over budget
+        // since the last publish (bot thread)
+        // ───────────────────────────────────────────────────────────────
+        public static void PublishIfDue()
+        {
+            if (!_available) return;
+
+            long now = Stopwatch.GetTimestamp();
+            if (now - _lastPublishTicks < Stopwatch.Frequency * PublishIntervalMs / 1000)
+                return;
+            _lastPublishTicks = now;
+
+            HookMeterSummary summary;
+            NativeMethods.AchikoHookSummary(out summary);
+            if (summary.Alarms == 0)
+                return;
+
+            var stats = new HookStats[MaxHooks];
+            int count = NativeMethods.AchikoHookStats(stats, stats.Length);
+            for (int i = 0; i < count; i++)
+            {
+                HookStats s = stats[i];
+                ulong previous = _publishedAlarms[s.Id];
+                if (s.Alarms <= previous)
+                {
+                    _publishedAlarms[s.Id] = s.Alarms;   // reset since
+                    continue;
+                }
+                _publishedAlarms[s.Id] = s.Alarms;
+                PipeClient.Log($"[Hooks] '{s.Name}' over budget in {s.Alarms - previous} frames " +
+                               $"(worst {Us(s.WorstFrameNs)} µs per frame, budget {s.BudgetUs} µs)");
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — HOOK_REPORT lines; null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            HookMeterSummary summary;
+            var stats = new HookStats[MaxHooks];
+            int count;
+            try
+            {
+                NativeMethods.AchikoHookSummary(out summary);
+                count = NativeMethods.AchikoHookStats(stats, stats.Length);
+            }
+            catch (Exception) { return null; }
+
+            double seconds = Math.Max(1e-3, summary.SinceNs / 1e9);
+            var lines = new List<string>(count + 1);
+            lines.Add(summary.Frames == 0
+                ? $"{summary.Hooks} hooks on {summary.Threads} threads over {seconds:F0} s; no frame hook — no budgets judged"
+                : $"{summary.Hooks} hooks on {summary.Threads} threads over {summary.Frames} frames ({summary.Frames / seconds:F0} fps): " +
+                  $"{Us(summary.HookNs / summary.Frames)} µs per frame avg, worst {Us(summary.WorstFrameNs)} µs, " +
+                  $"{summary.Alarms} budget alarms" + (summary.Dropped != 0 ? $", {summary.Dropped} records dropped" : ""));
+
+            for (int i = 0; i < count; i++)
+            {
+                HookStats s = stats[i];
+                if (s.Invocations == 0)
+                {
+                    lines.Add($"  {s.Name}: never called");
+                    continue;
+                }
+                string frames = s.Frames == 0 ? "" :
+                    $"; per frame worst {Us(s.WorstFrameNs)} µs" +
+                    (s.BudgetUs != 0 ? $" / budget {s.BudgetUs} µs, {s.Alarms} alarms" : "");
+                lines.Add($"  {s.Name}: {s.Invocations} calls ({s.Invocations / seconds:F1}/s) on {s.Threads} threads, " +
+                          $"avg {Us(s.TotalNs / s.Invocations)} µs, max {Us(s.MaxNs)} µs, " +
+                          $"{Us((ulong)(s.TotalNs / seconds))} µs/s in hook, " +
+                          $"{s.Transitions} managed transitions ({s.Transitions / seconds:F1}/s){frames}");
+            }
+            return lines.ToArray();
+        }
+
+        public static void Reset()
+        {
+            if (!_available) return;
+            NativeMethods.AchikoHookReset();
+            Array.Clear(_publishedAlarms, 0, _publishedAlarms.Length);
+        }
+
+        private static uint Budget(ConfigKey hookKey)
+        {
+            long fallback = Config.Int(DefaultBudgetUs, DefaultBudgetFallbackUs);
+            return (uint)Math.Max(0, Math.Min(1000000, Config.Int(hookKey, fallback)));
+        }
+
+        private static string Us(ulong ns) => (ns / 1000.0).ToString("F1");
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,231 @@
+﻿// MemoryBudget.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's address-space monitor and memory
+// budgets (MemoryBudget.h / MemoryMonitor.h)
+//
+// Responsibilities:
+// • Start(): start the native monitor thread, set default budgets
+// • Tick(): report the managed heap's size, drain trim requests — CLR →
+//   an idle-window collection (GcScheduler), caches → TrimRequested
+// • Publish a one-line summary every 10 s, and at once when the pressure
+//   level changes — Achikobuddy shows it live
+// • Report(): full breakdown by owner (MEMORY_REPORT)
+//
+// Architecture:
+// • Scanning, attribution and trim decisions are native; the tick arena
+//   reports and trims itself in AchikoArenaEndTick
+// • Summary lines start with "[Memory] " — Main.xaml.cs picks them out of
+//   the log stream like "[Effect] " lines
+//
+// Critical Design Decisions:
+// • Degrade, don't die: a trim request shrinks what the bot holds, it
+//   never stops the bot — caches drop entries, the CLR heap gets a
+//   collection out of combat
+// • Missing native exports = every call no-ops, Report() returns null
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using AchikoDLL.IPC;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // Mirrors MemoryOwner in MemoryBudget.h
+    public enum MemoryOwner
+    {
+        Game = 0,          // everything not claimed below
+        Clr = 1,           // CLR modules + managed heap
+        Arena = 2,         // native tick arena
+        Cache = 3,         // bot caches
+        Bot = 4            // RemoteAchiko / bot modules
+    }
+
+    // Mirrors MemoryPressure in MemoryBudget.h
+    public enum MemoryPressure
+    {
+        Normal = 0,
+        Low = 1,           // largest free < 64 MB or free < 256 MB
+        Critical = 2       // largest free < 16 MB or free < 64 MB
+    }
+
+    // Mirrors MemorySummary in MemoryBudget.h — per-owner arrays are
+    // indexed by MemoryOwner
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MemorySummary
+    {
+        public ulong FreeBytes;
+        public ulong LargestFree;
+        public ulong ReservedBytes;
+        public ulong CommittedBytes;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 5)] public ulong[] Committed;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 5)] public ulong[] Budget;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 5)] public ulong[] Trims;
+        public ulong Scans;
+        public ulong ScanNs;
+        public uint Regions;
+        public uint UsableFreeBlocks;
+        public uint FragmentationPermille;
+        public uint Pressure;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // MemoryBudget — static API, bot thread only
+    // ═══════════════════════════════════════════════════════════════
+    public static class MemoryBudget
+    {
+        public const int ScanIntervalMs = 5000;
+        public const int PublishIntervalMs = 10000;
+
+        // Default budgets — generous; address-space pressure does the rest
+        private const ulong MB = 1024UL * 1024UL;
+        private const ulong DefaultClrBudget = 256 * MB;
+        private const ulong DefaultArenaBudget = 16 * MB;
+        private const ulong DefaultCacheBudget = 64 * MB;
+
+        private static readonly string[] OwnerNames = { "game", "clr", "arena", "cache", "bot" };
+        private static readonly string[] PressureNames = { "normal", "low", "critical" };   // lower case: the UI treats "CRITICAL" as pipe loss
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static long _lastPublishTicks;              // bot thread only
+        private static uint _lastPressure;
+
+        // ───────────────────────────────────────────────────────────────
+        // TrimRequested — shrink bot caches to at most this many bytes
+        // (raised on the bot thread from Tick)
+        // ───────────────────────────────────────────────────────────────
+        public static event Action<ulong> TrimRequested;
+
+        public static void Start()
+        {
+            if (!_available) return;
+
+            try
+            {
+                NativeMethods.AchikoMemorySetBudget((uint)MemoryOwner.Clr, DefaultClrBudget);
+                NativeMethods.AchikoMemorySetBudget((uint)MemoryOwner.Arena, DefaultArenaBudget);
+                NativeMethods.AchikoMemorySetBudget((uint)MemoryOwner.Cache, DefaultCacheBudget);
+                NativeMethods.AchikoMemoryStart(ScanIntervalMs);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+            }
+        }
+
+        public static void SetBudget(MemoryOwner owner, ulong bytes)
+        {
+            if (_available)
+                NativeMethods.AchikoMemorySetBudget((uint)owner, bytes);
+        }
+
+        // Usage of a managed cache (sum over caches), for attribution + trims
+        public static void ReportCacheUsage(ulong bytes)
+        {
+            if (_available)
+                NativeMethods.AchikoMemoryReportUsage((uint)MemoryOwner.Cache, bytes);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Tick — once per bot tick: report the managed heap, act on trims
+        // ───────────────────────────────────────────────────────────────
+        public static void Tick()
+        {
+            if (!_available) return;
+
+            NativeMethods.AchikoMemoryReportUsage((uint)MemoryOwner.Clr, (ulong)GC.GetTotalMemory(false));
+
+            ulong target;
+            if (NativeMethods.AchikoMemoryTakeTrim((uint)MemoryOwner.Clr, out target) != 0)
+                GcScheduler.RequestCollection();
+
+            if (NativeMethods.AchikoMemoryTakeTrim((uint)MemoryOwner.Cache, out target) != 0)
+            {
+                Action<ulong> handler = TrimRequested;
+                if (handler != null)
+                    handler(target);
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORTING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // PublishIfDue — the summary line every PublishIntervalMs, or now
+        // if the pressure level changed (bot thread)
+        // ───────────────────────────────────────────────────────────────
+        public static void PublishIfDue()
+        {
+            if (!_available) return;
+
+            MemorySummary s;
+            NativeMethods.AchikoMemorySummary(out s);
+            if (s.Scans == 0)
+                return;
+
+            long now = Stopwatch.GetTimestamp();
+            bool changed = s.Pressure != _lastPressure;
+            if (!changed && now - _lastPublishTicks < Stopwatch.Frequency * PublishIntervalMs / 1000)
+                return;
+            _lastPublishTicks = now;
+            _lastPressure = s.Pressure;
+
+            PipeClient.Log("[Memory] " + Summary(s));
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — MEMORY_REPORT lines; null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            MemorySummary s;
+            try
+            {
+                NativeMethods.AchikoMemoryScanNow();
+                NativeMethods.AchikoMemorySummary(out s);
+            }
+            catch (Exception) { return null; }
+
+            var lines = new string[2 + OwnerNames.Length];
+            lines[0] = $"pressure {Pressure(s)}: free {Mb(s.FreeBytes)} MB, largest block {Mb(s.LargestFree)} MB, " +
+                       $"{s.UsableFreeBlocks} usable blocks, fragmentation {s.FragmentationPermille / 10.0:F1}%";
+            lines[1] = $"committed {Mb(s.CommittedBytes)} MB, reserved {Mb(s.ReservedBytes)} MB, " +
+                       $"{s.Regions} regions, scan {s.ScanNs / 1e6:F2} ms (#{s.Scans})";
+            for (int o = 0; o < OwnerNames.Length; o++)
+            {
+                lines[2 + o] = $"  {OwnerNames[o],-6} {Mb(s.Committed[o]),8} MB" +
+                               (s.Budget[o] != 0 ? $"  budget {Mb(s.Budget[o])} MB" : "") +
+                               (s.Trims[o] != 0 ? $"  trims {s.Trims[o]}" : "");
+            }
+            return lines;
+        }
+
+        // "largest 412.0 MB · free 1210.5 MB · frag 31.2% · clr 96.0 · arena 0.5 · cache 0.0 MB · normal"
+        private static string Summary(MemorySummary s)
+        {
+            return $"largest {Mb(s.LargestFree)} MB · free {Mb(s.FreeBytes)} MB · frag {s.FragmentationPermille / 10.0:F1}% · " +
+                   $"clr {Mb(s.Committed[(int)MemoryOwner.Clr])} · arena {Mb(s.Committed[(int)MemoryOwner.Arena])} · " +
+                   $"cache {Mb(s.Committed[(int)MemoryOwner.Cache])} MB · {Pressure(s)}";
+        }
+
+        private static string Pressure(MemorySummary s)
+        {
+            return s.Pressure < PressureNames.Length ? PressureNames[s.Pressure] : s.Pressure.ToString();
+        }
+
+        private static string Mb(ulong bytes)
+        {
+            return (bytes / (double)MB).ToString("F1");
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
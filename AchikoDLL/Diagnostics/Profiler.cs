@@ -0,0 +1,266 @@
+﻿// Profiler.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's sampling profiler (Sampler.h)
+//
+// Responsibilities:
+// • Register bot threads for sampling (each thread registers itself)
+// • Publish AchikoDLL method entry points so JIT'd frames get names
+// • Start / stop / dump on UI command (PROFILE_ON, PROFILE_DUMP)
+//
+// Architecture:
+// • Sampling, stack walking and aggregation are all native — a sampler
+//   thread suspends registered threads at the requested rate and walks
+//   their frame-pointer chain
+// • Native frames are named from module export tables on the native side
+// • JIT'd code lives outside every module, so we hand the sampler
+//   "entry point → AchikoDLL!Type.Method" pairs; a frame resolves to the
+//   nearest published entry point below it
+// • Output is collapsed stacks (flamegraph.pl, speedscope.app)
+//
+// Critical Design Decisions:
+// • Symbols are published once, on first PROFILE_ON or watchdog
+//   registration — PrepareMethod JITs every AchikoDLL method up front,
+//   which is exactly what we want before measuring anyway
+// • Only AchikoDLL methods are published — framework code is NGEN'd and
+//   shows as module+RVA (mscorlib.ni.dll+0x...)
+// • Missing native exports turn profiling off permanently, same as Tracer
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // ═══════════════════════════════════════════════════════════════
+    // Profiler — static sampling-profiler API
+    // ═══════════════════════════════════════════════════════════════
+    public static class Profiler
+    {
+        // ───────────────────────────────────────────────────────────────
+        // Defaults (match Sampler.h)
+        // ───────────────────────────────────────────────────────────────
+        public const int DefaultHz = 250;
+        public const int DefaultBudgetPermille = 20;   // 2% of one core
+
+        // ───────────────────────────────────────────────────────────────
+        // State
+        // ───────────────────────────────────────────────────────────────
+        private static volatile bool _available = true;   // false once exports are missing
+        private static readonly object _controlLock = new object();
+        private static bool _symbolsPublished;            // guarded by _controlLock
+        private static int _publishedSymbols;
+
+        public static int PublishedSymbols => _publishedSymbols;
+
+        // ═══════════════════════════════════════════════════════════════
+        // THREAD REGISTRATION
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // RegisterCurrentThread — make the calling thread a sampling target
+        //
+        // Notes:
+        //   • Cheap, safe to call whether or not profiling is running
+        //   • Pair with UnregisterCurrentThread before the thread exits
+        // ───────────────────────────────────────────────────────────────
+        public static void RegisterCurrentThread(string name)
+        {
+            if (!_available) return;
+
+            try { NativeMethods.AchikoProfilerRegisterThread(name); }
+            catch (Exception) { _available = false; }
+        }
+
+        public static void UnregisterCurrentThread()
+        {
+            if (!_available) return;
+
+            try { NativeMethods.AchikoProfilerUnregisterThread(); }
+            catch (Exception) { _available = false; }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // CONTROL (UI commands)
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — begin sampling, clearing any previous samples
+        //
+        // Args:
+        //   hz             - samples per second per thread (1..1000)
+        //   budgetPermille - sampler CPU cap in 1/1000 of one core
+        //
+        // Returns:
+        //   false if RemoteAchiko.dll exports are unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static bool Start(int hz, int budgetPermille)
+        {
+            lock (_controlLock)
+            {
+                if (!_available) return false;
+
+                try
+                {
+                    EnsureSymbolsPublished();
+                    return NativeMethods.AchikoProfilerStart(hz, budgetPermille) != 0;
+                }
+                catch (Exception)
+                {
+                    // DllNotFoundException / EntryPointNotFoundException
+                    _available = false;
+                    return false;
+                }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Dump — stop sampling and write collapsed stacks
+        //
+        // Returns:
+        //   Number of unique stacks written, -1 on failure
+        // ───────────────────────────────────────────────────────────────
+        public static int Dump(string path)
+        {
+            lock (_controlLock)
+            {
+                if (!_available) return -1;
+
+                try
+                {
+                    NativeMethods.AchikoProfilerStop();
+                    return NativeMethods.AchikoProfilerDump(path);
+                }
+                catch (Exception)
+                {
+                    return -1;
+                }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Summary — one log line: samples, failures, real rate, pass cost
+        // ───────────────────────────────────────────────────────────────
+        public static string Summary()
+        {
+            if (!_available) return "profiler unavailable";
+
+            try
+            {
+                ulong samples, failed;
+                int effectiveHz, avgPassUs;
+                NativeMethods.AchikoProfilerStats(out samples, out failed, out effectiveHz, out avgPassUs);
+                return $"{samples} samples, {failed} failed, {effectiveHz} Hz effective, {avgPassUs} µs/pass";
+            }
+            catch (Exception)
+            {
+                return "profiler unavailable";
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // MANAGED SYMBOLS
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // EnsureSymbolsPublished — publish once, from whoever needs names first
+        //
+        // Notes:
+        //   Also called by Watchdog — hang reports walk the same stacks
+        // ───────────────────────────────────────────────────────────────
+        public static void EnsureSymbolsPublished()
+        {
+            lock (_controlLock)
+            {
+                if (!_available || _symbolsPublished) return;
+
+                try
+                {
+                    _symbolsPublished = true;
+                    _publishedSymbols = PublishManagedSymbols();
+                }
+                catch (Exception)
+                {
+                    // DllNotFoundException / EntryPointNotFoundException
+                    _available = false;
+                }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // PublishManagedSymbols — JIT every AchikoDLL method, report entry points
+        //
+        // Behavior:
+        //   • Skips abstract, P/Invoke and open generic methods (no single
+        //     code body to name)
+        //   • GetFunctionPointer may return a precode stub — follow up to
+        //     two "jmp rel32" hops to reach the JIT'd body
+        //
+        // Returns:
+        //   Number of symbols handed to the sampler
+        // ───────────────────────────────────────────────────────────────
+        private static int PublishManagedSymbols()
+        {
+            const BindingFlags all = BindingFlags.Public | BindingFlags.NonPublic |
+                BindingFlags.Instance | BindingFlags.Static | BindingFlags.DeclaredOnly;
+
+            int published = 0;
+            Type[] types;
+            try { types = typeof(Profiler).Assembly.GetTypes(); }
+            catch (ReflectionTypeLoadException ex) { types = ex.Types; }
+
+            foreach (Type type in types)
+            {
+                if (type == null || type.ContainsGenericParameters) continue;
+
+                foreach (MethodBase method in type.GetMethods(all))
+                    published += PublishMethod(type, method);
+                foreach (MethodBase ctor in type.GetConstructors(all))
+                    published += PublishMethod(type, ctor);
+            }
+
+            return published;
+        }
+
+        private static int PublishMethod(Type type, MethodBase method)
+        {
+            if (method.IsAbstract || method.ContainsGenericParameters ||
+                (method.Attributes & MethodAttributes.PinvokeImpl) != 0 ||
+                (method.GetMethodImplementationFlags() & MethodImplAttributes.InternalCall) != 0)
+                return 0;
+
+            try
+            {
+                RuntimeMethodHandle handle = method.MethodHandle;
+                RuntimeHelpers.PrepareMethod(handle);
+
+                IntPtr entry = FollowJumps(handle.GetFunctionPointer());
+                if (entry == IntPtr.Zero) return 0;
+
+                NativeMethods.AchikoProfilerAddSymbol(entry, "AchikoDLL!" + type.FullName + "." + method.Name);
+                return 1;
+            }
+            catch (Exception)
+            {
+                // Methods the runtime refuses to prepare simply stay unnamed
+                return 0;
+            }
+        }
+
+        private static IntPtr FollowJumps(IntPtr address)
+        {
+            for (int hop = 0; hop < 2 && address != IntPtr.Zero; hop++)
+            {
+                if (Marshal.ReadByte(address) != 0xE9)   // jmp rel32
+                    break;
+
+                int rel = Marshal.ReadInt32(address, 1);
+                address = new IntPtr(address.ToInt64() + 5 + rel);
+            }
+            return address;
+        }
+    }
+}
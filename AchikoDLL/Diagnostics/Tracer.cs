@@ -0,0 +1,260 @@
+﻿// Tracer.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's span recorder (Trace.h)
+//
+// Responsibilities:
+// • Register span names once (static readonly ids per class)
+// • using (Tracer.Span(id)) { ... } — one P/Invoke per span when enabled
+// • Instant events for GC collections observed in this process
+// • Enable / disable / export on UI command (TRACE_ON, TRACE_OFF, TRACE_DUMP)
+//
+// Architecture:
+// • Spans are recorded natively into per-thread buffers; a native
+//   flusher thread drains them while tracing is on
+// • Timestamps are Stopwatch.GetTimestamp() (QPC ticks) — the same clock
+//   the native side uses, so bootstrap and managed spans line up
+// • Export writes Chrome / Perfetto trace-event JSON (ui.perfetto.dev,
+//   chrome://tracing)
+//
+// Critical Design Decisions:
+// • TraceSpan is a struct — "using" on it never boxes, so a span
+//   allocates nothing; disabled = one volatile read + default(TraceSpan)
+// • Missing native exports (AchikoDLL loaded without RemoteAchiko) turn
+//   tracing off permanently instead of throwing on every span
+// • .NET 4.0 has no in-process GC pause events — a finalizer sentinel
+//   marks each collection as an instant right after it completes
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Diagnostics;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // ───────────────────────────────────────────────────────────────
+    // TraceCategory — "cat" in the exported JSON (matches Trace.h)
+    // ───────────────────────────────────────────────────────────────
+    public enum TraceCategory
+    {
+        Bootstrap = 0,
+        Tick = 1,
+        Queue = 2,
+        Ipc = 3,
+        Gc = 4
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // Tracer — static span API
+    // ═══════════════════════════════════════════════════════════════
+    public static class Tracer
+    {
+        // ───────────────────────────────────────────────────────────────
+        // State
+        // ───────────────────────────────────────────────────────────────
+        private static volatile bool _enabled;            // mirrors native Enabled()
+        private static volatile bool _available = true;   // false once exports are missing
+        private static readonly object _controlLock = new object();
+
+        private static bool _gcSentinelArmed;             // guarded by _controlLock
+        private static int _lastGen0, _lastGen1, _lastGen2;
+        private static readonly ushort TraceGen0 = Register("gc.gen0", TraceCategory.Gc);
+        private static readonly ushort TraceGen1 = Register("gc.gen1", TraceCategory.Gc);
+        private static readonly ushort TraceGen2 = Register("gc.gen2", TraceCategory.Gc);
+
+        public static bool Enabled => _enabled;
+
+        // ═══════════════════════════════════════════════════════════════
+        // RECORDING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Register — intern a span name, returns 0 if tracing is unavailable
+        //
+        // Usage:
+        //   private static readonly ushort TraceTick = Tracer.Register("tick", TraceCategory.Tick);
+        // ───────────────────────────────────────────────────────────────
+        public static ushort Register(string name, TraceCategory category)
+        {
+            if (!_available) return 0;
+
+            try
+            {
+                return NativeMethods.AchikoTraceRegister(name, (int)category);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return 0;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Span — start a span; Dispose() records it
+        // ───────────────────────────────────────────────────────────────
+        public static TraceSpan Span(ushort nameId)
+        {
+            if (!_enabled || nameId == 0)
+                return default(TraceSpan);
+
+            return new TraceSpan(nameId, Stopwatch.GetTimestamp());
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Instant — zero-length marker at "now"
+        // ───────────────────────────────────────────────────────────────
+        public static void Instant(ushort nameId)
+        {
+            if (_enabled && nameId != 0)
+                NativeMethods.AchikoTraceInstant(nameId, Stopwatch.GetTimestamp());
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // NameThread — label the calling thread in exported traces
+        // ───────────────────────────────────────────────────────────────
+        public static void NameThread(string name)
+        {
+            if (!_available || string.IsNullOrEmpty(name)) return;
+
+            try { NativeMethods.AchikoTraceNameThread(name); }
+            catch (Exception) { _available = false; }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // CONTROL (UI commands)
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // SetEnabled — start/stop recording
+        //
+        // Returns:
+        //   false if RemoteAchiko.dll exports are unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static bool SetEnabled(bool enabled)
+        {
+            lock (_controlLock)
+            {
+                if (!_available) return false;
+
+                try
+                {
+                    NativeMethods.AchikoTraceSetEnabled(enabled ? 1 : 0);
+                }
+                catch (Exception)
+                {
+                    _available = false;
+                    _enabled = false;
+                    return false;
+                }
+
+                _enabled = enabled;
+
+                if (enabled && !_gcSentinelArmed)
+                {
+                    _lastGen0 = GC.CollectionCount(0);
+                    _lastGen1 = GC.CollectionCount(1);
+                    _lastGen2 = GC.CollectionCount(2);
+                    _gcSentinelArmed = true;
+                    new GcSentinel();
+                }
+
+                return true;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Export — write the recorded history to a JSON file
+        //
+        // Returns:
+        //   Number of events written, -1 on failure
+        // ───────────────────────────────────────────────────────────────
+        public static int Export(string path)
+        {
+            if (!_available) return -1;
+
+            try { return NativeMethods.AchikoTraceExport(path); }
+            catch (Exception) { return -1; }
+        }
+
+        public static ulong Dropped
+        {
+            get
+            {
+                if (!_available) return 0;
+                try { return NativeMethods.AchikoTraceDropped(); }
+                catch (Exception) { return 0; }
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // GC OBSERVATION
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // GcSentinel — unreachable object whose finalizer runs after each
+        // gen0 (and therefore every) collection
+        //
+        // Behavior:
+        //   • Emits gc.gen0/1/2 for the highest generation collected
+        //   • Re-arms itself while tracing is on; stops on disable,
+        //     process shutdown or AppDomain unload
+        // ───────────────────────────────────────────────────────────────
+        private sealed class GcSentinel
+        {
+            ~GcSentinel()
+            {
+                if (Environment.HasShutdownStarted || AppDomain.CurrentDomain.IsFinalizingForUnload())
+                    return;
+
+                lock (_controlLock)
+                {
+                    if (!_enabled)
+                    {
+                        _gcSentinelArmed = false;
+                        return;
+                    }
+
+                    ReportCollections();
+                    new GcSentinel();
+                }
+            }
+        }
+
+        private static void ReportCollections()
+        {
+            int gen0 = GC.CollectionCount(0);
+            int gen1 = GC.CollectionCount(1);
+            int gen2 = GC.CollectionCount(2);
+
+            if (gen2 != _lastGen2) Instant(TraceGen2);
+            else if (gen1 != _lastGen1) Instant(TraceGen1);
+            else if (gen0 != _lastGen0) Instant(TraceGen0);
+
+            _lastGen0 = gen0;
+            _lastGen1 = gen1;
+            _lastGen2 = gen2;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // TraceSpan — returned by Tracer.Span, records on Dispose
+    // ═══════════════════════════════════════════════════════════════
+    public struct TraceSpan : IDisposable
+    {
+        private readonly ushort _nameId;    // 0 = tracing was off at Span()
+        private readonly long _startTicks;
+
+        internal TraceSpan(ushort nameId, long startTicks)
+        {
+            _nameId = nameId;
+            _startTicks = startTicks;
+        }
+
+        public void Dispose()
+        {
+            if (_nameId != 0)
+                NativeMethods.AchikoTraceRecord(_nameId, _startTicks, Stopwatch.GetTimestamp());
+        }
+    }
+}
@@ -0,0 +1,118 @@
+﻿// Watchdog.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's heartbeat watchdog (Watchdog.h)
+//
+// Responsibilities:
+// • Register long-running bot threads with the native watchdog
+// • Hand each thread a Heartbeat it bumps once per loop iteration
+//
+// Architecture:
+// • Detection, stack capture and reporting are all native — a watchdog
+//   thread polls the heartbeat slots and, when one stops moving, captures
+//   the thread's stack + recent trace events and logs them to Achikobuddy
+//   through the bootstrapper pipe (works even if our log thread is stuck)
+// • Registration publishes managed symbols (Profiler) so hung AchikoDLL
+//   frames are named in the report
+//
+// Critical Design Decisions:
+// • Heartbeat.Beat() is one plain 32-bit store into the native slot —
+//   no P/Invoke, no lock, no interlocked op on the hot path
+// • The heartbeat belongs to the registering thread only; never share it
+// • Missing native exports = Heartbeat.None, Beat() does nothing
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.Diagnostics
+{
+    // ═══════════════════════════════════════════════════════════════
+    // Heartbeat — one watched thread's counter
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class Heartbeat
+    {
+        public static readonly Heartbeat None = new Heartbeat(IntPtr.Zero);
+
+        private readonly IntPtr _slot;   // native HeartbeatSlot::beat
+        private int _count;              // owner thread only
+
+        internal Heartbeat(IntPtr slot)
+        {
+            _slot = slot;
+        }
+
+        public bool IsWatched => _slot != IntPtr.Zero;
+
+        // ───────────────────────────────────────────────────────────────
+        // Beat — "still alive"; call at least once per timeout period
+        // ───────────────────────────────────────────────────────────────
+        public unsafe void Beat()
+        {
+            if (_slot != IntPtr.Zero)
+                *(int*)_slot.ToPointer() = ++_count;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // Watchdog — static registration API
+    // ═══════════════════════════════════════════════════════════════
+    public static class Watchdog
+    {
+        public const int DefaultTimeoutMs = 5000;
+
+        private static volatile bool _available = true;   // false once exports are missing
+
+        // ───────────────────────────────────────────────────────────────
+        // RegisterCurrentThread — start watching the calling thread
+        //
+        // Args:
+        //   name      - label in hang reports
+        //   timeoutMs - silence that counts as a hang; pick several loop
+        //               periods so a slow iteration is not a "hang"
+        //
+        // Returns:
+        //   The thread's Heartbeat (Heartbeat.None if unavailable)
+        // ───────────────────────────────────────────────────────────────
+        public static Heartbeat RegisterCurrentThread(string name, int timeoutMs)
+        {
+            if (!_available) return Heartbeat.None;
+
+            Profiler.EnsureSymbolsPublished();
+
+            try
+            {
+                IntPtr slot = NativeMethods.AchikoWatchdogRegister(name, timeoutMs);
+                return slot == IntPtr.Zero ? Heartbeat.None : new Heartbeat(slot);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return Heartbeat.None;
+            }
+        }
+
+        public static void UnregisterCurrentThread()
+        {
+            if (!_available) return;
+
+            try { NativeMethods.AchikoWatchdogUnregister(); }
+            catch (Exception) { _available = false; }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Hangs — hangs detected since injection
+        // ───────────────────────────────────────────────────────────────
+        public static ulong Hangs
+        {
+            get
+            {
+                if (!_available) return 0;
+
+                try { return NativeMethods.AchikoWatchdogHangs(); }
+                catch (Exception) { return 0; }
+            }
+        }
+    }
+}
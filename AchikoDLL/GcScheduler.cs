@@ -0,0 +1,397 @@
+﻿// GcScheduler.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// GC-aware scheduling — keep full collections out of combat ticks
+//
+// Responsibilities:
+// • Register for full-GC approach notifications and watch for them
+// • Induce the approaching gen2 collection early, in an idle window
+//   (out of combat, between ticks), instead of letting it land mid-fight
+// • Hold gen2 off during combat (GCLatencyMode.LowLatency)
+// • Tell the bot loop when a GC is imminent so it can skip non-critical,
+//   allocation-heavy work
+// • Run collections the memory budget asks for (RequestCollection) in the
+//   next idle window
+// • Count combat ticks that overlapped a gen2 GC, with scheduling off
+//   ("before") and on ("after"), for GC_REPORT
+// • 100% .NET 4.0 / C# 7.3 compatible
+//
+// Architecture:
+// • Watcher thread blocks in GC.WaitForFullGCApproach / Complete
+// • BotCore brackets every tick with TickBegin / TickEnd — that is where
+//   the combat flag arrives and where deferred collections are induced
+// • Induced collections run on the bot thread right after a tick, so the
+//   next tick starts on a clean heap; with the bot idle the watcher
+//   induces them itself
+//
+// Critical Design Decisions:
+// • Approach notifications only exist for non-concurrent GC — the
+//   bootstrapper clears STARTUP_CONCURRENT_GC before starting the CLR
+//   (RemoteAchiko.cpp). If registration still fails we run without
+//   notifications and only the overlap counters stay live
+// • Never induce while in combat — a deferred approach waits for the
+//   first idle window; if the heap runs out first the CLR collects
+//   anyway, and that tick shows up in the overlap count
+// • LowLatency is restored the moment combat ends (the CLR still collects
+//   gen2 under low memory, so it cannot starve the process)
+// • Single bot thread — tick bookkeeping needs no locks
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Diagnostics;
+using System.Runtime;
+using System.Threading;
+using AchikoDLL.Diagnostics;
+using AchikoDLL.IPC;
+
+namespace AchikoDLL
+{
+    // ═══════════════════════════════════════════════════════════════
+    // GcScheduler — static full-GC steering for the bot loop
+    // ═══════════════════════════════════════════════════════════════
+    public static class GcScheduler
+    {
+        // ───────────────────────────────────────────────────────────────
+        // Tuning
+        // ───────────────────────────────────────────────────────────────
+        // Notification thresholds (1..99): higher = earlier warning, more
+        // headroom to reach an idle window before the CLR collects itself
+        private const int ApproachThreshold = 20;
+        private const int LohThreshold = 20;
+        private const int WaitSliceMs = 1000;   // watcher re-checks _running
+
+        // ───────────────────────────────────────────────────────────────
+        // State
+        // ───────────────────────────────────────────────────────────────
+        private static readonly object _controlLock = new object();
+        private static Thread _watcherThread;
+        private static volatile bool _running;
+        private static volatile bool _registered;     // approach notifications live
+        private static volatile bool _enabled;        // steering on (GC_SCHED_ON/OFF)
+        private static volatile bool _imminent;       // approach seen, GC not done yet
+        private static volatile bool _inducePending;  // approach deferred by combat
+        private static volatile bool _collectRequested; // memory budget trim (MemoryBudget.cs)
+        private static volatile bool _inCombat;
+        private static volatile bool _inTick;
+        private static GCLatencyMode _normalLatency;
+
+        // Tick bookkeeping (bot thread only)
+        private static int _tickGen2;
+        private static long _tickStart;
+        private static bool _lowLatencyApplied;
+
+        // Statistics — [0] scheduling off ("before"), [1] on ("after")
+        private static readonly long[] _combatTicks = new long[2];
+        private static readonly long[] _overlapTicks = new long[2];
+        private static readonly long[] _overlapTicksUs = new long[2];
+        private static readonly long[] _overlapMaxUs = new long[2];
+        private static long _combatTickUsTotal;       // all modes, for the baseline
+        private static long _approaches;
+        private static long _induced;
+        private static long _inducedUsTotal;
+        private static long _inducedMaxUs;
+
+        private static readonly ushort TraceInduce = Tracer.Register("gc.induce", TraceCategory.Gc);
+
+        public static bool IsRegistered => _registered;
+        public static bool IsEnabled => _enabled;
+
+        // ───────────────────────────────────────────────────────────────
+        // GcImminent — a full GC is approaching and has not run yet
+        //
+        // Notes:
+        //   Steering only — always false while scheduling is off, so the
+        //   "before" numbers see the bot's normal allocation pattern
+        // ───────────────────────────────────────────────────────────────
+        public static bool GcImminent => _enabled && _imminent;
+
+        // ═══════════════════════════════════════════════════════════════
+        // LIFECYCLE
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — register for notifications and start the watcher
+        //
+        // Returns:
+        //   true if approach notifications are live (concurrent GC off)
+        // ───────────────────────────────────────────────────────────────
+        public static bool Start()
+        {
+            lock (_controlLock)
+            {
+                if (_running) return _registered;
+
+                _normalLatency = GCSettings.LatencyMode;
+
+                try
+                {
+                    GC.RegisterForFullGCNotification(ApproachThreshold, LohThreshold);
+                    _registered = true;
+                }
+                catch (InvalidOperationException)
+                {
+                    // Concurrent GC still on — host did not clear the flag
+                    _registered = false;
+                }
+
+                _enabled = _registered;
+                _running = true;
+
+                if (_registered)
+                {
+                    _watcherThread = new Thread(WatcherLoop)
+                    {
+                        IsBackground = true,
+                        Name = "AchikoGcWatcher"
+                    };
+                    _watcherThread.Start();
+                }
+
+                return _registered;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Stop — cancel notifications, restore latency mode, join watcher
+        // ───────────────────────────────────────────────────────────────
+        public static void Stop()
+        {
+            lock (_controlLock)
+            {
+                if (!_running) return;
+
+                _running = false;
+                _enabled = false;
+
+                if (_registered)
+                {
+                    GC.CancelFullGCNotification();   // wakes the watcher (Canceled)
+                    _registered = false;
+                }
+
+                if (_watcherThread != null && !_watcherThread.Join(2 * WaitSliceMs))
+                    PipeClient.Log("[GcScheduler] WARNING: watcher did not exit in time");
+                _watcherThread = null;
+
+                RestoreLatency();
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // SetEnabled — toggle steering (GC_SCHED_ON / GC_SCHED_OFF)
+        //
+        // Returns:
+        //   false if notifications are unavailable (stays off)
+        // ───────────────────────────────────────────────────────────────
+        public static bool SetEnabled(bool enabled)
+        {
+            if (enabled && !_registered) return false;
+
+            _enabled = enabled;
+            if (!enabled)
+                _inducePending = false;
+            return true;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // BOT LOOP HOOKS (bot thread only)
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // TickBegin — a tick is about to run
+        //
+        // Args:
+        //   inCombat - combat state for this tick
+        // ───────────────────────────────────────────────────────────────
+        public static void TickBegin(bool inCombat)
+        {
+            _inCombat = inCombat;
+            _inTick = true;
+
+            // Hold gen2 off for the whole fight, not just inside ticks
+            if (inCombat && _enabled && !_lowLatencyApplied)
+            {
+                GCSettings.LatencyMode = GCLatencyMode.LowLatency;
+                _lowLatencyApplied = true;
+            }
+            else if ((!inCombat || !_enabled) && _lowLatencyApplied)
+            {
+                RestoreLatency();
+            }
+
+            _tickGen2 = GC.CollectionCount(2);
+            _tickStart = Stopwatch.GetTimestamp();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // TickEnd — a tick finished; idle window until the next one
+        //
+        // Behavior:
+        //   • Combat tick → account it, flag it if a gen2 GC ran inside it
+        //   • Out of combat with a deferred approach or a memory trim
+        //     request → induce it now
+        // ───────────────────────────────────────────────────────────────
+        public static void TickEnd()
+        {
+            long elapsedUs = (Stopwatch.GetTimestamp() - _tickStart) * 1000000L / Stopwatch.Frequency;
+            int mode = _enabled ? 1 : 0;
+
+            if (_inCombat)
+            {
+                Interlocked.Increment(ref _combatTicks[mode]);
+                Interlocked.Add(ref _combatTickUsTotal, elapsedUs);
+
+                if (GC.CollectionCount(2) != _tickGen2)
+                {
+                    Interlocked.Increment(ref _overlapTicks[mode]);
+                    Interlocked.Add(ref _overlapTicksUs[mode], elapsedUs);
+                    if (elapsedUs > Interlocked.Read(ref _overlapMaxUs[mode]))
+                        Interlocked.Exchange(ref _overlapMaxUs[mode], elapsedUs);
+                }
+            }
+
+            _inTick = false;
+
+            if (!_inCombat && (_collectRequested || (_enabled && _inducePending)))
+            {
+                _collectRequested = false;
+                Induce();
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // RequestCollection — the managed heap is over budget or address
+        // space is short; collect in the next idle window
+        //
+        // Notes:
+        //   Independent of steering — a memory trim is not a GC approach
+        // ───────────────────────────────────────────────────────────────
+        public static void RequestCollection()
+        {
+            _collectRequested = true;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // BotIdle — the bot stopped ticking (disabled via UI)
+        //
+        // Notes:
+        //   Clears the combat flag so the watcher may induce on its own
+        // ───────────────────────────────────────────────────────────────
+        public static void BotIdle()
+        {
+            _inCombat = false;
+            _inTick = false;
+            if (_lowLatencyApplied)
+                RestoreLatency();
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORTING
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — GC_REPORT lines for the UI log
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            long combatAll = Interlocked.Read(ref _combatTicks[0]) + Interlocked.Read(ref _combatTicks[1]);
+            long avgTickUs = combatAll > 0 ? Interlocked.Read(ref _combatTickUsTotal) / combatAll : 0;
+            long induced = Interlocked.Read(ref _induced);
+
+            return new[]
+            {
+                $"notifications {(_registered ? "ON" : "OFF (concurrent GC)")}, steering {(_enabled ? "ON" : "OFF")}, " +
+                    $"gen2 total {GC.CollectionCount(2)}, approaches {Interlocked.Read(ref _approaches)}",
+                FormatMode("before (steering off)", 0),
+                FormatMode("after  (steering on) ", 1),
+                $"induced in idle windows: {induced}, avg {(induced > 0 ? Interlocked.Read(ref _inducedUsTotal) / induced / 1000.0 : 0):F1} ms, " +
+                    $"max {Interlocked.Read(ref _inducedMaxUs) / 1000.0:F1} ms; avg combat tick {avgTickUs / 1000.0:F1} ms"
+            };
+        }
+
+        private static string FormatMode(string label, int mode)
+        {
+            long ticks = Interlocked.Read(ref _combatTicks[mode]);
+            long overlaps = Interlocked.Read(ref _overlapTicks[mode]);
+            double pct = ticks > 0 ? 100.0 * overlaps / ticks : 0;
+            double avgMs = overlaps > 0 ? Interlocked.Read(ref _overlapTicksUs[mode]) / overlaps / 1000.0 : 0;
+
+            return $"{label}: {overlaps}/{ticks} combat ticks hit by gen2 ({pct:F2}%), " +
+                   $"those ticks avg {avgMs:F1} ms, max {Interlocked.Read(ref _overlapMaxUs[mode]) / 1000.0:F1} ms";
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // PRIVATE METHODS
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // WatcherLoop — approach → (induce | defer) → complete, forever
+        // ───────────────────────────────────────────────────────────────
+        private static void WatcherLoop()
+        {
+            Tracer.NameThread("AchikoGcWatcher");
+
+            while (_running)
+            {
+                try
+                {
+                    GCNotificationStatus status = GC.WaitForFullGCApproach(WaitSliceMs);
+                    if (status == GCNotificationStatus.Timeout) continue;
+                    if (status != GCNotificationStatus.Succeeded) break;   // Canceled / Failed
+
+                    Interlocked.Increment(ref _approaches);
+                    _imminent = true;
+
+                    if (_enabled)
+                    {
+                        if (!_inCombat && !_inTick)
+                            Induce();                 // idle right now
+                        else
+                            _inducePending = true;    // next idle window (TickEnd)
+                    }
+
+                    do
+                    {
+                        status = GC.WaitForFullGCComplete(WaitSliceMs);
+                    }
+                    while (status == GCNotificationStatus.Timeout && _running);
+
+                    _imminent = false;
+                    _inducePending = false;
+                }
+                catch (Exception ex)
+                {
+                    PipeClient.Log($"[GcScheduler] Exception in watcher → {ex.Message}");
+                    break;
+                }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Induce — run the approaching full GC now, timed
+        // ───────────────────────────────────────────────────────────────
+        private static void Induce()
+        {
+            _inducePending = false;
+
+            long start = Stopwatch.GetTimestamp();
+            using (Tracer.Span(TraceInduce))
+                GC.Collect(2, GCCollectionMode.Forced);
+            long us = (Stopwatch.GetTimestamp() - start) * 1000000L / Stopwatch.Frequency;
+
+            Interlocked.Increment(ref _induced);
+            Interlocked.Add(ref _inducedUsTotal, us);
+            if (us > Interlocked.Read(ref _inducedMaxUs))
+                Interlocked.Exchange(ref _inducedMaxUs, us);
+        }
+
+        private static void RestoreLatency()
+        {
+            GCSettings.LatencyMode = _normalLatency;
+            _lowLatencyApplied = false;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // END OF GcScheduler.cs
+        // ═══════════════════════════════════════════════════════════════
+    }
+}
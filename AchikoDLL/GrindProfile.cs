@@ -0,0 +1,333 @@
+﻿// GrindProfile.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's binary grind profiles
+// (GrindProfile.h) and the offline route optimizer (RouteOptimizer.h)
+//
+// Responsibilities:
+// • Load() / Unload(): GRIND_LOAD — map a profile as the bot's profile
+// • Hotspot() / Waypoints() / NearestVendor() / IsBlacklisted() /
+//   InBlackArea(): what the grind logic asks of the profile
+// • Create(): write a profile from managed arrays (authoring, import)
+// • Optimize(): GRIND_OPTIMIZE — reorder the hotspots into the cheapest
+//   loop, on a background thread
+// • Report(): GRIND_REPORT
+//
+// Architecture:
+// • The profile stays in the native mapping; every query copies one
+//   record (or a waypoint batch) out under the native lock, so a load or
+//   optimize on the command thread never pulls memory from under the bot
+// • Relative paths resolve against "Profiles" next to AchikoDLL.dll
+//
+// Critical Design Decisions:
+// • Loading = map + header check; no parsing, no managed copy of the
+//   waypoint list — a large profile loads in microseconds
+// • Optimize rewrites the file (route only — hotspots keep their authoring
+//   order) and the loaded copy is remapped natively when it is the same
+//   file
+// • Missing native exports = Load() returns false, queries find nothing
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Threading;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors GrindHotspot in GrindProfile.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GrindHotspot
+    {
+        public float X;
+        public float Y;
+        public float Z;
+        public float Radius;           // pull area around the point
+    }
+
+    // Mirrors GrindWaypoint in GrindProfile.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GrindWaypoint
+    {
+        public float X;
+        public float Y;
+        public float Z;
+        public uint Flags;             // caller-defined (jump, mount, ...)
+    }
+
+    // Mirrors GrindBlackArea in GrindProfile.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GrindBlackArea
+    {
+        public float X;
+        public float Y;
+        public float Z;
+        public float Radius;
+    }
+
+    // Mirrors GrindVendorService in GrindProfile.h
+    [Flags]
+    public enum GrindVendorService : uint
+    {
+        None = 0,
+        Sell = 1,
+        Repair = 2,
+        Food = 4,
+        Ammo = 8
+    }
+
+    // Mirrors GrindVendor in GrindProfile.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GrindVendor
+    {
+        public float X;
+        public float Y;
+        public float Z;
+        public uint Entry;             // creature entry
+        public GrindVendorService Services;
+        public uint Reserved;
+    }
+
+    // Mirrors GrindProfileInfo in GrindProfile.h
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct GrindProfileInfo
+    {
+        public uint Map;
+        public uint Hotspots;
+        public uint Waypoints;
+        public uint BlackAreas;
+        public uint BlacklistEntries;
+        public uint Vendors;
+        public float RouteCost;
+        public float HandCost;
+        public ulong MappedBytes;
+        public ulong OpenNs;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 32)]
+        public string Name;
+    }
+
+    // Mirrors RouteReport in RouteOptimizer.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GrindRouteReport
+    {
+        public float HandCost;         // loop in authoring order
+        public float RouteCost;        // loop in optimized order
+        public uint Hotspots;
+        public uint Threads;
+        public uint Starts;
+        public uint Reserved;
+        public ulong MatrixNs;
+        public ulong SolveNs;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // GrindProfile — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class GrindProfile
+    {
+        public const string DirectoryName = "Profiles";
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static volatile bool _loaded;
+        private static volatile bool _optimizing;
+        private static string _path;
+
+        public static bool IsLoaded => _loaded;
+        public static bool IsOptimizing => _optimizing;
+        public static string Path => _path;
+
+        // ───────────────────────────────────────────────────────────────
+        // ResolvePath — relative paths live in "Profiles" next to
+        // AchikoDLL.dll
+        // ───────────────────────────────────────────────────────────────
+        public static string ResolvePath(string path)
+        {
+            if (System.IO.Path.IsPathRooted(path))
+                return System.IO.Path.GetFullPath(path);
+            string dir = System.IO.Path.Combine(
+                System.IO.Path.GetDirectoryName(typeof(GrindProfile).Assembly.Location), DirectoryName);
+            return System.IO.Path.GetFullPath(System.IO.Path.Combine(dir, path));
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Load — map a profile as the loaded one (replaces the previous)
+        //
+        // Returns:
+        //   false if missing / invalid / exports unavailable (nothing stays
+        //   loaded)
+        // ───────────────────────────────────────────────────────────────
+        public static bool Load(string path)
+        {
+            if (!_available || string.IsNullOrEmpty(path)) return false;
+
+            string full = ResolvePath(path);
+            try { _loaded = NativeMethods.AchikoGrindOpen(full) != 0; }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                _loaded = false;
+            }
+            _path = _loaded ? full : null;
+            return _loaded;
+        }
+
+        public static void Unload()
+        {
+            if (!_loaded) return;
+            _loaded = false;
+            _path = null;
+            NativeMethods.AchikoGrindClose();
+        }
+
+        public static bool Info(out GrindProfileInfo info)
+        {
+            info = default(GrindProfileInfo);
+            return _loaded && NativeMethods.AchikoGrindInfo(out info) != 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Hotspot — index-th hotspot in visit order; false past the end
+        // ───────────────────────────────────────────────────────────────
+        public static bool Hotspot(int index, out GrindHotspot hotspot)
+        {
+            hotspot = default(GrindHotspot);
+            if (!_loaded || index < 0) return false;
+            return NativeMethods.AchikoGrindHotspot((uint)index, out hotspot) != 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Waypoints — waypoints [first, first + buffer.Length) into buffer
+        //
+        // Returns:
+        //   Waypoints written (0 past the end)
+        // ───────────────────────────────────────────────────────────────
+        public static int Waypoints(int first, GrindWaypoint[] buffer)
+        {
+            if (!_loaded || first < 0 || buffer == null || buffer.Length == 0) return 0;
+            return NativeMethods.AchikoGrindWaypoints((uint)first, buffer, buffer.Length);
+        }
+
+        // Closest profile vendor offering every service in services
+        public static bool NearestVendor(float x, float y, float z, GrindVendorService services, out GrindVendor vendor)
+        {
+            vendor = default(GrindVendor);
+            if (!_loaded) return false;
+            return NativeMethods.AchikoGrindNearestVendor(x, y, z, (uint)services, out vendor) != 0;
+        }
+
+        public static bool IsBlacklisted(uint entry)
+        {
+            return _loaded && NativeMethods.AchikoGrindIsBlacklisted(entry) != 0;
+        }
+
+        public static bool InBlackArea(float x, float y, float z)
+        {
+            return _loaded && NativeMethods.AchikoGrindInBlackArea(x, y, z) != 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Create — write a profile; the route is the hotspot order until
+        // Optimize() runs
+        // ───────────────────────────────────────────────────────────────
+        public static bool Create(string path, string name, uint map, GrindHotspot[] hotspots,
+                                  GrindWaypoint[] waypoints, GrindBlackArea[] blackAreas,
+                                  GrindVendor[] vendors, uint[] blacklist)
+        {
+            if (!_available || string.IsNullOrEmpty(path)) return false;
+
+            string full = ResolvePath(path);
+            try
+            {
+                Directory.CreateDirectory(System.IO.Path.GetDirectoryName(full));
+                return NativeMethods.AchikoGrindCreate(full, name ?? "", map,
+                    hotspots, hotspots?.Length ?? 0,
+                    waypoints, waypoints?.Length ?? 0,
+                    blackAreas, blackAreas?.Length ?? 0,
+                    vendors, vendors?.Length ?? 0,
+                    blacklist, blacklist?.Length ?? 0) != 0;
+            }
+            catch (DllNotFoundException) { _available = false; }
+            catch (EntryPointNotFoundException) { _available = false; }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+            return false;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Optimize — reorder a profile's route on a background thread
+        //
+        // Args:
+        //   costs     - hotspots² travel costs (row = from) from a real
+        //               path planner, or null for straight-line costs with
+        //               a climb penalty
+        //   completed - called on the worker with the report (null =
+        //               failed); may be null
+        //
+        // Returns:
+        //   false if another optimization is running or exports are missing
+        // ───────────────────────────────────────────────────────────────
+        public static bool Optimize(string path, float[] costs, Action<GrindRouteReport?> completed)
+        {
+            if (!_available || string.IsNullOrEmpty(path) || _optimizing) return false;
+
+            string full = ResolvePath(path);
+            _optimizing = true;
+            var worker = new Thread(() =>
+            {
+                GrindRouteReport? result = null;
+                try
+                {
+                    GrindRouteReport report;
+                    if (NativeMethods.AchikoGrindOptimize(full, costs, costs?.Length ?? 0, 0, out report) != 0)
+                        result = report;
+                }
+                catch (Exception)
+                {
+                    _available = false;
+                }
+                finally
+                {
+                    _optimizing = false;
+                }
+                completed?.Invoke(result);
+            })
+            {
+                IsBackground = true,
+                Name = "AchikoDLL GrindProfile (Optimize)",
+                Priority = ThreadPriority.BelowNormal
+            };
+            worker.Start();
+            return true;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — GRIND_REPORT line; null if no profile is loaded
+        // ───────────────────────────────────────────────────────────────
+        public static string Report()
+        {
+            GrindProfileInfo i;
+            if (!Info(out i)) return null;
+
+            string route = i.RouteCost > 0 && i.RouteCost < i.HandCost
+                ? $"optimized loop {i.RouteCost:F0} yd (hand order {i.HandCost:F0} yd, −{100.0 * (1.0 - i.RouteCost / i.HandCost):F0}%)"
+                : "hand-ordered route";
+            return $"'{i.Name}' map {i.Map}: {i.Hotspots} hotspots, {i.Waypoints} waypoints, {i.Vendors} vendors, " +
+                   $"{i.BlackAreas} black areas, {i.BlacklistEntries} blacklisted entries; {route}; " +
+                   $"{i.MappedBytes / 1024.0:F0} KB mapped in {i.OpenNs / 1000.0:F0} µs";
+        }
+
+        // One-line optimizer result for the log
+        public static string Describe(GrindRouteReport r)
+        {
+            double saved = r.HandCost > 0 ? 100.0 * (1.0 - r.RouteCost / r.HandCost) : 0.0;
+            return $"{r.Hotspots} hotspots: loop {r.HandCost:F0} → {r.RouteCost:F0} yd (−{saved:F1}%), " +
+                   $"{r.Starts} starts on {r.Threads} threads, matrix {r.MatrixNs / 1e6:F1} ms, solve {r.SolveNs / 1e6:F0} ms";
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
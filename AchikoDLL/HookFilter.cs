@@ -0,0 +1,296 @@
+﻿// HookFilter.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's filtered hooks (HookFilter.h) —
+// game function hooks that only reach managed code for watched ids
+//
+// Responsibilities:
+// • Install(): patch a game function with a native stub that tests one
+//   argument (spell id, event id, …) against a bitset
+// • Watch() / Unwatch(): which ids are interesting — changeable any time
+// • Drain(): bot thread, once per tick — every watched call since the
+//   last tick, handed to the hook's handler in call order
+// • Report(): HOOK_REPORT lines — calls, matches and managed transitions
+//   saved per second
+//
+// Architecture:
+// • A GreyMagic detour (Marshal.GetFunctionPointerForDelegate) costs a
+//   reverse P/Invoke on every call, including every call the bot ignores.
+//   Here unwatched calls never leave the native stub, and watched ones
+//   are queued natively and read as one TickArena span per tick
+// • The drain is one native → managed transition, metered as the
+//   "filter.drain" hook (HookMeter)
+//
+// Critical Design Decisions:
+// • Handlers run on the bot thread, after the call returned — they
+//   observe, they cannot change arguments or results (use a detour for
+//   that)
+// • Events carry the raw registers and stack slots; handlers decode them
+// • Missing native exports = Install() returns 0, Drain() no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Text;
+using AchikoDLL.Diagnostics;
+using AchikoDLL.IPC;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors HookFilterSource in HookFilter.h
+    public enum HookArg : uint
+    {
+        Ecx = 0,                           // __thiscall this / __fastcall first argument
+        Edx = 1,                           // __fastcall second argument
+        Stack0 = 2,
+        Stack1 = 3,
+        Stack2 = 4,
+        Stack3 = 5,
+        Stack4 = 6,
+        Stack5 = 7,
+        Stack6 = 8,
+        Stack7 = 9
+    }
+
+    // Mirrors HookEvent in HookFilter.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct HookEvent
+    {
+        public ulong Ticks;                // Stopwatch timestamp of the call
+        public uint Hook;
+        public uint ThreadId;
+        public uint Id;                    // the watched value
+        public uint ReturnAddress;
+        public uint Ecx;
+        public uint Edx;
+        public uint Arg0;
+        public uint Arg1;
+        public uint Arg2;
+        public uint Arg3;
+        public uint Arg4;
+        public uint Arg5;
+    }
+
+    // Mirrors HookFilterStats in HookFilter.h
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct HookFilterStats
+    {
+        public ulong Calls;
+        public ulong Matched;
+        public ulong Dropped;
+        public ulong Target;
+        public uint Id;
+        public uint Source;
+        public uint Watched;
+        public uint Installed;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 32)]
+        public string Name;
+    }
+
+    // Mirrors HookFilterSummary in HookFilter.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct HookFilterSummary
+    {
+        public ulong Calls;
+        public ulong Matched;
+        public ulong Dropped;
+        public ulong Drains;
+        public ulong Drained;
+        public ulong SinceNs;
+        public uint Hooks;
+        public uint RingSize;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // HookFilter — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class HookFilter
+    {
+        public const int MaxHooks = 16;                    // kHookFilterMaxHooks
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static readonly object _lock = new object();
+        private static readonly Action<HookEvent>[] _handlers = new Action<HookEvent>[MaxHooks];
+        private static readonly HashSet<uint> _installed = new HashSet<uint>();
+        private static volatile int _installedCount;
+        private static uint _drainHook;
+
+        // ───────────────────────────────────────────────────────────────
+        // Install — filtered hook on a game function
+        //
+        // Args:
+        //   target        - function entry
+        //   arg           - where the watched id is passed
+        //   prologueBytes - whole instructions at target to relocate
+        //                   (≥ 5, no relative jumps or calls; the usual
+        //                   `push ebp; mov ebp, esp; sub esp, imm8` is 6)
+        //   handler       - called from Drain() for each watched call
+        //
+        // Returns:
+        //   Filter id for Watch(), 0 on failure (reason logged)
+        // ───────────────────────────────────────────────────────────────
+        public static uint Install(string name, IntPtr target, HookArg arg, int prologueBytes, Action<HookEvent> handler)
+        {
+            if (!_available || string.IsNullOrEmpty(name) || handler == null) return 0;
+
+            uint id;
+            try
+            {
+                id = (uint)NativeMethods.AchikoHookFilterInstall(name, target, (uint)arg, (uint)prologueBytes);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return 0;
+            }
+
+            if (id == 0)
+            {
+                var error = new StringBuilder(256);
+                NativeMethods.AchikoHookFilterLastError(error, error.Capacity);
+                PipeClient.Log($"[HookFilter] '{name}' at 0x{target.ToInt64():X8} not installed: {error}");
+                return 0;
+            }
+
+            lock (_lock)
+            {
+                _handlers[id] = handler;
+                _installed.Add(id);
+                _installedCount = _installed.Count;
+                if (_drainHook == 0)
+                    _drainHook = HookMeter.Register("filter.drain");
+            }
+            return id;
+        }
+
+        public static int Watch(uint id, params uint[] ids) => SetWatched(id, ids, true);
+        public static int Unwatch(uint id, params uint[] ids) => SetWatched(id, ids, false);
+
+        // Restore the original bytes (the stub stays valid natively)
+        public static bool Remove(uint id)
+        {
+            if (!_available) return false;
+            bool removed = NativeMethods.AchikoHookFilterRemove(id) != 0;
+            lock (_lock)
+            {
+                _installed.Remove(id);
+                _installedCount = _installed.Count;
+            }
+            return removed;
+        }
+
+        public static void RemoveAll()
+        {
+            uint[] ids;
+            lock (_lock)
+            {
+                ids = new uint[_installed.Count];
+                _installed.CopyTo(ids);
+            }
+            foreach (uint id in ids)
+                Remove(id);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Drain — deliver this tick's watched calls (bot thread, before
+        // TickArena.EndTick)
+        //
+        // Returns:
+        //   Events delivered
+        // ───────────────────────────────────────────────────────────────
+        public static int Drain()
+        {
+            if (!_available || _installedCount == 0) return 0;
+
+            using (HookMeter.Measure(_drainHook))
+            {
+                ArenaSpan events;
+                int count = NativeMethods.AchikoHookFilterDrain(out events);
+                for (int i = 0; i < count; ++i)
+                {
+                    HookEvent e = ReadEvent(events, i);
+                    Action<HookEvent> handler = e.Hook < MaxHooks ? _handlers[e.Hook] : null;
+                    if (handler == null) continue;
+
+                    try { handler(e); }
+                    catch (Exception ex)
+                    {
+                        PipeClient.Log($"[HookFilter] Handler for hook {e.Hook} threw: {ex.Message}");
+                    }
+                }
+                return count;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — HOOK_REPORT lines; null if unavailable or unused
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            HookFilterSummary summary;
+            var stats = new HookFilterStats[MaxHooks];
+            int count;
+            try
+            {
+                NativeMethods.AchikoHookFilterSummary(out summary);
+                count = NativeMethods.AchikoHookFilterStats(stats, stats.Length);
+            }
+            catch (Exception) { return null; }
+            if (summary.Hooks == 0) return null;
+
+            // Every call would have been a transition under a managed
+            // detour; what is left is one per drain
+            double seconds = Math.Max(1e-3, summary.SinceNs / 1e9);
+            ulong saved = summary.Calls > summary.Drains ? summary.Calls - summary.Drains : 0;
+            var lines = new List<string>(count + 1);
+            lines.Add($"filters: {summary.Hooks} over {seconds:F0} s — {summary.Calls / seconds:F1} calls/s, " +
+                      $"{summary.Matched / seconds:F1} watched/s, {summary.Drains / seconds:F1} drains/s: " +
+                      $"{saved / seconds:F1} managed transitions/s saved" +
+                      (summary.Dropped != 0 ? $", {summary.Dropped} events dropped (ring {summary.RingSize})" : ""));
+
+            for (int i = 0; i < count; i++)
+            {
+                HookFilterStats s = stats[i];
+                lines.Add($"  {s.Name} @ 0x{s.Target:X8}{(s.Installed != 0 ? "" : " (removed)")}: " +
+                          $"{s.Watched} ids on {(HookArg)s.Source}, {s.Calls} calls, {s.Matched} watched" +
+                          (s.Dropped != 0 ? $", {s.Dropped} dropped" : ""));
+            }
+            return lines.ToArray();
+        }
+
+        private static int SetWatched(uint id, uint[] ids, bool watch)
+        {
+            if (!_available || ids == null || ids.Length == 0) return 0;
+            return NativeMethods.AchikoHookFilterWatch(id, ids, ids.Length, watch ? 1 : 0);
+        }
+
+        private static HookEvent ReadEvent(ArenaSpan span, int i)
+        {
+            return new HookEvent
+            {
+                Ticks = span.ReadUInt64(i, 0),
+                Hook = span.ReadUInt32(i, 8),
+                ThreadId = span.ReadUInt32(i, 12),
+                Id = span.ReadUInt32(i, 16),
+                ReturnAddress = span.ReadUInt32(i, 20),
+                Ecx = span.ReadUInt32(i, 24),
+                Edx = span.ReadUInt32(i, 28),
+                Arg0 = span.ReadUInt32(i, 32),
+                Arg1 = span.ReadUInt32(i, 36),
+                Arg2 = span.ReadUInt32(i, 40),
+                Arg3 = span.ReadUInt32(i, 44),
+                Arg4 = span.ReadUInt32(i, 48),
+                Arg5 = span.ReadUInt32(i, 52)
+            };
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
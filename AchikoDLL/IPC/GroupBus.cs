@@ -0,0 +1,317 @@
+﻿// GroupBus.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's host-local group bus (GroupBus.h)
+//
+// Responsibilities:
+// • Join / leave a named group of bot instances on this machine
+// • Send targets and pull timing to one member or all of them
+// • Publish this client's state (position, target, pull time) to the
+//   shared broadcast region and read everyone else's
+// • One receive thread that blocks natively and raises MessageReceived
+//
+// Architecture:
+// • Everything travels through shared memory between the WoW processes —
+//   Achikobuddy's UI is not on the path (that relay cost 100s of ms)
+// • The receive thread answers pings itself, so GROUP_PING measures the
+//   bus alone, not whatever the bot thread is doing
+//
+// Critical Design Decisions:
+// • The native rings are single-producer: sends from any managed thread
+//   are serialized by _sendLock
+// • Join / Leave stop the receive thread first — it is the only caller
+//   of the blocking native wait
+// • MessageReceived runs on the receive thread — handlers copy what they
+//   need and return; never tick bot logic there
+// • Missing native exports = Join() returns false, everything else no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using System.Threading;
+using AchikoDLL.Native;
+
+namespace AchikoDLL.IPC
+{
+    // Mirrors BusMessageType in GroupBus.h
+    public enum BusMessageType : uint
+    {
+        Target = 1,
+        Pull = 2,
+        Ping = 3,
+        Pong = 4,
+        User = 256
+    }
+
+    // Mirrors BusStateFlags in GroupBus.h
+    [Flags]
+    public enum BusStateFlags : uint
+    {
+        None = 0,
+        InCombat = 1,
+        Dead = 2,
+        Leader = 4
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // BusMessage — mirrors BusMessage in GroupBus.h (64 bytes)
+    // ═══════════════════════════════════════════════════════════════
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BusMessage
+    {
+        public BusMessageType Type;
+        public ushort From;          // sender slot (set by the bus)
+        public ushort Flags;
+        public ulong SentNs;         // GroupBus.NowNs() at send (set by the bus)
+        public ulong Arg0;
+        public ulong Arg1;
+        public ulong Arg2;
+        public ulong Arg3;
+        public ulong Arg4;
+        public ulong Arg5;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // BusState — mirrors BusState in GroupBus.h (64 bytes)
+    // ═══════════════════════════════════════════════════════════════
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BusState
+    {
+        public ulong UpdatedNs;      // set by the bus on Publish
+        public ulong TargetGuid;
+        public ulong PullAtNs;       // GroupBus.NowNs() clock, 0 = none
+        public float X;
+        public float Y;
+        public float Z;
+        public float Facing;
+        public uint MapId;
+        public BusStateFlags Flags;
+        public uint HealthPct;
+        public uint ManaPct;
+        public uint Reserved0;
+        public uint Reserved1;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // GroupBus — static API, one membership per WoW process
+    // ═══════════════════════════════════════════════════════════════
+    public static class GroupBus
+    {
+        private const int ReceiveBatch = 64;
+        private const int WaitTimeoutMs = 250;       // also the heartbeat period
+        private const int MaxMembers = 8;            // kBusMaxMembers
+
+        private static readonly object _lock = new object();       // Join / Leave
+        private static readonly object _sendLock = new object();   // single native producer
+        private static Thread _receiveThread;
+        private static volatile bool _receiving;
+        private static int _slot = -1;
+        private static string _group;
+
+        // Fired on the receive thread for every message except pings
+        public static event Action<BusMessage> MessageReceived;
+
+        // Native slot: a stall past kBusStaleMs can move us to another one
+        public static int Slot => _slot >= 0 ? NativeMethods.AchikoBusSlot() : -1;
+        public static string Group => _group;
+        public static bool Joined => _slot >= 0;
+
+        // ───────────────────────────────────────────────────────────────
+        // NowNs — the bus clock (QPC in ns, same value native code uses)
+        // ───────────────────────────────────────────────────────────────
+        public static ulong NowNs()
+        {
+            long ticks = Stopwatch.GetTimestamp();
+            long freq = Stopwatch.Frequency;
+            return (ulong)(ticks / freq * 1000000000L + ticks % freq * 1000000000L / freq);
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // MEMBERSHIP
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Join — join (or switch to) group and start receiving
+        //
+        // Returns:
+        //   false if the bus is unavailable or the group is full
+        // ───────────────────────────────────────────────────────────────
+        public static bool Join(string group)
+        {
+            lock (_lock)
+            {
+                StopReceiving();
+
+                int slot;
+                try { slot = NativeMethods.AchikoBusJoin(group); }
+                catch (Exception) { slot = -1; }   // DllNotFound / EntryPointNotFound
+
+                _slot = slot;
+                _group = slot >= 0 ? group : null;
+                if (slot < 0)
+                    return false;
+
+                _receiving = true;
+                _receiveThread = new Thread(ReceiveLoop)
+                {
+                    IsBackground = true,
+                    Name = "AchikoDLL GroupBus (Receive)",
+                    Priority = ThreadPriority.AboveNormal
+                };
+                _receiveThread.Start();
+                return true;
+            }
+        }
+
+        public static void Leave()
+        {
+            lock (_lock)
+            {
+                StopReceiving();
+                if (_slot < 0)
+                    return;
+
+                try { NativeMethods.AchikoBusLeave(); }
+                catch (Exception) { }
+                _slot = -1;
+                _group = null;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Members — slots + PIDs of the live members (self included)
+        // ───────────────────────────────────────────────────────────────
+        public static KeyValuePair<int, int>[] Members()
+        {
+            if (_slot < 0)
+                return new KeyValuePair<int, int>[0];
+
+            var slots = new uint[MaxMembers];
+            var pids = new uint[MaxMembers];
+            int count = Math.Min(NativeMethods.AchikoBusMembers(slots, pids, MaxMembers), MaxMembers);
+
+            var members = new KeyValuePair<int, int>[count];
+            for (int i = 0; i < count; i++)
+                members[i] = new KeyValuePair<int, int>((int)slots[i], (int)pids[i]);
+            return members;
+        }
+
+        // Messages lost to full rings since Join
+        public static ulong Dropped
+        {
+            get
+            {
+                try { return NativeMethods.AchikoBusDropped(); }
+                catch (Exception) { return 0; }
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // MESSAGES
+        // ═══════════════════════════════════════════════════════════════
+
+        public static bool Send(int slot, ref BusMessage message)
+        {
+            if (_slot < 0)
+                return false;
+            lock (_sendLock)
+                return NativeMethods.AchikoBusSend(slot, ref message) != 0;
+        }
+
+        // Returns how many other members accepted it
+        public static int Broadcast(ref BusMessage message)
+        {
+            if (_slot < 0)
+                return 0;
+            lock (_sendLock)
+                return NativeMethods.AchikoBusBroadcast(ref message);
+        }
+
+        public static int BroadcastTarget(ulong targetGuid)
+        {
+            var message = new BusMessage { Type = BusMessageType.Target, Arg0 = targetGuid };
+            return Broadcast(ref message);
+        }
+
+        // pullAtNs on the NowNs() clock — every member sees the same instant
+        public static int BroadcastPull(ulong targetGuid, ulong pullAtNs)
+        {
+            var message = new BusMessage { Type = BusMessageType.Pull, Arg0 = targetGuid, Arg1 = pullAtNs };
+            return Broadcast(ref message);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Ping — one ping per other member; pongs (with the one-way
+        // latency the receiver measured in Arg1) arrive via MessageReceived
+        // ───────────────────────────────────────────────────────────────
+        public static int Ping(ulong cookie)
+        {
+            var message = new BusMessage { Type = BusMessageType.Ping, Arg0 = cookie };
+            return Broadcast(ref message);
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // BROADCAST REGION
+        // ═══════════════════════════════════════════════════════════════
+
+        // Replaces this member's shared state (never blocks)
+        public static void Publish(ref BusState state)
+        {
+            if (_slot >= 0)
+                NativeMethods.AchikoBusPublish(ref state);
+        }
+
+        // false if slot never published
+        public static bool TryReadState(int slot, out BusState state)
+        {
+            state = default(BusState);
+            return _slot >= 0 && NativeMethods.AchikoBusReadState(slot, out state) != 0;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // RECEIVE THREAD
+        // ═══════════════════════════════════════════════════════════════
+
+        private static void ReceiveLoop()
+        {
+            var buffer = new BusMessage[ReceiveBatch];
+
+            while (_receiving)
+            {
+                int count;
+                try { count = NativeMethods.AchikoBusWait(buffer, ReceiveBatch, WaitTimeoutMs); }
+                catch (Exception) { break; }
+
+                ulong now = NowNs();
+                for (int i = 0; i < count; i++)
+                {
+                    if (buffer[i].Type == BusMessageType.Ping)
+                    {
+                        var pong = buffer[i];
+                        pong.Type = BusMessageType.Pong;
+                        pong.Arg1 = now - buffer[i].SentNs;
+                        Send(buffer[i].From, ref pong);
+                        continue;
+                    }
+
+                    try { MessageReceived?.Invoke(buffer[i]); }
+                    catch (Exception ex) { PipeClient.Log("[GroupBus] Handler error: " + ex.Message); }
+                }
+            }
+        }
+
+        // Caller holds _lock
+        private static void StopReceiving()
+        {
+            _receiving = false;
+            _receiveThread?.Join(2 * WaitTimeoutMs + 1000);
+            _receiveThread = null;
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,230 @@
+﻿// LogFrames.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Pooled, coalescing byte frames between PipeClient.Log and the log pipe
+//
+// Responsibilities:
+// • Encode each log line (timestamp + UTF-8 text + '\n') straight into a
+//   pooled frame — no string concatenation, no per-message byte[]
+// • Coalesce lines into frames of up to FrameBytes; the log thread writes
+//   one frame per pipe write
+// • Wake the log thread on the empty → non-empty edge (no sleep timer)
+// • Bound memory while Achikobuddy is away: at most MaxFrames, then drop
+//   and count
+//
+// Architecture:
+// • Producers (any thread) append under one short lock; the single
+//   consumer (PipeClient's log thread) takes whole frames and gives them
+//   back after writing
+// • Frames are allocated lazily up to MaxFrames and recycled forever —
+//   steady-state logging allocates nothing
+//
+// Critical Design Decisions:
+// • Encoding runs on the caller, but into a reused buffer with the
+//   non-allocating GetBytes(string, int, int, byte[], int) overload —
+//   cheaper than the old "[ts] " + msg + "\n" strings + GetBytes copy
+// • The wake event is set only when the consumer may be asleep (nothing
+//   was pending), so a burst costs one kernel call, not one per line
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+
+namespace AchikoDLL.IPC
+{
+    // ═══════════════════════════════════════════════════════════════
+    // LogFrames — multi-producer, single-consumer frame pool
+    // ═══════════════════════════════════════════════════════════════
+    internal sealed class LogFrames
+    {
+        public const int FrameBytes = 32 * 1024;     // max bytes per pipe write
+        public const int MaxFrames = 32;             // 1 MB backlog, then drop
+
+        private const int TimestampBytes = 15;       // "[HH:mm:ss.fff] "
+
+        private static readonly UTF8Encoding Utf8 = new UTF8Encoding(false);
+
+        private readonly object _lock = new object();
+        private readonly Stack<byte[]> _free = new Stack<byte[]>(MaxFrames);
+        private readonly Queue<byte[]> _sealed = new Queue<byte[]>(MaxFrames);
+        private readonly Queue<int> _sealedLengths = new Queue<int>(MaxFrames);
+        private readonly AutoResetEvent _wake = new AutoResetEvent(false);
+        private byte[] _current;         // frame being filled (null = none)
+        private int _currentLength;
+        private int _allocated;          // frames ever created (≤ MaxFrames)
+        private long _dropped;           // lines lost to a full backlog
+
+        // Lines dropped since the last TakeDropped()
+        public long TakeDropped()
+        {
+            lock (_lock)
+            {
+                long dropped = _dropped;
+                _dropped = 0;
+                return dropped;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Append — encode one line into the current frame
+        //
+        // Args:
+        //   message   - line text (no trailing '\n')
+        //   timestamp - prefix "[HH:mm:ss.fff] " (local time)
+        //
+        // Notes:
+        //   Lines longer than a frame are truncated to fit one
+        // ───────────────────────────────────────────────────────────────
+        public void Append(string message, bool timestamp)
+        {
+            // Upper bound first — GetMaxByteCount is arithmetic only
+            int chars = message.Length;
+            int prefix = timestamp ? TimestampBytes : 0;
+            int need = prefix + Utf8.GetMaxByteCount(chars) + 1;
+            if (need > FrameBytes)
+            {
+                chars = Math.Min(chars, (FrameBytes - prefix - 1) / 3 - 1);
+                if (chars > 0 && char.IsHighSurrogate(message[chars - 1]))
+                    chars--;   // never split a surrogate pair
+                need = prefix + Utf8.GetMaxByteCount(chars) + 1;
+            }
+
+            DateTime now = timestamp ? DateTime.Now : default(DateTime);
+            bool wake;
+
+            lock (_lock)
+            {
+                wake = _sealed.Count == 0 && _currentLength == 0;
+
+                if (_current != null && FrameBytes - _currentLength < need)
+                    Seal();
+                if (_current == null && !TryRent(out _current))
+                {
+                    _dropped++;
+                    return;
+                }
+
+                int at = _currentLength;
+                if (timestamp)
+                    at = WriteTimestamp(_current, at, now);
+                at += Utf8.GetBytes(message, 0, chars, _current, at);
+                _current[at++] = (byte)'\n';
+                _currentLength = at;
+            }
+
+            if (wake)
+                _wake.Set();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Wait — consumer blocks until something was appended
+        //
+        // Returns:
+        //   false on timeout (lets the caller beat its watchdog)
+        // ───────────────────────────────────────────────────────────────
+        public bool Wait(int timeoutMs)
+        {
+            return _wake.WaitOne(timeoutMs);
+        }
+
+        // Ends Wait() early (shutdown)
+        public void Wake()
+        {
+            _wake.Set();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // TryTake — oldest full frame, else the partly filled one
+        //
+        // Returns:
+        //   false if nothing is pending; otherwise the caller owns frame
+        //   until Return(frame)
+        // ───────────────────────────────────────────────────────────────
+        public bool TryTake(out byte[] frame, out int length)
+        {
+            lock (_lock)
+            {
+                if (_sealed.Count == 0 && _currentLength > 0)
+                    Seal();
+
+                if (_sealed.Count == 0)
+                {
+                    frame = null;
+                    length = 0;
+                    return false;
+                }
+
+                frame = _sealed.Dequeue();
+                length = _sealedLengths.Dequeue();
+                return true;
+            }
+        }
+
+        public void Return(byte[] frame)
+        {
+            lock (_lock)
+                _free.Push(frame);
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // INTERNALS — caller holds _lock
+        // ═══════════════════════════════════════════════════════════════
+
+        private void Seal()
+        {
+            _sealed.Enqueue(_current);
+            _sealedLengths.Enqueue(_currentLength);
+            _current = null;
+            _currentLength = 0;
+        }
+
+        private bool TryRent(out byte[] frame)
+        {
+            if (_free.Count > 0)
+            {
+                frame = _free.Pop();
+                return true;
+            }
+            if (_allocated < MaxFrames)
+            {
+                _allocated++;
+                frame = new byte[FrameBytes];
+                return true;
+            }
+            frame = null;
+            return false;
+        }
+
+        // "[HH:mm:ss.fff] " as ASCII — same text as the old $"{DateTime.Now:HH:mm:ss.fff}"
+        private static int WriteTimestamp(byte[] buffer, int at, DateTime now)
+        {
+            buffer[at++] = (byte)'[';
+            at = Write2(buffer, at, now.Hour);
+            buffer[at++] = (byte)':';
+            at = Write2(buffer, at, now.Minute);
+            buffer[at++] = (byte)':';
+            at = Write2(buffer, at, now.Second);
+            buffer[at++] = (byte)'.';
+            int ms = now.Millisecond;
+            buffer[at++] = (byte)('0' + ms / 100);
+            buffer[at++] = (byte)('0' + ms / 10 % 10);
+            buffer[at++] = (byte)('0' + ms % 10);
+            buffer[at++] = (byte)']';
+            buffer[at++] = (byte)' ';
+            return at;
+        }
+
+        private static int Write2(byte[] buffer, int at, int value)
+        {
+            buffer[at++] = (byte)('0' + value / 10);
+            buffer[at++] = (byte)('0' + value % 10);
+            return at;
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -3,21 +3,27 @@
 // Managed bidirectional pipe system for AchikoDLL ↔ Achikobuddy UI
 //
 // Responsibilities:
-// • Fire-and-forget logging — never blocks the game
+// • Fire-and-forget logging — never blocks the game; lines are encoded
+//   into pooled frames (LogFrames) and written one frame per pipe write
 // • Receives START/STOP commands from UI
 // • Auto-reconnect if Achikobuddy crashes or restarts
 // • Survives DLL unload / AppDomain teardown
 // • Emergency fallback logging if main pipe fails
 // • Detects broken pipes for BotCore auto-disable
 // • Thread-safe, high-performance, maximum stability
+// • Log thread sleeps until a line is queued — no polling interval
+// • Pipe flushes and writes traced as ipc.flush / ipc.write (Tracer)
+// • Signals the "pipes connected" bootstrap stage to Achikobuddy's
+//   process watcher once both pipes are up (BootstrapStage.h)
 // • 100% .NET 4.0 / C# 7.3 compatible
 // ─────────────────────────────────────────────────────────────────────────────
 
 using System;
-using System.Collections.Concurrent;
+using System.Diagnostics;
 using System.IO.Pipes;
 using System.Text;
 using System.Threading;
+using AchikoDLL.Diagnostics;
 
 namespace AchikoDLL.IPC
 {
@@ -32,11 +38,20 @@ namespace AchikoDLL.IPC
         private static Thread _logThread;
         private static Thread _commandThread;
         private static volatile bool _running;
-        private static readonly ConcurrentQueue<string> _queue = new ConcurrentQueue<string>();
+        private static readonly LogFrames _frames = new LogFrames();
+        private static byte[] _unsent;                // frame a failed write left behind (log thread)
+        private static int _unsentLength;
         private static readonly object _connectLock = new object();
+        private static EventWaitHandle _pipesStage;   // kept open — see SignalPipesConnected
 
         private const string LogPipeName = "AchikoPipe_AchikoDLL";
-        private const string CommandPipeName = "AchikoPipe_Commands";
+        // One command pipe per client — several bots can run side by side
+        private static readonly string CommandPipeName = "AchikoPipe_Commands_" + Process.GetCurrentProcess().Id;
+
+        private static readonly ushort TraceFlush = Tracer.Register("ipc.flush", TraceCategory.Ipc);
+        private static readonly ushort TraceWrite = Tracer.Register("ipc.write", TraceCategory.Ipc);
+
+        private const int LogIdleWaitMs = 1000;       // heartbeat period while idle
 
         // indicates whether the log pipe is broken
         public static bool IsBroken => _logPipe == null || !_logPipe.IsConnected || !_running;
@@ -92,6 +107,7 @@ namespace AchikoDLL.IPC
             Log("[PipeClient] Stop requested — shutting down...");
             _running = false;
 
+            _frames.Wake();
             try { _logThread?.Interrupt(); } catch { }
             try { _commandThread?.Interrupt(); } catch { }
 
@@ -112,8 +128,7 @@ namespace AchikoDLL.IPC
         public static void Log(string message)
         {
             if (!_running || string.IsNullOrEmpty(message)) return;
-            string line = $"[{DateTime.Now:HH:mm:ss.fff}] {message}";
-            _queue.Enqueue(line);
+            _frames.Append(message, true);
         }
 
         // ───────────────────────────────────────────────────────────────
@@ -122,29 +137,42 @@ namespace AchikoDLL.IPC
         public static void Send(string message)
         {
             if (!_running || string.IsNullOrEmpty(message)) return;
-            _queue.Enqueue(message);
+            _frames.Append(message, false);
         }
 
         // ───────────────────────────────────────────────────────────────
         // LOG THREAD — flush queue to Achikobuddy
+        //
+        // Wakes on the first line queued after an idle period (or every
+        // second for the watchdog); while disconnected it retries the
+        // pipe every 200ms instead
         // ───────────────────────────────────────────────────────────────
         private static void LogThreadLoop()
         {
             Log("[PipeClient] Log thread alive");
+            Tracer.NameThread("AchikoDLL log pipe");
+            Profiler.RegisterCurrentThread("AchikoDLL log pipe");
+            Heartbeat heartbeat = Watchdog.RegisterCurrentThread("AchikoDLL log pipe", Watchdog.DefaultTimeoutMs);
 
             while (_running)
             {
+                heartbeat.Beat();
                 try
                 {
                     EnsureLogPipeConnected();
                     FlushQueueNonBlocking();
+
+                    if (_logPipe != null && _logPipe.IsConnected)
+                        _frames.Wait(LogIdleWaitMs);
+                    else
+                        Thread.Sleep(200);   // Connect(200) already waited too
                 }
                 catch (ThreadInterruptedException) { break; }
                 catch (Exception ex) { TryWriteEmergency($"[PipeClient] LogThread error: {ex.Message}"); }
-
-                try { Thread.Sleep(33); } catch (ThreadInterruptedException) { break; }
             }
 
+            Watchdog.UnregisterCurrentThread();
+            Profiler.UnregisterCurrentThread();
             Log("[PipeClient] Log thread exiting");
         }
 
@@ -163,14 +191,19 @@ namespace AchikoDLL.IPC
 
                     if (_commandPipe != null && _commandPipe.IsConnected)
                     {
-                        byte[] buffer = new byte[256];
+                        byte[] buffer = new byte[1024];   // fits a MAX_PATH command + a follow-up
                         int bytesRead = _commandPipe.Read(buffer, 0, buffer.Length);
 
                         if (bytesRead > 0)
                         {
-                            string msg = Encoding.UTF8.GetString(buffer, 0, bytesRead).Trim('\0', '\n', '\r');
-                            if (!string.IsNullOrEmpty(msg))
+                            // Commands sent back to back arrive in one read —
+                            // one per '\n'-terminated line
+                            string text = Encoding.UTF8.GetString(buffer, 0, bytesRead);
+                            foreach (string line in text.Split('\n'))
                             {
+                                string msg = line.Trim('\0', '\r');
+                                if (string.IsNullOrEmpty(msg)) continue;
+
                                 Log($"[PipeClient] Received command: {msg}");
                                 OnMessage?.Invoke(msg);
                             }
@@ -204,6 +237,7 @@ namespace AchikoDLL.IPC
                     _logPipe = new NamedPipeClientStream(".", LogPipeName, PipeDirection.Out, PipeOptions.Asynchronous);
                     _logPipe.Connect(200);
                     Log("[PipeClient] Log pipe connected to Achikobuddy!");
+                    SignalPipesConnected();
                 }
                 catch { DisposeLogPipe(); }
             }
@@ -225,30 +259,75 @@ namespace AchikoDLL.IPC
                 Log("[PipeClient] Waiting for Achikobuddy to connect command pipe...");
                 _commandPipe.WaitForConnection();
                 Log("[PipeClient] Command pipe connected!");
+                SignalPipesConnected();
             }
             catch { DisposeCommandPipe(); }
         }
 
         // ───────────────────────────────────────────────────────────────
-        // flush queued messages without blocking main thread
+        // SignalPipesConnected — last bootstrap stage for the Launcher
+        //
+        // Behavior:
+        //   • Sets "AchikoBootstrap_PID_<pid>_4" once both pipes are up;
+        //     the event only exists if Achikobuddy's watcher created it
+        //   • Handle stays open so a restarted Achikobuddy still sees the
+        //     stage as signalled
+        // ───────────────────────────────────────────────────────────────
+        private static void SignalPipesConnected()
+        {
+            if (_pipesStage != null) return;
+            if (_logPipe == null || !_logPipe.IsConnected) return;
+            if (_commandPipe == null || !_commandPipe.IsConnected) return;
+
+            try
+            {
+                int pid = Process.GetCurrentProcess().Id;
+                _pipesStage = EventWaitHandle.OpenExisting($"AchikoBootstrap_PID_{pid}_4");
+                _pipesStage.Set();
+            }
+            catch (Exception)
+            {
+                // WaitHandleCannotBeOpenedException — no watcher running
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // flush queued frames without blocking main thread
+        //
+        // Behavior:
+        //   • One pipe write per frame — every line queued since the last
+        //     flush, up to LogFrames.FrameBytes
+        //   • A failed write keeps its frame in _unsent and retries it
+        //     first after reconnecting — nothing is reordered or lost
         // ───────────────────────────────────────────────────────────────
         private static void FlushQueueNonBlocking()
         {
             if (_logPipe == null || !_logPipe.IsConnected) return;
 
-            string msg;
-            while (_queue.TryDequeue(out msg))
+            long dropped = _frames.TakeDropped();
+            if (dropped > 0)
+                Log("[PipeClient] " + dropped + " log line(s) dropped — backlog full");
+
+            using (Tracer.Span(TraceFlush))
             {
-                try
-                {
-                    byte[] data = Encoding.UTF8.GetBytes(msg + "\n");
-                    _logPipe.Write(data, 0, data.Length);
-                }
-                catch
+                while (true)
                 {
-                    DisposeLogPipe();
-                    _queue.Enqueue(msg);
-                    break;
+                    if (_unsent == null && !_frames.TryTake(out _unsent, out _unsentLength))
+                        break;
+
+                    try
+                    {
+                        using (Tracer.Span(TraceWrite))
+                            _logPipe.Write(_unsent, 0, _unsentLength);
+                    }
+                    catch
+                    {
+                        DisposeLogPipe();
+                        break;
+                    }
+
+                    _frames.Return(_unsent);
+                    _unsent = null;
                 }
             }
         }
@@ -260,18 +339,12 @@ namespace AchikoDLL.IPC
         {
             if (_logPipe == null || !_logPipe.IsConnected) return;
 
-            int attempts = 0;
-            string msg;
-            while (_queue.TryDequeue(out msg) && attempts++ < 1000)
+            try
             {
-                try
-                {
-                    byte[] data = Encoding.UTF8.GetBytes(msg + "\n");
-                    _logPipe.Write(data, 0, data.Length);
-                    _logPipe.Flush();
-                }
-                catch { break; }
+                FlushQueueNonBlocking();
+                _logPipe?.Flush();
             }
+            catch { }
         }
 
         // ───────────────────────────────────────────────────────────────
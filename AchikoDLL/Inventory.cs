@@ -0,0 +1,304 @@
+﻿// Inventory.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's inventory snapshot
+// (InventorySnapshot.h) — bag contents, change events, item metadata
+//
+// Responsibilities:
+// • Configure(): hand the client build's inventory offsets to native code
+// • Refresh(): one call per tick → change events (Changed) and, only when
+//   the contents hash moved, a fresh managed copy of the occupied slots
+// • Slot() / CountOf() / FreeSlots / TryGetInfo(): what vendor, equip and
+//   destroy decisions ask — plain reads of managed state
+// • Report(): INVENTORY_REPORT
+//
+// Architecture:
+// • Native code re-reads every bag slot per tick (~100 guarded copies,
+//   a few µs) and diffs per-slot hashes; managed code sees a hash and a
+//   usually empty event span
+// • Item metadata (quality, sell price, name, …) is read once per entry
+//   natively and memoized here once resolved
+//
+// Critical Design Decisions:
+// • Bot thread only: Refresh() after ObjectSnapshot.Take() of the same
+//   tick (items resolve through that object list), before EndTick()
+// • Changed fires synchronously inside Refresh() — keep handlers short
+// • Missing native exports = Configure() returns false, inventory empty
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors InventoryLayout in InventorySnapshot.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InventoryLayout
+    {
+        public ulong ItemTable;            // client table: record pointer per entry (0 = no metadata)
+        public uint ItemTableMin;          // entry of ItemTable[0]
+        public uint ItemTableCount;
+        public uint ObjectDescriptors;     // object → descriptor block pointer
+        public uint PlayerPackSlots;       // player descriptors → ulong GUID[PackSlotCount]
+        public uint PackSlotCount;
+        public uint PlayerBagSlots;        // player descriptors → ulong GUID[BagCount]
+        public uint BagCount;
+        public uint ContainerSlotCount;    // container descriptors → uint
+        public uint ContainerSlots;        // container descriptors → ulong GUID[slot count]
+        public uint ItemEntry;
+        public uint ItemStackCount;
+        public uint ItemDurability;
+        public uint ItemFlags;
+        public uint RecordQuality;
+        public uint RecordClass;
+        public uint RecordSubClass;
+        public uint RecordSellPrice;
+        public uint RecordMaxStack;
+        public uint RecordItemLevel;
+        public uint RecordName;            // item record → char* name
+        public uint Reserved;
+    }
+
+    // Mirrors InventorySlot in InventorySnapshot.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InventorySlot
+    {
+        public ulong Guid;
+        public uint Entry;
+        public uint StackCount;
+        public uint Durability;
+        public uint Flags;
+        public byte Bag;                   // 0 = backpack, 1-4 = equipped bags
+        public byte Slot;
+        public ushort Reserved;
+        public uint Hash;
+    }
+
+    // Mirrors InventoryEventType in InventorySnapshot.h
+    public enum InventoryEventType : byte
+    {
+        Added = 1,
+        Removed = 2,
+        StackChanged = 3,
+        Changed = 4                        // durability / flags
+    }
+
+    // Mirrors InventoryEvent in InventorySnapshot.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InventoryEvent
+    {
+        public ulong Guid;
+        public uint Entry;
+        public uint StackCount;            // after the change (0 when removed)
+        public int StackDelta;
+        public InventoryEventType Type;
+        public byte Bag;
+        public byte Slot;
+        public byte Reserved;
+    }
+
+    // Mirrors ItemInfo in InventorySnapshot.h
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct ItemInfo
+    {
+        public uint Entry;
+        public uint SellPrice;             // copper
+        public uint MaxStack;
+        public uint ItemLevel;
+        public byte Quality;               // 0 poor … 5 legendary
+        public byte ItemClass;
+        public byte SubClass;
+        public byte Resolved;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 44)]
+        public string Name;
+    }
+
+    // Mirrors InventoryStats in InventorySnapshot.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InventoryStats
+    {
+        public ulong Refreshes;
+        public ulong Changed;
+        public ulong Events;
+        public ulong Unresolved;
+        public ulong Faults;
+        public ulong RefreshNs;
+        public ulong IndexRebuilds;
+        public uint LastSlots;
+        public uint LastItems;
+        public uint InfoCached;
+        public uint InfoMisses;
+        public uint Hash;
+        public uint Reserved;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // Inventory — static API, bot thread only
+    // ═══════════════════════════════════════════════════════════════
+    public static class Inventory
+    {
+        private static volatile bool _available = true;   // false once exports are missing
+        private static bool _configured;
+        private static bool _synced;                       // _slots matches _hash
+        private static uint _hash;
+        private static InventorySlot[] _slots = new InventorySlot[0];
+        private static readonly Dictionary<uint, ItemInfo> _info = new Dictionary<uint, ItemInfo>();
+        private static ulong _slotCopies;
+
+        // Fired inside Refresh() for every change since the last tick
+        public static event Action<InventoryEvent> Changed;
+
+        public static int SlotCount => _slots.Length;
+
+        // Empty slots over backpack and bags, as of the last slot copy
+        public static int FreeSlots { get; private set; }
+
+        public static bool Configure(InventoryLayout layout)
+        {
+            if (!_available) return false;
+
+            try { _configured = NativeMethods.AchikoInventoryConfigure(ref layout) != 0; }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                _configured = false;
+            }
+            _synced = false;
+            _slots = new InventorySlot[0];
+            _info.Clear();
+            return _configured;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Refresh — this tick's bag changes
+        //
+        // Args:
+        //   playerGuid - local player
+        //
+        // Returns:
+        //   Change events raised; -1 if not configured / unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static int Refresh(ulong playerGuid)
+        {
+            if (!_configured) return -1;
+
+            ArenaSpan events;
+            uint hash;
+            int count = NativeMethods.AchikoInventoryRefresh(playerGuid, out events, out hash);
+            if (count < 0) return -1;
+
+            var handler = Changed;
+            if (handler != null)
+                for (int i = 0; i < events.Count; ++i)
+                    handler(ReadEvent(events, i));
+
+            if (!_synced || hash != _hash)
+                CopySlots();
+            _hash = hash;
+            return count;
+        }
+
+        public static InventorySlot Slot(int index) => _slots[index];
+
+        // Items of entry across all bags (stack counts summed)
+        public static uint CountOf(uint entry)
+        {
+            uint total = 0;
+            foreach (InventorySlot slot in _slots)
+                if (slot.Entry == entry)
+                    total += slot.StackCount;
+            return total;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // TryGetInfo — metadata for an item entry
+        //
+        // Returns:
+        //   false while the client has not cached the item (retry later)
+        // ───────────────────────────────────────────────────────────────
+        public static bool TryGetInfo(uint entry, out ItemInfo info)
+        {
+            if (_info.TryGetValue(entry, out info)) return true;
+            if (!_configured) return false;
+
+            if (NativeMethods.AchikoInventoryItemInfo(entry, out info) == 0) return false;
+            _info[entry] = info;
+            return true;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — INVENTORY_REPORT lines; null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            InventoryStats s;
+            try { NativeMethods.AchikoInventoryStats(out s); }
+            catch (Exception) { return null; }
+
+            double refreshes = Math.Max(1UL, s.Refreshes);
+            return new[]
+            {
+                $"bags: {s.LastItems} items in {s.LastSlots} slots, hash {s.Hash:X8}; " +
+                    $"{s.Changed} of {s.Refreshes} refreshes changed ({s.Events} events), " +
+                    $"{_slotCopies} managed slot copies",
+                $"refresh: {s.RefreshNs / refreshes / 1000.0:F1} µs avg, {s.IndexRebuilds} GUID index rebuilds, " +
+                    $"{s.Unresolved} unresolved item reads, {s.Faults} player read faults",
+                $"item metadata: {s.InfoCached} cached, {s.InfoMisses} waiting for the client"
+            };
+        }
+
+        private static void CopySlots()
+        {
+            ArenaSpan span;
+            if (NativeMethods.AchikoInventorySlots(out span) < 0) return;
+
+            var slots = new InventorySlot[span.Count];
+            for (int i = 0; i < slots.Length; ++i)
+            {
+                uint bagSlot = span.ReadUInt32(i, 24);
+                slots[i] = new InventorySlot
+                {
+                    Guid = span.ReadUInt64(i, 0),
+                    Entry = span.ReadUInt32(i, 8),
+                    StackCount = span.ReadUInt32(i, 12),
+                    Durability = span.ReadUInt32(i, 16),
+                    Flags = span.ReadUInt32(i, 20),
+                    Bag = (byte)bagSlot,
+                    Slot = (byte)(bagSlot >> 8),
+                    Hash = span.ReadUInt32(i, 28)
+                };
+            }
+
+            InventoryStats s;
+            NativeMethods.AchikoInventoryStats(out s);
+            FreeSlots = (int)(s.LastSlots - s.LastItems);
+            _slots = slots;
+            _synced = true;
+            ++_slotCopies;
+        }
+
+        private static InventoryEvent ReadEvent(ArenaSpan span, int i)
+        {
+            uint typeBagSlot = span.ReadUInt32(i, 20);
+            return new InventoryEvent
+            {
+                Guid = span.ReadUInt64(i, 0),
+                Entry = span.ReadUInt32(i, 8),
+                StackCount = span.ReadUInt32(i, 12),
+                StackDelta = (int)span.ReadUInt32(i, 16),
+                Type = (InventoryEventType)(byte)typeBagSlot,
+                Bag = (byte)(typeBagSlot >> 8),
+                Slot = (byte)(typeBagSlot >> 16)
+            };
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -29,6 +29,7 @@
 using System;
 using System.Diagnostics;
 using System.Threading;
+using AchikoDLL.Diagnostics;
 using AchikoDLL.IPC;
 
 namespace AchikoDLL
@@ -66,9 +67,10 @@ namespace AchikoDLL
         //   1. Starts PipeClient (both log + command pipes)
         //   2. Waits 50ms for pipe connection to Achikobuddy
         //   3. Logs startup banner with PID
-        //   4. Creates BotCore instance (thread starts immediately)
-        //   5. Subscribes to PipeClient.OnMessage for UI commands
-        //   6. Returns 0 (success) to RemoteAchiko.cpp
+        //   4. Starts GcScheduler (full-GC approach notifications)
+        //   5. Creates BotCore instance (thread starts immediately)
+        //   6. Subscribes to PipeClient.OnMessage for UI commands
+        //   7. Returns 0 (success) to RemoteAchiko.cpp
         //
         // Called by:
         //   RemoteAchiko.cpp via CLR ExecuteInDefaultAppDomain()
@@ -111,10 +113,33 @@ namespace AchikoDLL
                     PipeClient.Log("Loader.Start() invoked — initializing bot");
                     PipeClient.Log("C# runtime successfully loaded in WoW");
                     PipeClient.Log($"Target PID: {Process.GetCurrentProcess().Id}");
+                    if (AllocProfiler.IsActive)
+                        PipeClient.Log("Allocation profiler ACTIVE — ALLOC_REPORT lists top allocators");
                     PipeClient.Log("═══════════════════════════════════════════");
 
+                    // Settings / offsets — before anything that reads them
+                    PipeClient.Log(Config.Open()
+                        ? "Config: " + string.Join("; ", Config.Report())
+                        : "Config unavailable — RemoteAchiko.dll exports not found");
+
+                    // ───────────────────────────────────────────────────
+                    // Step 3: GC steering (needs concurrent GC off — the
+                    // bootstrapper clears it before starting the CLR)
                     // ───────────────────────────────────────────────────
-                    // Step 3: Create BotCore singleton
+                    PipeClient.Log(GcScheduler.Start()
+                        ? "GC scheduler ACTIVE — full GCs steered out of combat (GC_REPORT)"
+                        : "GC scheduler: full-GC notifications unavailable (concurrent GC) — overlap counters only");
+
+                    // Address-space monitor + default memory budgets
+                    MemoryBudget.Start();
+
+                    // Spawns / vendors / nodes from earlier sessions
+                    PipeClient.Log(WorldKnowledge.Open()
+                        ? "World knowledge: " + WorldKnowledge.Report()
+                        : "World knowledge unavailable — store could not be opened");
+
+                    // ───────────────────────────────────────────────────
+                    // Step 4: Create BotCore singleton
                     // ───────────────────────────────────────────────────
                     // BotCore constructor starts the bot thread immediately
                     // Thread will be idle until UI sends START command
@@ -122,11 +147,12 @@ namespace AchikoDLL
                     PipeClient.Log("BotCore instance created — thread started, awaiting UI enable");
 
                     // ───────────────────────────────────────────────────
-                    // Step 4: Subscribe to incoming UI commands
+                    // Step 5: Subscribe to incoming UI commands
                     // ───────────────────────────────────────────────────
                     // When Achikobuddy UI sends "START" or "STOP" via pipe,
                     // PipeClient fires OnMessage event → HandleCommand() runs
                     PipeClient.OnMessage += HandleCommand;
+                    GroupBus.MessageReceived += OnGroupMessage;
 
                     return 0; // Success — tell RemoteAchiko.cpp all is well
                 }
@@ -148,11 +174,41 @@ namespace AchikoDLL
         // HandleCommand — process incoming UI commands from pipe
         //
         // Args:
-        //   msg - command string from Achikobuddy ("START" or "STOP")
+        //   msg - command string from Achikobuddy ("START", "STOP", "TRACE_...", "PROFILE_...")
         //
         // Behavior:
         //   • "START" → calls BotCore.Start() → bot begins ticking
         //   • "STOP"  → calls BotCore.Stop() → bot goes idle
+        //   • "TRACE_ON" / "TRACE_OFF" → start/stop span recording
+        //   • "TRACE_DUMP|<path>" → stop recording, write Chrome trace JSON
+        //   • "PROFILE_ON|<hz>[|<budget‰>]" → start the sampling profiler
+        //   • "PROFILE_DUMP|<path>" → stop sampling, write collapsed stacks
+        //   • "ALLOC_REPORT" → log the top allocators (allocation profiler)
+        //   • "GC_SCHED_ON" / "GC_SCHED_OFF" → toggle full-GC steering
+        //   • "GC_REPORT" → log combat ticks hit by gen2, steering off vs on
+        //   • "COMBAT_ON" / "COMBAT_OFF" → set the bot's combat state
+        //   • "GROUP_JOIN|<name>" / "GROUP_LEAVE" → group bus membership
+        //   • "GROUP_PING" → log one-way bus latency to every member
+        //   • "ACTION_WINDOW|<ms>" → action queue lead window (0 = reactive)
+        //   • "ACTION_REPORT" → log idle between casts, reactive vs queued
+        //   • "EFFECT_REPORT" / "EFFECT_RESET" → decision → effect latency
+        //   • "ARENA_REPORT" → log tick arena usage and high-water mark
+        //   • "ARENA_POISON_ON" / "ARENA_POISON_OFF" → debug poison of
+        //     released arena memory
+        //   • "OBJECTS_REPORT" → log object enumeration and descriptor copies
+        //   • "MEMORY_REPORT" → scan now, log address space + commit by owner
+        //   • "WORLD_REPORT" / "WORLD_COMPACT" → world knowledge store size,
+        //     hit counts / merge the log into a new base now
+        //   • "INVENTORY_REPORT" → log bag contents, change and refresh counts
+        //   • "GRIND_LOAD|<path>" / "GRIND_REPORT" → map a grind profile /
+        //     log its contents and route cost
+        //   • "GRIND_OPTIMIZE|<path>" → reorder a profile's hotspot loop
+        //     (background thread, result logged when done)
+        //   • "CONFIG_REPORT" / "CONFIG_RELOAD" → log config generation and
+        //     reload counts / check the config files now
+        //   • "HOOK_REPORT" / "HOOK_RESET" → per-hook calls, time, managed
+        //     transitions and budget alarms, filtered hooks and transitions
+        //     saved / zero the hook counters
         //   • Logs all commands for debugging
         //
         // Called by:
@@ -184,11 +240,359 @@ namespace AchikoDLL
                     PipeClient.Log("[Loader] STOP command received — bot DISABLED");
                     break;
 
+                case "TRACE_ON":
+                    PipeClient.Log(Tracer.SetEnabled(true)
+                        ? "[Loader] Tracing ENABLED"
+                        : "[Loader] Tracing unavailable — RemoteAchiko.dll exports not found");
+                    break;
+
+                case "TRACE_OFF":
+                    Tracer.SetEnabled(false);
+                    PipeClient.Log("[Loader] Tracing DISABLED");
+                    break;
+
+                case "ALLOC_REPORT":
+                    ReportAllocations();
+                    break;
+
+                case "GC_SCHED_ON":
+                    PipeClient.Log(GcScheduler.SetEnabled(true)
+                        ? "[Loader] GC steering ENABLED"
+                        : "[Loader] GC steering unavailable — concurrent GC is on");
+                    break;
+
+                case "GC_SCHED_OFF":
+                    GcScheduler.SetEnabled(false);
+                    PipeClient.Log("[Loader] GC steering DISABLED");
+                    break;
+
+                case "GC_REPORT":
+                    foreach (string line in GcScheduler.Report())
+                        PipeClient.Log("[GC] " + line);
+                    break;
+
+                case "COMBAT_ON":
+                case "COMBAT_OFF":
+                    if (_botCore != null)
+                        _botCore.InCombat = msg == "COMBAT_ON";
+                    PipeClient.Log($"[Loader] Combat state → {(msg == "COMBAT_ON" ? "IN COMBAT" : "out of combat")}");
+                    break;
+
+                case "GROUP_LEAVE":
+                    GroupBus.Leave();
+                    PipeClient.Log("[Loader] Left group bus");
+                    break;
+
+                case "GROUP_PING":
+                    PingGroup();
+                    break;
+
+                case "EFFECT_REPORT":
+                    string[] effects = EffectLatency.Report();
+                    if (effects == null)
+                        PipeClient.Log("[Loader] Effect tracking unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in effects)
+                            PipeClient.Log("[EffectReport] " + line);
+                    break;
+
+                case "EFFECT_RESET":
+                    EffectLatency.Reset();
+                    PipeClient.Log("[Loader] Decision → effect histograms cleared");
+                    break;
+
+                case "ACTION_REPORT":
+                    string[] report = ActionQueue.Report();
+                    if (report == null)
+                        PipeClient.Log("[Loader] Action queue unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in report)
+                            PipeClient.Log("[Action] " + line);
+                    break;
+
+                case "ARENA_REPORT":
+                    string arena = TickArena.Report();
+                    PipeClient.Log(arena == null
+                        ? "[Loader] Tick arena unavailable — RemoteAchiko.dll exports not found"
+                        : "[Arena] " + arena);
+                    break;
+
+                case "ARENA_POISON_ON":
+                case "ARENA_POISON_OFF":
+                    bool poison = msg == "ARENA_POISON_ON";
+                    PipeClient.Log(TickArena.SetPoison(poison)
+                        ? $"[Loader] Arena poison {(poison ? "ENABLED" : "DISABLED")}"
+                        : "[Loader] Tick arena unavailable — RemoteAchiko.dll exports not found");
+                    break;
+
+                case "OBJECTS_REPORT":
+                    string[] objects = ObjectSnapshot.Report();
+                    if (objects == null)
+                        PipeClient.Log("[Loader] Object snapshot unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in objects)
+                            PipeClient.Log("[Objects] " + line);
+                    break;
+
+                case "MEMORY_REPORT":
+                    string[] memory = MemoryBudget.Report();
+                    if (memory == null)
+                        PipeClient.Log("[Loader] Memory monitor unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in memory)
+                            PipeClient.Log("[MemoryReport] " + line);
+                    break;
+
+                case "WORLD_REPORT":
+                    string world = WorldKnowledge.Report();
+                    PipeClient.Log(world == null
+                        ? "[Loader] World knowledge store not open"
+                        : "[World] " + world);
+                    break;
+
+                case "WORLD_COMPACT":
+                    PipeClient.Log(WorldKnowledge.Compact()
+                        ? "[Loader] World knowledge compaction requested"
+                        : "[Loader] World knowledge store not open");
+                    break;
+
+                case "INVENTORY_REPORT":
+                    string[] inventory = Inventory.Report();
+                    if (inventory == null)
+                        PipeClient.Log("[Loader] Inventory snapshot unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in inventory)
+                            PipeClient.Log("[Inventory] " + line);
+                    break;
+
+                case "GRIND_REPORT":
+                    string grind = GrindProfile.Report();
+                    PipeClient.Log(grind == null
+                        ? "[Loader] No grind profile loaded"
+                        : "[Grind] " + grind);
+                    break;
+
+                case "CONFIG_REPORT":
+                    string[] config = Config.Report();
+                    if (config == null)
+                        PipeClient.Log("[Loader] Config unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in config)
+                            PipeClient.Log("[Config] " + line);
+                    break;
+
+                case "CONFIG_RELOAD":
+                    PipeClient.Log(Config.Reload()
+                        ? $"[Config] Generation {Config.Generation} live"
+                        : "[Loader] Config unchanged (or rejected — see CONFIG_REPORT)");
+                    break;
+
+                case "HOOK_REPORT":
+                    string[] hooks = HookMeter.Report();
+                    if (hooks == null)
+                        PipeClient.Log("[Loader] Hook meter unavailable — RemoteAchiko.dll exports not found");
+                    else
+                        foreach (string line in hooks)
+                            PipeClient.Log("[Hooks] " + line);
+                    string[] filters = HookFilter.Report();
+                    if (filters != null)
+                        foreach (string line in filters)
+                            PipeClient.Log("[Hooks] " + line);
+                    break;
+
+                case "HOOK_RESET":
+                    HookMeter.Reset();
+                    PipeClient.Log("[Loader] Hook counters reset");
+                    break;
+
+                default:
+                    if (msg.StartsWith("TRACE_DUMP|", StringComparison.Ordinal))
+                        DumpTrace(msg.Substring("TRACE_DUMP|".Length));
+                    else if (msg.StartsWith("PROFILE_ON|", StringComparison.Ordinal))
+                        StartProfile(msg.Substring("PROFILE_ON|".Length));
+                    else if (msg.StartsWith("PROFILE_DUMP|", StringComparison.Ordinal))
+                        DumpProfile(msg.Substring("PROFILE_DUMP|".Length));
+                    else if (msg.StartsWith("GROUP_JOIN|", StringComparison.Ordinal))
+                        JoinGroup(msg.Substring("GROUP_JOIN|".Length));
+                    else if (msg.StartsWith("ACTION_WINDOW|", StringComparison.Ordinal))
+                        SetActionWindow(msg.Substring("ACTION_WINDOW|".Length));
+                    else if (msg.StartsWith("GRIND_LOAD|", StringComparison.Ordinal))
+                        LoadGrindProfile(msg.Substring("GRIND_LOAD|".Length));
+                    else if (msg.StartsWith("GRIND_OPTIMIZE|", StringComparison.Ordinal))
+                        OptimizeGrindProfile(msg.Substring("GRIND_OPTIMIZE|".Length));
+
                     // Future commands can be added here:
                     // case "PAUSE": ...
                     // case "STATUS": ...
-                    // default: PipeClient.Log($"Unknown command: {msg}");
+                    break;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // DumpTrace — stop recording and export Chrome trace-event JSON
+        //
+        // Args:
+        //   path - absolute file path chosen by Achikobuddy
+        //
+        // Behavior:
+        //   • Disabling first makes the native flusher drain every
+        //     thread buffer, so the file holds everything up to now
+        //   • Result (event count / dropped) goes back as a log line
+        // ───────────────────────────────────────────────────────────────
+        private static void DumpTrace(string path)
+        {
+            Tracer.SetEnabled(false);
+
+            int written = Tracer.Export(path);
+            if (written < 0)
+                PipeClient.Log($"[Loader] Trace export FAILED → {path}");
+            else
+                PipeClient.Log($"[Loader] Trace written: {written} events ({Tracer.Dropped} dropped) → {path}");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // StartProfile — start sampling registered threads
+        //
+        // Args:
+        //   args - "<hz>" or "<hz>|<budget‰>"; bad numbers fall back to the
+        //          Profiler defaults
+        // ───────────────────────────────────────────────────────────────
+        private static void StartProfile(string args)
+        {
+            string[] parts = args.Split('|');
+            int hz, budget;
+            if (!int.TryParse(parts[0], out hz) || hz <= 0)
+                hz = Profiler.DefaultHz;
+            if (parts.Length < 2 || !int.TryParse(parts[1], out budget) || budget <= 0)
+                budget = Profiler.DefaultBudgetPermille;
+
+            // One measurement window for CPU samples and allocations
+            AllocProfiler.Reset();
+
+            if (Profiler.Start(hz, budget))
+                PipeClient.Log($"[Loader] Profiling ENABLED — {hz} Hz, budget {budget}‰, {Profiler.PublishedSymbols} managed symbols");
+            else
+                PipeClient.Log("[Loader] Profiling unavailable — RemoteAchiko.dll exports not found");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // DumpProfile — stop sampling and write collapsed stacks
+        //
+        // Args:
+        //   path - absolute file path chosen by Achikobuddy (.folded)
+        // ───────────────────────────────────────────────────────────────
+        private static void DumpProfile(string path)
+        {
+            int written = Profiler.Dump(path);
+            if (written < 0)
+                PipeClient.Log($"[Loader] Profile export FAILED → {path}");
+            else
+                PipeClient.Log($"[Loader] Profile written: {written} stacks ({Profiler.Summary()}) → {path}");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // JoinGroup — join the named group bus (leaves the current one)
+        // ───────────────────────────────────────────────────────────────
+        private static void JoinGroup(string group)
+        {
+            if (string.IsNullOrEmpty(group))
+            {
+                PipeClient.Log("[Loader] GROUP_JOIN needs a group name");
+                return;
             }
+
+            if (GroupBus.Join(group))
+                PipeClient.Log($"[Loader] Joined group bus \"{group}\" as slot {GroupBus.Slot} ({GroupBus.Members().Length} members)");
+            else
+                PipeClient.Log($"[Loader] Group bus \"{group}\" unavailable — group full or RemoteAchiko.dll exports not found");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // PingGroup — ping every other member; OnGroupMessage logs the
+        // one-way latency each receiver measured
+        // ───────────────────────────────────────────────────────────────
+        private static void PingGroup()
+        {
+            if (!GroupBus.Joined)
+            {
+                PipeClient.Log("[Loader] Not in a group — GROUP_JOIN|<name> first");
+                return;
+            }
+
+            int sent = GroupBus.Ping(GroupBus.NowNs());
+            PipeClient.Log($"[Loader] Pinged {sent} member(s), {GroupBus.Dropped} dropped so far");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // SetActionWindow — "<ms>"; 0 switches the queue to reactive so
+        // ACTION_REPORT can compare both on the same fight
+        // ───────────────────────────────────────────────────────────────
+        private static void SetActionWindow(string args)
+        {
+            int windowMs;
+            if (!int.TryParse(args, out windowMs) || windowMs < 0)
+            {
+                PipeClient.Log($"[Loader] ACTION_WINDOW needs a window in ms, got \"{args}\"");
+                return;
+            }
+
+            if (ActionQueue.SetWindow(windowMs))
+                PipeClient.Log(windowMs > 0
+                    ? $"[Loader] Action queue window → {windowMs} ms"
+                    : "[Loader] Action queue → reactive (submit on readiness)");
+            else
+                PipeClient.Log("[Loader] Action queue unavailable — RemoteAchiko.dll exports not found");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // LoadGrindProfile — GRIND_LOAD|<path> (relative = Profiles\)
+        // ───────────────────────────────────────────────────────────────
+        private static void LoadGrindProfile(string path)
+        {
+            if (GrindProfile.Load(path))
+                PipeClient.Log("[Grind] " + GrindProfile.Report());
+            else
+                PipeClient.Log($"[Loader] Grind profile FAILED to load — missing or invalid: {GrindProfile.ResolvePath(path)}");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // OptimizeGrindProfile — GRIND_OPTIMIZE|<path>; logs twice (start,
+        // result from the optimizer thread)
+        // ───────────────────────────────────────────────────────────────
+        private static void OptimizeGrindProfile(string path)
+        {
+            bool started = GrindProfile.Optimize(path, null, report =>
+                PipeClient.Log(report.HasValue
+                    ? "[Grind] Route optimized — " + GrindProfile.Describe(report.Value)
+                    : $"[Loader] Grind route optimization FAILED — {GrindProfile.ResolvePath(path)}"));
+
+            PipeClient.Log(started
+                ? $"[Loader] Optimizing grind route → {GrindProfile.ResolvePath(path)}"
+                : "[Loader] Grind route optimizer busy or unavailable");
+        }
+
+        private static void OnGroupMessage(BusMessage message)
+        {
+            if (message.Type == BusMessageType.Pong)
+                PipeClient.Log($"[Group] Slot {message.From}: one-way {message.Arg1 / 1000.0:F1} µs");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // ReportAllocations — top 15 allocation sites to the UI log
+        //
+        // Format (per site):
+        //   #rank  est. bytes  share  Type <- AllocatingMethod <- Caller
+        // ───────────────────────────────────────────────────────────────
+        private static void ReportAllocations()
+        {
+            if (!AllocProfiler.IsActive)
+            {
+                PipeClient.Log("[Loader] Allocation profiler not active — tick \"Profile allocations\" in the launcher");
+                return;
+            }
+
+            foreach (string line in AllocProfiler.Report(15))
+                PipeClient.Log("[Alloc] " + line);
         }
 
         // ═══════════════════════════════════════════════════════════════
@@ -202,8 +606,11 @@ namespace AchikoDLL
         //   1. Logs shutdown banner
         //   2. Calls BotCore.Shutdown() → stops thread, waits 3s for exit
         //   3. Nulls out BotCore reference (allows GC)
-        //   4. Calls PipeClient.Stop() → stops both pipe threads
-        //   5. Logs final goodbye message
+        //   4. Stops the GC scheduler watcher
+        //   5. Stops the action queue's submit thread
+        //   6. Leaves the group bus (frees the slot for the next client)
+        //   7. Calls PipeClient.Stop() → stops both pipe threads
+        //   8. Logs final goodbye message
         //
         // Called by:
         //   Previously: exported UnloadAchiko() from native code
@@ -238,6 +645,9 @@ namespace AchikoDLL
                     _botCore?.Shutdown();
                     _botCore = null;
                     PipeClient.Log("BotCore stopped successfully");
+
+                    // Nobody drains the event ring from here on
+                    HookFilter.RemoveAll();
                 }
                 catch (Exception ex)
                 {
@@ -245,6 +655,19 @@ namespace AchikoDLL
                     PipeClient.Log($"Error during BotCore.Shutdown(): {ex.Message}");
                 }
 
+                // Cancel GC notifications, restore the latency mode
+                GcScheduler.Stop();
+
+                ActionQueue.Stop();
+
+                // Log stays on disk; the next session replays it
+                WorldKnowledge.Close();
+                GrindProfile.Unload();
+                Config.Close();
+
+                // Free our group slot now rather than after the stale timeout
+                GroupBus.Leave();
+
                 // ───────────────────────────────────────────────────────
                 // Shut down PipeClient (stops log + command threads)
                 // ───────────────────────────────────────────────────────
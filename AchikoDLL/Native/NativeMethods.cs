@@ -0,0 +1,409 @@
+﻿// NativeMethods.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// P/Invoke declarations for the exports of RemoteAchiko.dll
+//
+// Responsibilities:
+// • One place for every extern "C" export declared in Exports.cpp
+// • Signatures mirror the native side exactly (cdecl, fixed-width ints)
+//
+// Architecture:
+// • RemoteAchiko.dll is already loaded in WoW (it bootstrapped us), so
+//   "RemoteAchiko.dll" resolves to the injected module — no path needed
+// • Callers wrap these in safe managed APIs (Tracer, ...) and treat
+//   DllNotFoundException / EntryPointNotFoundException as "feature off"
+//
+// Critical Design Decisions:
+// • SuppressUnmanagedCodeSecurity — skips the per-call stack walk; these
+//   sit on hot paths (one call per trace span)
+// • No marshaling on hot calls — blittable arguments only
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Security;
+using System.Text;
+using AchikoDLL.Diagnostics;
+using AchikoDLL.IPC;
+
+namespace AchikoDLL.Native
+{
+    // ═══════════════════════════════════════════════════════════════
+    // NativeMethods — raw imports, keep in sync with Exports.cpp
+    // ═══════════════════════════════════════════════════════════════
+    [SuppressUnmanagedCodeSecurity]
+    internal static class NativeMethods
+    {
+        private const string RemoteAchiko = "RemoteAchiko.dll";
+
+        // ───────────────────────────────────────────────────────────────
+        // Tracing (Trace.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoTraceSetEnabled(int enabled);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoTraceIsEnabled();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern ushort AchikoTraceRegister(string name, int category);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoTraceRecord(ushort nameId, long startTicks, long endTicks);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoTraceInstant(ushort nameId, long ticks);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern void AchikoTraceNameThread(string name);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoTraceExport(string path);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern ulong AchikoTraceDropped();
+
+        // ───────────────────────────────────────────────────────────────
+        // Sampling profiler (Sampler.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoProfilerRegisterThread(string name);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoProfilerUnregisterThread();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern void AchikoProfilerAddSymbol(IntPtr start, string name);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoProfilerStart(int hz, int budgetPermille);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoProfilerStop();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoProfilerIsRunning();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoProfilerDump(string path);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoProfilerStats(out ulong samples, out ulong failed,
+            out int effectiveHz, out int avgPassUs);
+
+        // ───────────────────────────────────────────────────────────────
+        // Allocation profiler (AllocProfiler.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoAllocIsActive();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoAllocReset();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoAllocReport(byte[] buffer, int capacity, int topN);
+
+        // ───────────────────────────────────────────────────────────────
+        // Watchdog (Watchdog.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern IntPtr AchikoWatchdogRegister(string name, int timeoutMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoWatchdogUnregister();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern ulong AchikoWatchdogHangs();
+
+        // ───────────────────────────────────────────────────────────────
+        // Group bus (GroupBus.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoBusJoin(string group);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoBusLeave();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusSlot();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusSend(int slot, ref BusMessage message);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusBroadcast(ref BusMessage message);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusWait([Out] BusMessage[] messages, int capacity, int timeoutMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoBusPublish(ref BusState state);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusReadState(int slot, out BusState state);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoBusMembers([Out] uint[] slots, [Out] uint[] pids, int max);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern ulong AchikoBusDropped();
+
+        // ───────────────────────────────────────────────────────────────
+        // Action queue (ActionQueue.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionSetWindow(int windowMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionEnqueue(uint actionId, ulong arg);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionCancel();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionCastStart(uint actionId, int castMs, int gcdMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionReady();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionFailed(uint actionId, int reason);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionLatency(int rttMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoActionWait(out ActionSubmit action, int timeoutMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionStats(int mode, out ActionStats stats);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoActionResetStats();
+
+        // ───────────────────────────────────────────────────────────────
+        // Decision → effect latency (EffectTracker.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern uint AchikoEffectDecide(int kind, ulong expect);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoEffectDispatched(uint token);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoEffectExecuted(uint token);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoEffectObserve(ref EffectSnapshot snapshot, long takenTicks);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoEffectStats(int kind, out EffectKindStats stats);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoEffectReset();
+
+        // ───────────────────────────────────────────────────────────────
+        // Tick arena (TickArena.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern uint AchikoArenaEndTick();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern uint AchikoArenaGeneration();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoArenaSetPoison(int enabled);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoArenaStats(out TickArenaStats stats);
+
+        // ───────────────────────────────────────────────────────────────
+        // Object snapshot (ObjectDirectory.h / DescriptorBlocks.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoObjectsConfigure(ref ObjectSnapshotLayout layout);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoObjectsSnapshot(IntPtr manager, out ArenaSpan guids, out ArenaSpan descriptors);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoObjectsStats(out ObjectDirectoryStats directory, out DescriptorBlockStats blocks);
+
+        // ───────────────────────────────────────────────────────────────
+        // Memory budget (MemoryBudget.h / MemoryMonitor.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoMemoryStart(uint intervalMs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoMemorySetBudget(uint owner, ulong bytes);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoMemoryReportUsage(uint owner, ulong bytes);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoMemoryTakeTrim(uint owner, out ulong targetBytes);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern uint AchikoMemoryScanNow();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoMemorySummary(out MemorySummary summary);
+
+        // ───────────────────────────────────────────────────────────────
+        // World knowledge store (WorldStore.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoWorldOpen(string directory);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoWorldClose();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoWorldRecord(ref WorldSighting sighting);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoWorldNearest(uint map, uint kind, uint entry, float x, float y, float maxRadius,
+                                                      out WorldSighting spot);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoWorldQueryRadius(uint map, uint kind, uint entry, float x, float y, float radius,
+                                                          [Out] WorldSighting[] spots, int max);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoWorldCompact();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoWorldStats(out WorldStoreStats stats);
+
+        // ───────────────────────────────────────────────────────────────
+        // Grind profiles (GrindProfile.h, RouteOptimizer.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoGrindOpen(string path);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoGrindClose();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindInfo(out GrindProfileInfo info);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindHotspot(uint index, out GrindHotspot hotspot);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindWaypoints(uint first, [Out] GrindWaypoint[] waypoints, int max);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindNearestVendor(float x, float y, float z, uint services, out GrindVendor vendor);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindIsBlacklisted(uint entry);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoGrindInBlackArea(float x, float y, float z);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoGrindCreate(string path,
+                                                     [MarshalAs(UnmanagedType.LPStr)] string name, uint map,
+                                                     GrindHotspot[] hotspots, int hotspotCount,
+                                                     GrindWaypoint[] waypoints, int waypointCount,
+                                                     GrindBlackArea[] blackAreas, int blackAreaCount,
+                                                     GrindVendor[] vendors, int vendorCount,
+                                                     uint[] blacklist, int blacklistCount);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoGrindOptimize(string path, float[] costs, int costCount, uint threads,
+                                                       out GrindRouteReport report);
+
+        // ───────────────────────────────────────────────────────────────
+        // Inventory snapshot (InventorySnapshot.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoInventoryConfigure(ref InventoryLayout layout);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoInventoryRefresh(ulong playerGuid, out ArenaSpan events, out uint hash);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoInventorySlots(out ArenaSpan slots);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoInventoryItemInfo(uint entry, out ItemInfo info);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoInventoryStats(out InventoryStats stats);
+
+        // ───────────────────────────────────────────────────────────────
+        // Config (ConfigStore.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern int AchikoConfigOpen(string binPath, string textPath);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoConfigClose();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoConfigReload();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoConfigView(out ConfigView view);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern IntPtr AchikoConfigGenerationAddress();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoConfigStats(out ConfigStats stats);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoConfigLastError(StringBuilder error, int size);
+
+        // ───────────────────────────────────────────────────────────────
+        // Hook meter (HookMeter.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoHookRegister(string name, uint budgetUs, uint flags);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookSetBudget(uint id, uint budgetUs);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookRecord(uint id, ulong startTicks, ulong endTicks, uint transitions);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookFrameEnd();
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoHookStats([Out] HookStats[] stats, int capacity);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookSummary(out HookMeterSummary summary);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookReset();
+
+        // ───────────────────────────────────────────────────────────────
+        // Hook filter (HookFilter.h)
+        // ───────────────────────────────────────────────────────────────
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoHookFilterInstall(string name, IntPtr target, uint source, uint prologueBytes);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoHookFilterRemove(uint id);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoHookFilterWatch(uint id, uint[] ids, int count, int watch);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoHookFilterDrain(out ArenaSpan events);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int AchikoHookFilterStats([Out] HookFilterStats[] stats, int capacity);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void AchikoHookFilterSummary(out HookFilterSummary summary);
+
+        [DllImport(RemoteAchiko, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int AchikoHookFilterLastError(StringBuilder error, int size);
+    }
+}
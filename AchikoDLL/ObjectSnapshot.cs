@@ -0,0 +1,148 @@
+﻿// ObjectSnapshot.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's object snapshot — incremental object
+// enumeration (ObjectDirectory.h) + descriptor block copies
+// (DescriptorBlocks.h), returned as TickArena spans
+//
+// Responsibilities:
+// • Configure(): hand the client build's offsets to the native side
+// • Take(): one call per tick → GUID span + descriptor span, same order
+// • Report(): nodes walked per tick, validated vs full walks, time saved,
+//   descriptor copy volume (OBJECTS_REPORT)
+//
+// Architecture:
+// • One P/Invoke per tick replaces one per object per field — fields are
+//   read from the descriptor span with ArenaSpan.ReadUInt32 / ReadSingle
+// • Spans live in the bot arena: take and read them on the bot thread,
+//   before BotCore's TickArena.EndTick()
+//
+// Critical Design Decisions:
+// • A descriptor block that faulted reads as zeros — GUID 0 / health 0 —
+//   rather than failing the whole snapshot
+// • Missing native exports = Configure() returns false, Take() returns -1
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors ObjectSnapshotLayout in DescriptorBlocks.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ObjectSnapshotLayout
+    {
+        public uint ManagerFirstObject;
+        public uint ManagerCount;
+        public uint ObjectNext;
+        public uint ObjectGuid;
+        public uint ObjectDescriptors;     // object → descriptor block pointer
+        public uint DescriptorSize;        // bytes copied per object
+    }
+
+    // Mirrors ObjectDirectoryStats in ObjectDirectory.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ObjectDirectoryStats
+    {
+        public ulong Ticks;
+        public ulong FullWalks;
+        public ulong Validated;
+        public ulong Mismatches;
+        public ulong Faults;
+        public ulong NodesWalked;
+        public ulong NodesValidated;
+        public ulong WalkNs;
+        public ulong ValidateNs;
+        public long SavedNs;
+        public uint LastCount;
+        public uint LastWalked;
+    }
+
+    // Mirrors DescriptorBlockStats in DescriptorBlocks.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DescriptorBlockStats
+    {
+        public ulong Captures;
+        public ulong Blocks;
+        public ulong Faults;
+        public ulong Bytes;
+        public ulong CaptureNs;
+        public uint LastCount;
+        public uint LastFaults;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ObjectSnapshot — static API, bot thread only
+    // ═══════════════════════════════════════════════════════════════
+    public static class ObjectSnapshot
+    {
+        private static volatile bool _available = true;   // false once exports are missing
+
+        public static bool Configure(ObjectSnapshotLayout layout)
+        {
+            if (!_available) return false;
+
+            try { return NativeMethods.AchikoObjectsConfigure(ref layout) != 0; }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                return false;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Take — this tick's objects
+        //
+        // Args:
+        //   manager     - object manager address (IntPtr.Zero = not in world)
+        //   guids       - [out] ulong GUID per object (offset 0)
+        //   descriptors - [out] descriptor block per object
+        //
+        // Returns:
+        //   Object count; -1 if not configured / unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static int Take(IntPtr manager, out ArenaSpan guids, out ArenaSpan descriptors)
+        {
+            guids = default(ArenaSpan);
+            descriptors = default(ArenaSpan);
+            if (!_available) return -1;
+
+            try { return NativeMethods.AchikoObjectsSnapshot(manager, out guids, out descriptors); }
+            catch (Exception)
+            {
+                _available = false;
+                return -1;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — enumeration and copy figures; null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string[] Report()
+        {
+            if (!_available) return null;
+
+            ObjectDirectoryStats d;
+            DescriptorBlockStats b;
+            try { NativeMethods.AchikoObjectsStats(out d, out b); }
+            catch (Exception) { return null; }
+
+            double ticks = Math.Max(1UL, d.Ticks);
+            double captures = Math.Max(1UL, b.Captures);
+            return new[]
+            {
+                $"enumeration: {d.LastCount} objects, {d.NodesWalked / ticks:F1} nodes walked/tick over {d.Ticks} ticks " +
+                    $"({d.Validated} validated, {d.FullWalks} full walks, {d.Mismatches} mismatches, {d.Faults} faults)",
+                $"enumeration time: walk {d.WalkNs / 1e6:F1} ms, validate {d.ValidateNs / 1e6:F1} ms, saved ≈ {d.SavedNs / 1e6:F1} ms",
+                $"descriptors: {b.Blocks} blocks, {b.Faults} faults, {b.Bytes / 1048576.0:F1} MB copied, " +
+                    $"{b.CaptureNs / captures / 1000.0:F1} µs/tick"
+            };
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,172 @@
+﻿// TickArena.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed view of RemoteAchiko's per-tick arena (TickArena.h)
+//
+// Responsibilities:
+// • ArenaSpan: read native per-tick results (object snapshots, query
+//   results) in place — no copy into managed arrays, no GC pressure
+// • EndTick(): release the tick's results at the end of every bot tick
+// • Poison toggle and usage report (ARENA_POISON_ON / ARENA_REPORT)
+//
+// Architecture:
+// • Arena memory is native, so it never moves — a span is a plain
+//   pointer + count + stride, effectively pinned for its whole lifetime
+// • Every span carries the arena generation it was built in; the arena
+//   advances the generation at EndTick, which makes older spans stale
+//
+// Critical Design Decisions:
+// • Reading a stale span throws instead of returning last tick's bytes —
+//   the memory is already being reused (or 0xDD with poison on)
+// • The bot arena belongs to the bot thread: take spans and EndTick there
+// • Missing native exports = spans stay empty, EndTick() no-ops
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // ═══════════════════════════════════════════════════════════════
+    // ArenaSpan — mirrors ArenaSpan in TickArena.h
+    // ═══════════════════════════════════════════════════════════════
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ArenaSpan
+    {
+        public ulong Address;          // first element (0 = empty)
+        public uint Count;
+        public uint Stride;            // bytes between elements
+        public uint Generation;        // arena generation it was built in
+        public uint Reserved;
+
+        public bool IsEmpty => Count == 0;
+        public bool IsCurrent => Generation == TickArena.Generation;
+
+        public unsafe uint ReadUInt32(int index, int offset)
+        {
+            return *(uint*)At(index, offset, sizeof(uint));
+        }
+
+        public unsafe ulong ReadUInt64(int index, int offset)
+        {
+            return *(ulong*)At(index, offset, sizeof(ulong));
+        }
+
+        public unsafe float ReadSingle(int index, int offset)
+        {
+            return *(float*)At(index, offset, sizeof(float));
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // At — address of [index] + offset after generation and bounds
+        // checks (size bytes must fit inside one element)
+        // ───────────────────────────────────────────────────────────────
+        private unsafe byte* At(int index, int offset, int size)
+        {
+            if (Generation != TickArena.Generation)
+                throw new InvalidOperationException($"ArenaSpan from tick {Generation} read in tick {TickArena.Generation} — its memory was released");
+            if ((uint)index >= Count || offset < 0 || (uint)offset + (uint)size > Stride)
+                throw new ArgumentOutOfRangeException(nameof(index), $"[{index}] + {offset} outside {Count} × {Stride} bytes");
+
+            return (byte*)Address + (ulong)index * Stride + (uint)offset;
+        }
+    }
+
+    // Mirrors TickArenaStats in TickArena.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TickArenaStats
+    {
+        public ulong UsedBytes;
+        public ulong HighWaterBytes;
+        public ulong ReservedBytes;
+        public ulong Allocations;
+        public uint Generation;
+        public uint Chunks;
+        public uint Oversized;
+        public uint Poison;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // TickArena — static API over the bot thread's native arena
+    // ═══════════════════════════════════════════════════════════════
+    public static class TickArena
+    {
+        private static volatile bool _available = true;   // false once exports are missing
+        private static bool _synced;
+        private static uint _generation;                    // mirror of the native generation
+
+        // ───────────────────────────────────────────────────────────────
+        // Generation — current arena generation; spans built in an older
+        // one are stale
+        // ───────────────────────────────────────────────────────────────
+        public static uint Generation
+        {
+            get
+            {
+                if (!_synced && _available)
+                {
+                    try { _generation = NativeMethods.AchikoArenaGeneration(); }
+                    catch (Exception) { _available = false; }
+                    _synced = true;
+                }
+                return _generation;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // EndTick — release this tick's native results (bot thread, once
+        // per tick, after the last span was read)
+        // ───────────────────────────────────────────────────────────────
+        public static void EndTick()
+        {
+            if (!_available) return;
+
+            try
+            {
+                _generation = NativeMethods.AchikoArenaEndTick();
+                _synced = true;
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+            }
+        }
+
+        public static bool SetPoison(bool enabled)
+        {
+            if (!_available) return false;
+
+            try
+            {
+                NativeMethods.AchikoArenaSetPoison(enabled ? 1 : 0);
+                return true;
+            }
+            catch (Exception)
+            {
+                _available = false;
+                return false;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — one line of usage (ARENA_REPORT); null if unavailable
+        // ───────────────────────────────────────────────────────────────
+        public static string Report()
+        {
+            if (!_available) return null;
+
+            TickArenaStats s;
+            try { NativeMethods.AchikoArenaStats(out s); }
+            catch (Exception) { return null; }
+
+            return $"generation {s.Generation}, high water {s.HighWaterBytes / 1024.0:F1} KB of {s.ReservedBytes / 1024.0:F0} KB " +
+                   $"in {s.Chunks} chunk(s), {s.Oversized} oversized, {s.Allocations} allocations, poison {(s.Poison != 0 ? "ON" : "off")}";
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
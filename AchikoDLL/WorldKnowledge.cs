@@ -0,0 +1,198 @@
+﻿// WorldKnowledge.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed front end for RemoteAchiko's persistent world store
+// (WorldStore.h) — what earlier sessions learned about the world
+//
+// Responsibilities:
+// • Open() / Close(): the store directory next to AchikoDLL.dll
+// • Record(): report a sighting — mob spawn, vendor, flight master,
+//   herb / ore node — once, when the object first shows up
+// • Nearest() / Within(): "nearest known vendor", "known herbs around
+//   here" over every session so far
+// • Report() / Compact(): WORLD_REPORT / WORLD_COMPACT
+//
+// Architecture:
+// • Storage, merging, spatial index and compaction are native; queries
+//   read the memory-mapped base directly and cost microseconds
+// • Safe from any thread — the native store takes its own lock
+//
+// Critical Design Decisions:
+// • Call Record() freely: a spot seen again within an hour is dropped
+//   natively before it reaches the log
+// • Missing native exports = Open() returns false, queries find nothing
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using AchikoDLL.Native;
+
+namespace AchikoDLL
+{
+    // Mirrors WorldKind in WorldStore.h
+    public enum WorldKind : ushort
+    {
+        MobSpawn = 0,
+        Vendor = 1,
+        Repair = 2,
+        FlightMaster = 3,
+        Innkeeper = 4,
+        Trainer = 5,
+        Herb = 6,
+        Ore = 7,
+        Chest = 8
+    }
+
+    // Mirrors WorldSighting in WorldStore.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct WorldSighting
+    {
+        public uint Map;
+        public WorldKind Kind;
+        public ushort Flags;           // caller-defined, OR-ed on merge
+        public uint Entry;             // creature / game object entry
+        public float X;
+        public float Y;
+        public float Z;
+        public uint SeenAt;            // unix seconds, latest sighting
+        public uint SeenCount;         // sightings merged into this spot
+    }
+
+    // Mirrors WorldStoreStats in WorldStore.h
+    [StructLayout(LayoutKind.Sequential)]
+    public struct WorldStoreStats
+    {
+        public ulong BaseRecords;
+        public ulong TailRecords;
+        public ulong BaseBytes;
+        public ulong Recorded;
+        public ulong Deduplicated;
+        public ulong Queries;
+        public ulong Compactions;
+        public ulong LastCompactNs;
+        public uint Partitions;
+        public uint Generation;
+        public uint Compacting;
+        public uint Open;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // WorldKnowledge — static API
+    // ═══════════════════════════════════════════════════════════════
+    public static class WorldKnowledge
+    {
+        public const string DirectoryName = "WorldKnowledge";
+
+        private static readonly DateTime UnixEpoch = new DateTime(1970, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private static volatile bool _available = true;   // false once exports are missing
+        private static volatile bool _open;
+
+        public static bool IsOpen => _open;
+
+        // ───────────────────────────────────────────────────────────────
+        // Open — open (or create) the store
+        //
+        // Args:
+        //   directory - null = "WorldKnowledge" next to AchikoDLL.dll
+        // ───────────────────────────────────────────────────────────────
+        public static bool Open(string directory = null)
+        {
+            if (!_available) return false;
+
+            if (directory == null)
+                directory = Path.Combine(Path.GetDirectoryName(typeof(WorldKnowledge).Assembly.Location), DirectoryName);
+
+            try { _open = NativeMethods.AchikoWorldOpen(directory) != 0; }
+            catch (Exception)
+            {
+                // DllNotFoundException / EntryPointNotFoundException
+                _available = false;
+                _open = false;
+            }
+            return _open;
+        }
+
+        public static void Close()
+        {
+            if (!_open) return;
+            _open = false;
+            NativeMethods.AchikoWorldClose();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Record — one sighting at (x, y, z), seen now
+        //
+        // Returns:
+        //   true if it was new knowledge (logged), false if already known,
+        //   the position is not a finite map position or the store is closed
+        // ───────────────────────────────────────────────────────────────
+        public static bool Record(uint map, WorldKind kind, uint entry, float x, float y, float z)
+        {
+            if (!_open) return false;
+
+            var sighting = new WorldSighting
+            {
+                Map = map,
+                Kind = kind,
+                Entry = entry,
+                X = x,
+                Y = y,
+                Z = z,
+                SeenAt = (uint)(DateTime.UtcNow - UnixEpoch).TotalSeconds,
+                SeenCount = 1
+            };
+            return NativeMethods.AchikoWorldRecord(ref sighting) > 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Nearest — closest known spot of kind (entry 0 = any)
+        // ───────────────────────────────────────────────────────────────
+        public static bool Nearest(uint map, WorldKind kind, uint entry, float x, float y, float maxRadius,
+                                   out WorldSighting spot)
+        {
+            spot = default(WorldSighting);
+            if (!_open) return false;
+            return NativeMethods.AchikoWorldNearest(map, (uint)kind, entry, x, y, maxRadius, out spot) != 0;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Within — known spots of kind within radius, into buffer
+        //
+        // Returns:
+        //   Spots written (at most buffer.Length)
+        // ───────────────────────────────────────────────────────────────
+        public static int Within(uint map, WorldKind kind, uint entry, float x, float y, float radius,
+                                 WorldSighting[] buffer)
+        {
+            if (!_open || buffer == null || buffer.Length == 0) return 0;
+            return NativeMethods.AchikoWorldQueryRadius(map, (uint)kind, entry, x, y, radius, buffer, buffer.Length);
+        }
+
+        public static bool Compact()
+        {
+            if (!_open) return false;
+            NativeMethods.AchikoWorldCompact();
+            return true;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — WORLD_REPORT line; null if the store is not open
+        // ───────────────────────────────────────────────────────────────
+        public static string Report()
+        {
+            if (!_open) return null;
+
+            WorldStoreStats s;
+            NativeMethods.AchikoWorldStats(out s);
+            return $"{s.BaseRecords} spots in base #{s.Generation} ({s.Partitions} map/kind partitions, {s.BaseBytes / 1024.0:F0} KB mapped), " +
+                   $"{s.TailRecords} in log; {s.Recorded} logged, {s.Deduplicated} already known, {s.Queries} queries; " +
+                   $"{s.Compactions} compactions, last {s.LastCompactNs / 1e6:F1} ms{(s.Compacting != 0 ? " (compacting)" : "")}";
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,170 @@
+﻿// Exports.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// extern "C" surface of AchikoIngest.dll for Achikobuddy (P/Invoke)
+//
+// Responsibilities:
+// • Open / close one ingest source per connected pipe client
+// • Take raw pipe blocks from Bugger's reader tasks
+// • Block Bugger's merge thread until ordered lines are available
+// • Open saved logs for the memory-mapped viewer (LogView.h) and serve
+//   windows of lines / filtered lines from them
+//
+// Architecture:
+// • Loaded by Achikobuddy.exe, NOT injected — one LogIngest per UI
+//   process, a heap singleton like AchikoWatch's ProcessWatch
+// • Signatures mirrored by LogIngest.cs (cdecl, blittable IngestRecord)
+//   and LogFileView.cs (opaque LogView* handle, blittable ViewLine)
+//
+// Critical Design Decisions:
+// • Never throws across the boundary — allocation failure in a Push
+//   drops that block instead of taking down the UI
+// • AchikoIngestWait always honours its timeout, so the managed merge
+//   thread can be stopped
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include <Windows.h>
+#include <new>
+#include "LogIngest.h"
+#include "LogView.h"
+
+#define ACHIKO_EXPORT extern "C" __declspec(dllexport)
+
+static LogIngest& Ingest()
+{
+    static LogIngest* s_ingest = new LogIngest();
+    return *s_ingest;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoIngestStart — (re)arm the merger
+//
+// Args:
+//   reorderWindowMs - max time a line is held for slower sources
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT void __cdecl AchikoIngestStart(int reorderWindowMs)
+{
+    Ingest().Reset();
+    Ingest().SetWindowMs(reorderWindowMs > 0 ? (uint32_t)reorderWindowMs : 0);
+}
+
+// Releases AchikoIngestWait; queued lines are flushed by the next calls
+ACHIKO_EXPORT void __cdecl AchikoIngestStop()
+{
+    Ingest().Stop();
+}
+
+// Returns the source id for Push / Close (tag comes back in each record)
+ACHIKO_EXPORT int __cdecl AchikoIngestOpen(int tag)
+{
+    try { return (int)Ingest().Open((uint32_t)tag); }
+    catch (...) { return 0; }
+}
+
+ACHIKO_EXPORT void __cdecl AchikoIngestPush(int source, const char* data, int length)
+{
+    if (source <= 0 || !data || length <= 0)
+        return;
+    try { Ingest().Push((uint32_t)source, data, (size_t)length); }
+    catch (const std::bad_alloc&) { }
+}
+
+ACHIKO_EXPORT void __cdecl AchikoIngestClose(int source)
+{
+    if (source <= 0)
+        return;
+    try { Ingest().Close((uint32_t)source); }
+    catch (...) { }
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoIngestWait — block until ordered lines are available
+//
+// Returns:
+//   Records written (0 on timeout, or once stopped and empty)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoIngestWait(IngestRecord* records, int maxRecords,
+                                           char* text, int textCapacity, int timeoutMs)
+{
+    if (!records || maxRecords <= 0 || !text || textCapacity <= 0)
+        return 0;
+    return (int)Ingest().Wait(records, (size_t)maxRecords, text, (size_t)textCapacity,
+                              timeoutMs > 0 ? (uint32_t)timeoutMs : 0);
+}
+
+// Lines released after a line with a later timestamp (reorder window too short)
+ACHIKO_EXPORT unsigned long long __cdecl AchikoIngestLateLines()
+{
+    return Ingest().Stats().late;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SAVED LOG VIEWER
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// AchikoLogOpen — map a log file and start indexing it
+//
+// Returns:
+//   Handle for the other AchikoLog* calls, NULL if it cannot be opened
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT LogView* __cdecl AchikoLogOpen(const wchar_t* path)
+{
+    if (!path || !*path)
+        return NULL;
+
+    LogView* view = new (std::nothrow) LogView();
+    if (!view)
+        return NULL;
+    try
+    {
+        if (view->Open(path))
+            return view;
+    }
+    catch (...) { /* std::system_error from the index thread */ }
+    delete view;
+    return NULL;
+}
+
+// Stops the index thread and unmaps the file
+ACHIKO_EXPORT void __cdecl AchikoLogClose(LogView* view)
+{
+    delete view;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoLogStatus(LogView* view, ViewStatus* status)
+{
+    if (view && status)
+        *status = view->Status();
+}
+
+// Lines [first, first + maxLines); returns lines written
+ACHIKO_EXPORT int __cdecl AchikoLogRead(LogView* view, unsigned long long first, ViewLine* lines, int maxLines,
+                                        char* text, int textCapacity)
+{
+    if (!view || !lines || maxLines <= 0 || !text || textCapacity <= 0)
+        return 0;
+    return (int)view->Read(first, lines, (size_t)maxLines, text, (size_t)textCapacity);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoLogFilter — filter by source prefix (blocking, parallel)
+//
+// Returns:
+//   Matching lines; an empty pattern clears the filter and returns 0
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT unsigned long long __cdecl AchikoLogFilter(LogView* view, const char* pattern)
+{
+    if (!view)
+        return 0;
+    try { return view->Filter(pattern ? pattern : "", pattern ? strlen(pattern) : 0); }
+    catch (...) { return 0; }
+}
+
+// Matches [first, first + maxLines) of the last filter; returns lines written
+ACHIKO_EXPORT int __cdecl AchikoLogReadFiltered(LogView* view, unsigned long long first, ViewLine* lines,
+                                                int maxLines, char* text, int textCapacity)
+{
+    if (!view || !lines || maxLines <= 0 || !text || textCapacity <= 0)
+        return 0;
+    return (int)view->ReadFiltered(first, lines, (size_t)maxLines, text, (size_t)textCapacity);
+}
@@ -0,0 +1,495 @@
+﻿// LogIngest.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Block log ingest + timestamp-ordered k-way merge for Achikobuddy's Bugger
+//
+// Responsibilities:
+// • Accept raw pipe blocks (any size, lines split anywhere) per source
+// • Split lines with an SSE2 newline search and decode the "[HH:mm:ss.fff]"
+//   prefix in place (LineCodec.h) — no per-line copy until output
+// • Merge every source into one timeline ordered by source timestamp,
+//   holding lines back at most ReorderWindowMs to let slower pipes catch up
+// • Hand the consumer batches of lines + their text in caller buffers
+//
+// Architecture:
+// • Header-only, no OS calls — Exports.cpp wraps one instance for
+//   Achikobuddy (P/Invoke), RemoteAchikoBench drives it directly
+// • One mutex; Push() appends the block to the source's buffer and scans
+//   only the new bytes, Wait() sleeps on a condition variable until a line
+//   can be released (new data, or the oldest held line's window expiring)
+// • Per source: one growing byte buffer (compacted once half is consumed)
+//   plus a FIFO of line descriptors pointing into it
+//
+// Critical Design Decisions:
+// • Merge rule: the smallest head line is released once no open source
+//   can still produce something earlier — every other source either has
+//   a line queued or has already logged a later timestamp — or once it
+//   has waited ReorderWindowMs. Idle sources cost latency, never order
+//   beyond the window; anything later than that is released and counted
+//   as "late"
+// • Linear scan over active sources instead of a heap — a session has a
+//   handful of pipes, and the scan is the same loop that checks the rule
+// • Timestamps are ms-of-day; keys are unwrapped against the newest key
+//   seen, so midnight does not reorder the log. Lines without a prefix
+//   inherit their source's last timestamp; a source's keys never go
+//   backwards (threads racing the PipeClient timestamp)
+// • IngestRecord is blittable with fixed-width fields
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "LineCodec.h"
+#include "Platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACHIKO_INGEST_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+static const uint32_t kIngestDefaultWindowMs = 20;
+static const size_t kIngestMaxLineBytes = 64 * 1024;     // longer lines are cut here
+static const size_t kIngestCompactBytes = 64 * 1024;     // min dead prefix worth a memmove
+
+// ═══════════════════════════════════════════════════════════════
+// NEWLINE SEARCH
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// FindNewline — first '\n' in [p, end)
+//
+// Returns:
+//   Pointer to the '\n', or end if there is none
+//
+// Notes:
+//   16 bytes per compare with SSE2 (x64, and x86 built /arch:SSE2);
+//   byte loop elsewhere and for the tail
+// ───────────────────────────────────────────────────────────────
+inline const char* FindNewline(const char* p, const char* end)
+{
+#ifdef ACHIKO_INGEST_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16)
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i*)p);
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+        if (mask != 0)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, (unsigned long)mask);
+            return p + index;
+#else
+            return p + __builtin_ctz((unsigned)mask);
+#endif
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '\n')
+        ++p;
+    return p;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// IngestRecord / IngestStats
+// ═══════════════════════════════════════════════════════════════
+struct IngestRecord
+{
+    uint32_t tag;          // Open() tag (LogSource in Achikobuddy)
+    uint32_t msOfDay;      // source timestamp (inherited if the line had none)
+    uint32_t offset;       // into the caller's text buffer
+    uint32_t length;       // bytes, without '\r' / '\n'
+};
+
+struct IngestStats
+{
+    uint64_t lines;        // lines released
+    uint64_t bytes;        // text bytes released
+    uint64_t late;         // released after a line with a later timestamp
+    uint64_t untimed;      // lines without a "[HH:mm:ss.fff]" prefix
+};
+
+// ═══════════════════════════════════════════════════════════════
+// LogIngest
+// ═══════════════════════════════════════════════════════════════
+class LogIngest
+{
+public:
+    LogIngest()
+        : m_windowNs(kIngestDefaultWindowMs * 1000000ull), m_nextSource(1), m_nextSeq(0),
+          m_refKey(0), m_lastEmittedKey(0), m_nextReleaseNs(0), m_stopped(false)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    void SetWindowMs(uint32_t windowMs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_windowNs = windowMs * 1000000ull;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Producer side — one source per connected pipe client
+    // ───────────────────────────────────────────────────────────────
+
+    // Returns the source id for Push / Close (never 0)
+    uint32_t Open(uint32_t tag)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const uint32_t id = m_nextSource++;
+        Source& source = m_sources[id];
+        source.tag = tag;
+        RebuildActive();
+        return id;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Push — append a raw block read from the source's pipe
+    //
+    // Notes:
+    //   A line split across blocks is completed by the next Push; only
+    //   bytes not scanned before are searched for '\n'
+    // ───────────────────────────────────────────────────────────────
+    void Push(uint32_t id, const char* data, size_t length)
+    {
+        const uint64_t nowNs = PlatformNowNs();
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::map<uint32_t, Source>::iterator it = m_sources.find(id);
+        if (it == m_sources.end() || !it->second.open || length == 0)
+            return;
+
+        Source& s = it->second;
+        Compact(s);
+        s.buf.insert(s.buf.end(), data, data + length);
+
+        const char* base = &s.buf[0];
+        const char* end = base + s.buf.size();
+        const char* p = base + s.scanFrom;
+        const size_t before = s.lines.size();
+
+        for (;;)
+        {
+            const char* newline = FindNewline(p, end);
+            if (newline == end)
+                break;
+            AddLine(s, s.lineStart, (size_t)(newline - base), nowNs);
+            s.lineStart = (size_t)(newline - base) + 1;
+            p = newline + 1;
+        }
+        s.scanFrom = s.buf.size();
+
+        // A client that never sends '\n' must not grow the buffer forever
+        if (s.buf.size() - s.lineStart > kIngestMaxLineBytes)
+        {
+            AddLine(s, s.lineStart, s.lineStart + kIngestMaxLineBytes, nowNs);
+            s.lineStart += kIngestMaxLineBytes;
+        }
+
+        if (s.lines.size() != before)
+            m_changed.notify_one();
+    }
+
+    // Disconnected — queued lines are released without waiting
+    void Close(uint32_t id)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::map<uint32_t, Source>::iterator it = m_sources.find(id);
+        if (it == m_sources.end())
+            return;
+
+        Source& s = it->second;
+        if (s.buf.size() > s.lineStart)
+            AddLine(s, s.lineStart, s.buf.size(), PlatformNowNs());   // unterminated last line
+        s.lineStart = s.scanFrom = s.buf.size();
+        s.open = false;
+
+        if (s.lines.empty())
+            m_sources.erase(it);
+        RebuildActive();
+        m_changed.notify_one();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Consumer side
+    // ───────────────────────────────────────────────────────────────
+
+    // ───────────────────────────────────────────────────────────────
+    // Wait — block until lines can be released, then drain
+    //
+    // Args:
+    //   records      - [out] one per line, in timeline order
+    //   maxRecords   - entries in records
+    //   text         - [out] line bytes, records point into it
+    //   textCapacity - bytes in text
+    //   timeoutMs    - give up after this long (returns 0)
+    //
+    // Returns:
+    //   Records written; after Stop() everything queued is released
+    // ───────────────────────────────────────────────────────────────
+    size_t Wait(IngestRecord* records, size_t maxRecords, char* text, size_t textCapacity, uint32_t timeoutMs)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        const uint64_t deadlineNs = PlatformNowNs() + timeoutMs * 1000000ull;
+
+        for (;;)
+        {
+            const uint64_t nowNs = PlatformNowNs();
+            const size_t count = DrainLocked(records, maxRecords, text, textCapacity, nowNs, m_stopped);
+            if (count != 0 || m_stopped || nowNs >= deadlineNs)
+                return count;
+
+            uint64_t sleepNs = deadlineNs - nowNs;
+            if (m_nextReleaseNs != 0 && m_nextReleaseNs > nowNs && m_nextReleaseNs - nowNs < sleepNs)
+                sleepNs = m_nextReleaseNs - nowNs;
+            m_changed.wait_for(guard, std::chrono::nanoseconds(sleepNs));
+        }
+    }
+
+    // Non-blocking drain at the current time
+    size_t Drain(IngestRecord* records, size_t maxRecords, char* text, size_t textCapacity)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return DrainLocked(records, maxRecords, text, textCapacity, PlatformNowNs(), false);
+    }
+
+    // Drain ignoring the reorder window (shutdown, benchmarks)
+    size_t Flush(IngestRecord* records, size_t maxRecords, char* text, size_t textCapacity)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return DrainLocked(records, maxRecords, text, textCapacity, PlatformNowNs(), true);
+    }
+
+    // Releases every Wait() — queued lines are flushed by the next calls
+    void Stop()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stopped = true;
+        m_changed.notify_all();
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_sources.clear();
+        m_active.clear();
+        m_refKey = m_lastEmittedKey = 0;
+        m_stopped = false;
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    IngestStats Stats()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_stats;
+    }
+
+private:
+    LogIngest(const LogIngest&);
+    LogIngest& operator=(const LogIngest&);
+
+    struct Line
+    {
+        uint64_t key;          // unwrapped ms timestamp
+        uint64_t seq;          // arrival order — ties and same-ms lines
+        uint64_t arrivalNs;
+        uint32_t msOfDay;
+        uint32_t offset;       // into Source::buf
+        uint32_t length;
+    };
+
+    struct Source
+    {
+        Source() : tag(0), open(true), lineStart(0), scanFrom(0), lastKey(0), lastMs(0), timed(false) {}
+
+        uint32_t tag;
+        bool open;
+        std::vector<char> buf;
+        size_t lineStart;      // first byte of the incomplete line
+        size_t scanFrom;       // bytes before this contain no unconsumed '\n'
+        std::deque<Line> lines;
+        uint64_t lastKey;
+        uint32_t lastMs;
+        bool timed;            // lastMs came from a prefix (or a previous line)
+    };
+
+    // ───────────────────────────────────────────────────────────────
+    // AddLine — describe buf[begin, end) (caller holds m_lock)
+    // ───────────────────────────────────────────────────────────────
+    void AddLine(Source& s, size_t begin, size_t end, uint64_t nowNs)
+    {
+        if (end > begin && s.buf[end - 1] == '\r')
+            --end;
+
+        const char* line = &s.buf[0] + begin;
+        const size_t length = end - begin;
+
+        uint32_t ms;
+        uint64_t key;
+        if (DecodeLinePrefix(line, length, ms))
+        {
+            key = Unwrap(ms);
+        }
+        else
+        {
+            ++m_stats.untimed;
+            ms = s.timed ? s.lastMs : PlatformLocalMsOfDay();
+            key = s.timed ? s.lastKey : Unwrap(ms);
+        }
+
+        if (key < s.lastKey)
+            key = s.lastKey;
+        if (key > m_refKey)
+            m_refKey = key;
+
+        s.lastKey = key;
+        s.lastMs = ms;
+        s.timed = true;
+
+        Line entry = { key, m_nextSeq++, nowNs, ms, (uint32_t)begin, (uint32_t)length };
+        s.lines.push_back(entry);
+    }
+
+    // ms-of-day → key on a continuous axis, nearest to the newest key seen
+    uint64_t Unwrap(uint32_t ms) const
+    {
+        if (m_refKey == 0)
+            return kMsPerDay + ms;   // day 1 — leaves room to step back over midnight
+
+        uint64_t key = m_refKey - m_refKey % kMsPerDay + ms;
+        if (key + kMsPerDay / 2 < m_refKey)
+            key += kMsPerDay;
+        else if (key > m_refKey + kMsPerDay / 2)
+            key -= kMsPerDay;
+        return key;
+    }
+
+    // Drop the consumed prefix once it is large and at least half the buffer
+    void Compact(Source& s)
+    {
+        const size_t dead = s.lines.empty() ? s.lineStart : s.lines.front().offset;
+        if (dead < kIngestCompactBytes || dead * 2 < s.buf.size())
+            return;
+
+        s.buf.erase(s.buf.begin(), s.buf.begin() + dead);
+        for (size_t i = 0; i < s.lines.size(); ++i)
+            s.lines[i].offset -= (uint32_t)dead;
+        s.lineStart -= dead;
+        s.scanFrom -= dead;
+    }
+
+    void RebuildActive()
+    {
+        m_active.clear();
+        for (std::map<uint32_t, Source>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+            m_active.push_back(&it->second);
+    }
+
+    // Could an open source other than head's still log something earlier?
+    bool Blocked(const Source* head, const Line& line) const
+    {
+        for (size_t i = 0; i < m_active.size(); ++i)
+        {
+            const Source* s = m_active[i];
+            if (s == head || !s->open || !s->lines.empty())
+                continue;
+            if (s->lastKey < line.key)
+                return true;
+        }
+        return false;
+    }
+
+    size_t DrainLocked(IngestRecord* records, size_t maxRecords, char* text, size_t textCapacity,
+                       uint64_t nowNs, bool force)
+    {
+        size_t count = 0;
+        size_t used = 0;
+        bool removed = false;
+        m_nextReleaseNs = 0;
+
+        while (count < maxRecords)
+        {
+            Source* best = NULL;
+            for (size_t i = 0; i < m_active.size(); ++i)
+            {
+                Source* s = m_active[i];
+                if (s->lines.empty())
+                    continue;
+                const Line& head = s->lines.front();
+                if (!best || head.key < best->lines.front().key ||
+                    (head.key == best->lines.front().key && head.seq < best->lines.front().seq))
+                    best = s;
+            }
+            if (!best)
+                break;
+
+            const Line& line = best->lines.front();
+            if (!force && nowNs - line.arrivalNs < m_windowNs && Blocked(best, line))
+            {
+                m_nextReleaseNs = line.arrivalNs + m_windowNs;
+                break;
+            }
+
+            size_t length = line.length;
+            if (used + length > textCapacity)
+            {
+                if (count != 0)
+                    break;
+                length = textCapacity - used;   // a single line larger than the whole buffer
+            }
+
+            memcpy(text + used, &best->buf[0] + line.offset, length);
+            IngestRecord record = { best->tag, line.msOfDay, (uint32_t)used, (uint32_t)length };
+            records[count++] = record;
+            used += length;
+
+            ++m_stats.lines;
+            m_stats.bytes += length;
+            if (line.key < m_lastEmittedKey)
+                ++m_stats.late;
+            else
+                m_lastEmittedKey = line.key;
+
+            best->lines.pop_front();
+            if (!best->open && best->lines.empty())
+                removed = true;
+        }
+
+        if (removed)
+        {
+            for (std::map<uint32_t, Source>::iterator it = m_sources.begin(); it != m_sources.end();)
+            {
+                if (!it->second.open && it->second.lines.empty())
+                    m_sources.erase(it++);
+                else
+                    ++it;
+            }
+            RebuildActive();
+        }
+        return count;
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_changed;
+    std::map<uint32_t, Source> m_sources;    // node-based — m_active pointers stay valid
+    std::vector<Source*> m_active;
+    uint64_t m_windowNs;
+    uint32_t m_nextSource;
+    uint64_t m_nextSeq;
+    uint64_t m_refKey;                       // newest key seen (midnight unwrap)
+    uint64_t m_lastEmittedKey;
+    uint64_t m_nextReleaseNs;                // 0 = nothing held by the window
+    bool m_stopped;
+    IngestStats m_stats;
+};
@@ -0,0 +1,659 @@
+﻿// LogView.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Memory-mapped viewer backend for multi-GB Achikobuddy.log files
+//
+// Responsibilities:
+// • Map a saved log read-only, a bounded view at a time — never load it
+// • Build a sparse line index in the background: one byte offset per
+//   kViewStrideLines lines, found with an SSE2 newline count
+// • Serve any window of lines (by line number) straight from the mapping
+// • Filter by source prefix ("[AchikoDLL]", ...) in parallel chunks and
+//   serve windows of the filtered lines the same way
+//
+// Architecture:
+// • Header-only; MappedLogFile is the only OS-specific part
+//   (CreateFileMapping / mmap). Exports.cpp wraps it for Achikobuddy
+//   (P/Invoke), RemoteAchikoBench drives it directly
+// • A window read maps from the nearest checkpoint and walks at most
+//   kViewStrideLines - 1 lines before the first one it returns
+// • A filter keeps one match count per index block (prefix sums), not
+//   a list of matching lines
+//
+// Critical Design Decisions:
+// • Memory is flat in the file size: ≤ kViewMapBytes mapped per walker,
+//   8 bytes of index and 8 bytes of filter per kViewStrideLines lines
+//   (~1.6 MB for a 10 GB log of 80-byte lines)
+// • Views are remapped as walkers move instead of mapping the whole
+//   file — Achikobuddy is a 32-bit process
+// • The view is a snapshot of the file's size at Open(); lines appended
+//   later are not seen
+// • Windows can be read while indexing is still running; they cover
+//   the lines indexed so far
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LineCodec.h"
+#include "LogIngest.h"
+#include "Platform.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const uint64_t kViewStrideLines = 1024;           // lines per index checkpoint
+static const size_t kViewMapBytes = 8u << 20;             // one mapped view per walker
+static const size_t kViewCountBytes = 4096;               // newline-count step while indexing
+static const uint64_t kViewFilterChunkBlocks = 64;        // index blocks per filter work item
+
+#ifdef _WIN32
+typedef wchar_t ViewPathChar;
+#else
+typedef char ViewPathChar;
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// NEWLINE COUNT
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// CountNewlines — number of '\n' in [p, end)
+//
+// Notes:
+//   SSE2: compare 16 bytes, subtract the 0xFF matches into byte
+//   counters, fold them with PSADBW every 255 blocks (before a
+//   counter can wrap). No POPCNT needed
+// ───────────────────────────────────────────────────────────────
+inline size_t CountNewlines(const char* p, const char* end)
+{
+    size_t count = 0;
+#ifdef ACHIKO_INGEST_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16)
+    {
+        const size_t blocks = std::min((size_t)(end - p) / 16, (size_t)255);
+        const char* stop = p + blocks * 16;
+        __m128i counters = zero;
+        for (; p != stop; p += 16)
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+        const __m128i sums = _mm_sad_epu8(counters, zero);
+        count += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_extract_epi16(sums, 4);
+    }
+#endif
+    for (; p < end; ++p)
+        count += *p == '\n';
+    return count;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MappedLogFile — read-only file + views onto it
+// ═══════════════════════════════════════════════════════════════
+class MappedLogFile
+{
+public:
+    // ───────────────────────────────────────────────────────────────
+    // View — one mapped range, unmapped on destruction / Reset
+    // ───────────────────────────────────────────────────────────────
+    class View
+    {
+    public:
+        View() : m_base(NULL), m_length(0), m_data(NULL) {}
+        ~View() { Reset(); }
+
+        const char* Data() const { return m_data; }
+
+        void Reset()
+        {
+            if (!m_base)
+                return;
+#ifdef _WIN32
+            UnmapViewOfFile(m_base);
+#else
+            munmap(m_base, m_length);
+#endif
+            m_base = NULL;
+            m_data = NULL;
+            m_length = 0;
+        }
+
+    private:
+        friend class MappedLogFile;
+        View(const View&);
+        View& operator=(const View&);
+
+        void* m_base;          // aligned start actually mapped
+        size_t m_length;       // bytes mapped from m_base
+        const char* m_data;    // requested offset inside the view
+    };
+
+    MappedLogFile() : m_size(0), m_granularity(4096)
+#ifdef _WIN32
+        , m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#else
+        , m_fd(-1)
+#endif
+    {
+    }
+
+    ~MappedLogFile() { Close(); }
+
+    uint64_t Size() const { return m_size; }
+
+    bool Open(const ViewPathChar* path)
+    {
+        Close();
+#ifdef _WIN32
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        m_granularity = si.dwAllocationGranularity;
+
+        // Share write/delete: Bugger may still be appending to this file
+        m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            Close();
+            return false;
+        }
+        m_size = (uint64_t)size.QuadPart;
+
+        // A zero-length mapping is an error — an empty file simply has no views
+        if (m_size != 0)
+        {
+            m_mapping = CreateFileMappingW(m_file, NULL, PAGE_READONLY, size.HighPart, size.LowPart, NULL);
+            if (!m_mapping)
+            {
+                Close();
+                return false;
+            }
+        }
+        return true;
+#else
+        const long page = sysconf(_SC_PAGESIZE);
+        m_granularity = page > 0 ? (uint32_t)page : 4096u;
+
+        m_fd = open(path, O_RDONLY);
+        if (m_fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(m_fd, &st) != 0)
+        {
+            Close();
+            return false;
+        }
+        m_size = (uint64_t)st.st_size;
+        return true;
+#endif
+    }
+
+    void Close()
+    {
+#ifdef _WIN32
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+        m_mapping = NULL;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_size = 0;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Map — map [offset, offset + length) into view
+    //
+    // Returns:
+    //   Pointer to offset, or NULL on failure / past EOF. length is
+    //   clamped to the file size. Thread-safe (one view per caller)
+    // ───────────────────────────────────────────────────────────────
+    const char* Map(uint64_t offset, size_t length, View& view) const
+    {
+        view.Reset();
+        if (offset >= m_size || length == 0)
+            return NULL;
+        if (length > m_size - offset)
+            length = (size_t)(m_size - offset);
+
+        const uint64_t aligned = offset - offset % m_granularity;
+        const size_t lead = (size_t)(offset - aligned);
+#ifdef _WIN32
+        void* base = MapViewOfFile(m_mapping, FILE_MAP_READ, (DWORD)(aligned >> 32), (DWORD)aligned, lead + length);
+        if (!base)
+            return NULL;
+#else
+        void* base = mmap(NULL, lead + length, PROT_READ, MAP_SHARED, m_fd, (off_t)aligned);
+        if (base == MAP_FAILED)
+            return NULL;
+#endif
+        view.m_base = base;
+        view.m_length = lead + length;
+        view.m_data = (const char*)base + lead;
+        return view.m_data;
+    }
+
+private:
+    MappedLogFile(const MappedLogFile&);
+    MappedLogFile& operator=(const MappedLogFile&);
+
+    uint64_t m_size;
+    uint32_t m_granularity;    // view offsets must be multiples of this
+#ifdef _WIN32
+    HANDLE m_file;
+    HANDLE m_mapping;
+#else
+    int m_fd;
+#endif
+};
+
+// ═══════════════════════════════════════════════════════════════
+// LineCursor — walk lines forward from a byte offset
+// ═══════════════════════════════════════════════════════════════
+class LineCursor
+{
+public:
+    LineCursor(const MappedLogFile& file, uint64_t offset)
+        : m_file(file), m_offset(offset), m_viewEnd(offset), m_p(NULL), m_end(NULL)
+    {
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Next — the next line, without its '\r' / '\n'
+    //
+    // Returns:
+    //   false at EOF (or if a view cannot be mapped). line stays valid
+    //   until the following call
+    //
+    // Notes:
+    //   A line crossing the view end is remapped from its start; a line
+    //   longer than kViewMapBytes is returned in kViewMapBytes pieces
+    // ───────────────────────────────────────────────────────────────
+    bool Next(const char*& line, size_t& length)
+    {
+        if (m_offset >= m_file.Size())
+            return false;
+        if (m_p == m_end && !Remap())
+            return false;
+
+        const char* newline = FindNewline(m_p, m_end);
+        if (newline == m_end && m_viewEnd < m_file.Size() && m_p != m_view.Data())
+        {
+            if (!Remap())
+                return false;
+            newline = FindNewline(m_p, m_end);
+        }
+
+        line = m_p;
+        length = (size_t)(newline - m_p);
+        const size_t consumed = length + (newline != m_end ? 1 : 0);
+        m_p += consumed;
+        m_offset += consumed;
+
+        if (length != 0 && line[length - 1] == '\r')
+            --length;
+        return true;
+    }
+
+private:
+    bool Remap()
+    {
+        const char* data = m_file.Map(m_offset, kViewMapBytes, m_view);
+        if (!data)
+            return false;
+        const size_t mapped = (size_t)std::min<uint64_t>(kViewMapBytes, m_file.Size() - m_offset);
+        m_p = data;
+        m_end = data + mapped;
+        m_viewEnd = m_offset + mapped;
+        return true;
+    }
+
+    const MappedLogFile& m_file;
+    MappedLogFile::View m_view;
+    uint64_t m_offset;     // file offset of m_p
+    uint64_t m_viewEnd;    // file offset of m_end
+    const char* m_p;
+    const char* m_end;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ViewLine / ViewStatus
+// ═══════════════════════════════════════════════════════════════
+struct ViewLine
+{
+    uint64_t line;         // line number in the file (0-based)
+    uint32_t offset;       // into the caller's text buffer
+    uint32_t length;       // bytes, without '\r' / '\n'
+};
+
+struct ViewStatus
+{
+    uint64_t sizeBytes;    // file size at Open()
+    uint64_t indexedBytes; // bytes the index covers so far
+    uint64_t lines;        // lines readable so far
+    uint32_t done;         // 1 once the whole file is indexed
+    uint32_t failed;       // 1 if indexing stopped on a mapping failure
+};
+
+// ═══════════════════════════════════════════════════════════════
+// LogView
+// ═══════════════════════════════════════════════════════════════
+class LogView
+{
+public:
+    LogView() : m_lines(0), m_indexedBytes(0), m_done(false), m_failed(false), m_stop(false) {}
+
+    ~LogView()
+    {
+        m_stop.store(true);
+        if (m_indexer.joinable())
+            m_indexer.join();
+    }
+
+    // Maps the file and starts the background index; false if it cannot be opened
+    bool Open(const ViewPathChar* path)
+    {
+        if (!m_file.Open(path))
+            return false;
+        m_checkpoints.push_back(0);
+        m_indexer = std::thread(&LogView::IndexLoop, this);
+        return true;
+    }
+
+    ViewStatus Status() const
+    {
+        ViewStatus status;
+        status.sizeBytes = m_file.Size();
+        status.indexedBytes = m_indexedBytes.load(std::memory_order_acquire);
+        status.lines = m_lines.load(std::memory_order_acquire);
+        status.done = m_done.load(std::memory_order_acquire) ? 1u : 0u;
+        status.failed = m_failed.load(std::memory_order_acquire) ? 1u : 0u;
+        return status;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Read — lines [first, first + max) of the file
+    //
+    // Returns:
+    //   Lines written (fewer if text fills up or the index does not
+    //   reach that far yet). A single line larger than text is cut
+    // ───────────────────────────────────────────────────────────────
+    size_t Read(uint64_t first, ViewLine* out, size_t max, char* text, size_t capacity) const
+    {
+        const uint64_t lines = m_lines.load(std::memory_order_acquire);
+        if (first >= lines || max == 0 || capacity == 0)
+            return 0;
+        if (max > lines - first)
+            max = (size_t)(lines - first);
+
+        const uint64_t block = first / kViewStrideLines;
+        LineCursor cursor(m_file, Checkpoint(block));
+
+        const char* line;
+        size_t length;
+        for (uint64_t n = block * kViewStrideLines; n < first; ++n)
+        {
+            if (!cursor.Next(line, length))
+                return 0;
+        }
+
+        size_t count = 0;
+        size_t used = 0;
+        while (count < max && cursor.Next(line, length))
+        {
+            if (!Emit(first + count, line, length, out, count, text, used, capacity))
+                break;
+        }
+        return count;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Filter — keep lines whose body starts with pattern
+    //
+    // Args:
+    //   pattern - source prefix, e.g. "[AchikoDLL]"; matched after the
+    //             "[HH:mm:ss.fff] " stamp Bugger writes. Empty = clear
+    //
+    // Returns:
+    //   Matching lines among those indexed at the time of the call
+    //
+    // Notes:
+    //   Blocking — chunks of kViewFilterChunkBlocks index blocks are
+    //   handed to one worker per logical CPU (the caller included)
+    // ───────────────────────────────────────────────────────────────
+    uint64_t Filter(const char* pattern, size_t length)
+    {
+        if (length == 0)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_filter.reset();
+            return 0;
+        }
+
+        std::shared_ptr<FilterState> state(new FilterState());
+        state->pattern.assign(pattern, length);
+        state->lines = m_lines.load(std::memory_order_acquire);
+
+        const uint64_t blocks = (state->lines + kViewStrideLines - 1) / kViewStrideLines;
+        std::vector<uint64_t> offsets((size_t)blocks);
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            std::copy(m_checkpoints.begin(), m_checkpoints.begin() + (ptrdiff_t)blocks, offsets.begin());
+        }
+
+        std::vector<uint32_t> counts((size_t)blocks, 0);
+        const uint64_t chunks = (blocks + kViewFilterChunkBlocks - 1) / kViewFilterChunkBlocks;
+        std::atomic<uint64_t> nextChunk(0);
+        const FilterState& filter = *state;
+
+        auto work = [&]()
+        {
+            for (uint64_t chunk; (chunk = nextChunk.fetch_add(1)) < chunks; )
+            {
+                const uint64_t firstBlock = chunk * kViewFilterChunkBlocks;
+                const uint64_t endLine = std::min(filter.lines, (firstBlock + kViewFilterChunkBlocks) * kViewStrideLines);
+                LineCursor cursor(m_file, offsets[(size_t)firstBlock]);
+
+                const char* line;
+                size_t lineLength;
+                for (uint64_t n = firstBlock * kViewStrideLines; n < endLine && cursor.Next(line, lineLength); ++n)
+                {
+                    if (filter.Matches(line, lineLength))
+                        ++counts[(size_t)(n / kViewStrideLines)];
+                }
+            }
+        };
+
+        const uint32_t workers = (uint32_t)std::min<uint64_t>(PlatformCpuCount(), chunks);
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < workers; ++i)
+            threads.push_back(std::thread(work));
+        work();
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        state->before.resize((size_t)blocks + 1);
+        state->before[0] = 0;
+        for (size_t b = 0; b < counts.size(); ++b)
+            state->before[b + 1] = state->before[b] + counts[b];
+
+        const uint64_t matches = state->before.back();
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_filter = state;
+        return matches;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // ReadFiltered — matches [first, first + max) of the last Filter()
+    //
+    // Returns:
+    //   Lines written; ViewLine::line carries each match's file line
+    // ───────────────────────────────────────────────────────────────
+    size_t ReadFiltered(uint64_t first, ViewLine* out, size_t max, char* text, size_t capacity) const
+    {
+        std::shared_ptr<const FilterState> filter;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            filter = m_filter;
+        }
+        if (!filter || first >= filter->before.back() || max == 0 || capacity == 0)
+            return 0;
+
+        // Block holding match #first: before[block] <= first < before[block + 1]
+        const size_t block = (size_t)(std::upper_bound(filter->before.begin(), filter->before.end(), first)
+                                      - filter->before.begin()) - 1;
+        LineCursor cursor(m_file, Checkpoint(block));
+
+        uint64_t match = filter->before[block];
+        size_t count = 0;
+        size_t used = 0;
+        const char* line;
+        size_t length;
+        for (uint64_t n = block * kViewStrideLines; n < filter->lines && count < max && cursor.Next(line, length); ++n)
+        {
+            if (!filter->Matches(line, length))
+                continue;
+            if (match++ < first)
+                continue;
+            if (!Emit(n, line, length, out, count, text, used, capacity))
+                break;
+        }
+        return count;
+    }
+
+private:
+    struct FilterState
+    {
+        std::string pattern;
+        uint64_t lines;                    // lines the filter covered
+        std::vector<uint64_t> before;      // matches in blocks [0, b)
+
+        bool Matches(const char* line, size_t length) const
+        {
+            const size_t skip = LinePrefixSkip(line, length);
+            return length - skip >= pattern.size() && memcmp(line + skip, pattern.data(), pattern.size()) == 0;
+        }
+    };
+
+    uint64_t Checkpoint(uint64_t block) const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_checkpoints[(size_t)block];
+    }
+
+    // Copies one line out; false once text is full (the first line is cut instead)
+    static bool Emit(uint64_t lineNumber, const char* line, size_t length,
+                     ViewLine* out, size_t& count, char* text, size_t& used, size_t capacity)
+    {
+        if (length > capacity - used)
+        {
+            if (count != 0)
+                return false;
+            length = capacity - used;
+        }
+        memcpy(text + used, line, length);
+        out[count].line = lineNumber;
+        out[count].offset = (uint32_t)used;
+        out[count].length = (uint32_t)length;
+        used += length;
+        ++count;
+        return true;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // IndexLoop — background thread, one pass over the file
+    //
+    // Counts newlines kViewCountBytes at a time; only the step that
+    // crosses the next checkpoint is walked line by line to find it
+    // ───────────────────────────────────────────────────────────────
+    void IndexLoop()
+    {
+        const uint64_t size = m_file.Size();
+        uint64_t lines = 0;
+        uint64_t nextCheckpoint = kViewStrideLines;
+        uint64_t offset = 0;
+        MappedLogFile::View view;
+
+        while (offset < size && !m_stop.load(std::memory_order_relaxed))
+        {
+            const char* base = m_file.Map(offset, kViewMapBytes, view);
+            if (!base)
+            {
+                m_failed.store(true, std::memory_order_release);
+                return;
+            }
+            const char* end = base + (size_t)std::min<uint64_t>(kViewMapBytes, size - offset);
+
+            for (const char* p = base; p < end; )
+            {
+                const char* step = p + std::min((size_t)(end - p), kViewCountBytes);
+                const size_t count = CountNewlines(p, step);
+
+                if (lines + count < nextCheckpoint)
+                {
+                    lines += count;
+                    p = step;
+                    continue;
+                }
+
+                for (const char* newline; (newline = FindNewline(p, step)) != step; )
+                {
+                    p = newline + 1;
+                    if (++lines == nextCheckpoint)
+                    {
+                        std::lock_guard<std::mutex> guard(m_lock);
+                        m_checkpoints.push_back(offset + (uint64_t)(p - base));
+                        nextCheckpoint += kViewStrideLines;
+                    }
+                }
+                p = step;
+            }
+
+            offset += (uint64_t)(end - base);
+            m_indexedBytes.store(offset, std::memory_order_release);
+            m_lines.store(lines, std::memory_order_release);
+        }
+
+        // An unterminated last line still counts
+        if (size != 0 && offset == size)
+        {
+            char last = 0;
+            if (m_file.Map(size - 1, 1, view))
+                last = *view.Data();
+            if (last != '\n')
+                m_lines.store(lines + 1, std::memory_order_release);
+        }
+        m_done.store(true, std::memory_order_release);
+    }
+
+    MappedLogFile m_file;
+    mutable std::mutex m_lock;                     // m_checkpoints, m_filter
+    std::vector<uint64_t> m_checkpoints;           // offset of line k * kViewStrideLines
+    std::shared_ptr<const FilterState> m_filter;
+    std::atomic<uint64_t> m_lines;
+    std::atomic<uint64_t> m_indexedBytes;
+    std::atomic<bool> m_done;
+    std::atomic<bool> m_failed;
+    std::atomic<bool> m_stop;
+    std::thread m_indexer;
+};
@@ -0,0 +1,604 @@
+﻿// AchikoLoad.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// AchikoLoad — multi-bot load generator for Achikobuddy's ingest path
+//
+// Responsibilities:
+// • Simulates N injected bots, each with the two connections a real bot
+//   opens: AchikoPipe_AchikoDLL (managed logs) and AchikoPipe_Bootstrapper
+//   (native loader logs)
+// • Four traffic sources per bot — log, telemetry, command echo, native —
+//   each with its own rate, all scaled by a burst shape
+// • Reports offered vs. sustained lines/s per source, client-side write
+//   stall latency, and end-to-end latency (send → line in log file)
+// • Sweep mode doubles rates each step until the sink saturates
+//
+// Architecture:
+// • One thread per bot connection; the managed connection flushes every
+//   33 ms (PipeClient.LogThreadLoop cadence), native writes every 1 ms
+// • Each line carries a probe " ~p<source>:<sendNs>"; LogTailer reads the
+//   sink's log file and records now - sendNs
+// • On Linux, --sink runs a Bugger stand-in over Unix sockets so the whole
+//   loop is testable without Windows
+//
+// Usage:
+//   AchikoLoad --bots 16 --duration 10 --tail C:\Achikobuddy\Achikobuddy.log
+//   AchikoLoad --bots 8 --shape burst:200:800:10 --sweep 6 --out load.json
+//   AchikoLoad --sink /tmp/achiko.log --tail /tmp/achiko.log --bots 8
+//
+// Critical Design Decisions:
+// • Open-loop generator: offered load is a function of time only. If the
+//   sink stalls, lines pile up as backlog (like PipeClient's unbounded
+//   queue) instead of silently lowering the offered rate
+// • Saturated = sustained < 95% of offered, or e2e p99 above --max-p99-ms
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "LatencyHistogram.h"
+#include "LineCodec.h"
+#include "LoadShape.h"
+#include "LoadTransport.h"
+#include "LogTailer.h"
+#include "Platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <mmsystem.h>
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// SOURCES
+// ═══════════════════════════════════════════════════════════════
+
+enum LoadSourceId
+{
+    Source_Log = 0,          // AchikoDLL general logging
+    Source_Telemetry = 1,    // per-tick state lines
+    Source_Command = 2,      // command receipt echoes
+    Source_Native = 3,       // RemoteAchiko bootstrapper logs
+    Source_Count
+};
+
+enum LoadConnection
+{
+    Connection_Managed = 0,  // AchikoPipe_AchikoDLL
+    Connection_Native = 1,   // AchikoPipe_Bootstrapper
+    Connection_Count
+};
+
+struct SourceInfo
+{
+    const char* name;
+    LoadConnection connection;
+    const char* body;        // message text after the bot tag
+};
+
+static const SourceInfo kSources[Source_Count] =
+{
+    { "log",       Connection_Managed, "[Bot] Pull: Defias Pillager (level 14) at 312.5, -1182.0, casting Frostbolt" },
+    { "telemetry", Connection_Managed, "[Telemetry] tick hp=81 mana=40 target=0xF13000001234ABCD x=-9460.3 y=62.8" },
+    { "command",   Connection_Managed, "[PipeClient] Received command: START" },
+    { "native",    Connection_Native,  "[RemoteAchiko] Heartbeat: CLR host alive, AchikoDLL loaded" },
+};
+
+static const char* const kPipeNames[Connection_Count] = { "AchikoDLL", "Bootstrapper" };
+
+// ═══════════════════════════════════════════════════════════════
+// OPTIONS
+// ═══════════════════════════════════════════════════════════════
+
+struct LoadOptions
+{
+    uint32_t bots;
+    uint32_t durationSec;
+    double rates[Source_Count];   // lines/s per bot
+    LoadShape shape;
+    std::string shapeText;
+    std::string pipePrefix;
+    std::string tailPath;
+    std::string sinkPath;
+    std::string outPath;
+    uint32_t sweepSteps;          // 0 = single run
+    double sweepFactor;
+    double maxP99Ms;
+    uint32_t lineBytes;           // pad lines to roughly this size
+    uint32_t managedFlushMs;
+    uint32_t nativeFlushMs;
+
+    LoadOptions()
+        : bots(8), durationSec(10), shapeText("steady"), pipePrefix("AchikoPipe_"),
+          sweepSteps(0), sweepFactor(2.0), maxP99Ms(250.0), lineBytes(0),
+          managedFlushMs(33), nativeFlushMs(1)
+    {
+        rates[Source_Log] = 200.0;
+        rates[Source_Telemetry] = 30.0;
+        rates[Source_Command] = 0.5;
+        rates[Source_Native] = 5.0;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════
+// STATS
+// ═══════════════════════════════════════════════════════════════
+
+struct SourceStats
+{
+    std::atomic<uint64_t> offered;
+    std::atomic<uint64_t> sent;
+    std::atomic<uint64_t> bytes;
+    LatencyHistogram writeStall;   // duration of each Write() call
+
+    void Reset()
+    {
+        offered = 0;
+        sent = 0;
+        bytes = 0;
+        writeStall.Reset();
+    }
+};
+
+struct RunState
+{
+    const LoadOptions* options;
+    double scale;                  // sweep multiplier on all rates
+    uint64_t startNs;
+    uint64_t endNs;
+    std::atomic<uint32_t> connected;
+    std::atomic<uint32_t> connectFailures;
+    std::atomic<uint32_t> brokenPipes;
+    SourceStats stats[Source_Count];
+    LatencyHistogram endToEnd[Source_Count];   // send → visible in sink log file (LogTailer)
+};
+
+// ───────────────────────────────────────────────────────────────
+// AppendU64 — decimal without snprintf (hot path, ~1M lines/s)
+// ───────────────────────────────────────────────────────────────
+static size_t AppendU64(char* out, uint64_t v)
+{
+    char tmp[24];
+    size_t n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// BOT CONNECTION
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// ConnectionLoop — one bot's pipe: accrue credit per source, write
+// due lines one Write() each, sleep until the next flush
+// ───────────────────────────────────────────────────────────────
+static void ConnectionLoop(RunState* run, uint32_t bot, LoadConnection connection)
+{
+    const LoadOptions& o = *run->options;
+
+    LineWriter writer;
+    if (!writer.Connect(o.pipePrefix + kPipeNames[connection], 5000))
+    {
+        run->connectFailures.fetch_add(1);
+        return;
+    }
+    run->connected.fetch_add(1);
+
+    // Per-source line template: "[HH:mm:ss.fff] [BotNN] body<pad> ~p<id>:"
+    std::string bodies[Source_Count];
+    for (uint32_t s = 0; s < Source_Count; ++s)
+    {
+        if (kSources[s].connection != connection)
+            continue;
+        char tag[16];
+        snprintf(tag, sizeof(tag), "[Bot%02u] ", bot);
+        bodies[s] = std::string(tag) + kSources[s].body;
+        while (bodies[s].size() + kLinePrefixLength + 24 < o.lineBytes)
+            bodies[s] += '.';
+        char probe[16];
+        snprintf(probe, sizeof(probe), " ~p%u:", s);
+        bodies[s] += probe;
+    }
+
+    const uint32_t flushMs = connection == Connection_Managed ? o.managedFlushMs : o.nativeFlushMs;
+    double credit[Source_Count] = { 0 };
+    uint64_t lastNs = run->startNs;
+    char line[4096];
+
+    while (writer.IsOpen())
+    {
+        const uint64_t now = PlatformNowNs();
+        if (now >= run->endNs)
+            break;
+
+        const double dt = (double)(now - lastNs) / 1e9;
+        const double mult = o.shape.Multiplier(now - run->startNs) * run->scale;
+
+        for (uint32_t s = 0; s < Source_Count && writer.IsOpen(); ++s)
+        {
+            if (bodies[s].empty())
+                continue;
+
+            credit[s] += o.rates[s] * mult * dt;
+            if (s == Source_Log)
+                credit[s] += o.shape.SpikeLines(lastNs - run->startNs, now - run->startNs);
+
+            const uint64_t due = (uint64_t)credit[s];
+            credit[s] -= (double)due;
+            run->stats[s].offered.fetch_add(due, std::memory_order_relaxed);
+
+            const uint32_t msOfDay = PlatformLocalMsOfDay();
+            for (uint64_t k = 0; k < due; ++k)
+            {
+                size_t n = EncodeLinePrefix(line, msOfDay);
+                memcpy(line + n, bodies[s].data(), bodies[s].size());
+                n += bodies[s].size();
+
+                const uint64_t sendNs = PlatformNowNs();
+                n += AppendU64(line + n, sendNs);
+                line[n++] = '\n';
+
+                if (!writer.Write(line, n))
+                {
+                    run->brokenPipes.fetch_add(1);
+                    break;
+                }
+
+                const uint64_t doneNs = PlatformNowNs();
+                run->stats[s].writeStall.Record(doneNs - sendNs);
+                run->stats[s].sent.fetch_add(1, std::memory_order_relaxed);
+                run->stats[s].bytes.fetch_add(n, std::memory_order_relaxed);
+
+                if (doneNs >= run->endNs)
+                    break;
+            }
+        }
+
+        lastNs = now;
+        PlatformSleepMs(flushMs);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// REPORTING
+// ═══════════════════════════════════════════════════════════════
+
+struct SourceSummary
+{
+    double offeredPerSec;
+    double sentPerSec;
+    uint64_t writeP99Ns;
+    uint64_t e2eCount;
+    uint64_t e2eP50Ns;
+    uint64_t e2eP99Ns;
+    uint64_t e2eMaxNs;
+};
+
+struct StepSummary
+{
+    double scale;
+    double seconds;
+    uint32_t connected;
+    uint32_t connectFailures;
+    uint32_t brokenPipes;
+    SourceSummary sources[Source_Count];
+    double offeredTotal;
+    double sentTotal;
+    uint64_t e2eP99WorstNs;
+    bool saturated;
+};
+
+static StepSummary Summarize(RunState& run, double seconds, const LoadOptions& o)
+{
+    StepSummary step;
+    step.scale = run.scale;
+    step.seconds = seconds;
+    step.connected = run.connected.load();
+    step.connectFailures = run.connectFailures.load();
+    step.brokenPipes = run.brokenPipes.load();
+    step.offeredTotal = 0;
+    step.sentTotal = 0;
+    step.e2eP99WorstNs = 0;
+
+    for (uint32_t s = 0; s < Source_Count; ++s)
+    {
+        SourceStats& st = run.stats[s];
+        SourceSummary& sum = step.sources[s];
+        sum.offeredPerSec = (double)st.offered.load() / seconds;
+        sum.sentPerSec = (double)st.sent.load() / seconds;
+        sum.writeP99Ns = st.writeStall.Percentile(99);
+        sum.e2eCount = run.endToEnd[s].Count();
+        sum.e2eP50Ns = run.endToEnd[s].Percentile(50);
+        sum.e2eP99Ns = run.endToEnd[s].Percentile(99);
+        sum.e2eMaxNs = run.endToEnd[s].Max();
+
+        step.offeredTotal += sum.offeredPerSec;
+        step.sentTotal += sum.sentPerSec;
+        if (sum.e2eP99Ns > step.e2eP99WorstNs)
+            step.e2eP99WorstNs = sum.e2eP99Ns;
+    }
+
+    step.saturated = (step.offeredTotal > 0 && step.sentTotal < 0.95 * step.offeredTotal) ||
+                     (double)step.e2eP99WorstNs > o.maxP99Ms * 1e6 ||
+                     step.brokenPipes > 0;
+    return step;
+}
+
+static void PrintStep(const StepSummary& step, bool tailing)
+{
+    printf("\nscale x%-6.2f  %.1fs  connections %u (failed %u, broken %u)\n",
+           step.scale, step.seconds, step.connected, step.connectFailures, step.brokenPipes);
+    printf("  %-10s %12s %12s %12s", "source", "offered/s", "sent/s", "write p99");
+    if (tailing)
+        printf(" %10s %10s %10s", "e2e p50", "e2e p99", "e2e max");
+    printf("\n");
+
+    for (uint32_t s = 0; s < Source_Count; ++s)
+    {
+        const SourceSummary& sum = step.sources[s];
+        printf("  %-10s %12.0f %12.0f %9.2f ms", kSources[s].name,
+               sum.offeredPerSec, sum.sentPerSec, sum.writeP99Ns / 1e6);
+        if (tailing)
+        {
+            if (sum.e2eCount)
+                printf(" %7.2f ms %7.2f ms %7.2f ms", sum.e2eP50Ns / 1e6, sum.e2eP99Ns / 1e6, sum.e2eMaxNs / 1e6);
+            else
+                printf(" %10s %10s %10s", "-", "-", "-");
+        }
+        printf("\n");
+    }
+    printf("  %-10s %12.0f %12.0f   %s\n", "total", step.offeredTotal, step.sentTotal,
+           step.saturated ? "SATURATED" : "ok");
+}
+
+static bool WriteJson(const std::string& path, const LoadOptions& o, const std::vector<StepSummary>& steps)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+
+    fprintf(f, "{\n  \"tool\": \"AchikoLoad\",\n  \"bots\": %u,\n  \"shape\": \"%s\",\n  \"steps\": [\n",
+            o.bots, o.shapeText.c_str());
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        const StepSummary& st = steps[i];
+        fprintf(f, "    { \"scale\": %.3f, \"seconds\": %.3f, \"saturated\": %s, \"offered_per_sec\": %.1f, \"sent_per_sec\": %.1f,\n",
+                st.scale, st.seconds, st.saturated ? "true" : "false", st.offeredTotal, st.sentTotal);
+        fprintf(f, "      \"sources\": {");
+        for (uint32_t s = 0; s < Source_Count; ++s)
+        {
+            const SourceSummary& sum = st.sources[s];
+            fprintf(f, "%s\n        \"%s\": { \"offered_per_sec\": %.1f, \"sent_per_sec\": %.1f, \"write_p99_ns\": %llu, "
+                       "\"e2e_samples\": %llu, \"e2e_p50_ns\": %llu, \"e2e_p99_ns\": %llu, \"e2e_max_ns\": %llu }",
+                    s ? "," : "", kSources[s].name, sum.offeredPerSec, sum.sentPerSec,
+                    (unsigned long long)sum.writeP99Ns, (unsigned long long)sum.e2eCount,
+                    (unsigned long long)sum.e2eP50Ns, (unsigned long long)sum.e2eP99Ns,
+                    (unsigned long long)sum.e2eMaxNs);
+        }
+        fprintf(f, " } }%s\n", i + 1 < steps.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RUN
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// RunStep — one timed run at `scale`, printing sent lines/s each second
+// ───────────────────────────────────────────────────────────────
+static StepSummary RunStep(const LoadOptions& o, double scale)
+{
+    RunState* run = new RunState();   // ~130 KB of histograms — keep off the stack
+    run->options = &o;
+    run->scale = scale;
+    run->connected = 0;
+    run->connectFailures = 0;
+    run->brokenPipes = 0;
+    for (uint32_t s = 0; s < Source_Count; ++s)
+    {
+        run->stats[s].Reset();
+        run->endToEnd[s].Reset();
+    }
+
+    LogTailer tailer(run->endToEnd, Source_Count);
+    const bool tailing = !o.tailPath.empty();
+    if (tailing && !tailer.Start(o.tailPath))
+        fprintf(stderr, "[load] Cannot open %s for tailing — no end-to-end latency\n", o.tailPath.c_str());
+
+    run->startNs = PlatformNowNs();
+    run->endNs = run->startNs + (uint64_t)o.durationSec * 1000000000ULL;
+
+    std::vector<std::thread> threads;
+    for (uint32_t b = 0; b < o.bots; ++b)
+        for (uint32_t c = 0; c < Connection_Count; ++c)
+            threads.push_back(std::thread(ConnectionLoop, run, b, (LoadConnection)c));
+
+    uint64_t lastSent = 0;
+    for (uint32_t sec = 0; sec < o.durationSec; ++sec)
+    {
+        PlatformSleepMs(1000);
+        uint64_t sent = 0;
+        for (uint32_t s = 0; s < Source_Count; ++s)
+            sent += run->stats[s].sent.load(std::memory_order_relaxed);
+        fprintf(stderr, "[load] t=%3us  sent %8llu lines/s  connections %u\n",
+                sec + 1, (unsigned long long)(sent - lastSent), run->connected.load());
+        lastSent = sent;
+    }
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+    const double seconds = (double)(PlatformNowNs() - run->startNs) / 1e9;
+
+    // Give the sink a moment to drain what is already in the pipes
+    if (tailing)
+        PlatformSleepMs(500);
+    tailer.Stop();
+
+    const StepSummary step = Summarize(*run, seconds, o);
+    delete run;
+    return step;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "Usage: AchikoLoad [options]\n"
+        "  --bots N                simulated bots (default 8)\n"
+        "  --duration S            seconds per run / sweep step (default 10)\n"
+        "  --log-rate R            log lines/s per bot (default 200)\n"
+        "  --telemetry-rate R      telemetry lines/s per bot (default 30)\n"
+        "  --command-rate R        command echo lines/s per bot (default 0.5)\n"
+        "  --native-rate R         native loader lines/s per bot (default 5)\n"
+        "  --shape SHAPE           steady | burst:ON_MS:OFF_MS:MULT | ramp:S | spike:EVERY_MS:COUNT\n"
+        "  --line-bytes N          pad lines to about N bytes\n"
+        "  --flush-ms MS           managed connection flush interval (default 33)\n"
+        "  --tail FILE             follow the sink's log file for end-to-end latency\n"
+        "  --sweep STEPS           repeat, multiplying rates by --sweep-factor, until saturated\n"
+        "  --sweep-factor F        rate multiplier per sweep step (default 2)\n"
+        "  --max-p99-ms MS         e2e p99 above this counts as saturated (default 250)\n"
+        "  --pipe-prefix P         pipe name prefix (default AchikoPipe_)\n"
+        "  --out FILE              write a JSON summary\n"
+        "  --sink FILE             run an Achikobuddy-like sink writing FILE (Linux);\n"
+        "                          with --bots 0 it only serves until --duration ends\n");
+}
+
+static bool ParseArgs(int argc, char** argv, LoadOptions& o)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char* v = argv[++i];
+
+        if (arg == "--bots") o.bots = (uint32_t)strtoul(v, nullptr, 10);
+        else if (arg == "--duration") o.durationSec = (uint32_t)strtoul(v, nullptr, 10);
+        else if (arg == "--log-rate") o.rates[Source_Log] = strtod(v, nullptr);
+        else if (arg == "--telemetry-rate") o.rates[Source_Telemetry] = strtod(v, nullptr);
+        else if (arg == "--command-rate") o.rates[Source_Command] = strtod(v, nullptr);
+        else if (arg == "--native-rate") o.rates[Source_Native] = strtod(v, nullptr);
+        else if (arg == "--shape")
+        {
+            o.shapeText = v;
+            if (!o.shape.Parse(o.shapeText))
+                return false;
+        }
+        else if (arg == "--line-bytes") o.lineBytes = (uint32_t)strtoul(v, nullptr, 10);
+        else if (arg == "--flush-ms") o.managedFlushMs = (uint32_t)strtoul(v, nullptr, 10);
+        else if (arg == "--tail") o.tailPath = v;
+        else if (arg == "--sweep") o.sweepSteps = (uint32_t)strtoul(v, nullptr, 10);
+        else if (arg == "--sweep-factor") o.sweepFactor = strtod(v, nullptr);
+        else if (arg == "--max-p99-ms") o.maxP99Ms = strtod(v, nullptr);
+        else if (arg == "--pipe-prefix") o.pipePrefix = v;
+        else if (arg == "--out") o.outPath = v;
+        else if (arg == "--sink") o.sinkPath = v;
+        else return false;
+    }
+
+    if (o.lineBytes > 2048)
+        o.lineBytes = 2048;
+    if (o.managedFlushMs == 0)
+        o.managedFlushMs = 1;
+    return o.durationSec > 0 && o.sweepFactor > 1.0;
+}
+
+int main(int argc, char** argv)
+{
+    LoadOptions o;
+    if (!ParseArgs(argc, argv, o))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+#ifdef _WIN32
+    timeBeginPeriod(1);   // 1 ms Sleep granularity for flush pacing and tailing
+#endif
+
+    // ───────────────────────────────────────────────────────────
+    // Optional local sink (Linux) — Bugger stand-in
+    // ───────────────────────────────────────────────────────────
+    LineSink nativeSink, managedSink;
+    if (!o.sinkPath.empty())
+    {
+        FILE* f = fopen(o.sinkPath.c_str(), "wb");   // fresh file, like Bugger's ctor
+        if (f)
+            fclose(f);
+
+        if (!nativeSink.Start(o.pipePrefix + kPipeNames[Connection_Native], "[RemoteAchiko]", o.sinkPath) ||
+            !managedSink.Start(o.pipePrefix + kPipeNames[Connection_Managed], "[AchikoDLL]", o.sinkPath))
+        {
+            fprintf(stderr, "[load] Cannot start sink (Windows: run Achikobuddy instead)\n");
+            return 2;
+        }
+        fprintf(stderr, "[load] Sink listening on %s*, writing %s\n",
+                LoadEndpointPath(o.pipePrefix).c_str(), o.sinkPath.c_str());
+
+        if (o.bots == 0)
+        {
+            uint64_t last = 0;
+            for (uint32_t sec = 0; sec < o.durationSec; ++sec)
+            {
+                PlatformSleepMs(1000);
+                const uint64_t total = nativeSink.LinesReceived() + managedSink.LinesReceived();
+                fprintf(stderr, "[load] sink %8llu lines/s\n", (unsigned long long)(total - last));
+                last = total;
+            }
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "[load] %u bots, shape %s, %us per step, rates/bot: log %.1f telemetry %.1f command %.1f native %.1f\n",
+            o.bots, o.shapeText.c_str(), o.durationSec,
+            o.rates[Source_Log], o.rates[Source_Telemetry], o.rates[Source_Command], o.rates[Source_Native]);
+
+    // ───────────────────────────────────────────────────────────
+    // Single run or saturation sweep
+    // ───────────────────────────────────────────────────────────
+    std::vector<StepSummary> steps;
+    const uint32_t stepCount = o.sweepSteps ? o.sweepSteps : 1;
+    double scale = 1.0;
+
+    for (uint32_t i = 0; i < stepCount; ++i)
+    {
+        const StepSummary step = RunStep(o, scale);
+        steps.push_back(step);
+        PrintStep(step, !o.tailPath.empty());
+
+        if (step.saturated && o.sweepSteps)
+        {
+            const double sustained = i > 0 ? steps[i - 1].sentTotal : 0.0;
+            printf("\nSaturated at x%.2f (offered %.0f lines/s, sustained %.0f).", scale, step.offeredTotal, step.sentTotal);
+            if (i > 0)
+                printf(" Last healthy step sustained %.0f lines/s.", sustained);
+            printf("\n");
+            break;
+        }
+        scale *= o.sweepFactor;
+    }
+
+    if (o.sweepSteps && !steps.back().saturated)
+        printf("\nNo saturation up to x%.2f (%.0f lines/s sustained).\n", steps.back().scale, steps.back().sentTotal);
+
+    if (!o.outPath.empty() && !WriteJson(o.outPath, o, steps))
+        fprintf(stderr, "[load] Cannot write %s\n", o.outPath.c_str());
+
+    managedSink.Stop();
+    nativeSink.Stop();
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+    return 0;
+}
@@ -0,0 +1,102 @@
+﻿// LoadShape.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Traffic shapes for AchikoLoad — how offered load varies over time
+//
+// Shapes (command line syntax):
+//   steady                      constant rate
+//   burst:ON_MS:OFF_MS:MULT     square wave — MULT x rate for ON_MS, then
+//                               OFF_MS at base rate (combat pulls, loot spam)
+//   ramp:SECONDS                linear ramp from 0 to full rate (sweeps)
+//   spike:EVERY_MS:COUNT        base rate plus COUNT extra lines at once
+//                               every EVERY_MS (exception dumps, reloads)
+//
+// Architecture:
+// • Multiplier(t) scales every source's rate at time t since start
+// • SpikeLines(t0, t1) returns extra lines due in (t0, t1]
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+struct LoadShape
+{
+    enum Kind { Steady, Burst, Ramp, Spike };
+
+    Kind kind;
+    uint64_t onNs, offNs;       // Burst
+    double multiplier;          // Burst
+    uint64_t rampNs;            // Ramp
+    uint64_t everyNs;           // Spike
+    uint32_t spikeLines;        // Spike
+
+    LoadShape()
+        : kind(Steady), onNs(0), offNs(0), multiplier(1.0), rampNs(0), everyNs(0), spikeLines(0) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Parse — from "steady" / "burst:200:800:10" / "ramp:30" / "spike:1000:500"
+    //
+    // Returns:
+    //   false on syntax error (shape left unchanged)
+    // ───────────────────────────────────────────────────────────────
+    bool Parse(const std::string& text)
+    {
+        LoadShape s;
+        unsigned a = 0, b = 0;
+        double m = 0;
+
+        if (text == "steady")
+        {
+            s.kind = Steady;
+        }
+        else if (sscanf(text.c_str(), "burst:%u:%u:%lf", &a, &b, &m) == 3 && a > 0 && m > 0)
+        {
+            s.kind = Burst;
+            s.onNs = a * 1000000ULL;
+            s.offNs = b * 1000000ULL;
+            s.multiplier = m;
+        }
+        else if (sscanf(text.c_str(), "ramp:%u", &a) == 1 && a > 0)
+        {
+            s.kind = Ramp;
+            s.rampNs = a * 1000000000ULL;
+        }
+        else if (sscanf(text.c_str(), "spike:%u:%u", &a, &b) == 2 && a > 0)
+        {
+            s.kind = Spike;
+            s.everyNs = a * 1000000ULL;
+            s.spikeLines = b;
+        }
+        else
+        {
+            return false;
+        }
+
+        *this = s;
+        return true;
+    }
+
+    double Multiplier(uint64_t tNs) const
+    {
+        switch (kind)
+        {
+        case Burst:
+            return (tNs % (onNs + offNs)) < onNs ? multiplier : 1.0;
+        case Ramp:
+            return tNs >= rampNs ? 1.0 : (double)tNs / (double)rampNs;
+        default:
+            return 1.0;
+        }
+    }
+
+    uint32_t SpikeLines(uint64_t t0Ns, uint64_t t1Ns) const
+    {
+        if (kind != Spike || t1Ns <= t0Ns)
+            return 0;
+        const uint64_t crossed = t1Ns / everyNs - t0Ns / everyNs;
+        return (uint32_t)(crossed * spikeLines);
+    }
+};
@@ -0,0 +1,364 @@
+﻿// LoadTransport.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Named pipe (Windows) and Unix socket (Linux) transports for AchikoLoad
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "LoadTransport.h"
+#include "LineCodec.h"
+#include "Platform.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+std::string LoadEndpointPath(const std::string& name)
+{
+#ifdef _WIN32
+    return "\\\\.\\pipe\\" + name;
+#else
+    const char* tmp = getenv("TMPDIR");
+    std::string dir = (tmp && *tmp) ? tmp : "/tmp";
+    if (dir[dir.size() - 1] != '/')
+        dir += '/';
+    return dir + name;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// LINE WRITER
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef _WIN32
+
+LineWriter::LineWriter() : m_handle(INVALID_HANDLE_VALUE) {}
+LineWriter::~LineWriter() { Close(); }
+
+bool LineWriter::Connect(const std::string& name, uint32_t timeoutMs)
+{
+    Close();
+    const std::string path = LoadEndpointPath(name);
+    const uint64_t deadline = PlatformNowNs() + (uint64_t)timeoutMs * 1000000ULL;
+
+    for (;;)
+    {
+        HANDLE h = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (h != INVALID_HANDLE_VALUE)
+        {
+            m_handle = h;
+            return true;
+        }
+
+        // ERROR_PIPE_BUSY: every instance taken — wait for Bugger to create the next
+        // ERROR_FILE_NOT_FOUND: Achikobuddy not running (yet)
+        const uint64_t now = PlatformNowNs();
+        if (now >= deadline)
+            return false;
+        if (GetLastError() == ERROR_PIPE_BUSY)
+            WaitNamedPipeA(path.c_str(), 100);
+        else
+            PlatformSleepMs(50);
+    }
+}
+
+bool LineWriter::Write(const char* data, size_t length)
+{
+    if (m_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    while (length > 0)
+    {
+        DWORD written = 0;
+        if (!WriteFile((HANDLE)m_handle, data, (DWORD)length, &written, nullptr))
+        {
+            Close();
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+void LineWriter::Close()
+{
+    if (m_handle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle((HANDLE)m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool LineWriter::IsOpen() const { return m_handle != INVALID_HANDLE_VALUE; }
+
+#else
+
+LineWriter::LineWriter() : m_fd(-1) {}
+LineWriter::~LineWriter() { Close(); }
+
+bool LineWriter::Connect(const std::string& name, uint32_t timeoutMs)
+{
+    Close();
+    const std::string path = LoadEndpointPath(name);
+    const uint64_t deadline = PlatformNowNs() + (uint64_t)timeoutMs * 1000000ULL;
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    for (;;)
+    {
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return false;
+
+        if (connect(fd, (const sockaddr*)&addr, sizeof(addr)) == 0)
+        {
+            m_fd = fd;
+            return true;
+        }
+        close(fd);
+
+        if (PlatformNowNs() >= deadline)
+            return false;
+        PlatformSleepMs(50);
+    }
+}
+
+bool LineWriter::Write(const char* data, size_t length)
+{
+    if (m_fd < 0)
+        return false;
+
+    while (length > 0)
+    {
+        const ssize_t n = send(m_fd, data, length, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Close();
+            return false;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+void LineWriter::Close()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool LineWriter::IsOpen() const { return m_fd >= 0; }
+
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// LINE SINK
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef _WIN32
+
+struct LineSink::Impl {};
+
+LineSink::LineSink() : m_impl(nullptr) {}
+LineSink::~LineSink() {}
+
+bool LineSink::Start(const std::string&, const std::string&, const std::string&)
+{
+    return false;   // Achikobuddy itself is the sink on Windows
+}
+
+void LineSink::Stop() {}
+uint64_t LineSink::LinesReceived() const { return 0; }
+
+#else
+
+struct LineSink::Impl
+{
+    std::string path;
+    std::string tag;
+    int listenFd;
+    int logFd;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> lines;
+    std::mutex fileLock;             // Bugger's _fileLock
+    std::thread acceptThread;
+    std::mutex clientsLock;
+    std::vector<std::thread> clients;
+    std::vector<int> clientFds;
+
+    Impl() : listenFd(-1), logFd(-1), running(false), lines(0) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // WriteLine — Bugger.WriteLog equivalent: timestamp + tag, one
+    // append per line, serialized across all clients
+    // ───────────────────────────────────────────────────────────────
+    void WriteLine(const char* text, size_t length)
+    {
+        char out[4096];
+        size_t n = EncodeLinePrefix(out, PlatformLocalMsOfDay());
+        memcpy(out + n, tag.data(), tag.size());
+        n += tag.size();
+        out[n++] = ' ';
+        if (length > sizeof(out) - n - 1)
+            length = sizeof(out) - n - 1;
+        memcpy(out + n, text, length);
+        n += length;
+        out[n++] = '\n';
+
+        std::lock_guard<std::mutex> guard(fileLock);
+        if (write(logFd, out, n) < 0) { /* best-effort, like Bugger */ }
+        lines.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void ClientLoop(int fd)
+    {
+        std::vector<char> pending;
+        char buffer[65536];
+
+        while (running.load(std::memory_order_relaxed))
+        {
+            const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+                break;
+
+            size_t start = 0;
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                if (buffer[i] != '\n')
+                    continue;
+
+                size_t end = (size_t)i;
+                if (end > start && buffer[end - 1] == '\r')
+                    --end;
+
+                if (!pending.empty())
+                {
+                    pending.insert(pending.end(), buffer + start, buffer + end);
+                    WriteLine(pending.data(), pending.size());
+                    pending.clear();
+                }
+                else
+                {
+                    WriteLine(buffer + start, end - start);
+                }
+                start = (size_t)i + 1;
+            }
+            pending.insert(pending.end(), buffer + start, buffer + n);
+        }
+        // fd stays open until Stop() — closing here would let accept()
+        // reuse the number while Stop() still holds it in clientFds
+    }
+
+    void AcceptLoop()
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            const int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;   // listen socket shut down by Stop()
+            }
+
+            std::lock_guard<std::mutex> guard(clientsLock);
+            clientFds.push_back(fd);
+            clients.push_back(std::thread(&Impl::ClientLoop, this, fd));
+        }
+    }
+};
+
+LineSink::LineSink() : m_impl(nullptr) {}
+LineSink::~LineSink() { Stop(); }
+
+bool LineSink::Start(const std::string& name, const std::string& tag, const std::string& logPath)
+{
+    Stop();
+    m_impl = new Impl();
+    m_impl->path = LoadEndpointPath(name);
+    m_impl->tag = tag;
+
+    m_impl->logFd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (m_impl->logFd < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, m_impl->path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(m_impl->path.c_str());
+
+    m_impl->listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_impl->listenFd < 0 ||
+        bind(m_impl->listenFd, (const sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(m_impl->listenFd, 128) != 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_impl->running = true;
+    m_impl->acceptThread = std::thread(&Impl::AcceptLoop, m_impl);
+    return true;
+}
+
+void LineSink::Stop()
+{
+    if (!m_impl)
+        return;
+
+    m_impl->running = false;
+    if (m_impl->listenFd >= 0)
+    {
+        shutdown(m_impl->listenFd, SHUT_RDWR);
+        close(m_impl->listenFd);
+        unlink(m_impl->path.c_str());
+    }
+    if (m_impl->acceptThread.joinable())
+        m_impl->acceptThread.join();
+
+    {
+        std::lock_guard<std::mutex> guard(m_impl->clientsLock);
+        for (size_t i = 0; i < m_impl->clientFds.size(); ++i)
+            shutdown(m_impl->clientFds[i], SHUT_RDWR);
+    }
+    for (size_t i = 0; i < m_impl->clients.size(); ++i)
+        m_impl->clients[i].join();
+    for (size_t i = 0; i < m_impl->clientFds.size(); ++i)
+        close(m_impl->clientFds[i]);
+
+    if (m_impl->logFd >= 0)
+        close(m_impl->logFd);
+
+    delete m_impl;
+    m_impl = nullptr;
+}
+
+uint64_t LineSink::LinesReceived() const
+{
+    return m_impl ? m_impl->lines.load(std::memory_order_relaxed) : 0;
+}
+
+#endif
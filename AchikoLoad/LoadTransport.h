@@ -0,0 +1,102 @@
+﻿// LoadTransport.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Line transport for AchikoLoad — what a simulated bot writes into
+//
+// Responsibilities:
+// • LineWriter: client end of an Achikobuddy log pipe (one per bot per pipe)
+// • LineSink:   Achikobuddy-like server end (Linux only) — accepts many
+//               clients, tags each line and appends it to a log file
+//
+// Architecture:
+// • Windows: named pipes (\\.\pipe\<name>) — same endpoints Bugger serves
+// • Linux:   Unix domain stream sockets at $TMPDIR/<name> — same byte
+//            stream semantics, one connection per client
+// • Writers are blocking: a full pipe stalls the bot exactly like a
+//   stalled Bugger stalls PipeClient's flush thread
+//
+// Critical Design Decisions:
+// • One Write() per line — mirrors PipeClient.FlushQueueNonBlocking, so
+//   per-line syscall cost on the server side is part of what we measure
+// • The sink reproduces Bugger.WriteLog's "[HH:mm:ss.fff] [Source] line"
+//   format and its one-append-per-line file pattern
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// ───────────────────────────────────────────────────────────────
+// LoadEndpointPath — OS path for a pipe name ("AchikoPipe_AchikoDLL")
+// ───────────────────────────────────────────────────────────────
+std::string LoadEndpointPath(const std::string& name);
+
+// ═══════════════════════════════════════════════════════════════
+// LineWriter — client connection to one pipe
+// ═══════════════════════════════════════════════════════════════
+class LineWriter
+{
+public:
+    LineWriter();
+    ~LineWriter();
+
+    // ───────────────────────────────────────────────────────────────
+    // Connect — open the endpoint, retrying until timeoutMs elapses
+    //
+    // Returns:
+    //   true if connected
+    // ───────────────────────────────────────────────────────────────
+    bool Connect(const std::string& name, uint32_t timeoutMs);
+
+    // ───────────────────────────────────────────────────────────────
+    // Write — send bytes (blocking until the server has buffer space)
+    //
+    // Returns:
+    //   false if the connection broke (writer is closed afterwards)
+    // ───────────────────────────────────────────────────────────────
+    bool Write(const char* data, size_t length);
+
+    void Close();
+    bool IsOpen() const;
+
+private:
+    LineWriter(const LineWriter&);
+    LineWriter& operator=(const LineWriter&);
+
+#ifdef _WIN32
+    void* m_handle;
+#else
+    int m_fd;
+#endif
+};
+
+// ═══════════════════════════════════════════════════════════════
+// LineSink — stand-in for Bugger's pipe servers (Linux)
+// ═══════════════════════════════════════════════════════════════
+class LineSink
+{
+public:
+    LineSink();
+    ~LineSink();
+
+    // ───────────────────────────────────────────────────────────────
+    // Start — listen on `name`, tag lines with `tag`, append to logPath
+    //
+    // Returns:
+    //   false on platforms without a sink (Windows: run Achikobuddy) or
+    //   if the endpoint could not be created
+    // ───────────────────────────────────────────────────────────────
+    bool Start(const std::string& name, const std::string& tag, const std::string& logPath);
+
+    void Stop();
+
+    uint64_t LinesReceived() const;
+
+private:
+    LineSink(const LineSink&);
+    LineSink& operator=(const LineSink&);
+
+    struct Impl;
+    Impl* m_impl;
+};
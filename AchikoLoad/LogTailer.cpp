@@ -0,0 +1,125 @@
+﻿// LogTailer.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Log file follower for end-to-end latency measurement
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "LogTailer.h"
+#include "Platform.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+LogTailer::LogTailer(LatencyHistogram* histograms, uint32_t count)
+    : m_histograms(histograms), m_count(count), m_running(false), m_lines(0)
+{
+}
+
+LogTailer::~LogTailer()
+{
+    Stop();
+}
+
+bool LogTailer::Start(const std::string& path)
+{
+    Stop();
+
+    // Fail early if the file does not exist — a typo would otherwise
+    // silently report "no latency samples"
+    FILE* probe = fopen(path.c_str(), "rb");
+    if (!probe)
+        return false;
+    fclose(probe);
+
+    m_path = path;
+    m_running = true;
+    m_thread = std::thread(&LogTailer::Run, this);
+    return true;
+}
+
+void LogTailer::Stop()
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+// ───────────────────────────────────────────────────────────────
+// Run — read appended bytes, split lines, parse probes
+// ───────────────────────────────────────────────────────────────
+void LogTailer::Run()
+{
+    FILE* f = fopen(m_path.c_str(), "rb");
+    if (!f)
+        return;
+    fseek(f, 0, SEEK_END);
+
+    std::vector<char> pending;
+    std::vector<char> buffer(1 << 20);
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        const size_t n = fread(buffer.data(), 1, buffer.size(), f);
+        if (n == 0)
+        {
+            clearerr(f);   // EOF is sticky — reset it to see new appends
+            PlatformSleepMs(1);
+            continue;
+        }
+
+        const uint64_t nowNs = PlatformNowNs();
+        size_t start = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (buffer[i] != '\n')
+                continue;
+
+            if (!pending.empty())
+            {
+                pending.insert(pending.end(), buffer.data() + start, buffer.data() + i);
+                ParseLine(pending.data(), pending.size(), nowNs);
+                pending.clear();
+            }
+            else
+            {
+                ParseLine(buffer.data() + start, i - start, nowNs);
+            }
+            start = i + 1;
+        }
+        pending.insert(pending.end(), buffer.data() + start, buffer.data() + n);
+    }
+
+    fclose(f);
+}
+
+// ───────────────────────────────────────────────────────────────
+// ParseLine — find the last " ~p<id>:<ns>" and record its latency
+// ───────────────────────────────────────────────────────────────
+void LogTailer::ParseLine(const char* line, size_t length, uint64_t nowNs)
+{
+    m_lines.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = length; i >= 3; --i)
+    {
+        const char* p = line + i - 3;
+        if (p[0] != ' ' || p[1] != '~' || p[2] != 'p')
+            continue;
+
+        const char* c = p + 3;
+        const char* end = line + length;
+        uint32_t id = 0;
+        while (c < end && *c >= '0' && *c <= '9')
+            id = id * 10 + (uint32_t)(*c++ - '0');
+        if (c >= end || *c != ':' || id >= m_count)
+            return;
+
+        ++c;
+        uint64_t sendNs = 0;
+        while (c < end && *c >= '0' && *c <= '9')
+            sendNs = sendNs * 10 + (uint64_t)(*c++ - '0');
+
+        if (sendNs != 0 && nowNs >= sendNs)
+            m_histograms[id].Record(nowNs - sendNs);
+        return;
+    }
+}
@@ -0,0 +1,61 @@
+﻿// LogTailer.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Follows the sink's log file and turns probe stamps into end-to-end latency
+//
+// Responsibilities:
+// • Poll a growing file (Achikobuddy.log or the Linux sink's file)
+// • Find each line's probe stamp " ~p<source>:<sendNs>" and record
+//   now - sendNs into that source's histogram
+//
+// Architecture:
+// • One background thread, 1 ms poll — latency resolution is ~1 ms,
+//   which is fine for the 10-1000 ms effects a saturated UI shows
+// • Starts at the current end of file; earlier content is ignored
+//
+// Critical Design Decisions:
+// • Send stamps are PlatformNowNs() in the AchikoLoad process — same
+//   process reads them back, so no cross-process clock assumptions
+// • File is opened shared (Bugger appends while we read)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+class LogTailer
+{
+public:
+    // ───────────────────────────────────────────────────────────────
+    // Constructor
+    //
+    // Args:
+    //   histograms - one per source id (probe "~p<id>:")
+    //   count      - number of histograms
+    // ───────────────────────────────────────────────────────────────
+    LogTailer(LatencyHistogram* histograms, uint32_t count);
+    ~LogTailer();
+
+    bool Start(const std::string& path);
+    void Stop();
+
+    uint64_t LinesSeen() const { return m_lines.load(std::memory_order_relaxed); }
+
+private:
+    LogTailer(const LogTailer&);
+    LogTailer& operator=(const LogTailer&);
+
+    void Run();
+    void ParseLine(const char* line, size_t length, uint64_t nowNs);
+
+    LatencyHistogram* m_histograms;
+    uint32_t m_count;
+    std::string m_path;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_lines;
+    std::thread m_thread;
+};
@@ -0,0 +1,265 @@
+﻿// ClientModel.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Typed model of the WoW clients Achikobuddy can see, with coalesced diffs
+//
+// Responsibilities:
+// • One ClientRecord per live WoW process: PID, attach state, bootstrap stage
+// • Apply notifications from the platform watcher (start, exit, stage)
+//   and from the UI (attach)
+// • Hand the consumer only what changed since its last drain, as
+//   Added / Changed / Removed diffs
+//
+// Architecture:
+// • Header-only, no OS calls — ProcessWatchWin.cpp feeds it in Achikobuddy,
+//   ProcessWatchLinux.cpp feeds it in RemoteAchikoBench
+// • Two tables: m_clients (current truth) and m_reported (what the consumer
+//   has been told); a diff is computed per dirty PID at drain time
+// • Wait() blocks on a condition variable — the consumer thread sleeps
+//   until something actually changed
+//
+// Critical Design Decisions:
+// • Coalescing: a client that starts and changes stage three times before
+//   the UI drains is ONE Added diff with the latest state; one that starts
+//   and exits in between produces nothing
+// • PID reuse: every start gets a new generation, so a recycled PID is
+//   reported as Removed + Added, never as a Changed of the old client
+// • ClientDiff is blittable with fixed-width fields — Achikobuddy marshals
+//   arrays of it straight from AchikoWatchWait
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "BootstrapStage.h"
+#include "Platform.h"
+
+enum AttachState : uint32_t
+{
+    Attach_None = 0,       // no bot in this client
+    Attach_Attached = 1,   // "AchikobuddyBot_PID_<pid>" mutex exists
+};
+
+enum ClientDiffKind : uint32_t
+{
+    ClientDiff_Added = 1,
+    ClientDiff_Changed = 2,
+    ClientDiff_Removed = 3,
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ClientRecord / ClientDiff
+// ═══════════════════════════════════════════════════════════════
+struct ClientRecord
+{
+    uint32_t pid;
+    uint32_t attach;       // AttachState
+    uint32_t bootstrap;    // BootstrapStage
+    uint32_t generation;   // bumped on every process start (PID reuse)
+};
+
+struct ClientDiff
+{
+    uint32_t kind;         // ClientDiffKind
+    uint32_t pid;
+    uint32_t attach;
+    uint32_t bootstrap;
+    uint64_t eventNs;      // PlatformNowNs() of the first change in this diff
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ClientModel
+// ═══════════════════════════════════════════════════════════════
+class ClientModel
+{
+public:
+    ClientModel() : m_nextGeneration(1), m_stopped(false) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Watcher side
+    // ───────────────────────────────────────────────────────────────
+
+    // Returns false if the PID was already tracked (snapshot + event race)
+    bool OnProcessStarted(uint32_t pid, uint32_t attach)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_clients.count(pid))
+            return false;
+
+        ClientRecord record = { pid, attach, Bootstrap_None, m_nextGeneration++ };
+        m_clients[pid] = record;
+        MarkDirty(pid);
+        return true;
+    }
+
+    void OnProcessExited(uint32_t pid)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_clients.erase(pid))
+            MarkDirty(pid);
+    }
+
+    void SetBootstrap(uint32_t pid, uint32_t stage)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::map<uint32_t, ClientRecord>::iterator it = m_clients.find(pid);
+        if (it == m_clients.end() || it->second.bootstrap == Bootstrap_Failed)
+            return;
+        if (stage != Bootstrap_Failed && stage <= it->second.bootstrap)
+            return;   // late delivery of an earlier stage
+
+        it->second.bootstrap = stage;
+        MarkDirty(pid);
+    }
+
+    void SetAttach(uint32_t pid, uint32_t attach)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::map<uint32_t, ClientRecord>::iterator it = m_clients.find(pid);
+        if (it == m_clients.end() || it->second.attach == attach)
+            return;
+
+        it->second.attach = attach;
+        MarkDirty(pid);
+    }
+
+    bool IsTracked(uint32_t pid)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_clients.count(pid) != 0;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Consumer side
+    // ───────────────────────────────────────────────────────────────
+
+    // ───────────────────────────────────────────────────────────────
+    // Wait — block until something changed, then drain
+    //
+    // Args:
+    //   out       - [out] diffs, oldest PID change first
+    //   capacity  - entries in out (a Removed + Added pair needs 2)
+    //   timeoutMs - give up after this long (returns 0)
+    //
+    // Returns:
+    //   Diffs written; PIDs that did not fit stay dirty for the next call
+    // ───────────────────────────────────────────────────────────────
+    size_t Wait(ClientDiff* out, size_t capacity, uint32_t timeoutMs)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_changed.wait_for(guard, std::chrono::milliseconds(timeoutMs),
+            [this] { return !m_dirty.empty() || m_stopped; });
+        return DrainLocked(out, capacity);
+    }
+
+    size_t Drain(ClientDiff* out, size_t capacity)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return DrainLocked(out, capacity);
+    }
+
+    // Releases every Wait() — used when the watcher stops
+    void Stop()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stopped = true;
+        m_changed.notify_all();
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_clients.clear();
+        m_reported.clear();
+        m_dirty.clear();
+        m_stopped = false;
+    }
+
+private:
+    struct Dirty
+    {
+        uint32_t pid;
+        uint64_t sinceNs;
+    };
+
+    void MarkDirty(uint32_t pid)
+    {
+        for (size_t i = 0; i < m_dirty.size(); ++i)
+        {
+            if (m_dirty[i].pid == pid)
+                return;   // keep the first timestamp — latency runs from there
+        }
+
+        Dirty d = { pid, PlatformNowNs() };
+        m_dirty.push_back(d);
+        m_changed.notify_all();
+    }
+
+    static ClientDiff MakeDiff(uint32_t kind, const ClientRecord& record, uint64_t eventNs)
+    {
+        ClientDiff diff = { kind, record.pid, record.attach, record.bootstrap, eventNs };
+        return diff;
+    }
+
+    size_t DrainLocked(ClientDiff* out, size_t capacity)
+    {
+        size_t count = 0;
+        size_t done = 0;
+
+        for (; done < m_dirty.size(); ++done)
+        {
+            const Dirty& d = m_dirty[done];
+            std::map<uint32_t, ClientRecord>::iterator now = m_clients.find(d.pid);
+            std::map<uint32_t, ClientRecord>::iterator seen = m_reported.find(d.pid);
+            const bool present = now != m_clients.end();
+            const bool known = seen != m_reported.end();
+
+            if (present && known && now->second.generation != seen->second.generation)
+            {
+                if (capacity - count < 2)
+                    break;
+                out[count++] = MakeDiff(ClientDiff_Removed, seen->second, d.sinceNs);
+                out[count++] = MakeDiff(ClientDiff_Added, now->second, d.sinceNs);
+                seen->second = now->second;
+                continue;
+            }
+
+            if (count == capacity)
+                break;
+
+            if (present && !known)
+            {
+                out[count++] = MakeDiff(ClientDiff_Added, now->second, d.sinceNs);
+                m_reported[d.pid] = now->second;
+            }
+            else if (!present && known)
+            {
+                out[count++] = MakeDiff(ClientDiff_Removed, seen->second, d.sinceNs);
+                m_reported.erase(seen);
+            }
+            else if (present && (now->second.attach != seen->second.attach ||
+                                 now->second.bootstrap != seen->second.bootstrap))
+            {
+                out[count++] = MakeDiff(ClientDiff_Changed, now->second, d.sinceNs);
+                seen->second = now->second;
+            }
+            // else: started and exited (or changed and changed back) between drains
+        }
+
+        m_dirty.erase(m_dirty.begin(), m_dirty.begin() + done);
+        return count;
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_changed;
+    std::map<uint32_t, ClientRecord> m_clients;    // current state
+    std::map<uint32_t, ClientRecord> m_reported;   // consumer's view
+    std::vector<Dirty> m_dirty;                    // PIDs to diff, in change order
+    uint32_t m_nextGeneration;
+    bool m_stopped;
+};
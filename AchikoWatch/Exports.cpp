@@ -0,0 +1,74 @@
+﻿// Exports.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// extern "C" surface of AchikoWatch.dll for Achikobuddy (P/Invoke)
+//
+// Responsibilities:
+// • Start / stop the process watcher for the Launcher
+// • Block a consumer thread until client diffs are available
+// • Let the UI report attach changes it makes itself (the mutex)
+//
+// Architecture:
+// • Loaded by Achikobuddy.exe, NOT injected — one watcher per UI process,
+//   a heap singleton like RemoteAchiko's recorders
+// • Signatures mirrored by ProcessWatcher.cs (cdecl, blittable ClientDiff)
+//
+// Critical Design Decisions:
+// • Never throws across the boundary
+// • AchikoWatchWait is the only blocking call and always honours its
+//   timeout, so the managed consumer thread can be stopped
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include <Windows.h>
+#include "ProcessWatch.h"
+
+#define ACHIKO_EXPORT extern "C" __declspec(dllexport)
+
+static ProcessWatch& Watch()
+{
+    static ProcessWatch* s_watch = new ProcessWatch();
+    return *s_watch;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoWatchStart — watch processes named imageName ("WoW.exe")
+//
+// Returns:
+//   1 if start notifications are live, 0 if unavailable (caller falls
+//   back to its own discovery)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoWatchStart(const char* imageName)
+{
+    if (!imageName || !*imageName)
+        return 0;
+    return Watch().Start(imageName) ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoWatchStop()
+{
+    Watch().Stop();
+}
+
+// Notification source in use ("wmi trace", "wmi instance", "none")
+ACHIKO_EXPORT const char* __cdecl AchikoWatchSource()
+{
+    return Watch().Source();
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoWatchWait — block until clients changed, then drain diffs
+//
+// Returns:
+//   Diffs written to out (0 on timeout or after AchikoWatchStop)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoWatchWait(ClientDiff* out, int capacity, int timeoutMs)
+{
+    if (!out || capacity <= 0)
+        return 0;
+    return (int)Watch().Model().Wait(out, (size_t)capacity, timeoutMs > 0 ? (uint32_t)timeoutMs : 0);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoWatchSetAttach(int pid, int attached)
+{
+    if (pid > 0)
+        Watch().Model().SetAttach((uint32_t)pid, attached ? Attach_Attached : Attach_None);
+}
@@ -0,0 +1,69 @@
+﻿// ProcessWatch.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Event-driven process watcher — keeps a ClientModel in sync with the OS
+//
+// Responsibilities:
+// • Learn about new processes with a given image name from OS start
+//   notifications, and about their exit from per-process waits
+// • One snapshot at Start() for processes that were already running
+// • Feed everything into the ClientModel (ClientModel.h)
+//
+// Architecture:
+// • One interface, one backend per platform, selected at build time:
+//     ProcessWatchWin.cpp   — WMI process start trace + RegisterWaitFor-
+//                             SingleObject on process handles and on the
+//                             bootstrap stage events (BootstrapStage.h)
+//     ProcessWatchLinux.cpp — netlink proc connector (exec / exit), built
+//                             into RemoteAchikoBench
+// • The backend owns its threads; the consumer only talks to the model
+//
+// Critical Design Decisions:
+// • No polling in steady state on either platform — a quiet system costs
+//   nothing; the only timed wait is the stop check of the event thread
+// • Start() subscribes BEFORE taking the snapshot, so a process starting
+//   in between is seen twice rather than never (the model dedupes)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include "ClientModel.h"
+
+// ═══════════════════════════════════════════════════════════════
+// ProcessWatch
+// ═══════════════════════════════════════════════════════════════
+class ProcessWatch
+{
+public:
+    ProcessWatch();
+    ~ProcessWatch();
+
+    // ───────────────────────────────────────────────────────────────
+    // Start — subscribe, snapshot, start the backend threads
+    //
+    // Args:
+    //   imageName - process image to watch ("WoW.exe" on Windows, the
+    //               comm name on Linux); matched case-insensitively
+    //
+    // Returns:
+    //   false if no start notification source is available (the model
+    //   stays empty — callers fall back to their own discovery)
+    // ───────────────────────────────────────────────────────────────
+    bool Start(const char* imageName);
+    void Stop();
+
+    bool Running() const { return m_impl != nullptr; }
+
+    // Which notification source is in use ("wmi trace", "netlink", ...)
+    const char* Source() const;
+
+    ClientModel& Model() { return m_model; }
+
+private:
+    ProcessWatch(const ProcessWatch&) = delete;
+    ProcessWatch& operator=(const ProcessWatch&) = delete;
+
+    struct Impl;
+    Impl* m_impl;
+    ClientModel m_model;
+};
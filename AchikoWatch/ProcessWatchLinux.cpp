@@ -0,0 +1,298 @@
+﻿// ProcessWatchLinux.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// ProcessWatch backend for Linux — netlink process connector
+//
+// Subscribes to the kernel's proc connector (exec + exit events for every
+// process), matches exec'd processes by /proc/<pid>/comm and feeds the
+// ClientModel. Lets RemoteAchikoBench drive the same model + diff path
+// Achikobuddy uses, with real processes.
+//
+// Notes:
+//   • Needs CAP_NET_ADMIN (root) — Start() returns false otherwise
+//   • Attach / bootstrap state have no Linux source; they only change
+//     through ClientModel::SetAttach / SetBootstrap
+//   • ENOBUFS (fork storm overran the socket) = events lost → rescan /proc
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "ProcessWatch.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <set>
+#include <string>
+#include <thread>
+
+static const size_t kCommLength = 15;   // TASK_COMM_LEN - 1
+
+struct ProcessWatch::Impl
+{
+    ClientModel* model;
+    std::string image;                   // truncated to kCommLength
+    int socket;
+    int wake[2];                         // self-pipe: Stop() → event thread
+    std::thread thread;
+    std::set<uint32_t> tracked;          // event thread only (after Start)
+
+    bool Matches(uint32_t pid) const;
+    void Track(uint32_t pid);
+    void Rescan();
+    void EventLoop();
+};
+
+// ───────────────────────────────────────────────────────────────
+// Matches — /proc/<pid>/comm equals the watched image name
+// ───────────────────────────────────────────────────────────────
+bool ProcessWatch::Impl::Matches(uint32_t pid) const
+{
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/comm", pid);
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;   // already gone
+
+    char comm[32];
+    const ssize_t n = read(fd, comm, sizeof(comm) - 1);
+    close(fd);
+    if (n <= 0)
+        return false;
+
+    size_t length = (size_t)n;
+    if (comm[length - 1] == '\n')
+        --length;
+    comm[length] = '\0';
+    return strcasecmp(comm, image.c_str()) == 0;
+}
+
+void ProcessWatch::Impl::Track(uint32_t pid)
+{
+    if (model->OnProcessStarted(pid, Attach_None))
+        tracked.insert(pid);
+}
+
+// ───────────────────────────────────────────────────────────────
+// Rescan — snapshot at start, and resync after lost events
+// ───────────────────────────────────────────────────────────────
+void ProcessWatch::Impl::Rescan()
+{
+    for (std::set<uint32_t>::iterator it = tracked.begin(); it != tracked.end();)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "/proc/%u", *it);
+        if (access(path, F_OK) != 0)
+        {
+            model->OnProcessExited(*it);
+            it = tracked.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    DIR* proc = opendir("/proc");
+    if (!proc)
+        return;
+
+    while (dirent* entry = readdir(proc))
+    {
+        char* end = nullptr;
+        const unsigned long pid = strtoul(entry->d_name, &end, 10);
+        if (*end != '\0' || pid == 0)
+            continue;
+        if (Matches((uint32_t)pid))
+            Track((uint32_t)pid);
+    }
+    closedir(proc);
+}
+
+// ───────────────────────────────────────────────────────────────
+// EventLoop — block on the connector socket until Stop()
+// ───────────────────────────────────────────────────────────────
+void ProcessWatch::Impl::EventLoop()
+{
+    alignas(nlmsghdr) char buffer[8192];
+
+    for (;;)
+    {
+        pollfd fds[2] = { { socket, POLLIN, 0 }, { wake[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[1].revents)
+            return;
+
+        const ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+        if (received < 0)
+        {
+            if (errno == ENOBUFS)
+                Rescan();
+            else if (errno != EINTR)
+                return;
+            continue;
+        }
+
+        size_t remaining = (size_t)received;
+        for (nlmsghdr* header = (nlmsghdr*)buffer; NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining))
+        {
+            if (header->nlmsg_type != NLMSG_DONE)
+                continue;
+
+            const cn_msg* message = (const cn_msg*)NLMSG_DATA(header);
+            if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC)
+                continue;
+
+            if (message->len < sizeof(proc_event))
+                continue;
+
+            // cn_msg::data is only 4-byte aligned — read the event from a copy
+            proc_event event;
+            memcpy(&event, message->data, sizeof(event));
+            switch (event.what)
+            {
+            case proc_event::PROC_EVENT_EXEC:
+            {
+                const uint32_t pid = (uint32_t)event.event_data.exec.process_tgid;
+                if (Matches(pid))
+                    Track(pid);
+                break;
+            }
+            case proc_event::PROC_EVENT_EXIT:
+            {
+                // One event per thread — only the leader's exit ends the process
+                const uint32_t pid = (uint32_t)event.event_data.exit.process_tgid;
+                if ((uint32_t)event.event_data.exit.process_pid == pid && tracked.erase(pid))
+                    model->OnProcessExited(pid);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ProcessWatch
+// ═══════════════════════════════════════════════════════════════
+
+ProcessWatch::ProcessWatch() : m_impl(nullptr) {}
+
+ProcessWatch::~ProcessWatch()
+{
+    Stop();
+}
+
+// ───────────────────────────────────────────────────────────────
+// Subscribe — PROC_CN_MCAST_LISTEN on a bound connector socket
+// ───────────────────────────────────────────────────────────────
+static int Subscribe()
+{
+    const int sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock < 0)
+        return -1;
+
+    int bufferBytes = 1 << 20;   // absorb fork storms before ENOBUFS
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+
+    sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0;   // kernel assigns
+    if (bind(sock, (sockaddr*)&address, sizeof(address)) < 0)
+    {
+        close(sock);
+        return -1;
+    }
+
+    // nlmsghdr | cn_msg | op — cn_msg ends in a flexible array, so the
+    // request is laid out by hand
+    alignas(nlmsghdr) char request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(uint32_t))];
+    memset(request, 0, sizeof(request));
+
+    nlmsghdr* header = (nlmsghdr*)request;
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(uint32_t));
+    header->nlmsg_type = NLMSG_DONE;
+
+    cn_msg* message = (cn_msg*)NLMSG_DATA(header);
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(uint32_t);
+
+    const uint32_t op = PROC_CN_MCAST_LISTEN;
+    memcpy(message->data, &op, sizeof(op));
+
+    if (send(sock, request, header->nlmsg_len, 0) != (ssize_t)header->nlmsg_len)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+bool ProcessWatch::Start(const char* imageName)
+{
+    if (m_impl)
+        return true;
+
+    const int sock = Subscribe();
+    if (sock < 0)
+        return false;
+
+    Impl* impl = new Impl();
+    impl->model = &m_model;
+    impl->image = std::string(imageName ? imageName : "").substr(0, kCommLength);
+    impl->socket = sock;
+    if (pipe2(impl->wake, O_CLOEXEC) != 0)
+    {
+        close(sock);
+        delete impl;
+        return false;
+    }
+
+    m_model.Reset();
+    impl->Rescan();   // after subscribing — see header
+    impl->thread = std::thread(&Impl::EventLoop, impl);
+    m_impl = impl;
+    return true;
+}
+
+void ProcessWatch::Stop()
+{
+    if (!m_impl)
+        return;
+
+    const char stop = 1;
+    if (write(m_impl->wake[1], &stop, 1) != 1)
+        shutdown(m_impl->socket, SHUT_RDWR);
+    m_impl->thread.join();
+
+    close(m_impl->socket);
+    close(m_impl->wake[0]);
+    close(m_impl->wake[1]);
+    delete m_impl;
+    m_impl = nullptr;
+
+    m_model.Stop();
+}
+
+const char* ProcessWatch::Source() const
+{
+    return m_impl ? "netlink" : "none";
+}
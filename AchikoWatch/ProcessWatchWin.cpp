@@ -0,0 +1,432 @@
+﻿// ProcessWatchWin.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// ProcessWatch backend for Windows — WMI start events + kernel waits
+//
+// Responsibilities:
+// • Starts: WMI Win32_ProcessStartTrace (kernel process-start events,
+//   needs elevation — Achikobuddy runs elevated to inject anyway);
+//   unelevated fallback is __InstanceCreationEvent WITHIN 1, which WMI
+//   evaluates in its own service, not in our process
+// • Exits: RegisterWaitForSingleObject on a SYNCHRONIZE handle per client
+// • Bootstrap stages: create the per-PID stage events (BootstrapStage.h)
+//   and wait on them the same way
+// • Attach state: probe "AchikobuddyBot_PID_<pid>" once when a client is
+//   first seen; later changes come from the UI (AchikoWatchSetAttach)
+//
+// Architecture:
+// • Event thread: owns COM + the WMI enumerator, blocks in Next() and
+//   tracks every new PID; also frees the bookkeeping of exited clients
+// • Thread-pool wait callbacks only touch the ClientModel — never the
+//   tracked table's handles — so cleanup never races a callback
+//
+// Critical Design Decisions:
+// • Stage events are manual-reset and kept open for the life of the
+//   client: a stage signalled before we registered the wait is not lost,
+//   and a restarted Achikobuddy re-opens the still-signalled events
+// • Waits are unregistered with INVALID_HANDLE_VALUE (blocking) from the
+//   event thread only — never from inside a wait callback
+// ─────────────────────────────────────────────────────────────────────────────
+
+#define _WIN32_DCOM
+#include "ProcessWatch.h"
+
+#include <Windows.h>
+#include <TlHelp32.h>
+#include <Wbemidl.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma comment(lib, "wbemuuid.lib")
+
+static const long kWmiNextTimeoutMs = 500;   // stop-check period of the event thread
+
+struct TrackedClient;
+
+struct StageWait
+{
+    TrackedClient* owner;
+    uint32_t stage;
+    HANDLE event;
+    HANDLE wait;
+};
+
+struct TrackedClient
+{
+    ClientModel* model;
+    struct WatchImpl* impl;
+    uint32_t pid;
+    HANDLE process;
+    HANDLE exitWait;
+    StageWait stages[Bootstrap_Count];   // [0] unused (Bootstrap_None)
+};
+
+struct WatchImpl
+{
+    ClientModel* model;
+    wchar_t image[MAX_PATH];
+    const char* source;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    HANDLE ready;                                 // event thread → Start()
+    bool subscribed;
+
+    std::mutex lock;                              // tracked + exited
+    std::map<uint32_t, TrackedClient*> tracked;
+    std::vector<TrackedClient*> exited;           // freed by the event thread
+};
+
+struct ProcessWatch::Impl : WatchImpl {};
+
+// ═══════════════════════════════════════════════════════════════
+// WAIT CALLBACKS (thread pool)
+// ═══════════════════════════════════════════════════════════════
+
+static VOID CALLBACK OnStageSignalled(PVOID context, BOOLEAN)
+{
+    StageWait* stage = (StageWait*)context;
+    stage->owner->model->SetBootstrap(stage->owner->pid, stage->stage);
+}
+
+static VOID CALLBACK OnProcessExit(PVOID context, BOOLEAN)
+{
+    TrackedClient* client = (TrackedClient*)context;
+    client->model->OnProcessExited(client->pid);
+
+    WatchImpl* impl = client->impl;
+    std::lock_guard<std::mutex> guard(impl->lock);
+    impl->tracked.erase(client->pid);
+    impl->exited.push_back(client);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// TRACKING
+// ═══════════════════════════════════════════════════════════════
+
+static void Untrack(TrackedClient* client)
+{
+    for (uint32_t s = Bootstrap_Injected; s < Bootstrap_Count; ++s)
+    {
+        if (client->stages[s].wait)
+            UnregisterWaitEx(client->stages[s].wait, INVALID_HANDLE_VALUE);
+        if (client->stages[s].event)
+            CloseHandle(client->stages[s].event);
+    }
+    if (client->exitWait)
+        UnregisterWaitEx(client->exitWait, INVALID_HANDLE_VALUE);
+    CloseHandle(client->process);
+    delete client;
+}
+
+static void FreeExited(WatchImpl* impl)
+{
+    std::vector<TrackedClient*> done;
+    {
+        std::lock_guard<std::mutex> guard(impl->lock);
+        done.swap(impl->exited);
+    }
+    for (size_t i = 0; i < done.size(); ++i)
+        Untrack(done[i]);
+}
+
+static uint32_t ProbeAttach(uint32_t pid)
+{
+    wchar_t name[64];
+    swprintf_s(name, L"AchikobuddyBot_PID_%lu", (unsigned long)pid);
+
+    HANDLE mutex = OpenMutexW(SYNCHRONIZE, FALSE, name);
+    if (!mutex)
+        return Attach_None;
+    CloseHandle(mutex);
+    return Attach_Attached;
+}
+
+// ───────────────────────────────────────────────────────────────
+// Track — first sighting of a watched PID
+// ───────────────────────────────────────────────────────────────
+static void Track(WatchImpl* impl, uint32_t pid)
+{
+    {
+        std::lock_guard<std::mutex> guard(impl->lock);
+        if (impl->tracked.count(pid))
+            return;
+    }
+
+    HANDLE process = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!process)
+        return;   // already gone
+
+    TrackedClient* client = new TrackedClient();
+    client->model = impl->model;
+    client->impl = impl;
+    client->pid = pid;
+    client->process = process;
+    client->exitWait = nullptr;
+
+    for (uint32_t s = 0; s < Bootstrap_Count; ++s)
+    {
+        client->stages[s].owner = client;
+        client->stages[s].stage = s;
+        client->stages[s].event = nullptr;
+        client->stages[s].wait = nullptr;
+    }
+
+    if (!impl->model->OnProcessStarted(pid, ProbeAttach(pid)))
+    {
+        CloseHandle(process);
+        delete client;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(impl->lock);
+        impl->tracked[pid] = client;
+    }
+
+    for (uint32_t s = Bootstrap_Injected; s < Bootstrap_Count; ++s)
+    {
+        wchar_t name[64];
+        swprintf_s(name, ACHIKO_BOOTSTRAP_EVENT_FORMAT, (unsigned long)pid, s);
+
+        StageWait& stage = client->stages[s];
+        stage.event = CreateEventW(NULL, TRUE, FALSE, name);
+        if (stage.event)
+            RegisterWaitForSingleObject(&stage.wait, stage.event, OnStageSignalled, &stage,
+                INFINITE, WT_EXECUTEONLYONCE);
+    }
+
+    // Last — the exit callback hands the client to FreeExited
+    RegisterWaitForSingleObject(&client->exitWait, process, OnProcessExit, client,
+        INFINITE, WT_EXECUTEONLYONCE);
+}
+
+static void Snapshot(WatchImpl* impl)
+{
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+        return;
+
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+    for (BOOL ok = Process32FirstW(snapshot, &entry); ok; ok = Process32NextW(snapshot, &entry))
+    {
+        if (_wcsicmp(entry.szExeFile, impl->image) == 0)
+            Track(impl, entry.th32ProcessID);
+    }
+    CloseHandle(snapshot);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// WMI EVENT THREAD
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// EventPid — PID out of either query's event object
+// ───────────────────────────────────────────────────────────────
+static uint32_t EventPid(IWbemClassObject* event, bool startTrace)
+{
+    uint32_t pid = 0;
+    VARIANT value;
+    VariantInit(&value);
+
+    if (startTrace)
+    {
+        if (SUCCEEDED(event->Get(L"ProcessID", 0, &value, NULL, NULL)))
+            pid = value.vt == VT_I4 ? (uint32_t)value.lVal : value.vt == VT_UI4 ? value.ulVal : 0;
+        VariantClear(&value);
+        return pid;
+    }
+
+    if (SUCCEEDED(event->Get(L"TargetInstance", 0, &value, NULL, NULL)) && value.vt == VT_UNKNOWN && value.punkVal)
+    {
+        IWbemClassObject* instance = nullptr;
+        if (SUCCEEDED(value.punkVal->QueryInterface(IID_IWbemClassObject, (void**)&instance)))
+        {
+            VARIANT id;
+            VariantInit(&id);
+            if (SUCCEEDED(instance->Get(L"ProcessId", 0, &id, NULL, NULL)))
+                pid = id.vt == VT_I4 ? (uint32_t)id.lVal : id.vt == VT_UI4 ? id.ulVal : 0;
+            VariantClear(&id);
+            instance->Release();
+        }
+    }
+    VariantClear(&value);
+    return pid;
+}
+
+static IEnumWbemClassObject* Subscribe(IWbemServices* services, const wchar_t* image, bool startTrace)
+{
+    wchar_t query[512];
+    if (startTrace)
+        swprintf_s(query, L"SELECT ProcessID FROM Win32_ProcessStartTrace WHERE ProcessName = '%s'", image);
+    else
+        swprintf_s(query, L"SELECT * FROM __InstanceCreationEvent WITHIN 1 WHERE "
+            L"TargetInstance ISA 'Win32_Process' AND TargetInstance.Name = '%s'", image);
+
+    BSTR language = SysAllocString(L"WQL");
+    BSTR text = SysAllocString(query);
+    IEnumWbemClassObject* events = nullptr;
+    const HRESULT hr = services->ExecNotificationQuery(language, text,
+        WBEM_FLAG_RETURN_IMMEDIATELY | WBEM_FLAG_FORWARD_ONLY, NULL, &events);
+    SysFreeString(text);
+    SysFreeString(language);
+    return SUCCEEDED(hr) ? events : nullptr;
+}
+
+static void EventThread(WatchImpl* impl)
+{
+    const HRESULT init = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+    const HRESULT security = CoInitializeSecurity(NULL, -1, NULL, NULL, RPC_C_AUTHN_LEVEL_DEFAULT,
+        RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE, NULL);
+    (void)security;   // RPC_E_TOO_LATE: the host already chose — fine for WMI
+
+    IWbemLocator* locator = nullptr;
+    IWbemServices* services = nullptr;
+    IEnumWbemClassObject* events = nullptr;
+    bool startTrace = true;
+
+    if (SUCCEEDED(CoCreateInstance(CLSID_WbemLocator, NULL, CLSCTX_INPROC_SERVER, IID_IWbemLocator, (void**)&locator)))
+    {
+        BSTR ns = SysAllocString(L"ROOT\\CIMV2");
+        if (SUCCEEDED(locator->ConnectServer(ns, NULL, NULL, NULL, 0, NULL, NULL, &services)))
+        {
+            CoSetProxyBlanket(services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL, RPC_C_AUTHN_LEVEL_CALL,
+                RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
+
+            events = Subscribe(services, impl->image, true);
+            if (!events)
+            {
+                startTrace = false;   // not elevated — no kernel trace
+                events = Subscribe(services, impl->image, false);
+            }
+        }
+        SysFreeString(ns);
+    }
+
+    impl->subscribed = events != nullptr;
+    impl->source = !events ? "none" : startTrace ? "wmi trace" : "wmi instance";
+    SetEvent(impl->ready);
+
+    while (events && impl->running.load(std::memory_order_acquire))
+    {
+        IWbemClassObject* event = nullptr;
+        ULONG returned = 0;
+        const HRESULT hr = events->Next(kWmiNextTimeoutMs, 1, &event, &returned);
+
+        FreeExited(impl);   // before Track — a reused PID must not meet its old events
+        if (hr == WBEM_S_TIMEDOUT)
+            continue;
+        if (FAILED(hr))
+            break;        // WMI service gone — exits/stages keep working
+        if (returned == 0)
+            continue;
+
+        const uint32_t pid = EventPid(event, startTrace);
+        event->Release();
+        if (pid != 0)
+            Track(impl, pid);
+    }
+
+    if (events) events->Release();
+    if (services) services->Release();
+    if (locator) locator->Release();
+    if (SUCCEEDED(init))
+        CoUninitialize();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ProcessWatch
+// ═══════════════════════════════════════════════════════════════
+
+ProcessWatch::ProcessWatch() : m_impl(nullptr) {}
+
+ProcessWatch::~ProcessWatch()
+{
+    Stop();
+}
+
+bool ProcessWatch::Start(const char* imageName)
+{
+    if (m_impl)
+        return true;
+
+    Impl* impl = new Impl();
+    impl->model = &m_model;
+    impl->source = "none";
+    impl->subscribed = false;
+    impl->running.store(true, std::memory_order_relaxed);
+    impl->ready = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (!impl->ready || !MultiByteToWideChar(CP_UTF8, 0, imageName ? imageName : "", -1, impl->image, MAX_PATH))
+    {
+        if (impl->ready) CloseHandle(impl->ready);
+        delete impl;
+        return false;
+    }
+
+    m_model.Reset();
+    impl->thread = std::thread(EventThread, impl);
+    WaitForSingleObject(impl->ready, INFINITE);
+
+    if (!impl->subscribed)
+    {
+        impl->thread.join();
+        CloseHandle(impl->ready);
+        delete impl;
+        return false;
+    }
+
+    Snapshot(impl);   // after subscribing — see header
+    m_impl = impl;
+    return true;
+}
+
+void ProcessWatch::Stop()
+{
+    if (!m_impl)
+        return;
+
+    m_impl->running.store(false, std::memory_order_release);
+    m_impl->thread.join();
+
+    std::vector<TrackedClient*> live;
+    {
+        std::lock_guard<std::mutex> guard(m_impl->lock);
+        for (std::map<uint32_t, TrackedClient*>::iterator it = m_impl->tracked.begin(); it != m_impl->tracked.end(); ++it)
+            live.push_back(it->second);
+        m_impl->tracked.clear();
+    }
+    // After this no exit callback can run; one that already ran left its
+    // client in BOTH lists (it erased the map entry after our copy)
+    for (size_t i = 0; i < live.size(); ++i)
+    {
+        UnregisterWaitEx(live[i]->exitWait, INVALID_HANDLE_VALUE);
+        live[i]->exitWait = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> guard(m_impl->lock);
+        for (size_t i = 0; i < m_impl->exited.size(); ++i)
+        {
+            if (std::find(live.begin(), live.end(), m_impl->exited[i]) == live.end())
+                live.push_back(m_impl->exited[i]);
+        }
+        m_impl->exited.clear();
+    }
+    for (size_t i = 0; i < live.size(); ++i)
+        Untrack(live[i]);
+
+    CloseHandle(m_impl->ready);
+    delete m_impl;
+    m_impl = nullptr;
+
+    m_model.Stop();
+}
+
+const char* ProcessWatch::Source() const
+{
+    return m_impl ? m_impl->source : "none";
+}
@@ -0,0 +1,413 @@
+﻿// AttachOrchestrator.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Attach RemoteAchiko.dll to many WoW clients at once, off the UI thread
+//
+// Responsibilities:
+// • Inject a set of PIDs with bounded parallelism (MaxParallel workers)
+// • Follow each client through the bootstrap stages (BootstrapStage.h):
+//     Injecting → Injected → ClrUp → ManagedReady → Ready (pipes connected)
+//   with a timeout per stage
+// • Retry failed injections with back-off (MaxAttempts)
+// • Report time-to-all-ready plus a per-client, per-stage breakdown
+//
+// Architecture:
+// • Worker threads pull PIDs from a shared queue; each one blocks in
+//   WaitHandle.WaitAny on { next stage event, Failed event, process
+//   exit, cancel } — no polling, no pipe parsing
+// • Stage events are the same per-PID named events AchikoWatch creates;
+//   creating them here too means the orchestrator works with or without
+//   the native watcher, and whoever is first makes them
+// • ClientUpdated / Completed are raised on the Dispatcher thread
+//
+// Critical Design Decisions:
+// • Only injection is retried: once LoadLibraryA succeeded, DllMain has
+//   run and a second injection cannot restart the bootstrap — a later
+//   stage that times out ends the client as TimedOut
+// • Stage events are manual-reset, so a stage signalled before the wait
+//   starts is still seen; timestamps are then "when we noticed"
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Text;
+using System.Threading;
+using System.Windows.Threading;
+using Achikobuddy.Debug;
+
+namespace Achikobuddy.Core
+{
+    public enum AttachState
+    {
+        Queued,
+        Injecting,
+        Injected,
+        ClrUp,
+        ManagedReady,
+        Ready,          // pipes connected — bot is live
+        Failed,
+        TimedOut,
+        Cancelled
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ClientAttach — progress of one client (copies go to the UI)
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class ClientAttach
+    {
+        public int Pid;
+        public AttachState State;
+        public int Attempts;
+        public string Error;
+
+        // Milliseconds since the orchestrator started; -1 = not reached.
+        // StageMs is indexed by BootstrapStage (Injected..PipesConnected).
+        public long StartedMs = -1;
+        public readonly long[] StageMs = { -1, -1, -1, -1, -1 };
+        public long FinishedMs = -1;
+
+        public bool Done => State >= AttachState.Ready;
+
+        // Injection never succeeded — nothing of ours runs in the client
+        public bool NeverInjected => StageMs[(int)BootstrapStage.Injected] < 0;
+
+        internal ClientAttach Clone()
+        {
+            var copy = (ClientAttach)MemberwiseClone();
+            Array.Copy(StageMs, copy.StageMs, StageMs.Length);
+            return copy;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // AttachReport — result of one orchestrated attach
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class AttachReport
+    {
+        public IList<ClientAttach> Clients;
+        public long TotalMs;
+        public int ReadyCount;
+
+        public bool AllReady => ReadyCount == Clients.Count;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // AttachOrchestrator
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class AttachOrchestrator : IDisposable
+    {
+        // ───────────────────────────────────────────────────────────────
+        // Limits — per-stage timeouts are measured from the previous stage
+        // ───────────────────────────────────────────────────────────────
+        public int MaxParallel { get; set; } = 4;
+        public int MaxAttempts { get; set; } = 3;
+
+        private const int InjectTimeoutMs = 5000;        // LoadLibraryA incl. DllMain
+        private const int RetryBackoffMs = 500;          // × attempt number
+        private static readonly int[] StageTimeoutMs =
+        {
+            0,
+            5000,       // Injected       — bootstrap thread started
+            15000,      // ClrUp          — CLR started (+ allocation profiler)
+            30000,      // ManagedReady   — AchikoDLL loaded, Loader.Start() done
+            10000       // PipesConnected — log + command pipe connected
+        };
+
+        private readonly Dispatcher _dispatcher;
+        private readonly string _dllPath;
+        private readonly ManualResetEvent _cancel = new ManualResetEvent(false);
+        private readonly Stopwatch _clock = new Stopwatch();
+        private ConcurrentQueue<ClientAttach> _queue;
+        private List<ClientAttach> _clients;
+        private int _workersLeft;
+
+        // Raised on the dispatcher thread with a snapshot of the client
+        public event Action<ClientAttach> ClientUpdated;
+
+        // Raised on the dispatcher thread once every client is done
+        public event Action<AttachReport> Completed;
+
+        public bool Busy => Volatile.Read(ref _workersLeft) > 0;
+
+        public AttachOrchestrator(Dispatcher dispatcher, string dllPath)
+        {
+            _dispatcher = dispatcher;
+            _dllPath = dllPath;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — attach to every PID, MaxParallel at a time
+        //
+        // Returns:
+        //   false if an attach is still running or pids is empty
+        // ───────────────────────────────────────────────────────────────
+        public bool Start(IList<int> pids)
+        {
+            if (Busy || pids.Count == 0)
+                return false;
+
+            _cancel.Reset();
+            _clients = new List<ClientAttach>(pids.Count);
+            _queue = new ConcurrentQueue<ClientAttach>();
+            foreach (int pid in pids)
+            {
+                var client = new ClientAttach { Pid = pid, State = AttachState.Queued };
+                _clients.Add(client);
+                _queue.Enqueue(client);
+            }
+
+            int workers = Math.Max(1, Math.Min(MaxParallel, pids.Count));
+            _workersLeft = workers;
+            _clock.Restart();
+
+            Bugger.Instance.Log($"[Attach] Attaching {pids.Count} client(s), {workers} at a time");
+
+            for (int i = 0; i < workers; i++)
+            {
+                new Thread(WorkerLoop) { Name = "Achikobuddy attach " + i, IsBackground = true }.Start();
+            }
+            return true;
+        }
+
+        // Abandon every wait; clients still in flight end as Cancelled
+        public void Cancel()
+        {
+            _cancel.Set();
+        }
+
+        public void Dispose()
+        {
+            Cancel();
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // WORKERS
+        // ═══════════════════════════════════════════════════════════════
+
+        private void WorkerLoop()
+        {
+            ClientAttach client;
+            while (_queue.TryDequeue(out client))
+            {
+                try
+                {
+                    Attach(client);
+                }
+                catch (Exception ex)
+                {
+                    Finish(client, AttachState.Failed, ex.Message);
+                }
+            }
+
+            if (Interlocked.Decrement(ref _workersLeft) == 0)
+                Report();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Attach — inject (with retries), then walk the stage events
+        // ───────────────────────────────────────────────────────────────
+        private void Attach(ClientAttach client)
+        {
+            client.StartedMs = _clock.ElapsedMilliseconds;
+
+            Process process;
+            try
+            {
+                process = Process.GetProcessById(client.Pid);
+            }
+            catch (ArgumentException)
+            {
+                Finish(client, AttachState.Failed, "process not running");
+                return;
+            }
+
+            // Index = BootstrapStage; [0] unused
+            var stages = new EventWaitHandle[(int)BootstrapStage.Failed + 1];
+            ManualResetEvent exited = null;
+            try
+            {
+                for (int s = (int)BootstrapStage.Injected; s <= (int)BootstrapStage.Failed; s++)
+                {
+                    stages[s] = new EventWaitHandle(false, EventResetMode.ManualReset,
+                        $"AchikoBootstrap_PID_{client.Pid}_{s}");
+                }
+
+                // Process.Handle is owned by process — wrap, don't take ownership
+                exited = new ManualResetEvent(false)
+                {
+                    SafeWaitHandle = new Microsoft.Win32.SafeHandles.SafeWaitHandle(process.Handle, false)
+                };
+
+                if (!Inject(client, exited))
+                    return;
+
+                for (int s = (int)BootstrapStage.Injected; s <= (int)BootstrapStage.PipesConnected; s++)
+                {
+                    var stage = (BootstrapStage)s;
+                    int hit = WaitHandle.WaitAny(
+                        new WaitHandle[] { stages[s], stages[(int)BootstrapStage.Failed], exited, _cancel },
+                        StageTimeoutMs[s]);
+
+                    switch (hit)
+                    {
+                        case 0:
+                            client.StageMs[s] = _clock.ElapsedMilliseconds;
+                            client.State = StateAfter(stage);
+                            if (client.State == AttachState.Ready)
+                                Finish(client, AttachState.Ready, null);
+                            else
+                                Publish(client);
+                            break;
+                        case 1:
+                            Finish(client, AttachState.Failed, $"bootstrap failed before {stage} — see log");
+                            return;
+                        case 2:
+                            Finish(client, AttachState.Failed, $"process exited before {stage}");
+                            return;
+                        case 3:
+                            Finish(client, AttachState.Cancelled, null);
+                            return;
+                        default:
+                            Finish(client, AttachState.TimedOut, $"no {stage} within {StageTimeoutMs[s]} ms");
+                            return;
+                    }
+                }
+            }
+            finally
+            {
+                exited?.Dispose();
+                foreach (EventWaitHandle stage in stages)
+                    stage?.Dispose();
+                process.Dispose();
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Inject — up to MaxAttempts LoadLibraryA attempts
+        //
+        // Returns:
+        //   true once the module is loaded; false after Finish()
+        // ───────────────────────────────────────────────────────────────
+        private bool Inject(ClientAttach client, WaitHandle exited)
+        {
+            for (int attempt = 1; ; attempt++)
+            {
+                client.Attempts = attempt;
+                client.State = AttachState.Injecting;
+                Publish(client);
+
+                string error;
+                if (Injector.Inject(client.Pid, _dllPath, InjectTimeoutMs, out error))
+                    return true;
+
+                Bugger.Instance.Log($"[Attach] PID {client.Pid} injection attempt {attempt} failed: {error}");
+
+                if (attempt >= MaxAttempts)
+                {
+                    Finish(client, AttachState.Failed, error);
+                    return false;
+                }
+
+                // Back-off doubles as the exit / cancel check
+                switch (WaitHandle.WaitAny(new[] { exited, _cancel }, RetryBackoffMs * attempt))
+                {
+                    case 0:
+                        Finish(client, AttachState.Failed, "process exited during injection");
+                        return false;
+                    case 1:
+                        Finish(client, AttachState.Cancelled, null);
+                        return false;
+                }
+            }
+        }
+
+        private static AttachState StateAfter(BootstrapStage stage)
+        {
+            switch (stage)
+            {
+                case BootstrapStage.Injected: return AttachState.Injected;
+                case BootstrapStage.ClrUp: return AttachState.ClrUp;
+                case BootstrapStage.ManagedReady: return AttachState.ManagedReady;
+                default: return AttachState.Ready;
+            }
+        }
+
+        private void Finish(ClientAttach client, AttachState state, string error)
+        {
+            client.State = state;
+            client.Error = error;
+            client.FinishedMs = _clock.ElapsedMilliseconds;
+            Publish(client);
+        }
+
+        private void Publish(ClientAttach client)
+        {
+            ClientAttach snapshot = client.Clone();
+            _dispatcher.BeginInvoke(new Action(() => ClientUpdated?.Invoke(snapshot)));
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // REPORT
+        // ═══════════════════════════════════════════════════════════════
+
+        // ───────────────────────────────────────────────────────────────
+        // Report — last worker out; every ClientAttach is final here
+        //
+        // Log format:
+        //   [Attach] 3/3 ready in 4210 ms (4 parallel)
+        //   [Attach]   PID 1234 Ready     x1  wait 0 | inject 180 | clr +220 | ...
+        // ───────────────────────────────────────────────────────────────
+        private void Report()
+        {
+            var report = new AttachReport
+            {
+                Clients = _clients.ConvertAll(c => c.Clone()),
+                TotalMs = _clock.ElapsedMilliseconds
+            };
+            foreach (ClientAttach client in report.Clients)
+            {
+                if (client.State == AttachState.Ready)
+                    report.ReadyCount++;
+            }
+
+            Bugger.Instance.Log(report.AllReady
+                ? $"[Attach] {report.ReadyCount}/{report.Clients.Count} ready — all ready in {report.TotalMs} ms ({MaxParallel} parallel)"
+                : $"[Attach] {report.ReadyCount}/{report.Clients.Count} ready after {report.TotalMs} ms ({MaxParallel} parallel)");
+            foreach (ClientAttach client in report.Clients)
+                Bugger.Instance.Log("[Attach]   " + Describe(client));
+
+            _dispatcher.BeginInvoke(new Action(() => Completed?.Invoke(report)));
+        }
+
+        private static readonly string[] StageLabels = { null, "inject", "clr", "managed", "pipes" };
+
+        private static string Describe(ClientAttach client)
+        {
+            var line = new StringBuilder();
+            line.Append($"PID {client.Pid,-6} {client.State,-9} x{client.Attempts}  wait {Math.Max(0, client.StartedMs)}");
+
+            // Injected is measured from the worker picking the client up,
+            // every later stage from the one before it
+            long previous = client.StartedMs;
+            for (int s = (int)BootstrapStage.Injected; s <= (int)BootstrapStage.PipesConnected; s++)
+            {
+                if (client.StageMs[s] < 0) break;
+                line.Append(s == (int)BootstrapStage.Injected ? " | " : " | +")
+                    .Append(StageLabels[s]).Append(' ').Append(client.StageMs[s] - previous);
+                previous = client.StageMs[s];
+            }
+
+            if (client.StartedMs >= 0 && client.FinishedMs >= 0)
+                line.Append($" | total {client.FinishedMs - client.StartedMs} ms");
+            if (client.Error != null)
+                line.Append(" — ").Append(client.Error);
+            return line.ToString();
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
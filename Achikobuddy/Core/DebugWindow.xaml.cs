@@ -10,6 +10,7 @@
 // • Thread-safe cache and event handling
 // • Singleton pattern with safe ShowWindow() activation
 // • Clear logs button now clears Bugger storage for all tabs
+// • Open Log button hands saved logs to LogFileWindow (memory-mapped)
 // • Full cleanup on close — no leaks, no ghost subscriptions
 // • 100% .NET 4.0 / C# 7.3 compatible
 // ─────────────────────────────────────────────────────────────────────────────
@@ -265,6 +266,26 @@ namespace Achikobuddy.Core
             Achikobuddy.Debug.Bugger.Instance.Log("[DebugWindow] User cleared all logs");
         }
 
+        // ───────────────────────────────────────────────────────────────
+        // Open log button — pick a saved log, view it memory-mapped
+        //
+        // • Never loads the file into this window's TextBox
+        // • Defaults to the session log next to the executable
+        // ───────────────────────────────────────────────────────────────
+        private void OpenLogButton_Click(object sender, RoutedEventArgs e)
+        {
+            var dialog = new Microsoft.Win32.OpenFileDialog
+            {
+                Title = "Open Achikobuddy log",
+                Filter = "Log files (*.log)|*.log|All files (*.*)|*.*",
+                InitialDirectory = AppDomain.CurrentDomain.BaseDirectory,
+                FileName = "Achikobuddy.log"
+            };
+
+            if (dialog.ShowDialog(this) == true)
+                LogFileWindow.ShowFile(dialog.FileName);
+        }
+
         // ───────────────────────────────────────────────────────────────
         // Cleanup on close — unsubscribe from events
         // ───────────────────────────────────────────────────────────────
@@ -0,0 +1,157 @@
+﻿// Injector.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// LoadLibraryA injection of RemoteAchiko.dll into a WoW process
+//
+// Responsibilities:
+// • Write the DLL path into the target, run LoadLibraryA on a remote thread
+// • Wait for that thread and report whether the module actually loaded
+// • Free the remote path buffer and close every handle — zero leaks
+//
+// Architecture:
+// • Used by AttachOrchestrator on its worker threads — never on the UI
+//   thread, the remote LoadLibraryA runs RemoteAchiko's DllMain
+//
+// Critical Design Decisions:
+// • Success = remote thread exit code (the HMODULE) is non-zero; a failed
+//   LoadLibraryA is retryable, a bootstrap that started is not (DllMain
+//   runs once per process)
+// • 100% .NET 4.0 / C# 7.3 compatible — no modern syntax
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Achikobuddy.Core
+{
+    // ═══════════════════════════════════════════════════════════════
+    // Injector — manual DLL injection (LoadLibraryA)
+    // ═══════════════════════════════════════════════════════════════
+    internal static class Injector
+    {
+        private const int ProcessAllAccess = 0x1F0FFF;
+        private const uint MemCommitReserve = 0x3000;
+        private const uint MemRelease = 0x8000;
+        private const uint PageReadWrite = 0x04;
+        private const uint WaitObject0 = 0;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr OpenProcess(int dwDesiredAccess, bool bInheritHandle, int dwProcessId);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr VirtualAllocEx(IntPtr hProcess, IntPtr lpAddress, uint dwSize,
+            uint flAllocationType, uint flProtect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool VirtualFreeEx(IntPtr hProcess, IntPtr lpAddress, uint dwSize, uint dwFreeType);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool WriteProcessMemory(IntPtr hProcess, IntPtr lpBaseAddress, byte[] lpBuffer,
+            uint nSize, out IntPtr lpNumberOfBytesWritten);
+
+        [DllImport("kernel32.dll", CharSet = CharSet.Ansi)]
+        private static extern IntPtr GetProcAddress(IntPtr hModule, string procName);
+
+        [DllImport("kernel32.dll", CharSet = CharSet.Auto)]
+        private static extern IntPtr GetModuleHandle(string lpModuleName);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern IntPtr CreateRemoteThread(IntPtr hProcess, IntPtr lpThreadAttributes, uint dwStackSize,
+            IntPtr lpStartAddress, IntPtr lpParameter, uint dwCreationFlags, IntPtr lpThreadId);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern uint WaitForSingleObject(IntPtr hHandle, uint dwMilliseconds);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetExitCodeThread(IntPtr hThread, out uint lpExitCode);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool CloseHandle(IntPtr hObject);
+
+        // ───────────────────────────────────────────────────────────────
+        // Inject — load dllPath into pid and wait for LoadLibraryA
+        //
+        // Args:
+        //   timeoutMs - how long LoadLibraryA (incl. DllMain) may take
+        //   error     - [out] reason on failure, null on success
+        //
+        // Returns:
+        //   true if the module is loaded in the target
+        // ───────────────────────────────────────────────────────────────
+        public static bool Inject(int pid, string dllPath, int timeoutMs, out string error)
+        {
+            error = null;
+
+            IntPtr hProcess = OpenProcess(ProcessAllAccess, false, pid);
+            if (hProcess == IntPtr.Zero)
+            {
+                error = $"OpenProcess failed — GLE: {Marshal.GetLastWin32Error()}";
+                return false;
+            }
+
+            IntPtr remoteMem = IntPtr.Zero;
+            IntPtr thread = IntPtr.Zero;
+            bool freeRemote = true;
+            try
+            {
+                byte[] pathBytes = Encoding.ASCII.GetBytes(dllPath + "\0");
+
+                remoteMem = VirtualAllocEx(hProcess, IntPtr.Zero, (uint)pathBytes.Length, MemCommitReserve, PageReadWrite);
+                if (remoteMem == IntPtr.Zero)
+                {
+                    error = $"VirtualAllocEx failed — GLE: {Marshal.GetLastWin32Error()}";
+                    return false;
+                }
+
+                if (!WriteProcessMemory(hProcess, remoteMem, pathBytes, (uint)pathBytes.Length, out _))
+                {
+                    error = $"WriteProcessMemory failed — GLE: {Marshal.GetLastWin32Error()}";
+                    return false;
+                }
+
+                IntPtr loadLib = GetProcAddress(GetModuleHandle("kernel32.dll"), "LoadLibraryA");
+                if (loadLib == IntPtr.Zero)
+                {
+                    error = "LoadLibraryA not found";
+                    return false;
+                }
+
+                thread = CreateRemoteThread(hProcess, IntPtr.Zero, 0, loadLib, remoteMem, 0, IntPtr.Zero);
+                if (thread == IntPtr.Zero)
+                {
+                    error = $"CreateRemoteThread failed — GLE: {Marshal.GetLastWin32Error()}";
+                    return false;
+                }
+
+                if (WaitForSingleObject(thread, (uint)timeoutMs) != WaitObject0)
+                {
+                    // Still reading the path — leave the buffer to the target
+                    freeRemote = false;
+                    error = $"LoadLibraryA did not return within {timeoutMs} ms";
+                    return false;
+                }
+
+                uint module;
+                if (!GetExitCodeThread(thread, out module) || module == 0)
+                {
+                    error = "LoadLibraryA failed in the target (RemoteAchiko.dll or a dependency missing?)";
+                    return false;
+                }
+
+                return true;
+            }
+            finally
+            {
+                if (thread != IntPtr.Zero)
+                    CloseHandle(thread);
+                if (remoteMem != IntPtr.Zero && freeRemote)
+                    VirtualFreeEx(hProcess, remoteMem, 0, MemRelease);
+                CloseHandle(hProcess);
+            }
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
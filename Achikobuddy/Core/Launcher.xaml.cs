@@ -3,24 +3,26 @@
 // Launcher window — discovers running WoW instances and injects RemoteAchiko.dll
 //
 // Responsibilities:
-// • Real-time WoW process detection with 1-second refresh
-// • Visual [BOT ATTACHED] indicator using global mutex
+// • Live WoW process list from ProcessWatcher diffs — start/exit
+//   notifications, no polling on the UI thread
+// • Visual [BOT ATTACHED] indicator (global mutex) and bootstrap stage
+// • LAUNCH (selected client) / LAUNCH ALL (every unattached client) —
+//   both hand the PIDs to AttachOrchestrator, so injection and the
+//   bootstrap wait never block the UI thread
 // • 100% protection against double injection
-// • Safe process handle cleanup — zero leaks
+// • Optional allocation profiler: a named per-PID event tells
+//   RemoteAchiko.dll to attach the CLR profiler before starting .NET
 // • Clean, professional error handling and user feedback
 // • 100% .NET 4.0 / C# 7.3 compatible — no modern syntax
 // ─────────────────────────────────────────────────────────────────────────────
 
 using System;
-using System.Diagnostics;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
 using System.IO;
-using System.Linq;
-using System.Runtime.InteropServices;
 using System.Text;
-using System.Text.RegularExpressions;
 using System.Threading;
 using System.Windows;
-using System.Windows.Threading;
 using Achikobuddy.Debug;
 
 namespace Achikobuddy.Core
@@ -33,35 +35,15 @@ namespace Achikobuddy.Core
         // ───────────────────────────────────────────────────────────────
         // Private fields
         // ───────────────────────────────────────────────────────────────
-        private DispatcherTimer _updateTimer;
-        private int? _lastSelectedPid = null;
+        private ProcessWatcher _watcher;
+        private readonly ObservableCollection<WatchedClient> _clients = new ObservableCollection<WatchedClient>();
+        private AttachOrchestrator _orchestrator;
+        private readonly Dictionary<int, Main> _attaching = new Dictionary<int, Main>();
+        private int _readyCount;
 
-        // ───────────────────────────────────────────────────────────────
-        // Win32 API Declarations — manual DLL injection (LoadLibraryA)
-        // ───────────────────────────────────────────────────────────────
-        [DllImport("kernel32.dll", SetLastError = true)]
-        private static extern IntPtr OpenProcess(int dwDesiredAccess, bool bInheritHandle, int dwProcessId);
-
-        [DllImport("kernel32.dll", SetLastError = true)]
-        private static extern IntPtr VirtualAllocEx(IntPtr hProcess, IntPtr lpAddress, uint dwSize,
-            uint flAllocationType, uint flProtect);
-
-        [DllImport("kernel32.dll", SetLastError = true)]
-        private static extern bool WriteProcessMemory(IntPtr hProcess, IntPtr lpBaseAddress, byte[] lpBuffer,
-            uint nSize, out IntPtr lpNumberOfBytesWritten);
-
-        [DllImport("kernel32.dll", CharSet = CharSet.Ansi)]
-        private static extern IntPtr GetProcAddress(IntPtr hModule, string procName);
-
-        [DllImport("kernel32.dll", CharSet = CharSet.Auto)]
-        private static extern IntPtr GetModuleHandle(string lpModuleName);
-
-        [DllImport("kernel32.dll", SetLastError = true)]
-        private static extern IntPtr CreateRemoteThread(IntPtr hProcess, IntPtr lpThreadAttributes, uint dwStackSize,
-            IntPtr lpStartAddress, IntPtr lpParameter, uint dwCreationFlags, IntPtr lpThreadId);
-
-        [DllImport("kernel32.dll", SetLastError = true)]
-        private static extern bool CloseHandle(IntPtr hObject);
+        // Opt-in flags for the allocation profiler — must outlive this window
+        // until RemoteAchiko.dll has checked them (it does so at bootstrap)
+        private static readonly List<EventWaitHandle> _allocProfilerFlags = new List<EventWaitHandle>();
 
         // ───────────────────────────────────────────────────────────────
         // Constructor
@@ -70,98 +52,92 @@ namespace Achikobuddy.Core
         {
             InitializeComponent();
             Loaded += Launcher_Loaded;
+            Closed += Launcher_Closed;
         }
 
         // ───────────────────────────────────────────────────────────────
-        // Window Loaded — initialize logging and start process scanning
+        // Window Loaded — initialize logging and start the process watcher
         // ───────────────────────────────────────────────────────────────
         private void Launcher_Loaded(object sender, RoutedEventArgs e)
         {
             _ = Bugger.Instance; // Start logging + pipe servers
 
-            UpdatePidList();
+            selectPID.ItemsSource = _clients;
 
-            _updateTimer = new DispatcherTimer
-            {
-                Interval = TimeSpan.FromSeconds(1)
-            };
-            _updateTimer.Tick += (s, args) => UpdatePidList();
-            _updateTimer.Start();
+            _watcher = new ProcessWatcher(Dispatcher);
+            _watcher.Changed += ApplyClientDiffs;
+            _watcher.Start("WoW.exe");
+        }
+
+        private void Launcher_Closed(object sender, EventArgs e)
+        {
+            _orchestrator?.Dispose();
+            _orchestrator = null;
+            _watcher?.Dispose();
+            _watcher = null;
         }
 
         // ───────────────────────────────────────────────────────────────
-        // Real-time WoW process detection + [BOT ATTACHED] status
+        // ApplyClientDiffs — UI thread; keeps the list sorted by PID
+        //
+        // Notes:
+        //   Items are long-lived WatchedClient objects, so the current
+        //   selection survives every update that does not remove it
         // ───────────────────────────────────────────────────────────────
-        private void UpdatePidList()
+        private void ApplyClientDiffs(IList<ClientDiff> diffs)
         {
-            _lastSelectedPid = GetSelectedPid();
-
-            var processes = Process.GetProcessesByName("WoW")
-                .OrderBy(p => p.Id)
-                .Select(p =>
-                {
-                    string item = $"WoW.exe (PID: {p.Id})";
-
-                    // Check if bot is already attached via global mutex
-                    try
-                    {
-                        using (Mutex.OpenExisting($"AchikobuddyBot_PID_{p.Id}"))
-                        {
-                            item += " [BOT ATTACHED]";
-                        }
-                    }
-                    catch
-                    {
-                        // Mutex does not exist → bot not attached
-                    }
-
-                    return item;
-                })
-                .ToList();
-
-            Dispatcher.Invoke(() =>
-            {
-                var current = selectPID.Items.Cast<string>().ToList();
-                if (!processes.SequenceEqual(current))
+            foreach (ClientDiff diff in diffs)
+            {
+                int index = IndexOfPid(diff.Pid);
+                switch (diff.Kind)
                 {
-                    selectPID.ItemsSource = processes;
-
-                    // Restore previous selection if possible
-                    if (_lastSelectedPid.HasValue)
-                    {
-                        string match = processes.FirstOrDefault(x => ParsePidFromItem(x) == _lastSelectedPid.Value);
-                        if (match != null)
-                            selectPID.SelectedItem = match;
-                    }
-                    else if (processes.Count > 0 && selectPID.SelectedIndex == -1)
-                    {
-                        selectPID.SelectedIndex = 0;
-                    }
+                    case ClientChange.Added:
+                        if (index >= 0) break;
+                        var client = new WatchedClient(diff.Pid);
+                        client.Update(diff.Attached, diff.Bootstrap);
+                        int insertAt = 0;
+                        while (insertAt < _clients.Count && _clients[insertAt].Pid < diff.Pid)
+                            insertAt++;
+                        _clients.Insert(insertAt, client);
+                        break;
+
+                    case ClientChange.Changed:
+                        if (index >= 0)
+                            _clients[index].Update(diff.Attached, diff.Bootstrap);
+                        break;
+
+                    case ClientChange.Removed:
+                        if (index >= 0)
+                            _clients.RemoveAt(index);
+                        break;
                 }
-            });
+            }
+
+            if (selectPID.SelectedIndex == -1 && _clients.Count > 0)
+                selectPID.SelectedIndex = 0;
         }
 
-        // ───────────────────────────────────────────────────────────────
-        // Get currently selected PID from dropdown
-        // ───────────────────────────────────────────────────────────────
-        private int? GetSelectedPid()
+        private int IndexOfPid(int pid)
         {
-            if (selectPID.SelectedItem is string s)
-                return (int?)ParsePidFromItem(s);
-            return null;
+            for (int i = 0; i < _clients.Count; i++)
+            {
+                if (_clients[i].Pid == pid)
+                    return i;
+            }
+            return -1;
         }
 
         // ───────────────────────────────────────────────────────────────
-        // Extract PID number from string item
+        // Get currently selected PID from dropdown
         // ───────────────────────────────────────────────────────────────
-        private static int ParsePidFromItem(string item)
+        private int? GetSelectedPid()
         {
-            var m = Regex.Match(item, @"PID: (\d+)");
-            return m.Success && int.TryParse(m.Groups[1].Value, out int pid) ? pid : 0;
+            var client = selectPID.SelectedItem as WatchedClient;
+            return client != null ? (int?)client.Pid : null;
         }
 
         // ───────────────────────────────────────────────────────────────
-        // Main injection logic — called on "Launch" button click
+        // "LAUNCH" — attach to the selected client
         // ───────────────────────────────────────────────────────────────
         private void launchMain_Click(object sender, RoutedEventArgs e)
         {
@@ -173,15 +149,45 @@ namespace Achikobuddy.Core
                 return;
             }
 
-            string mutexName = $"AchikobuddyBot_PID_{pid}";
-            bool createdNew;
-            var mutex = new Mutex(true, mutexName, out createdNew);
+            LaunchClients(new List<int> { pid });
+        }
 
-            if (!createdNew)
+        // ───────────────────────────────────────────────────────────────
+        // "LAUNCH ALL" — attach to every client not attached yet
+        // ───────────────────────────────────────────────────────────────
+        private void launchAll_Click(object sender, RoutedEventArgs e)
+        {
+            var pids = new List<int>();
+            foreach (WatchedClient client in _clients)
             {
-                MessageBox.Show("Bot is already attached to this WoW instance.", "Already Attached",
-                    MessageBoxButton.OK, MessageBoxImage.Warning);
-                mutex.Dispose();
+                if (!client.Attached)
+                    pids.Add(client.Pid);
+            }
+
+            if (pids.Count == 0)
+            {
+                MessageBox.Show("No unattached WoW process found.", "Achikobuddy",
+                    MessageBoxButton.OK, MessageBoxImage.Information);
+                return;
+            }
+
+            LaunchClients(pids);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // LaunchClients — claim each PID, open its Main window, then let
+        // the orchestrator inject and follow the bootstrap
+        //
+        // Notes:
+        //   The bot mutex is created here, on the UI thread — Main owns it
+        //   and releases it in OnClosed (mutexes are thread-affine)
+        // ───────────────────────────────────────────────────────────────
+        private void LaunchClients(IList<int> pids)
+        {
+            if (_orchestrator != null && _orchestrator.Busy)
+            {
+                MessageBox.Show("An attach is already in progress.", "Achikobuddy",
+                    MessageBoxButton.OK, MessageBoxImage.Information);
                 return;
             }
 
@@ -190,61 +196,141 @@ namespace Achikobuddy.Core
             {
                 MessageBox.Show("RemoteAchiko.dll not found in application directory.", "Missing DLL",
                     MessageBoxButton.OK, MessageBoxImage.Error);
-                mutex.Dispose();
                 return;
             }
 
-            var mainWindow = new Main(pid, mutex);
-            mainWindow.Show();
-
-            if (!InjectDLL(pid, dllPath))
+            var claimed = new List<int>();
+            foreach (int pid in pids)
             {
-                MessageBox.Show(
-                    "DLL injection failed.\n\nBoth WoW and Achikobuddy must be run as Administrator.",
-                    "Injection Failed", MessageBoxButton.OK, MessageBoxImage.Error);
+                string mutexName = $"AchikobuddyBot_PID_{pid}";
+                bool createdNew;
+                var mutex = new Mutex(true, mutexName, out createdNew);
 
-                mainWindow.Close();
-                Bugger.Instance.CloseDebugWindow();
-                mutex.Dispose();
+                if (!createdNew)
+                {
+                    Bugger.Instance.Log($"[Launcher] PID {pid} already has a bot attached — skipped");
+                    mutex.Dispose();
+                    continue;
+                }
+
+                if (allocProfilerCheck.IsChecked == true)
+                    RequestAllocProfiler(pid);
+
+                _watcher?.SetAttached(pid, true);
+
+                var mainWindow = new Main(pid, mutex);
+                mainWindow.Show();
+                _attaching[pid] = mainWindow;
+                claimed.Add(pid);
+            }
+
+            if (claimed.Count == 0)
+            {
+                MessageBox.Show("Bot is already attached to this WoW instance.", "Already Attached",
+                    MessageBoxButton.OK, MessageBoxImage.Warning);
                 return;
             }
 
-            Bugger.Instance.Log($"[Launcher] Successfully injected into PID {pid} — bot is LIVE");
-            this.Close();
+            if (_orchestrator == null)
+            {
+                _orchestrator = new AttachOrchestrator(Dispatcher, dllPath);
+                _orchestrator.ClientUpdated += Orchestrator_ClientUpdated;
+                _orchestrator.Completed += Orchestrator_Completed;
+            }
+
+            launchMain.IsEnabled = false;
+            launchAll.IsEnabled = false;
+            _readyCount = 0;
+            attachStatus.Text = $"Attaching 0/{claimed.Count} ready";
+            _orchestrator.Start(claimed);
         }
 
         // ───────────────────────────────────────────────────────────────
-        // Manual DLL injection using LoadLibraryA — safe and reliable
+        // Orchestrator_ClientUpdated — one client moved (UI thread)
+        //
+        // Behavior:
+        //   • ManagedReady → Main connects the command pipe, which is
+        //     what lets AchikoDLL signal the last stage
+        //   • Never injected → close its Main window and free the PID
+        //   • Later failures keep the window open — the log explains
         // ───────────────────────────────────────────────────────────────
-        private bool InjectDLL(int pid, string dllPath)
+        private void Orchestrator_ClientUpdated(ClientAttach client)
         {
-            IntPtr hProcess = OpenProcess(0x1F0FFF, false, pid);
-            if (hProcess == IntPtr.Zero)
+            Main mainWindow;
+            if (!_attaching.TryGetValue(client.Pid, out mainWindow))
+                return;
+
+            if (client.State == AttachState.ManagedReady)
             {
-                Bugger.Instance.Log($"[Launcher] OpenProcess failed — GLE: {Marshal.GetLastWin32Error()}");
-                return false;
+                mainWindow.ConnectCommandPipeAsync();
+            }
+            else if (client.Done && client.State != AttachState.Ready && client.NeverInjected)
+            {
+                mainWindow.Close();   // releases the bot mutex
+                _watcher?.SetAttached(client.Pid, false);
             }
 
-            try
+            if (client.State == AttachState.Ready)
+                _readyCount++;
+            attachStatus.Text = $"Attaching {_readyCount}/{_attaching.Count} ready — PID {client.Pid}: {client.State}";
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Orchestrator_Completed — every client is Ready or gave up
+        // ───────────────────────────────────────────────────────────────
+        private void Orchestrator_Completed(AttachReport report)
+        {
+            _attaching.Clear();
+            launchMain.IsEnabled = true;
+            launchAll.IsEnabled = true;
+            attachStatus.Text = $"{report.ReadyCount}/{report.Clients.Count} ready in {report.TotalMs} ms";
+
+            if (report.AllReady)
             {
-                byte[] pathBytes = Encoding.ASCII.GetBytes(dllPath + "\0");
+                Bugger.Instance.Log($"[Launcher] {report.ReadyCount} client(s) attached — bot is LIVE");
+                this.Close();
+                return;
+            }
 
-                IntPtr remoteMem = VirtualAllocEx(hProcess, IntPtr.Zero, (uint)pathBytes.Length, 0x3000, 0x40);
-                if (remoteMem == IntPtr.Zero) return false;
+            var failed = new StringBuilder();
+            bool anyInjected = false;
+            foreach (ClientAttach client in report.Clients)
+            {
+                if (!client.NeverInjected)
+                    anyInjected = true;
+                if (client.State != AttachState.Ready)
+                    failed.Append($"\nPID {client.Pid}: {client.State} — {client.Error}");
+            }
 
-                if (!WriteProcessMemory(hProcess, remoteMem, pathBytes, (uint)pathBytes.Length, out _))
-                    return false;
+            if (!anyInjected)
+                Bugger.Instance.CloseDebugWindow();
 
-                IntPtr loadLib = GetProcAddress(GetModuleHandle("kernel32.dll"), "LoadLibraryA");
-                if (loadLib == IntPtr.Zero) return false;
+            MessageBox.Show(
+                $"{report.ReadyCount} of {report.Clients.Count} client(s) attached.\n{failed}" +
+                "\n\nBoth WoW and Achikobuddy must be run as Administrator.",
+                "Injection Failed", MessageBoxButton.OK, MessageBoxImage.Error);
+        }
 
-                IntPtr thread = CreateRemoteThread(hProcess, IntPtr.Zero, 0, loadLib, remoteMem, 0, IntPtr.Zero);
-                return thread != IntPtr.Zero;
+        // ───────────────────────────────────────────────────────────────
+        // RequestAllocProfiler — create "AchikoAllocProfiler_PID_<pid>"
+        //
+        // Behavior:
+        //   • RemoteAchiko.dll opens the event during bootstrap; if it
+        //     exists, the CLR is started with our allocation profiler
+        //   • Only effective on first injection — the CLR reads profiler
+        //     settings once, when it starts
+        // ───────────────────────────────────────────────────────────────
+        private static void RequestAllocProfiler(int pid)
+        {
+            try
+            {
+                _allocProfilerFlags.Add(new EventWaitHandle(false, EventResetMode.ManualReset,
+                    $"AchikoAllocProfiler_PID_{pid}"));
+                Bugger.Instance.Log($"[Launcher] Allocation profiler requested for PID {pid}");
             }
-            finally
+            catch (Exception ex)
             {
-                if (hProcess != IntPtr.Zero)
-                    CloseHandle(hProcess);
+                Bugger.Instance.Log($"[Launcher] Cannot request allocation profiler: {ex.Message}");
             }
         }
     }
@@ -0,0 +1,232 @@
+﻿// LogFileWindow.xaml.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Viewer for saved Achikobuddy.log files of any size
+//
+// Responsibilities:
+// • Open a log through LogFileView (memory-mapped, indexed natively)
+// • Show only the lines that fit the window; the scroll bar spans the
+//   whole file (or the whole filter result)
+// • Source filters (Main / RemoteAchiko / AchikoDLL) run off the UI thread
+// • Live indexing progress in the status line
+//
+// Architecture:
+// • The TextBox never holds more than one screen of text — every scroll
+//   re-reads that window from the mapping (tens of µs)
+// • A DispatcherTimer polls progress while the index is still being
+//   built; the scroll range grows as lines become readable
+//
+// Critical Design Decisions:
+// • Separate from DebugWindow: DebugWindow shows the live session from
+//   Bugger's memory, this window only ever reads files
+// • A filter started during indexing covers the lines indexed so far and
+//   is re-run once indexing completes
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Threading.Tasks;
+using System.Windows;
+using System.Windows.Controls.Primitives;
+using System.Windows.Input;
+using System.Windows.Threading;
+using Achikobuddy.Debug;
+
+namespace Achikobuddy.Core
+{
+    // ───────────────────────────────────────────────────────────────
+    // LogFileWindow — one window per opened file
+    // ───────────────────────────────────────────────────────────────
+    public partial class LogFileWindow : Window
+    {
+        private const int WheelLines = 3;
+
+        private readonly LogFileView _view;
+        private readonly DispatcherTimer _progressTimer;
+        private string _filter;          // null = all lines
+        private long _filterCount;
+        private int _filterVersion;      // drops results of superseded filters
+        private long _top;               // first visible line (or match)
+
+        private LogFileWindow(LogFileView view)
+        {
+            InitializeComponent();
+            _view = view;
+            Title = "Achikobuddy Log Viewer — " + view.Path;
+
+            _progressTimer = new DispatcherTimer { Interval = TimeSpan.FromMilliseconds(250) };
+            _progressTimer.Tick += ProgressTimer_Tick;
+            _progressTimer.Start();
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // ShowFile — open path in a new viewer window
+        //
+        // Returns:
+        //   false if the file could not be opened (reason logged to Bugger)
+        // ───────────────────────────────────────────────────────────────
+        public static bool ShowFile(string path)
+        {
+            string error;
+            LogFileView view = LogFileView.Open(path, out error);
+            if (view == null)
+            {
+                Bugger.Instance.Log("[LogViewer] " + error);
+                return false;
+            }
+
+            new LogFileWindow(view).Show();
+            return true;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // RENDERING
+        // ═══════════════════════════════════════════════════════════════
+
+        // Lines or matches the scroll bar spans
+        private long Count => _filter == null ? _view.Lines : _filterCount;
+
+        private int VisibleLines
+        {
+            get
+            {
+                double lineHeight = linesBox.FontSize * linesBox.FontFamily.LineSpacing;
+                int lines = (int)(linesBox.ActualHeight / lineHeight);
+                return Math.Max(1, Math.Min(lines, LogFileView.MaxWindowLines));
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Render — read the visible window and sync the scroll bar
+        // ───────────────────────────────────────────────────────────────
+        private void Render()
+        {
+            int visible = VisibleLines;
+            long count = Count;
+            long maxTop = Math.Max(0, count - visible);
+            _top = Math.Max(0, Math.Min(_top, maxTop));
+
+            string[] lines;
+            if (_filter == null)
+            {
+                lines = _view.Read(_top, visible);
+            }
+            else
+            {
+                long[] lineNumbers;
+                lines = _view.ReadFiltered(_top, visible, out lineNumbers);
+            }
+
+            linesBox.Text = string.Join(Environment.NewLine, lines);
+
+            lineScroll.Maximum = maxTop;
+            lineScroll.ViewportSize = visible;
+            lineScroll.LargeChange = visible;
+            lineScroll.Value = _top;
+        }
+
+        private void UpdateStatus()
+        {
+            string lines = _view.Lines.ToString("N0");
+            string status;
+
+            if (_view.Failed)
+                status = $"Indexing failed after {lines} lines";
+            else if (!_view.Indexed)
+                status = $"Indexing {_view.IndexedFraction:P0} — {lines} lines";
+            else
+                status = $"{lines} lines";
+
+            if (_filter != null)
+                status += $" — {_filter}: {_filterCount:N0}";
+
+            statusText.Text = status;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // FILTERING
+        // ═══════════════════════════════════════════════════════════════
+
+        private async void ApplyFilter(string prefix)
+        {
+            int version = ++_filterVersion;
+
+            if (prefix == null)
+            {
+                _filter = null;
+                _top = 0;
+                Render();
+                UpdateStatus();
+                return;
+            }
+
+            statusText.Text = $"Filtering {prefix}…";
+            long count = await _view.FilterAsync(prefix);
+
+            if (version != _filterVersion || !IsLoaded)
+                return;   // superseded or window closed
+
+            _filter = prefix;
+            _filterCount = count;
+            _top = 0;
+            Render();
+            UpdateStatus();
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // EVENT HANDLERS
+        // ═══════════════════════════════════════════════════════════════
+
+        private void ProgressTimer_Tick(object sender, EventArgs e)
+        {
+            bool finished = _view.Indexed || _view.Failed;
+            if (finished)
+            {
+                _progressTimer.Stop();
+                if (_filter != null)
+                    ApplyFilter(_filter);   // extend to the lines indexed since
+            }
+
+            Render();
+            UpdateStatus();
+        }
+
+        private void LineScroll_Scroll(object sender, ScrollEventArgs e)
+        {
+            _top = (long)lineScroll.Value;
+            Render();
+        }
+
+        private void LinesBox_PreviewMouseWheel(object sender, MouseWheelEventArgs e)
+        {
+            _top -= e.Delta / Mouse.MouseWheelDeltaForOneLine * WheelLines;
+            Render();
+            e.Handled = true;
+        }
+
+        private void LinesBox_SizeChanged(object sender, SizeChangedEventArgs e) => Render();
+
+        private void BtnAll_Click(object sender, RoutedEventArgs e) => ApplyFilter(null);
+        private void BtnMain_Click(object sender, RoutedEventArgs e) => ApplyFilter("[Main]");
+        private void BtnRemote_Click(object sender, RoutedEventArgs e) => ApplyFilter("[RemoteAchiko]");
+        private void BtnAchiko_Click(object sender, RoutedEventArgs e) => ApplyFilter("[AchikoDLL]");
+
+        // ───────────────────────────────────────────────────────────────
+        // Cleanup on close — Dispose waits out a running filter, so it
+        // happens off the UI thread
+        // ───────────────────────────────────────────────────────────────
+        protected override void OnClosed(EventArgs e)
+        {
+            _progressTimer.Stop();
+            _filterVersion++;
+
+            LogFileView view = _view;
+            Task.Run(() => view.Dispose());
+
+            base.OnClosed(e);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // END OF LogFileWindow.xaml.cs
+        // ───────────────────────────────────────────────────────────────
+    }
+}
@@ -6,6 +6,7 @@
 // • Live monitoring of WoW process, bot state, and pipe health
 // • Real-time memory reading (player stats, position, target, zone)
 // • Start/Stop buttons that send commands to injected AchikoDLL via pipe
+// • Trace button: TRACE_ON, then TRACE_DUMP → Chrome/Perfetto JSON in Traces\
 // • Auto-status updates every 500ms with smooth color-coded indicators
 // • Thread control 100% handled by AchikoDLL's BotCore (separation of concerns)
 // • Professional, smooth, elite-tier UI with zero flicker
@@ -19,7 +20,9 @@
 // • Fully decoupled: UI doesn't know about BotCore internals
 //
 // Critical Design Decisions:
-// • Command pipe lazily reconnects if DLL not loaded yet
+// • Command pipe is per PID ("AchikoPipe_Commands_<pid>") so several
+//   bots can run side by side; the Launcher connects it once the client
+//   reaches ManagedReady, and it lazily reconnects if DLL not loaded yet
 // • _botEnabled tracks UI state, NOT actual bot state (fire-and-forget)
 // • Status colors: Gold (idle), LimeGreen (running), OrangeRed (broken), Red (error)
 // • Pipe health monitored via log messages (contains "CRITICAL" or "Pipe broken")
@@ -29,6 +32,7 @@
 using System;
 using System.ComponentModel;
 using System.Diagnostics;
+using System.IO;
 using System.IO.Pipes;
 using System.Linq;
 using System.Text;
@@ -58,6 +62,13 @@ namespace Achikobuddy.Core
         private bool _botEnabled = false;               // UI state: is bot enabled?
         private bool _pipeHealthy = true;               // Pipe connection status
         private NamedPipeClientStream _commandPipe;     // Outgoing commands to DLL
+        private readonly string _commandPipeName;       // "AchikoPipe_Commands_<pid>"
+        private bool _tracing = false;                  // UI state: TRACE_ON sent, no dump yet
+        private bool _profiling = false;                // UI state: PROFILE_ON sent, no dump yet
+        private volatile string _effectSummary;         // last "[Effect]" line from the DLL
+        private const string EffectTag = "[Effect] ";   // EffectLatency.PublishIfDue lines
+        private volatile string _memorySummary;         // last "[Memory]" line from the DLL
+        private const string MemoryTag = "[Memory] ";   // MemoryBudget.PublishIfDue lines
 
         // ═══════════════════════════════════════════════════════════════
         // INITIALIZATION
@@ -73,8 +84,8 @@ namespace Achikobuddy.Core
         // Behavior:
         //   1. Sets window title with PID for easy identification
         //   2. Subscribes to Bugger.LogAdded for DLL health monitoring
-        //   3. Attempts to connect command pipe (may fail if DLL not loaded yet)
-        //   4. Sets up Loaded/Closing event handlers
+        //   3. Sets up Loaded/Closing event handlers
+        //   (the command pipe connects later — see ConnectCommandPipeAsync)
         //
         // Thread safety:
         //   Constructor runs on UI thread — no locking needed
@@ -85,6 +96,7 @@ namespace Achikobuddy.Core
 
             _pid = pid;
             _pidMutex = pidMutex;
+            _commandPipeName = $"AchikoPipe_Commands_{pid}";
 
             Title = $"Achikobuddy — PID {_pid}";
             SetStatus("Status: Connected | Idle", Brushes.Gold);
@@ -97,9 +109,6 @@ namespace Achikobuddy.Core
             // Subscribe to DLL logs for health monitoring
             // (unsubscribed in OnClosed to prevent memory leaks)
             Bugger.Instance.LogAdded += HandleLogMessage;
-
-            // Try to connect command pipe (may fail if DLL not injected yet)
-            InitializeCommandPipe();
         }
 
         // ═══════════════════════════════════════════════════════════════
@@ -107,36 +116,50 @@ namespace Achikobuddy.Core
         // ═══════════════════════════════════════════════════════════════
 
         // ───────────────────────────────────────────────────────────────
-        // InitializeCommandPipe — establish connection to AchikoDLL
+        // ConnectCommandPipeAsync — establish connection to AchikoDLL
         //
         // Behavior:
-        //   • Attempts to connect to "AchikoPipe_Commands" with 100ms timeout
-        //   • If successful, logs connection
-        //   • If fails (DLL not loaded yet), silently continues
-        //   • SendCommandToDLL() will retry connection when needed
-        //
-        // Why 100ms timeout?
-        //   DLL might not be loaded yet — we don't want to block startup
+        //   • Called by the Launcher when the client reaches ManagedReady —
+        //     AchikoDLL's command server may still be starting, so the
+        //     connect (up to 5s) runs on the thread pool, not the UI thread
+        //   • AchikoDLL signals the PipesConnected stage once it accepts
+        //   • If it fails, SendCommandToDLL() retries when needed
         // ───────────────────────────────────────────────────────────────
-        private void InitializeCommandPipe()
+        public void ConnectCommandPipeAsync()
         {
-            try
+            ThreadPool.QueueUserWorkItem(_ =>
             {
-                _commandPipe = new NamedPipeClientStream(
-                    ".",                        // Local machine
-                    "AchikoPipe_Commands",      // Pipe name (matches AchikoDLL)
-                    PipeDirection.Out,          // We only send commands
-                    PipeOptions.Asynchronous    // Non-blocking I/O
-                );
-                _commandPipe.Connect(100);  // 100ms timeout
-                Bugger.Instance.Log("[MainWindow] Command pipe connected to AchikoDLL");
-            }
-            catch
-            {
-                // DLL not loaded yet — this is expected on startup
-                // We'll reconnect when user clicks Start/Stop
-                _commandPipe = null;
-            }
+                NamedPipeClientStream pipe = null;
+                try
+                {
+                    pipe = new NamedPipeClientStream(
+                        ".",                        // Local machine
+                        _commandPipeName,           // Pipe name (matches AchikoDLL)
+                        PipeDirection.Out,          // We only send commands
+                        PipeOptions.Asynchronous    // Non-blocking I/O
+                    );
+                    pipe.Connect(5000);
+                }
+                catch
+                {
+                    // DLL never opened the pipe — SendCommandToDLL will retry
+                    try { pipe?.Dispose(); } catch { }
+                    return;
+                }
+
+                Dispatcher.BeginInvoke(new Action(() =>
+                {
+                    if (_commandPipe != null && _commandPipe.IsConnected)
+                    {
+                        pipe.Dispose();     // a click reconnected first
+                        return;
+                    }
+
+                    try { _commandPipe?.Dispose(); } catch { }
+                    _commandPipe = pipe;
+                    Bugger.Instance.Log("[MainWindow] Command pipe connected to AchikoDLL");
+                }));
+            });
         }
 
         // ───────────────────────────────────────────────────────────────
@@ -168,7 +191,7 @@ namespace Achikobuddy.Core
                 if (_commandPipe == null || !_commandPipe.IsConnected)
                 {
                     try { _commandPipe?.Dispose(); } catch { }
-                    _commandPipe = new NamedPipeClientStream(".", "AchikoPipe_Commands", PipeDirection.Out);
+                    _commandPipe = new NamedPipeClientStream(".", _commandPipeName, PipeDirection.Out);
                     _commandPipe.Connect(200);  // 200ms timeout (slightly longer on reconnect)
                 }
 
@@ -296,6 +319,10 @@ namespace Achikobuddy.Core
                 targetGuidText.Text = Elements.TargetGuidText;
                 zoneTextLabel.Text = Elements.ZoneText;
                 minimapZoneTextLabel.Text = Elements.MinimapZoneText;
+                if (_effectSummary != null)
+                    effectText.Text = "Decision → effect: " + _effectSummary;
+                if (_memorySummary != null)
+                    memoryText.Text = "Address space: " + _memorySummary;
             }
             catch (Exception ex)
             {
@@ -386,6 +413,73 @@ namespace Achikobuddy.Core
             Bugger.Instance.Log("[MainWindow] Click-to-Move clicked — (not implemented)");
         }
 
+        // ───────────────────────────────────────────────────────────────
+        // TraceButton_Click — start a trace session, or dump the current one
+        //
+        // Behavior:
+        //   • First click  → "TRACE_ON" (AchikoDLL records spans natively)
+        //   • Second click → "TRACE_DUMP|<path>" — DLL stops recording and
+        //     writes Traces\achiko-<pid>-<time>.json next to Achikobuddy.exe
+        //   • Open the file in ui.perfetto.dev or chrome://tracing
+        //   • Result (event count or failure) arrives as an [AchikoDLL] log line
+        // ───────────────────────────────────────────────────────────────
+        private void TraceButton_Click(object sender, RoutedEventArgs e)
+        {
+            if (!_tracing)
+            {
+                SendCommandToDLL("TRACE_ON");
+                _tracing = true;
+                TraceButton.Content = "Save Trace";
+                return;
+            }
+
+            string folder = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, "Traces");
+            try { Directory.CreateDirectory(folder); }
+            catch (Exception ex) { Bugger.Instance.Log($"[MainWindow] Cannot create {folder}: {ex.Message}"); }
+
+            string path = Path.Combine(folder, $"achiko-{_pid}-{DateTime.Now:yyyyMMdd-HHmmss}.json");
+            SendCommandToDLL("TRACE_DUMP|" + path);
+
+            _tracing = false;
+            TraceButton.Content = "Trace";
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // ProfileButton_Click — start sampling, or dump the collected stacks
+        //
+        // Behavior:
+        //   • First click  → "PROFILE_ON|250" (bot threads sampled at 250 Hz,
+        //     sampler capped at 2% of one core)
+        //   • Second click → "PROFILE_DUMP|<path>" — DLL stops sampling and
+        //     writes Traces\achiko-<pid>-<time>.folded (collapsed stacks)
+        //   • Open the file in speedscope.app or feed it to flamegraph.pl
+        //   • Also sends "ALLOC_REPORT" — top allocators for the same window
+        //     (only if the allocation profiler was enabled in the launcher)
+        //   • And "GC_REPORT" — combat ticks hit by a gen2 GC, steering off vs on
+        // ───────────────────────────────────────────────────────────────
+        private void ProfileButton_Click(object sender, RoutedEventArgs e)
+        {
+            if (!_profiling)
+            {
+                SendCommandToDLL("PROFILE_ON|250");
+                _profiling = true;
+                ProfileButton.Content = "Save Prof";
+                return;
+            }
+
+            string folder = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, "Traces");
+            try { Directory.CreateDirectory(folder); }
+            catch (Exception ex) { Bugger.Instance.Log($"[MainWindow] Cannot create {folder}: {ex.Message}"); }
+
+            string path = Path.Combine(folder, $"achiko-{_pid}-{DateTime.Now:yyyyMMdd-HHmmss}.folded");
+            SendCommandToDLL("PROFILE_DUMP|" + path);
+            SendCommandToDLL("ALLOC_REPORT");
+            SendCommandToDLL("GC_REPORT");
+
+            _profiling = false;
+            ProfileButton.Content = "Profile";
+        }
+
         private void DebugButton_Click(object sender, RoutedEventArgs e)
         {
             DebugWindow.ShowWindow();
@@ -467,6 +561,8 @@ namespace Achikobuddy.Core
         //   • Filters for [AchikoDLL] messages only
         //   • If contains "Pipe broken" or "CRITICAL" → mark pipe unhealthy
         //   • If contains "Connected" → mark pipe healthy
+        //   • "[Effect] ..." → decision → effect summary for the status area
+        //   • "[Memory] ..." → address-space summary for the status area
         //   • UpdateStatus() will reflect changes on next tick
         //
         // Why monitor logs instead of direct pipe health?
@@ -488,6 +584,14 @@ namespace Achikobuddy.Core
                 {
                     _pipeHealthy = true;
                 }
+
+                int effect = message.IndexOf(EffectTag, StringComparison.Ordinal);
+                if (effect >= 0)
+                    _effectSummary = message.Substring(effect + EffectTag.Length);
+
+                int memory = message.IndexOf(MemoryTag, StringComparison.Ordinal);
+                if (memory >= 0)
+                    _memorySummary = message.Substring(memory + MemoryTag.Length);
             }
         }
 
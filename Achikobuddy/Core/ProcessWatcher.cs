@@ -0,0 +1,330 @@
+﻿// ProcessWatcher.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Typed, event-driven list of WoW clients for the Launcher
+//
+// Responsibilities:
+// • WatchedClient: one WoW process — PID, attach state, bootstrap stage
+// • ProcessWatcher: turn AchikoWatch.dll's client diffs into Changed
+//   events on the UI thread
+// • Fallback discovery (1 s scan on a background thread) when the native
+//   watcher is missing or has no start notifications
+//
+// Architecture:
+// • AchikoWatch.dll (native, loaded into Achikobuddy — not injected) gets
+//   process starts from WMI, exits and bootstrap stages from kernel waits,
+//   and keeps the client model (ClientModel.h)
+// • One consumer thread blocks in AchikoWatchWait and marshals each batch
+//   of diffs to the Dispatcher — the UI thread only applies changes
+//
+// Critical Design Decisions:
+// • The UI never re-reads the process list: Added / Changed / Removed
+//   are applied to long-lived WatchedClient objects, so selection
+//   survives updates without string matching
+// • Bootstrap stages only exist with the native watcher; the fallback
+//   reports PID + attach state, like the old Launcher did
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Collections.Generic;
+using System.ComponentModel;
+using System.Diagnostics;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Threading;
+using System.Windows.Threading;
+using Achikobuddy.Debug;
+
+namespace Achikobuddy.Core
+{
+    // Mirrors BootstrapStage.h
+    public enum BootstrapStage
+    {
+        None = 0,
+        Injected = 1,
+        ClrUp = 2,
+        ManagedReady = 3,
+        PipesConnected = 4,
+        Failed = 5
+    }
+
+    public enum ClientChange
+    {
+        Added = 1,
+        Changed = 2,
+        Removed = 3
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ClientDiff — one change to one client
+    // ═══════════════════════════════════════════════════════════════
+    public struct ClientDiff
+    {
+        public ClientChange Kind;
+        public int Pid;
+        public bool Attached;
+        public BootstrapStage Bootstrap;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // WatchedClient — one WoW process in the Launcher list
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class WatchedClient : INotifyPropertyChanged
+    {
+        public WatchedClient(int pid)
+        {
+            Pid = pid;
+        }
+
+        public int Pid { get; }
+        public bool Attached { get; private set; }
+        public BootstrapStage Bootstrap { get; private set; }
+
+        // ComboBox text (DisplayMemberPath)
+        public string Display
+        {
+            get
+            {
+                string text = $"WoW.exe (PID: {Pid})";
+                if (Attached)
+                    text += " [BOT ATTACHED]";
+
+                switch (Bootstrap)
+                {
+                    case BootstrapStage.Injected: return text + " [bootstrap: starting CLR]";
+                    case BootstrapStage.ClrUp: return text + " [bootstrap: loading AchikoDLL]";
+                    case BootstrapStage.ManagedReady: return text + " [bootstrap: connecting pipes]";
+                    case BootstrapStage.Failed: return text + " [BOOTSTRAP FAILED]";
+                    default: return text;
+                }
+            }
+        }
+
+        public event PropertyChangedEventHandler PropertyChanged;
+
+        internal void Update(bool attached, BootstrapStage bootstrap)
+        {
+            if (Attached == attached && Bootstrap == bootstrap)
+                return;
+
+            Attached = attached;
+            Bootstrap = bootstrap;
+            PropertyChanged?.Invoke(this, new PropertyChangedEventArgs(nameof(Display)));
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ProcessWatcher — diff source for the Launcher
+    // ═══════════════════════════════════════════════════════════════
+    public sealed class ProcessWatcher : IDisposable
+    {
+        private const int BatchSize = 32;
+        private const int WaitTimeoutMs = 500;        // stop-check period only
+        private const int FallbackIntervalMs = 1000;
+
+        private readonly Dispatcher _dispatcher;
+        private Thread _thread;
+        private volatile bool _running;
+        private bool _native;
+
+        // Raised on the dispatcher thread, one batch per notification
+        public event Action<IList<ClientDiff>> Changed;
+
+        // "wmi trace", "wmi instance" or "polling"
+        public string Source { get; private set; } = "none";
+
+        // ───────────────────────────────────────────────────────────────
+        // AchikoWatch.dll — keep in sync with AchikoWatch/Exports.cpp
+        // ───────────────────────────────────────────────────────────────
+        [StructLayout(LayoutKind.Sequential)]
+        private struct NativeClientDiff
+        {
+            public uint Kind;
+            public uint Pid;
+            public uint Attach;
+            public uint Bootstrap;
+            public ulong EventNs;
+        }
+
+        [DllImport("AchikoWatch.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        private static extern int AchikoWatchStart(string imageName);
+
+        [DllImport("AchikoWatch.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoWatchStop();
+
+        [DllImport("AchikoWatch.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern IntPtr AchikoWatchSource();
+
+        [DllImport("AchikoWatch.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern int AchikoWatchWait([Out] NativeClientDiff[] diffs, int capacity, int timeoutMs);
+
+        [DllImport("AchikoWatch.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoWatchSetAttach(int pid, int attached);
+
+        public ProcessWatcher(Dispatcher dispatcher)
+        {
+            _dispatcher = dispatcher;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — native watcher if possible, background scan otherwise
+        //
+        // Args:
+        //   imageName - "WoW.exe"
+        // ───────────────────────────────────────────────────────────────
+        public void Start(string imageName)
+        {
+            if (_running) return;
+            _running = true;
+
+            try
+            {
+                _native = AchikoWatchStart(imageName) != 0;
+                if (_native)
+                    Source = Marshal.PtrToStringAnsi(AchikoWatchSource());
+            }
+            catch (Exception ex)
+            {
+                // DllNotFoundException / BadImageFormatException (bitness) /
+                // EntryPointNotFoundException
+                Bugger.Instance.Log($"[ProcessWatcher] AchikoWatch.dll unavailable ({ex.GetType().Name})");
+                _native = false;
+            }
+
+            if (!_native)
+                Source = "polling";
+
+            string processName = Path.GetFileNameWithoutExtension(imageName);
+            _thread = _native
+                ? new Thread(NativeLoop) { Name = "Achikobuddy process watch", IsBackground = true }
+                : new Thread(() => FallbackLoop(processName)) { Name = "Achikobuddy process scan", IsBackground = true };
+            _thread.Start();
+
+            Bugger.Instance.Log($"[ProcessWatcher] Watching {imageName} via {Source}");
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // SetAttached — the Launcher created / released the bot mutex
+        // ───────────────────────────────────────────────────────────────
+        public void SetAttached(int pid, bool attached)
+        {
+            if (!_native) return;   // the fallback scan probes the mutex itself
+
+            try { AchikoWatchSetAttach(pid, attached ? 1 : 0); }
+            catch (Exception) { }
+        }
+
+        public void Dispose()
+        {
+            if (!_running) return;
+            _running = false;
+
+            if (_native)
+            {
+                try { AchikoWatchStop(); }   // releases AchikoWatchWait
+                catch (Exception) { }
+            }
+
+            _thread?.Join(2000);
+            _thread = null;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // CONSUMER THREADS
+        // ═══════════════════════════════════════════════════════════════
+
+        private void NativeLoop()
+        {
+            var buffer = new NativeClientDiff[BatchSize];
+
+            while (_running)
+            {
+                int count;
+                try { count = AchikoWatchWait(buffer, BatchSize, WaitTimeoutMs); }
+                catch (Exception) { break; }
+
+                if (count <= 0 || !_running)
+                    continue;
+
+                var diffs = new ClientDiff[count];
+                for (int i = 0; i < count; i++)
+                {
+                    diffs[i] = new ClientDiff
+                    {
+                        Kind = (ClientChange)buffer[i].Kind,
+                        Pid = (int)buffer[i].Pid,
+                        Attached = buffer[i].Attach != 0,
+                        Bootstrap = (BootstrapStage)buffer[i].Bootstrap
+                    };
+                }
+                Publish(diffs);
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // FallbackLoop — the old 1 s scan, moved off the UI thread and
+        // reduced to diffs against the previous scan
+        // ───────────────────────────────────────────────────────────────
+        private void FallbackLoop(string processName)
+        {
+            var known = new Dictionary<int, bool>();   // pid → attached
+
+            while (_running)
+            {
+                var seen = new Dictionary<int, bool>();
+                foreach (Process process in Process.GetProcessesByName(processName))
+                {
+                    seen[process.Id] = ProbeAttached(process.Id);
+                    process.Dispose();
+                }
+
+                var diffs = new List<ClientDiff>();
+                foreach (var pair in seen)
+                {
+                    bool attached;
+                    if (!known.TryGetValue(pair.Key, out attached))
+                        diffs.Add(new ClientDiff { Kind = ClientChange.Added, Pid = pair.Key, Attached = pair.Value });
+                    else if (attached != pair.Value)
+                        diffs.Add(new ClientDiff { Kind = ClientChange.Changed, Pid = pair.Key, Attached = pair.Value });
+                }
+                foreach (int pid in known.Keys)
+                {
+                    if (!seen.ContainsKey(pid))
+                        diffs.Add(new ClientDiff { Kind = ClientChange.Removed, Pid = pid });
+                }
+
+                known = seen;
+                if (diffs.Count > 0)
+                    Publish(diffs);
+
+                try { Thread.Sleep(FallbackIntervalMs); } catch (ThreadInterruptedException) { break; }
+            }
+        }
+
+        private static bool ProbeAttached(int pid)
+        {
+            try
+            {
+                using (Mutex.OpenExisting($"AchikobuddyBot_PID_{pid}"))
+                    return true;
+            }
+            catch (Exception)
+            {
+                return false;   // WaitHandleCannotBeOpenedException — not attached
+            }
+        }
+
+        private void Publish(IList<ClientDiff> diffs)
+        {
+            _dispatcher.BeginInvoke(new Action(() =>
+            {
+                if (_running)
+                    Changed?.Invoke(diffs);
+            }));
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
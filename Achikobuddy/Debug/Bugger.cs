@@ -17,11 +17,14 @@
 //   - AchikoPipe_Bootstrapper → receives logs from RemoteAchiko.dll (native)
 //   - AchikoPipe_AchikoDLL     → receives logs from AchikoDLL.dll (managed)
 // • All logs tagged with source: [Main], [RemoteAchiko], [AchikoDLL]
+// • Pipe clients are read in 64 KB blocks and merged into one timeline
+//   by their own "[HH:mm:ss.fff]" stamps (LogIngest → AchikoIngest.dll);
+//   without the DLL, each client is read line by line as before
 // • DebugWindow subscribes to LogAdded for live display
 //
 // Critical Design Decisions:
 // • File logging is best-effort — never throws on disk errors
-// • Pipe servers auto-reconnect if client disconnects
+// • Pipe servers accept any number of concurrent clients per pipe
 // • Memory buffer grows unbounded (acceptable for debugging)
 // • CancellationToken used for clean shutdown without deadlocks
 // ─────────────────────────────────────────────────────────────────────────────
@@ -57,6 +60,7 @@ namespace Achikobuddy.Debug
         private CancellationTokenSource _cts;
         private Task _bootstrapperTask;
         private Task _botTask;
+        private LogIngest _ingest;                      // null = per-line fallback
 
         // ───────────────────────────────────────────────────────────────
         // File path for persistent logging
@@ -101,7 +105,8 @@ namespace Achikobuddy.Debug
         {
             try
             {
-                _mainLog.Clear();
+                lock (_fileLock)
+                    _mainLog.Clear();
             }
             catch { /* StringBuilder should never throw, but safety first */ }
         }
@@ -253,38 +258,71 @@ namespace Achikobuddy.Debug
         //   [HH:mm:ss.fff] [Source] Message
         //
         // Thread safety:
-        //   File writes are locked via _fileLock
-        //   StringBuilder is NOT thread-safe, but only accessed here
+        //   File writes and _mainLog appends are locked via _fileLock —
+        //   every connected pipe client calls this from its own task
         //   Event invocation is thread-safe (delegates handle their own)
         // ───────────────────────────────────────────────────────────────
         private void WriteLog(string message)
+        {
+            WriteLogs(new[] { message }, 1);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // WriteLogs — WriteLog for a batch: one timestamp, one file append
+        // and one buffer append for all of them
+        //
+        // Used by:
+        //   WriteLog, and the merge thread for every ordered pipe batch
+        // ───────────────────────────────────────────────────────────────
+        private void WriteLogs(string[] messages, int count)
         {
             // Add timestamp prefix: [HH:mm:ss.fff]
-            string line = $"[{DateTime.Now:HH:mm:ss.fff}] {message}{Environment.NewLine}";
+            string stamp = $"[{DateTime.Now:HH:mm:ss.fff}] ";
+            var block = new StringBuilder();
+            for (int i = 0; i < count; i++)
+                block.Append(stamp).Append(messages[i]).Append(Environment.NewLine);
+            string lines = block.ToString();
 
-            // ───────────────────────────────────────────────────────────
-            // Output 1: Write to disk file (best-effort, locked)
-            // ───────────────────────────────────────────────────────────
             lock (_fileLock)
             {
-                try { File.AppendAllText(LogFilePath, line); }
+                // ───────────────────────────────────────────────────────
+                // Output 1: Write to disk file (best-effort, locked)
+                // ───────────────────────────────────────────────────────
+                try { File.AppendAllText(LogFilePath, lines); }
                 catch { /* Ignore disk errors — memory + UI still work */ }
-            }
 
-            // ───────────────────────────────────────────────────────────
-            // Output 2: Append to in-memory buffer
-            // ───────────────────────────────────────────────────────────
-            _mainLog.Append(line);
+                // ───────────────────────────────────────────────────────
+                // Output 2: Append to in-memory buffer
+                // ───────────────────────────────────────────────────────
+                _mainLog.Append(lines);
+            }
 
-            // ───────────────────────────────────────────────────────────
-            // Output 3: Fire event for DebugWindow (if subscribed)
-            // ───────────────────────────────────────────────────────────
-            LogAdded?.Invoke(message);
+            for (int i = 0; i < count; i++)
+            {
+                // ───────────────────────────────────────────────────────
+                // Output 3: Fire event for DebugWindow (if subscribed)
+                // ───────────────────────────────────────────────────────
+                LogAdded?.Invoke(messages[i]);
+
+                // ───────────────────────────────────────────────────────
+                // Output 4: Direct append if DebugWindow is open
+                // ───────────────────────────────────────────────────────
+                DebugWindow?.AppendLog(messages[i]);
+            }
+        }
 
-            // ───────────────────────────────────────────────────────────
-            // Output 4: Direct append if DebugWindow is open
-            // ───────────────────────────────────────────────────────────
-            DebugWindow?.AppendLog(message);
+        // ───────────────────────────────────────────────────────────────
+        // WriteIngested — merge thread sink: tag and write one batch
+        // ───────────────────────────────────────────────────────────────
+        private void WriteIngested(IngestedLine[] lines, int count)
+        {
+            var messages = new string[count];
+            for (int i = 0; i < count; i++)
+            {
+                messages[i] = (lines[i].Tag == LogTag.RemoteAchiko ? "[RemoteAchiko] " : "[AchikoDLL] ")
+                    + lines[i].Text;
+            }
+            WriteLogs(messages, count);
         }
 
         // ───────────────────────────────────────────────────────────────
@@ -296,7 +334,11 @@ namespace Achikobuddy.Debug
         // Used by:
         //   DebugWindow on tab switch to rebuild filtered views
         // ───────────────────────────────────────────────────────────────
-        public string GetAllLogs() => _mainLog.ToString();
+        public string GetAllLogs()
+        {
+            lock (_fileLock)
+                return _mainLog.ToString();
+        }
 
         // ═══════════════════════════════════════════════════════════════
         // DEBUG WINDOW CONTROL
@@ -353,6 +395,7 @@ namespace Achikobuddy.Debug
         //     - _bootstrapperTask for RemoteAchiko (native DLL)
         //     - _botTask for AchikoDLL (managed bot)
         //   • Both run PipeLoop with different pipe names and loggers
+        //   • Starts the native ingest + merge thread first (if available)
         //
         // Why Task.Run?
         //   Clean async background execution without blocking startup
@@ -362,74 +405,84 @@ namespace Achikobuddy.Debug
             _cts = new CancellationTokenSource();
             var token = _cts.Token;
 
-            _bootstrapperTask = Task.Run(() => PipeLoop("AchikoPipe_Bootstrapper", LogRemoteAchiko, token));
-            _botTask = Task.Run(() => PipeLoop("AchikoPipe_AchikoDLL", LogAchikoDLL, token));
+            _ingest = new LogIngest(WriteIngested);
+            if (!_ingest.Start())
+            {
+                Log("AchikoIngest.dll unavailable — pipe logs unmerged, read line by line");
+                _ingest = null;
+            }
+
+            _bootstrapperTask = Task.Run(() => PipeLoop("AchikoPipe_Bootstrapper", LogTag.RemoteAchiko, LogRemoteAchiko, token));
+            _botTask = Task.Run(() => PipeLoop("AchikoPipe_AchikoDLL", LogTag.AchikoDLL, LogAchikoDLL, token));
         }
 
         // ───────────────────────────────────────────────────────────────
-        // PipeLoop — generic pipe server implementation
+        // PipeLoop — generic pipe server implementation (multi-client)
         //
         // Args:
         //   pipeName - name of pipe to create (e.g., "AchikoPipe_Bootstrapper")
+        //   tag      - ingest source tag for this pipe's clients
         //   log      - delegate to call with received messages
         //   token    - cancellation token for clean shutdown
         //
         // Behavior:
-        //   1. Creates NamedPipeServerStream with given name
-        //   2. Waits for client connection (RemoteAchiko or AchikoDLL)
-        //   3. Reads lines until client disconnects
-        //   4. Logs all received lines via provided delegate
-        //   5. On disconnect, waits 300ms and reconnects (infinite loop)
-        //   6. Exits cleanly when token is cancelled
+        //   1. Creates a NamedPipeServerStream instance with given name
+        //   2. Waits for a client connection (RemoteAchiko or AchikoDLL)
+        //   3. Hands the connected pipe to ClientLoop on its own task
+        //   4. Immediately creates the next instance for the next client
+        //   5. Exits cleanly when token is cancelled
+        //
+        // Why multi-instance?
+        //   Several injected clients (or AchikoLoad's simulated bots) log
+        //   at once — with a single instance every other client waits in
+        //   ERROR_PIPE_BUSY until the first one disconnects.
         //
         // Error handling:
         //   • OperationCanceledException → expected on shutdown, silent exit
-        //   • Other exceptions → logged and loop continues (reconnect)
-        //
-        // Why async?
-        //   WaitForConnectionAsync prevents thread blocking during idle
+        //   • Other exceptions → logged, 300ms back-off, loop continues
         // ───────────────────────────────────────────────────────────────
-        private async Task PipeLoop(string pipeName, Action<string> log, CancellationToken token)
+        private async Task PipeLoop(string pipeName, LogTag tag, Action<string> log, CancellationToken token)
         {
+            bool announced = false;
+
             while (!token.IsCancellationRequested)
             {
                 NamedPipeServerStream pipe = null;
-                StreamReader reader = null;
 
                 try
                 {
                     // ───────────────────────────────────────────────────
-                    // Create named pipe server (in-only, async mode)
+                    // Create next server instance (in-only, async mode)
                     // ───────────────────────────────────────────────────
                     pipe = new NamedPipeServerStream(
                         pipeName,
-                        PipeDirection.In,                    // Only receive data
-                        1,                                   // Max 1 client at a time
-                        PipeTransmissionMode.Byte,           // Stream mode (not message)
+                        PipeDirection.In,                                // Only receive data
+                        NamedPipeServerStream.MaxAllowedServerInstances, // One instance per client
+                        PipeTransmissionMode.Byte,                       // Stream mode (not message)
                         PipeOptions.Asynchronous | PipeOptions.WriteThrough
                     );
 
-                    log($"Waiting for client on {pipeName}...");
+                    if (!announced)
+                    {
+                        log($"Waiting for clients on {pipeName}...");
+                        announced = true;
+                    }
 
                     // ───────────────────────────────────────────────────
-                    // Wait for injected DLL to connect
+                    // Wait for an injected DLL to connect
                     // ───────────────────────────────────────────────────
                     await pipe.WaitForConnectionAsync(token).ConfigureAwait(false);
                     log("Client connected");
 
                     // ───────────────────────────────────────────────────
-                    // Read lines until disconnect or cancellation
+                    // Reader owns the pipe from here on
                     // ───────────────────────────────────────────────────
-                    reader = new StreamReader(pipe, Encoding.UTF8, false, 1024, true);
-
-                    while (!token.IsCancellationRequested && pipe.IsConnected)
-                    {
-                        string line = await reader.ReadLineAsync().ConfigureAwait(false);
-                        if (line == null) break;  // EOF = client disconnected
-                        log(line);
-                    }
-
-                    log("Client disconnected");
+                    var connected = pipe;
+                    pipe = null;
+                    _ = _ingest != null
+                        ? Task.Run(() => IngestLoop(connected, tag, log, token))
+                        : Task.Run(() => ClientLoop(connected, log, token));
+                    continue;
                 }
                 catch (OperationCanceledException)
                 {
@@ -437,21 +490,100 @@ namespace Achikobuddy.Debug
                 }
                 catch (Exception ex)
                 {
-                    // Unexpected error — log and continue (will reconnect)
+                    // Unexpected error — log and continue (will recreate instance)
                     if (!token.IsCancellationRequested)
                         log($"Pipe error: {ex.Message}");
                 }
                 finally
                 {
-                    // ───────────────────────────────────────────────────
-                    // Clean up pipe resources (safe even if null)
-                    // ───────────────────────────────────────────────────
-                    try { reader?.Dispose(); } catch { }
                     try { pipe?.Dispose(); } catch { }
                 }
 
-                // Wait before reconnecting (reduces CPU thrashing on errors)
-                await Task.Delay(300, token).ConfigureAwait(false);
+                // Wait before retrying (reduces CPU thrashing on errors)
+                try { await Task.Delay(300, token).ConfigureAwait(false); }
+                catch (OperationCanceledException) { }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // ClientLoop — read lines from one connected client
+        //
+        // Args:
+        //   pipe  - connected server instance (disposed on exit)
+        //   log   - delegate to call with received messages
+        //   token - cancellation token for clean shutdown
+        //
+        // Behavior:
+        //   Reads lines until the client disconnects (EOF) or shutdown
+        // ───────────────────────────────────────────────────────────────
+        private async Task ClientLoop(NamedPipeServerStream pipe, Action<string> log, CancellationToken token)
+        {
+            StreamReader reader = null;
+
+            try
+            {
+                reader = new StreamReader(pipe, Encoding.UTF8, false, LogIngest.ReadBlockBytes, true);
+
+                while (!token.IsCancellationRequested && pipe.IsConnected)
+                {
+                    string line = await reader.ReadLineAsync().ConfigureAwait(false);
+                    if (line == null) break;  // EOF = client disconnected
+                    log(line);
+                }
+
+                log("Client disconnected");
+            }
+            catch (Exception ex)
+            {
+                if (!token.IsCancellationRequested)
+                    log($"Pipe error: {ex.Message}");
+            }
+            finally
+            {
+                try { reader?.Dispose(); } catch { }
+                try { pipe.Dispose(); } catch { }
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // IngestLoop — read one connected client in blocks
+        //
+        // Args:
+        //   pipe  - connected server instance (disposed on exit)
+        //   tag   - which component this pipe serves
+        //   log   - delegate for connection messages (not for the lines)
+        //   token - cancellation token for clean shutdown
+        //
+        // Behavior:
+        //   Every read (up to 64 KB, partial lines included) goes to the
+        //   native ingest; the merge thread writes the lines in order
+        // ───────────────────────────────────────────────────────────────
+        private async Task IngestLoop(NamedPipeServerStream pipe, LogTag tag, Action<string> log, CancellationToken token)
+        {
+            var ingest = _ingest;
+            int source = ingest.Open(tag);
+            var block = new byte[LogIngest.ReadBlockBytes];
+
+            try
+            {
+                while (!token.IsCancellationRequested && pipe.IsConnected)
+                {
+                    int read = await pipe.ReadAsync(block, 0, block.Length, token).ConfigureAwait(false);
+                    if (read == 0) break;  // EOF = client disconnected
+                    ingest.Push(source, block, read);
+                }
+
+                log("Client disconnected");
+            }
+            catch (Exception ex)
+            {
+                if (!token.IsCancellationRequested)
+                    log($"Pipe error: {ex.Message}");
+            }
+            finally
+            {
+                ingest.Close(source);
+                try { pipe.Dispose(); } catch { }
             }
         }
 
@@ -461,6 +593,7 @@ namespace Achikobuddy.Debug
         // Behavior:
         //   • Cancels token → triggers OperationCanceledException in loops
         //   • Waits up to 500ms per task for clean exit
+        //   • Flushes and stops the log merge thread
         //   • Logs warning if tasks don't stop in time (rare)
         //
         // Thread safety:
@@ -484,6 +617,9 @@ namespace Achikobuddy.Debug
                 }
                 catch { /* Task already completed or faulted — ignore */ }
             }
+
+            // Readers are gone — flush what the merger still holds
+            _ingest?.Dispose();
         }
 
         // ═══════════════════════════════════════════════════════════════
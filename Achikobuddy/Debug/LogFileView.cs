@@ -0,0 +1,247 @@
+﻿// LogFileView.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed side of AchikoIngest.dll's saved-log viewer (LogView.h)
+//
+// Responsibilities:
+// • Open a saved Achikobuddy.log of any size without loading it
+// • Report indexing progress (bytes / lines indexed so far)
+// • Return any window of lines, or of lines matching a source filter
+//
+// Architecture:
+// • The DLL memory-maps the file a view at a time and indexes it on its
+//   own thread; this class only copies the visible window into strings
+// • Filter() blocks while the DLL scans in parallel — callers run it
+//   off the UI thread (FilterAsync)
+//
+// Critical Design Decisions:
+// • Memory stays flat: one reusable record + text buffer per instance,
+//   sized for a screen of lines, never for the file
+// • Open() returns null when the DLL is missing or the file cannot be
+//   mapped — the caller reports it, nothing falls back to ReadAllText
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Achikobuddy.Debug
+{
+    // ═══════════════════════════════════════════════════════════════
+    // LogFileView
+    // ═══════════════════════════════════════════════════════════════
+    internal sealed class LogFileView : IDisposable
+    {
+        public const int MaxWindowLines = 1024;
+        private const int WindowTextBytes = 1024 * 1024;
+
+        private readonly object _lock = new object();         // buffers below + _handle
+        private readonly object _filterLock = new object();   // held for a whole Filter scan
+        private readonly ViewLine[] _records = new ViewLine[MaxWindowLines];
+        private readonly byte[] _text = new byte[WindowTextBytes];
+        private IntPtr _handle;
+
+        public string Path { get; }
+
+        // ───────────────────────────────────────────────────────────────
+        // AchikoIngest.dll — keep in sync with AchikoIngest/Exports.cpp
+        // ───────────────────────────────────────────────────────────────
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ViewLine
+        {
+            public ulong Line;
+            public uint Offset;
+            public uint Length;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ViewStatus
+        {
+            public ulong SizeBytes;
+            public ulong IndexedBytes;
+            public ulong Lines;
+            public uint Done;
+            public uint Failed;
+        }
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        private static extern IntPtr AchikoLogOpen(string path);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoLogClose(IntPtr view);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoLogStatus(IntPtr view, out ViewStatus status);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern int AchikoLogRead(IntPtr view, ulong first, [Out] ViewLine[] lines, int maxLines,
+            [Out] byte[] text, int textCapacity);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        private static extern ulong AchikoLogFilter(IntPtr view, string pattern);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern int AchikoLogReadFiltered(IntPtr view, ulong first, [Out] ViewLine[] lines, int maxLines,
+            [Out] byte[] text, int textCapacity);
+
+        private LogFileView(string path, IntPtr handle)
+        {
+            Path = path;
+            _handle = handle;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Open — map a log file and start indexing it
+        //
+        // Returns:
+        //   null if AchikoIngest.dll is unavailable or the file cannot be
+        //   opened (error says which)
+        // ───────────────────────────────────────────────────────────────
+        public static LogFileView Open(string path, out string error)
+        {
+            IntPtr handle;
+            try
+            {
+                handle = AchikoLogOpen(path);
+            }
+            catch (Exception ex)
+            {
+                // DllNotFoundException / BadImageFormatException / EntryPointNotFoundException
+                error = "AchikoIngest.dll unavailable: " + ex.Message;
+                return null;
+            }
+
+            if (handle == IntPtr.Zero)
+            {
+                error = "Cannot open " + path;
+                return null;
+            }
+
+            error = null;
+            return new LogFileView(path, handle);
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Progress — lines readable so far, and whether indexing is done
+        // ───────────────────────────────────────────────────────────────
+        public long Lines => (long)Status().Lines;
+        public bool Indexed => Status().Done != 0;
+        public bool Failed => Status().Failed != 0;
+
+        // 0..1 share of the file indexed
+        public double IndexedFraction
+        {
+            get
+            {
+                ViewStatus status = Status();
+                return status.SizeBytes == 0 ? 1.0 : (double)status.IndexedBytes / status.SizeBytes;
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Read — lines [first, first + count) of the file
+        // ───────────────────────────────────────────────────────────────
+        public string[] Read(long first, int count)
+        {
+            lock (_lock)
+            {
+                if (_handle == IntPtr.Zero)
+                    return new string[0];
+                int got = AchikoLogRead(_handle, (ulong)first, _records, Math.Min(count, MaxWindowLines),
+                                        _text, _text.Length);
+                return Decode(got);
+            }
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Filter — keep lines whose body starts with prefix ("[AchikoDLL]")
+        //
+        // Returns:
+        //   Matching lines (over the lines indexed so far); null / empty
+        //   prefix clears the filter and returns 0
+        //
+        // Notes:
+        //   Blocks for a full scan — use FilterAsync from the UI
+        // ───────────────────────────────────────────────────────────────
+        public long Filter(string prefix)
+        {
+            lock (_filterLock)
+            {
+                IntPtr handle = _handle;
+                if (handle == IntPtr.Zero)
+                    return 0;
+                return (long)AchikoLogFilter(handle, prefix ?? string.Empty);
+            }
+        }
+
+        public Task<long> FilterAsync(string prefix)
+        {
+            return Task.Run(() => Filter(prefix));
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // ReadFiltered — matches [first, first + count) of the last Filter
+        //
+        // Args:
+        //   lineNumbers - [out] file line of each returned match
+        // ───────────────────────────────────────────────────────────────
+        public string[] ReadFiltered(long first, int count, out long[] lineNumbers)
+        {
+            lock (_lock)
+            {
+                lineNumbers = new long[0];
+                if (_handle == IntPtr.Zero)
+                    return new string[0];
+
+                int got = AchikoLogReadFiltered(_handle, (ulong)first, _records, Math.Min(count, MaxWindowLines),
+                                                _text, _text.Length);
+                lineNumbers = new long[got];
+                for (int i = 0; i < got; i++)
+                    lineNumbers[i] = (long)_records[i].Line;
+                return Decode(got);
+            }
+        }
+
+        // Stops indexing and unmaps the file (waits out a running Filter)
+        public void Dispose()
+        {
+            lock (_filterLock)
+            lock (_lock)
+            {
+                if (_handle == IntPtr.Zero)
+                    return;
+                try { AchikoLogClose(_handle); }
+                catch (Exception) { }
+                _handle = IntPtr.Zero;
+            }
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // INTERNALS
+        // ═══════════════════════════════════════════════════════════════
+
+        private ViewStatus Status()
+        {
+            ViewStatus status = default(ViewStatus);
+            lock (_lock)
+            {
+                if (_handle != IntPtr.Zero)
+                    AchikoLogStatus(_handle, out status);
+            }
+            return status;
+        }
+
+        private string[] Decode(int count)
+        {
+            var lines = new string[count];
+            for (int i = 0; i < count; i++)
+                lines[i] = Encoding.UTF8.GetString(_text, (int)_records[i].Offset, (int)_records[i].Length);
+            return lines;
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
@@ -0,0 +1,207 @@
+﻿// LogIngest.cs
+// ─────────────────────────────────────────────────────────────────────────────
+// Managed side of AchikoIngest.dll — block ingest + ordered merge for Bugger
+//
+// Responsibilities:
+// • One native source per connected pipe client (Open / Push / Close)
+// • A merge thread that waits for ordered lines and hands them to Bugger
+//   in batches
+//
+// Architecture:
+// • Bugger's reader tasks read 64 KB blocks straight from the pipe and
+//   Push them — no StreamReader, no per-line strings on the read side
+// • AchikoIngest.dll (native, loaded into Achikobuddy — not injected)
+//   splits lines, parses "[HH:mm:ss.fff]" in place and k-way merges all
+//   sources by that timestamp (LogIngest.h)
+// • The merge thread turns each batch into strings once and calls the sink
+//
+// Critical Design Decisions:
+// • Start() returns false when the DLL is missing or the wrong bitness —
+//   Bugger then keeps its old per-line StreamReader path
+// • Tags mirror LogSource in LogRing.h (0 = RemoteAchiko, 1 = AchikoDLL)
+// • 100% .NET 4.0 / C# 7.3 compatible
+// ─────────────────────────────────────────────────────────────────────────────
+
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+
+namespace Achikobuddy.Debug
+{
+    // Mirrors LogSource in LogRing.h
+    internal enum LogTag
+    {
+        RemoteAchiko = 0,
+        AchikoDLL = 1
+    }
+
+    internal struct IngestedLine
+    {
+        public LogTag Tag;
+        public string Text;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // LogIngest
+    // ═══════════════════════════════════════════════════════════════
+    internal sealed class LogIngest : IDisposable
+    {
+        public const int ReadBlockBytes = 64 * 1024;   // one pipe read → one Push
+
+        private const int ReorderWindowMs = 20;
+        private const int BatchRecords = 4096;
+        private const int BatchTextBytes = 256 * 1024;
+        private const int WaitTimeoutMs = 500;         // stop-check period only
+
+        private readonly Action<IngestedLine[], int> _sink;
+        private readonly IngestRecord[] _records = new IngestRecord[BatchRecords];
+        private readonly byte[] _text = new byte[BatchTextBytes];
+        private readonly IngestedLine[] _lines = new IngestedLine[BatchRecords];
+        private Thread _thread;
+        private volatile bool _running;
+
+        // ───────────────────────────────────────────────────────────────
+        // AchikoIngest.dll — keep in sync with AchikoIngest/Exports.cpp
+        // ───────────────────────────────────────────────────────────────
+        [StructLayout(LayoutKind.Sequential)]
+        private struct IngestRecord
+        {
+            public uint Tag;
+            public uint MsOfDay;
+            public uint Offset;
+            public uint Length;
+        }
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoIngestStart(int reorderWindowMs);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoIngestStop();
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern int AchikoIngestOpen(int tag);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoIngestPush(int source, byte[] data, int length);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void AchikoIngestClose(int source);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern int AchikoIngestWait([Out] IngestRecord[] records, int maxRecords,
+            [Out] byte[] text, int textCapacity, int timeoutMs);
+
+        [DllImport("AchikoIngest.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern ulong AchikoIngestLateLines();
+
+        // ───────────────────────────────────────────────────────────────
+        // Constructor
+        //
+        // Args:
+        //   sink - called on the merge thread with each ordered batch
+        //          (array is reused — copy what you keep)
+        // ───────────────────────────────────────────────────────────────
+        public LogIngest(Action<IngestedLine[], int> sink)
+        {
+            _sink = sink;
+        }
+
+        // ───────────────────────────────────────────────────────────────
+        // Start — arm the native merger and the merge thread
+        //
+        // Returns:
+        //   false if AchikoIngest.dll is unavailable
+        // ───────────────────────────────────────────────────────────────
+        public bool Start()
+        {
+            try
+            {
+                AchikoIngestStart(ReorderWindowMs);
+            }
+            catch (Exception)
+            {
+                // DllNotFoundException / BadImageFormatException (bitness) /
+                // EntryPointNotFoundException
+                return false;
+            }
+
+            _running = true;
+            _thread = new Thread(MergeLoop) { Name = "Achikobuddy log merge", IsBackground = true };
+            _thread.Start();
+            return true;
+        }
+
+        public int Open(LogTag tag)
+        {
+            return AchikoIngestOpen((int)tag);
+        }
+
+        public void Push(int source, byte[] data, int length)
+        {
+            AchikoIngestPush(source, data, length);
+        }
+
+        public void Close(int source)
+        {
+            AchikoIngestClose(source);
+        }
+
+        // Lines that arrived after the reorder window had already let a
+        // later line through
+        public ulong LateLines
+        {
+            get
+            {
+                try { return AchikoIngestLateLines(); }
+                catch (Exception) { return 0; }
+            }
+        }
+
+        // Flushes everything still queued, then stops the merge thread
+        public void Dispose()
+        {
+            if (!_running) return;
+            _running = false;
+
+            try { AchikoIngestStop(); }   // releases AchikoIngestWait
+            catch (Exception) { }
+
+            _thread?.Join(2000);
+            _thread = null;
+        }
+
+        // ═══════════════════════════════════════════════════════════════
+        // MERGE THREAD
+        // ═══════════════════════════════════════════════════════════════
+
+        private void MergeLoop()
+        {
+            for (;;)
+            {
+                int count;
+                try { count = AchikoIngestWait(_records, BatchRecords, _text, BatchTextBytes, WaitTimeoutMs); }
+                catch (Exception) { break; }
+
+                if (count <= 0)
+                {
+                    if (!_running) break;   // stopped and fully flushed
+                    continue;
+                }
+
+                for (int i = 0; i < count; i++)
+                {
+                    _lines[i].Tag = (LogTag)_records[i].Tag;
+                    _lines[i].Text = Encoding.UTF8.GetString(_text, (int)_records[i].Offset, (int)_records[i].Length);
+                }
+
+                try { _sink(_lines, count); }
+                catch (Exception) { /* a faulty sink must not kill the merge thread */ }
+            }
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// END OF FILE
+// ───────────────────────────────────────────────────────────────
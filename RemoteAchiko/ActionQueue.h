@@ -0,0 +1,481 @@
+﻿// ActionQueue.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Latency-compensated action queue — the next cast goes out before the
+// current one ends
+//
+// Responsibilities:
+// • Hold the bot's next decided action (one slot, newest decision wins)
+// • Predict readiness from observed cast starts (cast time / GCD) and
+//   submit the queued action one round trip before it, capped by a
+//   configurable window
+// • Verify every submission: confirmed by its cast start, retried on a
+//   "not ready yet" reply or a missing confirmation
+// • Estimate the client↔server round trip (SRTT / RTTVAR, RFC 6298) from
+//   reported latency and from our own submit → reply times
+// • Idle time between chained casts, kept separately for reactive
+//   (window 0) and queued operation so the two can be compared live
+//
+// Architecture:
+// • Observations (cast start / ready / failed / latency) come from the
+//   game thread, Enqueue from the bot thread, Poll / Wait from one submit
+//   thread — all state behind one mutex, held for a few hundred ns
+// • Every method takes nowNs explicitly; only Wait() reads the clock, so
+//   the core runs unchanged against a simulated client (BenchAction.cpp)
+// • Wait() blocks on a condition variable until ~1 ms before the due
+//   time, then spins the tail (same split as TickPacer)
+//
+// Critical Design Decisions:
+// • The client sees readiness one-way after the server and the action
+//   lands one-way later — a decision made at client readiness idles a
+//   full round trip. Lead = SRTT - 2·RTTVAR - early margin: the
+//   submission should land just after the server is ready, never before
+// • Each early rejection widens the margin (4 ms, capped at the window);
+//   each clean confirmation shrinks it by 1/8 — self-corrects for a
+//   client whose reported latency is optimistic
+// • Idle is only counted when the next action was already queued at
+//   readiness — gaps where the bot had nothing to cast are not latency
+// • Window 0 = reactive: submit only after the client reports readiness.
+//   This is the "before" path the queued numbers are compared against
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "Platform.h"
+
+static const uint64_t kActionDefaultWindowNs = 400000000ULL;     // 400 ms
+static const uint64_t kActionMaxWindowNs = 1000000000ULL;
+static const uint64_t kActionEarlyPenaltyNs = 4000000ULL;        // margin added per early reject
+static const uint64_t kActionConfirmSlackNs = 50000000ULL;       // beyond RTT before a timeout
+static const uint64_t kActionSpinNs = 1000000ULL;                // Wait() spin tail
+static const uint32_t kActionMaxAttempts = 3;
+static const uint32_t kActionIdleSamples = 256;                  // per mode, for percentiles
+static const uint64_t kActionNever = UINT64_MAX;
+
+// ═══════════════════════════════════════════════════════════════
+// Public records
+// ═══════════════════════════════════════════════════════════════
+enum ActionFailReason : uint32_t
+{
+    ActionFail_NotReady = 1,   // server: still casting / on GCD — retried
+    ActionFail_Rejected = 2,   // server: any other error — dropped
+    ActionFail_Local = 3,      // never left the client — dropped, no RTT sample
+};
+
+enum ActionMode : uint32_t
+{
+    ActionMode_Reactive = 0,   // window 0
+    ActionMode_Queued = 1,
+    ActionMode_Count = 2,
+};
+
+// What the submit thread must send now
+struct ActionSubmit
+{
+    uint32_t actionId;
+    uint32_t attempt;          // 1 = first try
+    uint64_t arg;              // caller's payload (target GUID, ...)
+    uint64_t dueNs;            // when it was scheduled
+};
+
+// One mode's counters — layout shared with ActionQueue.cs
+struct ActionStats
+{
+    uint64_t casts;            // confirmed casts
+    uint64_t chained;          // of those, queued before readiness (idle measured)
+    uint64_t idleAvgNs;
+    uint64_t idleP50Ns;        // over the last kActionIdleSamples
+    uint64_t idleP95Ns;
+    uint64_t idleMaxNs;
+    uint64_t earlyRejects;
+    uint64_t rejects;
+    uint64_t timeouts;
+    uint64_t retries;
+    uint64_t dropped;          // gave up after kActionMaxAttempts
+    uint64_t srttNs;           // current estimates (same in both modes)
+    uint64_t rttvarNs;
+    uint64_t leadNs;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ActionQueue
+// ═══════════════════════════════════════════════════════════════
+class ActionQueue
+{
+public:
+    explicit ActionQueue(uint64_t windowNs = kActionDefaultWindowNs)
+        : m_windowNs(std::min(windowNs, kActionMaxWindowNs)),
+          m_srttNs(0), m_rttvarNs(0), m_marginNs(0),
+          m_readyNs(0), m_readyObserved(true), m_haveCast(false),
+          m_queuedAtNs(0), m_hasQueued(false),
+          m_hasPending(false), m_pendingQueuedAtNs(0), m_pendingSubmitNs(0),
+          m_pendingDeadlineNs(0), m_pendingAfterReady(false)
+    {
+        memset(&m_queued, 0, sizeof(m_queued));
+        memset(&m_pending, 0, sizeof(m_pending));
+        memset(m_modes, 0, sizeof(m_modes));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // SetWindow — maximum lead before readiness (0 = reactive)
+    // ───────────────────────────────────────────────────────────────
+    void SetWindow(uint64_t windowNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_windowNs = std::min(windowNs, kActionMaxWindowNs);
+        m_marginNs = std::min(m_marginNs, m_windowNs);
+        m_changed.notify_all();
+    }
+
+    uint64_t WindowNs() const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_windowNs;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // DECISIONS (bot thread)
+    // ═══════════════════════════════════════════════════════════════
+
+    // Replaces any queued, not yet submitted action
+    void Enqueue(uint64_t nowNs, uint32_t actionId, uint64_t arg)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queued.actionId = actionId;
+        m_queued.arg = arg;
+        m_queued.attempt = 0;
+        m_queuedAtNs = nowNs;
+        m_hasQueued = true;
+        m_changed.notify_all();
+    }
+
+    void Cancel()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_hasQueued = false;
+        m_changed.notify_all();
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // OBSERVATIONS (game thread)
+    // ═══════════════════════════════════════════════════════════════
+
+    // Client-reported round trip (the game's own latency figure)
+    void ObserveLatency(uint64_t rttNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        AddRttSample(rttNs);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // ObserveCastStart — the client saw a cast (or instant) start
+    //
+    // Args:
+    //   actionId - what started (confirms our pending submission if equal)
+    //   castNs   - cast time, 0 for instants
+    //   gcdNs    - global cooldown it triggered, 0 if none
+    // ───────────────────────────────────────────────────────────────
+    void ObserveCastStart(uint64_t nowNs, uint32_t actionId, uint64_t castNs, uint64_t gcdNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ModeCounters& mode = m_modes[CurrentMode()];
+
+        if (m_hasPending && m_pending.actionId == actionId)
+        {
+            ++mode.casts;
+
+            // Chained: decided before the previous cast ended
+            if (m_haveCast && m_pendingQueuedAtNs <= m_readyNs)
+            {
+                const uint64_t idle = nowNs > m_readyNs ? nowNs - m_readyNs : 0;
+                ++mode.chained;
+                mode.idleSumNs += idle;
+                mode.idleMaxNs = std::max(mode.idleMaxNs, idle);
+                mode.idle[mode.idleNext++ % kActionIdleSamples] = idle;
+            }
+
+            // Sent after readiness = the server took it immediately, so
+            // submit → start is one clean round trip
+            if (m_pendingAfterReady)
+                AddRttSample(nowNs - m_pendingSubmitNs);
+
+            m_marginNs -= m_marginNs / 8;
+            m_hasPending = false;
+        }
+
+        m_readyNs = nowNs + std::max(castNs, gcdNs);
+        m_readyObserved = false;
+        m_haveCast = true;
+        m_changed.notify_all();
+    }
+
+    // Client readiness (cast bar finished / GCD over) — corrects the
+    // prediction and is the reactive path's trigger
+    void ObserveReady(uint64_t nowNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_readyNs = nowNs;
+        m_readyObserved = true;
+        m_changed.notify_all();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // ObserveFailed — the pending submission failed
+    //
+    // Behavior:
+    //   • NotReady → margin widened, resubmitted now (unless a newer
+    //     decision is queued or attempts are used up)
+    //   • Rejected / Local → dropped
+    // ───────────────────────────────────────────────────────────────
+    void ObserveFailed(uint64_t nowNs, uint32_t actionId, ActionFailReason reason)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_hasPending || m_pending.actionId != actionId)
+            return;
+
+        ModeCounters& mode = m_modes[CurrentMode()];
+        m_hasPending = false;
+
+        if (reason != ActionFail_Local)
+            AddRttSample(nowNs - m_pendingSubmitNs);
+
+        if (reason != ActionFail_NotReady)
+        {
+            if (reason == ActionFail_Rejected)
+                ++mode.rejects;
+            m_changed.notify_all();
+            return;
+        }
+
+        ++mode.earlyRejects;
+        m_marginNs = std::min(m_marginNs + kActionEarlyPenaltyNs, m_windowNs);
+        Retry(mode);
+        m_changed.notify_all();
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // SUBMISSION (submit thread)
+    // ═══════════════════════════════════════════════════════════════
+
+    // When Poll() will next have work (kActionNever = nothing to do)
+    uint64_t DueNs() const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return DueLocked();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Poll — hand out the action to submit at nowNs, if any
+    //
+    // Returns:
+    //   true and fills out; the caller must submit it now and report
+    //   the outcome through ObserveCastStart / ObserveFailed
+    // ───────────────────────────────────────────────────────────────
+    bool Poll(uint64_t nowNs, ActionSubmit& out)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return PollLocked(nowNs, out);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Wait — block until an action is due (or timeoutMs passes)
+    //
+    // Returns:
+    //   true and fills out, as Poll()
+    // ───────────────────────────────────────────────────────────────
+    bool Wait(uint32_t timeoutMs, ActionSubmit& out)
+    {
+        const uint64_t deadline = PlatformNowNs() + (uint64_t)timeoutMs * 1000000ULL;
+        std::unique_lock<std::mutex> guard(m_lock);
+
+        for (;;)
+        {
+            const uint64_t now = PlatformNowNs();
+            if (PollLocked(now, out))
+                return true;
+            if (now >= deadline)
+                return false;
+
+            const uint64_t until = std::min(DueLocked(), deadline);
+            if (until > now + kActionSpinNs)
+            {
+                // Any Enqueue / observation re-evaluates the due time
+                m_changed.wait_for(guard, std::chrono::nanoseconds(until - now - kActionSpinNs));
+            }
+            else
+            {
+                guard.unlock();
+                PlatformCpuRelax();
+                guard.lock();
+            }
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPORTING
+    // ═══════════════════════════════════════════════════════════════
+
+    void Stats(ActionMode which, ActionStats& out) const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const ModeCounters& mode = m_modes[which < ActionMode_Count ? which : ActionMode_Queued];
+        memset(&out, 0, sizeof(out));
+
+        out.casts = mode.casts;
+        out.chained = mode.chained;
+        out.idleAvgNs = mode.chained ? mode.idleSumNs / mode.chained : 0;
+        out.idleMaxNs = mode.idleMaxNs;
+        out.earlyRejects = mode.earlyRejects;
+        out.rejects = mode.rejects;
+        out.timeouts = mode.timeouts;
+        out.retries = mode.retries;
+        out.dropped = mode.dropped;
+        out.srttNs = m_srttNs;
+        out.rttvarNs = m_rttvarNs;
+        out.leadNs = LeadLocked();
+
+        const size_t count = (size_t)std::min<uint64_t>(mode.idleNext, kActionIdleSamples);
+        if (count)
+        {
+            uint64_t sorted[kActionIdleSamples];
+            memcpy(sorted, mode.idle, count * sizeof(uint64_t));
+            std::sort(sorted, sorted + count);
+            out.idleP50Ns = sorted[count / 2];
+            out.idleP95Ns = sorted[std::min(count - 1, count * 95 / 100)];
+        }
+    }
+
+    void ResetStats()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        memset(m_modes, 0, sizeof(m_modes));
+    }
+
+private:
+    struct ModeCounters
+    {
+        uint64_t casts, chained, idleSumNs, idleMaxNs;
+        uint64_t earlyRejects, rejects, timeouts, retries, dropped;
+        uint64_t idleNext;
+        uint64_t idle[kActionIdleSamples];
+    };
+
+    ActionQueue(const ActionQueue&) = delete;
+    ActionQueue& operator=(const ActionQueue&) = delete;
+
+    ActionMode CurrentMode() const { return m_windowNs ? ActionMode_Queued : ActionMode_Reactive; }
+
+    // RFC 6298 smoothing (alpha 1/8, beta 1/4)
+    void AddRttSample(uint64_t rttNs)
+    {
+        if (!m_srttNs)
+        {
+            m_srttNs = rttNs;
+            m_rttvarNs = rttNs / 2;
+            return;
+        }
+        const uint64_t error = rttNs > m_srttNs ? rttNs - m_srttNs : m_srttNs - rttNs;
+        m_rttvarNs = m_rttvarNs - m_rttvarNs / 4 + error / 4;
+        m_srttNs = m_srttNs - m_srttNs / 8 + rttNs / 8;
+    }
+
+    uint64_t LeadLocked() const
+    {
+        const uint64_t guardNs = 2 * m_rttvarNs + m_marginNs;
+        const uint64_t lead = m_srttNs > guardNs ? m_srttNs - guardNs : 0;
+        return std::min(lead, m_windowNs);
+    }
+
+    uint64_t DueLocked() const
+    {
+        if (m_hasPending)
+            return m_pendingDeadlineNs;          // timeout check
+        if (!m_hasQueued)
+            return kActionNever;
+        if (m_readyObserved)
+            return m_readyNs;                    // ready now (or never cast)
+        if (!m_windowNs)
+            return kActionNever;                 // reactive: wait for ObserveReady
+        const uint64_t lead = LeadLocked();
+        return m_readyNs > lead ? m_readyNs - lead : 0;
+    }
+
+    bool PollLocked(uint64_t nowNs, ActionSubmit& out)
+    {
+        const uint64_t due = DueLocked();
+        if (due == kActionNever || nowNs < due)
+            return false;
+
+        if (m_hasPending)
+        {
+            // No confirmation in time — lost, or the client ignored it
+            ModeCounters& mode = m_modes[CurrentMode()];
+            ++mode.timeouts;
+            m_hasPending = false;
+            Retry(mode);
+            if (!m_hasQueued || DueLocked() > nowNs)
+                return false;
+        }
+
+        m_pending = m_queued;
+        m_pending.attempt += 1;
+        m_pending.dueNs = due;
+        m_pendingQueuedAtNs = m_queuedAtNs;
+        m_pendingSubmitNs = nowNs;
+        m_pendingAfterReady = m_readyObserved;
+        m_pendingDeadlineNs = std::max(nowNs, m_readyNs) + 2 * m_srttNs + 4 * m_rttvarNs + kActionConfirmSlackNs;
+        m_hasPending = true;
+        m_hasQueued = false;
+
+        out = m_pending;
+        return true;
+    }
+
+    // Put the failed pending action back in the slot (caller cleared
+    // m_hasPending) — a newer decision already queued takes precedence
+    void Retry(ModeCounters& mode)
+    {
+        if (m_hasQueued)
+            return;
+        if (m_pending.attempt >= kActionMaxAttempts)
+        {
+            ++mode.dropped;
+            return;
+        }
+        ++mode.retries;
+        m_queued = m_pending;
+        m_queuedAtNs = m_pendingQueuedAtNs;
+        m_hasQueued = true;
+    }
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_changed;
+
+    uint64_t m_windowNs;
+    uint64_t m_srttNs;
+    uint64_t m_rttvarNs;
+    uint64_t m_marginNs;                 // learned from early rejects
+
+    uint64_t m_readyNs;                  // predicted (or observed) client readiness
+    bool m_readyObserved;
+    bool m_haveCast;
+
+    ActionSubmit m_queued;
+    uint64_t m_queuedAtNs;
+    bool m_hasQueued;
+
+    ActionSubmit m_pending;              // submitted, awaiting verification
+    bool m_hasPending;
+    uint64_t m_pendingQueuedAtNs;
+    uint64_t m_pendingSubmitNs;
+    uint64_t m_pendingDeadlineNs;
+    bool m_pendingAfterReady;
+
+    ModeCounters m_modes[ActionMode_Count];
+};
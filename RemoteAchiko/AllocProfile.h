@@ -0,0 +1,188 @@
+﻿// AllocProfile.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Allocation sampling core — byte-interval sampler + per-site table
+//
+// Responsibilities:
+// • AllocCountdown: decide, per allocation, whether it is sampled
+// • AllocSiteTable: aggregate sampled allocations by (type, site, caller)
+// • Top-N snapshot for reporting
+//
+// Architecture:
+// • Header-only, no OS calls — the CLR profiler callback (AllocProfiler.cpp)
+//   drives it on Windows, RemoteAchikoBench measures it on Linux
+// • Byte-interval sampling: one sample every ~kAllocSampleBytes allocated
+//   on a thread; each sample stands for that many bytes, so large objects
+//   are sampled proportionally more often than small ones
+// • Interval jittered ±50% — a fixed interval aliases with allocation
+//   loops of the same period and always blames the same object
+//
+// Critical Design Decisions:
+// • Fixed-capacity open-addressing table — Record() runs inside the CLR's
+//   allocation callback and must not allocate
+// • Full table counts the sample as dropped instead of evicting
+// • One spinlock for the table — sampled allocations are rare (a few
+//   per second per thread), contention is not a concern
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "Platform.h"
+
+static const uint32_t kAllocSampleBytes = 64 * 1024;
+static const uint32_t kAllocSiteCapacity = 4096;   // power of two
+
+// ═══════════════════════════════════════════════════════════════
+// AllocSite — one aggregated (type, allocating method, caller) triple
+// ═══════════════════════════════════════════════════════════════
+struct AllocSite
+{
+    uintptr_t typeId;     // ClassID on the CLR side
+    uintptr_t site;       // FunctionID of the allocating method, 0 = unknown
+    uintptr_t caller;     // FunctionID of its caller, 0 = unknown
+    uint64_t samples;
+    uint64_t bytes;       // estimated: samples × interval, not exact
+};
+
+// ═══════════════════════════════════════════════════════════════
+// AllocCountdown — per-thread sampling decision
+// ═══════════════════════════════════════════════════════════════
+struct AllocCountdown
+{
+    int64_t remaining;
+    uint32_t rng;
+
+    AllocCountdown() : remaining(0), rng(0) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Take — account one allocation
+    //
+    // Returns:
+    //   Bytes this allocation stands for (0 = not sampled)
+    // ───────────────────────────────────────────────────────────────
+    uint64_t Take(uint32_t size, uint32_t interval)
+    {
+        remaining -= size;
+        if (remaining > 0)
+            return 0;
+
+        // Every whole interval crossed belongs to this sample
+        uint64_t weight = 0;
+        while (remaining <= 0)
+        {
+            remaining += NextInterval(interval);
+            weight += interval;
+        }
+        return weight;
+    }
+
+private:
+    int64_t NextInterval(uint32_t interval)
+    {
+        if (rng == 0)
+            rng = (uint32_t)(uintptr_t)this | 1u;
+        rng ^= rng << 13;                       // xorshift32
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return (int64_t)(interval / 2) + (int64_t)(rng % (interval + 1));
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════
+// AllocSiteTable — fixed-capacity aggregation
+// ═══════════════════════════════════════════════════════════════
+class AllocSiteTable
+{
+public:
+    AllocSiteTable() : m_dropped(0), m_used(0)
+    {
+        m_lock.clear();
+        memset(m_sites, 0, sizeof(m_sites));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Record — add one sample (no allocation, safe in CLR callbacks)
+    // ───────────────────────────────────────────────────────────────
+    void Record(uintptr_t typeId, uintptr_t site, uintptr_t caller, uint64_t bytes)
+    {
+        uint64_t h = (uint64_t)typeId * 0x9E3779B97F4A7C15ULL;
+        h ^= (uint64_t)site * 0xC2B2AE3D27D4EB4FULL;
+        h ^= (uint64_t)caller * 0x165667B19E3779F9ULL;
+        uint32_t index = (uint32_t)(h ^ (h >> 29)) & (kAllocSiteCapacity - 1);
+
+        Lock();
+        for (uint32_t probe = 0; probe < kAllocSiteCapacity; ++probe)
+        {
+            AllocSite& s = m_sites[index];
+            if (s.samples == 0)
+            {
+                if (m_used >= kAllocSiteCapacity * 3 / 4)
+                    break;
+                s.typeId = typeId;
+                s.site = site;
+                s.caller = caller;
+                ++m_used;
+            }
+            if (s.typeId == typeId && s.site == site && s.caller == caller)
+            {
+                s.samples++;
+                s.bytes += bytes;
+                Unlock();
+                return;
+            }
+            index = (index + 1) & (kAllocSiteCapacity - 1);
+        }
+        m_dropped++;
+        Unlock();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Top — the n heaviest sites by estimated bytes
+    // ───────────────────────────────────────────────────────────────
+    void Top(size_t n, std::vector<AllocSite>& out)
+    {
+        out.clear();
+        Lock();
+        for (uint32_t i = 0; i < kAllocSiteCapacity; ++i)
+        {
+            if (m_sites[i].samples != 0)
+                out.push_back(m_sites[i]);
+        }
+        Unlock();
+
+        std::sort(out.begin(), out.end(),
+            [](const AllocSite& a, const AllocSite& b) { return a.bytes > b.bytes; });
+        if (out.size() > n)
+            out.resize(n);
+    }
+
+    void Clear()
+    {
+        Lock();
+        memset(m_sites, 0, sizeof(m_sites));
+        m_used = 0;
+        m_dropped = 0;
+        Unlock();
+    }
+
+    uint64_t Dropped() const { return m_dropped; }
+
+private:
+    void Lock()
+    {
+        while (m_lock.test_and_set(std::memory_order_acquire))
+            PlatformCpuRelax();
+    }
+
+    void Unlock() { m_lock.clear(std::memory_order_release); }
+
+    std::atomic_flag m_lock;
+    uint64_t m_dropped;
+    uint32_t m_used;
+    AllocSite m_sites[kAllocSiteCapacity];
+};
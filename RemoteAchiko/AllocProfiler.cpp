@@ -0,0 +1,525 @@
+﻿// AllocProfiler.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// CLR allocation profiler implementation (see AllocProfiler.h)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "AllocProfiler.h"
+
+#include <cor.h>
+#include <corprof.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AllocProfile.h"
+
+// ═══════════════════════════════════════════════════════════════
+// IDENTITY
+// ═══════════════════════════════════════════════════════════════
+
+// {CD6899B1-9228-4B06-B6B8-8908DC4600B4}
+static const CLSID kClsidAllocProfiler =
+    { 0xcd6899b1, 0x9228, 0x4b06, { 0xb6, 0xb8, 0x89, 0x08, 0xdc, 0x46, 0x00, 0xb4 } };
+static const wchar_t kClsidAllocProfilerString[] = L"{CD6899B1-9228-4B06-B6B8-8908DC4600B4}";
+
+// cor.h declares IID_IMetaDataImport extern (corguids.lib) — keep our own copy
+static const IID kIidMetaDataImport =
+    { 0x7dac8207, 0xd3ae, 0x4c75, { 0x9b, 0x67, 0x92, 0x80, 0x1a, 0x49, 0x7d, 0x44 } };
+
+static const uint32_t kAllocSnapshotFrames = 2;   // allocating method + caller
+
+// ═══════════════════════════════════════════════════════════════
+// STATE
+// ═══════════════════════════════════════════════════════════════
+
+static ICorProfilerInfo2* g_allocInfo = nullptr;      // set in Initialize, never released
+static std::atomic<bool> g_allocActive(false);
+static std::atomic<uint64_t> g_allocBytes(0);         // exact totals since Reset
+static std::atomic<uint64_t> g_allocObjects(0);
+static std::atomic<uint64_t> g_allocSamples(0);
+static std::atomic<uint64_t> g_allocSinceNs(0);
+static AllocSiteTable* g_allocSites = nullptr;        // ~160 KB, allocated only when armed
+
+static thread_local AllocCountdown t_allocCountdown;
+
+// ═══════════════════════════════════════════════════════════════
+// OPT-IN + ENVIRONMENT
+// ═══════════════════════════════════════════════════════════════
+
+bool AllocProfilerRequested()
+{
+    wchar_t name[64];
+    swprintf_s(name, L"AchikoAllocProfiler_PID_%lu", GetCurrentProcessId());
+
+    HANDLE flag = OpenEventW(SYNCHRONIZE, FALSE, name);
+    if (!flag)
+        return false;
+
+    CloseHandle(flag);
+    return true;
+}
+
+bool AllocProfilerArm(HMODULE self)
+{
+    wchar_t path[MAX_PATH];
+    const DWORD length = GetModuleFileNameW(self, path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH)
+        return false;
+
+    if (!g_allocSites)
+        g_allocSites = new AllocSiteTable();
+
+    return SetEnvironmentVariableW(L"COR_ENABLE_PROFILING", L"1") &&
+        SetEnvironmentVariableW(L"COR_PROFILER", kClsidAllocProfilerString) &&
+        SetEnvironmentVariableW(L"COR_PROFILER_PATH", path);
+}
+
+void AllocProfilerDisarm()
+{
+    SetEnvironmentVariableW(L"COR_ENABLE_PROFILING", nullptr);
+    SetEnvironmentVariableW(L"COR_PROFILER", nullptr);
+    SetEnvironmentVariableW(L"COR_PROFILER_PATH", nullptr);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// STACK SNAPSHOT
+// ═══════════════════════════════════════════════════════════════
+
+struct SnapshotFrames
+{
+    FunctionID ids[kAllocSnapshotFrames];
+    uint32_t count;
+};
+
+// ───────────────────────────────────────────────────────────────
+// SnapshotCallback — collect the first managed frames (leaf first)
+//
+// Notes:
+//   funcId 0 = native block (the allocation helper itself) — skipped
+// ───────────────────────────────────────────────────────────────
+static HRESULT __stdcall SnapshotCallback(FunctionID funcId, UINT_PTR ip, COR_PRF_FRAME_INFO frameInfo,
+    ULONG32 contextSize, BYTE context[], void* clientData)
+{
+    (void)ip; (void)frameInfo; (void)contextSize; (void)context;
+    if (funcId == 0)
+        return S_OK;
+
+    SnapshotFrames* frames = (SnapshotFrames*)clientData;
+    frames->ids[frames->count++] = funcId;
+    return frames->count < kAllocSnapshotFrames ? S_OK : S_FALSE;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// AllocCallback — ICorProfilerCallback2, only ObjectAllocated does work
+// ═══════════════════════════════════════════════════════════════
+class AllocCallback : public ICorProfilerCallback2
+{
+public:
+    AllocCallback() : m_refs(1) {}
+
+    // ───────────────────────────────────────────────────────────
+    // IUnknown — never deleted (the CLR may call us until exit)
+    // ───────────────────────────────────────────────────────────
+    STDMETHODIMP QueryInterface(REFIID iid, void** object) override
+    {
+        if (!object)
+            return E_POINTER;
+
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(ICorProfilerCallback) ||
+            iid == __uuidof(ICorProfilerCallback2))
+        {
+            *object = static_cast<ICorProfilerCallback2*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    STDMETHODIMP_(ULONG) AddRef() override { return (ULONG)++m_refs; }
+    STDMETHODIMP_(ULONG) Release() override { return (ULONG)--m_refs; }
+
+    // ───────────────────────────────────────────────────────────
+    // Initialize — subscribe to allocations + allow stack snapshots
+    // ───────────────────────────────────────────────────────────
+    STDMETHODIMP Initialize(IUnknown* infoUnknown) override
+    {
+        ICorProfilerInfo2* info = nullptr;
+        if (!infoUnknown || !g_allocSites ||
+            FAILED(infoUnknown->QueryInterface(__uuidof(ICorProfilerInfo2), (void**)&info)))
+            return E_FAIL;
+
+        const HRESULT hr = info->SetEventMask(COR_PRF_MONITOR_OBJECT_ALLOCATED |
+            COR_PRF_ENABLE_OBJECT_ALLOCATED | COR_PRF_ENABLE_STACK_SNAPSHOT);
+        if (FAILED(hr))
+        {
+            info->Release();
+            return hr;
+        }
+
+        g_allocInfo = info;
+        g_allocSinceNs.store(PlatformNowNs(), std::memory_order_relaxed);
+        g_allocActive.store(true, std::memory_order_release);
+        return S_OK;
+    }
+
+    STDMETHODIMP Shutdown() override
+    {
+        g_allocActive.store(false, std::memory_order_release);
+        return S_OK;
+    }
+
+    // ───────────────────────────────────────────────────────────
+    // ObjectAllocated — runs on the allocating thread for EVERY object
+    //
+    // Fast path: object size + two relaxed adds + countdown
+    // Sampled:   one synchronous stack snapshot + table insert
+    // ───────────────────────────────────────────────────────────
+    STDMETHODIMP ObjectAllocated(ObjectID objectId, ClassID classId) override
+    {
+        ULONG size = 0;
+        if (!g_allocActive.load(std::memory_order_relaxed) ||
+            FAILED(g_allocInfo->GetObjectSize(objectId, &size)))
+            return S_OK;
+
+        g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+        g_allocObjects.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t weight = t_allocCountdown.Take((uint32_t)size, kAllocSampleBytes);
+        if (weight == 0)
+            return S_OK;
+
+        SnapshotFrames frames;
+        memset(&frames, 0, sizeof(frames));
+        g_allocInfo->DoStackSnapshot(0, SnapshotCallback, COR_PRF_SNAPSHOT_DEFAULT, &frames, nullptr, 0);
+
+        g_allocSites->Record(classId, frames.ids[0], frames.ids[1], weight);
+        g_allocSamples.fetch_add(1, std::memory_order_relaxed);
+        return S_OK;
+    }
+
+    // ───────────────────────────────────────────────────────────
+    // Everything else — not subscribed, never called with our mask
+    // ───────────────────────────────────────────────────────────
+    STDMETHODIMP AppDomainCreationStarted(AppDomainID) override { return S_OK; }
+    STDMETHODIMP AppDomainCreationFinished(AppDomainID, HRESULT) override { return S_OK; }
+    STDMETHODIMP AppDomainShutdownStarted(AppDomainID) override { return S_OK; }
+    STDMETHODIMP AppDomainShutdownFinished(AppDomainID, HRESULT) override { return S_OK; }
+    STDMETHODIMP AssemblyLoadStarted(AssemblyID) override { return S_OK; }
+    STDMETHODIMP AssemblyLoadFinished(AssemblyID, HRESULT) override { return S_OK; }
+    STDMETHODIMP AssemblyUnloadStarted(AssemblyID) override { return S_OK; }
+    STDMETHODIMP AssemblyUnloadFinished(AssemblyID, HRESULT) override { return S_OK; }
+    STDMETHODIMP ModuleLoadStarted(ModuleID) override { return S_OK; }
+    STDMETHODIMP ModuleLoadFinished(ModuleID, HRESULT) override { return S_OK; }
+    STDMETHODIMP ModuleUnloadStarted(ModuleID) override { return S_OK; }
+    STDMETHODIMP ModuleUnloadFinished(ModuleID, HRESULT) override { return S_OK; }
+    STDMETHODIMP ModuleAttachedToAssembly(ModuleID, AssemblyID) override { return S_OK; }
+    STDMETHODIMP ClassLoadStarted(ClassID) override { return S_OK; }
+    STDMETHODIMP ClassLoadFinished(ClassID, HRESULT) override { return S_OK; }
+    STDMETHODIMP ClassUnloadStarted(ClassID) override { return S_OK; }
+    STDMETHODIMP ClassUnloadFinished(ClassID, HRESULT) override { return S_OK; }
+    STDMETHODIMP FunctionUnloadStarted(FunctionID) override { return S_OK; }
+    STDMETHODIMP JITCompilationStarted(FunctionID, BOOL) override { return S_OK; }
+    STDMETHODIMP JITCompilationFinished(FunctionID, HRESULT, BOOL) override { return S_OK; }
+    STDMETHODIMP JITCachedFunctionSearchStarted(FunctionID, BOOL*) override { return S_OK; }
+    STDMETHODIMP JITCachedFunctionSearchFinished(FunctionID, COR_PRF_JIT_CACHE) override { return S_OK; }
+    STDMETHODIMP JITFunctionPitched(FunctionID) override { return S_OK; }
+    STDMETHODIMP JITInlining(FunctionID, FunctionID, BOOL*) override { return S_OK; }
+    STDMETHODIMP ThreadCreated(ThreadID) override { return S_OK; }
+    STDMETHODIMP ThreadDestroyed(ThreadID) override { return S_OK; }
+    STDMETHODIMP ThreadAssignedToOSThread(ThreadID, DWORD) override { return S_OK; }
+    STDMETHODIMP RemotingClientInvocationStarted() override { return S_OK; }
+    STDMETHODIMP RemotingClientSendingMessage(GUID*, BOOL) override { return S_OK; }
+    STDMETHODIMP RemotingClientReceivingReply(GUID*, BOOL) override { return S_OK; }
+    STDMETHODIMP RemotingClientInvocationFinished() override { return S_OK; }
+    STDMETHODIMP RemotingServerReceivingMessage(GUID*, BOOL) override { return S_OK; }
+    STDMETHODIMP RemotingServerInvocationStarted() override { return S_OK; }
+    STDMETHODIMP RemotingServerInvocationReturned() override { return S_OK; }
+    STDMETHODIMP RemotingServerSendingReply(GUID*, BOOL) override { return S_OK; }
+    STDMETHODIMP UnmanagedToManagedTransition(FunctionID, COR_PRF_TRANSITION_REASON) override { return S_OK; }
+    STDMETHODIMP ManagedToUnmanagedTransition(FunctionID, COR_PRF_TRANSITION_REASON) override { return S_OK; }
+    STDMETHODIMP RuntimeSuspendStarted(COR_PRF_SUSPEND_REASON) override { return S_OK; }
+    STDMETHODIMP RuntimeSuspendFinished() override { return S_OK; }
+    STDMETHODIMP RuntimeSuspendAborted() override { return S_OK; }
+    STDMETHODIMP RuntimeResumeStarted() override { return S_OK; }
+    STDMETHODIMP RuntimeResumeFinished() override { return S_OK; }
+    STDMETHODIMP RuntimeThreadSuspended(ThreadID) override { return S_OK; }
+    STDMETHODIMP RuntimeThreadResumed(ThreadID) override { return S_OK; }
+    STDMETHODIMP MovedReferences(ULONG, ObjectID[], ObjectID[], ULONG[]) override { return S_OK; }
+    STDMETHODIMP ObjectsAllocatedByClass(ULONG, ClassID[], ULONG[]) override { return S_OK; }
+    STDMETHODIMP ObjectReferences(ObjectID, ClassID, ULONG, ObjectID[]) override { return S_OK; }
+    STDMETHODIMP RootReferences(ULONG, ObjectID[]) override { return S_OK; }
+    STDMETHODIMP ExceptionThrown(ObjectID) override { return S_OK; }
+    STDMETHODIMP ExceptionSearchFunctionEnter(FunctionID) override { return S_OK; }
+    STDMETHODIMP ExceptionSearchFunctionLeave() override { return S_OK; }
+    STDMETHODIMP ExceptionSearchFilterEnter(FunctionID) override { return S_OK; }
+    STDMETHODIMP ExceptionSearchFilterLeave() override { return S_OK; }
+    STDMETHODIMP ExceptionSearchCatcherFound(FunctionID) override { return S_OK; }
+    STDMETHODIMP ExceptionOSHandlerEnter(UINT_PTR) override { return S_OK; }
+    STDMETHODIMP ExceptionOSHandlerLeave(UINT_PTR) override { return S_OK; }
+    STDMETHODIMP ExceptionUnwindFunctionEnter(FunctionID) override { return S_OK; }
+    STDMETHODIMP ExceptionUnwindFunctionLeave() override { return S_OK; }
+    STDMETHODIMP ExceptionUnwindFinallyEnter(FunctionID) override { return S_OK; }
+    STDMETHODIMP ExceptionUnwindFinallyLeave() override { return S_OK; }
+    STDMETHODIMP ExceptionCatcherEnter(FunctionID, ObjectID) override { return S_OK; }
+    STDMETHODIMP ExceptionCatcherLeave() override { return S_OK; }
+    STDMETHODIMP COMClassicVTableCreated(ClassID, REFGUID, void*, ULONG) override { return S_OK; }
+    STDMETHODIMP COMClassicVTableDestroyed(ClassID, REFGUID, void*) override { return S_OK; }
+    STDMETHODIMP ExceptionCLRCatcherFound() override { return S_OK; }
+    STDMETHODIMP ExceptionCLRCatcherExecute() override { return S_OK; }
+    STDMETHODIMP ThreadNameChanged(ThreadID, ULONG, WCHAR[]) override { return S_OK; }
+    STDMETHODIMP GarbageCollectionStarted(int, BOOL[], COR_PRF_GC_REASON) override { return S_OK; }
+    STDMETHODIMP SurvivingReferences(ULONG, ObjectID[], ULONG[]) override { return S_OK; }
+    STDMETHODIMP GarbageCollectionFinished() override { return S_OK; }
+    STDMETHODIMP FinalizeableObjectQueued(DWORD, ObjectID) override { return S_OK; }
+    STDMETHODIMP RootReferences2(ULONG, ObjectID[], COR_PRF_GC_ROOT_KIND[], COR_PRF_GC_ROOT_FLAGS[], UINT_PTR[]) override { return S_OK; }
+    STDMETHODIMP HandleCreated(GCHandleID, ObjectID) override { return S_OK; }
+    STDMETHODIMP HandleDestroyed(GCHandleID) override { return S_OK; }
+
+private:
+    std::atomic<long> m_refs;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// AllocClassFactory — hands the CLR our single callback object
+// ═══════════════════════════════════════════════════════════════
+class AllocClassFactory : public IClassFactory
+{
+public:
+    STDMETHODIMP QueryInterface(REFIID iid, void** object) override
+    {
+        if (!object)
+            return E_POINTER;
+
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(IClassFactory))
+        {
+            *object = static_cast<IClassFactory*>(this);
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    STDMETHODIMP_(ULONG) AddRef() override { return 2; }    // static lifetime
+    STDMETHODIMP_(ULONG) Release() override { return 1; }
+
+    STDMETHODIMP CreateInstance(IUnknown* outer, REFIID iid, void** object) override
+    {
+        if (outer)
+            return CLASS_E_NOAGGREGATION;
+
+        static AllocCallback* s_callback = new AllocCallback();
+        return s_callback->QueryInterface(iid, object);
+    }
+
+    STDMETHODIMP LockServer(BOOL) override { return S_OK; }
+};
+
+HRESULT AllocProfilerGetClassObject(REFCLSID clsid, REFIID iid, void** object)
+{
+    if (!object)
+        return E_POINTER;
+
+    if (clsid != kClsidAllocProfiler)
+    {
+        *object = nullptr;
+        return CLASS_E_CLASSNOTAVAILABLE;
+    }
+
+    static AllocClassFactory s_factory;
+    return s_factory.QueryInterface(iid, object);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CONTROL
+// ═══════════════════════════════════════════════════════════════
+
+bool AllocProfilerActive()
+{
+    return g_allocActive.load(std::memory_order_acquire);
+}
+
+void AllocProfilerReset()
+{
+    if (!g_allocSites)
+        return;
+
+    g_allocSites->Clear();
+    g_allocBytes.store(0, std::memory_order_relaxed);
+    g_allocObjects.store(0, std::memory_order_relaxed);
+    g_allocSamples.store(0, std::memory_order_relaxed);
+    g_allocSinceNs.store(PlatformNowNs(), std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// REPORT — metadata name resolution
+// ═══════════════════════════════════════════════════════════════
+
+static std::mutex g_allocReportLock;
+static std::unordered_map<uintptr_t, std::string> g_allocNames;   // FunctionID / ClassID → name
+
+static std::string Utf8(const WCHAR* text)
+{
+    char buffer[512];
+    const int n = WideCharToMultiByte(CP_UTF8, 0, text, -1, buffer, sizeof(buffer), nullptr, nullptr);
+    return n > 0 ? std::string(buffer) : std::string("?");
+}
+
+// ───────────────────────────────────────────────────────────────
+// TypeDefName — "Namespace.Type" from module metadata
+// ───────────────────────────────────────────────────────────────
+static std::string TypeDefName(ModuleID module, mdTypeDef typeDef)
+{
+    IMetaDataImport* metadata = nullptr;
+    if (FAILED(g_allocInfo->GetModuleMetaData(module, ofRead, kIidMetaDataImport, (IUnknown**)&metadata)))
+        return "?";
+
+    WCHAR name[256];
+    ULONG length = 0;
+    const HRESULT hr = metadata->GetTypeDefProps(typeDef, name, 256, &length, nullptr, nullptr);
+    metadata->Release();
+    return SUCCEEDED(hr) ? Utf8(name) : std::string("?");
+}
+
+static const char* PrimitiveName(CorElementType type)
+{
+    switch (type)
+    {
+    case ELEMENT_TYPE_BOOLEAN: return "System.Boolean";
+    case ELEMENT_TYPE_CHAR: return "System.Char";
+    case ELEMENT_TYPE_I1: return "System.SByte";
+    case ELEMENT_TYPE_U1: return "System.Byte";
+    case ELEMENT_TYPE_I2: return "System.Int16";
+    case ELEMENT_TYPE_U2: return "System.UInt16";
+    case ELEMENT_TYPE_I4: return "System.Int32";
+    case ELEMENT_TYPE_U4: return "System.UInt32";
+    case ELEMENT_TYPE_I8: return "System.Int64";
+    case ELEMENT_TYPE_U8: return "System.UInt64";
+    case ELEMENT_TYPE_R4: return "System.Single";
+    case ELEMENT_TYPE_R8: return "System.Double";
+    case ELEMENT_TYPE_I: return "System.IntPtr";
+    case ELEMENT_TYPE_U: return "System.UIntPtr";
+    default: return "?";
+    }
+}
+
+static std::string ClassName(ClassID classId, int depth = 0)
+{
+    std::unordered_map<uintptr_t, std::string>::iterator cached = g_allocNames.find(classId);
+    if (cached != g_allocNames.end())
+        return cached->second;
+
+    std::string name;
+    CorElementType elementType;
+    ClassID elementClass = 0;
+    ULONG rank = 0;
+    ModuleID module = 0;
+    mdTypeDef typeDef = 0;
+
+    if (g_allocInfo->IsArrayClass(classId, &elementType, &elementClass, &rank) == S_OK)
+    {
+        name = (elementClass && depth < 4) ? ClassName(elementClass, depth + 1) : PrimitiveName(elementType);
+        name += rank > 1 ? std::string("[") + std::string(rank - 1, ',') + "]" : std::string("[]");
+    }
+    else if (SUCCEEDED(g_allocInfo->GetClassIDInfo(classId, &module, &typeDef)) && typeDef != 0)
+        name = TypeDefName(module, typeDef);
+    else
+        name = "[type]";
+
+    g_allocNames[classId] = name;
+    return name;
+}
+
+// ───────────────────────────────────────────────────────────────
+// FunctionName — "Namespace.Type.Method"
+// ───────────────────────────────────────────────────────────────
+static std::string FunctionName(FunctionID functionId)
+{
+    if (functionId == 0)
+        return "[unknown]";
+
+    std::unordered_map<uintptr_t, std::string>::iterator cached = g_allocNames.find(functionId);
+    if (cached != g_allocNames.end())
+        return cached->second;
+
+    std::string name = "?";
+    ClassID classId = 0;
+    ModuleID module = 0;
+    mdToken token = 0;
+    IMetaDataImport* metadata = nullptr;
+
+    if (SUCCEEDED(g_allocInfo->GetFunctionInfo(functionId, &classId, &module, &token)) &&
+        SUCCEEDED(g_allocInfo->GetModuleMetaData(module, ofRead, kIidMetaDataImport, (IUnknown**)&metadata)))
+    {
+        WCHAR method[256];
+        ULONG length = 0;
+        mdTypeDef typeDef = 0;
+        if (SUCCEEDED(metadata->GetMethodProps(token, &typeDef, method, 256, &length,
+            nullptr, nullptr, nullptr, nullptr, nullptr)))
+            name = TypeDefName(module, typeDef) + "." + Utf8(method);
+        metadata->Release();
+    }
+
+    g_allocNames[functionId] = name;
+    return name;
+}
+
+// ───────────────────────────────────────────────────────────────
+// FormatBytes — "812 B", "64.0 KB", "12.3 MB"
+// ───────────────────────────────────────────────────────────────
+static void FormatBytes(char* out, size_t capacity, double bytes)
+{
+    if (bytes >= 1024.0 * 1024.0)
+        sprintf_s(out, capacity, "%.1f MB", bytes / (1024.0 * 1024.0));
+    else if (bytes >= 1024.0)
+        sprintf_s(out, capacity, "%.1f KB", bytes / 1024.0);
+    else
+        sprintf_s(out, capacity, "%.0f B", bytes);
+}
+
+size_t AllocProfilerReport(char* out, size_t capacity, uint32_t topN)
+{
+    if (!out || capacity == 0)
+        return 0;
+    out[0] = '\0';
+    if (!AllocProfilerActive())
+        return 0;
+
+    std::lock_guard<std::mutex> guard(g_allocReportLock);
+
+    std::vector<AllocSite> sites;
+    g_allocSites->Top(topN, sites);
+
+    const uint64_t bytes = g_allocBytes.load(std::memory_order_relaxed);
+    const uint64_t objects = g_allocObjects.load(std::memory_order_relaxed);
+    const uint64_t samples = g_allocSamples.load(std::memory_order_relaxed);
+    const double seconds = (double)(PlatformNowNs() - g_allocSinceNs.load(std::memory_order_relaxed)) / 1e9;
+    const double sampledBytes = (double)samples * kAllocSampleBytes;
+
+    std::string report;
+    char line[1024], total[32], rate[32], share[32];
+
+    FormatBytes(total, sizeof(total), (double)bytes);
+    FormatBytes(rate, sizeof(rate), seconds > 0 ? bytes / seconds : 0);
+    sprintf_s(line, "allocated %s in %.1f s (%s/s, %.0f obj/s), %llu samples @ %u KB, %llu dropped\n",
+        total, seconds, rate, seconds > 0 ? objects / seconds : 0.0,
+        (unsigned long long)samples, kAllocSampleBytes / 1024, (unsigned long long)g_allocSites->Dropped());
+    report += line;
+
+    for (size_t i = 0; i < sites.size(); ++i)
+    {
+        const AllocSite& s = sites[i];
+        FormatBytes(share, sizeof(share), (double)s.bytes);
+        sprintf_s(line, "#%u %s %.0f%% %s <- %s <- %s\n", (unsigned)(i + 1), share,
+            sampledBytes > 0 ? 100.0 * s.bytes / sampledBytes : 0.0,
+            ClassName(s.typeId).c_str(), FunctionName(s.site).c_str(), FunctionName(s.caller).c_str());
+        report += line;
+    }
+
+    size_t length = report.size() < capacity - 1 ? report.size() : capacity - 1;
+    memcpy(out, report.data(), length);
+    out[length] = '\0';
+    return length;
+}
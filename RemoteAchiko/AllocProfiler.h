@@ -0,0 +1,89 @@
+﻿// AllocProfiler.h
+// ─────────────────────────────────────────────────────────────────────────────
+// CLR allocation profiler hosted by the bootstrapper (Windows only)
+//
+// Responsibilities:
+// • Opt-in check: the launcher signals "profile allocations" per PID
+// • Arm: point COR_PROFILER at RemoteAchiko.dll before the CLR starts
+// • ICorProfilerCallback2: sample ObjectAllocated by bytes, capture the
+//   allocating method + caller with a synchronous stack snapshot
+// • Report: top allocators by type and call site as text lines
+//
+// Architecture:
+// • We host the CLR ourselves (ICLRRuntimeHost::Start), so the classic
+//   startup-profiler environment variables are read from OUR process
+//   environment — no registry, no attach API
+// • COR_PROFILER_PATH names RemoteAchiko.dll; the CLR's LoadLibrary gets
+//   the already-loaded module and calls our DllGetClassObject
+// • Sampling core (countdown, site table) lives in AllocProfile.h
+//
+// Critical Design Decisions:
+// • COR_PRF_ENABLE_OBJECT_ALLOCATED is immutable and routes every
+//   allocation through the slow helper — that cost is why the whole
+//   profiler is opt-in at injection time, never on by default
+// • Names are resolved at report time only (metadata lookups are far
+//   too slow for the allocation callback)
+// • The callback object is never released (same rule as g_clrHost)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <Windows.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "AllocProfile.h"
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerRequested — did the launcher opt this process in?
+//
+// Returns:
+//   true if the named event "AchikoAllocProfiler_PID_<pid>" exists
+//   (created by Achikobuddy's launcher before injecting)
+// ───────────────────────────────────────────────────────────────
+bool AllocProfilerRequested();
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerArm / Disarm — set / clear the COR_* variables
+//
+// Args:
+//   self - RemoteAchiko.dll module handle (its path becomes
+//          COR_PROFILER_PATH)
+//
+// Notes:
+//   Arm before CLRCreateInstance, Disarm right after ICLRRuntimeHost::Start
+//   — WoW's child processes must never inherit the variables
+// ───────────────────────────────────────────────────────────────
+bool AllocProfilerArm(HMODULE self);
+void AllocProfilerDisarm();
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerActive — CLR loaded us and Initialize succeeded
+// ───────────────────────────────────────────────────────────────
+bool AllocProfilerActive();
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerReset — clear samples and totals (new measurement window)
+// ───────────────────────────────────────────────────────────────
+void AllocProfilerReset();
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerReport — top allocators as UTF-8 lines
+//
+// Args:
+//   out      - destination buffer
+//   capacity - buffer size in bytes (output always terminated)
+//   topN     - number of sites to list
+//
+// Returns:
+//   Bytes written (excluding terminator), 0 if inactive
+//
+// Format:
+//   summary line, then one "#rank bytes share type <- site <- caller"
+//   line per site, '\n'-separated
+// ───────────────────────────────────────────────────────────────
+size_t AllocProfilerReport(char* out, size_t capacity, uint32_t topN);
+
+// ───────────────────────────────────────────────────────────────
+// AllocProfilerGetClassObject — DllGetClassObject body
+// ───────────────────────────────────────────────────────────────
+HRESULT AllocProfilerGetClassObject(REFCLSID clsid, REFIID iid, void** object);
@@ -0,0 +1,39 @@
+﻿// BootstrapStage.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Bootstrap progress of one injected client, as seen from Achikobuddy
+//
+// Responsibilities:
+// • The stage numbers shared by RemoteAchiko (signals), AchikoDLL (signals
+//   the last stage) and AchikoWatch (waits on them)
+// • The per-PID, per-stage named event that carries each signal
+//
+// Architecture:
+// • Achikobuddy's process watcher CREATES the events as soon as it sees a
+//   WoW process, then waits on them — no polling, no pipe parsing
+// • The injected side only OPENS + sets them; if no watcher created them
+//   (Achikobuddy not running, older build) the signal is simply dropped
+//
+// Critical Design Decisions:
+// • Manual-reset events: a stage signalled before the watcher's wait is
+//   registered is still seen
+// • Stages only move forward — the watcher keeps the highest one seen,
+//   except Failed which sticks
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+
+enum BootstrapStage : uint32_t
+{
+    Bootstrap_None = 0,            // process seen, nothing injected yet
+    Bootstrap_Injected = 1,        // RemoteAchiko.dll bootstrap thread running
+    Bootstrap_ClrUp = 2,           // ICLRRuntimeHost::Start succeeded
+    Bootstrap_ManagedReady = 3,    // Loader.Start() returned 0
+    Bootstrap_PipesConnected = 4,  // AchikoDLL log + command pipes connected
+    Bootstrap_Failed = 5,          // any bootstrap step failed (see log)
+    Bootstrap_Count
+};
+
+// "AchikoBootstrap_PID_<pid>_<stage>" — AchikoDLL builds the same name
+#define ACHIKO_BOOTSTRAP_EVENT_FORMAT L"AchikoBootstrap_PID_%lu_%u"
@@ -0,0 +1,877 @@
+﻿// ConfigStore.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Binary settings / offsets file — compiled from text, memory-mapped, hot
+// reloaded under a generation counter
+//
+// Responsibilities:
+// • ConfigTable: a validated view over a compiled image (sorted entries +
+//   string pool); Find() is a binary search on the key hash
+// • ConfigCompileText / ConfigCompileFile: "key = value" text → image
+// • ConfigStore: the live file — watcher thread, atomic swap, generation
+//   counter, retired mappings (Exports.cpp singleton)
+//
+// Architecture:
+// • Two files next to AchikoDLL.dll: Achiko.cfg (edited by hand) and
+//   Achiko.cfg.bin (what is mapped). The watcher polls both stamps every
+//   500 ms; a newer text is compiled to the .bin, a newer .bin is mapped
+//   and swapped in, and the generation moves
+// • Layout: ConfigFileHeader, ConfigEntry[count] sorted by key, string
+//   pool (names + string values, NUL-terminated)
+// • Managed code reads the same mapping through pointers (Config.cs):
+//   it polls the generation word and only re-resolves a key when it moved
+//
+// Critical Design Decisions:
+// • Keys are FNV-1a 64 hashes of "section.name" — a lookup never
+//   compares strings, and managed code hashes the same way
+// • An image that fails validation is never swapped in, and text that
+//   fails to compile never replaces the .bin: a typo keeps the old values
+// • A retired mapping stays mapped for kConfigGraceMs — a reader that
+//   resolved a pointer just before the swap finishes on the old image
+// • Windows refuses to replace a mapped file, but one opened with
+//   FILE_SHARE_DELETE (MappedFile) can be renamed: the mapped .bin is
+//   moved aside and deleted (pending until unmapped) before the new one
+//   takes its name
+// • With a text file present it is the source of truth: a .bin not
+//   compiled from the current text is recompiled
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MappedFile.h"
+
+static const uint32_t kConfigVersion = 1;
+static const uint32_t kConfigPollMs = 500;          // watcher stamp check
+static const uint32_t kConfigGraceMs = 10000;       // retired image stays mapped
+static const size_t kConfigMaxName = 63;
+static const size_t kConfigMaxText = 1024 * 1024;
+
+typedef std::basic_string<MappedPathChar> ConfigPath;
+
+// ═══════════════════════════════════════════════════════════════
+// File layout (shared with Config.cs)
+// ═══════════════════════════════════════════════════════════════
+enum ConfigType : uint32_t
+{
+    ConfigType_Int = 1,            // value = int64 (true / false = 1 / 0)
+    ConfigType_Float = 2,          // value = double bits
+    ConfigType_String = 3          // value = pool offset, length = bytes
+};
+
+struct ConfigFileHeader
+{
+    char magic[4];                 // "ACFG"
+    uint32_t version;
+    uint32_t count;
+    uint32_t stringBytes;
+    uint64_t sourceStamp;          // ConfigFileStamp of the text it was compiled from
+    uint32_t checksum;             // FNV-1a 32 over entries + pool
+    uint32_t reserved;
+};
+
+struct ConfigEntry
+{
+    uint64_t key;                  // ConfigKeyHash("section.name")
+    uint32_t type;                 // ConfigType
+    uint32_t name;                 // pool offset of "section.name"
+    int64_t value;
+    uint32_t length;               // string bytes (without the NUL)
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ConfigFileHeader) == 32, "ConfigFileHeader layout is shared with Config.cs");
+static_assert(sizeof(ConfigEntry) == 32, "ConfigEntry layout is shared with Config.cs");
+
+// What AchikoConfigView hands managed code (layout shared with Config.cs)
+struct ConfigViewInfo
+{
+    uint64_t entries;              // const ConfigEntry* (0 = no config)
+    uint64_t strings;              // const char* pool
+    uint32_t count;
+    uint32_t stringBytes;
+    uint32_t generation;
+    uint32_t reserved;
+};
+
+struct ConfigStats
+{
+    uint64_t reloads;              // images swapped in
+    uint64_t compiles;             // text → .bin
+    uint64_t rejected;             // text that failed to compile / images that failed validation
+    uint64_t lastReloadNs;         // stamp seen → new image live
+    uint64_t lastCompileNs;
+    uint64_t mappedBytes;
+    uint32_t generation;
+    uint32_t entries;
+    uint32_t retired;              // old images still mapped
+    uint32_t reserved;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Hashing / file helpers
+// ═══════════════════════════════════════════════════════════════
+
+inline uint64_t ConfigKeyHash(const char* name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline uint64_t ConfigKeyHash(const char* name)
+{
+    return ConfigKeyHash(name, strlen(name));
+}
+
+inline uint32_t ConfigChecksum(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ───────────────────────────────────────────────────────────────
+// ConfigFileStamp — modification time and size folded into one value
+//
+// Returns:
+//   0 if the file does not exist
+// ───────────────────────────────────────────────────────────────
+inline uint64_t ConfigFileStamp(const ConfigPath& path)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    const uint64_t written = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    const uint64_t size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return 0;
+    const uint64_t written = (uint64_t)st.st_mtim.tv_sec * 1000000000ULL + (uint64_t)st.st_mtim.tv_nsec;
+    const uint64_t size = (uint64_t)st.st_size;
+#endif
+    const uint64_t stamp = written * 1099511628211ULL ^ size;
+    return stamp ? stamp : 1;
+}
+
+// ───────────────────────────────────────────────────────────────
+// ConfigReplaceFile — move tmp onto path, even while path is mapped
+//
+// Args:
+//   aside - unused name the mapped file is moved to when a plain
+//           replace is refused (Windows); it is deleted right away and
+//           disappears once the last mapping closes
+// ───────────────────────────────────────────────────────────────
+inline bool ConfigReplaceFile(const ConfigPath& tmp, const ConfigPath& path, const ConfigPath& aside)
+{
+#ifdef _WIN32
+    if (MoveFileExW(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+        return true;
+    if (!MoveFileExW(path.c_str(), aside.c_str(), MOVEFILE_REPLACE_EXISTING))
+        return false;
+    DeleteFileW(aside.c_str());
+    return MoveFileExW(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    (void)aside;
+    return rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+}
+
+inline FILE* ConfigOpenFile(const ConfigPath& path, bool write)
+{
+#ifdef _WIN32
+    FILE* file = nullptr;
+    return _wfopen_s(&file, path.c_str(), write ? L"wb" : L"rb") == 0 ? file : nullptr;
+#else
+    return fopen(path.c_str(), write ? "wb" : "rb");
+#endif
+}
+
+// sourceStamp from the header of a .bin on disk (0 = missing / not one)
+inline uint64_t ConfigReadSourceStamp(const ConfigPath& path)
+{
+    ConfigFileHeader header;
+    FILE* in = ConfigOpenFile(path, false);
+    if (!in)
+        return 0;
+    const bool read = fread(&header, sizeof(header), 1, in) == 1;
+    fclose(in);
+    return read && memcmp(header.magic, "ACFG", 4) == 0 ? header.sourceStamp : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ConfigTable — validated view over an image (mapped or in memory)
+// ═══════════════════════════════════════════════════════════════
+class ConfigTable
+{
+public:
+    ConfigTable() : m_header(nullptr), m_entries(nullptr), m_strings(nullptr), m_count(0), m_stringBytes(0) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Bind — check an image and point into it
+    //
+    // Returns:
+    //   false (and an empty table) unless magic, version, sizes,
+    //   checksum, key order and every pool offset check out
+    // ───────────────────────────────────────────────────────────────
+    bool Bind(const uint8_t* data, size_t size)
+    {
+        *this = ConfigTable();
+        if (!data || size < sizeof(ConfigFileHeader))
+            return false;
+
+        const ConfigFileHeader* header = (const ConfigFileHeader*)data;
+        if (memcmp(header->magic, "ACFG", 4) != 0 || header->version != kConfigVersion)
+            return false;
+        const uint64_t expected = sizeof(ConfigFileHeader) + (uint64_t)header->count * sizeof(ConfigEntry) + header->stringBytes;
+        if (expected != size)
+            return false;
+
+        const uint8_t* body = data + sizeof(ConfigFileHeader);
+        if (ConfigChecksum(body, size - sizeof(ConfigFileHeader)) != header->checksum)
+            return false;
+
+        const ConfigEntry* entries = (const ConfigEntry*)body;
+        const char* strings = (const char*)(entries + header->count);
+        if (header->stringBytes && strings[header->stringBytes - 1] != '\0')
+            return false;
+        for (uint32_t i = 0; i < header->count; ++i)
+        {
+            const ConfigEntry& e = entries[i];
+            if (i && entries[i - 1].key >= e.key)
+                return false;
+            if (e.name >= header->stringBytes)
+                return false;
+            if (e.type == ConfigType_String)
+            {
+                // value is signed: a negative offset would wrap the sum below
+                if (e.value < 0 || (uint64_t)e.value >= header->stringBytes)
+                    return false;
+                if ((uint64_t)e.value + e.length >= header->stringBytes || strings[e.value + e.length] != '\0')
+                    return false;
+            }
+            else if (e.type != ConfigType_Int && e.type != ConfigType_Float)
+            {
+                return false;
+            }
+        }
+
+        m_header = header;
+        m_entries = entries;
+        m_strings = strings;
+        m_count = header->count;
+        m_stringBytes = header->stringBytes;
+        return true;
+    }
+
+    // Entry for key, or nullptr
+    const ConfigEntry* Find(uint64_t key) const
+    {
+        const ConfigEntry* first = m_entries;
+        const ConfigEntry* last = m_entries + m_count;
+        const ConfigEntry* it = std::lower_bound(first, last, key,
+            [](const ConfigEntry& e, uint64_t k) { return e.key < k; });
+        return it != last && it->key == key ? it : nullptr;
+    }
+
+    bool GetInt(const char* name, int64_t& out) const
+    {
+        const ConfigEntry* e = Find(ConfigKeyHash(name));
+        if (!e || e->type == ConfigType_String)
+            return false;
+        out = e->type == ConfigType_Float ? (int64_t)AsDouble(*e) : e->value;
+        return true;
+    }
+
+    bool GetFloat(const char* name, double& out) const
+    {
+        const ConfigEntry* e = Find(ConfigKeyHash(name));
+        if (!e || e->type == ConfigType_String)
+            return false;
+        out = e->type == ConfigType_Float ? AsDouble(*e) : (double)e->value;
+        return true;
+    }
+
+    // Pool pointer (NUL-terminated, lives as long as the image), or nullptr
+    const char* GetString(const char* name) const
+    {
+        const ConfigEntry* e = Find(ConfigKeyHash(name));
+        return e && e->type == ConfigType_String ? m_strings + e->value : nullptr;
+    }
+
+    static double AsDouble(const ConfigEntry& e)
+    {
+        double value;
+        memcpy(&value, &e.value, sizeof(value));
+        return value;
+    }
+
+    bool Valid() const { return m_header != nullptr; }
+    uint64_t SourceStamp() const { return m_header ? m_header->sourceStamp : 0; }
+    const ConfigEntry* Entries() const { return m_entries; }
+    const char* Strings() const { return m_strings; }
+    uint32_t Count() const { return m_count; }
+    uint32_t StringBytes() const { return m_stringBytes; }
+
+private:
+    const ConfigFileHeader* m_header;
+    const ConfigEntry* m_entries;
+    const char* m_strings;
+    uint32_t m_count;
+    uint32_t m_stringBytes;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Compiler
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// ConfigCompileText — text → image
+//
+// Args:
+//   text        - lines of "name = value"; "[section]" prefixes the
+//                 names below it with "section."; '#' starts a comment.
+//                 Values: "quoted string", true / false, 0x hex, integer,
+//                 or float (has '.' or an exponent). A leading UTF-8
+//                 BOM (Notepad) is skipped
+//   sourceStamp - recorded in the header (ConfigFileStamp of the text)
+//   image       - receives the file bytes
+//   error       - "line N: ..." when it fails
+//
+// Returns:
+//   false on the first bad line or a duplicate name (image untouched)
+// ───────────────────────────────────────────────────────────────
+inline bool ConfigCompileText(const char* text, size_t size, uint64_t sourceStamp,
+                              std::vector<uint8_t>& image, std::string& error)
+{
+    struct Parsed
+    {
+        ConfigEntry entry;
+        uint32_t line;
+    };
+    std::vector<Parsed> parsed;
+    std::string pool;
+    std::string section;
+    char message[160];
+
+    const char* p = text;
+    const char* end = text + size;
+    if (size >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)
+        p += 3;
+    for (uint32_t line = 1; p < end; ++line)
+    {
+        const char* eol = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!eol)
+            eol = end;
+        const char* s = p;
+        const char* e = eol;
+        p = eol + 1;
+
+        while (s < e && (*s == ' ' || *s == '\t'))
+            ++s;
+        // Cut the comment (not inside a quoted value)
+        bool quoted = false;
+        for (const char* c = s; c < e; ++c)
+        {
+            if (*c == '"' && (c == s || c[-1] != '\\'))
+                quoted = !quoted;
+            else if (*c == '#' && !quoted)
+            {
+                e = c;
+                break;
+            }
+        }
+        while (e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r'))
+            --e;
+        if (s == e)
+            continue;
+
+        if (*s == '[')
+        {
+            if (e[-1] != ']' || e - s < 3)
+            {
+                snprintf(message, sizeof(message), "line %u: bad section header", line);
+                error = message;
+                return false;
+            }
+            section.assign(s + 1, e - 1);
+            continue;
+        }
+
+        const char* eq = (const char*)memchr(s, '=', (size_t)(e - s));
+        if (!eq)
+        {
+            snprintf(message, sizeof(message), "line %u: expected name = value", line);
+            error = message;
+            return false;
+        }
+        const char* nameEnd = eq;
+        while (nameEnd > s && (nameEnd[-1] == ' ' || nameEnd[-1] == '\t'))
+            --nameEnd;
+        std::string name = section.empty() ? std::string() : section + ".";
+        name.append(s, nameEnd);
+        bool nameOk = nameEnd > s && name.size() <= kConfigMaxName;
+        for (size_t i = 0; nameOk && i < name.size(); ++i)
+        {
+            const char c = name[i];
+            nameOk = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                     c == '_' || c == '.' || c == '-';
+        }
+        if (!nameOk)
+        {
+            snprintf(message, sizeof(message), "line %u: bad name", line);
+            error = message;
+            return false;
+        }
+
+        const char* v = eq + 1;
+        while (v < e && (*v == ' ' || *v == '\t'))
+            ++v;
+        const std::string value(v, e);
+
+        Parsed item;
+        memset(&item.entry, 0, sizeof(item.entry));
+        item.line = line;
+        item.entry.key = ConfigKeyHash(name.c_str(), name.size());
+        item.entry.name = (uint32_t)pool.size();
+        pool.append(name).push_back('\0');
+
+        bool valueOk = !value.empty();
+        if (valueOk && value[0] == '"')
+        {
+            std::string str;
+            size_t i = 1;
+            for (; i < value.size() && value[i] != '"'; ++i)
+            {
+                if (value[i] == '\\' && i + 1 < value.size())
+                {
+                    const char next = value[++i];
+                    str.push_back(next == 'n' ? '\n' : next == 't' ? '\t' : next);
+                }
+                else
+                {
+                    str.push_back(value[i]);
+                }
+            }
+            valueOk = i + 1 == value.size();
+            item.entry.type = ConfigType_String;
+            item.entry.value = (int64_t)pool.size();
+            item.entry.length = (uint32_t)str.size();
+            pool.append(str).push_back('\0');
+        }
+        else if (valueOk && (value == "true" || value == "false"))
+        {
+            item.entry.type = ConfigType_Int;
+            item.entry.value = value == "true" ? 1 : 0;
+        }
+        else if (valueOk)
+        {
+            char* stop = nullptr;
+            const bool hex = value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X');
+            if (hex || value.find_first_of(".eE") == std::string::npos)
+            {
+                item.entry.type = ConfigType_Int;
+                item.entry.value = hex ? (int64_t)strtoull(value.c_str(), &stop, 16)
+                                       : (int64_t)strtoll(value.c_str(), &stop, 10);
+            }
+            else
+            {
+                const double d = strtod(value.c_str(), &stop);
+                item.entry.type = ConfigType_Float;
+                memcpy(&item.entry.value, &d, sizeof(d));
+            }
+            valueOk = stop && *stop == '\0';
+        }
+        if (!valueOk)
+        {
+            snprintf(message, sizeof(message), "line %u: bad value for '%s'", line, name.c_str());
+            error = message;
+            return false;
+        }
+        parsed.push_back(item);
+    }
+
+    std::sort(parsed.begin(), parsed.end(),
+              [](const Parsed& a, const Parsed& b) { return a.entry.key < b.entry.key; });
+    for (size_t i = 1; i < parsed.size(); ++i)
+    {
+        if (parsed[i].entry.key == parsed[i - 1].entry.key)
+        {
+            // Same name twice (a 64-bit hash collision reads the same way)
+            snprintf(message, sizeof(message), "line %u: '%s' already set on line %u",
+                     std::max(parsed[i].line, parsed[i - 1].line), pool.c_str() + parsed[i].entry.name,
+                     std::min(parsed[i].line, parsed[i - 1].line));
+            error = message;
+            return false;
+        }
+    }
+
+    ConfigFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "ACFG", 4);
+    header.version = kConfigVersion;
+    header.count = (uint32_t)parsed.size();
+    header.stringBytes = (uint32_t)pool.size();
+    header.sourceStamp = sourceStamp;
+
+    image.assign(sizeof(header), 0);
+    for (size_t i = 0; i < parsed.size(); ++i)
+    {
+        const uint8_t* bytes = (const uint8_t*)&parsed[i].entry;
+        image.insert(image.end(), bytes, bytes + sizeof(ConfigEntry));
+    }
+    image.insert(image.end(), pool.begin(), pool.end());
+    header.checksum = ConfigChecksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    memcpy(image.data(), &header, sizeof(header));
+    return true;
+}
+
+// ───────────────────────────────────────────────────────────────
+// ConfigCompileFile — compile text at textPath into binPath
+//
+// Returns:
+//   false if the text is missing / does not compile / a file step
+//   failed; an existing binPath is left untouched then
+// ───────────────────────────────────────────────────────────────
+inline bool ConfigCompileFile(const ConfigPath& textPath, const ConfigPath& binPath, std::string& error)
+{
+    const uint64_t stamp = ConfigFileStamp(textPath);
+    FILE* in = stamp ? ConfigOpenFile(textPath, false) : nullptr;
+    if (!in)
+    {
+        error = "cannot read the text file";
+        return false;
+    }
+    std::vector<char> text(kConfigMaxText + 1);
+    const size_t size = fread(text.data(), 1, text.size(), in);
+    fclose(in);
+    if (size > kConfigMaxText)
+    {
+        error = "text file larger than 1 MB";
+        return false;
+    }
+
+    std::vector<uint8_t> image;
+    if (!ConfigCompileText(text.data(), size, stamp, image, error))
+        return false;
+
+    // Aside names must be unique: a deleted file keeps its name while
+    // it is still mapped
+    const uint64_t now = PlatformNowNs();
+    ConfigPath aside = binPath;
+    aside.push_back('.');
+    for (int shift = 60; shift >= 0; shift -= 4)
+        aside.push_back((MappedPathChar)"0123456789abcdef"[(now >> shift) & 0xF]);
+    aside.push_back('.');
+    aside.push_back('o');
+    aside.push_back('l');
+    aside.push_back('d');
+    ConfigPath tmp = binPath;
+    tmp.push_back('.');
+    tmp.push_back('t');
+    tmp.push_back('m');
+    tmp.push_back('p');
+
+    FILE* out = ConfigOpenFile(tmp, true);
+    if (!out)
+    {
+        error = "cannot write the .bin file";
+        return false;
+    }
+    const bool written = fwrite(image.data(), 1, image.size(), out) == image.size();
+    const bool closed = fclose(out) == 0;
+    if (!written || !closed || !ConfigReplaceFile(tmp, binPath, aside))
+    {
+#ifdef _WIN32
+        DeleteFileW(tmp.c_str());
+#else
+        unlink(tmp.c_str());
+#endif
+        error = "cannot replace the .bin file";
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ConfigImage — a mapped .bin
+// ═══════════════════════════════════════════════════════════════
+struct ConfigImage
+{
+    MappedFile file;
+    ConfigTable table;
+    uint64_t stamp;                // ConfigFileStamp of the .bin when mapped
+
+    bool Open(const ConfigPath& path, uint64_t binStamp)
+    {
+        stamp = binStamp;
+        if (file.Open(path.c_str()) && table.Bind(file.Data(), file.Size()))
+            return true;
+        file.Close();
+        return false;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ConfigStore — the live configuration
+// ═══════════════════════════════════════════════════════════════
+class ConfigStore
+{
+public:
+    ConfigStore() : m_generation(0), m_failedStamp(0), m_rejectedBinStamp(0), m_stop(false), m_open(false)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    ~ConfigStore() { Close(); }
+
+    // ───────────────────────────────────────────────────────────────
+    // Open — map binPath (compiling textPath first when it is newer)
+    // and start watching both
+    //
+    // Args:
+    //   textPath - may be empty: the .bin is then edited / generated
+    //              elsewhere and only it is watched
+    //
+    // Returns:
+    //   false if already open. A missing or invalid file is not a
+    //   failure — generation stays 0 (defaults) until one shows up
+    // ───────────────────────────────────────────────────────────────
+    bool Open(const ConfigPath& binPath, const ConfigPath& textPath)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (m_open || binPath.empty())
+                return false;
+            m_bin = binPath;
+            m_text = textPath;
+            m_open = true;
+        }
+        ReloadNow();
+
+        m_stop = false;
+        m_worker = std::thread(&ConfigStore::WatchLoop, this);
+        return true;
+    }
+
+    // Stops the watcher and unmaps every image; generation keeps counting
+    // so a reopen is still seen as a change
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_workerLock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_current)
+            m_generation.fetch_add(1);
+        m_current.reset();
+        m_retired.clear();
+        m_open = false;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // ReloadNow — what the watcher does every kConfigPollMs
+    //
+    // Returns:
+    //   true if a new image was swapped in
+    // ───────────────────────────────────────────────────────────────
+    bool ReloadNow()
+    {
+        std::lock_guard<std::mutex> reload(m_reloadLock);
+        ConfigPath bin, text;
+        uint64_t sourceStamp, binStamp;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (!m_open)
+                return false;
+            bin = m_bin;
+            text = m_text;
+            sourceStamp = m_current ? m_current->table.SourceStamp() : 0;
+            binStamp = m_current ? m_current->stamp : 0;
+        }
+        const uint64_t start = PlatformNowNs();
+
+        // Newer text → new .bin (a failed compile is retried only once
+        // the text changes again)
+        if (!text.empty())
+        {
+            const uint64_t textStamp = ConfigFileStamp(text);
+            if (textStamp && textStamp != m_failedStamp)
+            {
+                // The .bin on disk may be newer than the mapped one
+                // (compiled last session, or not mapped yet)
+                const uint64_t diskStamp = ConfigFileStamp(bin);
+                const uint64_t compiledFrom = diskStamp == binStamp ? sourceStamp : ConfigReadSourceStamp(bin);
+                if (compiledFrom != textStamp)
+                {
+                    std::string error;
+                    const bool compiled = ConfigCompileFile(text, bin, error);
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    if (compiled)
+                    {
+                        ++m_stats.compiles;
+                        m_stats.lastCompileNs = PlatformNowNs() - start;
+                        m_error.clear();
+                    }
+                    else
+                    {
+                        ++m_stats.rejected;
+                        m_failedStamp = textStamp;
+                        m_error = error;
+                    }
+                }
+            }
+        }
+
+        // Newer .bin → map, validate, swap
+        const uint64_t newBinStamp = ConfigFileStamp(bin);
+        if (!newBinStamp || newBinStamp == binStamp || newBinStamp == m_rejectedBinStamp)
+            return false;
+
+        std::shared_ptr<ConfigImage> image(new ConfigImage());
+        if (!image->Open(bin, newBinStamp))
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            ++m_stats.rejected;
+            m_rejectedBinStamp = newBinStamp;
+            m_error = "the .bin file is not a valid config image";
+            return false;
+        }
+
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_open)
+            return false;
+        if (m_current)
+            m_retired.push_back(Retired(PlatformNowNs(), m_current));
+        m_current = image;
+        m_generation.fetch_add(1);
+        ++m_stats.reloads;
+        m_stats.lastReloadNs = PlatformNowNs() - start;
+        return true;
+    }
+
+    // Current image for managed readers — consistent with its generation
+    void View(ConfigViewInfo& out)
+    {
+        memset(&out, 0, sizeof(out));
+        std::lock_guard<std::mutex> guard(m_lock);
+        out.generation = m_generation.load();
+        if (!m_current)
+            return;
+        out.entries = (uint64_t)(uintptr_t)m_current->table.Entries();
+        out.strings = (uint64_t)(uintptr_t)m_current->table.Strings();
+        out.count = m_current->table.Count();
+        out.stringBytes = m_current->table.StringBytes();
+    }
+
+    // Holds the current image alive for native readers; empty = defaults
+    std::shared_ptr<ConfigImage> Current()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_current;
+    }
+
+    // Polled by managed code through a pointer — no call per check
+    const uint32_t* GenerationAddress() const
+    {
+        return reinterpret_cast<const uint32_t*>(&m_generation);
+    }
+
+    uint32_t Generation() const { return m_generation.load(); }
+
+    void Stats(ConfigStats& out)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        out = m_stats;
+        out.generation = m_generation.load();
+        out.entries = m_current ? m_current->table.Count() : 0;
+        out.mappedBytes = m_current ? m_current->file.Size() : 0;
+        out.retired = (uint32_t)m_retired.size();
+    }
+
+    // Why the last compile / image was rejected ("" if it was not)
+    std::string LastError()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_error;
+    }
+
+private:
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    typedef std::pair<uint64_t, std::shared_ptr<ConfigImage>> Retired;
+
+    void ReleaseRetired()
+    {
+        const uint64_t now = PlatformNowNs();
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), [now](const Retired& r)
+        {
+            return now - r.first >= (uint64_t)kConfigGraceMs * 1000000ULL;
+        }), m_retired.end());
+    }
+
+    void WatchLoop()
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_workerLock);
+                m_wake.wait_for(lock, std::chrono::milliseconds(kConfigPollMs), [this] { return m_stop; });
+                if (m_stop)
+                    return;
+            }
+            ReloadNow();
+            ReleaseRetired();
+        }
+    }
+
+    std::mutex m_lock;                          // paths, images, stats, error
+    ConfigPath m_bin;
+    ConfigPath m_text;
+    std::shared_ptr<ConfigImage> m_current;
+    std::vector<Retired> m_retired;             // (retired at ns, image)
+    std::atomic<uint32_t> m_generation;
+    ConfigStats m_stats;
+    std::string m_error;
+
+    std::mutex m_reloadLock;                    // one reload at a time (watcher / CONFIG_RELOAD)
+    uint64_t m_failedStamp;                     // text stamp that did not compile
+    uint64_t m_rejectedBinStamp;                // .bin stamp that did not validate
+
+    std::mutex m_workerLock;
+    std::condition_variable m_wake;
+    std::thread m_worker;
+    bool m_stop;
+    bool m_open;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "managed code reads the generation as a plain uint");
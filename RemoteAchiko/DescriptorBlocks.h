@@ -0,0 +1,171 @@
+﻿// DescriptorBlocks.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Per-tick descriptor copies — one guarded memcpy per object, then typed
+// field reads from local memory
+//
+// Responsibilities:
+// • Capture(): for every object in this tick's list, resolve its
+//   descriptor pointer and copy the whole block into the tick arena
+// • Field<T>(): typed accessor over the local copy — no fault handling,
+//   no foreign memory, no interop
+// • Per-slot valid flag: an object whose block faulted reads as zeros
+//
+// Architecture:
+// • One flat buffer per capture, allocated from the caller's TickArena:
+//   slot i at i × stride, stride = block size rounded to a cache line so
+//   slots never share one
+// • The buffer lives until the arena resets — Block(0) + Stride() can be
+//   handed to managed code as an ArenaSpan
+// • Fed from ObjectDirectory's address list in the same order, so slot i
+//   is directory entry i
+//
+// Critical Design Decisions:
+// • Two guarded calls per object (pointer + block) instead of one per
+//   field: 30+ fields per unit used to mean 30+ fault frames, and from
+//   managed code 30+ P/Invoke transitions
+// • The copy is a snapshot: fields of one object are mutually consistent
+//   as of the copy, not as of each read
+// • Out-of-range offsets read as T() rather than asserting — offsets come
+//   from data files and a bad one must not take the client down
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "MemoryRead.h"
+#include "Platform.h"
+#include "TickArena.h"
+
+// What an object snapshot needs from the client — layout shared with
+// ObjectSnapshot.cs
+struct ObjectSnapshotLayout
+{
+    uint32_t managerFirstObject;
+    uint32_t managerCount;
+    uint32_t objectNext;
+    uint32_t objectGuid;
+    uint32_t objectDescriptors;    // object → descriptor block pointer
+    uint32_t descriptorSize;       // bytes copied per object
+};
+
+struct DescriptorBlockStats
+{
+    uint64_t captures;             // Capture() calls
+    uint64_t blocks;               // blocks copied, all ticks
+    uint64_t faults;               // pointer or block unreadable
+    uint64_t bytes;                // bytes copied, all ticks
+    uint64_t captureNs;            // time in Capture()
+    uint32_t lastCount;            // slots in the last capture
+    uint32_t lastFaults;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// DescriptorBlocks
+// ═══════════════════════════════════════════════════════════════
+class DescriptorBlocks
+{
+public:
+    // ───────────────────────────────────────────────────────────────
+    // Constructor
+    //
+    // Args:
+    //   descriptorOffset - object → descriptor block pointer
+    //   blockSize        - bytes to copy per object
+    // ───────────────────────────────────────────────────────────────
+    DescriptorBlocks(uint32_t descriptorOffset, uint32_t blockSize)
+        : m_descriptorOffset(descriptorOffset), m_blockSize(blockSize),
+          m_stride(((size_t)blockSize + kCacheLine - 1) & ~(size_t)(kCacheLine - 1)),
+          m_count(0), m_buffer(nullptr), m_valid(nullptr)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Capture — replace the buffer with this tick's blocks
+    //
+    // Args:
+    //   arena   - owns the copies until its next Reset()
+    //   objects - object addresses (typically ObjectDirectory::Addresses())
+    //   count   - number of objects
+    //
+    // Returns:
+    //   Blocks copied (count minus faults); 0 if the arena is out of memory
+    // ───────────────────────────────────────────────────────────────
+    size_t Capture(TickArena& arena, const uintptr_t* objects, size_t count)
+    {
+        const uint64_t start = PlatformNowNs();
+        m_buffer = arena.AllocateArray<uint8_t>(m_stride * count, kCacheLine);
+        m_valid = arena.AllocateArray<uint8_t>(count);
+        m_count = m_buffer && m_valid ? count : 0;
+
+        uint32_t faults = 0;
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            uint8_t* slot = &m_buffer[i * m_stride];
+            uintptr_t descriptors = 0;
+            const bool ok = SafeCopy(&descriptors, (const void*)(objects[i] + m_descriptorOffset), sizeof(descriptors)) &&
+                SafeCopy(slot, (const void*)descriptors, m_blockSize);
+
+            m_valid[i] = ok ? 1 : 0;
+            if (!ok)
+            {
+                memset(slot, 0, m_blockSize);
+                ++faults;
+            }
+        }
+
+        const size_t copied = m_count - faults;
+        ++m_stats.captures;
+        m_stats.blocks += copied;
+        m_stats.faults += faults;
+        m_stats.bytes += (uint64_t)copied * m_blockSize;
+        m_stats.captureNs += PlatformNowNs() - start;
+        m_stats.lastCount = (uint32_t)m_count;
+        m_stats.lastFaults = faults;
+        return copied;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Field — typed read from slot i's local copy
+    //
+    // Returns:
+    //   The value at offset, or T() for a faulted slot / out-of-range
+    //   slot or offset
+    // ───────────────────────────────────────────────────────────────
+    template <class T>
+    T Field(size_t i, uint32_t offset) const
+    {
+        T value = T();
+        if (i < m_count && m_valid[i] && (size_t)offset + sizeof(T) <= m_blockSize)
+            memcpy(&value, &m_buffer[i * m_stride + offset], sizeof(T));
+        return value;
+    }
+
+    size_t Count() const { return m_count; }
+    bool Valid(size_t i) const { return i < m_count && m_valid[i] != 0; }
+    uint32_t BlockSize() const { return m_blockSize; }
+    size_t Stride() const { return m_stride; }
+
+    // Raw slot for bulk consumers; nullptr past Count()
+    const uint8_t* Block(size_t i) const { return i < m_count ? &m_buffer[i * m_stride] : nullptr; }
+
+    // The copies as a span of the arena's current generation
+    ArenaSpan Span(const TickArena& arena) const { return arena.Span(m_buffer, m_count, m_stride); }
+
+    void Stats(DescriptorBlockStats& out) const { out = m_stats; }
+    void ResetStats() { memset(&m_stats, 0, sizeof(m_stats)); }
+
+private:
+    DescriptorBlocks(const DescriptorBlocks&) = delete;
+    DescriptorBlocks& operator=(const DescriptorBlocks&) = delete;
+
+    uint32_t m_descriptorOffset;
+    uint32_t m_blockSize;
+    size_t m_stride;
+    size_t m_count;
+    uint8_t* m_buffer;             // arena memory, m_count slots
+    uint8_t* m_valid;
+    DescriptorBlockStats m_stats;
+};
@@ -0,0 +1,349 @@
+﻿// EffectTracker.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Closed-loop decision-to-effect latency — from "the bot decided" to "the
+// game shows it happened"
+//
+// Responsibilities:
+// • Stamp each decision (cast / move / target) and hand back a token
+// • Optional intermediate stamps on the token: dispatched (left the bot's
+//   queue) and executed (the game thread ran the call)
+// • Match decisions against the player's state in every later snapshot:
+//   cast id appeared, position moved, target changed
+// • Per action kind, per stage histograms:
+//     queue    = decided    → dispatched
+//     handoff  = dispatched → executed on the game thread
+//     response = executed   → first snapshot showing the effect
+//     total    = decided    → effect
+// • Decisions that never show an effect expire after 5 s and are counted
+//
+// Architecture:
+// • Fixed table of kEffectMaxPending open decisions behind one mutex —
+//   four different threads stamp (bot, submit, game, snapshot)
+// • Histograms are LatencyHistogram (lock-free record, 6.25% buckets)
+// • Every call takes nowNs; the exports stamp PlatformNowNs() on arrival
+//
+// Critical Design Decisions:
+// • A decision only matches once its condition was seen false: re-casting
+//   the spell that is already casting, or re-targeting the current target,
+//   must not complete in the very next snapshot
+// • Movement is measured from the last snapshot before the decision (or
+//   the first one after it, if none existed)
+// • Missing stamps fall back to the previous stage's time — a caller that
+//   only stamps decide + observe still gets response and total
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <mutex>
+#include "LatencyHistogram.h"
+
+static const uint32_t kEffectMaxPending = 64;
+static const uint32_t kEffectSlotBits = 6;                      // 64 slots
+static const uint64_t kEffectTimeoutNs = 5000000000ULL;        // decision → no effect
+static const float kEffectMoveEpsilon = 0.25f;                  // yards
+
+static_assert((1u << kEffectSlotBits) == kEffectMaxPending, "token slot bits match the table");
+
+// ═══════════════════════════════════════════════════════════════
+// Public records
+// ═══════════════════════════════════════════════════════════════
+enum EffectKind : uint32_t
+{
+    Effect_Cast = 0,       // expect = spell id
+    Effect_Move = 1,       // expect unused
+    Effect_Target = 2,     // expect = target GUID
+    Effect_KindCount = 3,
+};
+
+enum EffectStage : uint32_t
+{
+    EffectStage_Queue = 0,
+    EffectStage_Handoff = 1,
+    EffectStage_Response = 2,
+    EffectStage_Total = 3,
+    EffectStage_Count = 4,
+};
+
+// The player's state in one snapshot — layout shared with EffectLatency.cs
+struct EffectSnapshot
+{
+    uint64_t castId;       // spell being cast / channeled, 0 = none
+    uint64_t targetGuid;
+    float x, y, z;
+    uint32_t reserved;
+};
+
+// One kind's distribution — layout shared with EffectLatency.cs
+struct EffectKindStats
+{
+    uint64_t completed;
+    uint64_t expired;                          // no effect within kEffectTimeoutNs
+    uint64_t pending;
+    uint64_t count[EffectStage_Count];         // stages can be unstamped
+    uint64_t p50Ns[EffectStage_Count];
+    uint64_t p90Ns[EffectStage_Count];
+    uint64_t p99Ns[EffectStage_Count];
+    uint64_t maxNs[EffectStage_Count];
+};
+
+// ═══════════════════════════════════════════════════════════════
+// EffectTracker
+// ═══════════════════════════════════════════════════════════════
+class EffectTracker
+{
+public:
+    EffectTracker() : m_nextSlot(0), m_generation(0), m_haveSnapshot(false)
+    {
+        memset(m_pending, 0, sizeof(m_pending));
+        memset(&m_last, 0, sizeof(m_last));
+        memset(m_completed, 0, sizeof(m_completed));
+        memset(m_expired, 0, sizeof(m_expired));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Decide — open a decision
+    //
+    // Returns:
+    //   Token for the later stamps, 0 if kind is invalid. A full table
+    //   evicts the oldest decision (counted as expired)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Decide(uint64_t nowNs, EffectKind kind, uint64_t expect)
+    {
+        if (kind >= Effect_KindCount)
+            return 0;
+
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        uint32_t slot = kEffectMaxPending;
+        for (uint32_t i = 0; i < kEffectMaxPending && slot == kEffectMaxPending; ++i)
+        {
+            const uint32_t probe = (m_nextSlot + i) % kEffectMaxPending;
+            if (!m_pending[probe].token)
+                slot = probe;
+        }
+        if (slot == kEffectMaxPending)
+        {
+            slot = Oldest();
+            ++m_expired[m_pending[slot].kind];
+        }
+        m_nextSlot = (slot + 1) % kEffectMaxPending;
+
+        // Generation in the high bits keeps stale tokens from stamping
+        // a reused slot; never 0
+        if (++m_generation >= (1u << (32 - kEffectSlotBits)))
+            m_generation = 1;
+
+        Pending& p = m_pending[slot];
+        memset(&p, 0, sizeof(p));
+        p.token = (m_generation << kEffectSlotBits) | slot;
+        p.kind = kind;
+        p.expect = expect;
+        p.decidedNs = nowNs;
+        p.haveOrigin = m_haveSnapshot;
+        p.originX = m_last.x;
+        p.originY = m_last.y;
+        p.originZ = m_last.z;
+        p.armed = !m_haveSnapshot || !Holds(p, m_last);
+        return p.token;
+    }
+
+    void Dispatched(uint32_t token, uint64_t nowNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        Pending* p = Find(token);
+        if (p && !p->dispatchedNs)
+            p->dispatchedNs = nowNs;
+    }
+
+    void Executed(uint32_t token, uint64_t nowNs)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        Pending* p = Find(token);
+        if (p && !p->executedNs)
+            p->executedNs = nowNs;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Observe — match one snapshot against every open decision
+    //
+    // Args:
+    //   nowNs - when the snapshot was taken (not when it is processed)
+    //
+    // Returns:
+    //   Decisions completed by this snapshot
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Observe(uint64_t nowNs, const EffectSnapshot& snapshot)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        uint32_t completed = 0;
+
+        for (uint32_t i = 0; i < kEffectMaxPending; ++i)
+        {
+            Pending& p = m_pending[i];
+            if (!p.token || nowNs < p.decidedNs)
+                continue;
+
+            if (nowNs - p.decidedNs > kEffectTimeoutNs)
+            {
+                ++m_expired[p.kind];
+                p.token = 0;
+                continue;
+            }
+
+            if (p.kind == Effect_Move && !p.haveOrigin)
+            {
+                p.originX = snapshot.x;
+                p.originY = snapshot.y;
+                p.originZ = snapshot.z;
+                p.haveOrigin = true;
+                continue;
+            }
+
+            const bool holds = Holds(p, snapshot);
+            if (!p.armed)
+            {
+                p.armed = !holds;
+                continue;
+            }
+            if (!holds)
+                continue;
+
+            Complete(p, nowNs);
+            ++completed;
+        }
+
+        m_last = snapshot;
+        m_haveSnapshot = true;
+        return completed;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPORTING
+    // ═══════════════════════════════════════════════════════════════
+
+    void Stats(EffectKind kind, EffectKindStats& out) const
+    {
+        memset(&out, 0, sizeof(out));
+        if (kind >= Effect_KindCount)
+            return;
+
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            out.completed = m_completed[kind];
+            out.expired = m_expired[kind];
+            for (uint32_t i = 0; i < kEffectMaxPending; ++i)
+                out.pending += m_pending[i].token && m_pending[i].kind == kind ? 1 : 0;
+        }
+
+        for (uint32_t s = 0; s < EffectStage_Count; ++s)
+        {
+            const LatencyHistogram& h = m_histograms[kind][s];
+            out.count[s] = h.Count();
+            out.p50Ns[s] = h.Percentile(50.0);
+            out.p90Ns[s] = h.Percentile(90.0);
+            out.p99Ns[s] = h.Percentile(99.0);
+            out.maxNs[s] = h.Max();
+        }
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        memset(m_completed, 0, sizeof(m_completed));
+        memset(m_expired, 0, sizeof(m_expired));
+        for (uint32_t k = 0; k < Effect_KindCount; ++k)
+        {
+            for (uint32_t s = 0; s < EffectStage_Count; ++s)
+                m_histograms[k][s].Reset();
+        }
+    }
+
+private:
+    struct Pending
+    {
+        uint32_t token;                 // 0 = free
+        EffectKind kind;
+        uint64_t expect;
+        uint64_t decidedNs;
+        uint64_t dispatchedNs;          // 0 = not stamped
+        uint64_t executedNs;
+        float originX, originY, originZ;
+        bool haveOrigin;
+        bool armed;                     // condition seen false since Decide
+    };
+
+    EffectTracker(const EffectTracker&) = delete;
+    EffectTracker& operator=(const EffectTracker&) = delete;
+
+    static bool Holds(const Pending& p, const EffectSnapshot& s)
+    {
+        switch (p.kind)
+        {
+        case Effect_Cast:
+            return s.castId == p.expect;
+        case Effect_Target:
+            return s.targetGuid == p.expect;
+        case Effect_Move:
+        {
+            const float dx = s.x - p.originX, dy = s.y - p.originY, dz = s.z - p.originZ;
+            return p.haveOrigin && dx * dx + dy * dy + dz * dz > kEffectMoveEpsilon * kEffectMoveEpsilon;
+        }
+        default:
+            return false;
+        }
+    }
+
+    Pending* Find(uint32_t token)
+    {
+        Pending& p = m_pending[token & (kEffectMaxPending - 1)];
+        return token && p.token == token ? &p : nullptr;
+    }
+
+    uint32_t Oldest() const
+    {
+        uint32_t oldest = 0;
+        for (uint32_t i = 1; i < kEffectMaxPending; ++i)
+        {
+            if (m_pending[i].decidedNs < m_pending[oldest].decidedNs)
+                oldest = i;
+        }
+        return oldest;
+    }
+
+    void Complete(Pending& p, uint64_t nowNs)
+    {
+        LatencyHistogram* h = m_histograms[p.kind];
+        const uint64_t dispatched = p.dispatchedNs ? p.dispatchedNs : p.decidedNs;
+        const uint64_t executed = p.executedNs ? p.executedNs : dispatched;
+
+        if (p.dispatchedNs)
+            h[EffectStage_Queue].Record(Span(p.decidedNs, dispatched));
+        if (p.executedNs)
+            h[EffectStage_Handoff].Record(Span(dispatched, executed));
+        h[EffectStage_Response].Record(Span(executed, nowNs));
+        h[EffectStage_Total].Record(Span(p.decidedNs, nowNs));
+
+        ++m_completed[p.kind];
+        p.token = 0;
+    }
+
+    // Stamps come from different threads — clamp reordering to 0
+    static uint64_t Span(uint64_t from, uint64_t to)
+    {
+        return to > from ? to - from : 0;
+    }
+
+    mutable std::mutex m_lock;
+    Pending m_pending[kEffectMaxPending];
+    uint32_t m_nextSlot;
+    uint32_t m_generation;
+    EffectSnapshot m_last;
+    bool m_haveSnapshot;
+
+    uint64_t m_completed[Effect_KindCount];
+    uint64_t m_expired[Effect_KindCount];
+    LatencyHistogram m_histograms[Effect_KindCount][EffectStage_Count];
+};
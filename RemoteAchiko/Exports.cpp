@@ -0,0 +1,1192 @@
+﻿// Exports.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// extern "C" surface of RemoteAchiko.dll for AchikoDLL (P/Invoke)
+//
+// Responsibilities:
+// • Thin, exception-free wrappers around the native cores
+// • Stable C names and __cdecl convention — matched by NativeMethods.cs
+//
+// Architecture:
+// • RemoteAchiko.dll is already loaded in WoW when managed code runs, so
+//   [DllImport("RemoteAchiko.dll")] binds to the injected module
+// • Every export validates its arguments and never throws across the
+//   boundary — the CLR would turn that into a process-killing SEH
+//
+// Critical Design Decisions:
+// • Timestamps cross the boundary as raw PlatformNowTicks() values
+//   (== Stopwatch.GetTimestamp()) so a managed span costs one call
+// • Strings in: UTF-8 char* for names, UTF-16 wchar_t* for file paths
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include <Windows.h>
+#include <stdio.h>
+#include "ActionQueue.h"
+#include "AllocProfiler.h"
+#include "ConfigStore.h"
+#include "DescriptorBlocks.h"
+#include "EffectTracker.h"
+#include "GrindProfile.h"
+#include "GroupBus.h"
+#include "HookFilter.h"
+#include "HookMeter.h"
+#include "InventorySnapshot.h"
+#include "MemoryMonitor.h"
+#include "ObjectDirectory.h"
+#include "RouteOptimizer.h"
+#include "Sampler.h"
+#include "TickArena.h"
+#include "Trace.h"
+#include "Watchdog.h"
+#include "WorldStore.h"
+
+#define ACHIKO_EXPORT extern "C" __declspec(dllexport)
+
+// ═══════════════════════════════════════════════════════════════
+// TRACING
+// ═══════════════════════════════════════════════════════════════
+
+ACHIKO_EXPORT void __cdecl AchikoTraceSetEnabled(int enabled)
+{
+    TraceRecorder::Instance().SetEnabled(enabled != 0);
+}
+
+ACHIKO_EXPORT int __cdecl AchikoTraceIsEnabled()
+{
+    return TraceRecorder::Instance().Enabled() ? 1 : 0;
+}
+
+ACHIKO_EXPORT uint16_t __cdecl AchikoTraceRegister(const char* name, int category)
+{
+    return TraceRecorder::Instance().RegisterName(name, (uint8_t)category);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoTraceRecord(uint16_t nameId, int64_t startTicks, int64_t endTicks)
+{
+    if (nameId != 0)
+        TraceRecorder::Instance().Record(nameId, (uint64_t)startTicks, (uint64_t)endTicks);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoTraceInstant(uint16_t nameId, int64_t ticks)
+{
+    if (nameId != 0)
+        TraceRecorder::Instance().RecordInstant(nameId, (uint64_t)ticks);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoTraceNameThread(const char* name)
+{
+    TraceRecorder::Instance().NameThread(name);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoTraceExport — write Chrome trace-event JSON to a file
+//
+// Returns:
+//   Number of events written, -1 if the file could not be written
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoTraceExport(const wchar_t* path)
+{
+    if (!path || !*path)
+        return -1;
+
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, path, L"wb") != 0 || !file)
+        return -1;
+
+    const int64_t written = TraceRecorder::Instance().ExportChromeJson(file);
+    if (fclose(file) != 0)
+        return -1;
+
+    return (int)written;
+}
+
+ACHIKO_EXPORT uint64_t __cdecl AchikoTraceDropped()
+{
+    return TraceRecorder::Instance().Dropped();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SAMPLING PROFILER
+// ═══════════════════════════════════════════════════════════════
+
+ACHIKO_EXPORT int __cdecl AchikoProfilerRegisterThread(const char* name)
+{
+    return Sampler::Instance().RegisterCurrentThread(name) ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoProfilerUnregisterThread()
+{
+    Sampler::Instance().UnregisterCurrentThread();
+}
+
+ACHIKO_EXPORT void __cdecl AchikoProfilerAddSymbol(intptr_t start, const char* name)
+{
+    Sampler::Instance().AddManagedSymbol((uintptr_t)start, name);
+}
+
+ACHIKO_EXPORT int __cdecl AchikoProfilerStart(int hz, int budgetPermille)
+{
+    if (hz < 0 || budgetPermille < 0)
+        return 0;
+    return Sampler::Instance().Start((uint32_t)hz, (uint32_t)budgetPermille) ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoProfilerStop()
+{
+    Sampler::Instance().Stop();
+}
+
+ACHIKO_EXPORT int __cdecl AchikoProfilerIsRunning()
+{
+    return Sampler::Instance().Running() ? 1 : 0;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoProfilerDump — write collapsed stacks (flame graph input)
+//
+// Returns:
+//   Number of unique stacks written, -1 if the file could not be written
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoProfilerDump(const wchar_t* path)
+{
+    if (!path || !*path)
+        return -1;
+
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, path, L"wb") != 0 || !file)
+        return -1;
+
+    const int64_t written = Sampler::Instance().WriteCollapsed(file);
+    if (fclose(file) != 0)
+        return -1;
+
+    return (int)written;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoProfilerStats — samples taken, failures, passes, avg pass µs
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT void __cdecl AchikoProfilerStats(uint64_t* samples, uint64_t* failed,
+    int* effectiveHz, int* avgPassUs)
+{
+    const SamplerStats stats = Sampler::Instance().Stats();
+    if (samples) *samples = stats.samples;
+    if (failed) *failed = stats.failed;
+    if (effectiveHz) *effectiveHz = (int)stats.effectiveHz;
+    if (avgPassUs) *avgPassUs = stats.passes ? (int)(stats.passNsTotal / stats.passes / 1000) : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ALLOCATION PROFILER
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// DllGetClassObject — the CLR creates our ICorProfilerCallback2 here
+// (COR_PROFILER_PATH points at this DLL). Exported by name through the
+// linker: the SDK prototype cannot carry __declspec(dllexport).
+// ───────────────────────────────────────────────────────────────
+#ifdef _WIN64
+#pragma comment(linker, "/EXPORT:DllGetClassObject=DllGetClassObject,PRIVATE")
+#else
+#pragma comment(linker, "/EXPORT:DllGetClassObject=_DllGetClassObject@12,PRIVATE")
+#endif
+
+STDAPI DllGetClassObject(REFCLSID clsid, REFIID iid, LPVOID* object)
+{
+    return AllocProfilerGetClassObject(clsid, iid, object);
+}
+
+ACHIKO_EXPORT int __cdecl AchikoAllocIsActive()
+{
+    return AllocProfilerActive() ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoAllocReset()
+{
+    AllocProfilerReset();
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoAllocReport — top allocators as UTF-8 text
+//
+// Returns:
+//   Bytes written into buffer (always terminated), 0 if inactive
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoAllocReport(char* buffer, int capacity, int topN)
+{
+    if (!buffer || capacity <= 0 || topN <= 0)
+        return 0;
+    return (int)AllocProfilerReport(buffer, (size_t)capacity, (uint32_t)topN);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// WATCHDOG
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// AchikoWatchdogRegister — watch the calling thread
+//
+// Returns:
+//   Address of its 32-bit heartbeat counter (the thread keeps storing
+//   an increasing value there), 0 if no slot is free
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT intptr_t __cdecl AchikoWatchdogRegister(const char* name, int timeoutMs)
+{
+    return (intptr_t)Watchdog::Instance().RegisterCurrentThread(name, timeoutMs > 0 ? (uint32_t)timeoutMs : 0);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoWatchdogUnregister()
+{
+    Watchdog::Instance().UnregisterCurrentThread();
+}
+
+ACHIKO_EXPORT uint64_t __cdecl AchikoWatchdogHangs()
+{
+    return Watchdog::Instance().Hangs();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GROUP BUS
+// ═══════════════════════════════════════════════════════════════
+
+// One endpoint per WoW process. GroupBus.cs owns the call discipline:
+// Join / Leave only while its receive thread is stopped, sends
+// serialized, Wait / Receive on the receive thread only. Wait and
+// Publish may move the endpoint to a new slot after a stall
+static GroupBus& Bus()
+{
+    static GroupBus* s_bus = new GroupBus();
+    return *s_bus;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoBusJoin — join (or switch to) the named group
+//
+// Returns:
+//   Member slot, -1 if the bus is unavailable or the group is full
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoBusJoin(const char* group)
+{
+    return Bus().Join(group);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoBusLeave()
+{
+    Bus().Leave();
+}
+
+// Current member slot (changes if a stall cost us the old one), -1 = none
+ACHIKO_EXPORT int __cdecl AchikoBusSlot()
+{
+    return Bus().Slot();
+}
+
+// Returns 1 if the message was queued for slot, 0 if not (full / invalid)
+ACHIKO_EXPORT int __cdecl AchikoBusSend(int slot, const BusMessage* message)
+{
+    if (slot < 0 || !message)
+        return 0;
+    return Bus().Send((uint32_t)slot, *message) ? 1 : 0;
+}
+
+// Returns how many other members accepted the message
+ACHIKO_EXPORT int __cdecl AchikoBusBroadcast(const BusMessage* message)
+{
+    if (!message)
+        return 0;
+    return (int)Bus().Broadcast(*message);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoBusWait — block until messages arrive, then drain them
+//
+// Returns:
+//   Messages written to out (0 on timeout)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoBusWait(BusMessage* out, int capacity, int timeoutMs)
+{
+    if (!out || capacity <= 0)
+        return 0;
+    if (!Bus().Wait(timeoutMs > 0 ? (uint32_t)timeoutMs : 0))
+        return 0;
+    return (int)Bus().Receive(out, (size_t)capacity);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoBusPublish(const BusState* state)
+{
+    if (state)
+        Bus().Publish(*state);
+}
+
+// Returns 1 and fills state if slot has published one
+ACHIKO_EXPORT int __cdecl AchikoBusReadState(int slot, BusState* state)
+{
+    if (slot < 0 || !state)
+        return 0;
+    return Bus().ReadState((uint32_t)slot, *state) ? 1 : 0;
+}
+
+// Live members (self included); slots / pids filled up to max
+ACHIKO_EXPORT int __cdecl AchikoBusMembers(uint32_t* slots, uint32_t* pids, int max)
+{
+    return (int)Bus().Members(slots, pids, max > 0 ? (uint32_t)max : 0);
+}
+
+ACHIKO_EXPORT uint64_t __cdecl AchikoBusDropped()
+{
+    return Bus().Dropped();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ACTION QUEUE
+// ═══════════════════════════════════════════════════════════════
+
+// One queue per WoW process; observations are stamped here, on arrival
+static ActionQueue& Actions()
+{
+    static ActionQueue* s_actions = new ActionQueue();
+    return *s_actions;
+}
+
+static uint64_t MsToNs(int ms)
+{
+    return ms > 0 ? (uint64_t)ms * 1000000ULL : 0;
+}
+
+// Maximum lead before predicted readiness, 0 = reactive
+ACHIKO_EXPORT void __cdecl AchikoActionSetWindow(int windowMs)
+{
+    Actions().SetWindow(MsToNs(windowMs));
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionEnqueue(uint32_t actionId, uint64_t arg)
+{
+    Actions().Enqueue(PlatformNowNs(), actionId, arg);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionCancel()
+{
+    Actions().Cancel();
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionCastStart(uint32_t actionId, int castMs, int gcdMs)
+{
+    Actions().ObserveCastStart(PlatformNowNs(), actionId, MsToNs(castMs), MsToNs(gcdMs));
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionReady()
+{
+    Actions().ObserveReady(PlatformNowNs());
+}
+
+// reason: ActionFailReason
+ACHIKO_EXPORT void __cdecl AchikoActionFailed(uint32_t actionId, int reason)
+{
+    const uint32_t why = (uint32_t)reason;
+    if (why >= ActionFail_NotReady && why <= ActionFail_Local)
+        Actions().ObserveFailed(PlatformNowNs(), actionId, (ActionFailReason)why);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionLatency(int rttMs)
+{
+    if (rttMs > 0)
+        Actions().ObserveLatency(MsToNs(rttMs));
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoActionWait — block until the queued action is due
+//
+// Returns:
+//   1 and fills out (submit it now), 0 on timeout
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoActionWait(ActionSubmit* out, int timeoutMs)
+{
+    if (!out)
+        return 0;
+    return Actions().Wait(timeoutMs > 0 ? (uint32_t)timeoutMs : 0, *out) ? 1 : 0;
+}
+
+// mode: ActionMode (0 = reactive, 1 = queued)
+ACHIKO_EXPORT void __cdecl AchikoActionStats(int mode, ActionStats* out)
+{
+    if (out)
+        Actions().Stats(mode == ActionMode_Reactive ? ActionMode_Reactive : ActionMode_Queued, *out);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoActionResetStats()
+{
+    Actions().ResetStats();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// DECISION → EFFECT LATENCY
+// ═══════════════════════════════════════════════════════════════
+
+static EffectTracker& Effects()
+{
+    static EffectTracker* s_effects = new EffectTracker();
+    return *s_effects;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoEffectDecide — stamp a decision
+//
+// Args:
+//   kind   - EffectKind (0 cast, 1 move, 2 target)
+//   expect - spell id / target GUID the effect must show
+//
+// Returns:
+//   Token for the later stamps, 0 if kind is invalid
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT uint32_t __cdecl AchikoEffectDecide(int kind, uint64_t expect)
+{
+    if (kind < 0 || kind >= (int)Effect_KindCount)
+        return 0;
+    return Effects().Decide(PlatformNowNs(), (EffectKind)kind, expect);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoEffectDispatched(uint32_t token)
+{
+    Effects().Dispatched(token, PlatformNowNs());
+}
+
+ACHIKO_EXPORT void __cdecl AchikoEffectExecuted(uint32_t token)
+{
+    Effects().Executed(token, PlatformNowNs());
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoEffectObserve — match one player snapshot
+//
+// Args:
+//   takenTicks - PlatformNowTicks() / Stopwatch.GetTimestamp() when the
+//                snapshot was read, 0 = now
+//
+// Returns:
+//   Decisions this snapshot completed
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoEffectObserve(const EffectSnapshot* snapshot, int64_t takenTicks)
+{
+    if (!snapshot)
+        return 0;
+    const uint64_t takenNs = takenTicks > 0 ? PlatformTicksToNs((uint64_t)takenTicks) : PlatformNowNs();
+    return (int)Effects().Observe(takenNs, *snapshot);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoEffectStats(int kind, EffectKindStats* out)
+{
+    if (out)
+        Effects().Stats(kind >= 0 ? (EffectKind)kind : Effect_KindCount, *out);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoEffectReset()
+{
+    Effects().Reset();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// TICK ARENA
+// ═══════════════════════════════════════════════════════════════
+
+// The bot thread's arena — every span handed to managed code points
+// here and stays valid until AchikoArenaEndTick. Bot thread only.
+static TickArena& BotArena()
+{
+    static TickArena* s_arena = new TickArena();
+    return *s_arena;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoArenaEndTick — release this tick's results
+//
+// Returns:
+//   The new generation; spans carrying an older one are stale
+//
+// Notes:
+//   • Also reports the arena's footprint to the memory budget and
+//     honours a pending trim — the arena is empty right here
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT uint32_t __cdecl AchikoArenaEndTick()
+{
+    TickArena& arena = BotArena();
+    const uint32_t generation = arena.Reset();
+
+    MemoryBudget& budget = MemoryMonitor::Instance().Budget();
+    uint64_t target = 0;
+    if (budget.TakeTrim(MemOwner_Arena, target))
+        arena.Trim((size_t)target);
+
+    TickArenaStats stats;
+    arena.Stats(stats);
+    budget.ReportUsage(MemOwner_Arena, stats.reservedBytes);
+    return generation;
+}
+
+ACHIKO_EXPORT uint32_t __cdecl AchikoArenaGeneration()
+{
+    return BotArena().Generation();
+}
+
+// Debug: overwrite released memory with 0xDD
+ACHIKO_EXPORT void __cdecl AchikoArenaSetPoison(int enabled)
+{
+    BotArena().SetPoison(enabled != 0);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoArenaStats(TickArenaStats* out)
+{
+    if (out)
+        BotArena().Stats(*out);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// OBJECT SNAPSHOT
+// ═══════════════════════════════════════════════════════════════
+
+// Built by AchikoObjectsConfigure; used from the bot thread only
+static ObjectDirectory* s_objectDirectory = nullptr;
+static DescriptorBlocks* s_descriptorBlocks = nullptr;
+
+// ───────────────────────────────────────────────────────────────
+// AchikoObjectsConfigure — (re)build the directory for a layout
+//
+// Notes:
+//   • Offsets change with the client build, so they come from
+//     managed code; reconfiguring starts over with a full walk
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoObjectsConfigure(const ObjectSnapshotLayout* layout)
+{
+    if (!layout || !layout->descriptorSize)
+        return 0;
+
+    ObjectListLayout list;
+    list.managerFirstObject = layout->managerFirstObject;
+    list.managerCount = layout->managerCount;
+    list.objectNext = layout->objectNext;
+    list.objectGuid = layout->objectGuid;
+
+    delete s_objectDirectory;
+    delete s_descriptorBlocks;
+    s_objectDirectory = new ObjectDirectory(list);
+    s_descriptorBlocks = new DescriptorBlocks(layout->objectDescriptors, layout->descriptorSize);
+    return 1;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoObjectsSnapshot — this tick's objects, as arena spans
+//
+// Args:
+//   manager     - object manager address (0 = not in world)
+//   guids       - [out] uint64 GUID per object, list order
+//   descriptors - [out] descriptor block copy per object (same order;
+//                 a block that faulted reads as zeros)
+//
+// Returns:
+//   Object count; -1 if not configured
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoObjectsSnapshot(intptr_t manager, ArenaSpan* guids, ArenaSpan* descriptors)
+{
+    if (!guids || !descriptors)
+        return -1;
+
+    TickArena& arena = BotArena();
+    *guids = arena.Span(nullptr, 0, sizeof(uint64_t));
+    *descriptors = arena.Span(nullptr, 0, 0);
+    if (!s_objectDirectory)
+        return -1;
+
+    const size_t count = s_objectDirectory->Refresh((uintptr_t)manager);
+
+    // The directory's own list changes next tick — hand out an arena copy
+    uint64_t* copy = arena.AllocateArray<uint64_t>(count);
+    if (!copy)
+        return 0;
+    memcpy(copy, s_objectDirectory->Guids(), count * sizeof(uint64_t));
+    *guids = arena.Span(copy, count, sizeof(uint64_t));
+
+    s_descriptorBlocks->Capture(arena, s_objectDirectory->Addresses(), count);
+    *descriptors = s_descriptorBlocks->Span(arena);
+    return (int)count;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoObjectsStats(ObjectDirectoryStats* directory, DescriptorBlockStats* blocks)
+{
+    if (directory)
+    {
+        memset(directory, 0, sizeof(*directory));
+        if (s_objectDirectory)
+            s_objectDirectory->Stats(*directory);
+    }
+    if (blocks)
+    {
+        memset(blocks, 0, sizeof(*blocks));
+        if (s_descriptorBlocks)
+            s_descriptorBlocks->Stats(*blocks);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MEMORY BUDGET
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// AchikoMemoryStart — start the address-space monitor thread
+//
+// Notes:
+//   • Idempotent; a second call only changes the interval
+//     (minimum 500 ms)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT void __cdecl AchikoMemoryStart(uint32_t intervalMs)
+{
+    MemoryMonitor::Instance().Start(intervalMs);
+}
+
+// Budget for one owner (MemoryOwner); 0 removes it
+ACHIKO_EXPORT void __cdecl AchikoMemorySetBudget(uint32_t owner, uint64_t bytes)
+{
+    MemoryMonitor::Instance().Budget().SetBudget((MemoryOwner)owner, bytes);
+}
+
+// Private-memory usage of an owner the address map cannot attribute
+ACHIKO_EXPORT void __cdecl AchikoMemoryReportUsage(uint32_t owner, uint64_t bytes)
+{
+    MemoryMonitor::Instance().Budget().ReportUsage((MemoryOwner)owner, bytes);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoMemoryTakeTrim — drain an owner's pending trim request
+//
+// Returns:
+//   1 and *targetBytes = size to shrink to; 0 if none pending
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoMemoryTakeTrim(uint32_t owner, uint64_t* targetBytes)
+{
+    uint64_t target = 0;
+    if (!MemoryMonitor::Instance().Budget().TakeTrim((MemoryOwner)owner, target))
+        return 0;
+    if (targetBytes)
+        *targetBytes = target;
+    return 1;
+}
+
+// Scan + evaluate on the calling thread; returns the pressure level
+ACHIKO_EXPORT uint32_t __cdecl AchikoMemoryScanNow()
+{
+    return MemoryMonitor::Instance().ScanNow();
+}
+
+ACHIKO_EXPORT void __cdecl AchikoMemorySummary(MemorySummary* out)
+{
+    if (out)
+        MemoryMonitor::Instance().Budget().Summary(*out);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// WORLD STORE
+// ═══════════════════════════════════════════════════════════════
+
+// Opened by AchikoWorldOpen; queries from any thread, compaction on
+// the store's own worker
+static WorldStore& World()
+{
+    static WorldStore* s_world = new WorldStore();
+    return *s_world;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoWorldOpen — open (or create) the store in a directory
+//
+// Returns:
+//   1 on success, 0 if the directory / log cannot be opened
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoWorldOpen(const wchar_t* dir)
+{
+    return World().Open(dir) ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoWorldClose()
+{
+    World().Close();
+}
+
+// 1 logged, 0 already known (recent sighting of that spot), -1 not open
+// or the position is out of range (NaN, ±inf, beyond kWorldMaxCoordinate)
+ACHIKO_EXPORT int __cdecl AchikoWorldRecord(const WorldSighting* sighting)
+{
+    return sighting ? World().Record(*sighting) : -1;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoWorldNearest — closest known spot of a kind (entry 0 = any)
+//
+// Returns:
+//   1 and *out filled, 0 if nothing within maxRadius
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoWorldNearest(uint32_t map, uint32_t kind, uint32_t entry,
+                                             float x, float y, float maxRadius, WorldSighting* out)
+{
+    if (!out)
+        return 0;
+    return World().Nearest(map, (uint16_t)kind, entry, x, y, maxRadius, *out) ? 1 : 0;
+}
+
+// Spots within radius → out[0..max); returns how many were written
+ACHIKO_EXPORT int __cdecl AchikoWorldQueryRadius(uint32_t map, uint32_t kind, uint32_t entry,
+                                                 float x, float y, float radius, WorldSighting* out, int max)
+{
+    if (!out || max <= 0)
+        return 0;
+    return (int)World().QueryRadius(map, (uint16_t)kind, entry, x, y, radius, out, (size_t)max);
+}
+
+// Asks the worker to merge the log into a new base now
+ACHIKO_EXPORT void __cdecl AchikoWorldCompact()
+{
+    World().RequestCompaction();
+}
+
+ACHIKO_EXPORT void __cdecl AchikoWorldStats(WorldStoreStats* out)
+{
+    if (out)
+        World().Stats(*out);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GRIND PROFILE
+// ═══════════════════════════════════════════════════════════════
+
+// Loaded by GRIND_LOAD, queried by the bot thread
+static GrindProfileSlot& Grind()
+{
+    static GrindProfileSlot* s_grind = new GrindProfileSlot();
+    return *s_grind;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoGrindOpen — map a profile as the loaded one
+//
+// Returns:
+//   1 on success, 0 if missing or invalid (nothing stays loaded)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoGrindOpen(const wchar_t* path)
+{
+    return path && Grind().Open(path) ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoGrindClose()
+{
+    Grind().Close();
+}
+
+// 1 and *out filled, 0 if no profile is loaded
+ACHIKO_EXPORT int __cdecl AchikoGrindInfo(GrindProfileInfo* out)
+{
+    return out && Grind().Info(*out) ? 1 : 0;
+}
+
+// index-th hotspot in visit order; 0 past the end
+ACHIKO_EXPORT int __cdecl AchikoGrindHotspot(uint32_t index, GrindHotspot* out)
+{
+    return out && Grind().Hotspot(index, *out) ? 1 : 0;
+}
+
+// Waypoints [first, first + max) → out; returns how many were written
+ACHIKO_EXPORT int __cdecl AchikoGrindWaypoints(uint32_t first, GrindWaypoint* out, int max)
+{
+    if (!out || max <= 0)
+        return 0;
+    return (int)Grind().Waypoints(first, out, (size_t)max);
+}
+
+ACHIKO_EXPORT int __cdecl AchikoGrindNearestVendor(float x, float y, float z, uint32_t services, GrindVendor* out)
+{
+    return out && Grind().NearestVendor(x, y, z, services, *out) ? 1 : 0;
+}
+
+ACHIKO_EXPORT int __cdecl AchikoGrindIsBlacklisted(uint32_t entry)
+{
+    return Grind().IsBlacklisted(entry) ? 1 : 0;
+}
+
+ACHIKO_EXPORT int __cdecl AchikoGrindInBlackArea(float x, float y, float z)
+{
+    return Grind().InBlackArea(x, y, z) ? 1 : 0;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoGrindCreate — write a profile (authoring order route)
+//
+// Returns:
+//   1 on success, 0 on bad arguments or a failed write
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoGrindCreate(const wchar_t* path, const char* name, uint32_t map,
+                                            const GrindHotspot* hotspots, int hotspotCount,
+                                            const GrindWaypoint* waypoints, int waypointCount,
+                                            const GrindBlackArea* blackAreas, int blackAreaCount,
+                                            const GrindVendor* vendors, int vendorCount,
+                                            const uint32_t* blacklist, int blacklistCount)
+{
+    if (!path || hotspotCount < 0 || waypointCount < 0 || blackAreaCount < 0 ||
+        vendorCount < 0 || blacklistCount < 0 ||
+        (hotspotCount && !hotspots) || (waypointCount && !waypoints) ||
+        (blackAreaCount && !blackAreas) || (vendorCount && !vendors) || (blacklistCount && !blacklist))
+        return 0;
+
+    GrindProfileData data;
+    data.name = name ? name : "";
+    data.map = map;
+    data.hotspots.assign(hotspots, hotspots + hotspotCount);
+    data.waypoints.assign(waypoints, waypoints + waypointCount);
+    data.blackAreas.assign(blackAreas, blackAreas + blackAreaCount);
+    data.vendors.assign(vendors, vendors + vendorCount);
+    data.blacklistEntries.assign(blacklist, blacklist + blacklistCount);
+
+    return Grind().Rewrite(path, [&]() { return GrindWriteProfile(path, data); }) ? 1 : 0;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoGrindOptimize — reorder a profile's route (blocks; seconds
+// for a few hundred hotspots)
+//
+// Args:
+//   costs     - hotspots² travel costs (row = from), or null for
+//               straight-line costs with a climb penalty
+//   costCount - elements in costs
+//   threads   - 0 = every logical CPU
+//
+// Returns:
+//   1 and *out filled, 0 if the profile cannot be read or rewritten
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoGrindOptimize(const wchar_t* path, const float* costs, int costCount,
+                                              uint32_t threads, RouteReport* out)
+{
+    if (!path || !out || costCount < 0)
+        return 0;
+
+    RouteOptions options;
+    options.threads = threads;
+    GrindProfileData data;
+    if (!GrindPlanRoute(path, costs, (size_t)costCount, options, data, *out))
+        return 0;
+    return Grind().Rewrite(path, [&]() { return GrindWriteProfile(path, data); }) ? 1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// INVENTORY
+// ═══════════════════════════════════════════════════════════════
+
+// Built by AchikoInventoryConfigure; bot thread only, after the
+// object snapshot (items resolve through s_objectDirectory)
+static InventorySnapshot* s_inventory = nullptr;
+
+ACHIKO_EXPORT int __cdecl AchikoInventoryConfigure(const InventoryLayout* layout)
+{
+    if (!layout || !layout->packSlotCount)
+        return 0;
+
+    delete s_inventory;
+    s_inventory = new InventorySnapshot(*layout);
+    return 1;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoInventoryRefresh — re-read the bags, diff against last time
+//
+// Args:
+//   playerGuid - local player
+//   events     - [out] change events since the last refresh (arena)
+//   hash       - [out] whole-inventory hash; unchanged = same contents
+//
+// Returns:
+//   Event count; -1 if inventory or object snapshot is not configured
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoInventoryRefresh(uint64_t playerGuid, ArenaSpan* events, uint32_t* hash)
+{
+    if (!events || !hash)
+        return -1;
+
+    TickArena& arena = BotArena();
+    *events = arena.Span(nullptr, 0, sizeof(InventoryEvent));
+    *hash = 0;
+    if (!s_inventory || !s_objectDirectory)
+        return -1;
+
+    InventoryEvent* out = nullptr;
+    const size_t count = s_inventory->Refresh(*s_objectDirectory, playerGuid, arena, out);
+    *events = arena.Span(out, count, sizeof(InventoryEvent));
+    *hash = s_inventory->Hash();
+    return (int)count;
+}
+
+// Occupied slots in bag order, copied into the bot arena
+ACHIKO_EXPORT int __cdecl AchikoInventorySlots(ArenaSpan* slots)
+{
+    if (!slots)
+        return -1;
+
+    TickArena& arena = BotArena();
+    *slots = arena.Span(nullptr, 0, sizeof(InventorySlot));
+    if (!s_inventory)
+        return -1;
+
+    InventorySlot* copy = arena.AllocateArray<InventorySlot>(kInventoryBags * kInventoryBagSlots);
+    if (!copy)
+        return 0;
+    const size_t count = s_inventory->CopySlots(copy, kInventoryBags * kInventoryBagSlots);
+    *slots = arena.Span(copy, count, sizeof(InventorySlot));
+    return (int)count;
+}
+
+// 1 and *out filled once the client knows the item, 0 otherwise
+ACHIKO_EXPORT int __cdecl AchikoInventoryItemInfo(uint32_t entry, ItemInfo* out)
+{
+    if (!out || !s_inventory)
+        return 0;
+
+    const ItemInfo* info = s_inventory->Info().Lookup(entry);
+    if (!info || !info->resolved)
+        return 0;
+    *out = *info;
+    return 1;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoInventoryStats(InventoryStats* out)
+{
+    if (!out)
+        return;
+    memset(out, 0, sizeof(*out));
+    if (s_inventory)
+        s_inventory->Stats(*out);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CONFIG
+// ═══════════════════════════════════════════════════════════════
+
+// Opened by Config.Open at load; watcher thread owned by the store
+static ConfigStore& Config()
+{
+    static ConfigStore* s_config = new ConfigStore();
+    return *s_config;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoConfigOpen — map binPath (compiling textPath when newer) and
+// watch both for changes
+//
+// Args:
+//   textPath - may be null: only the .bin is watched
+//
+// Returns:
+//   1 if watching, 0 on bad arguments or if already open. A missing
+//   config is not an error — generation stays 0 until one appears
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoConfigOpen(const wchar_t* binPath, const wchar_t* textPath)
+{
+    if (!binPath)
+        return 0;
+    return Config().Open(binPath, textPath ? textPath : L"") ? 1 : 0;
+}
+
+ACHIKO_EXPORT void __cdecl AchikoConfigClose()
+{
+    Config().Close();
+}
+
+// Check both files now instead of at the next poll; 1 if a new image
+// went live
+ACHIKO_EXPORT int __cdecl AchikoConfigReload()
+{
+    return Config().ReloadNow() ? 1 : 0;
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoConfigView — pointers into the current image
+//
+// Notes:
+//   • Valid until kConfigGraceMs after the generation moves; managed
+//     code re-reads the view whenever it sees a new generation
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT void __cdecl AchikoConfigView(ConfigViewInfo* out)
+{
+    if (out)
+        Config().View(*out);
+}
+
+// Address of the generation word — read by managed code on every
+// lookup instead of a call
+ACHIKO_EXPORT const uint32_t* __cdecl AchikoConfigGenerationAddress()
+{
+    return Config().GenerationAddress();
+}
+
+ACHIKO_EXPORT void __cdecl AchikoConfigStats(ConfigStats* out)
+{
+    if (out)
+        Config().Stats(*out);
+}
+
+// Why the last compile / image was rejected → out (NUL-terminated);
+// returns its length, 0 if nothing was rejected
+ACHIKO_EXPORT int __cdecl AchikoConfigLastError(char* out, int size)
+{
+    if (!out || size <= 0)
+        return 0;
+    const std::string error = Config().LastError();
+    const size_t length = std::min(error.size(), (size_t)size - 1);
+    memcpy(out, error.data(), length);
+    out[length] = '\0';
+    return (int)length;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// HOOK METER
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// AchikoHookRegister — intern a hook for cost accounting
+//
+// Args:
+//   budgetUs - time the hook may add per frame before it alarms (0 = never)
+//   flags    - HookFlag_Frame for the hook whose invocations end frames
+//
+// Returns:
+//   Hook id (same name → same id), 0 if the table is full
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoHookRegister(const char* name, uint32_t budgetUs, uint32_t flags)
+{
+    return HookMeter::Instance().Register(name, budgetUs, flags);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoHookSetBudget(uint32_t id, uint32_t budgetUs)
+{
+    if (id < kHookMaxHooks)
+        HookMeter::Instance().SetBudget((uint16_t)id, budgetUs);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoHookRecord — one invocation of a managed hook body
+//
+// Args:
+//   startTicks / endTicks - Stopwatch.GetTimestamp() (same clock as
+//                           PlatformNowTicks on Windows)
+//   transitions           - native → managed crossings it took
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT void __cdecl AchikoHookRecord(uint32_t id, uint64_t startTicks, uint64_t endTicks, uint32_t transitions)
+{
+    if (id < kHookMaxHooks)
+        HookMeter::Instance().Record((uint16_t)id, startTicks, endTicks, transitions);
+}
+
+// End the current frame (only when no hook is registered with HookFlag_Frame)
+ACHIKO_EXPORT void __cdecl AchikoHookFrameEnd()
+{
+    HookMeter::Instance().FrameEnd();
+}
+
+// Per-hook totals over every thread → out; returns how many were written
+ACHIKO_EXPORT int __cdecl AchikoHookStats(HookStats* out, int capacity)
+{
+    if (!out || capacity <= 0)
+        return 0;
+    return (int)HookMeter::Instance().Stats(out, (uint32_t)capacity);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoHookSummary(HookMeterSummary* out)
+{
+    if (out)
+        HookMeter::Instance().Summary(*out);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoHookReset()
+{
+    HookMeter::Instance().Reset();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// HOOK FILTER
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// AchikoHookFilterInstall — filtered hook on a game function
+//
+// Args:
+//   name          - filter name (same name → same id)
+//   target        - function entry to patch
+//   source        - HookFilterSource: where the watched id is read
+//   prologueBytes - whole instructions to relocate (≥ 5)
+//
+// Returns:
+//   Filter id, 0 on failure (AchikoHookFilterLastError)
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoHookFilterInstall(const char* name, intptr_t target, uint32_t source, uint32_t prologueBytes)
+{
+    HookFilter& filter = HookFilter::Instance();
+    const uint16_t id = filter.Register(name, source);
+    if (id == 0)
+        return 0;
+    return filter.Install(id, (uintptr_t)target, prologueBytes) ? id : 0;
+}
+
+ACHIKO_EXPORT int __cdecl AchikoHookFilterRemove(uint32_t id)
+{
+    return HookFilter::Instance().Remove((uint16_t)id) ? 1 : 0;
+}
+
+// Set (watch != 0) or clear ids in the filter's bitset; returns bits changed
+ACHIKO_EXPORT int __cdecl AchikoHookFilterWatch(uint32_t id, const uint32_t* ids, int count, int watch)
+{
+    if (count <= 0)
+        return 0;
+    return (int)HookFilter::Instance().Watch((uint16_t)id, ids, (uint32_t)count, watch != 0);
+}
+
+// ───────────────────────────────────────────────────────────────
+// AchikoHookFilterDrain — every watched call since the last drain
+//
+// Args:
+//   events - [out] HookEvent array in the bot arena (oldest first)
+//
+// Returns:
+//   Event count. Bot thread only, once per tick
+// ───────────────────────────────────────────────────────────────
+ACHIKO_EXPORT int __cdecl AchikoHookFilterDrain(ArenaSpan* events)
+{
+    if (!events)
+        return -1;
+
+    TickArena& arena = BotArena();
+    HookFilter& filter = HookFilter::Instance();
+    *events = arena.Span(nullptr, 0, sizeof(HookEvent));
+
+    // Events pushed after Pending() wait for the next tick
+    const size_t pending = filter.Pending();
+    HookEvent* out = pending ? arena.AllocateArray<HookEvent>(pending) : nullptr;
+    const uint32_t count = filter.Drain(out, out ? (uint32_t)pending : 0);
+    *events = arena.Span(out, count, sizeof(HookEvent));
+    return (int)count;
+}
+
+// Per-filter counters → out; returns how many were written
+ACHIKO_EXPORT int __cdecl AchikoHookFilterStats(HookFilterStats* out, int capacity)
+{
+    if (!out || capacity <= 0)
+        return 0;
+    return (int)HookFilter::Instance().Stats(out, (uint32_t)capacity);
+}
+
+ACHIKO_EXPORT void __cdecl AchikoHookFilterSummary(HookFilterSummary* out)
+{
+    if (out)
+        HookFilter::Instance().Summary(*out);
+}
+
+ACHIKO_EXPORT int __cdecl AchikoHookFilterLastError(char* out, int size)
+{
+    if (!out || size <= 0)
+        return 0;
+    const std::string error = HookFilter::Instance().LastError();
+    const size_t length = std::min(error.size(), (size_t)size - 1);
+    memcpy(out, error.data(), length);
+    out[length] = '\0';
+    return (int)length;
+}
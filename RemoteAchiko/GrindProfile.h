@@ -0,0 +1,496 @@
+﻿// GrindProfile.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Binary grind profile — hotspots, waypoints, blacklists and vendors in one
+// memory-mapped file
+//
+// Responsibilities:
+// • GrindProfile: map a profile, validate it, expose every section as a
+//   typed array straight from the mapping; blacklist / vendor lookups
+// • GrindProfileSlot: the loaded profile behind a lock (Exports.cpp)
+// • GrindProfileData + GrindWriteProfile: build / rewrite a profile
+//   (authoring, route optimizer output)
+// • GrindTravelCost: the default hotspot-to-hotspot cost
+//
+// Architecture:
+// • Layout: header, then fixed-size sections back to back —
+//     hotspots[]  route[] (visit order)  waypoints[]  blackAreas[]
+//     vendors[]  blacklistEntries[] (sorted)
+//   Every section is 4-byte aligned; the header carries the counts
+// • Loading = map + check sizes, route[] and blacklist order. Nothing
+//   is parsed or copied; records are read from the page cache when
+//   first touched
+// • Writing goes to "<path>.tmp" and is renamed over the old file
+//
+// Critical Design Decisions:
+// • route[] is separate from hotspots[]: authors keep their hotspot
+//   order, the optimizer only rewrites the visit order and both tour
+//   costs (handCost = authoring order, routeCost = route)
+// • A file whose section sizes do not add up, whose route[] is not a
+//   permutation of the hotspots or whose blacklist is unsorted is
+//   rejected whole — every index read later is trusted
+// • Replacing a file that is mapped fails on Windows: close the profile
+//   before rewriting it (GrindProfileSlot::Rewrite does)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+static const uint32_t kGrindVersion = 1;
+
+// ═══════════════════════════════════════════════════════════════
+// Records (layouts shared with GrindProfile.cs)
+// ═══════════════════════════════════════════════════════════════
+struct GrindHotspot
+{
+    float x, y, z;
+    float radius;              // pull area around the point
+};
+
+struct GrindWaypoint
+{
+    float x, y, z;
+    uint32_t flags;            // caller-defined (jump, mount, ...)
+};
+
+struct GrindBlackArea
+{
+    float x, y, z;
+    float radius;              // never path or pull inside
+};
+
+struct GrindVendor
+{
+    float x, y, z;
+    uint32_t entry;            // creature entry
+    uint32_t services;         // GrindVendorService bits
+    uint32_t reserved;
+};
+
+enum GrindVendorService : uint32_t
+{
+    GrindService_Sell = 1,
+    GrindService_Repair = 2,
+    GrindService_Food = 4,
+    GrindService_Ammo = 8,
+};
+
+struct GrindProfileHeader
+{
+    char magic[4];             // "AGPF"
+    uint32_t version;
+    uint32_t map;
+    uint32_t flags;
+    uint32_t hotspots;
+    uint32_t waypoints;
+    uint32_t blackAreas;
+    uint32_t blacklistEntries;
+    uint32_t vendors;
+    uint32_t reserved;
+    float routeCost;           // tour cost of route[]
+    float handCost;            // tour cost in hotspot (authoring) order
+    char name[32];             // UTF-8, NUL-padded
+};
+
+// ═══════════════════════════════════════════════════════════════
+// GrindTravelCost — default cost from a to b
+//
+// Notes:
+//   Straight-line distance, climbs counted three times (slopes,
+//   switchbacks). Asymmetric on purpose — the optimizer takes a full
+//   cost matrix, so navmesh path lengths drop in unchanged
+// ═══════════════════════════════════════════════════════════════
+inline float GrindTravelCost(const GrindHotspot& a, const GrindHotspot& b)
+{
+    const float dx = b.x - a.x, dy = b.y - a.y, dz = b.z - a.z;
+    const float flat = sqrtf(dx * dx + dy * dy + dz * dz);
+    return dz > 0.0f ? flat + 2.0f * dz : flat;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GrindProfile — one mapped profile
+// ═══════════════════════════════════════════════════════════════
+class GrindProfile
+{
+public:
+    GrindProfile() : m_header(nullptr) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Open — map and validate
+    //
+    // Returns:
+    //   false if the file is missing, not a profile, truncated, or
+    //   breaks what GrindWriteProfile guarantees (route permutation,
+    //   sorted blacklist)
+    // ───────────────────────────────────────────────────────────────
+    bool Open(const MappedPathChar* path)
+    {
+        Close();
+        if (!m_file.Open(path) || m_file.Size() < sizeof(GrindProfileHeader))
+            return false;
+
+        const GrindProfileHeader* h = (const GrindProfileHeader*)m_file.Data();
+        if (memcmp(h->magic, "AGPF", 4) != 0 || h->version != kGrindVersion)
+            return false;
+
+        const uint64_t expected = sizeof(GrindProfileHeader) +
+            (uint64_t)h->hotspots * (sizeof(GrindHotspot) + sizeof(uint32_t)) +
+            (uint64_t)h->waypoints * sizeof(GrindWaypoint) +
+            (uint64_t)h->blackAreas * sizeof(GrindBlackArea) +
+            (uint64_t)h->vendors * sizeof(GrindVendor) +
+            (uint64_t)h->blacklistEntries * sizeof(uint32_t);
+        if (expected != m_file.Size())
+            return false;
+
+        // Hotspot(index) indexes hotspots[] through route[] unchecked
+        const uint32_t* route = (const uint32_t*)((const GrindHotspot*)(h + 1) + h->hotspots);
+        std::vector<uint8_t> seen(h->hotspots, 0);
+        for (uint32_t i = 0; i < h->hotspots; ++i)
+        {
+            if (route[i] >= h->hotspots || seen[route[i]])
+                return false;
+            seen[route[i]] = 1;
+        }
+
+        m_header = h;
+        const uint32_t* entries = BlacklistEntries();
+        if (!std::is_sorted(entries, entries + h->blacklistEntries))
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+        m_header = nullptr;
+        m_file.Close();
+    }
+
+    bool IsOpen() const { return m_header != nullptr; }
+    const GrindProfileHeader& Header() const { return *m_header; }
+    size_t Bytes() const { return m_file.Size(); }
+
+    const GrindHotspot* Hotspots() const { return (const GrindHotspot*)(m_header + 1); }
+    const uint32_t* Route() const { return (const uint32_t*)(Hotspots() + m_header->hotspots); }
+    const GrindWaypoint* Waypoints() const { return (const GrindWaypoint*)(Route() + m_header->hotspots); }
+    const GrindBlackArea* BlackAreas() const { return (const GrindBlackArea*)(Waypoints() + m_header->waypoints); }
+    const GrindVendor* Vendors() const { return (const GrindVendor*)(BlackAreas() + m_header->blackAreas); }
+    const uint32_t* BlacklistEntries() const { return (const uint32_t*)(Vendors() + m_header->vendors); }
+
+    bool IsBlacklisted(uint32_t entry) const
+    {
+        const uint32_t* begin = BlacklistEntries();
+        return std::binary_search(begin, begin + m_header->blacklistEntries, entry);
+    }
+
+    bool InBlackArea(float x, float y, float z) const
+    {
+        const GrindBlackArea* areas = BlackAreas();
+        for (uint32_t i = 0; i < m_header->blackAreas; ++i)
+        {
+            const float dx = areas[i].x - x, dy = areas[i].y - y, dz = areas[i].z - z;
+            if (dx * dx + dy * dy + dz * dz <= areas[i].radius * areas[i].radius)
+                return true;
+        }
+        return false;
+    }
+
+    // Closest vendor offering every service in mask; null if none
+    const GrindVendor* NearestVendor(float x, float y, float z, uint32_t services) const
+    {
+        const GrindVendor* vendors = Vendors();
+        const GrindVendor* best = nullptr;
+        float bestSq = 0.0f;
+        for (uint32_t i = 0; i < m_header->vendors; ++i)
+        {
+            if ((vendors[i].services & services) != services)
+                continue;
+            const float dx = vendors[i].x - x, dy = vendors[i].y - y, dz = vendors[i].z - z;
+            const float sq = dx * dx + dy * dy + dz * dz;
+            if (!best || sq < bestSq)
+            {
+                best = &vendors[i];
+                bestSq = sq;
+            }
+        }
+        return best;
+    }
+
+private:
+    GrindProfile(const GrindProfile&) = delete;
+    GrindProfile& operator=(const GrindProfile&) = delete;
+
+    MappedFile m_file;
+    const GrindProfileHeader* m_header;    // null while closed
+};
+
+// Layout shared with GrindProfile.cs
+struct GrindProfileInfo
+{
+    uint32_t map;
+    uint32_t hotspots;
+    uint32_t waypoints;
+    uint32_t blackAreas;
+    uint32_t blacklistEntries;
+    uint32_t vendors;
+    float routeCost;
+    float handCost;
+    uint64_t mappedBytes;
+    uint64_t openNs;           // last Open: map + validate
+    char name[32];
+};
+
+// ═══════════════════════════════════════════════════════════════
+// GrindProfileSlot — the bot's loaded profile, shared across threads
+//
+// Notes:
+//   Readers copy records out under the lock, so a profile can be
+//   swapped (GRIND_LOAD) or rewritten (GRIND_OPTIMIZE) while the bot
+//   thread queries it
+// ═══════════════════════════════════════════════════════════════
+class GrindProfileSlot
+{
+public:
+    GrindProfileSlot() : m_openNs(0) {}
+
+    bool Open(const MappedPathChar* path)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return OpenLocked(path);
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_profile.Close();
+        m_path.clear();
+    }
+
+    bool Info(GrindProfileInfo& out)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        memset(&out, 0, sizeof(out));
+        if (!m_profile.IsOpen())
+            return false;
+
+        const GrindProfileHeader& h = m_profile.Header();
+        out.map = h.map;
+        out.hotspots = h.hotspots;
+        out.waypoints = h.waypoints;
+        out.blackAreas = h.blackAreas;
+        out.blacklistEntries = h.blacklistEntries;
+        out.vendors = h.vendors;
+        out.routeCost = h.routeCost;
+        out.handCost = h.handCost;
+        out.mappedBytes = m_profile.Bytes();
+        out.openNs = m_openNs;
+        memcpy(out.name, h.name, sizeof(out.name));
+        out.name[sizeof(out.name) - 1] = 0;
+        return true;
+    }
+
+    // index-th hotspot in route (visit) order
+    bool Hotspot(uint32_t index, GrindHotspot& out)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_profile.IsOpen() || index >= m_profile.Header().hotspots)
+            return false;
+        out = m_profile.Hotspots()[m_profile.Route()[index]];
+        return true;
+    }
+
+    size_t Waypoints(uint32_t first, GrindWaypoint* out, size_t max)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_profile.IsOpen() || first >= m_profile.Header().waypoints)
+            return 0;
+        const size_t count = std::min(max, (size_t)(m_profile.Header().waypoints - first));
+        memcpy(out, m_profile.Waypoints() + first, count * sizeof(GrindWaypoint));
+        return count;
+    }
+
+    bool NearestVendor(float x, float y, float z, uint32_t services, GrindVendor& out)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        const GrindVendor* vendor = m_profile.IsOpen() ? m_profile.NearestVendor(x, y, z, services) : nullptr;
+        if (vendor)
+            out = *vendor;
+        return vendor != nullptr;
+    }
+
+    bool IsBlacklisted(uint32_t entry)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_profile.IsOpen() && m_profile.IsBlacklisted(entry);
+    }
+
+    bool InBlackArea(float x, float y, float z)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_profile.IsOpen() && m_profile.InBlackArea(x, y, z);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Rewrite — run write() against path; if that is the loaded
+    // profile it is unmapped first and mapped again afterwards
+    // ───────────────────────────────────────────────────────────────
+    template <typename WriteFn>
+    bool Rewrite(const MappedPathChar* path, WriteFn write)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        const bool loaded = m_profile.IsOpen() && m_path == path;
+        if (loaded)
+            m_profile.Close();
+        const bool ok = write();
+        if (loaded)
+            OpenLocked(std::basic_string<MappedPathChar>(m_path).c_str());
+        return ok;
+    }
+
+private:
+    bool OpenLocked(const MappedPathChar* path)
+    {
+        const uint64_t start = PlatformNowNs();
+        const bool ok = m_profile.Open(path);
+        m_openNs = PlatformNowNs() - start;
+        m_path = ok ? path : std::basic_string<MappedPathChar>();
+        return ok;
+    }
+
+    std::mutex m_lock;
+    GrindProfile m_profile;
+    std::basic_string<MappedPathChar> m_path;
+    uint64_t m_openNs;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// WRITING
+// ═══════════════════════════════════════════════════════════════
+
+// Everything a profile holds, as plain vectors
+struct GrindProfileData
+{
+    std::string name;
+    uint32_t map;
+    uint32_t flags;
+    float routeCost;
+    float handCost;
+    std::vector<GrindHotspot> hotspots;
+    std::vector<uint32_t> route;           // empty = authoring order
+    std::vector<GrindWaypoint> waypoints;
+    std::vector<GrindBlackArea> blackAreas;
+    std::vector<GrindVendor> vendors;
+    std::vector<uint32_t> blacklistEntries;
+
+    GrindProfileData() : map(0), flags(0), routeCost(0), handCost(0) {}
+
+    // Copies a mapped profile (to rewrite it)
+    void From(const GrindProfile& profile)
+    {
+        const GrindProfileHeader& h = profile.Header();
+        name.assign(h.name, strnlen(h.name, sizeof(h.name)));
+        map = h.map;
+        flags = h.flags;
+        routeCost = h.routeCost;
+        handCost = h.handCost;
+        hotspots.assign(profile.Hotspots(), profile.Hotspots() + h.hotspots);
+        route.assign(profile.Route(), profile.Route() + h.hotspots);
+        waypoints.assign(profile.Waypoints(), profile.Waypoints() + h.waypoints);
+        blackAreas.assign(profile.BlackAreas(), profile.BlackAreas() + h.blackAreas);
+        vendors.assign(profile.Vendors(), profile.Vendors() + h.vendors);
+        blacklistEntries.assign(profile.BlacklistEntries(), profile.BlacklistEntries() + h.blacklistEntries);
+    }
+};
+
+// ───────────────────────────────────────────────────────────────
+// GrindWriteProfile — write data as a profile file
+//
+// Returns:
+//   false if the route is not a permutation of the hotspots or a file
+//   step failed (an existing profile at path is left untouched)
+// ───────────────────────────────────────────────────────────────
+inline bool GrindWriteProfile(const MappedPathChar* path, const GrindProfileData& data)
+{
+    const size_t n = data.hotspots.size();
+    std::vector<uint32_t> route = data.route;
+    if (route.empty())
+        for (uint32_t i = 0; i < n; ++i)
+            route.push_back(i);
+
+    std::vector<uint8_t> seen(n, 0);
+    if (route.size() != n)
+        return false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (route[i] >= n || seen[route[i]])
+            return false;
+        seen[route[i]] = 1;
+    }
+
+    std::vector<uint32_t> entries = data.blacklistEntries;
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    GrindProfileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "AGPF", 4);
+    h.version = kGrindVersion;
+    h.map = data.map;
+    h.flags = data.flags;
+    h.hotspots = (uint32_t)n;
+    h.waypoints = (uint32_t)data.waypoints.size();
+    h.blackAreas = (uint32_t)data.blackAreas.size();
+    h.blacklistEntries = (uint32_t)entries.size();
+    h.vendors = (uint32_t)data.vendors.size();
+    h.routeCost = data.routeCost;
+    h.handCost = data.handCost;
+    memcpy(h.name, data.name.data(), std::min(data.name.size(), sizeof(h.name) - 1));
+
+    std::basic_string<MappedPathChar> temp(path);
+    for (const char* ext = ".tmp"; *ext; ++ext)
+        temp += (MappedPathChar)*ext;
+
+#ifdef _WIN32
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, temp.c_str(), L"wb") != 0)
+        file = nullptr;
+#else
+    FILE* file = fopen(temp.c_str(), "wb");
+#endif
+    if (!file)
+        return false;
+
+    bool ok = fwrite(&h, sizeof(h), 1, file) == 1;
+    ok = ok && (n == 0 || fwrite(data.hotspots.data(), sizeof(GrindHotspot), n, file) == n);
+    ok = ok && (n == 0 || fwrite(route.data(), sizeof(uint32_t), n, file) == n);
+    ok = ok && (data.waypoints.empty() ||
+                fwrite(data.waypoints.data(), sizeof(GrindWaypoint), data.waypoints.size(), file) == data.waypoints.size());
+    ok = ok && (data.blackAreas.empty() ||
+                fwrite(data.blackAreas.data(), sizeof(GrindBlackArea), data.blackAreas.size(), file) == data.blackAreas.size());
+    ok = ok && (data.vendors.empty() ||
+                fwrite(data.vendors.data(), sizeof(GrindVendor), data.vendors.size(), file) == data.vendors.size());
+    ok = ok && (entries.empty() || fwrite(entries.data(), sizeof(uint32_t), entries.size(), file) == entries.size());
+    ok = fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExW(temp.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+    if (!ok)
+        DeleteFileW(temp.c_str());
+#else
+    ok = ok && rename(temp.c_str(), path) == 0;
+    if (!ok)
+        unlink(temp.c_str());
+#endif
+    return ok;
+}
@@ -0,0 +1,668 @@
+﻿// GroupBus.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Host-local shared-memory bus between the bot instances of one group
+//
+// Responsibilities:
+// • One named shared-memory segment per group ("AchikoGroupBus_<group>")
+//   that every member process maps
+// • Member table: each process claims a slot (pid + heartbeat), stale
+//   slots of crashed clients are reclaimed
+// • Point-to-point messages: one SPSC ring per (sender, receiver) pair of
+//   fixed 64-byte BusMessages — targets, pull timing, pings
+// • Broadcast region: one BusState per member (position, target, pull
+//   time) under a seqlock — written by its owner, read by everyone
+// • Blocking Wait() for the receive thread with a cross-process wake-up
+//
+// Architecture:
+// • Header-only; the layout is all fixed-size arrays of lock-free 32-bit
+//   atomics, so an all-zero segment is a valid empty bus and no process
+//   has to "initialize" it
+// • rings[to][from]: the sender owns tail, the receiver owns head, each
+//   on its own cache line; the sender caches the receiver's head in
+//   process-local memory and only re-reads it when the ring looks full
+// • Wake-up: a receiver that found nothing after a short spin sets its
+//   sleeping flag and blocks — futex on the member's wake word (Linux,
+//   shared futex) or a named auto-reset event per slot (Windows). A
+//   sender only pays for the kernel call when that flag is set
+//
+// Critical Design Decisions:
+// • Drop-on-full, counted — a stalled member must never block the game
+//   thread of the sender
+// • One sending thread and one receiving thread per member (SPSC per
+//   ring); callers with more threads serialize their sends
+// • Timestamps are PlatformNowNs(): QPC / CLOCK_MONOTONIC are host-wide,
+//   so sentNs lets the receiver measure one-way latency directly
+// • The spin before blocking is skipped on single-CPU hosts, where it
+//   could only delay the sender it is waiting for
+// • A member silent for kBusStaleMs can lose its slot to a joiner. A slot
+//   is ours while it holds our pid and the epoch we claimed it at; Wait
+//   and Publish check that and claim a new slot once it is gone, Leave
+//   only frees a slot it still owns
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include "Platform.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const uint32_t kBusMaxMembers = 8;
+static const uint32_t kBusRingCapacity = 256;            // messages per (sender, receiver) ring
+static const uint32_t kBusLayout = 0x41420001;           // 'AB' + layout version
+static const uint32_t kBusStaleMs = 5000;                // slot reclaimable after this silence
+static const uint64_t kBusSpinNs = 50000;                // spin before blocking in Wait()
+static const size_t kBusGroupName = 48;                  // max group name length
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "GroupBus needs address-free 32-bit atomics");
+
+// ═══════════════════════════════════════════════════════════════
+// BusMessage / BusState — the two record types on the bus
+// ═══════════════════════════════════════════════════════════════
+enum BusMessageType : uint32_t
+{
+    BusMsg_Target = 1,     // args[0] = target GUID
+    BusMsg_Pull = 2,       // args[0] = target GUID, args[1] = pull at (PlatformNowNs)
+    BusMsg_Ping = 3,       // args[0] = cookie — echoed as BusMsg_Pong
+    BusMsg_Pong = 4,       // args[0] = cookie, args[1] = ping's one-way ns
+    BusMsg_User = 256,     // first free type for callers
+};
+
+struct BusMessage
+{
+    uint32_t type;         // BusMessageType
+    uint16_t from;         // sender slot (stamped by Send)
+    uint16_t flags;        // free for callers
+    uint64_t sentNs;       // PlatformNowNs() at Send (stamped by Send)
+    uint64_t args[6];
+};
+static_assert(sizeof(BusMessage) == 64, "BusMessage is one cache line");
+
+struct BusState
+{
+    uint64_t updatedNs;    // PlatformNowNs() of the owner's Publish
+    uint64_t targetGuid;
+    uint64_t pullAtNs;     // planned pull, 0 = none
+    float x, y, z, facing;
+    uint32_t mapId;
+    uint32_t flags;        // BusStateFlags
+    uint32_t healthPct;
+    uint32_t manaPct;
+    uint32_t reserved[2];
+};
+static_assert(sizeof(BusState) == 64, "BusState is one cache line");
+
+enum BusStateFlags : uint32_t
+{
+    BusState_InCombat = 1,
+    BusState_Dead = 2,
+    BusState_Leader = 4,
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Shared layout — everything below lives in the mapped segment
+// ═══════════════════════════════════════════════════════════════
+struct alignas(64) BusMember
+{
+    std::atomic<uint32_t> pid;         // 0 = free
+    std::atomic<uint32_t> epoch;       // bumped on every join of this slot
+    std::atomic<uint32_t> beatMs;      // heartbeat, PlatformNowNs() / 1e6 (wraps)
+    std::atomic<uint32_t> sleeping;    // receiver is (about to be) blocked
+    std::atomic<uint32_t> wake;        // futex word (Linux)
+};
+
+struct alignas(64) BusStateCell
+{
+    std::atomic<uint32_t> seq;         // odd = write in progress, 0 = never published
+    uint32_t pad;
+    BusState state;
+};
+
+struct alignas(64) BusRing
+{
+    alignas(64) std::atomic<uint32_t> tail;   // sender
+    alignas(64) std::atomic<uint32_t> head;   // receiver
+    alignas(64) BusMessage cells[kBusRingCapacity];
+};
+
+struct alignas(64) BusSegment
+{
+    std::atomic<uint32_t> layout;      // kBusLayout once any member joined
+    BusMember members[kBusMaxMembers];
+    BusStateCell states[kBusMaxMembers];
+    BusRing rings[kBusMaxMembers][kBusMaxMembers];   // [to][from]
+};
+
+// ═══════════════════════════════════════════════════════════════
+// GroupBus — one process's endpoint on a group's bus
+// ═══════════════════════════════════════════════════════════════
+class GroupBus
+{
+public:
+    GroupBus() : m_bus(NULL), m_slot(-1), m_epoch(0), m_pid(0), m_sendSlot(-1), m_dropped(0), m_spinNs(0)
+#ifdef _WIN32
+        , m_mapping(NULL)
+#else
+        , m_fd(-1)
+#endif
+    {
+        memset(m_cachedHead, 0, sizeof(m_cachedHead));
+#ifdef _WIN32
+        memset(m_events, 0, sizeof(m_events));
+#endif
+    }
+
+    ~GroupBus() { Leave(); }
+
+    int Slot() const { return m_slot.load(std::memory_order_acquire); }
+    bool Joined() const { return Slot() >= 0; }
+    uint64_t Dropped() const { return m_dropped; }
+
+    // ───────────────────────────────────────────────────────────────
+    // Join — map the group's segment and claim a member slot
+    //
+    // Returns:
+    //   Slot (0..kBusMaxMembers-1), or -1 if the segment cannot be
+    //   mapped, has another layout, or every slot is live
+    // ───────────────────────────────────────────────────────────────
+    int Join(const char* group)
+    {
+        Leave();
+        if (!group || !*group || strlen(group) > kBusGroupName || !Map(group))
+            return -1;
+
+        uint32_t expected = 0;
+        if (!m_bus->layout.compare_exchange_strong(expected, kBusLayout) && expected != kBusLayout)
+        {
+            Unmap();
+            return -1;
+        }
+
+        m_pid = PlatformProcessId();
+        const int slot = Claim();
+        if (slot < 0)
+        {
+            Unmap();
+            return -1;
+        }
+        m_spinNs = PlatformCpuCount() > 1 ? kBusSpinNs : 0;
+        return slot;
+    }
+
+    // Frees the slot (if it is still ours) and unmaps the segment
+    void Leave()
+    {
+        const int slot = Slot();
+        if (slot >= 0)
+        {
+            // A slot taken over while we were stalled belongs to its new
+            // owner — neither its state nor its pid are ours to clear
+            if (Owns(slot))
+            {
+                m_bus->states[slot].seq.store(0, std::memory_order_release);
+                uint32_t pid = m_pid;
+                m_bus->members[slot].pid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+            }
+            m_slot.store(-1, std::memory_order_release);
+        }
+        m_sendSlot = -1;
+        Unmap();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Members — live slots (pid != 0 and heartbeat fresh), self included
+    //
+    // Returns:
+    //   Count; pids[i] / slots[i] filled up to max (either may be NULL)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Members(uint32_t* slots, uint32_t* pids, uint32_t max) const
+    {
+        if (Slot() < 0)
+            return 0;
+        const uint32_t now = NowMs();
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < kBusMaxMembers; ++i)
+        {
+            const BusMember& member = m_bus->members[i];
+            const uint32_t pid = member.pid.load(std::memory_order_acquire);
+            if (pid == 0 || now - member.beatMs.load(std::memory_order_relaxed) > kBusStaleMs)
+                continue;
+            if (count < max)
+            {
+                if (slots) slots[count] = i;
+                if (pids) pids[count] = pid;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // MESSAGES
+    // ═══════════════════════════════════════════════════════════════
+
+    // ───────────────────────────────────────────────────────────────
+    // Send — copy message into the ring towards slot to
+    //
+    // Returns:
+    //   false if not joined, to is invalid / self, or the ring is full
+    //   (counted in Dropped)
+    // ───────────────────────────────────────────────────────────────
+    bool Send(uint32_t to, const BusMessage& message)
+    {
+        const int slot = Slot();
+        if (slot < 0 || to >= kBusMaxMembers || to == (uint32_t)slot)
+            return false;
+
+        // After a re-claim our outgoing rings are another row — the
+        // cached heads belong to the old one
+        if (slot != m_sendSlot)
+        {
+            for (uint32_t i = 0; i < kBusMaxMembers; ++i)
+                m_cachedHead[i] = m_bus->rings[i][slot].head.load(std::memory_order_acquire);
+            m_sendSlot = slot;
+        }
+
+        BusRing& ring = m_bus->rings[to][slot];
+        const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead[to] >= kBusRingCapacity)
+        {
+            m_cachedHead[to] = ring.head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead[to] >= kBusRingCapacity)
+            {
+                ++m_dropped;
+                return false;
+            }
+        }
+
+        BusMessage& cell = ring.cells[tail & (kBusRingCapacity - 1)];
+        cell = message;
+        cell.from = (uint16_t)slot;
+        cell.sentNs = PlatformNowNs();
+        ring.tail.store(tail + 1, std::memory_order_release);
+
+        Wake(to);
+        return true;
+    }
+
+    // Send to every other live member; returns how many accepted it
+    uint32_t Broadcast(const BusMessage& message)
+    {
+        uint32_t slots[kBusMaxMembers];
+        const uint32_t count = Members(slots, NULL, kBusMaxMembers);
+        const int self = Slot();
+        uint32_t sent = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (slots[i] != (uint32_t)self && Send(slots[i], message))
+                ++sent;
+        }
+        return sent;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Receive — drain pending messages from every sender
+    //
+    // Returns:
+    //   Messages copied to out (per-sender FIFO; senders round robin)
+    // ───────────────────────────────────────────────────────────────
+    size_t Receive(BusMessage* out, size_t max)
+    {
+        const int slot = Slot();
+        if (slot < 0)
+            return 0;
+
+        size_t count = 0;
+        for (uint32_t from = 0; from < kBusMaxMembers && count < max; ++from)
+        {
+            BusRing& ring = m_bus->rings[slot][from];
+            uint32_t head = ring.head.load(std::memory_order_relaxed);
+            const uint32_t tail = ring.tail.load(std::memory_order_acquire);
+            if (head == tail)
+                continue;
+
+            for (; head != tail && count < max; ++head)
+                out[count++] = ring.cells[head & (kBusRingCapacity - 1)];
+            ring.head.store(head, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Wait — block until a message is pending or timeoutMs passes
+    //
+    // Returns:
+    //   true if something is pending (then call Receive)
+    //
+    // Notes:
+    //   Also refreshes this member's heartbeat — the receive thread
+    //   calling Wait() in a loop is what keeps the slot alive. A slot
+    //   lost to a stall is replaced first (false if none is free)
+    // ───────────────────────────────────────────────────────────────
+    bool Wait(uint32_t timeoutMs)
+    {
+        const int slot = OwnedSlot();
+        if (slot < 0)
+            return false;
+
+        BusMember& me = m_bus->members[slot];
+        me.beatMs.store(NowMs(), std::memory_order_relaxed);
+        if (Pending(slot))
+            return true;
+
+        if (m_spinNs != 0)
+        {
+            const uint64_t until = PlatformNowNs() + m_spinNs;
+            do
+            {
+                PlatformCpuRelax();
+                if (Pending(slot))
+                    return true;
+            } while (PlatformNowNs() < until);
+        }
+
+#ifndef _WIN32
+        const uint32_t wake = me.wake.load(std::memory_order_acquire);
+#endif
+        me.sleeping.store(1, std::memory_order_seq_cst);
+        if (Pending(slot))
+        {
+            me.sleeping.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+#ifdef _WIN32
+        WaitForSingleObject(m_events[slot], timeoutMs);
+#else
+        timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+        syscall(SYS_futex, &me.wake, FUTEX_WAIT, wake, &timeout, NULL, 0);
+#endif
+        me.sleeping.store(0, std::memory_order_relaxed);
+        return Pending(slot);
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // BROADCAST REGION
+    // ═══════════════════════════════════════════════════════════════
+
+    // ───────────────────────────────────────────────────────────────
+    // Publish — replace this member's BusState (seqlock writer)
+    //
+    // Notes:
+    //   Never blocks on other members; readers retry while the sequence
+    //   is odd. A slot lost to a stall is replaced first, so the state
+    //   never lands in another member's cell
+    // ───────────────────────────────────────────────────────────────
+    void Publish(const BusState& state)
+    {
+        const int slot = OwnedSlot();
+        if (slot < 0)
+            return;
+
+        m_bus->members[slot].beatMs.store(NowMs(), std::memory_order_relaxed);
+
+        BusStateCell& cell = m_bus->states[slot];
+        const uint32_t seq = cell.seq.load(std::memory_order_relaxed);
+        cell.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        cell.state = state;
+        cell.state.updatedNs = PlatformNowNs();
+        cell.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // ReadState — consistent copy of slot's BusState (seqlock reader)
+    //
+    // Returns:
+    //   false if slot never published (or a writer kept it busy for
+    //   every retry)
+    // ───────────────────────────────────────────────────────────────
+    bool ReadState(uint32_t slot, BusState& out) const
+    {
+        if (Slot() < 0 || slot >= kBusMaxMembers)
+            return false;
+
+        const BusStateCell& cell = m_bus->states[slot];
+        for (int attempt = 0; attempt < 64; ++attempt)
+        {
+            const uint32_t before = cell.seq.load(std::memory_order_acquire);
+            if (before == 0)
+                return false;
+            if (before & 1)
+            {
+                PlatformCpuRelax();
+                continue;
+            }
+            memcpy(&out, (const void*)&cell.state, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (cell.seq.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+        return false;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Unlink — remove a group's segment name (POSIX only; Windows
+    // sections vanish with their last handle). Existing mappings stay
+    // ───────────────────────────────────────────────────────────────
+    static void Unlink(const char* group)
+    {
+#ifndef _WIN32
+        char name[kBusGroupName + 32];
+        snprintf(name, sizeof(name), "/AchikoGroupBus_%s", group);
+        shm_unlink(name);
+#else
+        (void)group;
+#endif
+    }
+
+private:
+    GroupBus(const GroupBus&);
+    GroupBus& operator=(const GroupBus&);
+
+    static uint32_t NowMs() { return (uint32_t)(PlatformNowNs() / 1000000ull); }
+
+    // ───────────────────────────────────────────────────────────────
+    // Claim — take a free or stale slot (Join, or after losing one)
+    //
+    // Returns:
+    //   The slot, -1 if every slot is live
+    // ───────────────────────────────────────────────────────────────
+    int Claim()
+    {
+        const uint32_t pid = m_pid;
+        const uint32_t now = NowMs();
+        int slot = -1;
+        for (uint32_t i = 0; i < kBusMaxMembers && slot < 0; ++i)
+        {
+            BusMember& member = m_bus->members[i];
+            uint32_t owner = member.pid.load(std::memory_order_acquire);
+            if (owner != 0 && now - member.beatMs.load(std::memory_order_relaxed) <= kBusStaleMs)
+                continue;
+            // Fresh beat before the claim, so a racing joiner cannot take
+            // the slot back from us as "stale"
+            member.beatMs.store(now, std::memory_order_relaxed);
+            if (member.pid.compare_exchange_strong(owner, pid))
+                slot = (int)i;
+        }
+        if (slot < 0)
+            return -1;
+
+        BusMember& me = m_bus->members[slot];
+        me.sleeping.store(0, std::memory_order_relaxed);
+        m_epoch.store(me.epoch.fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_relaxed);
+
+        // Messages left for a previous owner of this slot are not ours
+        for (uint32_t from = 0; from < kBusMaxMembers; ++from)
+        {
+            BusRing& in = m_bus->rings[slot][from];
+            in.head.store(in.tail.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        m_slot.store(slot, std::memory_order_release);
+        return slot;
+    }
+
+    // Slot still carries our pid and the epoch we claimed it at
+    bool Owns(int slot) const
+    {
+        const BusMember& member = m_bus->members[slot];
+        return member.pid.load(std::memory_order_acquire) == m_pid &&
+               member.epoch.load(std::memory_order_acquire) == m_epoch.load(std::memory_order_relaxed);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // OwnedSlot — our slot, claiming a new one if it was taken over
+    //
+    // Returns:
+    //   The slot, -1 if not joined or no slot is free right now (the
+    //   next Wait / Publish tries again)
+    //
+    // Notes:
+    //   Wait and Publish run on different threads; the re-claim is
+    //   serialized and re-checked under m_claimLock
+    // ───────────────────────────────────────────────────────────────
+    int OwnedSlot()
+    {
+        int slot = Slot();
+        if (slot >= 0 && Owns(slot))
+            return slot;
+        if (!m_bus)
+            return -1;
+
+        std::lock_guard<std::mutex> guard(m_claimLock);
+        slot = Slot();
+        if (slot >= 0 && Owns(slot))
+            return slot;
+        m_slot.store(-1, std::memory_order_release);
+        return Claim();
+    }
+
+    bool Pending(int slot) const
+    {
+        for (uint32_t from = 0; from < kBusMaxMembers; ++from)
+        {
+            const BusRing& ring = m_bus->rings[slot][from];
+            if (ring.tail.load(std::memory_order_seq_cst) != ring.head.load(std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Kernel wake-up only if the receiver announced it is blocking
+    void Wake(uint32_t to)
+    {
+        BusMember& member = m_bus->members[to];
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!member.sleeping.load(std::memory_order_relaxed))
+            return;
+#ifdef _WIN32
+        SetEvent(m_events[to]);
+#else
+        member.wake.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, &member.wake, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+    }
+
+    bool Map(const char* group)
+    {
+        char name[kBusGroupName + 32];
+#ifdef _WIN32
+        sprintf_s(name, sizeof(name), "Local\\AchikoGroupBus_%s", group);
+        // Page-file backed sections start zeroed — a valid empty bus
+        m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)sizeof(BusSegment), name);
+        if (!m_mapping)
+            return false;
+        m_bus = (BusSegment*)MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(BusSegment));
+        if (!m_bus)
+        {
+            Unmap();
+            return false;
+        }
+        for (uint32_t i = 0; i < kBusMaxMembers; ++i)
+        {
+            sprintf_s(name, sizeof(name), "Local\\AchikoGroupBus_%s_%u", group, i);
+            m_events[i] = CreateEventA(NULL, FALSE, FALSE, name);
+            if (!m_events[i])
+            {
+                Unmap();
+                return false;
+            }
+        }
+        return true;
+#else
+        snprintf(name, sizeof(name), "/AchikoGroupBus_%s", group);
+        m_fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+        if (m_fd < 0)
+            return false;
+        // New objects are zero-filled; growing an existing one to the same size is a no-op
+        struct stat st;
+        if (fstat(m_fd, &st) != 0 || (st.st_size < (off_t)sizeof(BusSegment) && ftruncate(m_fd, sizeof(BusSegment)) != 0))
+        {
+            Unmap();
+            return false;
+        }
+        void* base = mmap(NULL, sizeof(BusSegment), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (base == MAP_FAILED)
+        {
+            Unmap();
+            return false;
+        }
+        m_bus = (BusSegment*)base;
+        return true;
+#endif
+    }
+
+    void Unmap()
+    {
+#ifdef _WIN32
+        if (m_bus)
+            UnmapViewOfFile(m_bus);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        for (uint32_t i = 0; i < kBusMaxMembers; ++i)
+        {
+            if (m_events[i])
+                CloseHandle(m_events[i]);
+            m_events[i] = NULL;
+        }
+        m_mapping = NULL;
+#else
+        if (m_bus)
+            munmap(m_bus, sizeof(BusSegment));
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_bus = NULL;
+    }
+
+    BusSegment* m_bus;                         // mapped from Join to Leave
+    std::atomic<int> m_slot;                   // -1 = none (not joined, or lost and not yet replaced)
+    std::atomic<uint32_t> m_epoch;             // members[m_slot].epoch when we claimed it
+    uint32_t m_pid;                            // PlatformProcessId() at Join
+    std::mutex m_claimLock;                    // OwnedSlot re-claims
+    int m_sendSlot;                            // slot m_cachedHead was read for (sending thread)
+    uint32_t m_cachedHead[kBusMaxMembers];     // receiver heads as last seen, per target
+    uint64_t m_dropped;
+    uint64_t m_spinNs;
+#ifdef _WIN32
+    HANDLE m_mapping;
+    HANDLE m_events[kBusMaxMembers];           // per-slot wake events
+#else
+    int m_fd;
+#endif
+};
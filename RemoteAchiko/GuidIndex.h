@@ -0,0 +1,208 @@
+﻿// GuidIndex.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Open-addressing hash index — 64-bit object GUID → 32-bit slot/handle
+//
+// Responsibilities:
+// • O(1) insert / find / erase keyed by game object GUID
+// • Flat arrays only — one cache line usually answers a lookup
+// • Clear() in O(capacity) without freeing, for per-tick rebuilds
+//
+// Architecture:
+// • Linear probing over a power-of-two table, max load factor 0.5
+// • Backward-shift deletion — no tombstones, probe chains stay short
+// • GUID 0 is reserved as the empty marker (never a valid object)
+//
+// Critical Design Decisions:
+// • Keys are mixed with the splitmix64 finalizer — raw GUIDs share their
+//   high (type) bits and count up in the low bits
+// • Grows by rehash when half full; callers that must not allocate on
+//   the hot path reserve up front
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+class GuidIndex
+{
+public:
+    static const uint32_t kNotFound = 0xFFFFFFFFu;
+
+    explicit GuidIndex(size_t expectedCount = 64)
+        : m_count(0)
+    {
+        Rehash(CapacityFor(expectedCount));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Reserve — make room for count keys without further growth
+    // ───────────────────────────────────────────────────────────────
+    void Reserve(size_t count)
+    {
+        const size_t wanted = CapacityFor(count);
+        if (wanted > m_keys.size())
+            Rehash(wanted);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Insert — add or overwrite guid → value
+    //
+    // Returns:
+    //   true  - new key added
+    //   false - existing key updated (or guid == 0 rejected)
+    // ───────────────────────────────────────────────────────────────
+    bool Insert(uint64_t guid, uint32_t value)
+    {
+        if (guid == 0)
+            return false;
+
+        if ((m_count + 1) * 2 > m_keys.size())
+            Rehash(m_keys.size() * 2);
+
+        const size_t mask = m_keys.size() - 1;
+        size_t i = Mix(guid) & mask;
+
+        for (;;)
+        {
+            if (m_keys[i] == 0)
+            {
+                m_keys[i] = guid;
+                m_values[i] = value;
+                ++m_count;
+                return true;
+            }
+            if (m_keys[i] == guid)
+            {
+                m_values[i] = value;
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Find — lookup
+    //
+    // Returns:
+    //   Stored value, or kNotFound
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Find(uint64_t guid) const
+    {
+        if (guid == 0)
+            return kNotFound;
+
+        const size_t mask = m_keys.size() - 1;
+        size_t i = Mix(guid) & mask;
+
+        for (;;)
+        {
+            const uint64_t k = m_keys[i];
+            if (k == guid)
+                return m_values[i];
+            if (k == 0)
+                return kNotFound;
+            i = (i + 1) & mask;
+        }
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Erase — remove guid, shifting followers back into the hole
+    //
+    // Returns:
+    //   true if the key was present
+    // ───────────────────────────────────────────────────────────────
+    bool Erase(uint64_t guid)
+    {
+        if (guid == 0)
+            return false;
+
+        const size_t mask = m_keys.size() - 1;
+        size_t i = Mix(guid) & mask;
+
+        while (m_keys[i] != guid)
+        {
+            if (m_keys[i] == 0)
+                return false;
+            i = (i + 1) & mask;
+        }
+
+        size_t hole = i;
+        for (;;)
+        {
+            i = (i + 1) & mask;
+            const uint64_t k = m_keys[i];
+            if (k == 0)
+                break;
+
+            // Move k back only if its home slot is not in (hole, i]
+            const size_t home = Mix(k) & mask;
+            const bool between = (hole <= i) ? (home > hole && home <= i) : (home > hole || home <= i);
+            if (!between)
+            {
+                m_keys[hole] = k;
+                m_values[hole] = m_values[i];
+                hole = i;
+            }
+        }
+
+        m_keys[hole] = 0;
+        --m_count;
+        return true;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Clear — drop all keys, keep capacity
+    // ───────────────────────────────────────────────────────────────
+    void Clear()
+    {
+        std::fill(m_keys.begin(), m_keys.end(), 0);
+        m_count = 0;
+    }
+
+    size_t Count() const { return m_count; }
+    size_t Capacity() const { return m_keys.size(); }
+
+private:
+    static size_t CapacityFor(size_t count)
+    {
+        size_t n = 16;
+        while (n < count * 2)
+            n <<= 1;
+        return n;
+    }
+
+    static uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<uint64_t> oldKeys;
+        std::vector<uint32_t> oldValues;
+        oldKeys.swap(m_keys);
+        oldValues.swap(m_values);
+
+        m_keys.assign(capacity, 0);
+        m_values.assign(capacity, 0);
+        m_count = 0;
+
+        for (size_t i = 0; i < oldKeys.size(); ++i)
+        {
+            if (oldKeys[i] != 0)
+                Insert(oldKeys[i], oldValues[i]);
+        }
+    }
+
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_values;
+    size_t m_count;
+};
@@ -0,0 +1,149 @@
+﻿// Heartbeat.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Per-thread heartbeat slots + hang detection core for the watchdog
+//
+// Responsibilities:
+// • HeartbeatSlot: one counter per watched thread, bumped by its owner
+// • HangDetector: notice counters that stopped moving for longer than
+//   their timeout, report each hang once and its recovery once
+//
+// Architecture:
+// • Header-only, no OS calls — the Windows watchdog (Watchdog.cpp) owns
+//   the slots and polls them, RemoteAchikoBench measures both sides on Linux
+// • Owner side is ONE relaxed store of a private counter — no RMW, no
+//   lock, no fence; AchikoDLL writes the same int through a raw pointer
+// • Detector side runs only on the watchdog thread and keeps its own
+//   per-slot state, so owners never read anything
+//
+// Critical Design Decisions:
+// • Each slot sits on its own cache line — owners never share a line
+//   with each other or with the detector's bookkeeping
+// • Counter wrap is harmless: only "changed / not changed" matters
+// • A slot's generation changes on every (re)registration, so a recycled
+//   slot is never reported as the previous thread's hang
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "Platform.h"
+
+static const uint32_t kHeartbeatMaxSlots = 16;
+static const uint32_t kHeartbeatDefaultTimeoutMs = 5000;
+static const uint32_t kHeartbeatMinTimeoutMs = 250;
+
+// ═══════════════════════════════════════════════════════════════
+// HeartbeatSlot — one watched thread (one cache line)
+// ═══════════════════════════════════════════════════════════════
+struct alignas(64) HeartbeatSlot
+{
+    std::atomic<uint32_t> beat;         // owner: relaxed store only
+    std::atomic<uint32_t> generation;   // 0 = free, odd = live
+    uint32_t threadId;
+    uint32_t timeoutMs;
+    char name[48];
+
+    // ───────────────────────────────────────────────────────────────
+    // Beat — owner side; counter is the owner's private running count
+    // ───────────────────────────────────────────────────────────────
+    void Beat(uint32_t counter) { beat.store(counter, std::memory_order_relaxed); }
+};
+
+// ═══════════════════════════════════════════════════════════════
+// HangEvent — detector output
+// ═══════════════════════════════════════════════════════════════
+struct HangEvent
+{
+    uint32_t slot;
+    bool recovered;      // false = newly hung, true = beating again
+    uint64_t stalledMs;  // silence so far (hung) or in total (recovered)
+};
+
+// ═══════════════════════════════════════════════════════════════
+// HangDetector — watchdog-thread side
+// ═══════════════════════════════════════════════════════════════
+class HangDetector
+{
+public:
+    HangDetector() { memset(m_state, 0, sizeof(m_state)); }
+
+    // ───────────────────────────────────────────────────────────────
+    // Scan — one poll over every slot
+    //
+    // Args:
+    //   slots  - kHeartbeatMaxSlots slots
+    //   nowMs  - monotonic milliseconds
+    //   events - [out] at most kHeartbeatMaxSlots entries
+    //
+    // Returns:
+    //   Number of events written (new hangs and recoveries)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Scan(const HeartbeatSlot* slots, uint64_t nowMs, HangEvent* events)
+    {
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < kHeartbeatMaxSlots; ++i)
+        {
+            State& s = m_state[i];
+            const uint32_t generation = slots[i].generation.load(std::memory_order_acquire);
+
+            if ((generation & 1) == 0)
+            {
+                s.generation = 0;
+                continue;
+            }
+
+            const uint32_t beat = slots[i].beat.load(std::memory_order_relaxed);
+
+            // New registration — start watching from now
+            if (s.generation != generation)
+            {
+                s.generation = generation;
+                s.lastBeat = beat;
+                s.lastChangeMs = nowMs;
+                s.hung = false;
+                continue;
+            }
+
+            if (beat != s.lastBeat)
+            {
+                if (s.hung)
+                {
+                    events[count].slot = i;
+                    events[count].recovered = true;
+                    events[count].stalledMs = nowMs - s.lastChangeMs;
+                    ++count;
+                }
+                s.lastBeat = beat;
+                s.lastChangeMs = nowMs;
+                s.hung = false;
+                continue;
+            }
+
+            if (!s.hung && nowMs - s.lastChangeMs >= slots[i].timeoutMs)
+            {
+                s.hung = true;
+                events[count].slot = i;
+                events[count].recovered = false;
+                events[count].stalledMs = nowMs - s.lastChangeMs;
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+private:
+    struct State
+    {
+        uint32_t generation;
+        uint32_t lastBeat;
+        uint64_t lastChangeMs;
+        bool hung;
+    };
+
+    State m_state[kHeartbeatMaxSlots];
+};
@@ -0,0 +1,432 @@
+﻿// HookFilter.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// HookFilter implementation — x86-32 stub emission, patching, the match
+// path and batched drains
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "HookFilter.h"
+
+#include <string.h>
+#include "MemoryRead.h"
+
+#if defined(_WIN32) && (defined(_M_IX86) || defined(__i386__))
+#define ACHIKO_HOOK_STUBS 1
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// The stub frame
+// ═══════════════════════════════════════════════════════════════
+// On a match the stub saves everything and passes OnMatch a pointer
+// to what it pushed:
+//   [0]      eflags (pushfd)
+//   [1..8]   edi esi ebp esp ebx edx ecx eax (pushad)
+//   [9]      return address of the hooked call
+//   [10..]   the call's stack arguments
+// ───────────────────────────────────────────────────────────────
+static const uint32_t kFrameEdx = 6;
+static const uint32_t kFrameEcx = 7;
+static const uint32_t kFrameReturn = 9;
+static const uint32_t kFrameArgs = 10;
+
+// Bounded copy that always leaves dst terminated
+static void CopyFilterName(char* dst, size_t capacity, const char* src)
+{
+    size_t n = strlen(src);
+    if (n > capacity - 1)
+        n = capacity - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+#ifdef ACHIKO_HOOK_STUBS
+
+// ═══════════════════════════════════════════════════════════════
+// STUB EMISSION (x86-32)
+// ═══════════════════════════════════════════════════════════════
+
+// Called by every stub on a match (cdecl: id, frame)
+static void __cdecl HookFilterMatchThunk(uint32_t id, const uint32_t* frame)
+{
+    HookFilter::Instance().OnMatch((uint16_t)id, frame);
+}
+
+struct StubWriter
+{
+    uint8_t* p;
+
+    void U8(uint8_t v) { *p++ = v; }
+    void U32(uint32_t v) { memcpy(p, &v, 4); p += 4; }
+    void Address(const volatile void* a) { U32((uint32_t)(uintptr_t)a); }
+    void Rel32(const void* to) { U32((uint32_t)((uintptr_t)to - ((uintptr_t)p + 4))); }
+};
+
+// ───────────────────────────────────────────────────────────────
+// EmitStub — the predicate stage for one hook
+//
+//     lock inc dword [calls]
+//     push eax
+//     mov  eax, <ecx | edx | [esp + 8 + 4n]>
+//     cmp  eax, kHookFilterMaxIds
+//     jae  pass
+//     bt   [bits], eax
+//     jc   match
+//   pass:
+//     pop  eax
+//     jmp  trampoline               ; not watched: original, untouched
+//   match:
+//     pop  eax
+//     pushad
+//     pushfd
+//     push esp                      ; frame
+//     push id
+//     call HookFilterMatchThunk
+//     add  esp, 8
+//     popfd
+//     popad
+//     jmp  trampoline
+//
+// Only eflags differ on the pass path — undefined at a call boundary
+// anyway (DF is never touched).
+// ───────────────────────────────────────────────────────────────
+static void EmitStub(uint8_t* stub, uint8_t* trampoline, uint16_t id, uint32_t source,
+                     const volatile void* calls, const uint32_t* bits)
+{
+    StubWriter w = { stub };
+    w.U8(0xF0); w.U8(0xFF); w.U8(0x05); w.Address(calls);
+    w.U8(0x50);
+    if (source == HookSource_Ecx)
+    {
+        w.U8(0x89); w.U8(0xC8);
+    }
+    else if (source == HookSource_Edx)
+    {
+        w.U8(0x89); w.U8(0xD0);
+    }
+    else
+    {
+        w.U8(0x8B); w.U8(0x44); w.U8(0x24); w.U8((uint8_t)(8 + 4 * (source - HookSource_Stack)));
+    }
+    w.U8(0x3D); w.U32(kHookFilterMaxIds);
+    w.U8(0x73); w.U8(9);                                  // over bt + jc
+    w.U8(0x0F); w.U8(0xA3); w.U8(0x05); w.Address(bits);
+    w.U8(0x72); w.U8(6);                                  // over pop + jmp
+
+    w.U8(0x58);
+    w.U8(0xE9); w.Rel32(trampoline);
+
+    w.U8(0x58);
+    w.U8(0x60);
+    w.U8(0x9C);
+    w.U8(0x54);
+    w.U8(0x6A); w.U8((uint8_t)id);
+    w.U8(0xE8); w.Rel32((const void*)&HookFilterMatchThunk);
+    w.U8(0x83); w.U8(0xC4); w.U8(0x08);
+    w.U8(0x9D);
+    w.U8(0x61);
+    w.U8(0xE9); w.Rel32(trampoline);
+}
+
+// Stub code fits in the first half of a slot, trampoline in the second
+static const uint32_t kStubTrampolineOffset = kHookFilterStubSize / 2;
+
+// Write bytes over code (protection flipped and restored)
+static bool PatchCode(uintptr_t target, const uint8_t* bytes, uint32_t length)
+{
+    DWORD oldProtect;
+    if (!VirtualProtect((void*)target, length, PAGE_EXECUTE_READWRITE, &oldProtect))
+        return false;
+    memcpy((void*)target, bytes, length);
+    VirtualProtect((void*)target, length, oldProtect, &oldProtect);
+    FlushInstructionCache(GetCurrentProcess(), (void*)target, length);
+    return true;
+}
+
+#endif // ACHIKO_HOOK_STUBS
+
+// ═══════════════════════════════════════════════════════════════
+// HookFilter
+// ═══════════════════════════════════════════════════════════════
+
+HookFilter& HookFilter::Instance()
+{
+    static HookFilter* s_instance = new HookFilter();
+    return *s_instance;
+}
+
+HookFilter::HookFilter()
+    : m_count(1), m_stubBlock(nullptr), m_sinceNs(0), m_drains(0), m_drained(0)
+{
+    for (uint32_t i = 0; i < kHookFilterMaxHooks; ++i)
+    {
+        Slot& slot = m_slots[i];
+        slot.name[0] = '\0';
+        slot.source = 0;
+        slot.calls.store(0, std::memory_order_relaxed);
+        slot.foldedCalls = 0;
+        slot.callsTotal = 0;
+        slot.matched.store(0, std::memory_order_relaxed);
+        slot.dropped.store(0, std::memory_order_relaxed);
+        slot.bits = nullptr;
+        slot.watched = 0;
+        slot.target = 0;
+        slot.prologueBytes = 0;
+        slot.stub = nullptr;
+        slot.installed = false;
+    }
+}
+
+uint16_t HookFilter::Register(const char* name, uint32_t source)
+{
+    if (!name || !*name || source >= HookSource_Stack + kHookFilterMaxStackArg)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    const uint32_t count = m_count.load(std::memory_order_relaxed);
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        if (strncmp(m_slots[i].name, name, sizeof(m_slots[i].name) - 1) == 0)
+            return m_slots[i].source == source ? (uint16_t)i : 0;
+    }
+    if (count >= kHookFilterMaxHooks)
+        return 0;
+
+    uint32_t* bits = new (std::nothrow) uint32_t[kHookFilterMaxIds / 32]();
+    if (!bits)
+        return 0;
+
+    Slot& slot = m_slots[count];
+    CopyFilterName(slot.name, sizeof(slot.name), name);
+    slot.source = source;
+    slot.bits = bits;
+    if (count == 1)
+        m_sinceNs = PlatformNowNs();
+    m_count.store(count + 1, std::memory_order_release);
+    return (uint16_t)count;
+}
+
+bool HookFilter::Fail(const char* error)
+{
+    m_lastError = error;
+    return false;
+}
+
+bool HookFilter::Install(uint16_t id, uintptr_t target, uint32_t prologueBytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (id == 0 || id >= m_count.load(std::memory_order_relaxed))
+        return Fail("unknown filter id");
+    if (!target)
+        return Fail("no target address");
+    if (prologueBytes < 5 || prologueBytes > kHookFilterMaxPrologue)
+        return Fail("prologue must be 5-16 bytes");
+
+    Slot& slot = m_slots[id];
+    if (slot.installed)
+        return slot.target == target ? true : Fail("filter is installed on another target");
+
+#ifdef ACHIKO_HOOK_STUBS
+    if (slot.stub && slot.target != target)
+        return Fail("filter was bound to another target — register a new name");
+
+    uint8_t prologue[kHookFilterMaxPrologue];
+    if (!SafeCopy(prologue, (const void*)target, prologueBytes))
+        return Fail("target is not readable");
+
+    // A jump or call first means another hook (GreyMagic push/ret, a
+    // previous filter) or code that cannot be relocated byte for byte
+    const uint8_t first = prologue[0];
+    if (first == 0xE8 || first == 0xE9 || first == 0xEB || first == 0x68 || first == 0xC3 ||
+        (first >= 0x70 && first <= 0x7F))
+        return Fail("target starts with a jump, call or push — already hooked?");
+
+    if (!slot.stub)
+    {
+        if (!m_stubBlock)
+        {
+            m_stubBlock = (uint8_t*)VirtualAlloc(nullptr, kHookFilterMaxHooks * kHookFilterStubSize,
+                                                 MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+            if (!m_stubBlock)
+                return Fail("VirtualAlloc for the stub block failed");
+        }
+
+        uint8_t* stub = m_stubBlock + id * kHookFilterStubSize;
+        uint8_t* trampoline = stub + kStubTrampolineOffset;
+        memcpy(slot.original, prologue, prologueBytes);
+        memcpy(trampoline, slot.original, prologueBytes);
+        StubWriter back = { trampoline + prologueBytes };
+        back.U8(0xE9);
+        back.Rel32((const void*)(target + prologueBytes));
+        EmitStub(stub, trampoline, id, slot.source, &slot.calls, slot.bits);
+        FlushInstructionCache(GetCurrentProcess(), stub, kHookFilterStubSize);
+
+        slot.stub = stub;
+        slot.target = target;
+        slot.prologueBytes = prologueBytes;
+    }
+    else if (prologueBytes != slot.prologueBytes || memcmp(prologue, slot.original, prologueBytes) != 0)
+    {
+        return Fail("target prologue changed since the first install");
+    }
+
+    uint8_t patch[kHookFilterMaxPrologue];
+    StubWriter jump = { patch };
+    jump.U8(0xE9);
+    jump.U32((uint32_t)((uintptr_t)slot.stub - (target + 5)));
+    memset(patch + 5, 0x90, slot.prologueBytes - 5);    // nop out the rest of the last instruction
+    if (!PatchCode(target, patch, slot.prologueBytes))
+        return Fail("VirtualProtect on the target failed");
+
+    slot.installed = true;
+    return true;
+#else
+    return Fail("native hook stubs are x86-32 Windows only");
+#endif
+}
+
+bool HookFilter::Remove(uint16_t id)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (id == 0 || id >= m_count.load(std::memory_order_relaxed))
+        return false;
+
+    Slot& slot = m_slots[id];
+    if (!slot.installed)
+        return false;
+#ifdef ACHIKO_HOOK_STUBS
+    if (!PatchCode(slot.target, slot.original, slot.prologueBytes))
+        return Fail("VirtualProtect on the target failed");
+#endif
+    slot.installed = false;
+    return true;
+}
+
+uint32_t HookFilter::Watch(uint16_t id, const uint32_t* ids, uint32_t count, bool watch)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (id == 0 || id >= m_count.load(std::memory_order_relaxed) || !ids)
+        return 0;
+
+    // Stubs read the words unlocked — one atomic word update per id
+    Slot& slot = m_slots[id];
+    uint32_t changed = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (ids[i] >= kHookFilterMaxIds)
+            continue;
+        std::atomic<uint32_t>& word = reinterpret_cast<std::atomic<uint32_t>&>(slot.bits[ids[i] >> 5]);
+        const uint32_t bit = 1u << (ids[i] & 31);
+        const uint32_t before = watch ? word.fetch_or(bit, std::memory_order_relaxed)
+                                      : word.fetch_and(~bit, std::memory_order_relaxed);
+        if (((before & bit) != 0) != watch)
+            ++changed;
+    }
+    slot.watched = watch ? slot.watched + changed : slot.watched - changed;
+    return changed;
+}
+
+uint32_t HookFilter::ReadId(const Slot& slot, const uint32_t* frame) const
+{
+    if (slot.source == HookSource_Ecx)
+        return frame[kFrameEcx];
+    if (slot.source == HookSource_Edx)
+        return frame[kFrameEdx];
+    return frame[kFrameArgs + slot.source - HookSource_Stack];
+}
+
+bool HookFilter::Filter(uint16_t id, uint32_t value, const uint32_t* frame)
+{
+    Slot& slot = m_slots[id];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    if (value >= kHookFilterMaxIds || !(slot.bits[value >> 5] & (1u << (value & 31))))
+        return false;
+    OnMatch(id, frame);
+    return true;
+}
+
+void HookFilter::OnMatch(uint16_t id, const uint32_t* frame)
+{
+    Slot& slot = m_slots[id];
+
+    HookEvent event;
+    event.ticks = PlatformNowTicks();
+    event.hook = id;
+    event.threadId = PlatformThreadId();
+    event.id = ReadId(slot, frame);
+    event.returnAddress = frame[kFrameReturn];
+    event.ecx = frame[kFrameEcx];
+    event.edx = frame[kFrameEdx];
+    memcpy(event.args, frame + kFrameArgs, sizeof(event.args));
+
+    slot.matched.fetch_add(1, std::memory_order_relaxed);
+    if (!m_ring.TryPush(event))
+        slot.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t HookFilter::Drain(HookEvent* out, uint32_t capacity)
+{
+    uint32_t n = 0;
+    while (n < capacity && m_ring.TryPop(out[n]))
+        ++n;
+    m_drains.fetch_add(1, std::memory_order_relaxed);
+    m_drained.fetch_add(n, std::memory_order_relaxed);
+    return n;
+}
+
+// Caller holds m_lock
+void HookFilter::Fold(Slot& slot)
+{
+    const uint32_t calls = slot.calls.load(std::memory_order_relaxed);
+    slot.callsTotal += (uint32_t)(calls - slot.foldedCalls);
+    slot.foldedCalls = calls;
+}
+
+uint32_t HookFilter::Stats(HookFilterStats* out, uint32_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    const uint32_t count = m_count.load(std::memory_order_relaxed);
+    uint32_t n = 0;
+    for (uint32_t i = 1; i < count && n < capacity; ++i, ++n)
+    {
+        Slot& slot = m_slots[i];
+        Fold(slot);
+
+        HookFilterStats& s = out[n];
+        memset(&s, 0, sizeof(s));
+        s.calls = slot.callsTotal;
+        s.matched = slot.matched.load(std::memory_order_relaxed);
+        s.dropped = slot.dropped.load(std::memory_order_relaxed);
+        s.target = slot.target;
+        s.id = i;
+        s.source = slot.source;
+        s.watched = slot.watched;
+        s.installed = slot.installed ? 1 : 0;
+        CopyFilterName(s.name, sizeof(s.name), slot.name);
+    }
+    return n;
+}
+
+void HookFilter::Summary(HookFilterSummary& out)
+{
+    memset(&out, 0, sizeof(out));
+    std::lock_guard<std::mutex> lock(m_lock);
+    const uint32_t count = m_count.load(std::memory_order_relaxed);
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        Slot& slot = m_slots[i];
+        Fold(slot);
+        out.calls += slot.callsTotal;
+        out.matched += slot.matched.load(std::memory_order_relaxed);
+        out.dropped += slot.dropped.load(std::memory_order_relaxed);
+    }
+    out.drains = m_drains.load(std::memory_order_relaxed);
+    out.drained = m_drained.load(std::memory_order_relaxed);
+    out.sinceNs = count > 1 ? PlatformNowNs() - m_sinceNs : 0;
+    out.hooks = count - 1;
+    out.ringSize = kHookFilterRingSize;
+}
+
+std::string HookFilter::LastError()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_lastError;
+}
@@ -0,0 +1,319 @@
+﻿// HookFilter.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Native pre-filter for game function hooks — decide in the stub whether
+// a call is interesting before anything crosses into managed code
+//
+// Responsibilities:
+// • Install(): patch a game function with a jmp to a generated stub; the
+//   stub reads one argument (ecx, edx or a stack slot) and tests it
+//   against a per-hook bitset of watched ids (spell ids, event ids)
+// • Not watched → straight on to the original (trampoline), nothing
+//   recorded, no managed code involved
+// • Watched → the call's registers and first stack arguments are pushed
+//   into a native event ring, then the original runs
+// • Drain(): the bot thread takes everything queued since the last tick
+//   in one batch (one P/Invoke instead of one reverse P/Invoke per call)
+// • Stats: calls seen, matched, dropped per hook; drains — transitions
+//   saved = calls − drains
+//
+// Architecture:
+// • Stubs and trampolines live in one executable block allocated on first
+//   install (kHookFilterStubSize bytes per hook) and never freed — a game
+//   thread may be inside a stub while it is being removed
+// • The event ring is a bounded MPSC queue (per-cell sequence numbers,
+//   the LogRing scheme) — any game thread pushes, the bot thread drains
+// • Filter() is the stub's logic in C++: what RemoteAchikoBench measures,
+//   and the whole fast path on builds without x86-32 stubs
+//
+// Critical Design Decisions:
+// • x86-32 only (WoW 1.12): stubs are emitted machine code. The caller
+//   names the prologue length to relocate (≥ 5 bytes, whole instructions,
+//   no relative branches) — the same knowledge GreyMagic's push/ret
+//   detour hardcodes as 6
+// • Patching is not atomic against a thread executing the prologue —
+//   install from the game thread, like a GreyMagic detour
+// • Ring full → the event is dropped and counted; the game thread never
+//   waits for the bot
+// • The stub counts calls with a 32-bit locked increment; reads fold the
+//   delta into 64-bit totals (read at least every 2^32 calls)
+// • Heap singleton, never destroyed (same rule as TraceRecorder)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include "Platform.h"
+
+// ═══════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════
+
+static const uint32_t kHookFilterMaxHooks = 16;         // id 0 is reserved for "none"
+static const uint32_t kHookFilterMaxIds = 65536;        // watched ids are [0, 65536)
+static const uint32_t kHookFilterRingSize = 4096;       // events between two drains
+static const uint32_t kHookFilterStubSize = 128;        // stub + trampoline per hook
+static const uint32_t kHookFilterMaxPrologue = 16;
+static const uint32_t kHookFilterMaxStackArg = 8;
+static const uint32_t kHookFilterArgs = 6;              // stack arguments copied per event
+
+// Where the stub finds the id it tests
+enum HookFilterSource : uint32_t
+{
+    HookSource_Ecx = 0,            // __thiscall this / __fastcall first argument
+    HookSource_Edx = 1,            // __fastcall second argument
+    HookSource_Stack = 2           // + n: n-th stack argument (n < kHookFilterMaxStackArg)
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Records (layouts shared with HookFilter.cs)
+// ═══════════════════════════════════════════════════════════════
+
+// One watched call — 56 bytes
+struct HookEvent
+{
+    uint64_t ticks;                // PlatformNowTicks() in the stub
+    uint32_t hook;
+    uint32_t threadId;
+    uint32_t id;                   // the value that matched the bitset
+    uint32_t returnAddress;        // caller
+    uint32_t ecx;
+    uint32_t edx;
+    uint32_t args[kHookFilterArgs];  // stack arguments 0.. (beyond the real
+                                     // argument count: caller's frame)
+};
+
+struct HookFilterStats
+{
+    uint64_t calls;                // stub entries since install
+    uint64_t matched;              // pushed into the ring
+    uint64_t dropped;              // matched, ring full
+    uint64_t target;               // patched function (0 = filter only)
+    uint32_t id;
+    uint32_t source;               // HookFilterSource
+    uint32_t watched;              // ids set in the bitset
+    uint32_t installed;            // 1 = patch in place
+    char name[32];
+};
+
+struct HookFilterSummary
+{
+    uint64_t calls;                // every hook
+    uint64_t matched;
+    uint64_t dropped;
+    uint64_t drains;               // managed batch reads — one transition each
+    uint64_t drained;              // events handed to managed code
+    uint64_t sinceNs;              // first hook registered → now
+    uint32_t hooks;
+    uint32_t ringSize;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// HookEventRing — MPSC bounded ring of HookEvents
+// ═══════════════════════════════════════════════════════════════
+class HookEventRing
+{
+public:
+    HookEventRing() : m_cells(nullptr), m_enqueuePos(0), m_dequeuePos(0)
+    {
+        m_cells = static_cast<Cell*>(PlatformAlignedAlloc(sizeof(Cell) * kHookFilterRingSize, kCacheLine));
+        if (!m_cells)
+            throw std::bad_alloc();
+        for (size_t i = 0; i < kHookFilterRingSize; ++i)
+        {
+            new (&m_cells[i]) Cell();
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~HookEventRing()
+    {
+        for (size_t i = 0; i < kHookFilterRingSize; ++i)
+            m_cells[i].~Cell();
+        PlatformAlignedFree(m_cells);
+    }
+
+    // false = ring full (caller counts the drop)
+    bool TryPush(const HookEvent& event)
+    {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &m_cells[pos & (kHookFilterRingSize - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->event = event;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer only
+    bool TryPop(HookEvent& out)
+    {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &m_cells[pos & (kHookFilterRingSize - 1)];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+            return false;
+
+        out = cell->event;
+        cell->sequence.store(pos + kHookFilterRingSize, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Upper bound on what TryPop will return right now (consumer side)
+    size_t Pending() const
+    {
+        const size_t queued = m_enqueuePos.load(std::memory_order_relaxed) -
+                              m_dequeuePos.load(std::memory_order_relaxed);
+        return queued < kHookFilterRingSize ? queued : kHookFilterRingSize;
+    }
+
+private:
+    HookEventRing(const HookEventRing&);
+    HookEventRing& operator=(const HookEventRing&);
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        HookEvent event;
+    };
+
+    Cell* m_cells;
+    std::atomic<size_t> m_enqueuePos;                                // producers
+    char m_pad[kCacheLine - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_dequeuePos;                                // consumer
+};
+
+// ═══════════════════════════════════════════════════════════════
+// HookFilter — process-wide filtered hooks
+// ═══════════════════════════════════════════════════════════════
+class HookFilter
+{
+public:
+    static HookFilter& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // Register — a named filter (bitset + counters), nothing patched
+    //
+    // Returns:
+    //   Stable id (same name → same id), 0 if the table is full or
+    //   the source is out of range
+    // ───────────────────────────────────────────────────────────────
+    uint16_t Register(const char* name, uint32_t source);
+
+    // ───────────────────────────────────────────────────────────────
+    // Install — patch target to run through the filter's stub
+    //
+    // Args:
+    //   target        - game function entry
+    //   prologueBytes - bytes to relocate into the trampoline: ≥ 5,
+    //                   ends on an instruction boundary, no relative
+    //                   branches or calls
+    //
+    // Returns:
+    //   true if patched (or already patched at target); false with
+    //   LastError() set otherwise
+    // ───────────────────────────────────────────────────────────────
+    bool Install(uint16_t id, uintptr_t target, uint32_t prologueBytes);
+
+    // Restore the original bytes; the stub stays valid for threads inside it
+    bool Remove(uint16_t id);
+
+    // ───────────────────────────────────────────────────────────────
+    // Watch — set (watch = true) or clear ids in a filter's bitset
+    //
+    // Returns:
+    //   Ids whose bit changed (out-of-range ids are ignored)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Watch(uint16_t id, const uint32_t* ids, uint32_t count, bool watch);
+
+    // ───────────────────────────────────────────────────────────────
+    // Filter — the stub's fast path in C++ for one call
+    //
+    // Args:
+    //   frame - the stub's register frame: eflags, pushad block, return
+    //           address, stack arguments (see HookFilter.cpp); only read
+    //           on a match
+    //
+    // Returns:
+    //   true if the call matched (and was recorded or dropped)
+    // ───────────────────────────────────────────────────────────────
+    bool Filter(uint16_t id, uint32_t value, const uint32_t* frame);
+
+    // The stub's match path: record the call described by frame
+    void OnMatch(uint16_t id, const uint32_t* frame);
+
+    // ───────────────────────────────────────────────────────────────
+    // Drain — move queued events into out (single consumer)
+    //
+    // Returns:
+    //   Events written; counts one drain even when empty
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Drain(HookEvent* out, uint32_t capacity);
+    size_t Pending() const { return m_ring.Pending(); }
+
+    uint32_t Stats(HookFilterStats* out, uint32_t capacity);
+    void Summary(HookFilterSummary& out);
+    std::string LastError();
+
+private:
+    // Per-hook state; the stub addresses calls and bits directly
+    struct Slot
+    {
+        char name[32];
+        uint32_t source;
+        std::atomic<uint32_t> calls;          // stub's locked increment (wraps)
+        uint32_t foldedCalls;                 // calls value at the last fold
+        uint64_t callsTotal;                  // m_lock
+        std::atomic<uint64_t> matched;
+        std::atomic<uint64_t> dropped;
+        uint32_t* bits;                       // kHookFilterMaxIds bits
+        uint32_t watched;                     // m_lock
+        uintptr_t target;                     // m_lock
+        uint32_t prologueBytes;
+        uint8_t original[kHookFilterMaxPrologue];
+        uint8_t* stub;                        // emitted once, never freed
+        bool installed;
+    };
+
+    HookFilter();
+    HookFilter(const HookFilter&);
+    HookFilter& operator=(const HookFilter&);
+
+    uint32_t ReadId(const Slot& slot, const uint32_t* frame) const;
+    void Fold(Slot& slot);
+    bool Fail(const char* error);
+
+    std::mutex m_lock;                         // Register / Install / Watch / Stats
+    Slot m_slots[kHookFilterMaxHooks];
+    std::atomic<uint32_t> m_count;
+    uint8_t* m_stubBlock;                      // kHookFilterMaxHooks stubs
+    std::string m_lastError;
+    uint64_t m_sinceNs;
+
+    HookEventRing m_ring;
+    std::atomic<uint64_t> m_drains;
+    std::atomic<uint64_t> m_drained;
+};
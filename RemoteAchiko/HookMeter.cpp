@@ -0,0 +1,365 @@
+﻿// HookMeter.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// HookMeter implementation — per-thread counter blocks, frame budgets,
+// aggregation on read
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "HookMeter.h"
+
+#include <new>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// HookThreadBlock — counters owned by one recording thread
+// ═══════════════════════════════════════════════════════════════
+struct HookCounter
+{
+    uint64_t invocations;
+    uint64_t ticks;
+    uint64_t maxTicks;
+    uint64_t transitions;
+    uint64_t frameTicks;           // time inside the hook during `frame`
+    uint32_t frame;
+    uint32_t reserved;
+};
+
+struct HookThreadBlock
+{
+    alignas(64) std::atomic<uint32_t> seq;   // odd while the owner updates
+    uint32_t epoch;                          // HookMeter::m_epoch the counters belong to
+    uint32_t threadId;
+    HookCounter counters[kHookMaxHooks];
+};
+
+static thread_local HookThreadBlock* t_hookBlock = nullptr;
+static thread_local bool t_hookNoBlock = false;   // registration failed — stop retrying
+
+// Bounded copy that always leaves dst terminated
+static void CopyHookName(char* dst, size_t capacity, const char* src)
+{
+    size_t n = strlen(src);
+    if (n > capacity - 1)
+        n = capacity - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ───────────────────────────────────────────────────────────────
+// ReadBlock — consistent copy of one thread's counters [0, hooks)
+//
+// Returns:
+//   false if the block belongs to an older epoch (not reset yet by
+//   its owner — it counts as zero)
+// ───────────────────────────────────────────────────────────────
+static bool ReadBlock(const HookThreadBlock* block, uint32_t epoch, uint32_t hooks, HookCounter* out)
+{
+    for (;;)
+    {
+        const uint32_t before = block->seq.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            PlatformCpuRelax();
+            continue;
+        }
+        const bool current = block->epoch == epoch;
+        if (current)
+            memcpy(out, block->counters, hooks * sizeof(HookCounter));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block->seq.load(std::memory_order_relaxed) == before)
+            return current;
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// Instance — leaked on purpose (see header)
+// ───────────────────────────────────────────────────────────────
+HookMeter& HookMeter::Instance()
+{
+    static HookMeter* s_instance = new HookMeter();
+    return *s_instance;
+}
+
+HookMeter::HookMeter()
+    : m_hookCount(1), m_threadCount(0), m_dropped(0), m_frame(0), m_epoch(1),
+      m_frames(0), m_frameHookNs(0), m_worstFrameNs(0), m_alarms(0), m_sinceNs(PlatformNowNs())
+{
+    for (uint32_t i = 0; i < kHookMaxHooks; ++i)
+    {
+        memset(m_hooks[i].name, 0, sizeof(m_hooks[i].name));
+        m_hooks[i].budgetUs.store(0, std::memory_order_relaxed);
+        m_hooks[i].flags.store(0, std::memory_order_relaxed);
+    }
+    memset(m_threads, 0, sizeof(m_threads));
+    memset(m_frameState, 0, sizeof(m_frameState));
+    CopyHookName(m_hooks[0].name, sizeof(m_hooks[0].name), "none");
+}
+
+// ═══════════════════════════════════════════════════════════════
+// REGISTRATION
+// ═══════════════════════════════════════════════════════════════
+
+uint16_t HookMeter::Register(const char* name, uint32_t budgetUs, uint32_t flags)
+{
+    if (!name || !*name)
+        return 0;
+
+    std::lock_guard<std::mutex> guard(m_hooksLock);
+
+    const uint32_t count = m_hookCount.load(std::memory_order_relaxed);
+    uint32_t id = 1;
+    while (id < count && strncmp(m_hooks[id].name, name, sizeof(m_hooks[id].name) - 1) != 0)
+        ++id;
+    if (id == count)
+    {
+        if (count >= kHookMaxHooks)
+            return 0;
+        CopyHookName(m_hooks[id].name, sizeof(m_hooks[id].name), name);
+    }
+    m_hooks[id].budgetUs.store(budgetUs, std::memory_order_relaxed);
+    m_hooks[id].flags.store(flags, std::memory_order_relaxed);
+
+    // Publish after the entry is written — readers take no lock
+    if (id == count)
+        m_hookCount.store(count + 1, std::memory_order_release);
+    return (uint16_t)id;
+}
+
+void HookMeter::SetBudget(uint16_t id, uint32_t budgetUs)
+{
+    if (id != 0 && id < m_hookCount.load(std::memory_order_acquire))
+        m_hooks[id].budgetUs.store(budgetUs, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RECORD PATH
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// CurrentBlock — this thread's counters, registered on first use
+// ───────────────────────────────────────────────────────────────
+HookThreadBlock* HookMeter::CurrentBlock()
+{
+    HookThreadBlock* block = t_hookBlock;
+    if (block || t_hookNoBlock)
+        return block;
+
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+
+    const uint32_t count = m_threadCount.load(std::memory_order_relaxed);
+    void* memory = count < kHookMaxThreads ? PlatformAlignedAlloc(sizeof(HookThreadBlock), kCacheLine) : nullptr;
+    if (!memory)
+    {
+        t_hookNoBlock = true;
+        return nullptr;
+    }
+
+    block = new (memory) HookThreadBlock();
+    block->seq.store(0, std::memory_order_relaxed);
+    block->epoch = m_epoch.load(std::memory_order_relaxed);
+    block->threadId = PlatformThreadId();
+    memset(block->counters, 0, sizeof(block->counters));
+
+    // Blocks outlive their threads — a game thread that exits keeps
+    // its totals in the report
+    m_threads[count] = block;
+    m_threadCount.store(count + 1, std::memory_order_release);
+
+    t_hookBlock = block;
+    return block;
+}
+
+void HookMeter::Record(uint16_t id, uint64_t startTicks, uint64_t endTicks, uint32_t transitions)
+{
+    if (id == 0 || id >= kHookMaxHooks)
+        return;
+
+    HookThreadBlock* block = CurrentBlock();
+    if (!block)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint64_t ticks = endTicks > startTicks ? endTicks - startTicks : 0;
+    const uint32_t frame = m_frame.load(std::memory_order_relaxed);
+    const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+    const uint32_t seq = block->seq.load(std::memory_order_relaxed);
+
+    block->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Reset() is applied by the owner — nobody else writes a block
+    if (block->epoch != epoch)
+    {
+        memset(block->counters, 0, sizeof(block->counters));
+        block->epoch = epoch;
+    }
+
+    HookCounter& c = block->counters[id];
+    ++c.invocations;
+    c.ticks += ticks;
+    if (ticks > c.maxTicks)
+        c.maxTicks = ticks;
+    c.transitions += transitions;
+    if (c.frame != frame)
+    {
+        c.frame = frame;
+        c.frameTicks = 0;
+    }
+    c.frameTicks += ticks;
+
+    block->seq.store(seq + 2, std::memory_order_release);
+
+    if (m_hooks[id].flags.load(std::memory_order_relaxed) & HookFlag_Frame)
+        FrameEnd();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FRAMES
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// FrameEnd — judge the frame that just ended, start the next
+//
+// Notes:
+//   • Runs on the frame hook's thread (the game's render thread):
+//     never blocks — while Stats / Reset hold the lock the frame is
+//     only advanced, its time folds into no judgement
+// ───────────────────────────────────────────────────────────────
+void HookMeter::FrameEnd()
+{
+    std::unique_lock<std::mutex> lock(m_frameLock, std::try_to_lock);
+    const uint32_t frame = m_frame.load(std::memory_order_relaxed);
+    if (lock.owns_lock())
+        EndFrame(frame);
+    m_frame.store(frame + 1, std::memory_order_relaxed);
+}
+
+void HookMeter::EndFrame(uint32_t frame)
+{
+    const uint32_t hooks = m_hookCount.load(std::memory_order_acquire);
+    const uint32_t threads = m_threadCount.load(std::memory_order_acquire);
+    const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+
+    uint64_t frameTicks[kHookMaxHooks];
+    memset(frameTicks, 0, sizeof(frameTicks));
+    HookCounter counters[kHookMaxHooks];
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        if (!ReadBlock(m_threads[t], epoch, hooks, counters))
+            continue;
+        for (uint32_t id = 1; id < hooks; ++id)
+            if (counters[id].frame == frame)
+                frameTicks[id] += counters[id].frameTicks;
+    }
+
+    uint64_t totalNs = 0;
+    for (uint32_t id = 1; id < hooks; ++id)
+    {
+        if (!frameTicks[id])
+            continue;
+        const uint64_t ns = PlatformTicksToNs(frameTicks[id]);
+        HookFrameState& s = m_frameState[id];
+        ++s.frames;
+        if (ns > s.worstFrameNs)
+            s.worstFrameNs = ns;
+        const uint32_t budgetUs = m_hooks[id].budgetUs.load(std::memory_order_relaxed);
+        if (budgetUs && ns > (uint64_t)budgetUs * 1000)
+        {
+            ++s.alarms;
+            s.lastAlarmFrame = m_frames;
+            ++m_alarms;
+        }
+        totalNs += ns;
+    }
+
+    ++m_frames;
+    m_frameHookNs += totalNs;
+    if (totalNs > m_worstFrameNs)
+        m_worstFrameNs = totalNs;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// READ
+// ═══════════════════════════════════════════════════════════════
+
+uint32_t HookMeter::Stats(HookStats* out, uint32_t capacity)
+{
+    const uint32_t hooks = m_hookCount.load(std::memory_order_acquire);
+    const uint32_t threads = m_threadCount.load(std::memory_order_acquire);
+    const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+    const uint32_t n = hooks - 1 < capacity ? hooks - 1 : capacity;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        memset(&out[i], 0, sizeof(out[i]));
+        out[i].id = i + 1;
+        out[i].budgetUs = m_hooks[i + 1].budgetUs.load(std::memory_order_relaxed);
+        out[i].flags = m_hooks[i + 1].flags.load(std::memory_order_relaxed);
+        CopyHookName(out[i].name, sizeof(out[i].name), m_hooks[i + 1].name);
+    }
+
+    HookCounter counters[kHookMaxHooks];
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        if (!ReadBlock(m_threads[t], epoch, hooks, counters))
+            continue;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const HookCounter& c = counters[i + 1];
+            if (!c.invocations)
+                continue;
+            HookStats& s = out[i];
+            s.invocations += c.invocations;
+            s.totalNs += c.ticks;                       // converted below
+            if (c.maxTicks > s.maxNs)
+                s.maxNs = c.maxTicks;
+            s.transitions += c.transitions;
+            ++s.threads;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_frameLock);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        HookStats& s = out[i];
+        s.totalNs = PlatformTicksToNs(s.totalNs);
+        s.maxNs = PlatformTicksToNs(s.maxNs);
+        const HookFrameState& f = m_frameState[i + 1];
+        s.frames = f.frames;
+        s.worstFrameNs = f.worstFrameNs;
+        s.alarms = f.alarms;
+        s.lastAlarmFrame = f.lastAlarmFrame;
+    }
+    return n;
+}
+
+void HookMeter::Summary(HookMeterSummary& out)
+{
+    memset(&out, 0, sizeof(out));
+    out.hooks = m_hookCount.load(std::memory_order_acquire) - 1;
+    out.threads = m_threadCount.load(std::memory_order_acquire);
+    out.dropped = m_dropped.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(m_frameLock);
+    out.frames = m_frames;
+    out.hookNs = m_frameHookNs;
+    out.worstFrameNs = m_worstFrameNs;
+    out.alarms = m_alarms;
+    out.sinceNs = PlatformNowNs() - m_sinceNs;
+}
+
+void HookMeter::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_frameLock);
+    // Owners zero their blocks on their next record; until then
+    // readers skip them
+    m_epoch.fetch_add(1, std::memory_order_relaxed);
+    memset(m_frameState, 0, sizeof(m_frameState));
+    m_frames = 0;
+    m_frameHookNs = 0;
+    m_worstFrameNs = 0;
+    m_alarms = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_sinceNs = PlatformNowNs();
+}
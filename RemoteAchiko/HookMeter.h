@@ -0,0 +1,214 @@
+﻿// HookMeter.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Hook cost accounting — invocations, time inside each hook, managed
+// transitions, and a per-frame budget alarm
+//
+// Responsibilities:
+// • Register hooks by name (id table, same name → same id) with a
+//   per-frame budget in µs
+// • Record one invocation: duration and how many times it crossed into
+//   managed code (HookScope does both)
+// • FrameEnd: per-hook time spent in the frame that just ended, compared
+//   against each budget — over budget counts an alarm
+// • Stats: per-hook totals aggregated over every thread on read
+//
+// Architecture:
+// • One counter block per recording thread (thread_local lookup, like
+//   TraceRecorder's buffers) — the hot path touches only the caller's
+//   own cache lines, no atomic read-modify-write, no lock
+// • Readers (FrameEnd, Stats) sum the blocks under a per-block sequence
+//   number and retry when they catch an update in flight
+// • Frames are counted by a frame hook (EndScene / Present): every
+//   invocation of a hook registered with HookFlag_Frame ends a frame.
+//   Per-frame time is kept against the frame number, so nothing is ever
+//   reset on another thread's counters
+//
+// Critical Design Decisions:
+// • Durations are PlatformNowTicks() deltas — converted to ns on read,
+//   never on the record path; managed Stopwatch timestamps are the same
+//   unit on Windows
+// • Times are inclusive: a hook called from inside another hook counts
+//   for both
+// • Without a frame hook there are no frames and no alarms — totals and
+//   µs per second still work
+// • Heap singleton, never destroyed (game threads may be inside a hook
+//   when WoW exits — same rule as TraceRecorder)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include "Platform.h"
+
+// ═══════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════
+
+static const uint32_t kHookMaxHooks = 64;            // id 0 is reserved for "none"
+static const uint32_t kHookMaxThreads = 32;
+static const uint32_t kHookDefaultBudgetUs = 200;
+
+enum HookFlags : uint32_t
+{
+    HookFlag_Frame = 1             // each invocation ends a frame (EndScene / Present)
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Stats (layouts shared with HookMeter.cs)
+// ═══════════════════════════════════════════════════════════════
+struct HookStats
+{
+    uint64_t invocations;
+    uint64_t totalNs;              // time inside the hook, all threads
+    uint64_t maxNs;                // longest single invocation
+    uint64_t transitions;          // native → managed crossings
+    uint64_t frames;               // frames the hook ran in
+    uint64_t worstFrameNs;         // most time inside the hook in one frame
+    uint64_t alarms;               // frames over budget
+    uint64_t lastAlarmFrame;
+    uint32_t id;
+    uint32_t budgetUs;             // 0 = no alarm
+    uint32_t flags;
+    uint32_t threads;              // threads that ran it
+    char name[32];
+};
+
+struct HookMeterSummary
+{
+    uint64_t frames;               // frame hook invocations since Reset
+    uint64_t hookNs;               // every hook, every frame (inclusive)
+    uint64_t worstFrameNs;         // most hook time in one frame
+    uint64_t sinceNs;              // Reset → now
+    uint64_t alarms;
+    uint64_t dropped;              // records lost: thread table full
+    uint32_t hooks;
+    uint32_t threads;
+};
+
+struct HookThreadBlock;   // HookMeter.cpp
+
+// ═══════════════════════════════════════════════════════════════
+// HookMeter — process-wide hook counters
+// ═══════════════════════════════════════════════════════════════
+class HookMeter
+{
+public:
+    static HookMeter& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // Register — intern a hook name
+    //
+    // Args:
+    //   budgetUs - time the hook may add per frame before it alarms
+    //              (0 = never); re-registering updates budget and flags
+    //
+    // Returns:
+    //   Stable id (same name → same id), 0 if the table is full
+    // ───────────────────────────────────────────────────────────────
+    uint16_t Register(const char* name, uint32_t budgetUs, uint32_t flags);
+    void SetBudget(uint16_t id, uint32_t budgetUs);
+
+    // ───────────────────────────────────────────────────────────────
+    // Record — one invocation, on the thread that ran it
+    //
+    // Notes:
+    //   • A frame hook's invocation ends the frame after it is counted
+    //   • Thread table full → record dropped, Dropped() incremented
+    // ───────────────────────────────────────────────────────────────
+    void Record(uint16_t id, uint64_t startTicks, uint64_t endTicks, uint32_t transitions);
+
+    // End the current frame explicitly (no frame hook installed)
+    void FrameEnd();
+
+    // ───────────────────────────────────────────────────────────────
+    // Stats — per-hook totals, summed over every thread's block
+    //
+    // Returns:
+    //   Hooks written (registration order)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Stats(HookStats* out, uint32_t capacity);
+    void Summary(HookMeterSummary& out);
+
+    // Zero every counter (hooks and budgets stay registered)
+    void Reset();
+
+    uint32_t Frame() const { return m_frame.load(std::memory_order_relaxed); }
+
+private:
+    struct HookInfo
+    {
+        char name[32];
+        std::atomic<uint32_t> budgetUs;
+        std::atomic<uint32_t> flags;
+    };
+
+    // Per-hook frame results — FrameEnd only (m_frameLock)
+    struct HookFrameState
+    {
+        uint64_t frames;
+        uint64_t worstFrameNs;
+        uint64_t alarms;
+        uint64_t lastAlarmFrame;
+    };
+
+    HookMeter();
+    HookMeter(const HookMeter&);
+    HookMeter& operator=(const HookMeter&);
+
+    HookThreadBlock* CurrentBlock();
+    void EndFrame(uint32_t frame);
+
+    std::mutex m_hooksLock;                       // Register only
+    HookInfo m_hooks[kHookMaxHooks];
+    std::atomic<uint32_t> m_hookCount;
+
+    std::mutex m_threadsLock;                     // block registration
+    HookThreadBlock* m_threads[kHookMaxThreads];
+    std::atomic<uint32_t> m_threadCount;
+    std::atomic<uint64_t> m_dropped;
+
+    std::atomic<uint32_t> m_frame;                // read on every Record
+    std::atomic<uint32_t> m_epoch;                // bumped by Reset
+
+    std::mutex m_frameLock;                       // FrameEnd / Reset
+    HookFrameState m_frameState[kHookMaxHooks];
+    uint64_t m_frames;
+    uint64_t m_frameHookNs;
+    uint64_t m_worstFrameNs;
+    uint64_t m_alarms;
+    uint64_t m_sinceNs;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// HookScope — RAII measurement for a native hook body
+// ═══════════════════════════════════════════════════════════════
+// Usage:
+//   static const uint16_t s_id = HookMeter::Instance().Register("CastSpell", 50, 0);
+//   HookScope scope(s_id);
+//   ...
+//   scope.Transition();      // before each call into managed code
+// ───────────────────────────────────────────────────────────────
+class HookScope
+{
+public:
+    explicit HookScope(uint16_t id) : m_id(id), m_transitions(0), m_start(PlatformNowTicks()) {}
+
+    ~HookScope()
+    {
+        if (m_id != 0)
+            HookMeter::Instance().Record(m_id, m_start, PlatformNowTicks(), m_transitions);
+    }
+
+    void Transition() { ++m_transitions; }
+
+private:
+    HookScope(const HookScope&);
+    HookScope& operator=(const HookScope&);
+
+    uint16_t m_id;
+    uint32_t m_transitions;
+    uint64_t m_start;
+};
@@ -0,0 +1,529 @@
+﻿// InventorySnapshot.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Bag contents per tick — slot hashes, change events, cached item metadata
+//
+// Responsibilities:
+// • Refresh(): read backpack + equipped bags + every item's stack fields,
+//   hash each slot and diff against the last refresh
+// • Change events: added / removed / stack changed / changed (durability,
+//   flags), in bag order, into the tick arena
+// • ItemInfoCache: entry → quality, class, sell price, max stack, name,
+//   read once from the client's item table and kept for the session
+//
+// Architecture:
+// • Item and bag GUIDs resolve to objects through this tick's
+//   ObjectDirectory; the GUID index over it is rebuilt only when the
+//   directory's generation moves
+// • Slots are a fixed grid (bag × slot) so a diff is a straight compare
+//   per cell — no matching, no allocation on the tick
+// • One guarded copy per slot array and one per item (a window covering
+//   every item field) — ~100 copies for full bags
+// • Single caller (the bot thread, after the object snapshot) — no lock
+//
+// Critical Design Decisions:
+// • An item GUID whose object is not in the list yet counts as an empty
+//   slot; it is "added" the tick it resolves, never as a half-read item.
+//   An item or bag already known keeps its last state instead — a
+//   transient miss must not read as "removed, then added again"
+// • When the player cannot be read (loading screen) the last contents are
+//   kept and nothing is emitted — a zone change is not "every item removed"
+// • Metadata misses (item not in the client's cache yet) are retried every
+//   kItemInfoRetryRefreshes refreshes, not every lookup
+// • Offsets come from managed code (client build specific); a bad one
+//   reads as empty, never faults the client
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "GuidIndex.h"
+#include "MemoryRead.h"
+#include "ObjectDirectory.h"
+#include "Platform.h"
+#include "TickArena.h"
+
+static const uint32_t kInventoryBags = 5;           // backpack + 4 equipped bags
+static const uint32_t kInventoryBagSlots = 36;      // largest container
+static const uint32_t kItemInfoRetryRefreshes = 64;
+
+// Client offsets — layout shared with Inventory.cs
+struct InventoryLayout
+{
+    uint64_t itemTable;            // client table: record pointer per entry (0 = no metadata)
+    uint32_t itemTableMin;         // entry of itemTable[0]
+    uint32_t itemTableCount;
+    uint32_t objectDescriptors;    // object → descriptor block pointer
+    uint32_t playerPackSlots;      // player descriptors → uint64 GUID[packSlotCount]
+    uint32_t packSlotCount;        // backpack size
+    uint32_t playerBagSlots;       // player descriptors → uint64 GUID[bagCount]
+    uint32_t bagCount;             // equipped bag slots (≤ kInventoryBags - 1)
+    uint32_t containerSlotCount;   // container descriptors → uint32 slot count
+    uint32_t containerSlots;       // container descriptors → uint64 GUID[slot count]
+    uint32_t itemEntry;            // item descriptors → uint32
+    uint32_t itemStackCount;       // item descriptors → uint32
+    uint32_t itemDurability;       // item descriptors → uint32
+    uint32_t itemFlags;            // item descriptors → uint32
+    uint32_t recordQuality;        // item record → uint32
+    uint32_t recordClass;          // item record → uint32
+    uint32_t recordSubClass;       // item record → uint32
+    uint32_t recordSellPrice;      // item record → uint32 (copper)
+    uint32_t recordMaxStack;       // item record → uint32
+    uint32_t recordItemLevel;      // item record → uint32
+    uint32_t recordName;           // item record → char* name
+    uint32_t reserved;
+};
+
+// One occupied bag slot — layout shared with Inventory.cs
+struct InventorySlot
+{
+    uint64_t guid;
+    uint32_t entry;
+    uint32_t stackCount;
+    uint32_t durability;
+    uint32_t flags;
+    uint8_t bag;                   // 0 = backpack, 1-4 = equipped bags
+    uint8_t slot;
+    uint16_t reserved;
+    uint32_t hash;                 // of guid, entry, stack, durability, flags
+};
+
+enum InventoryEventType : uint8_t
+{
+    InventoryEvent_Added = 1,
+    InventoryEvent_Removed = 2,
+    InventoryEvent_StackChanged = 3,
+    InventoryEvent_Changed = 4,    // durability / flags
+};
+
+// Layout shared with Inventory.cs
+struct InventoryEvent
+{
+    uint64_t guid;
+    uint32_t entry;
+    uint32_t stackCount;           // after the change (0 when removed)
+    int32_t stackDelta;
+    uint8_t type;                  // InventoryEventType
+    uint8_t bag;
+    uint8_t slot;
+    uint8_t reserved;
+};
+
+// Layout shared with Inventory.cs
+struct ItemInfo
+{
+    uint32_t entry;
+    uint32_t sellPrice;            // copper
+    uint32_t maxStack;
+    uint32_t itemLevel;
+    uint8_t quality;               // 0 poor … 5 legendary
+    uint8_t itemClass;
+    uint8_t subClass;
+    uint8_t resolved;              // 0 = not in the client's cache yet
+    char name[44];
+};
+
+struct InventoryStats
+{
+    uint64_t refreshes;
+    uint64_t changed;              // refreshes that emitted events
+    uint64_t events;
+    uint64_t unresolved;           // item GUIDs with no object yet, all refreshes
+    uint64_t faults;               // refreshes that could not read the player
+    uint64_t refreshNs;
+    uint64_t indexRebuilds;
+    uint32_t lastSlots;            // slots in bags (occupied or not)
+    uint32_t lastItems;            // occupied slots
+    uint32_t infoCached;           // entries with metadata
+    uint32_t infoMisses;           // entries still waiting for the client
+    uint32_t hash;                 // whole inventory
+    uint32_t reserved;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ItemInfoCache — entry → metadata, read from the client once
+// ═══════════════════════════════════════════════════════════════
+class ItemInfoCache
+{
+public:
+    ItemInfoCache() : m_layout(), m_refresh(0), m_resolved(0) {}
+
+    void Configure(const InventoryLayout& layout)
+    {
+        m_layout = layout;
+        m_index.Clear();
+        m_infos.clear();
+        m_retryAt.clear();
+        m_resolved = 0;
+    }
+
+    // Called once per inventory refresh — drives retries
+    void Tick() { ++m_refresh; }
+
+    // ───────────────────────────────────────────────────────────────
+    // Lookup — metadata for entry, reading the client table on first
+    // use (and on retry for entries the client did not have yet)
+    //
+    // Returns:
+    //   Cached record (resolved == 0 while unknown); null for entry 0
+    // ───────────────────────────────────────────────────────────────
+    const ItemInfo* Lookup(uint32_t entry)
+    {
+        if (!entry)
+            return nullptr;
+
+        uint32_t i = m_index.Find(entry);
+        if (i == GuidIndex::kNotFound)
+        {
+            ItemInfo info;
+            memset(&info, 0, sizeof(info));
+            info.entry = entry;
+            i = (uint32_t)m_infos.size();
+            m_infos.push_back(info);
+            m_retryAt.push_back(0);
+            m_index.Insert(entry, i);
+        }
+
+        ItemInfo& info = m_infos[i];
+        if (!info.resolved && m_refresh >= m_retryAt[i])
+        {
+            if (Read(info))
+                ++m_resolved;
+            else
+                m_retryAt[i] = m_refresh + kItemInfoRetryRefreshes;
+        }
+        return &info;
+    }
+
+    uint32_t Cached() const { return m_resolved; }
+    uint32_t Misses() const { return (uint32_t)m_infos.size() - m_resolved; }
+
+private:
+    bool Read(ItemInfo& info) const
+    {
+        const uint32_t row = info.entry - m_layout.itemTableMin;
+        uintptr_t record = 0;
+        if (!m_layout.itemTable || info.entry < m_layout.itemTableMin || row >= m_layout.itemTableCount ||
+            !SafeCopy(&record, (const void*)(uintptr_t)(m_layout.itemTable + (uint64_t)row * sizeof(uintptr_t)),
+                      sizeof(record)) ||
+            !record)
+        {
+            return false;
+        }
+
+        uint32_t quality = 0, itemClass = 0, subClass = 0;
+        uintptr_t name = 0;
+        if (!SafeCopy(&quality, (const void*)(record + m_layout.recordQuality), sizeof(quality)) ||
+            !SafeCopy(&itemClass, (const void*)(record + m_layout.recordClass), sizeof(itemClass)) ||
+            !SafeCopy(&subClass, (const void*)(record + m_layout.recordSubClass), sizeof(subClass)) ||
+            !SafeCopy(&info.sellPrice, (const void*)(record + m_layout.recordSellPrice), sizeof(info.sellPrice)) ||
+            !SafeCopy(&info.maxStack, (const void*)(record + m_layout.recordMaxStack), sizeof(info.maxStack)) ||
+            !SafeCopy(&info.itemLevel, (const void*)(record + m_layout.recordItemLevel), sizeof(info.itemLevel)) ||
+            !SafeCopy(&name, (const void*)(record + m_layout.recordName), sizeof(name)))
+        {
+            return false;
+        }
+
+        info.quality = (uint8_t)quality;
+        info.itemClass = (uint8_t)itemClass;
+        info.subClass = (uint8_t)subClass;
+        if (!name || !ReadCString(name, info.name, sizeof(info.name)))
+            info.name[0] = 0;
+        info.resolved = 1;
+        return true;
+    }
+
+    InventoryLayout m_layout;
+    GuidIndex m_index;                     // entry → m_infos index
+    std::vector<ItemInfo> m_infos;
+    std::vector<uint64_t> m_retryAt;       // refresh number of the next read attempt
+    uint64_t m_refresh;
+    uint32_t m_resolved;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// InventorySnapshot
+// ═══════════════════════════════════════════════════════════════
+class InventorySnapshot
+{
+public:
+    explicit InventorySnapshot(const InventoryLayout& layout)
+        : m_layout(layout), m_index(1024), m_indexGeneration(0), m_indexed(false), m_hash(0)
+    {
+        m_layout.packSlotCount = std::min(m_layout.packSlotCount, kInventoryBagSlots);
+        m_layout.bagCount = std::min(m_layout.bagCount, kInventoryBags - 1);
+
+        const uint32_t fields[] = { m_layout.itemEntry, m_layout.itemStackCount,
+                                    m_layout.itemDurability, m_layout.itemFlags };
+        m_itemLo = *std::min_element(fields, fields + 4);
+        m_itemBytes = *std::max_element(fields, fields + 4) + sizeof(uint32_t) - m_itemLo;
+
+        memset(m_slots, 0, sizeof(m_slots));
+        memset(m_bagSize, 0, sizeof(m_bagSize));
+        memset(m_bagGuids, 0, sizeof(m_bagGuids));
+        memset(&m_stats, 0, sizeof(m_stats));
+        m_info.Configure(m_layout);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Refresh — re-read the bags and diff against the last refresh
+    //
+    // Args:
+    //   directory  - this tick's object list (already refreshed)
+    //   playerGuid - the local player
+    //   arena      - receives the event array
+    //   events     - [out] change events (null if none)
+    //
+    // Returns:
+    //   Events written; 0 when nothing changed or the player is not
+    //   readable (contents kept)
+    // ───────────────────────────────────────────────────────────────
+    size_t Refresh(const ObjectDirectory& directory, uint64_t playerGuid, TickArena& arena, InventoryEvent*& events)
+    {
+        const uint64_t start = PlatformNowNs();
+        events = nullptr;
+        ++m_stats.refreshes;
+        m_info.Tick();
+
+        if (!m_indexed || directory.Generation() != m_indexGeneration)
+        {
+            m_index.Clear();
+            m_index.Reserve(directory.Count());
+            for (size_t i = 0; i < directory.Count(); ++i)
+                m_index.Insert(directory.Guid(i), (uint32_t)i);
+            m_indexGeneration = directory.Generation();
+            m_indexed = true;
+            ++m_stats.indexRebuilds;
+        }
+
+        InventorySlot next[kInventoryBags][kInventoryBagSlots];
+        uint32_t nextSize[kInventoryBags];
+        if (!ReadBags(directory, playerGuid, next, nextSize))
+        {
+            ++m_stats.faults;
+            m_stats.refreshNs += PlatformNowNs() - start;
+            return 0;
+        }
+
+        // Diff cell by cell; a bag that shrank or vanished reads as empty
+        InventoryEvent* out = nullptr;
+        size_t count = 0;
+        uint32_t slots = 0, items = 0, hash = 0;
+        for (uint32_t b = 0; b < kInventoryBags; ++b)
+        {
+            const uint32_t cells = std::max(m_bagSize[b], nextSize[b]);
+            slots += nextSize[b];
+            for (uint32_t s = 0; s < cells; ++s)
+            {
+                const InventorySlot& was = m_slots[b][s];
+                const InventorySlot& now = next[b][s];
+                if (now.guid)
+                {
+                    ++items;
+                    hash ^= SlotHash(now.hash + b * kInventoryBagSlots + s);
+                    m_info.Lookup(now.entry);
+                }
+                if (was.hash == now.hash && was.guid == now.guid)
+                    continue;
+
+                if (!out)
+                    out = arena.AllocateArray<InventoryEvent>(2 * kInventoryBags * kInventoryBagSlots);
+                if (!out)
+                    break;
+
+                if (was.guid && now.guid == was.guid)
+                {
+                    Emit(out[count++], now.stackCount != was.stackCount
+                        ? InventoryEvent_StackChanged : InventoryEvent_Changed, now, (int32_t)(now.stackCount - was.stackCount));
+                    continue;
+                }
+                if (was.guid)
+                    Emit(out[count++], InventoryEvent_Removed, was, -(int32_t)was.stackCount);
+                if (now.guid)
+                    Emit(out[count++], InventoryEvent_Added, now, (int32_t)now.stackCount);
+            }
+        }
+
+        memcpy(m_slots, next, sizeof(m_slots));
+        memcpy(m_bagSize, nextSize, sizeof(m_bagSize));
+        m_hash = hash ^ SlotHash((uint64_t)slots << 32 | 0x51075u);     // an empty bag swapped in counts
+
+        m_stats.lastSlots = slots;
+        m_stats.lastItems = items;
+        m_stats.events += count;
+        if (count)
+            ++m_stats.changed;
+        m_stats.refreshNs += PlatformNowNs() - start;
+        events = out;
+        return count;
+    }
+
+    // Whole-inventory hash — equal hashes, equal contents
+    uint32_t Hash() const { return m_hash; }
+
+    // ───────────────────────────────────────────────────────────────
+    // CopySlots — occupied slots in bag order into out[0..max)
+    //
+    // Returns:
+    //   Slots written
+    // ───────────────────────────────────────────────────────────────
+    size_t CopySlots(InventorySlot* out, size_t max) const
+    {
+        size_t n = 0;
+        for (uint32_t b = 0; b < kInventoryBags; ++b)
+            for (uint32_t s = 0; s < m_bagSize[b] && n < max; ++s)
+                if (m_slots[b][s].guid)
+                    out[n++] = m_slots[b][s];
+        return n;
+    }
+
+    size_t ItemCount() const { return m_stats.lastItems; }
+
+    ItemInfoCache& Info() { return m_info; }
+
+    void Stats(InventoryStats& out) const
+    {
+        out = m_stats;
+        out.infoCached = m_info.Cached();
+        out.infoMisses = m_info.Misses();
+        out.hash = m_hash;
+    }
+
+    void ResetStats()
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+private:
+    InventorySnapshot(const InventorySnapshot&) = delete;
+    InventorySnapshot& operator=(const InventorySnapshot&) = delete;
+
+    static uint32_t SlotHash(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return (uint32_t)x;
+    }
+
+    static void Emit(InventoryEvent& e, InventoryEventType type, const InventorySlot& slot, int32_t delta)
+    {
+        e.guid = slot.guid;
+        e.entry = slot.entry;
+        e.stackCount = type == InventoryEvent_Removed ? 0 : slot.stackCount;
+        e.stackDelta = delta;
+        e.type = (uint8_t)type;
+        e.bag = slot.bag;
+        e.slot = slot.slot;
+        e.reserved = 0;
+    }
+
+    // Object GUID → descriptor block address (0 if not in the list or
+    // unreadable)
+    uintptr_t Descriptors(const ObjectDirectory& directory, uint64_t guid) const
+    {
+        const uint32_t i = m_index.Find(guid);
+        uintptr_t descriptors = 0;
+        if (i == GuidIndex::kNotFound || i >= directory.Count() ||
+            !SafeCopy(&descriptors, (const void*)(directory.Address(i) + m_layout.objectDescriptors),
+                      sizeof(descriptors)))
+        {
+            return 0;
+        }
+        return descriptors;
+    }
+
+    bool ReadBags(const ObjectDirectory& directory, uint64_t playerGuid,
+                  InventorySlot (&next)[kInventoryBags][kInventoryBagSlots], uint32_t (&nextSize)[kInventoryBags])
+    {
+        const uintptr_t player = Descriptors(directory, playerGuid);
+        uint64_t guids[kInventoryBagSlots];
+        uint64_t bags[kInventoryBags - 1];
+        if (!player ||
+            !SafeCopy(guids, (const void*)(player + m_layout.playerPackSlots), m_layout.packSlotCount * sizeof(uint64_t)) ||
+            !SafeCopy(bags, (const void*)(player + m_layout.playerBagSlots), m_layout.bagCount * sizeof(uint64_t)))
+        {
+            return false;
+        }
+
+        memset(next, 0, sizeof(next));
+        memset(nextSize, 0, sizeof(nextSize));
+        nextSize[0] = m_layout.packSlotCount;
+        ReadItems(directory, 0, guids, m_layout.packSlotCount, next[0]);
+
+        for (uint32_t b = 0; b < m_layout.bagCount; ++b)
+        {
+            const uintptr_t bag = bags[b] ? Descriptors(directory, bags[b]) : 0;
+            uint32_t size = 0;
+            if (!bag || !SafeCopy(&size, (const void*)(bag + m_layout.containerSlotCount), sizeof(size)) ||
+                !SafeCopy(guids, (const void*)(bag + m_layout.containerSlots),
+                          std::min(size, kInventoryBagSlots) * sizeof(uint64_t)))
+            {
+                if (bags[b] && bags[b] == m_bagGuids[b])
+                {
+                    memcpy(next[b + 1], m_slots[b + 1], sizeof(next[b + 1]));
+                    nextSize[b + 1] = m_bagSize[b + 1];
+                }
+                continue;
+            }
+            size = std::min(size, kInventoryBagSlots);
+            nextSize[b + 1] = size;
+            ReadItems(directory, b + 1, guids, size, next[b + 1]);
+        }
+        memcpy(m_bagGuids, bags, m_layout.bagCount * sizeof(uint64_t));
+        return true;
+    }
+
+    void ReadItems(const ObjectDirectory& directory, uint32_t bag, const uint64_t* guids, uint32_t count,
+                   InventorySlot* out)
+    {
+        uint8_t window[256];
+        for (uint32_t s = 0; s < count; ++s)
+        {
+            if (!guids[s])
+                continue;
+
+            const uintptr_t item = Descriptors(directory, guids[s]);
+            if (!item || m_itemBytes > sizeof(window) ||
+                !SafeCopy(window, (const void*)(item + m_itemLo), m_itemBytes))
+            {
+                ++m_stats.unresolved;
+                if (m_slots[bag][s].guid == guids[s])
+                    out[s] = m_slots[bag][s];
+                continue;
+            }
+
+            InventorySlot& slot = out[s];
+            slot.guid = guids[s];
+            memcpy(&slot.entry, window + (m_layout.itemEntry - m_itemLo), sizeof(uint32_t));
+            memcpy(&slot.stackCount, window + (m_layout.itemStackCount - m_itemLo), sizeof(uint32_t));
+            memcpy(&slot.durability, window + (m_layout.itemDurability - m_itemLo), sizeof(uint32_t));
+            memcpy(&slot.flags, window + (m_layout.itemFlags - m_itemLo), sizeof(uint32_t));
+            slot.bag = (uint8_t)bag;
+            slot.slot = (uint8_t)s;
+            slot.hash = SlotHash(slot.guid ^ ((uint64_t)slot.entry << 32 | slot.stackCount) ^
+                                 ((uint64_t)slot.durability << 40) ^ ((uint64_t)slot.flags << 8));
+        }
+    }
+
+    InventoryLayout m_layout;
+    uint32_t m_itemLo;                     // item field window: first offset
+    uint32_t m_itemBytes;                  // … and its size
+
+    GuidIndex m_index;                     // GUID → directory index
+    uint32_t m_indexGeneration;
+    bool m_indexed;
+
+    InventorySlot m_slots[kInventoryBags][kInventoryBagSlots];
+    uint32_t m_bagSize[kInventoryBags];
+    uint64_t m_bagGuids[kInventoryBags - 1];
+    uint32_t m_hash;
+
+    ItemInfoCache m_info;
+    InventoryStats m_stats;
+};
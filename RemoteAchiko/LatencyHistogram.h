@@ -0,0 +1,114 @@
+﻿// LatencyHistogram.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Fixed-size log-linear latency histogram (nanoseconds)
+//
+// Responsibilities:
+// • Record(ns) from any thread — one relaxed atomic increment
+// • Percentile(p) / Max() / Count() snapshots for periodic reports
+//
+// Architecture:
+// • 16 linear sub-buckets per power of two → ≤ 6.25% relative error
+// • 64 * 16 buckets cover the full uint64 range — no overflow bucket
+//
+// Critical Design Decisions:
+// • No allocation after construction, no locks — safe on the hot path
+// • Percentiles report the bucket's upper bound (never under-reports)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+class LatencyHistogram
+{
+public:
+    static const uint32_t kSubBits = 4;
+    static const uint32_t kSubCount = 1u << kSubBits;
+    static const uint32_t kBuckets = 64 * kSubCount;
+
+    LatencyHistogram() { Reset(); }
+
+    void Record(uint64_t ns)
+    {
+        m_counts[Index(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_total.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t prev = m_max.load(std::memory_order_relaxed);
+        while (ns > prev && !m_max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Percentile — upper bound of the bucket holding the p-th value
+    //
+    // Args:
+    //   p - 0..100
+    // ───────────────────────────────────────────────────────────────
+    uint64_t Percentile(double p) const
+    {
+        const uint64_t total = m_total.load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0;
+
+        uint64_t rank = (uint64_t)(p / 100.0 * (double)total + 0.5);
+        if (rank == 0)
+            rank = 1;
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < kBuckets; ++i)
+        {
+            seen += m_counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                const uint64_t upper = UpperBound(i);
+                const uint64_t max = Max();
+                return upper < max ? upper : max;
+            }
+        }
+        return Max();
+    }
+
+    uint64_t Count() const { return m_total.load(std::memory_order_relaxed); }
+    uint64_t Max() const { return m_max.load(std::memory_order_relaxed); }
+
+    void Reset()
+    {
+        for (uint32_t i = 0; i < kBuckets; ++i)
+            m_counts[i].store(0, std::memory_order_relaxed);
+        m_total.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static uint32_t Msb(uint64_t v)
+    {
+        uint32_t n = 0;
+        while (v >>= 1)
+            ++n;
+        return n;
+    }
+
+    static uint32_t Index(uint64_t v)
+    {
+        if (v < kSubCount)
+            return (uint32_t)v;
+        const uint32_t msb = Msb(v);
+        const uint32_t sub = (uint32_t)(v >> (msb - kSubBits)) & (kSubCount - 1);
+        return (msb - kSubBits + 1) * kSubCount + sub;
+    }
+
+    static uint64_t UpperBound(uint32_t index)
+    {
+        if (index < kSubCount)
+            return index;
+        const uint32_t msb = index / kSubCount + kSubBits - 1;
+        const uint64_t sub = index % kSubCount;
+        const uint64_t base = (1ULL << msb) | (sub << (msb - kSubBits));
+        return base + (1ULL << (msb - kSubBits)) - 1;
+    }
+
+    std::atomic<uint64_t> m_counts[kBuckets];
+    std::atomic<uint64_t> m_total;
+    std::atomic<uint64_t> m_max;
+};
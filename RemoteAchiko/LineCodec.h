@@ -0,0 +1,129 @@
+﻿// LineCodec.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Log line codec — "[HH:mm:ss.fff] " timestamp prefix encode/decode
+//
+// Responsibilities:
+// • Encodes a millisecond-of-day timestamp into the 15-byte prefix used by
+//   every log line on the Achikobuddy pipes ("[12:34:56.789] ")
+// • Decodes that prefix back without copying or allocating
+//
+// Architecture:
+// • Pure functions over caller buffers — no state, no locale, no printf
+// • Same format PipeClient.Log() and Bugger.WriteLog() produce in C#
+//
+// Critical Design Decisions:
+// • Fixed-width digits — the decoder validates shape with direct byte
+//   checks instead of sscanf, so malformed lines cost a few compares
+// • Decoder never reads past the given length
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const size_t kLinePrefixLength = 15;                 // "[HH:mm:ss.fff] "
+static const uint32_t kMsPerDay = 24u * 60u * 60u * 1000u;
+
+// ═══════════════════════════════════════════════════════════════
+// ENCODE
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// EncodeLinePrefix — write "[HH:mm:ss.fff] " into out
+//
+// Args:
+//   out     - destination, at least kLinePrefixLength bytes
+//   msOfDay - milliseconds since local midnight (wrapped to one day)
+//
+// Returns:
+//   kLinePrefixLength (bytes written, no terminator)
+// ───────────────────────────────────────────────────────────────
+inline size_t EncodeLinePrefix(char* out, uint32_t msOfDay)
+{
+    msOfDay %= kMsPerDay;
+
+    const uint32_t ms = msOfDay % 1000;
+    const uint32_t totalSec = msOfDay / 1000;
+    const uint32_t sec = totalSec % 60;
+    const uint32_t min = (totalSec / 60) % 60;
+    const uint32_t hour = totalSec / 3600;
+
+    out[0] = '[';
+    out[1] = (char)('0' + hour / 10);
+    out[2] = (char)('0' + hour % 10);
+    out[3] = ':';
+    out[4] = (char)('0' + min / 10);
+    out[5] = (char)('0' + min % 10);
+    out[6] = ':';
+    out[7] = (char)('0' + sec / 10);
+    out[8] = (char)('0' + sec % 10);
+    out[9] = '.';
+    out[10] = (char)('0' + ms / 100);
+    out[11] = (char)('0' + (ms / 10) % 10);
+    out[12] = (char)('0' + ms % 10);
+    out[13] = ']';
+    out[14] = ' ';
+    return kLinePrefixLength;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// DECODE
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// DecodeLinePrefix — parse a leading "[HH:mm:ss.fff]" in place
+//
+// Args:
+//   line    - start of the line (not necessarily null-terminated)
+//   length  - bytes available at line
+//   msOfDay - [out] decoded milliseconds since midnight
+//
+// Returns:
+//   true  - prefix present and valid (trailing space optional)
+//   false - line does not start with a timestamp
+// ───────────────────────────────────────────────────────────────
+inline bool DecodeLinePrefix(const char* line, size_t length, uint32_t& msOfDay)
+{
+    if (length < kLinePrefixLength - 1)
+        return false;
+
+    const unsigned char* p = (const unsigned char*)line;
+    if (p[0] != '[' || p[3] != ':' || p[6] != ':' || p[9] != '.' || p[13] != ']')
+        return false;
+
+    static const int kDigits[] = { 1, 2, 4, 5, 7, 8, 10, 11, 12 };
+    for (size_t i = 0; i < sizeof(kDigits) / sizeof(kDigits[0]); ++i)
+    {
+        if ((unsigned)(p[kDigits[i]] - '0') > 9u)
+            return false;
+    }
+
+    const uint32_t hour = (p[1] - '0') * 10u + (p[2] - '0');
+    const uint32_t min = (p[4] - '0') * 10u + (p[5] - '0');
+    const uint32_t sec = (p[7] - '0') * 10u + (p[8] - '0');
+    const uint32_t ms = (p[10] - '0') * 100u + (p[11] - '0') * 10u + (p[12] - '0');
+
+    if (hour > 23 || min > 59 || sec > 59)
+        return false;
+
+    msOfDay = ((hour * 60u + min) * 60u + sec) * 1000u + ms;
+    return true;
+}
+
+// ───────────────────────────────────────────────────────────────
+// LinePrefixSkip — bytes to skip to reach the message body
+//
+// Returns:
+//   kLinePrefixLength if a valid prefix + space is present,
+//   kLinePrefixLength - 1 if the prefix ends the line, else 0
+// ───────────────────────────────────────────────────────────────
+inline size_t LinePrefixSkip(const char* line, size_t length)
+{
+    uint32_t unused;
+    if (!DecodeLinePrefix(line, length, unused))
+        return 0;
+    return (length >= kLinePrefixLength && line[kLinePrefixLength - 1] == ' ')
+        ? kLinePrefixLength
+        : kLinePrefixLength - 1;
+}
@@ -0,0 +1,194 @@
+﻿// LogRing.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Bounded lock-free log ring — many producers, one consumer
+//
+// Responsibilities:
+// • Fixed-size log records (128-byte cells, text truncated to fit)
+// • Lock-free TryPush from any thread — never blocks, never allocates
+// • Single consumer drains in FIFO order via TryPop
+// • Counts dropped records when the ring is full
+//
+// Architecture:
+// • Per-cell sequence numbers (Vyukov bounded queue) — no CAS loop
+//   on the consumer side, one CAS per push on the producer side
+// • Enqueue/dequeue cursors live on separate cache lines
+// • Cells allocated once at construction, capacity is a power of two
+//
+// Critical Design Decisions:
+// • Drop-on-full instead of overwrite — a hung consumer must not make
+//   producers spin inside the game's threads
+// • Timestamp and thread id captured at push time, not at drain time
+// • Header-only so RemoteAchikoBench measures exactly what ships
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <string.h>
+#include "Platform.h"
+
+// ═══════════════════════════════════════════════════════════════
+// LogRecord — one fixed-size log entry
+// ═══════════════════════════════════════════════════════════════
+static const size_t kLogRecordText = 104;  // cell = 8 seq + 16 header + 104 text = 128 bytes
+
+enum LogSource : uint8_t
+{
+    LogSource_RemoteAchiko = 0,
+    LogSource_AchikoDLL = 1,
+    LogSource_Trace = 2,
+    LogSource_Watchdog = 3,
+};
+
+struct LogRecord
+{
+    uint64_t timestampNs;          // PlatformNowNs() at push
+    uint32_t threadId;             // PlatformThreadId() of the producer
+    uint16_t length;               // bytes used in text (no terminator)
+    uint8_t  source;               // LogSource tag
+    uint8_t  level;                // free for callers (0 = info)
+    char     text[kLogRecordText]; // NOT null-terminated — use length
+};
+
+// ═══════════════════════════════════════════════════════════════
+// LogRing — MPSC bounded ring of LogRecords
+// ═══════════════════════════════════════════════════════════════
+class LogRing
+{
+public:
+    // ───────────────────────────────────────────────────────────────
+    // Constructor
+    //
+    // Args:
+    //   capacity - number of cells, rounded up to a power of two (min 2)
+    // ───────────────────────────────────────────────────────────────
+    explicit LogRing(size_t capacity)
+        : m_cells(nullptr), m_mask(0), m_enqueuePos(0), m_dequeuePos(0), m_dropped(0)
+    {
+        size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+
+        m_mask = n - 1;
+        m_cells = static_cast<Cell*>(PlatformAlignedAlloc(sizeof(Cell) * n, kCacheLine));
+        if (!m_cells)
+            throw std::bad_alloc();
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            new (&m_cells[i]) Cell();
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LogRing()
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+            m_cells[i].~Cell();
+        PlatformAlignedFree(m_cells);
+    }
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // ───────────────────────────────────────────────────────────────
+    // TryPush — append a record stamped with the current time
+    //
+    // Returns:
+    //   true  - record queued
+    //   false - ring full, record dropped (Dropped() incremented)
+    // ───────────────────────────────────────────────────────────────
+    bool TryPush(uint8_t source, const char* text, size_t length)
+    {
+        return TryPushStamped(PlatformNowNs(), source, text, length);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // TryPushStamped — append a record with a caller-supplied timestamp
+    //
+    // Args:
+    //   timestampNs - usually PlatformNowNs() taken earlier by the caller
+    //   source      - LogSource tag
+    //   text/length - payload, truncated to kLogRecordText bytes
+    // ───────────────────────────────────────────────────────────────
+    bool TryPushStamped(uint64_t timestampNs, uint8_t source, const char* text, size_t length)
+    {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (length > kLogRecordText)
+            length = kLogRecordText;
+
+        LogRecord& r = cell->record;
+        r.timestampNs = timestampNs;
+        r.threadId = PlatformThreadId();
+        r.length = (uint16_t)length;
+        r.source = source;
+        r.level = 0;
+        memcpy(r.text, text, length);
+
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // TryPop — remove the oldest record (single consumer only!)
+    //
+    // Returns:
+    //   true  - out filled
+    //   false - ring empty
+    // ───────────────────────────────────────────────────────────────
+    bool TryPop(LogRecord& out)
+    {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &m_cells[pos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+
+        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+            return false;
+
+        out = cell->record;
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t Capacity() const { return m_mask + 1; }
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    Cell* m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos;   // producers
+    alignas(64) std::atomic<size_t> m_dequeuePos;   // consumer
+    alignas(64) std::atomic<uint64_t> m_dropped;    // diagnostics
+};
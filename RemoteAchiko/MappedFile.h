@@ -0,0 +1,145 @@
+﻿// MappedFile.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Read-only whole-file memory mapping (Win32 / POSIX)
+//
+// Responsibilities:
+// • Map a file in one view and hand out its bytes; unmap on Close /
+//   destruction
+//
+// Architecture:
+// • Header-only; used by file formats that are read in place — the world
+//   store base (WorldStore.h), grind profiles (GrindProfile.h)
+// • Files here are small (MBs), so one view of the whole file is fine in
+//   a 32-bit process; LogView.h windows its multi-GB logs instead
+//
+// Critical Design Decisions:
+// • Opened with FILE_SHARE_DELETE so a newer version can be written next
+//   to it and the old one deleted once unmapped
+// • An empty file opens successfully with no data — a zero-length
+//   mapping is an error on Windows
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Platform.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+typedef wchar_t MappedPathChar;
+#else
+typedef char MappedPathChar;
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// MappedFile
+// ═══════════════════════════════════════════════════════════════
+class MappedFile
+{
+public:
+    MappedFile() : m_data(nullptr), m_size(0)
+#ifdef _WIN32
+        , m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#endif
+    {
+    }
+
+    ~MappedFile() { Close(); }
+
+    // ───────────────────────────────────────────────────────────────
+    // Open — map the whole file read-only
+    //
+    // Returns:
+    //   false if it cannot be opened or mapped (nothing stays open)
+    // ───────────────────────────────────────────────────────────────
+    bool Open(const MappedPathChar* path)
+    {
+        Close();
+#ifdef _WIN32
+        m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (m_file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            Close();
+            return false;
+        }
+        m_size = (size_t)size.QuadPart;
+        if (m_size == 0)
+            return true;
+
+        m_mapping = CreateFileMappingW(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        m_data = m_mapping ? (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        m_size = (size_t)st.st_size;
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+
+        void* data = mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        m_data = data != MAP_FAILED ? (const uint8_t*)data : nullptr;
+#endif
+        if (!m_data)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+#ifdef _WIN32
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+        m_mapping = NULL;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data)
+            munmap((void*)m_data, m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    HANDLE m_file;
+    HANDLE m_mapping;
+#endif
+};
@@ -0,0 +1,269 @@
+﻿// MemoryBudget.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Address-space summary and per-subsystem memory budgets for the injected
+// side
+//
+// Responsibilities:
+// • Summarize one scan of the virtual address map: free bytes, largest
+//   free block, usable free blocks, fragmentation, reserved vs committed
+// • Attribute committed memory to owners — game, CLR heaps, bot arenas,
+//   caches, bot modules
+// • Derive an address-space pressure level from the free-space figures
+// • Turn budgets + pressure into trim requests for the owners that can
+//   shrink (arenas, caches, the CLR heap via a collection)
+//
+// Architecture:
+// • Pure and portable — MemoryMonitor feeds it regions from VirtualQuery
+//   (or /proc/self/maps in the bench) on its own thread
+// • Image regions arrive tagged by module (clr.dll → CLR, RemoteAchiko →
+//   bot); private memory cannot be told apart by address, so owners that
+//   live there report their usage and the rest is the game's
+// • Trim requests are one-shot mailboxes per owner — each owner drains its
+//   own on the thread that owns the memory (the bot arena at tick end,
+//   managed caches on the bot tick)
+//
+// Critical Design Decisions:
+// • In a 32-bit client the failure is "no contiguous block left", not "no
+//   bytes left" — the largest free block drives pressure, total free only
+//   backs it up
+// • Degrade, don't die: over budget → trim to budget; low address space →
+//   shed a quarter of every trimmable owner; critical → shed half
+// • The game's share is what remains after every reported owner — a
+//   missing report makes the game look bigger, never the bot smaller
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <mutex>
+
+static const uint64_t kMemoryMB = 1024ULL * 1024ULL;
+static const uint64_t kMemoryUsableFree = 64 * 1024;               // allocation granularity
+static const uint64_t kMemoryLowLargestFree = 64 * kMemoryMB;
+static const uint64_t kMemoryLowFree = 256 * kMemoryMB;
+static const uint64_t kMemoryCriticalLargestFree = 16 * kMemoryMB;
+static const uint64_t kMemoryCriticalFree = 64 * kMemoryMB;
+
+// ═══════════════════════════════════════════════════════════════
+// Public records
+// ═══════════════════════════════════════════════════════════════
+enum MemoryState : uint32_t
+{
+    MemState_Free = 0,
+    MemState_Reserved = 1,
+    MemState_Committed = 2,
+};
+
+enum MemoryOwner : uint32_t
+{
+    MemOwner_Game = 0,         // everything not claimed below
+    MemOwner_Clr = 1,          // CLR modules + managed heap (reported)
+    MemOwner_Arena = 2,        // TickArena chunks (reported)
+    MemOwner_Cache = 3,        // bot caches (reported)
+    MemOwner_Bot = 4,          // RemoteAchiko / bot modules
+    MemOwner_Count = 5,
+};
+
+enum MemoryPressure : uint32_t
+{
+    MemPressure_Normal = 0,
+    MemPressure_Low = 1,
+    MemPressure_Critical = 2,
+};
+
+// One VirtualQuery-style region
+struct MemoryRegion
+{
+    uint64_t base;
+    uint64_t size;
+    uint32_t state;            // MemoryState
+    uint32_t owner;            // MemoryOwner for image regions, else Game
+};
+
+// Layout shared with MemoryBudget.cs
+struct MemorySummary
+{
+    uint64_t freeBytes;
+    uint64_t largestFree;
+    uint64_t reservedBytes;
+    uint64_t committedBytes;
+    uint64_t committed[MemOwner_Count];     // by owner
+    uint64_t budget[MemOwner_Count];        // 0 = no budget
+    uint64_t trims[MemOwner_Count];         // trim requests issued
+    uint64_t scans;
+    uint64_t scanNs;                        // last scan
+    uint32_t regions;                       // last scan
+    uint32_t usableFreeBlocks;              // free blocks >= 64 KB
+    uint32_t fragmentationPermille;         // 1000 × (1 − largest / free)
+    uint32_t pressure;                      // MemoryPressure
+};
+
+// ═══════════════════════════════════════════════════════════════
+// MemoryBudget
+// ═══════════════════════════════════════════════════════════════
+class MemoryBudget
+{
+public:
+    MemoryBudget()
+    {
+        memset(m_budget, 0, sizeof(m_budget));
+        memset(m_reported, 0, sizeof(m_reported));
+        memset(m_trimTarget, 0, sizeof(m_trimTarget));
+        memset(m_trimPending, 0, sizeof(m_trimPending));
+        memset(&m_summary, 0, sizeof(m_summary));
+    }
+
+    void SetBudget(MemoryOwner owner, uint64_t bytes)
+    {
+        if (owner >= MemOwner_Count)
+            return;
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_budget[owner] = bytes;
+    }
+
+    // Usage of an owner the address map cannot see (private memory)
+    void ReportUsage(MemoryOwner owner, uint64_t bytes)
+    {
+        if (owner >= MemOwner_Count || owner == MemOwner_Game)
+            return;
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_reported[owner] = bytes;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Evaluate — summarize one scan and issue trim requests
+    //
+    // Args:
+    //   regions - the whole address map, any order
+    //   scanNs  - what the scan cost (reported only)
+    //
+    // Returns:
+    //   Pressure level after this scan
+    // ───────────────────────────────────────────────────────────────
+    MemoryPressure Evaluate(const MemoryRegion* regions, size_t count, uint64_t scanNs)
+    {
+        MemorySummary s;
+        memset(&s, 0, sizeof(s));
+
+        uint64_t image[MemOwner_Count] = {};
+        uint64_t untagged = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const MemoryRegion& r = regions[i];
+            if (r.state == MemState_Free)
+            {
+                s.freeBytes += r.size;
+                if (r.size > s.largestFree)
+                    s.largestFree = r.size;
+                if (r.size >= kMemoryUsableFree)
+                    ++s.usableFreeBlocks;
+            }
+            else if (r.state == MemState_Reserved)
+            {
+                s.reservedBytes += r.size;
+            }
+            else
+            {
+                s.committedBytes += r.size;
+                if (r.owner != MemOwner_Game && r.owner < MemOwner_Count)
+                    image[r.owner] += r.size;
+                else
+                    untagged += r.size;
+            }
+        }
+
+        s.regions = (uint32_t)count;
+        s.scanNs = scanNs;
+        s.fragmentationPermille = s.freeBytes
+            ? (uint32_t)(1000 - s.largestFree * 1000 / s.freeBytes)
+            : 0;
+        s.pressure = Pressure(s);
+
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        for (uint32_t o = MemOwner_Game + 1; o < MemOwner_Count; ++o)
+        {
+            const uint64_t claimed = m_reported[o] < untagged ? m_reported[o] : untagged;
+            untagged -= claimed;
+            s.committed[o] = image[o] + claimed;
+        }
+        s.committed[MemOwner_Game] = image[MemOwner_Game] + untagged;
+
+        for (uint32_t o = MemOwner_Clr; o <= MemOwner_Cache; ++o)
+            RequestTrim((MemoryOwner)o, (MemoryPressure)s.pressure);
+
+        memcpy(s.budget, m_budget, sizeof(s.budget));
+        memcpy(s.trims, m_summary.trims, sizeof(s.trims));
+        s.scans = m_summary.scans + 1;
+        m_summary = s;
+        return (MemoryPressure)s.pressure;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // TakeTrim — drain owner's trim request
+    //
+    // Returns:
+    //   true and the size to shrink to, if a request was pending
+    // ───────────────────────────────────────────────────────────────
+    bool TakeTrim(MemoryOwner owner, uint64_t& targetBytes)
+    {
+        if (owner >= MemOwner_Count)
+            return false;
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_trimPending[owner])
+            return false;
+        m_trimPending[owner] = false;
+        targetBytes = m_trimTarget[owner];
+        return true;
+    }
+
+    void Summary(MemorySummary& out) const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        out = m_summary;
+        memcpy(out.budget, m_budget, sizeof(out.budget));
+    }
+
+private:
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    static uint32_t Pressure(const MemorySummary& s)
+    {
+        if (s.largestFree < kMemoryCriticalLargestFree || s.freeBytes < kMemoryCriticalFree)
+            return MemPressure_Critical;
+        if (s.largestFree < kMemoryLowLargestFree || s.freeBytes < kMemoryLowFree)
+            return MemPressure_Low;
+        return MemPressure_Normal;
+    }
+
+    // Caller holds m_lock; only the reported (private) part can shrink
+    void RequestTrim(MemoryOwner owner, MemoryPressure pressure)
+    {
+        const uint64_t usage = m_reported[owner];
+        uint64_t target = usage;
+
+        if (m_budget[owner] && usage > m_budget[owner])
+            target = m_budget[owner];
+        if (pressure == MemPressure_Low && usage - usage / 4 < target)
+            target = usage - usage / 4;
+        if (pressure == MemPressure_Critical && usage / 2 < target)
+            target = usage / 2;
+
+        if (target >= usage)
+            return;
+
+        m_trimTarget[owner] = target;
+        m_trimPending[owner] = true;
+        ++m_summary.trims[owner];
+    }
+
+    mutable std::mutex m_lock;
+    uint64_t m_budget[MemOwner_Count];
+    uint64_t m_reported[MemOwner_Count];
+    uint64_t m_trimTarget[MemOwner_Count];
+    bool m_trimPending[MemOwner_Count];
+    MemorySummary m_summary;
+};
@@ -0,0 +1,203 @@
+﻿// MemoryMonitor.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Address-space scan and monitor thread (see MemoryMonitor.h)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "MemoryMonitor.h"
+#include "Platform.h"
+#include "Trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+MemoryMonitor& MemoryMonitor::Instance()
+{
+    static MemoryMonitor* s_instance = new MemoryMonitor();
+    return *s_instance;
+}
+
+MemoryMonitor::MemoryMonitor()
+    : m_intervalMs(kMemoryMonitorDefaultMs), m_started(false)
+{
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SCAN
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef _WIN32
+
+// ───────────────────────────────────────────────────────────────
+// ImageOwner — who a mapped module counts for
+//
+// Behavior:
+//   • CLR runtime, JIT and NGen images → CLR
+//   • RemoteAchiko.dll → bot
+//   • Everything else (wow.exe, system DLLs, addons' DLLs) → game
+// ───────────────────────────────────────────────────────────────
+static MemoryOwner ImageOwner(HMODULE module)
+{
+    char path[MAX_PATH];
+    const DWORD length = GetModuleFileNameA(module, path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH)
+        return MemOwner_Game;
+
+    const char* name = strrchr(path, '\\');
+    name = name ? name + 1 : path;
+
+    char lower[MAX_PATH];
+    size_t n = 0;
+    for (; name[n] && n + 1 < sizeof(lower); ++n)
+        lower[n] = (char)tolower((unsigned char)name[n]);
+    lower[n] = '\0';
+
+    if (strcmp(lower, "clr.dll") == 0 || strcmp(lower, "clrjit.dll") == 0 ||
+        strncmp(lower, "mscor", 5) == 0 || strstr(lower, ".ni.dll") != nullptr)
+        return MemOwner_Clr;
+    if (strcmp(lower, "remoteachiko.dll") == 0)
+        return MemOwner_Bot;
+    return MemOwner_Game;
+}
+
+bool MemoryMonitor::Scan(std::vector<MemoryRegion>& out)
+{
+    out.clear();
+
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    uintptr_t address = (uintptr_t)si.lpMinimumApplicationAddress;
+    const uintptr_t end = (uintptr_t)si.lpMaximumApplicationAddress;
+
+    // Image regions of one module are contiguous — cache the last lookup
+    void* lastAllocation = nullptr;
+    MemoryOwner lastOwner = MemOwner_Game;
+
+    MEMORY_BASIC_INFORMATION mbi;
+    while (address < end && VirtualQuery((LPCVOID)address, &mbi, sizeof(mbi)) == sizeof(mbi))
+    {
+        MemoryRegion r;
+        r.base = (uintptr_t)mbi.BaseAddress;
+        r.size = mbi.RegionSize;
+        r.state = mbi.State == MEM_FREE ? MemState_Free
+            : mbi.State == MEM_RESERVE ? MemState_Reserved
+            : MemState_Committed;
+        r.owner = MemOwner_Game;
+
+        if (mbi.State == MEM_COMMIT && mbi.Type == MEM_IMAGE)
+        {
+            if (mbi.AllocationBase != lastAllocation)
+            {
+                lastAllocation = mbi.AllocationBase;
+                lastOwner = ImageOwner((HMODULE)mbi.AllocationBase);
+            }
+            r.owner = lastOwner;
+        }
+
+        out.push_back(r);
+
+        const uintptr_t next = (uintptr_t)mbi.BaseAddress + mbi.RegionSize;
+        if (next <= address)
+            break;
+        address = next;
+    }
+
+    return !out.empty();
+}
+
+#else
+
+bool MemoryMonitor::Scan(std::vector<MemoryRegion>& out)
+{
+    out.clear();
+
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps)
+        return false;
+
+    // Gaps below the first mapping start at the 64 KB null guard, like
+    // Windows' lpMinimumApplicationAddress
+    uint64_t previousEnd = 0x10000;
+    char line[512];
+    while (fgets(line, sizeof(line), maps))
+    {
+        unsigned long long start = 0, end = 0;
+        char perms[8] = {};
+        if (sscanf(line, "%llx-%llx %7s", &start, &end, perms) != 3 || end <= start)
+            continue;
+
+        // The vsyscall page sits far above user space; not part of the map
+        if (strstr(line, "[vsyscall]"))
+            continue;
+
+        if (start > previousEnd)
+        {
+            MemoryRegion gap;
+            gap.base = previousEnd;
+            gap.size = start - previousEnd;
+            gap.state = MemState_Free;
+            gap.owner = MemOwner_Game;
+            out.push_back(gap);
+        }
+
+        MemoryRegion r;
+        r.base = start;
+        r.size = end - start;
+        r.state = strncmp(perms, "---", 3) == 0 ? MemState_Reserved : MemState_Committed;
+        r.owner = MemOwner_Game;
+        out.push_back(r);
+
+        if (end > previousEnd)
+            previousEnd = end;
+    }
+
+    fclose(maps);
+    return !out.empty();
+}
+
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// MONITOR
+// ═══════════════════════════════════════════════════════════════
+
+void MemoryMonitor::Start(uint32_t intervalMs)
+{
+    m_intervalMs.store(intervalMs < kMemoryMonitorMinMs ? kMemoryMonitorMinMs : intervalMs);
+
+    bool expected = false;
+    if (!m_started.compare_exchange_strong(expected, true))
+        return;
+
+    std::thread thread(&MemoryMonitor::MonitorLoop, this);
+    thread.detach();
+}
+
+MemoryPressure MemoryMonitor::ScanNow()
+{
+    std::lock_guard<std::mutex> guard(m_scanLock);
+
+    const uint64_t start = PlatformNowNs();
+    Scan(m_regions);
+    const uint64_t scanNs = PlatformNowNs() - start;
+
+    return m_budget.Evaluate(m_regions.data(), m_regions.size(), scanNs);
+}
+
+void MemoryMonitor::MonitorLoop()
+{
+    TraceRecorder::Instance().NameThread("RemoteAchiko memory monitor");
+
+    for (;;)
+    {
+        ScanNow();
+
+        // Sleep in short slices so an interval change applies promptly
+        uint32_t slept = 0;
+        while (slept < m_intervalMs.load())
+        {
+            PlatformSleepMs(kMemoryMonitorMinMs);
+            slept += kMemoryMonitorMinMs;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+﻿// MemoryMonitor.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Periodic address-space scan feeding MemoryBudget
+//
+// Responsibilities:
+// • Scan(): walk the process's virtual address map into MemoryRegion
+//   records, image regions tagged by owning module
+// • Monitor thread: scan + evaluate every interval (default 5 s)
+// • Own the process-wide MemoryBudget that owners report to and drain
+//   trim requests from
+//
+// Architecture:
+// • Windows: VirtualQuery from the minimum to the maximum application
+//   address; image owners from the module file name, cached per
+//   allocation base
+// • POSIX: /proc/self/maps, gaps between mappings counted as free — only
+//   the bench uses it
+// • Heap singleton, thread started by the first Start() and never stopped
+//   (same rule as Watchdog / Sampler)
+//
+// Critical Design Decisions:
+// • The scan runs off the game and bot threads — a fragmented 32-bit
+//   client has thousands of regions, a few milliseconds per scan
+// • The region buffer is reused between scans; it only grows
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MemoryBudget.h"
+
+static const uint32_t kMemoryMonitorDefaultMs = 5000;
+static const uint32_t kMemoryMonitorMinMs = 500;
+
+// ═══════════════════════════════════════════════════════════════
+// MemoryMonitor
+// ═══════════════════════════════════════════════════════════════
+class MemoryMonitor
+{
+public:
+    static MemoryMonitor& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // Scan — the current address map
+    //
+    // Returns:
+    //   false if the map could not be read (out is then empty)
+    // ───────────────────────────────────────────────────────────────
+    static bool Scan(std::vector<MemoryRegion>& out);
+
+    // Starts the monitor thread (once); later calls change the interval
+    void Start(uint32_t intervalMs);
+
+    // Scan + evaluate on the calling thread, now
+    MemoryPressure ScanNow();
+
+    MemoryBudget& Budget() { return m_budget; }
+
+private:
+    MemoryMonitor();
+    MemoryMonitor(const MemoryMonitor&) = delete;
+    MemoryMonitor& operator=(const MemoryMonitor&) = delete;
+
+    void MonitorLoop();
+
+    MemoryBudget m_budget;
+    std::mutex m_scanLock;                  // one scan at a time, guards m_regions
+    std::vector<MemoryRegion> m_regions;
+    std::atomic<uint32_t> m_intervalMs;
+    std::atomic<bool> m_started;
+};
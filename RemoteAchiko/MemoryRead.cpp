@@ -0,0 +1,212 @@
+﻿// MemoryRead.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Guarded memory read implementations (see MemoryRead.h)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "MemoryRead.h"
+#include "Platform.h"
+
+#include <string.h>
+
+
+// ───────────────────────────────────────────────────────────────
+// SafeCopy — single SEH frame around memcpy
+// ───────────────────────────────────────────────────────────────
+bool SafeCopy(void* dst, const void* src, size_t size)
+{
+    if (!src)
+        return false;
+
+#ifdef _WIN32
+    __try
+    {
+        memcpy(dst, src, size);
+        return true;
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER
+        : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+#else
+    memcpy(dst, src, size);
+    return true;
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// ReadPointerChain — one guarded frame for the whole walk
+//
+// Behavior:
+//   • The whole chain runs inside one __try — entering SEH is free on
+//     x64 and a few instructions on x86, but per-hop frames add up
+//   • Null at any hop ends the walk with false (typical "not in world")
+// ───────────────────────────────────────────────────────────────
+bool ReadPointerChain(uintptr_t base, const uint32_t* offsets, size_t count, uintptr_t& out)
+{
+    if (!base)
+        return false;
+
+#ifdef _WIN32
+    __try
+    {
+#endif
+        uintptr_t p = *(const uintptr_t*)base;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!p)
+                return false;
+            p = *(const uintptr_t*)(p + offsets[i]);
+        }
+
+        out = p;
+        return p != 0;
+#ifdef _WIN32
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER
+        : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// ReadCString — scan and copy in one guarded pass
+//
+// Behavior:
+//   • Copies byte-by-byte until terminator or outSize - 1
+//   • On fault the partial copy is discarded (out = "")
+// ───────────────────────────────────────────────────────────────
+size_t ReadCString(uintptr_t address, char* out, size_t outSize)
+{
+    if (outSize == 0)
+        return 0;
+
+    out[0] = '\0';
+    if (!address)
+        return 0;
+
+#ifdef _WIN32
+    __try
+    {
+#endif
+        const char* src = (const char*)address;
+        const size_t max = outSize - 1;
+        size_t n = 0;
+
+        while (n < max && src[n] != '\0')
+        {
+            out[n] = src[n];
+            ++n;
+        }
+
+        out[n] = '\0';
+        return n;
+#ifdef _WIN32
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER
+        : EXCEPTION_CONTINUE_SEARCH)
+    {
+        out[0] = '\0';
+        return 0;
+    }
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// WalkObjectList — one guarded frame for the whole list
+//
+// Behavior:
+//   • count is updated per node, so a fault still reports how far the
+//     walk got (the caller discards the partial list)
+// ───────────────────────────────────────────────────────────────
+bool WalkObjectList(uintptr_t first, uint32_t nextOffset, uint32_t guidOffset,
+    uintptr_t* addresses, uint64_t* guids, size_t maxCount, size_t& count)
+{
+    count = 0;
+
+#ifdef _WIN32
+    __try
+    {
+#endif
+        uintptr_t node = first;
+        while (node && count < maxCount)
+        {
+            addresses[count] = node;
+            guids[count] = *(const uint64_t*)(node + guidOffset);
+            ++count;
+            node = *(const uintptr_t*)(node + nextOffset);
+        }
+        return true;
+#ifdef _WIN32
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER
+        : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// ValidateObjectList — prefetch one batch ahead, compare per batch
+//
+// Behavior:
+//   • 8 nodes per batch: the next batch's GUID and next-pointer lines
+//     are requested before this batch is loaded
+//   • Differences are OR-ed together and tested once per batch — no
+//     data-dependent branch per node
+//   • A node that was freed and reused shows up as a GUID mismatch;
+//     an insert, removal or reorder as a next-pointer mismatch
+// ───────────────────────────────────────────────────────────────
+bool ValidateObjectList(const uintptr_t* addresses, const uint64_t* guids, size_t count,
+    uint32_t nextOffset, uint32_t guidOffset, uintptr_t tailNext)
+{
+    const size_t kBatch = 8;
+
+#ifdef _WIN32
+    __try
+    {
+#endif
+        for (size_t i = 0; i < count && i < kBatch; ++i)
+        {
+            PlatformPrefetch((const void*)(addresses[i] + guidOffset));
+            PlatformPrefetch((const void*)(addresses[i] + nextOffset));
+        }
+
+        for (size_t base = 0; base < count; base += kBatch)
+        {
+            const size_t end = base + kBatch < count ? base + kBatch : count;
+            const size_t ahead = end + kBatch < count ? end + kBatch : count;
+            for (size_t i = end; i < ahead; ++i)
+            {
+                PlatformPrefetch((const void*)(addresses[i] + guidOffset));
+                PlatformPrefetch((const void*)(addresses[i] + nextOffset));
+            }
+
+            uint64_t diff = 0;
+            for (size_t i = base; i < end; ++i)
+            {
+                const uintptr_t expectNext = i + 1 < count ? addresses[i + 1] : tailNext;
+                diff |= *(const uint64_t*)(addresses[i] + guidOffset) ^ guids[i];
+                diff |= (uint64_t)(*(const uintptr_t*)(addresses[i] + nextOffset) ^ expectNext);
+            }
+            if (diff)
+                return false;
+        }
+        return true;
+#ifdef _WIN32
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER
+        : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+#endif
+}
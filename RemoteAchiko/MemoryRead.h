@@ -0,0 +1,118 @@
+﻿// MemoryRead.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Guarded in-process memory reads — pointer chains, blocks and C strings
+//
+// Responsibilities:
+// • SafeCopy: memcpy that turns an access violation into "false"
+// • ReadPointerChain: follow [[[base+o0]+o1]+o2]... with a null check per hop
+// • ReadCString: bounded copy of a null-terminated string
+// • WalkObjectList / ValidateObjectList: collect or re-check an object
+//   linked list (address + GUID per node) inside one guarded frame
+//
+// Architecture:
+// • We live inside WoW — addresses come from the game and can go stale
+//   between ticks, so every dereference must be survivable
+// • Windows: structured exception handling around each raw access
+// • POSIX: plain access — the Linux build only ever reads the benchmark's
+//   own synthetic memory, never foreign pointers
+//
+// Critical Design Decisions:
+// • Functions with __try live in MemoryRead.cpp and hold no C++ objects
+//   (MSVC forbids unwinding + SEH in the same frame)
+// • Pointer-sized reads: 4 bytes in the 32-bit client, 8 in the x64 bench
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ───────────────────────────────────────────────────────────────
+// SafeCopy — guarded memcpy
+//
+// Args:
+//   dst  - local destination buffer
+//   src  - foreign (game) address to read from
+//   size - bytes to copy
+//
+// Returns:
+//   true  - all bytes copied
+//   false - src faulted (dst contents undefined)
+// ───────────────────────────────────────────────────────────────
+bool SafeCopy(void* dst, const void* src, size_t size);
+
+// ───────────────────────────────────────────────────────────────
+// ReadPointerChain — resolve a multi-level pointer
+//
+// Args:
+//   base    - starting address
+//   offsets - offsets applied before each dereference
+//   count   - number of offsets (0 = just dereference base)
+//   out     - [out] final dereferenced value
+//
+// Returns:
+//   true  - every hop was readable and non-null
+//   false - fault or null pointer at some hop
+//
+// Example:
+//   offsets {0x10, 0x4} → out = *(*(*(base) + 0x10) + 0x4)
+// ───────────────────────────────────────────────────────────────
+bool ReadPointerChain(uintptr_t base, const uint32_t* offsets, size_t count, uintptr_t& out);
+
+// ───────────────────────────────────────────────────────────────
+// ReadCString — bounded, guarded string read
+//
+// Args:
+//   address - foreign address of a null-terminated string
+//   out     - local buffer (always null-terminated on return)
+//   outSize - size of out in bytes (must be >= 1)
+//
+// Returns:
+//   Length copied (excluding terminator); 0 on fault or empty string
+// ───────────────────────────────────────────────────────────────
+size_t ReadCString(uintptr_t address, char* out, size_t outSize);
+
+// ───────────────────────────────────────────────────────────────
+// WalkObjectList — follow next pointers from first, collecting nodes
+//
+// Args:
+//   first      - address of the first node (0 = empty list)
+//   nextOffset - node → next node pointer
+//   guidOffset - node → uint64 GUID
+//   addresses  - [out] node addresses in list order
+//   guids      - [out] GUID of each node
+//   maxCount   - capacity of both arrays; the walk stops there
+//   count      - [out] nodes collected (valid even on fault)
+//
+// Returns:
+//   true  - reached a null next pointer or maxCount
+//   false - a node faulted mid-walk
+//
+// Notes:
+//   • Every hop waits for the previous load — one cache miss per node
+// ───────────────────────────────────────────────────────────────
+bool WalkObjectList(uintptr_t first, uint32_t nextOffset, uint32_t guidOffset,
+    uintptr_t* addresses, uint64_t* guids, size_t maxCount, size_t& count);
+
+// ───────────────────────────────────────────────────────────────
+// ValidateObjectList — does memory still hold exactly this list?
+//
+// Args:
+//   addresses  - node addresses from an earlier WalkObjectList
+//   guids      - their GUIDs
+//   count      - number of nodes
+//   tailNext   - expected next pointer of the last node (0 unless the
+//                earlier walk stopped at maxCount)
+//
+// Returns:
+//   true  - every GUID matches and every next pointer links to the
+//           following address (same chain a fresh walk would find)
+//   false - any difference, or a fault
+//
+// Notes:
+//   • Addresses are known up front, so nodes are prefetched a batch
+//     ahead and checked branch-free per batch — misses overlap instead
+//     of queueing behind each other
+// ───────────────────────────────────────────────────────────────
+bool ValidateObjectList(const uintptr_t* addresses, const uint64_t* guids, size_t count,
+    uint32_t nextOffset, uint32_t guidOffset, uintptr_t tailNext);
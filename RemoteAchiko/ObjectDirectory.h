@@ -0,0 +1,222 @@
+﻿// ObjectDirectory.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Incremental object enumeration — keep last tick's (address, GUID) list
+// and only re-walk the client's object list when it actually changed
+//
+// Responsibilities:
+// • Refresh(): produce this tick's object list in list order
+// • Cheap path: re-check last tick's list in place (ValidateObjectList —
+//   prefetched, batched GUID + next-pointer compares)
+// • Full walk (WalkObjectList) when the manager's head pointer or count
+//   changed, when validation finds a difference, or after Invalidate()
+// • Stats: nodes walked per tick, full walks vs validated ticks, and the
+//   enumeration time the cheap path saved
+//
+// Architecture:
+// • Parallel address / GUID arrays, reserved to maxObjects up front — the
+//   tick never allocates
+// • All foreign reads go through MemoryRead's guarded functions; this
+//   class only holds state and timing
+// • Single caller (the tick that snapshots objects) — no lock
+//
+// Critical Design Decisions:
+// • Validation checks every next pointer, not just the GUIDs: a passing
+//   check proves memory still holds the exact chain a fresh walk from the
+//   same head would find, so results never differ from the full walk
+// • Head + count are read first and compared before touching any node —
+//   most spawns and despawns change one of them and skip validation
+// • Time saved = validated nodes × measured full-walk cost per node, minus
+//   everything spent validating (failed validations included) — it can go
+//   negative on a list that changes every tick, and then it should
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "MemoryRead.h"
+#include "Platform.h"
+
+static const size_t kObjectDirectoryMax = 16384;
+
+// Offsets into the client's object manager and object nodes
+struct ObjectListLayout
+{
+    uint32_t managerFirstObject;   // manager → first object pointer
+    uint32_t managerCount;         // manager → object count (uint32)
+    uint32_t objectNext;           // object → next object pointer
+    uint32_t objectGuid;           // object → uint64 GUID
+};
+
+struct ObjectDirectoryStats
+{
+    uint64_t ticks;
+    uint64_t fullWalks;            // ticks that chased the list
+    uint64_t validated;            // ticks answered from last tick's list
+    uint64_t mismatches;           // validations that fell back to a walk
+    uint64_t faults;               // ticks that ended with an empty list
+    uint64_t nodesWalked;          // pointer-chasing hops, all ticks
+    uint64_t nodesValidated;       // nodes confirmed in place, all ticks
+    uint64_t walkNs;               // time in full walks
+    uint64_t validateNs;           // time in validations, failed ones too
+    int64_t savedNs;               // estimate — see header notes
+    uint32_t lastCount;            // objects after the last tick
+    uint32_t lastWalked;           // hops the last tick chased (0 = validated)
+};
+
+// ═══════════════════════════════════════════════════════════════
+// ObjectDirectory
+// ═══════════════════════════════════════════════════════════════
+class ObjectDirectory
+{
+public:
+    explicit ObjectDirectory(const ObjectListLayout& layout, size_t maxObjects = kObjectDirectoryMax)
+        : m_layout(layout), m_max(maxObjects ? maxObjects : 1), m_count(0),
+          m_head(0), m_managerCount(0), m_tailNext(0), m_valid(false), m_generation(0)
+    {
+        m_addresses.resize(m_max);
+        m_guids.resize(m_max);
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Refresh — bring the directory up to date with the client
+    //
+    // Args:
+    //   manager - address of the object manager struct (0 = not in world)
+    //
+    // Returns:
+    //   Objects in the directory; 0 on fault or when not in world
+    // ───────────────────────────────────────────────────────────────
+    size_t Refresh(uintptr_t manager)
+    {
+        ++m_stats.ticks;
+        m_stats.lastWalked = 0;
+
+        uintptr_t head = 0;
+        uint32_t managerCount = 0;
+        if (!manager ||
+            !SafeCopy(&head, (const void*)(manager + m_layout.managerFirstObject), sizeof(head)) ||
+            !SafeCopy(&managerCount, (const void*)(manager + m_layout.managerCount), sizeof(managerCount)))
+        {
+            return Fail();
+        }
+
+        if (m_valid && head == m_head && managerCount == m_managerCount)
+        {
+            const uint64_t start = PlatformNowNs();
+            const bool same = ValidateObjectList(m_addresses.data(), m_guids.data(), m_count,
+                m_layout.objectNext, m_layout.objectGuid, m_tailNext);
+            m_stats.validateNs += PlatformNowNs() - start;
+
+            if (same)
+            {
+                ++m_stats.validated;
+                m_stats.nodesValidated += m_count;
+                m_stats.lastCount = (uint32_t)m_count;
+                return m_count;
+            }
+            ++m_stats.mismatches;
+        }
+
+        return Walk(head, managerCount);
+    }
+
+    // Forces a full walk on the next Refresh (zone change, reload)
+    void Invalidate() { m_valid = false; }
+
+    size_t Count() const { return m_count; }
+    uintptr_t Address(size_t i) const { return m_addresses[i]; }
+    uint64_t Guid(size_t i) const { return m_guids[i]; }
+    const uintptr_t* Addresses() const { return m_addresses.data(); }
+    const uint64_t* Guids() const { return m_guids.data(); }
+
+    // Bumped whenever the list was rebuilt or emptied — equal
+    // generations mean identical lists (for indexes built over it)
+    uint32_t Generation() const { return m_generation; }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPORTING
+    // ═══════════════════════════════════════════════════════════════
+
+    void Stats(ObjectDirectoryStats& out) const
+    {
+        out = m_stats;
+        out.savedNs = 0;
+        if (m_stats.nodesWalked)
+        {
+            const double perNode = (double)m_stats.walkNs / (double)m_stats.nodesWalked;
+            out.savedNs = (int64_t)(perNode * (double)m_stats.nodesValidated) - (int64_t)m_stats.validateNs;
+        }
+    }
+
+    void ResetStats()
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+private:
+    ObjectDirectory(const ObjectDirectory&) = delete;
+    ObjectDirectory& operator=(const ObjectDirectory&) = delete;
+
+    size_t Walk(uintptr_t head, uint32_t managerCount)
+    {
+        size_t walked = 0;
+        const uint64_t start = PlatformNowNs();
+        const bool ok = WalkObjectList(head, m_layout.objectNext, m_layout.objectGuid,
+            m_addresses.data(), m_guids.data(), m_max, walked);
+        m_stats.walkNs += PlatformNowNs() - start;
+        m_stats.nodesWalked += walked;
+        m_stats.lastWalked = (uint32_t)walked;
+
+        if (!ok)
+            return Fail();
+
+        // A list cut off at m_max keeps its last next pointer so the
+        // truncated prefix can still validate
+        uintptr_t tailNext = 0;
+        if (walked == m_max &&
+            !SafeCopy(&tailNext, (const void*)(m_addresses[walked - 1] + m_layout.objectNext), sizeof(tailNext)))
+        {
+            return Fail();
+        }
+
+        ++m_stats.fullWalks;
+        ++m_generation;
+        m_count = walked;
+        m_head = head;
+        m_managerCount = managerCount;
+        m_tailNext = tailNext;
+        m_valid = true;
+        m_stats.lastCount = (uint32_t)m_count;
+        return m_count;
+    }
+
+    size_t Fail()
+    {
+        ++m_stats.faults;
+        if (m_count)
+            ++m_generation;
+        m_count = 0;
+        m_valid = false;
+        m_stats.lastCount = 0;
+        return 0;
+    }
+
+    ObjectListLayout m_layout;
+    size_t m_max;
+    std::vector<uintptr_t> m_addresses;
+    std::vector<uint64_t> m_guids;
+    size_t m_count;
+
+    // What last tick's list was built from
+    uintptr_t m_head;
+    uint32_t m_managerCount;
+    uintptr_t m_tailNext;
+    bool m_valid;
+    uint32_t m_generation;
+
+    ObjectDirectoryStats m_stats;
+};
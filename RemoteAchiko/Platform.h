@@ -0,0 +1,274 @@
+﻿// Platform.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Portable platform shims for RemoteAchiko's native cores
+//
+// Responsibilities:
+// • Monotonic nanosecond clock (QueryPerformanceCounter / CLOCK_MONOTONIC)
+// • Raw tick clock shared with managed Stopwatch timestamps
+// • Local time of day for log line prefixes
+// • Sleep, yield and spin-wait primitives
+// • Current thread/process id and logical CPU count
+// • Cache-line size constant for padding hot atomics
+//
+// Architecture:
+// • Header-only — every core includes this instead of <Windows.h> directly
+// • Windows branch is what ships inside WoW (RemoteAchiko.dll)
+// • POSIX branch exists so the cores compile on Linux for RemoteAchikoBench
+//   and AchikoLoad
+//
+// Critical Design Decisions:
+// • No allocation, no locks, no exceptions — safe from any thread
+// • QPC frequency cached once — the conversion stays on the fast path
+// • Nothing here may pull in CLR or game state
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <intrin.h>
+#else
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════
+
+static const size_t kCacheLine = 64;  // x86 L1 line — pad producer/consumer indices apart
+
+// ═══════════════════════════════════════════════════════════════
+// CLOCK
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// PlatformNowTicks — raw monotonic counter
+//
+// Returns:
+//   Windows: QueryPerformanceCounter ticks — the same value managed
+//            code gets from Stopwatch.GetTimestamp()
+//   POSIX:   nanoseconds (ticks and ns are the same unit)
+//
+// Notes:
+//   • Lets AchikoDLL hand timestamps across the P/Invoke boundary
+//     without a second native call to convert them
+// ───────────────────────────────────────────────────────────────
+inline uint64_t PlatformNowTicks()
+{
+#ifdef _WIN32
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (uint64_t)now.QuadPart;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformTicksToNs — convert PlatformNowTicks() units to nanoseconds
+//
+// Notes:
+//   • Split multiply avoids 64-bit overflow for long uptimes
+//   • QPC frequency cached once — the conversion stays on the fast path
+// ───────────────────────────────────────────────────────────────
+inline uint64_t PlatformTicksToNs(uint64_t ticks)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER s_freq = { 0 };
+    if (s_freq.QuadPart == 0)
+        QueryPerformanceFrequency(&s_freq);
+
+    const uint64_t freq = (uint64_t)s_freq.QuadPart;
+    return (ticks / freq) * 1000000000ULL + ((ticks % freq) * 1000000000ULL) / freq;
+#else
+    return ticks;
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformNowNs — monotonic timestamp in nanoseconds
+//
+// Returns:
+//   Nanoseconds since an arbitrary, process-wide fixed origin
+//
+// Notes:
+//   • Never goes backwards, unaffected by wall-clock changes
+//   • Windows: ~20-30 ns per call (QPC reads the invariant TSC)
+// ───────────────────────────────────────────────────────────────
+inline uint64_t PlatformNowNs()
+{
+    return PlatformTicksToNs(PlatformNowTicks());
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformLocalMsOfDay — local wall-clock time as ms since midnight
+//
+// Notes:
+//   • For "[HH:mm:ss.fff]" log prefixes only — never for intervals
+// ───────────────────────────────────────────────────────────────
+inline uint32_t PlatformLocalMsOfDay()
+{
+#ifdef _WIN32
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    return ((st.wHour * 60u + st.wMinute) * 60u + st.wSecond) * 1000u + st.wMilliseconds;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    tm local;
+    localtime_r(&ts.tv_sec, &local);
+    return ((local.tm_hour * 60u + local.tm_min) * 60u + local.tm_sec) * 1000u
+        + (uint32_t)(ts.tv_nsec / 1000000);
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SCHEDULING
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// PlatformSleepMs — coarse sleep (OS timer granularity applies)
+// ───────────────────────────────────────────────────────────────
+inline void PlatformSleepMs(uint32_t ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, nullptr);
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformYield — give up the rest of the time slice
+// ───────────────────────────────────────────────────────────────
+inline void PlatformYield()
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformCpuRelax — spin-wait hint (PAUSE on x86)
+// ───────────────────────────────────────────────────────────────
+inline void PlatformCpuRelax()
+{
+#if defined(_WIN32)
+    YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// THREAD / MACHINE INFO
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// PlatformThreadId — OS id of the calling thread
+// ───────────────────────────────────────────────────────────────
+inline uint32_t PlatformThreadId()
+{
+#ifdef _WIN32
+    return (uint32_t)GetCurrentThreadId();
+#else
+    // gettid is a real syscall — cache it, log producers call this per record
+    static thread_local uint32_t t_threadId = 0;
+    if (!t_threadId)
+        t_threadId = (uint32_t)syscall(SYS_gettid);
+    return t_threadId;
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformProcessId — OS id of this process
+// ───────────────────────────────────────────────────────────────
+inline uint32_t PlatformProcessId()
+{
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformCpuCount — number of logical processors
+// ───────────────────────────────────────────────────────────────
+inline uint32_t PlatformCpuCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (uint32_t)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1u;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MEMORY
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// PlatformAlignedAlloc / PlatformAlignedFree — over-aligned heap blocks
+//
+// Notes:
+//   • C++11 operator new ignores alignas > 16, so padded cells
+//     must come from here
+//   • alignment must be a power of two
+// ───────────────────────────────────────────────────────────────
+inline void* PlatformAlignedAlloc(size_t size, size_t alignment)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+#endif
+}
+
+inline void PlatformAlignedFree(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// PlatformPrefetch — pull the line holding p toward L1
+//
+// Notes:
+//   • A hint only: never faults, so stale game addresses are fine
+//   • Pays off when the addresses are known ahead of the loads —
+//     a linked-list walk cannot use it, a stored address list can
+// ───────────────────────────────────────────────────────────────
+inline void PlatformPrefetch(const void* p)
+{
+#if defined(_WIN32)
+    _mm_prefetch((const char*)p, _MM_HINT_T0);
+#else
+    __builtin_prefetch(p, 0, 3);
+#endif
+}
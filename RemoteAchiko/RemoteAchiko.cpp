@@ -23,6 +23,10 @@
 // • CLR host NOT released — releasing can deadlock on process exit
 // • Pipe handle lazily opened — survives Achikobuddy restarts
 // • DisableThreadLibraryCalls — reduces overhead, improves stability
+// • Concurrent GC off at startup — lets the managed scheduler steer full
+//   collections out of combat (full-GC approach notifications)
+// • Bootstrap progress goes to Achikobuddy's process watcher as named
+//   per-PID stage events (BootstrapStage.h), not just as log lines
 // ─────────────────────────────────────────────────────────────────────────────
 
 #include <Windows.h>
@@ -31,6 +35,11 @@
 #include <strsafe.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include "AllocProfiler.h"
+#include "BootstrapStage.h"
+#include "LineCodec.h"
+#include "Platform.h"
+#include "Trace.h"
 
 #pragma comment(lib, "mscoree.lib")  // CLR hosting functions
 #pragma comment(lib, "shlwapi.lib")  // String helper functions
@@ -46,6 +55,31 @@ static HMODULE          g_hModule = NULL;                  // Our own DLL handle
 static HANDLE           g_hPipe = INVALID_HANDLE_VALUE;    // Named pipe to Achikobuddy UI
 static ICLRRuntimeHost* g_clrHost = nullptr;               // .NET CLR host interface (NEVER release!)
 
+// ═══════════════════════════════════════════════════════════════
+// BOOTSTRAP TRACE SPANS
+// ═══════════════════════════════════════════════════════════════
+// Recorded unconditionally (TraceScope always = true) — bootstrap is
+// over long before the UI can enable tracing, and the spans sit in this
+// thread's buffer until the first export picks them up.
+// ───────────────────────────────────────────────────────────────
+
+static uint16_t g_traceBootstrap = 0;     // whole BootstrapThread
+static uint16_t g_traceClrCreate = 0;     // CLRCreateInstance
+static uint16_t g_traceGetRuntime = 0;    // GetRuntime(v4.0.30319)
+static uint16_t g_traceClrStart = 0;      // GetInterface + Start
+static uint16_t g_traceLoadManaged = 0;   // ExecuteInDefaultAppDomain → Loader.Start
+
+static void RegisterBootstrapSpans()
+{
+    TraceRecorder& trace = TraceRecorder::Instance();
+    trace.NameThread("RemoteAchiko bootstrap");
+    g_traceBootstrap = trace.RegisterName("bootstrap", TraceCategory_Bootstrap);
+    g_traceClrCreate = trace.RegisterName("bootstrap.clr_create", TraceCategory_Bootstrap);
+    g_traceGetRuntime = trace.RegisterName("bootstrap.get_runtime", TraceCategory_Bootstrap);
+    g_traceClrStart = trace.RegisterName("bootstrap.clr_start", TraceCategory_Bootstrap);
+    g_traceLoadManaged = trace.RegisterName("bootstrap.load_managed", TraceCategory_Bootstrap);
+}
+
 // ═══════════════════════════════════════════════════════════════
 // LOGGING SYSTEM
 // ═══════════════════════════════════════════════════════════════
@@ -64,6 +98,8 @@ static ICLRRuntimeHost* g_clrHost = nullptr;               // .NET CLR host inte
 // Behavior:
 //   • Attempts to open pipe on first call
 //   • If pipe unavailable, silently fails (Achikobuddy not running)
+//   • Prefixes "[HH:mm:ss.fff] " like PipeClient.Log — Bugger merges
+//     all sources by that timestamp
 //   • Appends \r\n to every message for clean display
 //   • Non-blocking — never waits or stalls the caller
 // ───────────────────────────────────────────────────────────────
@@ -87,17 +123,46 @@ static void LogToPipe(const char* format, ...)
             return;
     }
 
-    // Format the log message into a buffer
+    // Format "[HH:mm:ss.fff] message\r\n" into one buffer — one write
     char buffer[1024];
+    size_t length = EncodeLinePrefix(buffer, PlatformLocalMsOfDay());
     va_list args;
     va_start(args, format);
-    vsnprintf_s(buffer, sizeof(buffer), _TRUNCATE, format, args);
+    vsnprintf_s(buffer + length, sizeof(buffer) - length - 2, _TRUNCATE, format, args);
     va_end(args);
+    length += strlen(buffer + length);
+    buffer[length++] = '\r';
+    buffer[length++] = '\n';
 
-    // Send message + newline to pipe (best-effort, ignore errors)
+    // Send to pipe (best-effort, ignore errors)
     DWORD written;
-    WriteFile(g_hPipe, buffer, (DWORD)strlen(buffer), &written, NULL);
-    WriteFile(g_hPipe, "\r\n", 2, &written, NULL);
+    WriteFile(g_hPipe, buffer, (DWORD)length, &written, NULL);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// BOOTSTRAP PROGRESS
+// ═══════════════════════════════════════════════════════════════
+// Achikobuddy's process watcher creates one named event per stage
+// for every WoW it sees (BootstrapStage.h) and waits on them — the
+// Launcher learns "CLR up" / "managed ready" without parsing logs.
+// ───────────────────────────────────────────────────────────────
+
+// ───────────────────────────────────────────────────────────────
+// SignalBootstrapStage — set "AchikoBootstrap_PID_<pid>_<stage>"
+//
+// Notes:
+//   • No watcher (event missing) = nothing to do
+//   • Handle deliberately kept open: the event stays signalled for a
+//     restarted Achikobuddy, which re-opens it by name
+// ───────────────────────────────────────────────────────────────
+static void SignalBootstrapStage(BootstrapStage stage)
+{
+    wchar_t name[64];
+    swprintf_s(name, ACHIKO_BOOTSTRAP_EVENT_FORMAT, GetCurrentProcessId(), (unsigned)stage);
+
+    HANDLE event = OpenEventW(EVENT_MODIFY_STATE, FALSE, name);
+    if (event)
+        SetEvent(event);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -163,6 +228,7 @@ static bool BuildManagedPath(wchar_t* outPath, size_t outSize)
 //   0 - always (success or failure)
 //
 // Flow:
+//   0. Arm the allocation profiler if the launcher asked for it
 //   1. Create CLR MetaHost
 //   2. Get .NET 4.0 runtime info
 //   3. Start the CLR inside WoW's process
@@ -178,20 +244,37 @@ static bool BuildManagedPath(wchar_t* outPath, size_t outSize)
 // ───────────────────────────────────────────────────────────────
 static DWORD WINAPI BootstrapThread(LPVOID lpParam)
 {
+    RegisterBootstrapSpans();
+    TraceScope bootstrapSpan(g_traceBootstrap, true);
+
+    SignalBootstrapStage(Bootstrap_Injected);
+
     LogToPipe("=======================================");
     LogToPipe("RemoteAchiko: Bootstrap thread started");
     LogToPipe("Initializing .NET 4.0 CLR in WoW process...");
 
     HRESULT hr;
 
+    // ───────────────────────────────────────────────────────────
+    // STEP 0: Optional allocation profiler — the COR_* variables
+    // must be in place before the runtime starts (see AllocProfiler.h)
+    // ───────────────────────────────────────────────────────────
+    const bool allocProfiler = AllocProfilerRequested() && AllocProfilerArm(g_hModule);
+    if (allocProfiler)
+        LogToPipe("RemoteAchiko: Allocation profiler requested - arming COR_PROFILER");
+
     // ───────────────────────────────────────────────────────────
     // STEP 1: Get CLR meta host interface
     // ───────────────────────────────────────────────────────────
     ICLRMetaHost* metaHost = nullptr;
-    hr = CLRCreateInstance(CLSID_CLRMetaHost, IID_ICLRMetaHost, (LPVOID*)&metaHost);
+    {
+        TraceScope span(g_traceClrCreate, true);
+        hr = CLRCreateInstance(CLSID_CLRMetaHost, IID_ICLRMetaHost, (LPVOID*)&metaHost);
+    }
     if (FAILED(hr))
     {
         LogToPipe("RemoteAchiko: CLRCreateInstance failed: 0x%08X", hr);
+        SignalBootstrapStage(Bootstrap_Failed);
         return 0;
     }
 
@@ -199,30 +282,56 @@ static DWORD WINAPI BootstrapThread(LPVOID lpParam)
     // STEP 2: Get .NET Framework 4.0 runtime info
     // ───────────────────────────────────────────────────────────
     ICLRRuntimeInfo* runtimeInfo = nullptr;
-    hr = metaHost->GetRuntime(L"v4.0.30319", IID_ICLRRuntimeInfo, (LPVOID*)&runtimeInfo);
+    {
+        TraceScope span(g_traceGetRuntime, true);
+        hr = metaHost->GetRuntime(L"v4.0.30319", IID_ICLRRuntimeInfo, (LPVOID*)&runtimeInfo);
+    }
     metaHost->Release();  // Done with metaHost — safe to release
     if (FAILED(hr))
     {
         LogToPipe("RemoteAchiko: GetRuntime failed: 0x%08X", hr);
+        SignalBootstrapStage(Bootstrap_Failed);
         return 0;
     }
 
     // ───────────────────────────────────────────────────────────
     // STEP 3: Get CLR runtime host and start the CLR
     // ───────────────────────────────────────────────────────────
+    // Non-concurrent GC: full-GC approach notifications (GcScheduler.cs)
+    // are only raised without background GC. Must be set before Start().
+    DWORD startupFlags = 0;
+    if (SUCCEEDED(runtimeInfo->GetDefaultStartupFlags(&startupFlags, nullptr, nullptr)))
+    {
+        hr = runtimeInfo->SetDefaultStartupFlags(startupFlags & ~(DWORD)STARTUP_CONCURRENT_GC, nullptr);
+        if (FAILED(hr))
+            LogToPipe("RemoteAchiko: SetDefaultStartupFlags failed: 0x%08X (GC steering off)", hr);
+    }
+
     hr = runtimeInfo->GetInterface(CLSID_CLRRuntimeHost, IID_ICLRRuntimeHost, (LPVOID*)&g_clrHost);
     if (FAILED(hr))
     {
         LogToPipe("RemoteAchiko: GetInterface failed: 0x%08X", hr);
+        SignalBootstrapStage(Bootstrap_Failed);
         runtimeInfo->Release();
         return 0;
     }
 
     // Start the CLR — loads mscorlib.dll and initializes .NET inside WoW
-    hr = g_clrHost->Start();
+    {
+        TraceScope span(g_traceClrStart, true);
+        hr = g_clrHost->Start();
+    }
+    if (allocProfiler)
+    {
+        AllocProfilerDisarm();
+        LogToPipe(AllocProfilerActive()
+            ? "RemoteAchiko: Allocation profiler ACTIVE (sampling every %u KB)"
+            : "RemoteAchiko: Allocation profiler did not load (CLR already running?)", kAllocSampleBytes / 1024);
+    }
     if (FAILED(hr))
     {
         LogToPipe("RemoteAchiko: CLR Start() failed: 0x%08X", hr);
+        SignalBootstrapStage(Bootstrap_Failed);
         g_clrHost->Release();
         g_clrHost = nullptr;
         runtimeInfo->Release();
@@ -232,6 +341,7 @@ static DWORD WINAPI BootstrapThread(LPVOID lpParam)
     runtimeInfo->Release();  // Done with runtimeInfo — safe to release
 
     LogToPipe("RemoteAchiko: CLR started successfully - .NET 4.0 is now running inside WoW");
+    SignalBootstrapStage(Bootstrap_ClrUp);
 
     // ───────────────────────────────────────────────────────────
     // STEP 4: Build full path to AchikoDLL.dll
@@ -240,6 +350,7 @@ static DWORD WINAPI BootstrapThread(LPVOID lpParam)
     if (!BuildManagedPath(managedPath, MAX_PATH))
     {
         LogToPipe("RemoteAchiko: Failed to build path to AchikoDLL.dll");
+        SignalBootstrapStage(Bootstrap_Failed);
         return 0;
     }
 
@@ -256,25 +367,30 @@ static DWORD WINAPI BootstrapThread(LPVOID lpParam)
     //   - Return code (0 = success, 1 = failure)
     // ───────────────────────────────────────────────────────────
     DWORD returnCode = 0;
-    hr = g_clrHost->ExecuteInDefaultAppDomain(
-        managedPath,          // Full path to AchikoDLL.dll
-        L"AchikoDLL.Loader",  // Fully qualified type name
-        L"Start",             // Public static method to call
-        L"",                  // Arguments (empty string)
-        &returnCode           // Return value from Start()
-    );
+    {
+        TraceScope span(g_traceLoadManaged, true);
+        hr = g_clrHost->ExecuteInDefaultAppDomain(
+            managedPath,          // Full path to AchikoDLL.dll
+            L"AchikoDLL.Loader",  // Fully qualified type name
+            L"Start",             // Public static method to call
+            L"",                  // Arguments (empty string)
+            &returnCode           // Return value from Start()
+        );
+    }
 
     // ───────────────────────────────────────────────────────────
     // Check if managed code started successfully
     // ───────────────────────────────────────────────────────────
     if (SUCCEEDED(hr) && returnCode == 0)
     {
+        SignalBootstrapStage(Bootstrap_ManagedReady);
         LogToPipe("RemoteAchiko: Loader.Start() succeeded - bot is LIVE!");
         LogToPipe("RemoteAchiko: BotCore thread started - awaiting UI enable command");
         LogToPipe("=======================================");
     }
     else
     {
+        SignalBootstrapStage(Bootstrap_Failed);
         LogToPipe("RemoteAchiko: Loader.Start() FAILED - hr=0x%08X, ret=%d", hr, returnCode);
         LogToPipe("=======================================");
     }
@@ -367,6 +483,6 @@ BOOL WINAPI DllMain(HMODULE hModule, DWORD reason, LPVOID lpReserved)
 // END OF RemoteAchiko.cpp
 // ═══════════════════════════════════════════════════════════════
 // This file is complete and production-ready.
-// No exports, no additional functions needed.
+// Exports for AchikoDLL (tracing, ...) live in Exports.cpp.
 // The managed bot (AchikoDLL.dll) handles everything else.
 // ═══════════════════════════════════════════════════════════════
\ No newline at end of file
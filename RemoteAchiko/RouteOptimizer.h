@@ -0,0 +1,390 @@
+﻿// RouteOptimizer.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Offline hotspot route optimizer — shortest closed tour over a grind
+// profile's hotspots
+//
+// Responsibilities:
+// • RouteBuildMatrix: n x n travel costs, rows computed in parallel
+// • RouteSolve: multi-start nearest neighbour + 2-opt / Or-opt local
+//   search with double-bridge kicks, starts spread over worker threads
+// • GrindPlanRoute: read a profile, build its matrix, solve
+//
+// Architecture:
+// • Cost is a full matrix (from row, to column) — asymmetric allowed, so
+//   real path lengths (uphill slower than downhill, detours around
+//   water) work as well as the GrindTravelCost default
+// • 2-opt on an asymmetric matrix: reversing a segment changes the
+//   direction of every edge inside it, so moves are priced with forward
+//   and reverse prefix sums of the current tour
+// • Each start owns its tour and RNG; workers pull start indices from an
+//   atomic counter
+//
+// Critical Design Decisions:
+// • Deterministic: the best tour is min(cost, start index), whatever the
+//   thread count or finishing order
+// • Result is rotated to begin at hotspot 0 — the tour is closed, and
+//   authors put the entry hotspot first
+// • Never worse than the authoring order: it is scored too and kept if
+//   nothing beats it
+// • Runs on the caller's thread plus (threads - 1) helpers; meant for
+//   GRIND_OPTIMIZE or tooling, never from the bot tick
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "GrindProfile.h"
+#include "Platform.h"
+
+// Shared with GrindProfile.cs (GrindRouteReport)
+struct RouteReport
+{
+    float handCost;            // closed tour in authoring order
+    float routeCost;           // closed tour in optimized order
+    uint32_t hotspots;
+    uint32_t threads;
+    uint32_t starts;
+    uint32_t reserved;
+    uint64_t matrixNs;
+    uint64_t solveNs;
+};
+
+struct RouteOptions
+{
+    uint32_t threads;          // 0 = PlatformCpuCount()
+    uint32_t starts;           // independent searches (0 = 16)
+    uint32_t kicks;            // perturbations per start (0 = 64)
+
+    RouteOptions() : threads(0), starts(0), kicks(0) {}
+};
+
+// ═══════════════════════════════════════════════════════════════
+// RouteRunParallel — run body(index) for index in [0, count) on
+// threads workers (the caller is one of them)
+// ═══════════════════════════════════════════════════════════════
+template <typename Body>
+inline void RouteRunParallel(uint32_t count, uint32_t threads, Body body)
+{
+    std::atomic<uint32_t> next(0);
+    auto worker = [&]()
+    {
+        for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            body(i);
+    };
+
+    std::vector<std::thread> helpers;
+    for (uint32_t t = 1; t < threads && t < count; ++t)
+        helpers.push_back(std::thread(worker));
+    worker();
+    for (size_t t = 0; t < helpers.size(); ++t)
+        helpers[t].join();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RouteBuildMatrix — matrix[from * n + to] = cost(from, to)
+//
+// Notes:
+//   cost is called concurrently from several threads. Rows are the unit
+//   of work: a navmesh cost would run n path queries per row
+// ═══════════════════════════════════════════════════════════════
+template <typename CostFn>
+inline void RouteBuildMatrix(size_t n, CostFn cost, uint32_t threads, std::vector<float>& matrix)
+{
+    matrix.assign(n * n, 0.0f);
+    RouteRunParallel((uint32_t)n, threads ? threads : PlatformCpuCount(), [&](uint32_t from)
+    {
+        for (size_t to = 0; to < n; ++to)
+            matrix[from * n + to] = to == from ? 0.0f : cost(from, (uint32_t)to);
+    });
+}
+
+inline float RouteTourCost(const float* matrix, size_t n, const uint32_t* order)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        total += matrix[order[i] * n + order[(i + 1) % n]];
+    return (float)total;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RouteSearch — local search on one closed tour
+// ═══════════════════════════════════════════════════════════════
+class RouteSearch
+{
+public:
+    RouteSearch(const float* matrix, size_t n) : m_matrix(matrix), m_n(n) {}
+
+    void NearestNeighbour(uint32_t start, std::vector<uint32_t>& tour) const
+    {
+        std::vector<uint8_t> used(m_n, 0);
+        tour.clear();
+        tour.push_back(start);
+        used[start] = 1;
+        while (tour.size() < m_n)
+        {
+            const uint32_t from = tour.back();
+            uint32_t best = 0;
+            float bestCost = 0.0f;
+            bool found = false;
+            for (uint32_t to = 0; to < m_n; ++to)
+            {
+                if (used[to] || (found && C(from, to) >= bestCost))
+                    continue;
+                best = to;
+                bestCost = C(from, to);
+                found = true;
+            }
+            tour.push_back(best);
+            used[best] = 1;
+        }
+    }
+
+    // Alternates 2-opt and Or-opt passes until neither improves
+    void Improve(std::vector<uint32_t>& tour)
+    {
+        if (m_n < 5)
+            return;
+        while (TwoOpt(tour) || OrOpt(tour))
+        {
+        }
+    }
+
+    // Double bridge: A B C D -> A C B D (no local move undoes it)
+    static void Kick(std::vector<uint32_t>& tour, uint32_t& seed)
+    {
+        const size_t n = tour.size();
+        if (n < 8)
+            return;
+        size_t cut[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            cut[i] = 1 + (seed >> 8) % (n - 1);
+        }
+        std::sort(cut, cut + 3);
+        if (cut[0] == cut[1] || cut[1] == cut[2])
+            return;
+
+        std::vector<uint32_t> out(tour.begin(), tour.begin() + cut[0]);
+        out.insert(out.end(), tour.begin() + cut[1], tour.begin() + cut[2]);
+        out.insert(out.end(), tour.begin() + cut[0], tour.begin() + cut[1]);
+        out.insert(out.end(), tour.begin() + cut[2], tour.end());
+        tour.swap(out);
+    }
+
+private:
+    float C(uint32_t from, uint32_t to) const { return m_matrix[from * m_n + to]; }
+
+    // First improving segment reversal, priced for asymmetric costs
+    bool TwoOpt(std::vector<uint32_t>& tour)
+    {
+        const size_t n = m_n;
+        m_forward.assign(n, 0.0);
+        m_reverse.assign(n, 0.0);
+        for (size_t k = 1; k < n; ++k)
+        {
+            m_forward[k] = m_forward[k - 1] + C(tour[k - 1], tour[k]);
+            m_reverse[k] = m_reverse[k - 1] + C(tour[k], tour[k - 1]);
+        }
+
+        for (size_t i = 0; i + 2 < n; ++i)
+        {
+            const uint32_t a = tour[i], b = tour[i + 1];
+            for (size_t j = i + 2; j < n; ++j)
+            {
+                if (i == 0 && j == n - 1)
+                    continue;
+                const uint32_t d = tour[j], e = tour[(j + 1) % n];
+                const double before = C(a, b) + (m_forward[j] - m_forward[i + 1]) + C(d, e);
+                const double after = C(a, d) + (m_reverse[j] - m_reverse[i + 1]) + C(b, e);
+                if (after < before - 1e-3)
+                {
+                    std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // First improving move of a 1-3 hotspot segment elsewhere (kept in
+    // its direction)
+    bool OrOpt(std::vector<uint32_t>& tour)
+    {
+        const size_t n = m_n;
+        for (size_t length = 1; length <= 3 && length + 2 < n; ++length)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint32_t prev = tour[(i + n - 1) % n];
+                const uint32_t first = tour[i];
+                const uint32_t last = tour[(i + length - 1) % n];
+                const uint32_t next = tour[(i + length) % n];
+                const double removed = C(prev, first) + C(last, next) - C(prev, next);
+
+                for (size_t offset = length; offset + 1 < n; ++offset)
+                {
+                    const uint32_t x = tour[(i + offset) % n];
+                    const uint32_t y = tour[(i + offset + 1) % n];
+                    const double added = C(x, first) + C(last, y) - C(x, y);
+                    if (added < removed - 1e-3)
+                    {
+                        // Rebuild starting after the segment: rest..., then
+                        // the segment after x
+                        std::vector<uint32_t> out;
+                        out.reserve(n);
+                        for (size_t k = length; k <= offset; ++k)
+                            out.push_back(tour[(i + k) % n]);
+                        for (size_t k = 0; k < length; ++k)
+                            out.push_back(tour[(i + k) % n]);
+                        for (size_t k = offset + 1; k < n; ++k)
+                            out.push_back(tour[(i + k) % n]);
+                        tour.swap(out);
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    const float* m_matrix;
+    size_t m_n;
+    std::vector<double> m_forward;     // m_forward[k] = cost tour[0] -> tour[k]
+    std::vector<double> m_reverse;     // same, every edge walked backwards
+};
+
+// ═══════════════════════════════════════════════════════════════
+// RouteSolve — best closed tour over n hotspots
+//
+// Returns:
+//   order = visit order starting at hotspot 0; report filled except
+//   matrixNs
+// ═══════════════════════════════════════════════════════════════
+inline void RouteSolve(const float* matrix, size_t n, const RouteOptions& options,
+                       std::vector<uint32_t>& order, RouteReport& report)
+{
+    const uint64_t startNs = PlatformNowNs();
+    const uint32_t threads = options.threads ? options.threads : PlatformCpuCount();
+    const uint32_t starts = options.starts ? options.starts : 16;
+    const uint32_t kicks = options.kicks ? options.kicks : 64;
+
+    order.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+        order[i] = i;
+
+    report.hotspots = (uint32_t)n;
+    report.threads = threads;
+    report.starts = starts;
+    report.reserved = 0;
+    report.handCost = n ? RouteTourCost(matrix, n, order.data()) : 0.0f;
+    report.routeCost = report.handCost;
+
+    if (n >= 4)
+    {
+        std::vector<std::vector<uint32_t> > tours(starts);
+        std::vector<float> costs(starts, 0.0f);
+
+        RouteRunParallel(starts, threads, [&](uint32_t s)
+        {
+            RouteSearch search(matrix, n);
+            uint32_t seed = 0x9E3779B9u * (s + 1);
+            std::vector<uint32_t> best;
+            search.NearestNeighbour(s % n, best);
+            search.Improve(best);
+            float bestCost = RouteTourCost(matrix, n, best.data());
+
+            std::vector<uint32_t> trial;
+            for (uint32_t k = 0; k < kicks; ++k)
+            {
+                trial = best;
+                RouteSearch::Kick(trial, seed);
+                search.Improve(trial);
+                const float cost = RouteTourCost(matrix, n, trial.data());
+                if (cost < bestCost)
+                {
+                    best.swap(trial);
+                    bestCost = cost;
+                }
+            }
+            tours[s].swap(best);
+            costs[s] = bestCost;
+        });
+
+        uint32_t winner = 0;
+        for (uint32_t s = 1; s < starts; ++s)
+            if (costs[s] < costs[winner])
+                winner = s;
+
+        if (costs[winner] < report.handCost)
+        {
+            const std::vector<uint32_t>& tour = tours[winner];
+            const size_t zero = std::find(tour.begin(), tour.end(), 0u) - tour.begin();
+            for (size_t i = 0; i < n; ++i)
+                order[i] = tour[(zero + i) % n];
+            report.routeCost = RouteTourCost(matrix, n, order.data());
+        }
+    }
+    report.solveNs = PlatformNowNs() - startNs;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GrindPlanRoute — read a profile and optimize its route
+//
+// Args:
+//   costs     - n x n matrix in hotspot order (e.g. path lengths from
+//               the caller's navmesh), or null for GrindTravelCost
+//   costCount - elements in costs; must be n x n
+//   data      - out: the profile with the new route and costs, ready
+//               for GrindWriteProfile
+//
+// Returns:
+//   false if the profile cannot be read, or costs does not match its
+//   hotspot count
+//
+// Notes:
+//   Reads through its own mapping and writes nothing, so the solve
+//   never holds up readers of a loaded copy
+// ═══════════════════════════════════════════════════════════════
+inline bool GrindPlanRoute(const MappedPathChar* path, const float* costs, size_t costCount,
+                           const RouteOptions& options, GrindProfileData& data, RouteReport& report)
+{
+    memset(&report, 0, sizeof(report));
+    {
+        GrindProfile profile;
+        if (!profile.Open(path))
+            return false;
+        data.From(profile);
+    }
+
+    const size_t n = data.hotspots.size();
+    if (costs && costCount != n * n)
+        return false;
+
+    const uint64_t matrixStart = PlatformNowNs();
+    std::vector<float> matrix;
+    if (costs)
+    {
+        matrix.assign(costs, costs + n * n);
+    }
+    else
+    {
+        const GrindHotspot* hotspots = data.hotspots.data();
+        RouteBuildMatrix(n, [hotspots](uint32_t from, uint32_t to)
+        {
+            return GrindTravelCost(hotspots[from], hotspots[to]);
+        }, options.threads, matrix);
+    }
+    const uint64_t matrixNs = PlatformNowNs() - matrixStart;
+
+    RouteSolve(matrix.data(), n, options, data.route, report);
+    report.matrixNs = matrixNs;
+    data.handCost = report.handCost;
+    data.routeCost = report.routeCost;
+    return true;
+}
@@ -0,0 +1,437 @@
+﻿// Sampler.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Sampler implementation — suspend/walk/resume loop, export symbolization
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Sampler.h"
+
+#include <Windows.h>
+#include <Psapi.h>
+#include <string.h>
+#include "MemoryRead.h"
+#include "Platform.h"
+#include "Trace.h"
+
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "winmm.lib")
+
+static const uintptr_t kExportMaxSpan = 16 * 1024;   // beyond this, print module+RVA
+static const uintptr_t kMaxFrameSize = 1024 * 1024;  // one frame never spans 1 MB of stack
+
+// ───────────────────────────────────────────────────────────────
+// CopyName — bounded copy that always leaves dst terminated
+// ───────────────────────────────────────────────────────────────
+static void CopyName(char* dst, size_t capacity, const char* src)
+{
+    size_t n = strlen(src);
+    if (n > capacity - 1)
+        n = capacity - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ───────────────────────────────────────────────────────────────
+// Instance — leaked on purpose (see header)
+// ───────────────────────────────────────────────────────────────
+Sampler& Sampler::Instance()
+{
+    static Sampler* s_instance = new Sampler();
+    return *s_instance;
+}
+
+Sampler::Sampler()
+    : m_running(false), m_hz(kSamplerDefaultHz), m_budgetPermille(kSamplerDefaultBudgetPermille),
+      m_failed(0), m_passes(0), m_passNsTotal(0), m_startNs(0)
+{
+    memset(m_threads, 0, sizeof(m_threads));
+    memset(m_frameCounts, 0, sizeof(m_frameCounts));
+}
+
+// ═══════════════════════════════════════════════════════════════
+// THREAD REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+bool Sampler::RegisterCurrentThread(const char* name)
+{
+    const uint32_t threadId = GetCurrentThreadId();
+    const char* label = (name && *name) ? name : "thread";
+
+    std::lock_guard<std::mutex> guard(m_threadLock);
+
+    Slot* free = nullptr;
+    for (uint32_t i = 0; i < kSamplerMaxThreads; ++i)
+    {
+        if (m_threads[i].threadId == threadId)
+            return true;
+        if (!free && m_threads[i].threadId == 0)
+            free = &m_threads[i];
+    }
+    if (!free)
+        return false;
+
+    HANDLE handle = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION,
+        FALSE, threadId);
+    if (!handle)
+        return false;
+
+    free->handle = handle;
+    CopyName(free->name, sizeof(free->name), label);
+    free->threadId = threadId;
+
+    std::lock_guard<std::mutex> data(m_dataLock);
+    m_stacks.SetThreadName(threadId, free->name);
+    return true;
+}
+
+void Sampler::UnregisterCurrentThread()
+{
+    const uint32_t threadId = GetCurrentThreadId();
+
+    std::lock_guard<std::mutex> guard(m_threadLock);
+    for (uint32_t i = 0; i < kSamplerMaxThreads; ++i)
+    {
+        if (m_threads[i].threadId == threadId)
+        {
+            CloseHandle((HANDLE)m_threads[i].handle);
+            m_threads[i].handle = nullptr;
+            m_threads[i].threadId = 0;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CONTROL
+// ═══════════════════════════════════════════════════════════════
+
+bool Sampler::Start(uint32_t hz, uint32_t budgetPermille)
+{
+    std::lock_guard<std::mutex> guard(m_controlLock);
+
+    if (m_running.load(std::memory_order_relaxed))
+        return true;
+
+    m_hz = hz == 0 ? kSamplerDefaultHz : (hz > kSamplerMaxHz ? kSamplerMaxHz : hz);
+    m_budgetPermille = budgetPermille == 0 ? kSamplerDefaultBudgetPermille
+        : (budgetPermille > 1000 ? 1000 : budgetPermille);
+
+    {
+        std::lock_guard<std::mutex> data(m_dataLock);
+        m_stacks.Clear();
+        m_failed = 0;
+        m_passes = 0;
+        m_passNsTotal = 0;
+        m_startNs = PlatformNowNs();
+    }
+
+    m_running.store(true, std::memory_order_relaxed);
+    m_thread = std::thread(&Sampler::SamplerLoop, this);
+    return true;
+}
+
+void Sampler::Stop()
+{
+    std::lock_guard<std::mutex> guard(m_controlLock);
+
+    if (!m_running.load(std::memory_order_relaxed))
+        return;
+
+    m_running.store(false, std::memory_order_relaxed);
+    m_thread.join();
+}
+
+// ───────────────────────────────────────────────────────────────
+// SamplerLoop — one pass per interval over every registered thread
+//
+// Pass:
+//   1. Under m_threadLock: for each thread suspend → capture → resume
+//      (frames land in m_frames, nothing allocates)
+//   2. Under m_dataLock: aggregate the captured stacks
+//
+// Pacing:
+//   interval = max(1/hz, passCost * 1000 / budgetPermille)
+//   → sampler CPU stays under the budget even when walks get expensive
+// ───────────────────────────────────────────────────────────────
+void Sampler::SamplerLoop()
+{
+    TraceRecorder::Instance().NameThread("RemoteAchiko sampler");
+    timeBeginPeriod(1);   // 1 ms Sleep granularity while profiling
+
+    const uint64_t periodNs = 1000000000ULL / m_hz;
+    uint32_t threadIds[kSamplerMaxThreads];
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        const uint64_t passStart = PlatformNowNs();
+        uint32_t captured = 0;
+        uint32_t failed = 0;
+
+        {
+            std::lock_guard<std::mutex> guard(m_threadLock);
+            for (uint32_t i = 0; i < kSamplerMaxThreads; ++i)
+            {
+                if (m_threads[i].threadId == 0)
+                    continue;
+
+                const uint32_t frames = CaptureStack(m_threads[i].handle, m_frames[captured]);
+                if (frames == 0)
+                {
+                    ++failed;
+                    continue;
+                }
+                m_frameCounts[captured] = frames;
+                threadIds[captured] = m_threads[i].threadId;
+                ++captured;
+            }
+        }
+
+        uint64_t passNs;
+        {
+            std::lock_guard<std::mutex> data(m_dataLock);
+            for (uint32_t i = 0; i < captured; ++i)
+                m_stacks.Add(threadIds[i], m_frames[i], m_frameCounts[i]);
+
+            passNs = PlatformNowNs() - passStart;
+            m_failed += failed;
+            m_passes++;
+            m_passNsTotal += passNs;
+        }
+
+        uint64_t intervalNs = passNs * 1000 / m_budgetPermille;
+        if (intervalNs < periodNs)
+            intervalNs = periodNs;
+
+        const uint64_t sleepNs = intervalNs > passNs ? intervalNs - passNs : 0;
+        PlatformSleepMs(sleepNs < 1000000 ? 1 : (uint32_t)(sleepNs / 1000000));
+    }
+
+    timeEndPeriod(1);
+}
+
+// ───────────────────────────────────────────────────────────────
+// CaptureStack — suspend, read context, walk, resume
+//
+// Returns:
+//   Frames written (leaf first), 0 if the thread could not be sampled
+//
+// Notes:
+//   • GetThreadContext after SuspendThread waits for the suspension to
+//     actually take effect — the registers are stable from here on
+//   • The walk reads the target's stack through SafeCopy; a corrupt or
+//     FPO frame ends the walk early instead of faulting
+//   • Nothing between Suspend and Resume may allocate or lock
+// ───────────────────────────────────────────────────────────────
+uint32_t Sampler::CaptureStack(void* handle, uintptr_t* frames)
+{
+    if (SuspendThread((HANDLE)handle) == (DWORD)-1)
+        return 0;
+
+    CONTEXT context;
+    memset(&context, 0, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+
+    uint32_t count = 0;
+    if (GetThreadContext((HANDLE)handle, &context))
+    {
+#ifdef _WIN64
+        frames[count++] = (uintptr_t)context.Rip;
+#else
+        frames[count++] = (uintptr_t)context.Eip;
+
+        uintptr_t frame = (uintptr_t)context.Ebp;
+        const uintptr_t stackTop = (uintptr_t)context.Esp;
+
+        while (count < kProfileMaxFrames)
+        {
+            // [ebp] = caller's ebp, [ebp+4] = return address
+            uintptr_t link[2];
+            if (frame < stackTop || (frame & 3) != 0 || !SafeCopy(link, (const void*)frame, sizeof(link)))
+                break;
+            if (link[1] == 0)
+                break;
+
+            frames[count++] = link[1];
+
+            // Frames grow towards higher addresses; anything else is garbage
+            if (link[0] <= frame || link[0] - frame > kMaxFrameSize)
+                break;
+            frame = link[0];
+        }
+#endif
+    }
+
+    ResumeThread((HANDLE)handle);
+    return count;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SYMBOLS
+// ═══════════════════════════════════════════════════════════════
+
+void Sampler::AddManagedSymbol(uintptr_t start, const char* name)
+{
+    if (start == 0 || !name || !*name)
+        return;
+
+    std::lock_guard<std::mutex> data(m_dataLock);
+    m_managed.Add(start, 0, name);
+}
+
+// ───────────────────────────────────────────────────────────────
+// LoadModuleSymbols — module ranges + export directory of each module
+//
+// Behavior:
+//   • Every export becomes "module!name", sized up to the next export
+//     of the same module (or the module end)
+//   • Forwarded exports (RVA inside the export directory) are skipped
+//   • Called under m_dataLock, at write time only
+// ───────────────────────────────────────────────────────────────
+void Sampler::LoadModuleSymbols()
+{
+    m_modules.Clear();
+    m_exports.Clear();
+
+    HMODULE modules[512];
+    DWORD needed = 0;
+    if (!EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &needed))
+        return;
+
+    const DWORD moduleCount = needed / sizeof(HMODULE) < 512 ? needed / sizeof(HMODULE) : 512;
+    std::vector<std::pair<uintptr_t, std::string> > exports;
+
+    for (DWORD m = 0; m < moduleCount; ++m)
+    {
+        MODULEINFO info;
+        char moduleName[MAX_PATH];
+        if (!GetModuleInformation(GetCurrentProcess(), modules[m], &info, sizeof(info)) ||
+            !GetModuleBaseNameA(GetCurrentProcess(), modules[m], moduleName, sizeof(moduleName)))
+            continue;
+
+        const uintptr_t base = (uintptr_t)info.lpBaseOfDll;
+        const uintptr_t end = base + info.SizeOfImage;
+        m_modules.Add(base, info.SizeOfImage, moduleName);
+
+        IMAGE_DOS_HEADER dos;
+        IMAGE_NT_HEADERS nt;
+        if (!SafeCopy(&dos, (const void*)base, sizeof(dos)) || dos.e_magic != IMAGE_DOS_SIGNATURE ||
+            !SafeCopy(&nt, (const void*)(base + dos.e_lfanew), sizeof(nt)) || nt.Signature != IMAGE_NT_SIGNATURE)
+            continue;
+
+        const IMAGE_DATA_DIRECTORY& dir = nt.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
+        IMAGE_EXPORT_DIRECTORY ed;
+        if (dir.VirtualAddress == 0 || dir.Size == 0 ||
+            !SafeCopy(&ed, (const void*)(base + dir.VirtualAddress), sizeof(ed)))
+            continue;
+
+        const DWORD* functions = (const DWORD*)(base + ed.AddressOfFunctions);
+        const DWORD* names = (const DWORD*)(base + ed.AddressOfNames);
+        const WORD* ordinals = (const WORD*)(base + ed.AddressOfNameOrdinals);
+
+        exports.clear();
+        for (DWORD n = 0; n < ed.NumberOfNames; ++n)
+        {
+            DWORD nameRva = 0, functionRva = 0;
+            WORD ordinal = 0;
+            char exportName[128];
+            if (!SafeCopy(&nameRva, &names[n], sizeof(nameRva)) ||
+                !SafeCopy(&ordinal, &ordinals[n], sizeof(ordinal)) || ordinal >= ed.NumberOfFunctions ||
+                !SafeCopy(&functionRva, &functions[ordinal], sizeof(functionRva)) ||
+                !ReadCString(base + nameRva, exportName, sizeof(exportName)))
+                continue;
+
+            if (functionRva == 0 ||
+                (functionRva >= dir.VirtualAddress && functionRva < dir.VirtualAddress + dir.Size))
+                continue;
+
+            exports.push_back(std::make_pair(base + functionRva, std::string(moduleName) + "!" + exportName));
+        }
+
+        std::sort(exports.begin(), exports.end());
+        for (size_t i = 0; i < exports.size(); ++i)
+        {
+            const uintptr_t next = i + 1 < exports.size() ? exports[i + 1].first : end;
+            if (next > exports[i].first)
+                m_exports.Add(exports[i].first, next - exports[i].first, exports[i].second);
+        }
+    }
+
+    m_modules.Seal();
+    m_exports.Seal();
+}
+
+// ───────────────────────────────────────────────────────────────
+// Resolve — address → frame name
+//
+// Order:
+//   1. Inside a module, near an export → "module!export"
+//   2. Inside a module, no export near → "module+0xRVA"
+//   3. Managed method published by AchikoDLL → "AchikoDLL!Type.Method"
+//   4. Anything else → "0xADDRESS"
+// ───────────────────────────────────────────────────────────────
+std::string Sampler::Resolve(uintptr_t address)
+{
+    uintptr_t moduleBase = 0;
+    if (const std::string* module = m_modules.Find(address, 0, &moduleBase))
+    {
+        // Exports only cover public entry points — far past one we are in
+        // some internal function, where module+RVA is the honest answer
+        uintptr_t exportStart = 0;
+        const std::string* symbol = m_exports.Find(address, 0, &exportStart);
+        if (symbol && address - exportStart <= kExportMaxSpan)
+            return *symbol;
+
+        char rva[32];
+        snprintf(rva, sizeof(rva), "+0x%llX", (unsigned long long)(address - moduleBase));
+        return *module + rva;
+    }
+
+    if (const std::string* managed = m_managed.Find(address, kSamplerManagedMaxSpan))
+        return *managed;
+
+    return FormatAddress(address);
+}
+
+std::string Sampler::FormatAddress(uintptr_t address)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "0x%llX", (unsigned long long)address);
+    return buf;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// OUTPUT
+// ═══════════════════════════════════════════════════════════════
+
+int64_t Sampler::WriteCollapsed(FILE* out)
+{
+    std::lock_guard<std::mutex> data(m_dataLock);
+
+    // Modules come and go — take the list as it is right now
+    LoadModuleSymbols();
+    return m_stacks.WriteCollapsed(out, [this](uintptr_t address) { return Resolve(address); });
+}
+
+void Sampler::Symbolize(const uintptr_t* frames, uint32_t count, std::vector<std::string>& names)
+{
+    std::lock_guard<std::mutex> data(m_dataLock);
+
+    LoadModuleSymbols();
+    names.clear();
+    for (uint32_t i = 0; i < count; ++i)
+        names.push_back(Resolve(frames[i]));
+}
+
+SamplerStats Sampler::Stats()
+{
+    std::lock_guard<std::mutex> data(m_dataLock);
+
+    SamplerStats stats;
+    stats.samples = m_stacks.Samples();
+    stats.failed = m_failed;
+    stats.passes = m_passes;
+    stats.passNsTotal = m_passNsTotal;
+    stats.uniqueStacks = m_stacks.UniqueStacks();
+
+    const uint64_t elapsedNs = m_startNs ? PlatformNowNs() - m_startNs : 0;
+    stats.effectiveHz = elapsedNs ? (uint32_t)(m_passes * 1000000000ULL / elapsedNs) : 0;
+    return stats;
+}
@@ -0,0 +1,162 @@
+﻿// Sampler.h
+// ─────────────────────────────────────────────────────────────────────────────
+// In-process sampling profiler for registered bot threads
+//
+// Responsibilities:
+// • Keep a small registry of threads to sample (bot loop, pipe writer...)
+// • Sampler thread: suspend → capture context → walk stack → resume
+// • Aggregate samples (StackProfile.h) and write collapsed stacks
+// • Symbolize native frames from module export tables and managed frames
+//   from method entry points published by AchikoDLL
+//
+// Architecture:
+// • Windows only (SuspendThread / GetThreadContext) — Sampler.cpp is not
+//   part of the Linux bench build; the aggregation core is
+// • x86: frame-pointer (EBP) chain walk, each hop read with SafeCopy
+// • x64: leaf instruction pointer only (no frame-pointer convention)
+// • Symbols are resolved at WriteCollapsed time, once per unique address
+//
+// Critical Design Decisions:
+// • While a thread is suspended the sampler touches only preallocated
+//   memory — no heap, no locks the target could be holding
+// • Overhead budget: the sampling interval stretches so that time spent
+//   inside sampling passes stays under budgetPermille of one core
+// • Sampler is heap-allocated and never destroyed (same rule as the
+//   TraceRecorder — its thread may outlive static destruction)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "StackProfile.h"
+
+// ═══════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════
+
+static const uint32_t kSamplerMaxThreads = 16;
+static const uint32_t kSamplerDefaultHz = 250;
+static const uint32_t kSamplerMaxHz = 1000;
+static const uint32_t kSamplerDefaultBudgetPermille = 20;   // 2% of one core
+static const uintptr_t kSamplerManagedMaxSpan = 64 * 1024;  // JIT'd method size cap
+
+// ═══════════════════════════════════════════════════════════════
+// SamplerStats — snapshot for logging
+// ═══════════════════════════════════════════════════════════════
+struct SamplerStats
+{
+    uint64_t samples;          // stacks aggregated
+    uint64_t failed;           // suspend / context failures (thread exited...)
+    uint64_t passes;           // sampling passes over all threads
+    uint64_t passNsTotal;      // time spent inside passes
+    uint32_t effectiveHz;      // passes per second after budget stretching
+    size_t uniqueStacks;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Sampler
+// ═══════════════════════════════════════════════════════════════
+class Sampler
+{
+public:
+    static Sampler& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // Thread registry — call from the thread itself
+    // ───────────────────────────────────────────────────────────────
+    bool RegisterCurrentThread(const char* name);
+    void UnregisterCurrentThread();
+
+    // ───────────────────────────────────────────────────────────────
+    // Start — begin sampling (clears previous samples)
+    //
+    // Args:
+    //   hz             - target samples per second per thread (1..kSamplerMaxHz)
+    //   budgetPermille - max sampler CPU in 1/1000 of one core (1..1000)
+    // ───────────────────────────────────────────────────────────────
+    bool Start(uint32_t hz, uint32_t budgetPermille);
+    void Stop();
+    bool Running() const { return m_running.load(std::memory_order_relaxed); }
+
+    // ───────────────────────────────────────────────────────────────
+    // AddManagedSymbol — JIT'd method entry point → name
+    // ───────────────────────────────────────────────────────────────
+    void AddManagedSymbol(uintptr_t start, const char* name);
+
+    // ───────────────────────────────────────────────────────────────
+    // WriteCollapsed — "thread;root;...;leaf count" per unique stack
+    //
+    // Returns:
+    //   Lines written, -1 on write error
+    // ───────────────────────────────────────────────────────────────
+    int64_t WriteCollapsed(FILE* out);
+
+    SamplerStats Stats();
+
+    // ───────────────────────────────────────────────────────────────
+    // CaptureStack — suspend one thread, walk its stack, resume it
+    //
+    // Args:
+    //   handle - thread HANDLE with SUSPEND_RESUME | GET_CONTEXT
+    //   frames - [out] kProfileMaxFrames entries, leaf first
+    //
+    // Returns:
+    //   Frames written, 0 if the thread could not be captured
+    //
+    // Notes:
+    //   Shared with the watchdog's hang capture (Watchdog.cpp)
+    // ───────────────────────────────────────────────────────────────
+    static uint32_t CaptureStack(void* handle, uintptr_t* frames);
+
+    // ───────────────────────────────────────────────────────────────
+    // Symbolize — frame addresses → names (same rules as WriteCollapsed)
+    // ───────────────────────────────────────────────────────────────
+    void Symbolize(const uintptr_t* frames, uint32_t count, std::vector<std::string>& names);
+
+private:
+    struct Slot
+    {
+        uint32_t threadId;      // 0 = free
+        void* handle;           // HANDLE with SUSPEND_RESUME | GET_CONTEXT
+        char name[48];
+    };
+
+    Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    void SamplerLoop();
+    std::string Resolve(uintptr_t address);
+    void LoadModuleSymbols();
+    static std::string FormatAddress(uintptr_t address);
+
+    std::mutex m_threadLock;                // registry; held across a pass
+    Slot m_threads[kSamplerMaxThreads];
+
+    std::mutex m_controlLock;               // Start / Stop
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    uint32_t m_hz;
+    uint32_t m_budgetPermille;
+
+    std::mutex m_dataLock;                  // aggregator + stats + symbols
+    StackAggregator m_stacks;
+    SymbolTable m_managed;
+    SymbolTable m_exports;                  // rebuilt on each WriteCollapsed
+    SymbolTable m_modules;
+    uint64_t m_failed;
+    uint64_t m_passes;
+    uint64_t m_passNsTotal;
+    uint64_t m_startNs;
+
+    // Sampler-thread scratch, filled while targets are suspended
+    uintptr_t m_frames[kSamplerMaxThreads][kProfileMaxFrames];
+    uint32_t m_frameCounts[kSamplerMaxThreads];
+};
@@ -0,0 +1,252 @@
+﻿// SpatialGrid.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Uniform 2D grid index over world positions — radius and nearest queries
+//
+// Responsibilities:
+// • Bulk-build from a point set (units, nodes, spawns) in O(n)
+// • QueryRadius: visit every point within r of (x, y)
+// • Nearest: closest point, optionally filtered by a predicate
+//
+// Architecture:
+// • Compressed layout (CSR): one cellStart[] offset array + one
+//   contiguous points[] array sorted by cell — no per-cell allocations
+// • Queries touch only the cells overlapping the search disc
+// • Nearest expands ring by ring and stops once no farther ring can win
+//
+// Critical Design Decisions:
+// • Build-once, query-many: indexes are rebuilt per tick / per load,
+//   never mutated in place — keeps the layout dense
+// • Z is stored but ignored for cell assignment (maps are 2.5D)
+// • Cell size grows automatically if the bounding box would need more
+//   than kMaxCells cells (continent-sized sparse sets)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+struct SpatialPoint
+{
+    float x, y, z;
+    uint32_t id;   // caller-defined (object slot, record index, entry id...)
+};
+
+class SpatialGrid
+{
+public:
+    static const size_t kMaxCells = 1u << 20;
+
+    explicit SpatialGrid(float cellSize = 50.0f)
+        : m_requestedCellSize(cellSize), m_cellSize(cellSize),
+          m_minX(0), m_minY(0), m_cols(0), m_rows(0)
+    {
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Build — (re)index a point set
+    //
+    // Args:
+    //   points - source points (copied)
+    //   count  - number of points
+    // ───────────────────────────────────────────────────────────────
+    void Build(const SpatialPoint* points, size_t count)
+    {
+        m_points.clear();
+        m_cellStart.clear();
+        m_cols = m_rows = 0;
+        m_cellSize = m_requestedCellSize;
+
+        if (count == 0)
+            return;
+
+        float minX = points[0].x, maxX = points[0].x;
+        float minY = points[0].y, maxY = points[0].y;
+        for (size_t i = 1; i < count; ++i)
+        {
+            if (points[i].x < minX) minX = points[i].x;
+            if (points[i].x > maxX) maxX = points[i].x;
+            if (points[i].y < minY) minY = points[i].y;
+            if (points[i].y > maxY) maxY = points[i].y;
+        }
+
+        for (;;)
+        {
+            m_cols = (size_t)((maxX - minX) / m_cellSize) + 1;
+            m_rows = (size_t)((maxY - minY) / m_cellSize) + 1;
+            if (m_cols * m_rows <= kMaxCells)
+                break;
+            m_cellSize *= 2.0f;
+        }
+
+        m_minX = minX;
+        m_minY = minY;
+
+        // Counting sort by cell: count → prefix sum → scatter
+        m_cellStart.assign(m_cols * m_rows + 1, 0);
+        std::vector<uint32_t> cellOf(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            cellOf[i] = (uint32_t)CellIndex(points[i].x, points[i].y);
+            ++m_cellStart[cellOf[i] + 1];
+        }
+
+        for (size_t c = 1; c < m_cellStart.size(); ++c)
+            m_cellStart[c] += m_cellStart[c - 1];
+
+        std::vector<uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+        m_points.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            m_points[cursor[cellOf[i]]++] = points[i];
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // QueryRadius — visit all points within radius of (x, y)
+    //
+    // Args:
+    //   fn - callable(const SpatialPoint&, float distSq)
+    //
+    // Returns:
+    //   Number of points visited
+    // ───────────────────────────────────────────────────────────────
+    template <class Fn>
+    size_t QueryRadius(float x, float y, float radius, Fn fn) const
+    {
+        if (m_points.empty())
+            return 0;
+
+        const float r2 = radius * radius;
+        const long c0 = ClampCol((long)floorf((x - radius - m_minX) / m_cellSize));
+        const long c1 = ClampCol((long)floorf((x + radius - m_minX) / m_cellSize));
+        const long r0 = ClampRow((long)floorf((y - radius - m_minY) / m_cellSize));
+        const long r1 = ClampRow((long)floorf((y + radius - m_minY) / m_cellSize));
+
+        size_t hits = 0;
+        for (long r = r0; r <= r1; ++r)
+        {
+            for (long c = c0; c <= c1; ++c)
+            {
+                const size_t cell = (size_t)r * m_cols + (size_t)c;
+                for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+                {
+                    const SpatialPoint& p = m_points[i];
+                    const float dx = p.x - x, dy = p.y - y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (d2 <= r2)
+                    {
+                        fn(p, d2);
+                        ++hits;
+                    }
+                }
+            }
+        }
+        return hits;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Nearest — closest accepted point within maxRadius
+    //
+    // Args:
+    //   accept - callable(const SpatialPoint&) → bool (filter)
+    //
+    // Returns:
+    //   Pointer into the index (valid until next Build), or nullptr
+    // ───────────────────────────────────────────────────────────────
+    template <class Pred>
+    const SpatialPoint* Nearest(float x, float y, float maxRadius, Pred accept) const
+    {
+        if (m_points.empty())
+            return nullptr;
+
+        const long cx = (long)floorf((x - m_minX) / m_cellSize);
+        const long cy = (long)floorf((y - m_minY) / m_cellSize);
+        // No cells exist beyond the farthest grid edge from (cx, cy)
+        long maxRing = (long)(maxRadius / m_cellSize) + 1;
+        const long edge = Max4(labs(cx), labs((long)m_cols - 1 - cx), labs(cy), labs((long)m_rows - 1 - cy));
+        if (edge < maxRing)
+            maxRing = edge;
+
+        const SpatialPoint* best = nullptr;
+        float bestD2 = maxRadius * maxRadius;
+
+        for (long ring = 0; ring <= maxRing; ++ring)
+        {
+            // Every point in ring k is at least (k - 1) cells away
+            if (best && ring > 0)
+            {
+                const float minDist = (float)(ring - 1) * m_cellSize;
+                if (minDist * minDist > bestD2)
+                    break;
+            }
+            for (long r = cy - ring; r <= cy + ring; ++r)
+            {
+                if (r < 0 || r >= (long)m_rows)
+                    continue;
+
+                const bool edgeRow = (r == cy - ring || r == cy + ring);
+                const long step = edgeRow ? 1 : 2 * ring;
+
+                for (long c = cx - ring; c <= cx + ring; c += (step > 0 ? step : 1))
+                {
+                    if (c < 0 || c >= (long)m_cols)
+                        continue;
+
+                    const size_t cell = (size_t)r * m_cols + (size_t)c;
+                    for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+                    {
+                        const SpatialPoint& p = m_points[i];
+                        const float dx = p.x - x, dy = p.y - y;
+                        const float d2 = dx * dx + dy * dy;
+                        if (d2 <= bestD2 && accept(p))
+                        {
+                            best = &p;
+                            bestD2 = d2;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    const SpatialPoint* Nearest(float x, float y, float maxRadius) const
+    {
+        return Nearest(x, y, maxRadius, AcceptAll());
+    }
+
+    size_t Count() const { return m_points.size(); }
+    float CellSize() const { return m_cellSize; }
+
+private:
+    struct AcceptAll
+    {
+        bool operator()(const SpatialPoint&) const { return true; }
+    };
+
+    size_t CellIndex(float x, float y) const
+    {
+        const size_t c = (size_t)ClampCol((long)((x - m_minX) / m_cellSize));
+        const size_t r = (size_t)ClampRow((long)((y - m_minY) / m_cellSize));
+        return r * m_cols + c;
+    }
+
+    static long Max4(long a, long b, long c, long d)
+    {
+        const long ab = a > b ? a : b;
+        const long cd = c > d ? c : d;
+        return ab > cd ? ab : cd;
+    }
+
+    long ClampCol(long c) const { return c < 0 ? 0 : (c >= (long)m_cols ? (long)m_cols - 1 : c); }
+    long ClampRow(long r) const { return r < 0 ? 0 : (r >= (long)m_rows ? (long)m_rows - 1 : r); }
+
+    float m_requestedCellSize;
+    float m_cellSize;
+    float m_minX, m_minY;
+    size_t m_cols, m_rows;
+    std::vector<uint32_t> m_cellStart;   // cols * rows + 1 offsets into m_points
+    std::vector<SpatialPoint> m_points;  // sorted by cell
+};
@@ -0,0 +1,253 @@
+﻿// StackProfile.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Stack sample aggregation + address symbolization → collapsed stacks
+//
+// Responsibilities:
+// • StackAggregator: count identical (thread, frames...) samples
+// • SymbolTable: sorted address ranges → names, binary-search lookup
+// • WriteCollapsed: "thread;root;...;leaf count" lines — the folded format
+//   read by flamegraph.pl, speedscope and inferno
+//
+// Architecture:
+// • Header-only, no OS calls — the Windows sampler (Sampler.cpp) fills it,
+//   RemoteAchikoBench measures it on Linux
+// • Frames are stored leaf-first (as walked) and written root-first
+// • Symbolization happens once per unique address at write time, never
+//   per sample
+//
+// Critical Design Decisions:
+// • Add() allocates — the sampler only calls it AFTER resuming the target
+//   thread (a suspended thread may own the heap lock)
+// • Symbols without a known size extend to the next symbol, capped by
+//   maxSpan, so a stray address is not blamed on a far-away function
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const uint32_t kProfileMaxFrames = 64;
+
+// ═══════════════════════════════════════════════════════════════
+// SymbolTable — address → name
+// ═══════════════════════════════════════════════════════════════
+class SymbolTable
+{
+public:
+    SymbolTable() : m_sorted(true) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Add — register a symbol
+    //
+    // Args:
+    //   start - first byte of the function / range
+    //   size  - bytes covered, 0 = unknown (extends to the next symbol)
+    //   name  - display name, e.g. "clr.dll!CoreDllMain" or
+    //           "AchikoDLL!BotCore.BotLoop"
+    // ───────────────────────────────────────────────────────────────
+    void Add(uintptr_t start, uintptr_t size, const std::string& name)
+    {
+        Entry e;
+        e.start = start;
+        e.size = size;
+        e.name = name;
+        m_entries.push_back(e);
+        m_sorted = false;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Find — symbol containing address
+    //
+    // Args:
+    //   address - code address
+    //   maxSpan - cap for symbols with unknown size
+    //   start   - [out, optional] start of the matching symbol
+    //
+    // Returns:
+    //   Name, or nullptr if no symbol covers the address
+    // ───────────────────────────────────────────────────────────────
+    const std::string* Find(uintptr_t address, uintptr_t maxSpan, uintptr_t* start = nullptr) const
+    {
+        if (!m_sorted)
+            const_cast<SymbolTable*>(this)->Seal();
+
+        // First entry with start > address, then step back one
+        size_t lo = 0, hi = m_entries.size();
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (m_entries[mid].start <= address)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == 0)
+            return nullptr;
+
+        const Entry& e = m_entries[lo - 1];
+        uintptr_t end;
+        if (e.size != 0)
+            end = e.start + e.size;
+        else
+        {
+            end = lo < m_entries.size() ? m_entries[lo].start : e.start + maxSpan;
+            if (end - e.start > maxSpan)
+                end = e.start + maxSpan;
+        }
+        if (address >= end)
+            return nullptr;
+        if (start)
+            *start = e.start;
+        return &e.name;
+    }
+
+    void Seal()
+    {
+        std::sort(m_entries.begin(), m_entries.end(),
+            [](const Entry& a, const Entry& b) { return a.start < b.start; });
+        m_sorted = true;
+    }
+
+    size_t Size() const { return m_entries.size(); }
+    void Clear() { m_entries.clear(); m_sorted = true; }
+
+private:
+    struct Entry
+    {
+        uintptr_t start;
+        uintptr_t size;
+        std::string name;
+    };
+
+    std::vector<Entry> m_entries;
+    bool m_sorted;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// StackAggregator — sample counts per unique stack
+// ═══════════════════════════════════════════════════════════════
+class StackAggregator
+{
+public:
+    StackAggregator() : m_samples(0) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Add — count one sample
+    //
+    // Args:
+    //   thread - caller-defined thread tag (see SetThreadName)
+    //   frames - return addresses, LEAF FIRST (frames[0] = IP)
+    //   count  - number of frames (clamped to kProfileMaxFrames)
+    // ───────────────────────────────────────────────────────────────
+    void Add(uint32_t thread, const uintptr_t* frames, uint32_t count)
+    {
+        if (count > kProfileMaxFrames)
+            count = kProfileMaxFrames;
+
+        m_key.assign(1, (uintptr_t)thread);
+        m_key.insert(m_key.end(), frames, frames + count);
+
+        ++m_stacks[m_key];
+        ++m_samples;
+    }
+
+    void SetThreadName(uint32_t thread, const std::string& name) { m_threadNames[thread] = name; }
+
+    uint64_t Samples() const { return m_samples; }
+    size_t UniqueStacks() const { return m_stacks.size(); }
+
+    void Clear()
+    {
+        m_stacks.clear();
+        m_samples = 0;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // WriteCollapsed — folded stacks, one line per unique stack
+    //
+    // Args:
+    //   out     - destination
+    //   resolve - functor: std::string(uintptr_t address)
+    //
+    // Returns:
+    //   Lines written, -1 on write error
+    // ───────────────────────────────────────────────────────────────
+    template <class Resolver>
+    int64_t WriteCollapsed(FILE* out, Resolver resolve) const
+    {
+        std::unordered_map<uintptr_t, std::string> names;
+        std::string line;
+        int64_t lines = 0;
+
+        for (StackMap::const_iterator it = m_stacks.begin(); it != m_stacks.end(); ++it)
+        {
+            const std::vector<uintptr_t>& key = it->first;
+            const uint32_t thread = (uint32_t)key[0];
+
+            ThreadNames::const_iterator tn = m_threadNames.find(thread);
+            if (tn != m_threadNames.end())
+                line = SanitizeFrame(tn->second);
+            else
+            {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "thread-%u", thread);
+                line = buf;
+            }
+
+            // key[1] is the leaf — walk backwards for root-first order
+            for (size_t i = key.size() - 1; i >= 1; --i)
+            {
+                std::unordered_map<uintptr_t, std::string>::iterator n = names.find(key[i]);
+                if (n == names.end())
+                    n = names.insert(std::make_pair(key[i], SanitizeFrame(resolve(key[i])))).first;
+                line += ';';
+                line += n->second;
+            }
+
+            fprintf(out, "%s %llu\n", line.c_str(), (unsigned long long)it->second);
+            ++lines;
+        }
+        return ferror(out) ? -1 : lines;
+    }
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const std::vector<uintptr_t>& key) const
+        {
+            uint64_t h = 1469598103934665603ULL;           // FNV-1a over frame words
+            for (size_t i = 0; i < key.size(); ++i)
+            {
+                h ^= (uint64_t)key[i];
+                h *= 1099511628211ULL;
+            }
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+
+    // ';' separates frames and '\n' lines — the count follows the LAST
+    // space, so spaces inside names are fine
+    static std::string SanitizeFrame(std::string name)
+    {
+        for (size_t i = 0; i < name.size(); ++i)
+        {
+            if (name[i] == ';' || name[i] == '\n' || name[i] == '\r')
+                name[i] = '_';
+        }
+        return name.empty() ? std::string("[unknown]") : name;
+    }
+
+    typedef std::unordered_map<std::vector<uintptr_t>, uint64_t, KeyHash> StackMap;
+    typedef std::unordered_map<uint32_t, std::string> ThreadNames;
+
+    StackMap m_stacks;
+    ThreadNames m_threadNames;
+    std::vector<uintptr_t> m_key;   // reused by Add — no per-sample key allocation
+    uint64_t m_samples;
+};
@@ -0,0 +1,296 @@
+﻿// TickArena.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Bump-pointer arena for per-tick native data — snapshots, query results,
+// event batches, path scratch
+//
+// Responsibilities:
+// • Allocate(): aligned bump allocation, no per-object free
+// • Reset(): drop everything at tick end in O(1) and start a new generation
+// • Mark() / Rewind(): scoped scratch inside a tick (a path search frees
+//   its open list before the tick's results are built)
+// • High-water mark, chunk count and oversized-request count for sizing
+// • Debug poison: released bytes are overwritten with 0xDD so a stale
+//   pointer reads obvious garbage instead of last tick's plausible data
+// • Trim(): give chunks back to the heap under memory pressure
+//   (MemoryBudget trim requests)
+//
+// Architecture:
+// • A list of chunks that only grows — Reset() rewinds to chunk 0 and the
+//   same memory serves every tick, so the heap sees nothing after warm-up
+// • One arena per thread that produces tick data (the bot tick, each
+//   worker); no locks, an arena never crosses threads
+// • ArenaSpan describes a result array to managed code: pointer, count,
+//   stride and the generation it belongs to
+//
+// Critical Design Decisions:
+// • WoW is 32-bit with a fragmented address space — per-tick new/delete
+//   of snapshot-sized buffers is exactly the churn that ends long sessions
+// • Chunks are fixed-size (requests larger than a chunk get a dedicated
+//   one) so a single huge tick cannot force one huge contiguous block
+// • Reset() costs O(1) with poison off; with poison on it touches every
+//   byte used this tick — a debug setting, not a production one
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "Platform.h"
+
+static const size_t kTickArenaChunkSize = 256 * 1024;
+static const uint8_t kTickArenaPoison = 0xDD;
+
+// A result array in arena memory — layout shared with TickArena.cs
+struct ArenaSpan
+{
+    uint64_t address;              // first element (0 = empty)
+    uint32_t count;
+    uint32_t stride;               // bytes between elements
+    uint32_t generation;           // arena generation it was built in
+    uint32_t reserved;
+};
+
+// Layout shared with TickArena.cs
+struct TickArenaStats
+{
+    uint64_t usedBytes;            // this tick so far
+    uint64_t highWaterBytes;       // most used by any tick
+    uint64_t reservedBytes;        // all chunks
+    uint64_t allocations;          // since the last ResetStats
+    uint32_t generation;
+    uint32_t chunks;
+    uint32_t oversized;            // requests that needed a dedicated chunk
+    uint32_t poison;               // 1 = debug poison on
+};
+
+// ═══════════════════════════════════════════════════════════════
+// TickArena
+// ═══════════════════════════════════════════════════════════════
+class TickArena
+{
+public:
+    struct Marker
+    {
+        size_t chunk;
+        size_t offset;
+        size_t used;
+    };
+
+    explicit TickArena(size_t chunkSize = kTickArenaChunkSize, bool poison = false)
+        : m_chunkSize(chunkSize ? chunkSize : kTickArenaChunkSize), m_current(0), m_offset(0),
+          m_used(0), m_highWater(0), m_allocations(0), m_oversized(0), m_generation(0), m_poison(poison)
+    {
+    }
+
+    ~TickArena()
+    {
+        for (size_t i = 0; i < m_chunks.size(); ++i)
+            PlatformAlignedFree(m_chunks[i].data);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Allocate — size bytes aligned to align (power of two, <= 64)
+    //
+    // Returns:
+    //   Memory valid until Reset() / a Rewind() past it; nullptr only
+    //   if the heap refused a new chunk
+    // ───────────────────────────────────────────────────────────────
+    void* Allocate(size_t size, size_t align = 16)
+    {
+        if (align > kCacheLine)
+            align = kCacheLine;
+
+        for (;;)
+        {
+            if (m_current < m_chunks.size())
+            {
+                Chunk& chunk = m_chunks[m_current];
+                const size_t start = (m_offset + align - 1) & ~(align - 1);
+                if (start + size <= chunk.size)
+                {
+                    m_used += start - m_offset + size;
+                    m_offset = start + size;
+                    ++m_allocations;
+                    if (m_used > m_highWater)
+                        m_highWater = m_used;
+                    return chunk.data + start;
+                }
+
+                // The tail of this chunk is lost for the rest of the tick
+                m_used += chunk.size - m_offset;
+                ++m_current;
+                m_offset = 0;
+                continue;
+            }
+
+            if (!AddChunk(size))
+                return nullptr;
+        }
+    }
+
+    template <class T>
+    T* AllocateArray(size_t count, size_t align = sizeof(T) < 16 ? 16 : kCacheLine)
+    {
+        return (T*)Allocate(count * sizeof(T), align);
+    }
+
+    Marker Mark() const
+    {
+        Marker m;
+        m.chunk = m_current;
+        m.offset = m_offset;
+        m.used = m_used;
+        return m;
+    }
+
+    // Releases everything allocated since m (poisoned in debug mode)
+    void Rewind(const Marker& m)
+    {
+        if (m.chunk > m_current || (m.chunk == m_current && m.offset > m_offset))
+            return;
+
+        if (m_poison)
+            PoisonFrom(m);
+        m_current = m.chunk;
+        m_offset = m.offset;
+        m_used = m.used;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Reset — end of tick: everything goes, the generation advances
+    //
+    // Returns:
+    //   The new generation (spans from earlier ones are stale)
+    // ───────────────────────────────────────────────────────────────
+    uint32_t Reset()
+    {
+        Marker start;
+        start.chunk = 0;
+        start.offset = 0;
+        start.used = 0;
+        Rewind(start);
+        return ++m_generation;
+    }
+
+    // Describes count elements at p as a span of this generation
+    ArenaSpan Span(const void* p, size_t count, size_t stride) const
+    {
+        ArenaSpan span;
+        span.address = p && count ? (uint64_t)(uintptr_t)p : 0;
+        span.count = span.address ? (uint32_t)count : 0;
+        span.stride = (uint32_t)stride;
+        span.generation = m_generation;
+        span.reserved = 0;
+        return span;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Trim — free unused chunks from the end until at most targetBytes
+    // stay reserved
+    //
+    // Returns:
+    //   Bytes given back; chunks in use this tick are never freed, so
+    //   call it right after Reset() to release the most
+    // ───────────────────────────────────────────────────────────────
+    size_t Trim(size_t targetBytes)
+    {
+        size_t reserved = 0;
+        for (size_t i = 0; i < m_chunks.size(); ++i)
+            reserved += m_chunks[i].size;
+
+        size_t released = 0;
+        while (reserved > targetBytes && m_chunks.size() > m_current + 1)
+        {
+            Chunk& last = m_chunks.back();
+            reserved -= last.size;
+            released += last.size;
+            PlatformAlignedFree(last.data);
+            m_chunks.pop_back();
+        }
+        return released;
+    }
+
+    uint32_t Generation() const { return m_generation; }
+    void SetPoison(bool poison) { m_poison = poison; }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPORTING
+    // ═══════════════════════════════════════════════════════════════
+
+    void Stats(TickArenaStats& out) const
+    {
+        memset(&out, 0, sizeof(out));
+        out.usedBytes = m_used;
+        out.highWaterBytes = m_highWater;
+        for (size_t i = 0; i < m_chunks.size(); ++i)
+            out.reservedBytes += m_chunks[i].size;
+        out.allocations = m_allocations;
+        out.generation = m_generation;
+        out.chunks = (uint32_t)m_chunks.size();
+        out.oversized = m_oversized;
+        out.poison = m_poison ? 1 : 0;
+    }
+
+    void ResetStats()
+    {
+        m_highWater = m_used;
+        m_allocations = 0;
+        m_oversized = 0;
+    }
+
+private:
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+
+    // Appends a chunk that can hold size bytes at any supported alignment
+    bool AddChunk(size_t size)
+    {
+        size_t chunkSize = m_chunkSize;
+        if (size + kCacheLine > chunkSize)
+        {
+            chunkSize = size + kCacheLine;
+            ++m_oversized;
+        }
+
+        Chunk chunk;
+        chunk.data = (uint8_t*)PlatformAlignedAlloc(chunkSize, kCacheLine);
+        chunk.size = chunkSize;
+        if (!chunk.data)
+            return false;
+
+        // Only called with every chunk used up, so the new one becomes
+        // m_current; an oversized chunk stays in the chain for later ticks
+        m_chunks.push_back(chunk);
+        return true;
+    }
+
+    void PoisonFrom(const Marker& m)
+    {
+        for (size_t c = m.chunk; c <= m_current && c < m_chunks.size(); ++c)
+        {
+            const size_t from = c == m.chunk ? m.offset : 0;
+            const size_t to = c == m_current ? m_offset : m_chunks[c].size;
+            if (to > from)
+                memset(m_chunks[c].data + from, kTickArenaPoison, to - from);
+        }
+    }
+
+    std::vector<Chunk> m_chunks;
+    size_t m_chunkSize;
+    size_t m_current;              // chunk being bumped (== size() when none left)
+    size_t m_offset;               // next free byte in m_chunks[m_current]
+    size_t m_used;                 // bytes consumed this tick, padding included
+    size_t m_highWater;
+    uint64_t m_allocations;
+    uint32_t m_oversized;
+    uint32_t m_generation;
+    bool m_poison;
+};
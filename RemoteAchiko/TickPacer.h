@@ -0,0 +1,99 @@
+﻿// TickPacer.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Fixed-rate tick pacer — sleeps to the next deadline with low jitter
+//
+// Responsibilities:
+// • Absolute deadlines (start + n * period) — drift never accumulates
+// • Coarse OS sleep for the bulk of the wait, short spin for the tail
+// • Reports lateness of every wake-up for jitter statistics
+// • Skips missed ticks instead of bursting to catch up
+//
+// Architecture:
+// • Owned by one loop thread — not thread-safe, no atomics needed
+// • Spin tail is bounded by spinNs (default 1 ms) so an idle bot costs
+//   at most spinNs / period of one core
+//
+// Critical Design Decisions:
+// • Windows Sleep() rounds up to the system timer (up to 15.6 ms) —
+//   sleeping "period - elapsed" overshoots, so we sleep only while more
+//   than one timer quantum + spin tail remains
+// • Catch-up bursts are worse than a skipped tick inside the game
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include "Platform.h"
+
+class TickPacer
+{
+public:
+    // ───────────────────────────────────────────────────────────────
+    // Constructor
+    //
+    // Args:
+    //   periodNs  - tick period in nanoseconds
+    //   spinNs    - busy-wait budget before each deadline
+    //   quantumNs - expected OS sleep granularity
+    // ───────────────────────────────────────────────────────────────
+    explicit TickPacer(uint64_t periodNs, uint64_t spinNs = 1000000ULL, uint64_t quantumNs = 1000000ULL)
+        : m_periodNs(periodNs), m_spinNs(spinNs), m_quantumNs(quantumNs),
+          m_next(PlatformNowNs() + periodNs), m_skipped(0)
+    {
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // WaitNext — block until the next tick deadline
+    //
+    // Returns:
+    //   Lateness in nanoseconds (wake time - deadline, >= 0)
+    // ───────────────────────────────────────────────────────────────
+    uint64_t WaitNext()
+    {
+        uint64_t now = PlatformNowNs();
+
+        while (m_next > now + m_spinNs + m_quantumNs)
+        {
+            const uint64_t sleepNs = m_next - now - m_spinNs - m_quantumNs;
+            PlatformSleepMs((uint32_t)(sleepNs / 1000000ULL > 0 ? sleepNs / 1000000ULL : 1));
+            now = PlatformNowNs();
+        }
+
+        while (now < m_next)
+        {
+            PlatformCpuRelax();
+            now = PlatformNowNs();
+        }
+
+        const uint64_t lateness = now - m_next;
+
+        // Advance; skip whole periods we already missed
+        m_next += m_periodNs;
+        if (m_next <= now)
+        {
+            const uint64_t missed = (now - m_next) / m_periodNs + 1;
+            m_next += missed * m_periodNs;
+            m_skipped += missed;
+        }
+
+        return lateness;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Reset — restart the schedule one period from now
+    // ───────────────────────────────────────────────────────────────
+    void Reset()
+    {
+        m_next = PlatformNowNs() + m_periodNs;
+    }
+
+    uint64_t PeriodNs() const { return m_periodNs; }
+    uint64_t SkippedTicks() const { return m_skipped; }
+
+private:
+    uint64_t m_periodNs;
+    uint64_t m_spinNs;
+    uint64_t m_quantumNs;
+    uint64_t m_next;
+    uint64_t m_skipped;
+};
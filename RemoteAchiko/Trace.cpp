@@ -0,0 +1,489 @@
+﻿// Trace.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// TraceRecorder implementation — per-thread buffers, flusher, JSON export
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// TraceThreadBuffer — SPSC ring owned by one producing thread
+// ═══════════════════════════════════════════════════════════════
+struct TraceThreadBuffer
+{
+    alignas(64) std::atomic<uint32_t> head;   // producer (owning thread)
+    alignas(64) std::atomic<uint32_t> tail;   // consumer (flusher, under m_flushLock)
+    std::atomic<bool> retired;                // owner exited (set once, by its thread)
+    uint32_t threadId;
+    char name[48];
+    TraceEvent events[kTraceThreadEvents];
+};
+
+static thread_local TraceThreadBuffer* t_traceBuffer = nullptr;
+static thread_local bool t_traceNoBuffer = false;   // registration failed — retry once a buffer retires
+static thread_local uint32_t t_traceNoBufferAt;     // m_retired when it failed
+static thread_local bool t_traceExited = false;     // past TraceThreadExit — never register again
+static thread_local char t_traceThreadName[48];     // NameThread before the buffer exists
+
+// ───────────────────────────────────────────────────────────────
+// TraceThreadExit — hands the thread's buffer back when it exits
+// (thread_local destructors run on DLL_THREAD_DETACH). Constructed
+// by the first registration, so threads that never record pay nothing
+// ───────────────────────────────────────────────────────────────
+struct TraceThreadExit
+{
+    bool armed;
+    ~TraceThreadExit();
+};
+
+static thread_local TraceThreadExit t_traceExit;
+
+static const char* const kCategoryNames[TraceCategory_Count] =
+{
+    "bootstrap", "tick", "queue", "ipc", "gc"
+};
+
+// ───────────────────────────────────────────────────────────────
+// CopyName — bounded copy that always leaves dst terminated
+// (strncpy is a C4996 error under SDL checks)
+// ───────────────────────────────────────────────────────────────
+static void CopyName(char* dst, size_t capacity, const char* src)
+{
+    size_t n = strlen(src);
+    if (n > capacity - 1)
+        n = capacity - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ───────────────────────────────────────────────────────────────
+// Instance — leaked on purpose (see header)
+// ───────────────────────────────────────────────────────────────
+TraceRecorder& TraceRecorder::Instance()
+{
+    static TraceRecorder* s_instance = new TraceRecorder();
+    return *s_instance;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_enabled(false), m_dropped(0), m_nameCount(1), m_threadCount(0),
+      m_retired(0), m_refused(0), m_historyWritten(0), m_flusherRunning(false)
+{
+    memset(m_names, 0, sizeof(m_names));
+    memset(m_threads, 0, sizeof(m_threads));
+    CopyName(m_names[0].name, sizeof(m_names[0].name), "none");
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CONTROL
+// ═══════════════════════════════════════════════════════════════
+
+void TraceRecorder::SetEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> guard(m_controlLock);
+
+    if (enabled)
+    {
+        m_enabled.store(true, std::memory_order_relaxed);
+        if (!m_flusherRunning.load(std::memory_order_relaxed))
+        {
+            m_flusherRunning.store(true, std::memory_order_relaxed);
+            m_flusher = std::thread(&TraceRecorder::FlusherLoop, this);
+        }
+        return;
+    }
+
+    m_enabled.store(false, std::memory_order_relaxed);
+    if (m_flusherRunning.load(std::memory_order_relaxed))
+    {
+        m_flusherRunning.store(false, std::memory_order_relaxed);
+        m_flusher.join();
+    }
+    Flush();
+}
+
+void TraceRecorder::FlusherLoop()
+{
+    NameThread("RemoteAchiko trace flusher");
+
+    while (m_flusherRunning.load(std::memory_order_relaxed))
+    {
+        Flush();
+        PlatformSleepMs(kTraceFlushIntervalMs);
+    }
+}
+
+uint16_t TraceRecorder::RegisterName(const char* name, uint8_t category)
+{
+    if (!name || !*name)
+        return 0;
+
+    std::lock_guard<std::mutex> guard(m_namesLock);
+
+    const uint32_t count = m_nameCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        if (strncmp(m_names[i].name, name, sizeof(m_names[i].name) - 1) == 0)
+            return (uint16_t)i;
+    }
+
+    if (count >= kTraceMaxNames)
+        return 0;
+
+    NameEntry& entry = m_names[count];
+    CopyName(entry.name, sizeof(entry.name), name);
+    entry.category = category < TraceCategory_Count ? category : 0;
+
+    // Publish after the entry is written — Export reads without the lock
+    m_nameCount.store(count + 1, std::memory_order_release);
+    return (uint16_t)count;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RECORD PATH
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// CurrentBuffer — this thread's buffer, registered on first use
+// ───────────────────────────────────────────────────────────────
+TraceThreadBuffer* TraceRecorder::CurrentBuffer()
+{
+    TraceThreadBuffer* buffer = t_traceBuffer;
+    if (buffer || t_traceExited)
+        return buffer;
+    if (t_traceNoBuffer && t_traceNoBufferAt == m_retired.load(std::memory_order_relaxed))
+        return nullptr;
+
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+
+    buffer = Recycle();
+    if (!buffer)
+    {
+        const uint32_t count = m_threadCount.load(std::memory_order_relaxed);
+        void* memory = count < kTraceMaxThreads ? PlatformAlignedAlloc(sizeof(TraceThreadBuffer), kCacheLine) : nullptr;
+        if (!memory)
+        {
+            // Every buffer belongs to a live thread (or still holds an
+            // exited one's spans) — counted so the export shows the gap
+            t_traceNoBuffer = true;
+            t_traceNoBufferAt = m_retired.load(std::memory_order_relaxed);
+            m_refused.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        buffer = new (memory) TraceThreadBuffer();
+        buffer->head.store(0, std::memory_order_relaxed);
+        buffer->tail.store(0, std::memory_order_relaxed);
+        buffer->retired.store(false, std::memory_order_relaxed);
+        buffer->threadId = PlatformThreadId();
+        CopyName(buffer->name, sizeof(buffer->name), t_traceThreadName);
+
+        m_threads[count] = buffer;
+        m_threadCount.store(count + 1, std::memory_order_release);
+    }
+
+    t_traceExit.armed = true;
+    t_traceNoBuffer = false;
+    t_traceBuffer = buffer;
+    return buffer;
+}
+
+// ───────────────────────────────────────────────────────────────
+// Recycle — take over the buffer of an exited thread once its last
+// spans are in history (m_threadsLock held)
+//
+// Notes:
+//   • Runs under m_flushLock: the flusher owns tail, Export reads
+//     threadId and name
+//   • Table full → flush here rather than wait for the flusher, which
+//     does not run while tracing is disabled
+// ───────────────────────────────────────────────────────────────
+TraceThreadBuffer* TraceRecorder::Recycle()
+{
+    std::lock_guard<std::mutex> guard(m_flushLock);
+
+    const uint32_t count = m_threadCount.load(std::memory_order_relaxed);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint32_t t = 0; t < count; ++t)
+        {
+            TraceThreadBuffer* buffer = m_threads[t];
+
+            // The owner published its last head before retiring
+            if (!buffer->retired.load(std::memory_order_acquire) ||
+                buffer->head.load(std::memory_order_relaxed) != buffer->tail.load(std::memory_order_relaxed))
+                continue;
+
+            buffer->retired.store(false, std::memory_order_relaxed);
+            buffer->threadId = PlatformThreadId();
+            CopyName(buffer->name, sizeof(buffer->name), t_traceThreadName);
+            return buffer;
+        }
+
+        if (count < kTraceMaxThreads)
+            return nullptr;
+        FlushLocked();
+    }
+    return nullptr;
+}
+
+TraceThreadExit::~TraceThreadExit()
+{
+    // Spans recorded by later thread_local destructors are dropped
+    t_traceExited = true;
+
+    TraceThreadBuffer* buffer = t_traceBuffer;
+    if (!buffer)
+        return;
+    t_traceBuffer = nullptr;
+
+    // Pending spans stay until the next flush moves them into history
+    buffer->retired.store(true, std::memory_order_release);
+    TraceRecorder::Instance().OnThreadRetired();
+}
+
+void TraceRecorder::OnThreadRetired()
+{
+    // Threads refused a buffer retry on their next span
+    m_retired.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Push(const TraceEvent& e)
+{
+    TraceThreadBuffer* buffer = CurrentBuffer();
+    if (!buffer)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint32_t head = buffer->head.load(std::memory_order_relaxed);
+    const uint32_t tail = buffer->tail.load(std::memory_order_acquire);
+    if (head - tail >= kTraceThreadEvents)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent& slot = buffer->events[head & (kTraceThreadEvents - 1)];
+    slot = e;
+    slot.threadId = buffer->threadId;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRecorder::Record(uint16_t nameId, uint64_t startTicks, uint64_t endTicks)
+{
+    TraceEvent e;
+    e.startTicks = startTicks;
+    e.durationTicks = endTicks > startTicks ? endTicks - startTicks : 0;
+    e.threadId = 0;
+    e.nameId = nameId;
+    e.instant = 0;
+    e.reserved = 0;
+    Push(e);
+}
+
+void TraceRecorder::RecordInstant(uint16_t nameId, uint64_t ticks)
+{
+    TraceEvent e;
+    e.startTicks = ticks;
+    e.durationTicks = 0;
+    e.threadId = 0;
+    e.nameId = nameId;
+    e.instant = 1;
+    e.reserved = 0;
+    Push(e);
+}
+
+void TraceRecorder::NameThread(const char* name)
+{
+    if (!name)
+        return;
+
+    // No buffer yet → remember the name; the buffer (≈100 KB) is only
+    // allocated once the thread actually records something
+    TraceThreadBuffer* buffer = t_traceBuffer;
+    if (!buffer)
+    {
+        CopyName(t_traceThreadName, sizeof(t_traceThreadName), name);
+        return;
+    }
+
+    // Export may read concurrently — a torn name is cosmetic, never unsafe
+    // because the last byte always stays '\0'
+    CopyName(buffer->name, sizeof(buffer->name), name);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CONSUMER SIDE
+// ═══════════════════════════════════════════════════════════════
+
+size_t TraceRecorder::Flush()
+{
+    std::lock_guard<std::mutex> guard(m_flushLock);
+    return FlushLocked();
+}
+
+size_t TraceRecorder::FlushLocked()
+{
+    if (m_history.empty())
+        m_history.resize(kTraceHistoryEvents);
+
+    size_t moved = 0;
+    const uint32_t threads = m_threadCount.load(std::memory_order_acquire);
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        TraceThreadBuffer* buffer = m_threads[t];
+        uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+        const uint32_t head = buffer->head.load(std::memory_order_acquire);
+
+        while (tail != head)
+        {
+            m_history[m_historyWritten % kTraceHistoryEvents] = buffer->events[tail & (kTraceThreadEvents - 1)];
+            ++m_historyWritten;
+            ++tail;
+            ++moved;
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+    return moved;
+}
+
+void TraceRecorder::Clear()
+{
+    Flush();
+
+    std::lock_guard<std::mutex> guard(m_flushLock);
+    m_historyWritten = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
+}
+
+size_t TraceRecorder::Recent(uint32_t threadId, TraceEvent* out, size_t capacity)
+{
+    Flush();
+
+    std::lock_guard<std::mutex> guard(m_flushLock);
+
+    const uint64_t written = m_historyWritten;
+    const uint64_t count = written < kTraceHistoryEvents ? written : kTraceHistoryEvents;
+
+    // Walk back from the newest event, then reverse into time order
+    size_t found = 0;
+    for (uint64_t i = written; i > written - count && found < capacity; --i)
+    {
+        const TraceEvent& e = m_history[(i - 1) % kTraceHistoryEvents];
+        if (threadId == 0 || e.threadId == threadId)
+            out[found++] = e;
+    }
+    std::reverse(out, out + found);
+    return found;
+}
+
+const char* TraceRecorder::NameOf(uint16_t nameId) const
+{
+    const uint32_t names = m_nameCount.load(std::memory_order_acquire);
+    return m_names[nameId < names ? nameId : 0].name;
+}
+
+// ───────────────────────────────────────────────────────────────
+// WriteJsonString — quoted, escaped JSON string
+// ───────────────────────────────────────────────────────────────
+static void WriteJsonString(FILE* out, const char* s)
+{
+    fputc('"', out);
+    for (; *s; ++s)
+    {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\')
+        {
+            fputc('\\', out);
+            fputc(c, out);
+        }
+        else if (c < 0x20)
+        {
+            fprintf(out, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// ───────────────────────────────────────────────────────────────
+// ExportChromeJson
+//
+// Format:
+//   • "X" complete events, "i" thread-scoped instants, "M" metadata
+//     for process/thread names
+//   • ts/dur in microseconds (fractional), relative to the oldest
+//     event in history so the viewer opens at t = 0
+// ───────────────────────────────────────────────────────────────
+int64_t TraceRecorder::ExportChromeJson(FILE* out)
+{
+    Flush();
+
+    std::lock_guard<std::mutex> guard(m_flushLock);
+
+    const uint64_t written = m_historyWritten;
+    const uint64_t count = written < kTraceHistoryEvents ? written : kTraceHistoryEvents;
+    const uint64_t first = written - count;
+    const uint32_t pid = PlatformProcessId();
+    const uint32_t names = m_nameCount.load(std::memory_order_acquire);
+
+    uint64_t originTicks = UINT64_MAX;
+    for (uint64_t i = first; i < written; ++i)
+    {
+        const uint64_t t = m_history[i % kTraceHistoryEvents].startTicks;
+        if (t < originTicks)
+            originTicks = t;
+    }
+    const uint64_t originNs = count ? PlatformTicksToNs(originTicks) : 0;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":%llu,\"refused_threads\":%llu},\"traceEvents\":[\n",
+        (unsigned long long)Dropped(), (unsigned long long)RefusedThreads());
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"WoW %u (Achiko)\"}}",
+        pid, pid);
+
+    const uint32_t threads = m_threadCount.load(std::memory_order_acquire);
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        const TraceThreadBuffer* buffer = m_threads[t];
+        if (!buffer->name[0])
+            continue;
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":", pid, buffer->threadId);
+        WriteJsonString(out, buffer->name);
+        fputs("}}", out);
+    }
+
+    for (uint64_t i = first; i < written; ++i)
+    {
+        const TraceEvent& e = m_history[i % kTraceHistoryEvents];
+        const NameEntry& name = m_names[e.nameId < names ? e.nameId : 0];
+        const uint64_t tsNs = PlatformTicksToNs(e.startTicks) - originNs;
+
+        fputs(",\n{\"name\":", out);
+        WriteJsonString(out, name.name);
+        fprintf(out, ",\"cat\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%llu.%03u",
+            kCategoryNames[name.category], pid, e.threadId,
+            (unsigned long long)(tsNs / 1000), (unsigned)(tsNs % 1000));
+
+        if (e.instant)
+        {
+            fputs(",\"ph\":\"i\",\"s\":\"t\"}", out);
+        }
+        else
+        {
+            const uint64_t durNs = PlatformTicksToNs(e.durationTicks);
+            fprintf(out, ",\"ph\":\"X\",\"dur\":%llu.%03u}",
+                (unsigned long long)(durNs / 1000), (unsigned)(durNs % 1000));
+        }
+    }
+
+    fputs("\n]}\n", out);
+    return ferror(out) ? -1 : (int64_t)count;
+}
@@ -0,0 +1,232 @@
+﻿// Trace.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Scoped trace spans → Chrome / Perfetto trace-event JSON
+//
+// Responsibilities:
+// • Record complete spans (name, start, duration, thread) from any thread
+// • Record instant events (GC observed, state changes)
+// • Background flusher drains per-thread buffers into a history ring
+// • ExportChromeJson writes the history as {"traceEvents":[...]}
+//
+// Architecture:
+// • One SPSC buffer per producing thread (thread_local lookup, no locks on
+//   the record path) — owner pushes, flusher pops
+// • Flusher thread runs every kFlushIntervalMs while tracing is enabled
+//   and moves events into a fixed history ring (oldest overwritten)
+// • Span names are interned once into a small id table; events carry a
+//   16-bit id, never a string
+//
+// Critical Design Decisions:
+// • Disabled = one relaxed atomic load in TraceScope, nothing else
+// • Full thread buffer drops the event and counts it — producers are game
+//   and bot threads and must never wait for the flusher
+// • A thread's buffer is handed back when the thread exits and reused by
+//   the next thread once its spans are flushed; with kTraceMaxThreads
+//   live threads a new one records nothing, and RefusedThreads() (in the
+//   export's otherData) says so
+// • Recorder is heap-allocated and never destroyed — the flusher thread
+//   may still be running when WoW exits (same rule as g_clrHost)
+// • Timestamps use PlatformNowTicks() so managed Stopwatch ticks and
+//   native spans land on one timeline
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Platform.h"
+
+// ═══════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════
+
+static const uint32_t kTraceThreadEvents = 4096;     // per-thread buffer (power of two)
+static const uint32_t kTraceHistoryEvents = 1 << 17; // 128k events ≈ 3 MB
+static const uint32_t kTraceMaxNames = 512;          // id 0 is reserved for "none"
+static const uint32_t kTraceMaxThreads = 64;
+static const uint32_t kTraceFlushIntervalMs = 10;
+
+// Categories appear as "cat" in the JSON — keep in sync with Tracer.cs
+enum TraceCategory : uint8_t
+{
+    TraceCategory_Bootstrap = 0,
+    TraceCategory_Tick = 1,
+    TraceCategory_Queue = 2,
+    TraceCategory_Ipc = 3,
+    TraceCategory_Gc = 4,
+    TraceCategory_Count
+};
+
+// ═══════════════════════════════════════════════════════════════
+// TraceEvent — one span or instant (24 bytes)
+// ═══════════════════════════════════════════════════════════════
+struct TraceEvent
+{
+    uint64_t startTicks;     // PlatformNowTicks() units
+    uint64_t durationTicks;  // 0 for instants
+    uint32_t threadId;       // PlatformThreadId() of the producer
+    uint16_t nameId;         // TraceRecorder::RegisterName
+    uint8_t  instant;        // 1 = "ph":"i", 0 = "ph":"X"
+    uint8_t  reserved;
+};
+
+struct TraceThreadBuffer;   // Trace.cpp
+struct TraceThreadExit;     // Trace.cpp
+
+// ═══════════════════════════════════════════════════════════════
+// TraceRecorder — process-wide span recorder
+// ═══════════════════════════════════════════════════════════════
+class TraceRecorder
+{
+public:
+    static TraceRecorder& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // SetEnabled — start/stop recording and the background flusher
+    //
+    // Notes:
+    //   • Disabling flushes once more so Export sees every span
+    //   • Never call from DllMain (joins the flusher thread)
+    // ───────────────────────────────────────────────────────────────
+    void SetEnabled(bool enabled);
+    bool Enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // ───────────────────────────────────────────────────────────────
+    // RegisterName — intern a span name
+    //
+    // Returns:
+    //   Stable id (same name → same id), 0 if the table is full
+    // ───────────────────────────────────────────────────────────────
+    uint16_t RegisterName(const char* name, uint8_t category);
+
+    // ───────────────────────────────────────────────────────────────
+    // Record / RecordInstant — append to the calling thread's buffer
+    //
+    // Notes:
+    //   • Does NOT check Enabled() — callers do (TraceScope, Tracer.cs),
+    //     which lets bootstrap spans be recorded before anyone enables
+    //   • Full buffer → event dropped, Dropped() incremented
+    // ───────────────────────────────────────────────────────────────
+    void Record(uint16_t nameId, uint64_t startTicks, uint64_t endTicks);
+    void RecordInstant(uint16_t nameId, uint64_t ticks);
+
+    // Label the calling thread in the exported trace (copied, truncated)
+    void NameThread(const char* name);
+
+    // ───────────────────────────────────────────────────────────────
+    // Flush — move every thread's pending events into history
+    //
+    // Returns:
+    //   Number of events moved
+    // ───────────────────────────────────────────────────────────────
+    size_t Flush();
+
+    // ───────────────────────────────────────────────────────────────
+    // ExportChromeJson — flush, then write history as trace-event JSON
+    //
+    // Returns:
+    //   Number of events written, or -1 on write error
+    // ───────────────────────────────────────────────────────────────
+    int64_t ExportChromeJson(FILE* out);
+
+    // ───────────────────────────────────────────────────────────────
+    // Recent — the last events of one thread, oldest first
+    //
+    // Args:
+    //   threadId - PlatformThreadId() of the thread (0 = any thread)
+    //   out      - [out] up to capacity events
+    //
+    // Returns:
+    //   Events written (flushes first; empty while tracing never ran)
+    // ───────────────────────────────────────────────────────────────
+    size_t Recent(uint32_t threadId, TraceEvent* out, size_t capacity);
+
+    // Interned span name for an id ("none" if unknown)
+    const char* NameOf(uint16_t nameId) const;
+
+    void Clear();
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Registrations refused because every buffer was taken (not reset by Clear)
+    uint64_t RefusedThreads() const { return m_refused.load(std::memory_order_relaxed); }
+
+private:
+    struct NameEntry
+    {
+        char name[48];
+        uint8_t category;
+    };
+
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder&);
+    TraceRecorder& operator=(const TraceRecorder&);
+
+    friend struct TraceThreadExit;
+
+    TraceThreadBuffer* CurrentBuffer();
+    TraceThreadBuffer* Recycle();
+    void OnThreadRetired();
+    void Push(const TraceEvent& e);
+    size_t FlushLocked();
+    void FlusherLoop();
+
+    std::atomic<bool> m_enabled;
+    std::atomic<uint64_t> m_dropped;
+
+    std::mutex m_namesLock;                       // RegisterName only
+    NameEntry m_names[kTraceMaxNames];
+    std::atomic<uint32_t> m_nameCount;
+
+    std::mutex m_threadsLock;                     // buffer registration
+    TraceThreadBuffer* m_threads[kTraceMaxThreads];
+    std::atomic<uint32_t> m_threadCount;
+    std::atomic<uint32_t> m_retired;              // thread exits that freed a buffer
+    std::atomic<uint64_t> m_refused;              // registrations with no buffer left
+
+    std::mutex m_flushLock;                       // the single consumer
+    std::vector<TraceEvent> m_history;            // allocated on first flush
+    uint64_t m_historyWritten;                    // total ever written
+
+    std::mutex m_controlLock;                     // SetEnabled
+    std::thread m_flusher;
+    std::atomic<bool> m_flusherRunning;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// TraceScope — RAII span for native code
+// ═══════════════════════════════════════════════════════════════
+// Usage:
+//   static const uint16_t s_id = TraceRecorder::Instance().RegisterName("boot.clr_start", TraceCategory_Bootstrap);
+//   TraceScope span(s_id);
+//
+// always = true records even while tracing is disabled (bootstrap runs
+// before the UI can enable anything).
+// ───────────────────────────────────────────────────────────────
+class TraceScope
+{
+public:
+    explicit TraceScope(uint16_t nameId, bool always = false)
+        : m_nameId(nameId), m_start(0)
+    {
+        if (nameId != 0 && (always || TraceRecorder::Instance().Enabled()))
+            m_start = PlatformNowTicks();
+    }
+
+    ~TraceScope()
+    {
+        if (m_start != 0)
+            TraceRecorder::Instance().Record(m_nameId, m_start, PlatformNowTicks());
+    }
+
+private:
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+
+    uint16_t m_nameId;
+    uint64_t m_start;
+};
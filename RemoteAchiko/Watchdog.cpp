@@ -0,0 +1,260 @@
+﻿// Watchdog.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Watchdog implementation — slot registry, poll loop, hang reports
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Watchdog.h"
+
+#include <Windows.h>
+#include <new>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Platform.h"
+#include "Sampler.h"
+#include "Trace.h"
+
+// ───────────────────────────────────────────────────────────────
+// CopyName — bounded copy that always leaves dst terminated
+// ───────────────────────────────────────────────────────────────
+static void CopyName(char* dst, size_t capacity, const char* src)
+{
+    size_t n = strlen(src);
+    if (n > capacity - 1)
+        n = capacity - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ───────────────────────────────────────────────────────────────
+// Instance — leaked on purpose (see header); aligned storage because
+// the slots are cache-line aligned and plain new is not (pre-C++17)
+// ───────────────────────────────────────────────────────────────
+Watchdog& Watchdog::Instance()
+{
+    static Watchdog* s_instance = new (PlatformAlignedAlloc(sizeof(Watchdog), kCacheLine)) Watchdog();
+    return *s_instance;
+}
+
+Watchdog::Watchdog()
+    : m_nextGeneration(1), m_started(false), m_hangs(0), m_pipe(INVALID_HANDLE_VALUE)
+{
+    for (uint32_t i = 0; i < kHeartbeatMaxSlots; ++i)
+    {
+        m_slots[i].beat.store(0, std::memory_order_relaxed);
+        m_slots[i].generation.store(0, std::memory_order_relaxed);
+        m_slots[i].threadId = 0;
+        m_slots[i].timeoutMs = kHeartbeatDefaultTimeoutMs;
+        m_slots[i].name[0] = '\0';
+        m_handles[i] = nullptr;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// THREAD REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+volatile uint32_t* Watchdog::RegisterCurrentThread(const char* name, uint32_t timeoutMs)
+{
+    const uint32_t threadId = GetCurrentThreadId();
+    const char* label = (name && *name) ? name : "thread";
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    HeartbeatSlot* free = nullptr;
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < kHeartbeatMaxSlots; ++i)
+    {
+        if (m_slots[i].threadId == threadId)
+            return reinterpret_cast<volatile uint32_t*>(&m_slots[i].beat);
+        if (!free && m_slots[i].threadId == 0)
+        {
+            free = &m_slots[i];
+            index = i;
+        }
+    }
+    if (!free)
+        return nullptr;
+
+    HANDLE handle = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION,
+        FALSE, threadId);
+    if (!handle)
+        return nullptr;
+
+    m_handles[index] = handle;
+    free->threadId = threadId;
+    free->timeoutMs = timeoutMs < kHeartbeatMinTimeoutMs ? kHeartbeatMinTimeoutMs : timeoutMs;
+    CopyName(free->name, sizeof(free->name), label);
+    free->beat.store(0, std::memory_order_relaxed);
+
+    // Publish last — the detector only looks at live (odd) generations
+    free->generation.store(m_nextGeneration, std::memory_order_release);
+    m_nextGeneration += 2;
+
+    if (!m_started)
+    {
+        m_started = true;
+        m_thread = std::thread(&Watchdog::WatchdogLoop, this);
+        m_thread.detach();
+    }
+
+    return reinterpret_cast<volatile uint32_t*>(&free->beat);
+}
+
+void Watchdog::UnregisterCurrentThread()
+{
+    const uint32_t threadId = GetCurrentThreadId();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (uint32_t i = 0; i < kHeartbeatMaxSlots; ++i)
+    {
+        if (m_slots[i].threadId == threadId)
+        {
+            m_slots[i].generation.store(0, std::memory_order_release);
+            m_slots[i].threadId = 0;
+            CloseHandle((HANDLE)m_handles[i]);
+            m_handles[i] = nullptr;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// WATCHDOG THREAD
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// WatchdogLoop — poll every kWatchdogPollMs, report what changed
+// ───────────────────────────────────────────────────────────────
+void Watchdog::WatchdogLoop()
+{
+    TraceRecorder::Instance().NameThread("RemoteAchiko watchdog");
+
+    HangEvent events[kHeartbeatMaxSlots];
+    for (;;)
+    {
+        PlatformSleepMs(kWatchdogPollMs);
+
+        const uint32_t count = m_detector.Scan(m_slots, PlatformNowNs() / 1000000ULL, events);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const HeartbeatSlot& slot = m_slots[events[i].slot];
+            if (events[i].recovered)
+            {
+                Report("[Watchdog] '%s' (tid %u) recovered after %.1f s without heartbeat",
+                    slot.name, slot.threadId, events[i].stalledMs / 1000.0);
+                continue;
+            }
+
+            m_hangs.fetch_add(1, std::memory_order_relaxed);
+            ReportHang(events[i].slot, events[i].stalledMs);
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// ReportHang — stack + recent trace events of one stuck thread
+//
+// Notes:
+//   • Capture runs under m_lock so the thread handle cannot be closed
+//     mid-walk; the target cannot hold m_lock while suspended because
+//     we already do
+//   • Symbolization and formatting happen after ResumeThread
+// ───────────────────────────────────────────────────────────────
+void Watchdog::ReportHang(uint32_t index, uint64_t stalledMs)
+{
+    uintptr_t frames[kProfileMaxFrames];
+    uint32_t frameCount = 0;
+    uint32_t threadId = 0;
+    char name[48];
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const HeartbeatSlot& slot = m_slots[index];
+        if ((slot.generation.load(std::memory_order_relaxed) & 1) == 0 || !m_handles[index])
+            return;   // unregistered since the scan
+
+        threadId = slot.threadId;
+        CopyName(name, sizeof(name), slot.name);
+        frameCount = Sampler::CaptureStack(m_handles[index], frames);
+    }
+
+    Report("[Watchdog] HANG: '%s' (tid %u) - no heartbeat for %.1f s",
+        name, threadId, stalledMs / 1000.0);
+
+    if (frameCount == 0)
+    {
+        Report("[Watchdog]   stack: capture failed");
+    }
+    else
+    {
+        std::vector<std::string> symbols;
+        Sampler::Instance().Symbolize(frames, frameCount, symbols);
+
+        const uint32_t shown = frameCount < kWatchdogReportFrames ? frameCount : kWatchdogReportFrames;
+        for (uint32_t f = 0; f < shown; ++f)
+            Report("[Watchdog]   #%-2u %s", f, symbols[f].c_str());
+        if (frameCount > shown)
+            Report("[Watchdog]   ... %u more frames", frameCount - shown);
+    }
+
+    TraceRecorder& trace = TraceRecorder::Instance();
+    TraceEvent recent[kWatchdogReportEvents];
+    const size_t eventCount = trace.Recent(threadId, recent, kWatchdogReportEvents);
+    if (eventCount == 0)
+    {
+        Report(trace.Enabled()
+            ? "[Watchdog]   flight recorder: no events from this thread"
+            : "[Watchdog]   flight recorder: tracing off - no events (Trace button)");
+        return;
+    }
+
+    const uint64_t nowTicks = PlatformNowTicks();
+    Report("[Watchdog]   last %u trace events (oldest first):", (unsigned)eventCount);
+    for (size_t e = 0; e < eventCount; ++e)
+    {
+        const uint64_t agoNs = nowTicks > recent[e].startTicks ? PlatformTicksToNs(nowTicks - recent[e].startTicks) : 0;
+        if (recent[e].instant)
+            Report("[Watchdog]     %-24s instant   %8.1f ms ago", trace.NameOf(recent[e].nameId), agoNs / 1e6);
+        else
+            Report("[Watchdog]     %-24s %7.2f ms %8.1f ms ago", trace.NameOf(recent[e].nameId),
+                PlatformTicksToNs(recent[e].durationTicks) / 1e6, agoNs / 1e6);
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// Report — one line to Achikobuddy's bootstrapper log
+//
+// Notes:
+//   Own pipe handle (the server accepts any number of clients), opened
+//   lazily and reopened after Achikobuddy restarts
+// ───────────────────────────────────────────────────────────────
+void Watchdog::Report(const char* format, ...)
+{
+    if (m_pipe == INVALID_HANDLE_VALUE)
+    {
+        m_pipe = CreateFileA("\\\\.\\pipe\\AchikoPipe_Bootstrapper", GENERIC_WRITE, 0, NULL,
+            OPEN_EXISTING, 0, NULL);
+        if (m_pipe == INVALID_HANDLE_VALUE)
+            return;
+    }
+
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    const int prefix = sprintf_s(buffer, sizeof(buffer), "RemoteAchiko: ");
+    vsnprintf_s(buffer + prefix, sizeof(buffer) - prefix - 2, _TRUNCATE, format, args);
+    va_end(args);
+
+    const size_t length = strlen(buffer);
+    buffer[length] = '\r';
+    buffer[length + 1] = '\n';
+
+    DWORD written = 0;
+    if (!WriteFile((HANDLE)m_pipe, buffer, (DWORD)(length + 2), &written, NULL))
+    {
+        CloseHandle((HANDLE)m_pipe);
+        m_pipe = INVALID_HANDLE_VALUE;
+    }
+}
@@ -0,0 +1,86 @@
+﻿// Watchdog.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Heartbeat watchdog for bot threads — detects hangs, captures evidence
+//
+// Responsibilities:
+// • Hand each watched thread a heartbeat slot (Heartbeat.h)
+// • Watchdog thread: poll the slots, detect missed heartbeats
+// • On a hang: capture the stuck thread's stack and its most recent
+//   trace events (the flight recorder), report both to Achikobuddy
+// • Report recovery when the thread starts beating again
+//
+// Architecture:
+// • Windows only (thread handles, stack capture) — Watchdog.cpp is not part
+//   of the Linux bench build; the detection core is
+// • Stack capture and symbolization are the sampler's (Sampler::CaptureStack,
+//   Sampler::Symbolize)
+// • Reports go straight to the bootstrapper log pipe on the watchdog's own
+//   handle — the hung thread may well be AchikoDLL's log writer
+//
+// Critical Design Decisions:
+// • Hot path is the owner's single relaxed store into its slot — the
+//   watchdog never writes a slot, registration is the only locked path
+// • Watchdog thread starts with the first registration and is never
+//   stopped (heap singleton, same rule as Sampler / TraceRecorder)
+// • Detection only — the watchdog never kills, interrupts or restarts
+//   a thread; that decision stays with the user
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Heartbeat.h"
+
+static const uint32_t kWatchdogPollMs = 250;
+static const uint32_t kWatchdogReportFrames = 24;   // stack lines per hang report
+static const uint32_t kWatchdogReportEvents = 16;   // trace events per hang report
+
+// ═══════════════════════════════════════════════════════════════
+// Watchdog
+// ═══════════════════════════════════════════════════════════════
+class Watchdog
+{
+public:
+    static Watchdog& Instance();
+
+    // ───────────────────────────────────────────────────────────────
+    // RegisterCurrentThread — start watching the calling thread
+    //
+    // Args:
+    //   name      - label for reports (copied, truncated)
+    //   timeoutMs - silence that counts as a hang (min kHeartbeatMinTimeoutMs)
+    //
+    // Returns:
+    //   Address of the 32-bit heartbeat counter the thread must keep
+    //   storing to, nullptr if every slot is taken
+    // ───────────────────────────────────────────────────────────────
+    volatile uint32_t* RegisterCurrentThread(const char* name, uint32_t timeoutMs);
+    void UnregisterCurrentThread();
+
+    uint64_t Hangs() const { return m_hangs.load(std::memory_order_relaxed); }
+
+private:
+    Watchdog();
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+
+    void WatchdogLoop();
+    void ReportHang(uint32_t slot, uint64_t stalledMs);
+    void Report(const char* format, ...);
+
+    HeartbeatSlot m_slots[kHeartbeatMaxSlots];
+    void* m_handles[kHeartbeatMaxSlots];   // SUSPEND_RESUME | GET_CONTEXT
+    uint32_t m_nextGeneration;
+
+    std::mutex m_lock;                     // registration + handles
+    std::thread m_thread;
+    bool m_started;
+    std::atomic<uint64_t> m_hangs;
+
+    void* m_pipe;                          // watchdog thread only
+    HangDetector m_detector;               // watchdog thread only
+};
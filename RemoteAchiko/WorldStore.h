@@ -0,0 +1,1083 @@
+﻿// WorldStore.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Persistent world knowledge — where mobs spawn, where vendors, flight
+// masters and gather nodes are — kept across sessions
+//
+// Responsibilities:
+// • Record(): append a sighting (map, kind, entry, position) to the log,
+//   unless a recent one of the same entry already covers that spot
+// • Nearest() / QueryRadius(): "nearest known vendor", "herbs within
+//   200 yd" over everything ever seen, in microseconds
+// • Compact in the background: merge the log into a new base file with
+//   a spatial grid per (map, kind) partition
+//
+// Architecture:
+// • On disk, in one directory:
+//     world-<gen>.dat  base: header, partition table, records sorted by
+//                      partition and cell, cell offsets (CSR grid, the
+//                      SpatialGrid layout)
+//     world-<gen>.log  append-only sightings, 36-byte checksummed frames
+//   Base <gen> contains every log numbered below <gen>
+// • The base is memory-mapped (MappedFile.h) and queried in place —
+//   Open() checks the header, partition table and cell offsets, not the
+//   records. Logs since the last compaction (the tail) are replayed into
+//   memory and scanned linearly; compaction keeps them short
+// • Compaction (worker thread): start a new log, merge base + tail
+//   snapshot into world-<gen+1>.tmp, rename to .dat, swap the mapping,
+//   delete the old base and logs
+//
+// Critical Design Decisions:
+// • Crash-safe without fsync games: a base only becomes visible by an
+//   atomic rename, old logs are deleted after it; a torn log frame ends
+//   that log's replay. Every session appends to a fresh log number
+// • Bases are numbered, never renamed over — Windows cannot replace a
+//   file that is still mapped
+// • Merge, don't hoard: sightings of the same entry within
+//   kWorldMergeRadius are one spot (count + last seen); a re-sighting
+//   inside kWorldRefreshSeconds is not logged at all
+// • One lock for queries, Record and the compactor's snapshot / swap —
+//   all are microseconds; the merge itself runs unlocked
+// • Portable (Win32 / POSIX) so RemoteAchikoBench measures it directly
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MappedFile.h"
+#include "Platform.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t kWorldVersion = 1;
+static const float kWorldMergeRadius = 5.0f;              // yards — same spot
+static const uint32_t kWorldRefreshSeconds = 3600;        // re-log a known spot at most hourly
+static const size_t kWorldCompactRecords = 4096;          // tail size that triggers compaction
+static const float kWorldCellSize = 100.0f;               // yards, grows for sparse partitions
+static const uint32_t kWorldMaxCells = 1u << 14;          // per partition
+static const float kWorldMaxCoordinate = 1.0e6f;          // yards — far beyond any map (±17067)
+
+#ifdef _WIN32
+typedef wchar_t WorldPathChar;
+#else
+typedef char WorldPathChar;
+#endif
+typedef std::basic_string<WorldPathChar> WorldPath;
+
+// ═══════════════════════════════════════════════════════════════
+// Public records
+// ═══════════════════════════════════════════════════════════════
+enum WorldKind : uint16_t
+{
+    WorldKind_MobSpawn = 0,
+    WorldKind_Vendor = 1,
+    WorldKind_Repair = 2,
+    WorldKind_FlightMaster = 3,
+    WorldKind_Innkeeper = 4,
+    WorldKind_Trainer = 5,
+    WorldKind_Herb = 6,
+    WorldKind_Ore = 7,
+    WorldKind_Chest = 8,
+    WorldKind_Count = 9,
+};
+
+// One known spot — a log frame payload and a base record. Layout shared
+// with WorldKnowledge.cs
+struct WorldSighting
+{
+    uint32_t map;
+    uint16_t kind;             // WorldKind
+    uint16_t flags;            // caller-defined, OR-ed on merge
+    uint32_t entry;            // creature / game object entry (0 in a query = any)
+    float x, y, z;
+    uint32_t seenAt;           // unix seconds, latest sighting
+    uint32_t seenCount;        // sightings merged into this spot
+};
+
+struct WorldStoreStats
+{
+    uint64_t baseRecords;
+    uint64_t tailRecords;
+    uint64_t baseBytes;
+    uint64_t recorded;         // appended to the log
+    uint64_t deduplicated;     // covered by a recent sighting, not logged
+    uint64_t queries;
+    uint64_t compactions;
+    uint64_t lastCompactNs;
+    uint32_t partitions;
+    uint32_t generation;       // current base
+    uint32_t compacting;       // 1 while the worker merges
+    uint32_t open;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// On-disk layout
+// ═══════════════════════════════════════════════════════════════
+struct WorldBaseHeader
+{
+    char magic[4];             // "AWKB"
+    uint32_t version;
+    uint32_t generation;
+    uint32_t partitions;
+    uint64_t records;
+    uint64_t cells;            // total cell offsets (sum of cols * rows + 1)
+};
+
+struct WorldPartition
+{
+    uint32_t map;
+    uint16_t kind;
+    uint16_t reserved;
+    uint32_t firstRecord;
+    uint32_t count;
+    uint32_t firstCell;        // into the cell offset array
+    uint32_t cols, rows;
+    float minX, minY, cellSize;
+};
+
+struct WorldLogFrame
+{
+    WorldSighting sighting;
+    uint32_t check;            // FNV-1a of sighting
+};
+
+inline uint32_t WorldChecksum(const WorldSighting& s)
+{
+    const uint8_t* p = (const uint8_t*)&s;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(s); ++i)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// Position within kWorldMaxCoordinate on every axis (NaN and ±inf fail)
+inline bool WorldInRange(const WorldSighting& s)
+{
+    return fabsf(s.x) <= kWorldMaxCoordinate && fabsf(s.y) <= kWorldMaxCoordinate &&
+           fabsf(s.z) <= kWorldMaxCoordinate;
+}
+
+// Query point and radius a search can use: finite, radius ≥ 0
+inline bool WorldQueryValid(float x, float y, float radius)
+{
+    return std::isfinite(x) && std::isfinite(y) && std::isfinite(radius) && radius >= 0.0f;
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldCell — grid column / row of v, clamped to [0, count - 1]
+//
+// Notes:
+//   Clamped in float before the integer cast: a point far off the
+//   grid (or NaN, which lands in cell 0) never reaches an out-of-range
+//   conversion
+// ───────────────────────────────────────────────────────────────
+inline uint32_t WorldCell(float v, float min, float cellSize, uint32_t count)
+{
+    const float f = floorf((v - min) / cellSize);
+    if (!(f > 0.0f))
+        return 0;
+    return f < (float)count ? (uint32_t)f : count - 1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FILE HELPERS (Win32 / POSIX)
+// ═══════════════════════════════════════════════════════════════
+
+// "<dir>/world-00000012.dat"
+inline WorldPath WorldFileName(const WorldPath& dir, uint32_t generation, const char* extension)
+{
+    char name[40];
+    snprintf(name, sizeof(name), "world-%08u.%s", generation, extension);
+    WorldPath path = dir;
+#ifdef _WIN32
+    path += L'\\';
+#else
+    path += '/';
+#endif
+    for (const char* c = name; *c; ++c)
+        path += (WorldPathChar)*c;
+    return path;
+}
+
+inline FILE* WorldOpenFile(const WorldPath& path, const char* mode)
+{
+#ifdef _WIN32
+    wchar_t wmode[8];
+    size_t n = 0;
+    for (; mode[n] && n + 1 < 8; ++n)
+        wmode[n] = (wchar_t)mode[n];
+    wmode[n] = L'\0';
+    FILE* file = nullptr;
+    return _wfopen_s(&file, path.c_str(), wmode) == 0 ? file : nullptr;
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+inline void WorldDeleteFile(const WorldPath& path)
+{
+#ifdef _WIN32
+    DeleteFileW(path.c_str());
+#else
+    unlink(path.c_str());
+#endif
+}
+
+inline bool WorldRenameFile(const WorldPath& from, const WorldPath& to)
+{
+#ifdef _WIN32
+    return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldListFiles — generations of world-*.<extension> in dir, sorted
+// ───────────────────────────────────────────────────────────────
+inline std::vector<uint32_t> WorldListFiles(const WorldPath& dir, const char* extension)
+{
+    std::vector<uint32_t> generations;
+    const size_t extLength = strlen(extension);
+#ifdef _WIN32
+    WIN32_FIND_DATAW found;
+    HANDLE find = FindFirstFileW((dir + L"\\world-*").c_str(), &found);
+    if (find == INVALID_HANDLE_VALUE)
+        return generations;
+    do
+    {
+        char name[64];
+        size_t n = 0;
+        for (; found.cFileName[n] && n + 1 < sizeof(name); ++n)
+            name[n] = (char)found.cFileName[n];
+        name[n] = '\0';
+#else
+    DIR* d = opendir(dir.c_str());
+    if (!d)
+        return generations;
+    while (struct dirent* e = readdir(d))
+    {
+        const char* name = e->d_name;
+        const size_t n = strlen(name);
+#endif
+        unsigned generation = 0;
+        int consumed = 0;
+        if (n == 6 + 8 + 1 + extLength &&
+            sscanf(name, "world-%8u.%n", &generation, &consumed) == 1 && consumed == 15 &&
+            strcmp(name + consumed, extension) == 0)
+            generations.push_back(generation);
+#ifdef _WIN32
+    }
+    while (FindNextFileW(find, &found));
+    FindClose(find);
+#else
+    }
+    closedir(d);
+#endif
+    std::sort(generations.begin(), generations.end());
+    return generations;
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldBase — one mapped base file, immutable
+// ───────────────────────────────────────────────────────────────
+class WorldBase
+{
+public:
+    WorldBase() : m_header(nullptr), m_partitions(nullptr), m_records(nullptr), m_cells(nullptr) {}
+
+    // ───────────────────────────────────────────────────────────────
+    // Open — map path and check everything a query indexes by: section
+    // sizes, the partition table (sorted, in range, sane grids) and each
+    // partition's cell offsets (0 … count, never decreasing)
+    //
+    // Returns:
+    //   false = not a usable base
+    // ───────────────────────────────────────────────────────────────
+    bool Open(const WorldPath& path)
+    {
+        if (!m_file.Open(path.c_str()) || m_file.Size() < sizeof(WorldBaseHeader))
+            return false;
+
+        const uint8_t* data = m_file.Data();
+        const WorldBaseHeader* header = (const WorldBaseHeader*)data;
+        if (memcmp(header->magic, "AWKB", 4) != 0 || header->version != kWorldVersion)
+            return false;
+
+        // Section by section, so no size product can overflow
+        uint64_t remaining = m_file.Size() - sizeof(WorldBaseHeader);
+        if (header->partitions > remaining / sizeof(WorldPartition))
+            return false;
+        remaining -= (uint64_t)header->partitions * sizeof(WorldPartition);
+        if (header->records > remaining / sizeof(WorldSighting))
+            return false;
+        remaining -= header->records * sizeof(WorldSighting);
+        if (remaining != header->cells * sizeof(uint32_t))
+            return false;
+
+        const WorldPartition* partitions = (const WorldPartition*)(data + sizeof(WorldBaseHeader));
+        const WorldSighting* records = (const WorldSighting*)(partitions + header->partitions);
+        const uint32_t* cells = (const uint32_t*)(records + header->records);
+        for (uint32_t i = 0; i < header->partitions; ++i)
+        {
+            const WorldPartition& p = partitions[i];
+            if (i > 0 && (((uint64_t)partitions[i - 1].map << 16) | partitions[i - 1].kind) >=
+                         (((uint64_t)p.map << 16) | p.kind))
+                return false;
+            if ((uint64_t)p.firstRecord + p.count > header->records)
+                return false;
+            if (p.cols == 0 || p.rows == 0 || (uint64_t)p.cols * p.rows > kWorldMaxCells)
+                return false;
+            if (!std::isfinite(p.minX) || !std::isfinite(p.minY) || !std::isfinite(p.cellSize) || !(p.cellSize > 0.0f))
+                return false;
+
+            const uint64_t cellCount = (uint64_t)p.cols * p.rows;
+            if ((uint64_t)p.firstCell + cellCount + 1 > header->cells)
+                return false;
+            const uint32_t* offsets = cells + p.firstCell;
+            if (offsets[0] != 0 || offsets[cellCount] != p.count)
+                return false;
+            for (uint64_t c = 1; c <= cellCount; ++c)
+            {
+                if (offsets[c] < offsets[c - 1])
+                    return false;
+            }
+        }
+
+        m_header = header;
+        m_partitions = partitions;
+        m_records = records;
+        m_cells = cells;
+        return true;
+    }
+
+    uint32_t Generation() const { return m_header ? m_header->generation : 0; }
+    uint32_t PartitionCount() const { return m_header ? m_header->partitions : 0; }
+    uint64_t RecordCount() const { return m_header ? m_header->records : 0; }
+    uint64_t Bytes() const { return m_file.Size(); }
+    const WorldSighting* Records() const { return m_records; }
+
+    // Partition of (map, kind), or nullptr — binary search, table is sorted
+    const WorldPartition* Find(uint32_t map, uint16_t kind) const
+    {
+        if (!m_header)
+            return nullptr;
+        const uint64_t key = ((uint64_t)map << 16) | kind;
+        size_t lo = 0, hi = m_header->partitions;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            const uint64_t k = ((uint64_t)m_partitions[mid].map << 16) | m_partitions[mid].kind;
+            if (k < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < m_header->partitions && m_partitions[lo].map == map && m_partitions[lo].kind == kind)
+            return &m_partitions[lo];
+        return nullptr;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // QueryRadius — visit partition records within radius of (x, y)
+    //
+    // Args:
+    //   fn - callable(const WorldSighting&, float distSq)
+    // ───────────────────────────────────────────────────────────────
+    template <class Fn>
+    void QueryRadius(const WorldPartition& p, float x, float y, float radius, Fn fn) const
+    {
+        const float r2 = radius * radius;
+        const long c0 = WorldCell(x - radius, p.minX, p.cellSize, p.cols);
+        const long c1 = WorldCell(x + radius, p.minX, p.cellSize, p.cols);
+        const long r0 = WorldCell(y - radius, p.minY, p.cellSize, p.rows);
+        const long r1 = WorldCell(y + radius, p.minY, p.cellSize, p.rows);
+
+        const uint32_t* cells = m_cells + p.firstCell;
+        const WorldSighting* records = m_records + p.firstRecord;
+        for (long r = r0; r <= r1; ++r)
+        {
+            for (long c = c0; c <= c1; ++c)
+            {
+                const size_t cell = (size_t)r * p.cols + (size_t)c;
+                for (uint32_t i = cells[cell]; i < cells[cell + 1]; ++i)
+                {
+                    const float dx = records[i].x - x, dy = records[i].y - y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (d2 <= r2)
+                        fn(records[i], d2);
+                }
+            }
+        }
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Nearest — ring search, as SpatialGrid::Nearest
+    //
+    // Args:
+    //   entry  - 0 = any entry
+    //   bestD2 - [in/out] squared search radius → squared distance found
+    //
+    // Returns:
+    //   Closest record closer than bestD2, or nullptr
+    // ───────────────────────────────────────────────────────────────
+    const WorldSighting* Nearest(const WorldPartition& p, uint32_t entry, float x, float y, float& bestD2) const
+    {
+        // A query point off the grid starts from the nearest edge cell:
+        // clamping only moves it closer to every record, so the ring
+        // bound below still holds
+        const long cx = WorldCell(x, p.minX, p.cellSize, p.cols);
+        const long cy = WorldCell(y, p.minY, p.cellSize, p.rows);
+        const long edge = std::max(std::max(cx, (long)p.cols - 1 - cx),
+                                   std::max(cy, (long)p.rows - 1 - cy));
+        const float rings = sqrtf(bestD2) / p.cellSize + 1.0f;
+        const long maxRing = rings < (float)edge ? (long)rings : edge;
+
+        const uint32_t* cells = m_cells + p.firstCell;
+        const WorldSighting* records = m_records + p.firstRecord;
+        const WorldSighting* best = nullptr;
+
+        for (long ring = 0; ring <= maxRing; ++ring)
+        {
+            // Every record in ring k is at least (k - 1) cells away
+            if (best && ring > 0)
+            {
+                const float minDist = (float)(ring - 1) * p.cellSize;
+                if (minDist * minDist > bestD2)
+                    break;
+            }
+            for (long r = cy - ring; r <= cy + ring; ++r)
+            {
+                if (r < 0 || r >= (long)p.rows)
+                    continue;
+
+                const bool edgeRow = (r == cy - ring || r == cy + ring);
+                const long step = edgeRow || ring == 0 ? 1 : 2 * ring;
+
+                for (long c = cx - ring; c <= cx + ring; c += step)
+                {
+                    if (c < 0 || c >= (long)p.cols)
+                        continue;
+
+                    const size_t cell = (size_t)r * p.cols + (size_t)c;
+                    for (uint32_t i = cells[cell]; i < cells[cell + 1]; ++i)
+                    {
+                        const WorldSighting& s = records[i];
+                        const float dx = s.x - x, dy = s.y - y;
+                        const float d2 = dx * dx + dy * dy;
+                        if (d2 <= bestD2 && (entry == 0 || s.entry == entry))
+                        {
+                            best = &s;
+                            bestD2 = d2;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    WorldBase(const WorldBase&) = delete;
+    WorldBase& operator=(const WorldBase&) = delete;
+
+    MappedFile m_file;
+    const WorldBaseHeader* m_header;       // null until a valid Open
+    const WorldPartition* m_partitions;
+    const WorldSighting* m_records;
+    const uint32_t* m_cells;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// MERGE + BUILD (compaction, no lock held)
+// ═══════════════════════════════════════════════════════════════
+
+inline bool WorldSameKey(const WorldSighting& a, const WorldSighting& b)
+{
+    return a.map == b.map && a.kind == b.kind && a.entry == b.entry;
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldMerge — fold sightings of one entry within kWorldMergeRadius
+// into the first (lowest x) one: counts add, last seen is the latest
+// ───────────────────────────────────────────────────────────────
+inline void WorldMerge(std::vector<WorldSighting>& records)
+{
+    std::sort(records.begin(), records.end(), [](const WorldSighting& a, const WorldSighting& b) {
+        if (a.map != b.map) return a.map < b.map;
+        if (a.kind != b.kind) return a.kind < b.kind;
+        if (a.entry != b.entry) return a.entry < b.entry;
+        return a.x < b.x;
+    });
+
+    const float r2 = kWorldMergeRadius * kWorldMergeRadius;
+    size_t out = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const WorldSighting& s = records[i];
+        bool merged = false;
+        // Outputs of this key keep their x order — only the window
+        // within the merge radius can match
+        for (size_t j = out; j-- > 0 && WorldSameKey(records[j], s) && records[j].x >= s.x - kWorldMergeRadius;)
+        {
+            WorldSighting& anchor = records[j];
+            const float dx = anchor.x - s.x, dy = anchor.y - s.y;
+            if (dx * dx + dy * dy <= r2)
+            {
+                anchor.seenCount += s.seenCount;
+                if (s.seenAt > anchor.seenAt)
+                    anchor.seenAt = s.seenAt;
+                anchor.flags |= s.flags;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged)
+            records[out++] = s;
+    }
+    records.resize(out);
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldBuildBase — merged records → base file image
+//
+// Notes:
+//   Per (map, kind) partition: bounding box, cell size doubled until
+//   the grid fits kWorldMaxCells (and ~2 cells per record), then a
+//   counting sort of the records by cell. Records must be WorldInRange
+// ───────────────────────────────────────────────────────────────
+inline void WorldBuildBase(const std::vector<WorldSighting>& merged, uint32_t generation, std::vector<uint8_t>& image)
+{
+    std::vector<WorldPartition> partitions;
+    std::vector<WorldSighting> records(merged.size());
+    std::vector<uint32_t> cells;
+
+    for (size_t begin = 0; begin < merged.size();)
+    {
+        size_t end = begin + 1;
+        while (end < merged.size() && merged[end].map == merged[begin].map && merged[end].kind == merged[begin].kind)
+            ++end;
+        const size_t count = end - begin;
+
+        WorldPartition p;
+        memset(&p, 0, sizeof(p));
+        p.map = merged[begin].map;
+        p.kind = merged[begin].kind;
+        p.firstRecord = (uint32_t)begin;
+        p.count = (uint32_t)count;
+        p.firstCell = (uint32_t)cells.size();
+
+        float minX = merged[begin].x, maxX = minX, minY = merged[begin].y, maxY = minY;
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            minX = std::min(minX, merged[i].x);
+            maxX = std::max(maxX, merged[i].x);
+            minY = std::min(minY, merged[i].y);
+            maxY = std::max(maxY, merged[i].y);
+        }
+
+        const size_t cellLimit = std::min<size_t>(kWorldMaxCells, std::max<size_t>(16, 2 * count));
+        p.cellSize = kWorldCellSize;
+        for (;;)
+        {
+            const float spanX = (maxX - minX) / p.cellSize;
+            const float spanY = (maxY - minY) / p.cellSize;
+            if (spanX < (float)cellLimit && spanY < (float)cellLimit)
+            {
+                p.cols = (uint32_t)spanX + 1;
+                p.rows = (uint32_t)spanY + 1;
+                if ((size_t)p.cols * p.rows <= cellLimit)
+                    break;
+            }
+            p.cellSize *= 2.0f;
+        }
+        p.minX = minX;
+        p.minY = minY;
+
+        // Counting sort by cell: count → prefix sum → scatter
+        const size_t cellCount = (size_t)p.cols * p.rows;
+        cells.resize(p.firstCell + cellCount + 1, 0);
+        uint32_t* start = &cells[p.firstCell];
+        std::vector<uint32_t> cellOf(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const WorldSighting& s = merged[begin + i];
+            const uint32_t c = WorldCell(s.x, minX, p.cellSize, p.cols);
+            const uint32_t r = WorldCell(s.y, minY, p.cellSize, p.rows);
+            cellOf[i] = r * p.cols + c;
+            ++start[cellOf[i] + 1];
+        }
+        for (size_t c = 1; c <= cellCount; ++c)
+            start[c] += start[c - 1];
+
+        std::vector<uint32_t> cursor(start, start + cellCount);
+        for (size_t i = 0; i < count; ++i)
+            records[begin + cursor[cellOf[i]]++] = merged[begin + i];
+
+        partitions.push_back(p);
+        begin = end;
+    }
+
+    WorldBaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "AWKB", 4);
+    header.version = kWorldVersion;
+    header.generation = generation;
+    header.partitions = (uint32_t)partitions.size();
+    header.records = records.size();
+    header.cells = cells.size();
+
+    image.resize(sizeof(header) + partitions.size() * sizeof(WorldPartition) +
+                 records.size() * sizeof(WorldSighting) + cells.size() * sizeof(uint32_t));
+    uint8_t* p = image.data();
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (!partitions.empty())
+        memcpy(p, partitions.data(), partitions.size() * sizeof(WorldPartition));
+    p += partitions.size() * sizeof(WorldPartition);
+    if (!records.empty())
+        memcpy(p, records.data(), records.size() * sizeof(WorldSighting));
+    p += records.size() * sizeof(WorldSighting);
+    if (!cells.empty())
+        memcpy(p, cells.data(), cells.size() * sizeof(uint32_t));
+}
+
+// ═══════════════════════════════════════════════════════════════
+// WorldStore
+// ═══════════════════════════════════════════════════════════════
+class WorldStore
+{
+public:
+    WorldStore() : m_log(nullptr), m_logGeneration(0), m_open(false), m_stop(false),
+                   m_compactRequested(false), m_compacting(false)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    ~WorldStore() { Close(); }
+
+    // ───────────────────────────────────────────────────────────────
+    // Open — map the newest base, replay newer logs, start a new log
+    // and the compactor
+    //
+    // Returns:
+    //   false if the directory cannot be created or the log not opened
+    // ───────────────────────────────────────────────────────────────
+    bool Open(const WorldPathChar* dir)
+    {
+        Close();
+        if (!dir || !*dir)
+            return false;
+        m_dir = dir;
+#ifdef _WIN32
+        CreateDirectoryW(dir, NULL);
+#else
+        mkdir(dir, 0755);
+#endif
+
+        // Newest base that maps and validates; anything older is garbage
+        std::shared_ptr<WorldBase> base;
+        const std::vector<uint32_t> bases = WorldListFiles(m_dir, "dat");
+        for (size_t i = bases.size(); i-- > 0 && !base;)
+        {
+            std::shared_ptr<WorldBase> candidate(new WorldBase());
+            if (candidate->Open(WorldFileName(m_dir, bases[i], "dat")) && candidate->Generation() == bases[i])
+                base = candidate;
+        }
+        if (!base)
+            base.reset(new WorldBase());
+        const uint32_t generation = base->Generation();
+
+        for (size_t i = 0; i < bases.size(); ++i)
+            if (bases[i] != generation)
+                WorldDeleteFile(WorldFileName(m_dir, bases[i], "dat"));
+        const std::vector<uint32_t> temps = WorldListFiles(m_dir, "tmp");
+        for (size_t i = 0; i < temps.size(); ++i)
+            WorldDeleteFile(WorldFileName(m_dir, temps[i], "tmp"));
+
+        // Logs at or above the base generation are not in it yet
+        std::vector<WorldSighting> tail;
+        uint32_t next = generation;
+        const std::vector<uint32_t> logs = WorldListFiles(m_dir, "log");
+        for (size_t i = 0; i < logs.size(); ++i)
+        {
+            const WorldPath path = WorldFileName(m_dir, logs[i], "log");
+            // Below the base: already merged. Empty: a session that saw
+            // nothing new — nothing to keep either
+            if (logs[i] < generation || Replay(path, tail) == 0)
+                WorldDeleteFile(path);
+            if (logs[i] >= next)
+                next = logs[i] + 1;
+        }
+
+        FILE* log = WorldOpenFile(WorldFileName(m_dir, next, "log"), "ab");
+        if (!log)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_base = base;
+            m_tail.swap(tail);
+            m_log = log;
+            m_logGeneration = next;
+            m_open = true;
+        }
+
+        m_stop = false;
+        m_compactRequested = m_tail.size() >= kWorldCompactRecords;
+        m_worker = std::thread(&WorldStore::CompactLoop, this);
+        return true;
+    }
+
+    // Stops the compactor and closes the log; the tail stays on disk
+    // for the next Open
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_workerLock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable())
+            m_worker.join();
+
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_log)
+            fclose(m_log);
+        m_log = nullptr;
+        m_base.reset();
+        m_tail.clear();
+        m_open = false;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Record — one sighting (seenCount is forced to 1)
+    //
+    // Returns:
+    //   1 logged, 0 covered by a recent sighting of the same spot,
+    //   -1 store not open / write failed / position not WorldInRange
+    // ───────────────────────────────────────────────────────────────
+    int Record(const WorldSighting& sighting)
+    {
+        if (!WorldInRange(sighting))
+            return -1;
+
+        WorldSighting s = sighting;
+        s.seenCount = 1;
+
+        bool compact = false;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (!m_open || !m_log)
+                return -1;
+
+            const WorldSighting* known = FindSpot(s);
+            if (known && s.seenAt < known->seenAt + kWorldRefreshSeconds)
+            {
+                ++m_stats.deduplicated;
+                return 0;
+            }
+
+            WorldLogFrame frame;
+            frame.sighting = s;
+            frame.check = WorldChecksum(s);
+            if (fwrite(&frame, sizeof(frame), 1, m_log) != 1 || fflush(m_log) != 0)
+                return -1;
+
+            m_tail.push_back(s);
+            ++m_stats.recorded;
+            compact = m_tail.size() >= kWorldCompactRecords;
+        }
+        if (compact)
+            RequestCompaction();
+        return 1;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Nearest — closest known spot of kind (and entry, 0 = any)
+    //
+    // Returns:
+    //   true and out = the spot, if one lies within maxRadius
+    // ───────────────────────────────────────────────────────────────
+    bool Nearest(uint32_t map, uint16_t kind, uint32_t entry, float x, float y, float maxRadius,
+                 WorldSighting& out)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ++m_stats.queries;
+        if (!m_open || !WorldQueryValid(x, y, maxRadius))
+            return false;
+
+        float bestD2 = maxRadius * maxRadius;
+        const WorldSighting* best = nullptr;
+        if (const WorldPartition* p = m_base->Find(map, kind))
+            best = m_base->Nearest(*p, entry, x, y, bestD2);
+
+        for (size_t i = 0; i < m_tail.size(); ++i)
+        {
+            const WorldSighting& s = m_tail[i];
+            if (s.map != map || s.kind != kind || (entry != 0 && s.entry != entry))
+                continue;
+            const float dx = s.x - x, dy = s.y - y;
+            const float d2 = dx * dx + dy * dy;
+            if (d2 <= bestD2)
+            {
+                best = &s;
+                bestD2 = d2;
+            }
+        }
+
+        if (best)
+            out = *best;
+        return best != nullptr;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // QueryRadius — known spots of kind (and entry) within radius
+    //
+    // Returns:
+    //   Spots written to out (at most max, in no particular order)
+    // ───────────────────────────────────────────────────────────────
+    size_t QueryRadius(uint32_t map, uint16_t kind, uint32_t entry, float x, float y, float radius,
+                       WorldSighting* out, size_t max)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        ++m_stats.queries;
+        if (!m_open || !out || !WorldQueryValid(x, y, radius))
+            return 0;
+
+        size_t n = 0;
+        if (const WorldPartition* p = m_base->Find(map, kind))
+        {
+            m_base->QueryRadius(*p, x, y, radius, [&](const WorldSighting& s, float) {
+                if (n < max && (entry == 0 || s.entry == entry))
+                    out[n++] = s;
+            });
+        }
+
+        const float r2 = radius * radius;
+        for (size_t i = 0; i < m_tail.size() && n < max; ++i)
+        {
+            const WorldSighting& s = m_tail[i];
+            if (s.map != map || s.kind != kind || (entry != 0 && s.entry != entry))
+                continue;
+            const float dx = s.x - x, dy = s.y - y;
+            if (dx * dx + dy * dy <= r2)
+                out[n++] = s;
+        }
+        return n;
+    }
+
+    // Wakes the compactor (no-op if the tail is empty when it runs)
+    void RequestCompaction()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_workerLock);
+            m_compactRequested = true;
+        }
+        m_wake.notify_one();
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // CompactNow — merge base + tail into a new base on this thread
+    //
+    // Returns:
+    //   false if there was nothing to merge or a file step failed (the
+    //   old base and the logs stay valid either way)
+    // ───────────────────────────────────────────────────────────────
+    bool CompactNow()
+    {
+        std::lock_guard<std::mutex> compactGuard(m_compactLock);
+        const uint64_t start = PlatformNowNs();
+
+        // 1. Snapshot the tail, switch appends to a new log
+        std::shared_ptr<WorldBase> base;
+        std::vector<WorldSighting> merged;
+        size_t snapshot = 0;
+        uint32_t generation = 0;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (!m_open || m_tail.empty())
+                return false;
+
+            FILE* log = WorldOpenFile(WorldFileName(m_dir, m_logGeneration + 1, "log"), "ab");
+            if (!log)
+                return false;
+            fclose(m_log);
+            m_log = log;
+            ++m_logGeneration;
+
+            base = m_base;
+            merged = m_tail;
+            snapshot = m_tail.size();
+            generation = m_logGeneration;
+            m_compacting = true;
+        }
+
+        // 2. Merge and write world-<generation>.dat (no lock held)
+        const WorldSighting* records = base->Records();
+        merged.insert(merged.end(), records, records + base->RecordCount());
+        // Open does not read the records; a damaged one is dropped here,
+        // not built into the grid
+        merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                    [](const WorldSighting& s) { return !WorldInRange(s); }),
+                     merged.end());
+        WorldMerge(merged);
+
+        std::vector<uint8_t> image;
+        WorldBuildBase(merged, generation, image);
+
+        const WorldPath temp = WorldFileName(m_dir, generation, "tmp");
+        const WorldPath path = WorldFileName(m_dir, generation, "dat");
+        std::shared_ptr<WorldBase> next(new WorldBase());
+        FILE* file = WorldOpenFile(temp, "wb");
+        const bool written = file && fwrite(image.data(), 1, image.size(), file) == image.size();
+        if (file && fclose(file) != 0)
+            file = nullptr;
+        if (!written || !file || !WorldRenameFile(temp, path) || !next->Open(path))
+        {
+            WorldDeleteFile(temp);
+            m_compacting = false;
+            return false;
+        }
+
+        // 3. Swap the mapping, drop the merged prefix of the tail
+        const uint32_t oldGeneration = base->Generation();
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_base = next;
+            m_tail.erase(m_tail.begin(), m_tail.begin() + snapshot);
+            ++m_stats.compactions;
+            m_stats.lastCompactNs = PlatformNowNs() - start;
+            m_compacting = false;
+        }
+
+        // 4. Unmap the old base, then delete what the new one contains
+        base.reset();
+        if (oldGeneration != 0)
+            WorldDeleteFile(WorldFileName(m_dir, oldGeneration, "dat"));
+        const std::vector<uint32_t> logs = WorldListFiles(m_dir, "log");
+        for (size_t i = 0; i < logs.size() && logs[i] < generation; ++i)
+            WorldDeleteFile(WorldFileName(m_dir, logs[i], "log"));
+        return true;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPORTING
+    // ═══════════════════════════════════════════════════════════════
+
+    void Stats(WorldStoreStats& out)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        out = m_stats;
+        out.open = m_open ? 1u : 0u;
+        out.compacting = m_compacting ? 1u : 0u;
+        out.tailRecords = m_tail.size();
+        if (m_base)
+        {
+            out.baseRecords = m_base->RecordCount();
+            out.baseBytes = m_base->Bytes();
+            out.partitions = m_base->PartitionCount();
+            out.generation = m_base->Generation();
+        }
+    }
+
+private:
+    WorldStore(const WorldStore&) = delete;
+    WorldStore& operator=(const WorldStore&) = delete;
+
+    // Appends every intact frame of a log; a torn or corrupt frame ends
+    // it, an intact one out of range is skipped. Returns the frames
+    // appended
+    static size_t Replay(const WorldPath& path, std::vector<WorldSighting>& tail)
+    {
+        FILE* file = WorldOpenFile(path, "rb");
+        if (!file)
+            return 0;
+        size_t frames = 0;
+        WorldLogFrame frame;
+        while (fread(&frame, sizeof(frame), 1, file) == 1 && frame.check == WorldChecksum(frame.sighting))
+        {
+            if (!WorldInRange(frame.sighting))
+                continue;
+            tail.push_back(frame.sighting);
+            ++frames;
+        }
+        fclose(file);
+        return frames;
+    }
+
+    // Caller holds m_lock; the latest known spot of s's entry within
+    // kWorldMergeRadius, base or tail
+    const WorldSighting* FindSpot(const WorldSighting& s) const
+    {
+        const WorldSighting* known = nullptr;
+        const float r2 = kWorldMergeRadius * kWorldMergeRadius;
+        for (size_t i = m_tail.size(); i-- > 0;)
+        {
+            const WorldSighting& t = m_tail[i];
+            const float dx = t.x - s.x, dy = t.y - s.y;
+            if (WorldSameKey(t, s) && dx * dx + dy * dy <= r2)
+            {
+                known = &t;
+                break;
+            }
+        }
+
+        if (const WorldPartition* p = m_base->Find(s.map, s.kind))
+        {
+            m_base->QueryRadius(*p, s.x, s.y, kWorldMergeRadius, [&](const WorldSighting& b, float) {
+                if (b.entry == s.entry && (!known || b.seenAt > known->seenAt))
+                    known = &b;
+            });
+        }
+        return known;
+    }
+
+    void CompactLoop()
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_workerLock);
+                m_wake.wait(lock, [this] { return m_stop || m_compactRequested; });
+                if (m_stop)
+                    return;
+                m_compactRequested = false;
+            }
+            CompactNow();
+        }
+    }
+
+    WorldPath m_dir;
+    std::mutex m_lock;                          // base pointer, tail, log, stats
+    std::shared_ptr<WorldBase> m_base;
+    std::vector<WorldSighting> m_tail;          // logged since the base was built
+    FILE* m_log;
+    uint32_t m_logGeneration;
+    bool m_open;
+    WorldStoreStats m_stats;
+
+    std::mutex m_compactLock;                   // one compaction at a time
+    std::mutex m_workerLock;
+    std::condition_variable m_wake;
+    std::thread m_worker;
+    bool m_stop;
+    bool m_compactRequested;
+    std::atomic<bool> m_compacting;
+};
@@ -0,0 +1,529 @@
+﻿// Bench.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// RemoteAchikoBench harness — runner, statistics, JSON I/O, comparison
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "Platform.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(_MSC_VER)
+volatile uintptr_t g_benchSink = 0;
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// REGISTRY / STATE
+// ═══════════════════════════════════════════════════════════════
+
+std::vector<BenchCase>& BenchRegistry()
+{
+    static std::vector<BenchCase> s_cases;  // function-local: safe across TU init order
+    return s_cases;
+}
+
+void BenchState::ResetTimer()
+{
+    m_startNs = PlatformNowNs();
+}
+
+void BenchState::SetCounter(const char* name, double value)
+{
+    for (size_t i = 0; i < m_counters.size(); ++i)
+    {
+        if (m_counters[i].first == name)
+        {
+            m_counters[i].second = value;
+            return;
+        }
+    }
+    m_counters.push_back(std::make_pair(std::string(name), value));
+}
+
+const BenchMetric* BenchResult::Find(const std::string& key) const
+{
+    for (size_t i = 0; i < metrics.size(); ++i)
+    {
+        if (metrics[i].key == key)
+            return &metrics[i];
+    }
+    return nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// STATISTICS
+// ═══════════════════════════════════════════════════════════════
+
+static double Percentile(const std::vector<uint64_t>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    const size_t idx = (size_t)ceil(p / 100.0 * (double)sorted.size());
+    return (double)sorted[idx == 0 ? 0 : (idx > sorted.size() ? sorted.size() - 1 : idx - 1)];
+}
+
+static double Median(std::vector<double> v)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return (n & 1) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RUNNER
+// ═══════════════════════════════════════════════════════════════
+
+// ───────────────────────────────────────────────────────────────
+// Calibrate — smallest power-of-two iteration count that runs for
+// at least minTimeNs / 8, then scaled up to ~minTimeNs
+// ───────────────────────────────────────────────────────────────
+static uint64_t Calibrate(const BenchCase& c, uint64_t minTimeNs)
+{
+    uint64_t n = 1;
+    for (;;)
+    {
+        BenchState state(n);
+        const uint64_t t0 = PlatformNowNs();
+        c.fn(state);
+        const uint64_t elapsed = PlatformNowNs() - (state.StartNs() ? state.StartNs() : t0);
+
+        if (elapsed >= minTimeNs / 8 || n >= (1ULL << 34))
+        {
+            const double perOp = (double)elapsed / (double)n;
+            const double wanted = perOp > 0 ? (double)minTimeNs / perOp : (double)n;
+            return wanted < 1.0 ? 1 : (uint64_t)wanted;
+        }
+        n *= 2;
+    }
+}
+
+static BenchResult RunCase(const BenchCase& c, const BenchOptions& options)
+{
+    BenchResult result;
+    result.name = c.name;
+    result.repetitions = options.repetitions;
+    result.itemsPerSec = 0;
+    result.bytesPerSec = 0;
+
+    const bool samplesMode = (c.flags & Bench_Samples) != 0;
+    const uint64_t iterations = samplesMode ? 1 : Calibrate(c, options.minTimeNs);
+    result.iterations = iterations;
+
+    std::vector<double> perOp;
+    std::vector<uint64_t> samples;
+    std::vector<std::pair<std::string, double> > counters;
+    uint64_t items = 0, bytes = 0;
+
+    for (uint32_t rep = 0; rep < options.repetitions; ++rep)
+    {
+        BenchState state(iterations);
+        const uint64_t t0 = PlatformNowNs();
+        c.fn(state);
+        const uint64_t elapsed = PlatformNowNs() - (state.StartNs() ? state.StartNs() : t0);
+
+        perOp.push_back((double)elapsed / (double)iterations);
+        samples.insert(samples.end(), state.Samples().begin(), state.Samples().end());
+        counters = state.Counters();
+        items = state.ItemsPerIteration();
+        bytes = state.BytesPerIteration();
+    }
+
+    const double medianPerOp = Median(perOp);
+
+    if (!samplesMode)
+    {
+        BenchMetric m;
+        m.key = "ns_per_op";   m.value = medianPerOp;                                     result.metrics.push_back(m);
+        m.key = "ns_per_op_min"; m.value = *std::min_element(perOp.begin(), perOp.end()); result.metrics.push_back(m);
+
+        if (items && medianPerOp > 0)
+            result.itemsPerSec = (double)items * 1e9 / medianPerOp;
+        if (bytes && medianPerOp > 0)
+            result.bytesPerSec = (double)bytes * 1e9 / medianPerOp;
+    }
+
+    if (!samples.empty())
+    {
+        std::sort(samples.begin(), samples.end());
+        BenchMetric m;
+        m.key = "p50_ns";  m.value = Percentile(samples, 50);   result.metrics.push_back(m);
+        m.key = "p90_ns";  m.value = Percentile(samples, 90);   result.metrics.push_back(m);
+        m.key = "p99_ns";  m.value = Percentile(samples, 99);   result.metrics.push_back(m);
+        m.key = "p999_ns"; m.value = Percentile(samples, 99.9); result.metrics.push_back(m);
+        m.key = "max_ns";  m.value = (double)samples.back();   result.metrics.push_back(m);
+    }
+
+    for (size_t i = 0; i < counters.size(); ++i)
+    {
+        BenchMetric m;
+        m.key = counters[i].first;
+        m.value = counters[i].second;
+        result.metrics.push_back(m);
+    }
+
+    return result;
+}
+
+std::vector<BenchResult> BenchRunAll(const BenchOptions& options)
+{
+    std::vector<BenchCase> cases = BenchRegistry();
+    std::sort(cases.begin(), cases.end(),
+        [](const BenchCase& a, const BenchCase& b) { return strcmp(a.name, b.name) < 0; });
+
+    std::vector<BenchResult> results;
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        if (!options.filter.empty() && strstr(cases[i].name, options.filter.c_str()) == nullptr)
+            continue;
+
+        fprintf(stderr, "[bench] %-40s ", cases[i].name);
+        fflush(stderr);
+
+        BenchResult r = RunCase(cases[i], options);
+        results.push_back(r);
+
+        const BenchMetric* primary = r.Find("ns_per_op");
+        if (!primary)
+            primary = r.Find("p50_ns");
+        const BenchMetric* p99 = r.Find("p99_ns");
+
+        fprintf(stderr, "%12.2f ns", primary ? primary->value : 0.0);
+        if (p99)
+            fprintf(stderr, "   p99 %12.0f ns", p99->value);
+        if (r.itemsPerSec > 0)
+            fprintf(stderr, "   %10.2f M items/s", r.itemsPerSec / 1e6);
+        fprintf(stderr, "\n");
+    }
+    return results;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// JSON OUTPUT
+// ═══════════════════════════════════════════════════════════════
+
+static void AppendEscaped(std::string& out, const std::string& s)
+{
+    out += '"';
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        const char ch = s[i];
+        if (ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+        else if ((unsigned char)ch < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", ch); out += buf; }
+        else out += ch;
+    }
+    out += '"';
+}
+
+static void AppendNumber(std::string& out, double v)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.3f", v);
+    out += buf;
+}
+
+static void AppendInteger(std::string& out, uint64_t v)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+    out += buf;
+}
+
+static const char* HostOs()
+{
+#ifdef _WIN32
+    return "windows";
+#else
+    return "linux";
+#endif
+}
+
+static const char* HostArch()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    return "x86_64";
+#elif defined(_M_IX86) || defined(__i386__)
+    return "x86";
+#else
+    return "unknown";
+#endif
+}
+
+std::string BenchToJson(const std::vector<BenchResult>& results)
+{
+    std::string out;
+    out += "{\n  \"suite\": \"RemoteAchikoBench\",\n  \"schema\": 1,\n";
+    out += "  \"host\": { \"os\": \""; out += HostOs();
+    out += "\", \"arch\": \""; out += HostArch();
+    out += "\", \"cpus\": "; AppendInteger(out, PlatformCpuCount());
+    out += " },\n  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& r = results[i];
+        out += "    { \"name\": "; AppendEscaped(out, r.name);
+        out += ", \"iterations\": "; AppendInteger(out, r.iterations);
+        out += ", \"repetitions\": "; AppendInteger(out, r.repetitions);
+        if (r.itemsPerSec > 0) { out += ", \"items_per_sec\": "; AppendNumber(out, r.itemsPerSec); }
+        if (r.bytesPerSec > 0) { out += ", \"bytes_per_sec\": "; AppendNumber(out, r.bytesPerSec); }
+        out += ",\n      \"metrics\": {";
+        for (size_t m = 0; m < r.metrics.size(); ++m)
+        {
+            out += m ? ", " : " ";
+            AppendEscaped(out, r.metrics[m].key);
+            out += ": ";
+            AppendNumber(out, r.metrics[m].value);
+        }
+        out += " } }";
+        out += (i + 1 < results.size()) ? ",\n" : "\n";
+    }
+
+    out += "  ]\n}\n";
+    return out;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// JSON INPUT — just enough to read our own result files back
+// ═══════════════════════════════════════════════════════════════
+
+namespace
+{
+    struct JsonReader
+    {
+        const char* p;
+        const char* end;
+        std::string error;
+
+        void SkipWs() { while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p; }
+        bool Expect(char ch) { SkipWs(); if (p < end && *p == ch) { ++p; return true; } error = std::string("expected '") + ch + "'"; return false; }
+        bool Peek(char ch) { SkipWs(); return p < end && *p == ch; }
+
+        bool String(std::string& out)
+        {
+            if (!Expect('"')) return false;
+            out.clear();
+            while (p < end && *p != '"')
+            {
+                if (*p == '\\' && p + 1 < end) { ++p; if (*p == 'u') { p += 4; out += '?'; } else out += *p; ++p; }
+                else out += *p++;
+            }
+            return Expect('"');
+        }
+
+        bool Number(double& out)
+        {
+            SkipWs();
+            char* stop = nullptr;
+            out = strtod(p, &stop);
+            if (stop == p) { error = "expected number"; return false; }
+            p = stop;
+            return true;
+        }
+
+        // Skips any value (used for fields we don't need, e.g. "host")
+        bool Skip()
+        {
+            SkipWs();
+            if (p >= end) { error = "unexpected end"; return false; }
+            if (*p == '"') { std::string s; return String(s); }
+            if (*p == '{' || *p == '[')
+            {
+                const char close = (*p == '{') ? '}' : ']';
+                const bool isObject = (*p == '{');
+                ++p;
+                if (Peek(close)) { ++p; return true; }
+                for (;;)
+                {
+                    if (isObject) { std::string k; if (!String(k) || !Expect(':')) return false; }
+                    if (!Skip()) return false;
+                    if (Peek(',')) { ++p; continue; }
+                    return Expect(close);
+                }
+            }
+            if (!strncmp(p, "true", 4)) { p += 4; return true; }
+            if (!strncmp(p, "false", 5)) { p += 5; return true; }
+            if (!strncmp(p, "null", 4)) { p += 4; return true; }
+            double d; return Number(d);
+        }
+
+        bool Result(BenchResult& r)
+        {
+            r.iterations = 0; r.repetitions = 0; r.itemsPerSec = 0; r.bytesPerSec = 0;
+            if (!Expect('{')) return false;
+            for (;;)
+            {
+                std::string key;
+                if (!String(key) || !Expect(':')) return false;
+
+                if (key == "name") { if (!String(r.name)) return false; }
+                else if (key == "iterations") { double d; if (!Number(d)) return false; r.iterations = (uint64_t)d; }
+                else if (key == "repetitions") { double d; if (!Number(d)) return false; r.repetitions = (uint32_t)d; }
+                else if (key == "items_per_sec") { if (!Number(r.itemsPerSec)) return false; }
+                else if (key == "bytes_per_sec") { if (!Number(r.bytesPerSec)) return false; }
+                else if (key == "metrics")
+                {
+                    if (!Expect('{')) return false;
+                    if (Peek('}')) ++p;
+                    else for (;;)
+                    {
+                        BenchMetric m;
+                        if (!String(m.key) || !Expect(':') || !Number(m.value)) return false;
+                        r.metrics.push_back(m);
+                        if (Peek(',')) { ++p; continue; }
+                        if (!Expect('}')) return false;
+                        break;
+                    }
+                }
+                else if (!Skip()) return false;
+
+                if (Peek(',')) { ++p; continue; }
+                return Expect('}');
+            }
+        }
+
+        bool Document(std::vector<BenchResult>& out)
+        {
+            if (!Expect('{')) return false;
+            for (;;)
+            {
+                std::string key;
+                if (!String(key) || !Expect(':')) return false;
+
+                if (key == "results")
+                {
+                    if (!Expect('[')) return false;
+                    if (Peek(']')) ++p;
+                    else for (;;)
+                    {
+                        BenchResult r;
+                        if (!Result(r)) return false;
+                        out.push_back(r);
+                        if (Peek(',')) { ++p; continue; }
+                        if (!Expect(']')) return false;
+                        break;
+                    }
+                }
+                else if (!Skip()) return false;
+
+                if (Peek(',')) { ++p; continue; }
+                return Expect('}');
+            }
+        }
+    };
+}
+
+bool BenchLoadJson(const std::string& path, std::vector<BenchResult>& out, std::string& error)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        text.append(buf, n);
+    fclose(f);
+
+    JsonReader reader;
+    reader.p = text.data();
+    reader.end = text.data() + text.size();
+    if (!reader.Document(out))
+    {
+        error = path + ": " + reader.error;
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMPARISON
+// ═══════════════════════════════════════════════════════════════
+
+// Tails (p99.9, max) and free-form counters are too noisy to gate on
+static bool IsGatedMetric(const std::string& key)
+{
+    return key == "ns_per_op" || key == "p50_ns" || key == "p99_ns";
+}
+
+// ───────────────────────────────────────────────────────────────
+// BenchCompare — diff current results against a stored baseline
+//
+// Behavior:
+//   • Compares ns_per_op, p50_ns and p99_ns when present in both files
+//   • delta% = (current - baseline) / baseline * 100 (lower is better)
+//   • delta% > threshold → REGRESSION, < -threshold → improved
+//   • Cases missing on either side are listed but never fail the run
+// ───────────────────────────────────────────────────────────────
+int BenchCompare(const std::vector<BenchResult>& baseline,
+                 const std::vector<BenchResult>& current,
+                 double thresholdPct)
+{
+    int regressions = 0;
+    printf("%-40s %-14s %14s %14s %9s\n", "case", "metric", "baseline", "current", "delta");
+
+    for (size_t i = 0; i < current.size(); ++i)
+    {
+        const BenchResult& cur = current[i];
+        const BenchResult* base = nullptr;
+        for (size_t j = 0; j < baseline.size(); ++j)
+        {
+            if (baseline[j].name == cur.name)
+            {
+                base = &baseline[j];
+                break;
+            }
+        }
+
+        if (!base)
+        {
+            printf("%-40s (new — no baseline)\n", cur.name.c_str());
+            continue;
+        }
+
+        for (size_t m = 0; m < cur.metrics.size(); ++m)
+        {
+            if (!IsGatedMetric(cur.metrics[m].key))
+                continue;
+
+            const BenchMetric* b = base->Find(cur.metrics[m].key);
+            if (!b || b->value <= 0)
+                continue;
+
+            const double delta = (cur.metrics[m].value - b->value) / b->value * 100.0;
+            const char* verdict = "";
+            if (delta > thresholdPct)
+            {
+                verdict = "  REGRESSION";
+                ++regressions;
+            }
+            else if (delta < -thresholdPct)
+            {
+                verdict = "  improved";
+            }
+
+            printf("%-40s %-14s %14.2f %14.2f %+8.1f%%%s\n",
+                cur.name.c_str(), cur.metrics[m].key.c_str(), b->value, cur.metrics[m].value, delta, verdict);
+        }
+    }
+
+    for (size_t j = 0; j < baseline.size(); ++j)
+    {
+        bool found = false;
+        for (size_t i = 0; i < current.size() && !found; ++i)
+            found = (current[i].name == baseline[j].name);
+        if (!found)
+            printf("%-40s (not run)\n", baseline[j].name.c_str());
+    }
+
+    printf("\n%d regression(s) beyond %.1f%%\n", regressions, thresholdPct);
+    return regressions;
+}
@@ -0,0 +1,165 @@
+﻿// Bench.h
+// ─────────────────────────────────────────────────────────────────────────────
+// RemoteAchikoBench — minimal benchmark harness for the native cores
+//
+// Responsibilities:
+// • Self-registering benchmark cases (BENCH_CASE macro)
+// • Iteration calibration + repeated runs → median/min/max ns per op
+// • Optional per-event latency samples → p50/p90/p99/p99.9/max
+// • Machine-readable JSON results and baseline comparison
+//
+// Architecture:
+// • Each case is a plain function taking a BenchState&
+// • Throughput cases loop state.Iterations() times; the harness times the
+//   call from state.ResetTimer() (or entry) to return and divides
+// • Latency cases call state.RecordSample(ns) per event and are flagged
+//   Bench_Samples so the harness reports the distribution instead
+//
+// Critical Design Decisions:
+// • No third-party benchmark library — must build with the same toolsets
+//   as RemoteAchiko (v142 on Windows, plain g++/clang on Linux)
+// • Every metric stored is "lower is better" so one comparison rule works
+//   for the whole file
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// ═══════════════════════════════════════════════════════════════
+// BenchState — handed to every case on every repetition
+// ═══════════════════════════════════════════════════════════════
+class BenchState
+{
+public:
+    explicit BenchState(uint64_t iterations) : m_iterations(iterations), m_items(0), m_bytes(0), m_startNs(0) {}
+
+    // Number of operations the case must perform this repetition
+    uint64_t Iterations() const { return m_iterations; }
+
+    // Call after setup — timing starts here instead of at case entry
+    void ResetTimer();
+
+    // Items / bytes processed per iteration (for items/s and MB/s)
+    void SetItemsPerIteration(uint64_t n) { m_items = n; }
+    void SetBytesPerIteration(uint64_t n) { m_bytes = n; }
+
+    // Latency sample in nanoseconds (Bench_Samples cases)
+    void RecordSample(uint64_t ns) { m_samples.push_back(ns); }
+    void ReserveSamples(size_t n) { m_samples.reserve(n); }
+
+    // Extra named metric, reported as-is (lower is better)
+    void SetCounter(const char* name, double value);
+
+    uint64_t ItemsPerIteration() const { return m_items; }
+    uint64_t BytesPerIteration() const { return m_bytes; }
+    const std::vector<uint64_t>& Samples() const { return m_samples; }
+    const std::vector<std::pair<std::string, double> >& Counters() const { return m_counters; }
+    uint64_t StartNs() const { return m_startNs; }
+
+private:
+    uint64_t m_iterations;
+    uint64_t m_items;
+    uint64_t m_bytes;
+    uint64_t m_startNs;                  // 0 = case never called ResetTimer
+    std::vector<uint64_t> m_samples;
+    std::vector<std::pair<std::string, double> > m_counters;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Registration
+// ═══════════════════════════════════════════════════════════════
+typedef void (*BenchFn)(BenchState&);
+
+enum BenchFlags : uint32_t
+{
+    Bench_Default = 0,   // calibrated throughput loop
+    Bench_Samples = 1,   // one call per repetition, case records its own samples
+};
+
+struct BenchCase
+{
+    const char* name;    // "group.case" — stable key in JSON/baselines
+    BenchFn fn;
+    uint32_t flags;
+};
+
+std::vector<BenchCase>& BenchRegistry();
+
+struct BenchRegistrar
+{
+    BenchRegistrar(const char* name, BenchFn fn, uint32_t flags)
+    {
+        BenchCase c = { name, fn, flags };
+        BenchRegistry().push_back(c);
+    }
+};
+
+#define BENCH_CASE(fn, name, flags) static BenchRegistrar s_benchReg_##fn(name, fn, flags)
+
+// ═══════════════════════════════════════════════════════════════
+// Optimizer barrier — keeps results of measured code alive
+// ═══════════════════════════════════════════════════════════════
+#if defined(_MSC_VER)
+#include <intrin.h>
+extern volatile uintptr_t g_benchSink;
+template <class T>
+inline void BenchKeep(const T& value)
+{
+    g_benchSink = (uintptr_t)&value;
+    _ReadWriteBarrier();
+}
+#else
+template <class T>
+inline void BenchKeep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// Results
+// ═══════════════════════════════════════════════════════════════
+struct BenchMetric
+{
+    std::string key;     // "ns_per_op", "p99_ns", counter name...
+    double value;        // lower is better
+};
+
+struct BenchResult
+{
+    std::string name;
+    uint64_t iterations;
+    uint32_t repetitions;
+    double itemsPerSec;              // 0 if not set
+    double bytesPerSec;              // 0 if not set
+    std::vector<BenchMetric> metrics;
+
+    const BenchMetric* Find(const std::string& key) const;
+};
+
+struct BenchOptions
+{
+    std::string filter;              // substring match on case name
+    uint32_t repetitions;            // default 7
+    uint64_t minTimeNs;              // per repetition, default 20 ms
+    std::string outPath;             // JSON output file ("" = none, "-" = stdout)
+    std::string comparePath;         // baseline to compare against
+    double thresholdPct;             // regression threshold, default 15
+    bool list;
+
+    BenchOptions()
+        : repetitions(7), minTimeNs(20000000ULL), thresholdPct(15.0), list(false) {}
+};
+
+std::vector<BenchResult> BenchRunAll(const BenchOptions& options);
+std::string BenchToJson(const std::vector<BenchResult>& results);
+bool BenchLoadJson(const std::string& path, std::vector<BenchResult>& out, std::string& error);
+
+// Prints a comparison table; returns number of regressions beyond threshold
+int BenchCompare(const std::vector<BenchResult>& baseline,
+                 const std::vector<BenchResult>& current,
+                 double thresholdPct);
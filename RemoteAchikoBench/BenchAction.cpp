@@ -0,0 +1,159 @@
+﻿// BenchAction.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// ActionQueue benchmarks — idle between chained casts, reactive vs queued
+//
+// idle_* drive the real queue against a simulated client/server pair in
+// virtual time: 1.5 s casts, each direction 30 ms ± 8 ms (60 ms RTT), the
+// game's latency figure fed once per cast. The server rejects anything
+// that arrives before it is ready. Samples are the idle time per cast
+// (client saw the next cast start - client saw the previous one end),
+// i.e. the "before" (window 0) and "after" (400 ms window) numbers.
+// poll_cycle is the real cost of one enqueue → poll → confirm cycle.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "ActionQueue.h"
+
+#include <string.h>
+
+static const uint32_t kActionCasts = 2000;
+static const uint64_t kActionCastNs = 1500000000ULL;
+static const uint64_t kActionOneWayNs = 30000000ULL;
+static const uint64_t kActionJitterNs = 8000000ULL;      // ± per direction
+
+// ───────────────────────────────────────────────────────────────
+// SimLink — deterministic one-way delays
+// ───────────────────────────────────────────────────────────────
+class SimLink
+{
+public:
+    SimLink() : m_seed(0x2545F4914F6CDD1Dull) {}
+
+    uint64_t OneWay()
+    {
+        m_seed = m_seed * 6364136223846793005ull + 1442695040888963407ull;
+        return kActionOneWayNs - kActionJitterNs + (m_seed >> 33) % (2 * kActionJitterNs + 1);
+    }
+
+private:
+    uint64_t m_seed;
+};
+
+// ───────────────────────────────────────────────────────────────
+// RunCasts — chain kActionCasts casts through the queue
+// ───────────────────────────────────────────────────────────────
+static void RunCasts(BenchState& state, uint64_t windowNs)
+{
+    ActionQueue queue(windowNs);
+    SimLink link;
+
+    uint64_t now = 0;
+    uint64_t serverReady = 0;
+    uint64_t clientReady = kActionNever;    // pending ObserveReady event
+    uint64_t lastReady = 0;                 // when the client last saw readiness
+    ActionSubmit submit;
+    memset(&submit, 0, sizeof(submit));
+
+    state.ReserveSamples(kActionCasts);
+    for (uint32_t cast = 1; cast <= kActionCasts; ++cast)
+    {
+        // The bot decides the next cast right after the previous started
+        queue.Enqueue(now, cast, 0);
+        queue.ObserveLatency(link.OneWay() + link.OneWay());
+
+        bool started = false;
+        while (!started)
+        {
+            const uint64_t due = queue.DueNs();
+            if (clientReady != kActionNever && clientReady <= due)
+            {
+                now = clientReady;
+                lastReady = clientReady;
+                clientReady = kActionNever;
+                queue.ObserveReady(now);
+                continue;
+            }
+            if (due == kActionNever)
+                return;
+
+            now = due;
+            if (!queue.Poll(now, submit))
+                continue;
+
+            const uint64_t arrive = now + link.OneWay();
+            const uint64_t reply = arrive + link.OneWay();
+
+            // Readiness the client sees before the reply lands first
+            if (clientReady <= reply)
+            {
+                lastReady = clientReady;
+                queue.ObserveReady(clientReady);
+                clientReady = kActionNever;
+            }
+
+            now = reply;
+            if (arrive < serverReady)
+            {
+                queue.ObserveFailed(now, submit.actionId, ActionFail_NotReady);
+                continue;
+            }
+
+            queue.ObserveCastStart(now, submit.actionId, kActionCastNs, kActionCastNs);
+
+            // Jitter can show the new start before the old cast bar ends:
+            // nothing was lost, and that readiness event is superseded
+            if (cast > 1)
+                state.RecordSample(clientReady == kActionNever ? now - lastReady : 0);
+            serverReady = arrive + kActionCastNs;
+            clientReady = now + kActionCastNs;
+            started = true;
+        }
+    }
+
+    ActionStats stats;
+    queue.Stats(windowNs ? ActionMode_Queued : ActionMode_Reactive, stats);
+    state.SetCounter("early_rejects", (double)stats.earlyRejects);
+    state.SetCounter("timeouts", (double)stats.timeouts);
+    state.SetCounter("lead_ms", stats.leadNs / 1e6);
+}
+
+static void Action_IdleReactive(BenchState& state)
+{
+    RunCasts(state, 0);
+}
+BENCH_CASE(Action_IdleReactive, "action.idle_reactive", Bench_Samples);
+
+static void Action_IdleQueued(BenchState& state)
+{
+    RunCasts(state, kActionDefaultWindowNs);
+}
+BENCH_CASE(Action_IdleQueued, "action.idle_queued", Bench_Samples);
+
+// ───────────────────────────────────────────────────────────────
+// poll_cycle — enqueue → poll → confirm → ready, uncontended locks
+// ───────────────────────────────────────────────────────────────
+static void Action_PollCycle(BenchState& state)
+{
+    ActionQueue queue(kActionDefaultWindowNs);
+    queue.ObserveLatency(2 * kActionOneWayNs);
+    ActionSubmit submit;
+    memset(&submit, 0, sizeof(submit));
+    uint64_t now = 0;
+    uint64_t submitted = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        queue.Enqueue(now, (uint32_t)i, i);
+        now = queue.DueNs();
+        submitted += queue.Poll(now, submit) ? 1 : 0;
+        now += 2 * kActionOneWayNs;
+        queue.ObserveCastStart(now, submit.actionId, kActionCastNs, kActionCastNs);
+        now += kActionCastNs;
+        queue.ObserveReady(now);
+    }
+
+    BenchKeep(submitted);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Action_PollCycle, "action.poll_cycle", Bench_Default);
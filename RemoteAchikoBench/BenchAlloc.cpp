@@ -0,0 +1,49 @@
+﻿// BenchAlloc.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// AllocProfile benchmarks — what the CLR allocation callback adds per object
+//
+// countdown is paid by EVERY managed allocation while the profiler is
+// loaded; site_record only by sampled ones (one per ~64 KB).
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "AllocProfile.h"
+
+// ───────────────────────────────────────────────────────────────
+// countdown — sampling decision for a stream of small objects
+// ───────────────────────────────────────────────────────────────
+static void Alloc_Countdown(BenchState& state)
+{
+    AllocCountdown countdown;
+    uint64_t sampled = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        sampled += countdown.Take(24 + (uint32_t)(i & 63), kAllocSampleBytes) != 0;
+
+    BenchKeep(sampled);
+    state.SetItemsPerIteration(1);
+    state.SetCounter("sampled_per_million", state.Iterations() ? sampled * 1e6 / state.Iterations() : 0);
+}
+BENCH_CASE(Alloc_Countdown, "alloc.countdown", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// site_record — sampled allocation into a table of ~200 live sites
+// ───────────────────────────────────────────────────────────────
+static void Alloc_SiteRecord(BenchState& state)
+{
+    static AllocSiteTable table;   // 160 KB — not on the stack
+    table.Clear();
+
+    uint32_t x = 2463534242u;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        const uintptr_t site = 0x1000 + (x % 200) * 0x40;
+        table.Record(0x7000 + (x % 7) * 0x10, site, site + 0x10, kAllocSampleBytes);
+    }
+    state.SetItemsPerIteration(1);
+    state.SetCounter("dropped", (double)table.Dropped());
+}
+BENCH_CASE(Alloc_SiteRecord, "alloc.site_record", Bench_Default);
@@ -0,0 +1,75 @@
+﻿// BenchArena.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// TickArena benchmarks — one tick's worth of transient buffers, arena vs
+// heap
+//
+// Each iteration builds 64 buffers of 16 B – 16 KB (the mix a snapshot,
+// a few queries and an event batch produce) and then drops them: heap_tick
+// with malloc/free, arena_tick with Allocate + Reset. arena_tick_poison is
+// the same with the debug poison on, i.e. what a debug session pays.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "TickArena.h"
+
+#include <stdlib.h>
+
+static const uint32_t kArenaBuffers = 64;
+
+static size_t BufferSize(uint32_t i)
+{
+    return (size_t)16 << (i % 11);     // 16 B … 16 KB
+}
+
+static void Arena_HeapTick(BenchState& state)
+{
+    void* buffers[kArenaBuffers];
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        for (uint32_t b = 0; b < kArenaBuffers; ++b)
+        {
+            buffers[b] = malloc(BufferSize(b));
+            *(volatile uint8_t*)buffers[b] = (uint8_t)b;
+        }
+        for (uint32_t b = 0; b < kArenaBuffers; ++b)
+            free(buffers[b]);
+    }
+    state.SetItemsPerIteration(kArenaBuffers);
+}
+BENCH_CASE(Arena_HeapTick, "arena.heap_tick_64", Bench_Default);
+
+static void RunArenaTick(BenchState& state, bool poison)
+{
+    TickArena arena(kTickArenaChunkSize, poison);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        for (uint32_t b = 0; b < kArenaBuffers; ++b)
+        {
+            uint8_t* p = arena.AllocateArray<uint8_t>(BufferSize(b));
+            *(volatile uint8_t*)p = (uint8_t)b;
+        }
+        arena.Reset();
+    }
+    state.SetItemsPerIteration(kArenaBuffers);
+
+    TickArenaStats stats;
+    arena.Stats(stats);
+    state.SetCounter("high_water_kb", stats.highWaterBytes / 1024.0);
+    state.SetCounter("chunks", (double)stats.chunks);
+}
+
+static void Arena_Tick(BenchState& state)
+{
+    RunArenaTick(state, false);
+}
+BENCH_CASE(Arena_Tick, "arena.arena_tick_64", Bench_Default);
+
+static void Arena_TickPoison(BenchState& state)
+{
+    RunArenaTick(state, true);
+}
+BENCH_CASE(Arena_TickPoison, "arena.arena_tick_64_poison", Bench_Default);
@@ -0,0 +1,215 @@
+﻿// BenchBus.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Group bus benchmarks — ring and seqlock cost, cross-process latency
+//
+// send_receive and state_read are single-process costs of one message /
+// one seqlocked state copy. oneway_xproc_* fork a real second member
+// process and ping it: the child stamps each ping's one-way latency
+// (receive time - sentNs, same host-wide clock) into its pong, so the
+// samples are send → receiver-has-it, not round trips.
+//   _busy — next ping right after the pong (receiver still spinning)
+//   _idle — 1 ms between pings (receiver blocked in the kernel)
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "GroupBus.h"
+
+#include <stdio.h>
+
+#ifdef __linux__
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+static const uint32_t kBusBatch = 64;
+static const uint32_t kBusPings = 2000;
+
+static void BusGroupName(char* out, size_t size, const char* tag)
+{
+    snprintf(out, size, "bench_%s_%u", tag, PlatformProcessId());
+}
+
+// ───────────────────────────────────────────────────────────────
+// send_receive — two members in one process, batches of 64
+// ───────────────────────────────────────────────────────────────
+static void Bus_SendReceive(BenchState& state)
+{
+    char group[64];
+    BusGroupName(group, sizeof(group), "sr");
+    GroupBus a, b;
+    if (a.Join(group) < 0 || b.Join(group) < 0)
+        return;
+
+    BusMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = BusMsg_Target;
+    BusMessage out[kBusBatch];
+    uint64_t received = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        for (uint32_t n = 0; n < kBusBatch; ++n)
+        {
+            message.args[0] = n;
+            a.Send((uint32_t)b.Slot(), message);
+        }
+        received += b.Receive(out, kBusBatch);
+    }
+
+    BenchKeep(received);
+    state.SetItemsPerIteration(kBusBatch);
+    state.SetCounter("dropped", (double)a.Dropped());
+    GroupBus::Unlink(group);
+}
+BENCH_CASE(Bus_SendReceive, "bus.send_receive", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// state_read — publish + one seqlocked read of the peer's state
+// ───────────────────────────────────────────────────────────────
+static void Bus_StateRead(BenchState& state)
+{
+    char group[64];
+    BusGroupName(group, sizeof(group), "st");
+    GroupBus a, b;
+    if (a.Join(group) < 0 || b.Join(group) < 0)
+        return;
+
+    BusState mine;
+    memset(&mine, 0, sizeof(mine));
+    BusState seen;
+    uint64_t sum = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        mine.targetGuid = i;
+        a.Publish(mine);
+        if (b.ReadState((uint32_t)a.Slot(), seen))
+            sum += seen.targetGuid;
+    }
+
+    BenchKeep(sum);
+    state.SetItemsPerIteration(1);
+    GroupBus::Unlink(group);
+}
+BENCH_CASE(Bus_StateRead, "bus.state_read", Bench_Default);
+
+#ifdef __linux__
+
+// ───────────────────────────────────────────────────────────────
+// RunEchoChild — second member: answer every ping with a pong that
+// carries the ping's one-way latency, until killed
+// ───────────────────────────────────────────────────────────────
+static void RunEchoChild(const char* group)
+{
+    GroupBus bus;
+    if (bus.Join(group) < 0)
+        _exit(1);
+
+    BusMessage in[kBusBatch];
+    for (;;)
+    {
+        if (!bus.Wait(100))
+            continue;
+        const uint64_t now = PlatformNowNs();
+        const size_t count = bus.Receive(in, kBusBatch);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (in[i].type != BusMsg_Ping)
+                continue;
+            BusMessage pong = in[i];
+            pong.type = BusMsg_Pong;
+            pong.args[1] = now - in[i].sentNs;
+            bus.Send(in[i].from, pong);
+        }
+    }
+}
+
+static void RunPingPong(BenchState& state, const char* tag, uint32_t gapUs)
+{
+    char group[64];
+    BusGroupName(group, sizeof(group), tag);
+    GroupBus::Unlink(group);
+
+    GroupBus bus;
+    if (bus.Join(group) < 0)
+        return;
+
+    const pid_t child = fork();
+    if (child == 0)
+        RunEchoChild(group);
+    if (child < 0)
+        return;
+
+    // Wait for the child to claim its slot
+    uint32_t slots[kBusMaxMembers];
+    uint32_t peer = kBusMaxMembers;
+    for (int tries = 0; tries < 2000 && peer == kBusMaxMembers; ++tries)
+    {
+        const uint32_t count = bus.Members(slots, NULL, kBusMaxMembers);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (slots[i] != (uint32_t)bus.Slot())
+                peer = slots[i];
+        }
+        if (peer == kBusMaxMembers)
+            PlatformSleepMs(1);
+    }
+
+    BusMessage ping;
+    memset(&ping, 0, sizeof(ping));
+    ping.type = BusMsg_Ping;
+    BusMessage in[kBusBatch];
+    uint32_t lost = 0;
+
+    state.ReserveSamples(kBusPings);
+    for (uint32_t n = 0; peer != kBusMaxMembers && n < kBusPings; ++n)
+    {
+        if (gapUs)
+            usleep(gapUs);
+
+        ping.args[0] = n;
+        bus.Send(peer, ping);
+
+        bool answered = false;
+        while (!answered)
+        {
+            if (!bus.Wait(1000))
+            {
+                ++lost;
+                break;
+            }
+            const size_t count = bus.Receive(in, kBusBatch);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (in[i].type == BusMsg_Pong && in[i].args[0] == n)
+                {
+                    state.RecordSample(in[i].args[1]);
+                    answered = true;
+                }
+            }
+        }
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    state.SetCounter("lost", (double)lost);
+    bus.Leave();
+    GroupBus::Unlink(group);
+}
+
+static void Bus_OneWayBusy(BenchState& state)
+{
+    RunPingPong(state, "busy", 0);
+}
+BENCH_CASE(Bus_OneWayBusy, "bus.oneway_xproc_busy", Bench_Samples);
+
+static void Bus_OneWayIdle(BenchState& state)
+{
+    RunPingPong(state, "idle", 1000);
+}
+BENCH_CASE(Bus_OneWayIdle, "bus.oneway_xproc_idle", Bench_Samples);
+
+#endif // __linux__
@@ -0,0 +1,89 @@
+﻿// BenchCodec.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// LineCodec benchmarks — timestamp prefix encode/decode versus the
+// snprintf formatting the pipe logger used before
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "LineCodec.h"
+
+#include <stdio.h>
+
+static const char* const kSampleLines[] =
+{
+    "[07:41:09.512] [Bugger] Pipe client connected",
+    "[07:41:09.530] [Bot] Pull: Defias Thug (level 11)",
+    "[13:02:58.001] [Combat] Frostbolt hit for 212",
+    "[23:59:59.999] [Nav] Waypoint 14 reached",
+};
+static const size_t kSampleLineLength = 14;   // prefix only — DecodeLinePrefix never reads further
+
+// ───────────────────────────────────────────────────────────────
+// encode_prefix — "[HH:mm:ss.fff] " from milliseconds-of-day
+// ───────────────────────────────────────────────────────────────
+static void Codec_EncodePrefix(BenchState& state)
+{
+    char buffer[32];
+    uint32_t ms = 12345678;
+
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        EncodeLinePrefix(buffer, ms);
+        BenchKeep(buffer);
+        ms = (ms + 7919) % kMsPerDay;
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Codec_EncodePrefix, "codec.encode_prefix", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// encode_prefix_snprintf — same output via snprintf (baseline)
+// ───────────────────────────────────────────────────────────────
+static void Codec_EncodePrefixSnprintf(BenchState& state)
+{
+    char buffer[32];
+    uint32_t ms = 12345678;
+
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "[%02u:%02u:%02u.%03u] ",
+                 ms / 3600000u, (ms / 60000u) % 60u, (ms / 1000u) % 60u, ms % 1000u);
+        BenchKeep(buffer);
+        ms = (ms + 7919) % kMsPerDay;
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Codec_EncodePrefixSnprintf, "codec.encode_prefix_snprintf", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// decode_prefix — parse the prefix back to milliseconds-of-day
+// ───────────────────────────────────────────────────────────────
+static void Codec_DecodePrefix(BenchState& state)
+{
+    uint32_t ms = 0;
+
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        DecodeLinePrefix(kSampleLines[i & 3], kSampleLineLength, ms);
+        BenchKeep(ms);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Codec_DecodePrefix, "codec.decode_prefix", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// decode_prefix_sscanf — same parse via sscanf (baseline)
+// ───────────────────────────────────────────────────────────────
+static void Codec_DecodePrefixSscanf(BenchState& state)
+{
+    unsigned h = 0, m = 0, s = 0, f = 0;
+
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        sscanf(kSampleLines[i & 3], "[%2u:%2u:%2u.%3u]", &h, &m, &s, &f);
+        const uint32_t ms = ((h * 60u + m) * 60u + s) * 1000u + f;
+        BenchKeep(ms);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Codec_DecodePrefixSscanf, "codec.decode_prefix_sscanf", Bench_Default);
@@ -0,0 +1,132 @@
+﻿// BenchConfig.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// ConfigStore benchmarks — what a settings read costs, and a hot reload
+//
+// The config is 200 entries in 8 sections: offsets (hex), tick rates and
+// thresholds (int / float), a few strings. lookup is a native read of a
+// pre-hashed key from the compiled image (managed code usually pays even
+// less: one compare against the generation word). compile_200 is the
+// text parse a reload pays once — and what a text config would cost per
+// read. reload is a text edit going live: compile, write the .bin, map,
+// validate and swap (samples, ns).
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "ConfigStore.h"
+
+static const uint32_t kConfigBenchEntries = 200;
+static const uint32_t kConfigBenchReloads = 50;
+
+static std::string ConfigBenchText(uint32_t variant)
+{
+    static const char* const kSections[] = { "bot", "combat", "loot", "vendor", "rest", "nav", "offsets", "ui" };
+    std::string text = "# benchmark config\n";
+    char line[96];
+    for (uint32_t i = 0; i < kConfigBenchEntries; ++i)
+    {
+        if (i % 25 == 0)
+        {
+            snprintf(line, sizeof(line), "\n[%s]\n", kSections[i / 25]);
+            text += line;
+        }
+        if (i / 25 == 6)
+            snprintf(line, sizeof(line), "field_%u = 0x%08X\n", i, 0x00B40000u + i * 8 + variant);
+        else if (i % 5 == 0)
+            snprintf(line, sizeof(line), "name_%u = \"value %u\"   # a comment\n", i, i + variant);
+        else if (i % 3 == 0)
+            snprintf(line, sizeof(line), "ratio_%u = %u.25\n", i, i + variant);
+        else
+            snprintf(line, sizeof(line), "limit_%u = %u\n", i, i * 10 + variant);
+        text += line;
+    }
+    return text;
+}
+
+static void Config_Lookup(BenchState& state)
+{
+    const std::string text = ConfigBenchText(0);
+    std::vector<uint8_t> image;
+    std::string error;
+    ConfigCompileText(text.data(), text.size(), 0, image, error);
+    ConfigTable table;
+    table.Bind(image.data(), image.size());
+
+    std::vector<uint64_t> keys;
+    for (uint32_t i = 0; i < table.Count(); ++i)
+        keys.push_back(table.Entries()[(i * 37) % table.Count()].key);
+
+    uint64_t sum = 0;   // wraps freely — only kept alive
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        sum += (uint64_t)table.Find(keys[i % keys.size()])->value;
+    BenchKeep(sum);
+    state.SetCounter("entries", table.Count());
+}
+BENCH_CASE(Config_Lookup, "config.lookup", Bench_Default);
+
+static void Config_Compile200(BenchState& state)
+{
+    const std::string text = ConfigBenchText(0);
+    std::vector<uint8_t> image;
+    std::string error;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        ConfigCompileText(text.data(), text.size(), 0, image, error);
+        BenchKeep(image.size());
+    }
+    state.SetItemsPerIteration(kConfigBenchEntries);
+    state.SetBytesPerIteration(text.size());
+}
+BENCH_CASE(Config_Compile200, "config.compile_200", Bench_Default);
+
+static void Config_Reload(BenchState& state)
+{
+#ifdef _WIN32
+    wchar_t dir[MAX_PATH];
+    GetTempPathW(MAX_PATH, dir);
+    const ConfigPath text = std::wstring(dir) + L"AchikoConfigBench.cfg";
+    const ConfigPath bin = std::wstring(dir) + L"AchikoConfigBench.cfg.bin";
+#else
+    const char* dir = getenv("TMPDIR");
+    const ConfigPath text = std::string(dir && *dir ? dir : "/tmp") + "/AchikoConfigBench.cfg";
+    const ConfigPath bin = text + ".bin";
+#endif
+
+    ConfigStore store;
+    for (uint32_t i = 0; i <= kConfigBenchReloads; ++i)
+    {
+        // i = 0 writes the first version before the store opens
+        const std::string content = ConfigBenchText(i + 1);
+        FILE* out = ConfigOpenFile(text, true);
+        if (!out)
+            return;
+        fwrite(content.data(), 1, content.size(), out);
+        fclose(out);
+        if (i == 0)
+        {
+            store.Open(bin, text);
+            continue;
+        }
+
+        const uint64_t start = PlatformNowNs();
+        // The watcher may have picked this edit up first
+        if (store.ReloadNow())
+            state.RecordSample(PlatformNowNs() - start);
+    }
+
+    ConfigStats stats;
+    store.Stats(stats);
+    state.SetCounter("generation", stats.generation);
+    state.SetCounter("rejected", (double)stats.rejected);
+    store.Close();
+#ifdef _WIN32
+    DeleteFileW(text.c_str());
+    DeleteFileW(bin.c_str());
+#else
+    unlink(text.c_str());
+    unlink(bin.c_str());
+#endif
+}
+BENCH_CASE(Config_Reload, "config.reload", Bench_Samples);
@@ -0,0 +1,59 @@
+﻿// BenchEffect.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// EffectTracker benchmarks — what the instrumentation itself costs
+//
+// cycle is one fully stamped cast decision: decide, dispatched, executed,
+// a snapshot that arms it and the snapshot that completes it (four
+// histogram records). observe_16 is one snapshot matched against 16 open
+// decisions that it does not complete — the steady per-snapshot cost.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "EffectTracker.h"
+
+#include <string.h>
+
+static void Effect_Cycle(BenchState& state)
+{
+    EffectTracker tracker;
+    EffectSnapshot idle, casting;
+    memset(&idle, 0, sizeof(idle));
+    memset(&casting, 0, sizeof(casting));
+    uint64_t now = 1;
+    uint64_t completed = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        casting.castId = 100 + (i & 7);
+        const uint32_t token = tracker.Decide(now, Effect_Cast, casting.castId);
+        tracker.Dispatched(token, now + 1000);
+        tracker.Executed(token, now + 20000);
+        tracker.Observe(now + 40000, idle);
+        completed += tracker.Observe(now + 80000, casting);
+        now += 100000;
+    }
+
+    BenchKeep(completed);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Effect_Cycle, "effect.cycle", Bench_Default);
+
+static void Effect_Observe16(BenchState& state)
+{
+    EffectTracker tracker;
+    EffectSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    for (uint32_t i = 0; i < 16; ++i)
+        tracker.Decide(0, (EffectKind)(i % Effect_KindCount), 1000 + i);
+
+    uint64_t completed = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        completed += tracker.Observe(1, snapshot);     // inside the timeout, nothing matches
+
+    BenchKeep(completed);
+    state.SetItemsPerIteration(16);
+}
+BENCH_CASE(Effect_Observe16, "effect.observe_16", Bench_Default);
@@ -0,0 +1,198 @@
+﻿// BenchGrind.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Grind profile benchmarks — load cost and route optimizer quality
+//
+// The profile is a large one: 64 hotspots, 20k waypoints, 40 black
+// areas, 60 vendors, 500 blacklisted entries (~340 KB). open_mapped maps
+// and validates it and reads the first hotspot of the route; parse_text
+// loads the same data from "x y z flags" text lines — what a text
+// profile costs on every load.
+// optimize_64 solves 64 hotspots laid out by hand as a zig-zag over
+// three hills (authoring order = hotspot order); cost_ratio is optimized
+// / hand-ordered tour cost, lower is better.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "RouteOptimizer.h"
+
+#include <stdlib.h>
+
+static const uint32_t kGrindHotspots = 64;
+static const uint32_t kGrindWaypoints = 20000;
+
+static uint32_t GrindRandom(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float GrindCoord(uint32_t& seed, float extent)
+{
+    return (float)(GrindRandom(seed) % 100000u) * (extent / 100000.0f);
+}
+
+// Hand-ordered layout: columns walked top to bottom, every column
+// starting at the top again, on terrain with three hills
+static void GrindBenchHotspots(std::vector<GrindHotspot>& out)
+{
+    uint32_t seed = 0xC0FFEEu;
+    out.clear();
+    for (uint32_t i = 0; i < kGrindHotspots; ++i)
+    {
+        GrindHotspot h;
+        h.x = (float)(i / 8) * 120.0f + GrindCoord(seed, 60.0f);
+        h.y = (float)(7 - i % 8) * 120.0f + GrindCoord(seed, 60.0f);
+        h.z = 40.0f * (sinf(h.x / 180.0f) + cosf(h.y / 150.0f) + 2.0f);
+        h.radius = 30.0f;
+        out.push_back(h);
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// GrindBenchProfile — the profile, as a file and as text
+// ───────────────────────────────────────────────────────────────
+class GrindBenchProfile
+{
+public:
+    GrindBenchProfile()
+    {
+#ifdef _WIN32
+        wchar_t dir[MAX_PATH];
+        GetTempPathW(MAX_PATH, dir);
+        m_path = std::wstring(dir) + L"AchikoGrindBench.agp";
+#else
+        const char* dir = getenv("TMPDIR");
+        m_path = std::string(dir && *dir ? dir : "/tmp") + "/AchikoGrindBench.agp";
+#endif
+        uint32_t seed = 0xAB5EEDu;
+        GrindProfileData data;
+        data.name = "Bench hills";
+        data.map = 1;
+        GrindBenchHotspots(data.hotspots);
+        for (uint32_t i = 0; i < kGrindWaypoints; ++i)
+        {
+            GrindWaypoint w;
+            w.x = GrindCoord(seed, 1000.0f);
+            w.y = GrindCoord(seed, 1000.0f);
+            w.z = GrindCoord(seed, 200.0f);
+            w.flags = GrindRandom(seed) % 4;
+            data.waypoints.push_back(w);
+        }
+        for (uint32_t i = 0; i < 40; ++i)
+        {
+            GrindBlackArea a = { GrindCoord(seed, 1000.0f), GrindCoord(seed, 1000.0f), 0.0f, 25.0f };
+            data.blackAreas.push_back(a);
+        }
+        for (uint32_t i = 0; i < 60; ++i)
+        {
+            GrindVendor v = { GrindCoord(seed, 1000.0f), GrindCoord(seed, 1000.0f), 0.0f, 3000 + i,
+                              GrindService_Sell | (i % 3 == 0 ? (uint32_t)GrindService_Repair : 0u), 0 };
+            data.vendors.push_back(v);
+        }
+        for (uint32_t i = 0; i < 500; ++i)
+            data.blacklistEntries.push_back(1 + GrindRandom(seed) % 20000);
+        GrindWriteProfile(m_path.c_str(), data);
+
+        char line[96];
+        for (size_t i = 0; i < data.waypoints.size(); ++i)
+        {
+            const GrindWaypoint& w = data.waypoints[i];
+            snprintf(line, sizeof(line), "%.3f %.3f %.3f %u\n", w.x, w.y, w.z, w.flags);
+            m_text += line;
+        }
+    }
+
+    ~GrindBenchProfile()
+    {
+#ifdef _WIN32
+        DeleteFileW(m_path.c_str());
+#else
+        unlink(m_path.c_str());
+#endif
+    }
+
+    const MappedPathChar* Path() const { return m_path.c_str(); }
+    const std::string& Text() const { return m_text; }
+
+private:
+    std::basic_string<MappedPathChar> m_path;
+    std::string m_text;                 // waypoints only
+};
+
+static GrindBenchProfile& SharedGrind()
+{
+    static GrindBenchProfile s_grind;
+    return s_grind;
+}
+
+static void Grind_OpenMapped(BenchState& state)
+{
+    GrindBenchProfile& shared = SharedGrind();
+    GrindProfile profile;
+    uint64_t opened = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        if (profile.Open(shared.Path()))
+            opened += profile.Route()[0] + (uint64_t)profile.Hotspots()[0].radius;
+        profile.Close();
+    }
+    BenchKeep(opened);
+}
+BENCH_CASE(Grind_OpenMapped, "grind.open_mapped", Bench_Default);
+
+static void Grind_ParseText(BenchState& state)
+{
+    const std::string& text = SharedGrind().Text();
+    std::vector<GrindWaypoint> waypoints;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        waypoints.clear();
+        const char* p = text.c_str();
+        while (*p)
+        {
+            char* end;
+            GrindWaypoint w;
+            w.x = strtof(p, &end);
+            w.y = strtof(end, &end);
+            w.z = strtof(end, &end);
+            w.flags = (uint32_t)strtoul(end, &end, 10);
+            waypoints.push_back(w);
+            p = *end ? end + 1 : end;
+        }
+        BenchKeep(waypoints.size());
+    }
+}
+BENCH_CASE(Grind_ParseText, "grind.parse_text", Bench_Default);
+
+static void Grind_Optimize64(BenchState& state)
+{
+    std::vector<GrindHotspot> hotspots;
+    GrindBenchHotspots(hotspots);
+
+    std::vector<float> matrix;
+    RouteBuildMatrix(hotspots.size(), [&hotspots](uint32_t from, uint32_t to)
+    {
+        return GrindTravelCost(hotspots[from], hotspots[to]);
+    }, 0, matrix);
+
+    RouteOptions options;
+    std::vector<uint32_t> order;
+    RouteReport report;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        RouteSolve(matrix.data(), hotspots.size(), options, order, report);
+        BenchKeep(report.routeCost);
+    }
+
+    state.SetCounter("hand_cost", report.handCost);
+    state.SetCounter("route_cost", report.routeCost);
+    state.SetCounter("cost_ratio", report.handCost > 0 ? report.routeCost / report.handCost : 1.0);
+    state.SetCounter("threads", report.threads);
+}
+BENCH_CASE(Grind_Optimize64, "grind.optimize_64", Bench_Default);
@@ -0,0 +1,85 @@
+﻿// BenchHookFilter.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// HookFilter benchmarks — the native predicate stage and batched drains
+//
+// Filter() is the stub's logic in C++ (the x86 stub itself only exists
+// inside WoW). reject is a call whose id is not watched: counter, bounds
+// check, bitset test — what every uninteresting call now pays instead of
+// a reverse P/Invoke. match_drain is a call stream with 1 in 16 ids
+// watched, drained every 1024 calls the way the bot tick does;
+// calls_per_transition is how many hooked calls share one managed
+// transition (a managed detour has 1).
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "HookFilter.h"
+
+#include <string.h>
+#include <vector>
+
+static const uint32_t kFilterBenchCallsPerDrain = 1024;
+
+// A stub frame: eflags, pushad block, return address, stack arguments
+static void FilterBenchFrame(uint32_t* frame, uint32_t spellId)
+{
+    memset(frame, 0, 16 * sizeof(uint32_t));
+    frame[9] = 0x006FC0DEu;
+    frame[10] = spellId;
+}
+
+static void HookFilter_Reject(BenchState& state)
+{
+    HookFilter& filter = HookFilter::Instance();
+    const uint16_t id = filter.Register("bench.reject", HookSource_Stack);
+    const uint32_t watched[] = { 133, 116, 2136 };
+    filter.Watch(id, watched, 3, true);
+
+    uint32_t frame[16];
+    FilterBenchFrame(frame, 0);
+    uint32_t matched = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        matched += filter.Filter(id, 4000 + (uint32_t)(i & 1023), frame) ? 1 : 0;
+    BenchKeep(matched);
+}
+BENCH_CASE(HookFilter_Reject, "hookfilter.reject", Bench_Default);
+
+static void HookFilter_MatchDrain(BenchState& state)
+{
+    HookFilter& filter = HookFilter::Instance();
+    const uint16_t id = filter.Register("bench.match_drain", HookSource_Stack);
+
+    // Spell ids 0..4095 called round-robin, every 16th watched
+    std::vector<uint32_t> watched;
+    for (uint32_t spell = 0; spell < 4096; spell += 16)
+        watched.push_back(spell);
+    filter.Watch(id, watched.data(), (uint32_t)watched.size(), true);
+
+    uint32_t frame[16];
+    std::vector<HookEvent> batch(kHookFilterRingSize);
+    HookFilterSummary before;
+    filter.Summary(before);
+
+    uint64_t events = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uint32_t spell = (uint32_t)(i * 7) & 4095;
+        FilterBenchFrame(frame, spell);
+        filter.Filter(id, spell, frame);
+        if ((i + 1) % kFilterBenchCallsPerDrain == 0)
+            events += filter.Drain(batch.data(), (uint32_t)batch.size());
+    }
+    events += filter.Drain(batch.data(), (uint32_t)batch.size());
+
+    HookFilterSummary after;
+    filter.Summary(after);
+    const double calls = (double)(after.calls - before.calls);
+    const double drains = (double)(after.drains - before.drains);
+    state.SetCounter("matched_per_call", calls > 0 ? (double)(after.matched - before.matched) / calls : 0.0);
+    state.SetCounter("events_per_drain", drains > 0 ? (double)events / drains : 0.0);
+    state.SetCounter("calls_per_transition", drains > 0 ? calls / drains : 0.0);
+    state.SetCounter("dropped", (double)(after.dropped - before.dropped));
+}
+BENCH_CASE(HookFilter_MatchDrain, "hookfilter.match_drain", Bench_Default);
@@ -0,0 +1,168 @@
+﻿// BenchIndex.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// GuidIndex and SpatialGrid benchmarks — lookup and query costs at
+// realistic object counts
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "GuidIndex.h"
+#include "SpatialGrid.h"
+#include "SyntheticClient.h"
+
+#include <vector>
+
+static const uint32_t kObjects = 2048;
+
+// ───────────────────────────────────────────────────────────────
+// guid.find_hit / guid.find_miss
+// ───────────────────────────────────────────────────────────────
+static void Guid_FindHit(BenchState& state)
+{
+    SyntheticClient client(kObjects);
+    GuidIndex index(kObjects);
+    for (uint32_t i = 0; i < kObjects; ++i)
+        index.Insert(client.Guid(i), i);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uint32_t slot = index.Find(client.Guid((size_t)(i * 7919) & (kObjects - 1)));
+        BenchKeep(slot);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Guid_FindHit, "index.guid_find_hit", Bench_Default);
+
+static void Guid_FindMiss(BenchState& state)
+{
+    SyntheticClient client(kObjects);
+    GuidIndex index(kObjects);
+    for (uint32_t i = 0; i < kObjects; ++i)
+        index.Insert(client.Guid(i), i);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uint32_t slot = index.Find(0xF140000000000000ULL | i);
+        BenchKeep(slot);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Guid_FindMiss, "index.guid_find_miss", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// Shared point set — 2048 units spread over a 2000 x 2000 yard zone
+// ───────────────────────────────────────────────────────────────
+static std::vector<SpatialPoint> MakePoints(SyntheticClient& client)
+{
+    std::vector<SpatialPoint> points(kObjects);
+    for (uint32_t i = 0; i < kObjects; ++i)
+    {
+        points[i].x = (float)(client.Next() % 200000) / 100.0f;
+        points[i].y = (float)(client.Next() % 200000) / 100.0f;
+        points[i].z = 0.0f;
+        points[i].id = i;
+    }
+    return points;
+}
+
+// ───────────────────────────────────────────────────────────────
+// spatial.build — rebuild the grid (done once per tick)
+// ───────────────────────────────────────────────────────────────
+static void Spatial_Build(BenchState& state)
+{
+    SyntheticClient client(1);
+    const std::vector<SpatialPoint> points = MakePoints(client);
+    SpatialGrid grid(50.0f);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        grid.Build(points.data(), points.size());
+        BenchKeep(grid.Count());
+    }
+    state.SetItemsPerIteration(kObjects);
+}
+BENCH_CASE(Spatial_Build, "index.spatial_build_2048", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// spatial.radius_40 — "units within aggro range"
+// ───────────────────────────────────────────────────────────────
+struct CountHits
+{
+    size_t* hits;
+    void operator()(const SpatialPoint&, float) const { ++*hits; }
+};
+
+static void Spatial_Radius(BenchState& state)
+{
+    SyntheticClient client(1);
+    const std::vector<SpatialPoint> points = MakePoints(client);
+    SpatialGrid grid(50.0f);
+    grid.Build(points.data(), points.size());
+
+    size_t hits = 0;
+    CountHits fn = { &hits };
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const SpatialPoint& p = points[(size_t)(i * 7919) & (kObjects - 1)];
+        grid.QueryRadius(p.x, p.y, 40.0f, fn);
+    }
+    BenchKeep(hits);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Spatial_Radius, "index.spatial_radius_40", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// spatial.nearest — closest unit from random positions
+// ───────────────────────────────────────────────────────────────
+static void Spatial_Nearest(BenchState& state)
+{
+    SyntheticClient client(1);
+    const std::vector<SpatialPoint> points = MakePoints(client);
+    SpatialGrid grid(50.0f);
+    grid.Build(points.data(), points.size());
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const float x = (float)((i * 7919) % 2000);
+        const float y = (float)((i * 104729) % 2000);
+        const SpatialPoint* best = grid.Nearest(x, y, 500.0f);
+        BenchKeep(best);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Spatial_Nearest, "index.spatial_nearest", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// spatial.nearest_linear — same query by brute force (baseline)
+// ───────────────────────────────────────────────────────────────
+static void Spatial_NearestLinear(BenchState& state)
+{
+    SyntheticClient client(1);
+    const std::vector<SpatialPoint> points = MakePoints(client);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const float x = (float)((i * 7919) % 2000);
+        const float y = (float)((i * 104729) % 2000);
+        const SpatialPoint* best = nullptr;
+        float bestD2 = 500.0f * 500.0f;
+        for (size_t k = 0; k < points.size(); ++k)
+        {
+            const float dx = points[k].x - x, dy = points[k].y - y;
+            const float d2 = dx * dx + dy * dy;
+            if (d2 <= bestD2)
+            {
+                best = &points[k];
+                bestD2 = d2;
+            }
+        }
+        BenchKeep(best);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Spatial_NearestLinear, "index.spatial_nearest_linear", Bench_Default);
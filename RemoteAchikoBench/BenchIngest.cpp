@@ -0,0 +1,190 @@
+﻿// BenchIngest.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Log ingest benchmarks — newline search and the full 4-source merge
+//
+// find_newline* split one 64 KB pipe block into lines: the SSE2 search
+// that ships, a byte loop, and the CRT memchr for reference.
+// merge_4src is what Bugger's reader tasks + merge thread do per block:
+// four sources with interleaved timestamps pushed in 64 KB blocks (lines
+// split across blocks), drained in timeline order — items = lines.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "LogIngest.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const size_t kIngestBlock = 64 * 1024;
+static const uint32_t kIngestSources = 4;
+static const uint32_t kIngestLinesPerSource = 4096;
+
+static const char* const kIngestBodies[] =
+{
+    "[AchikoDLL] [Bot] Pull: Defias Thug (level 11) at 12.5 yd",
+    "[AchikoDLL] [Combat] Frostbolt hit Defias Thug for 212 (crit)",
+    "[AchikoDLL] [Nav] Waypoint 14 reached, 37 remaining on path Westfall-3",
+    "[RemoteAchiko] RemoteAchiko: CLR started successfully",
+    "[AchikoDLL] [PipeClient] Received command: START",
+};
+
+// ───────────────────────────────────────────────────────────────
+// BuildSource — "[HH:mm:ss.fff] body\r\n" lines; source s logs every
+// 4th millisecond with phase s, so the sources interleave exactly
+// ───────────────────────────────────────────────────────────────
+static std::string BuildSource(uint32_t source)
+{
+    std::string out;
+    char prefix[kLinePrefixLength];
+    uint32_t ms = 12u * 3600u * 1000u + source;
+
+    for (uint32_t i = 0; i < kIngestLinesPerSource; ++i)
+    {
+        EncodeLinePrefix(prefix, ms);
+        out.append(prefix, kLinePrefixLength);
+        out.append(kIngestBodies[(i + source) % 5]);
+        out.append("\r\n");
+        ms += kIngestSources;
+    }
+    return out;
+}
+
+static std::string BuildBlock()
+{
+    std::string all = BuildSource(0);
+    all.resize(kIngestBlock);
+    return all;
+}
+
+// ───────────────────────────────────────────────────────────────
+// find_newline — SSE2 split of one block
+// ───────────────────────────────────────────────────────────────
+static void Ingest_FindNewline(BenchState& state)
+{
+    const std::string block = BuildBlock();
+    const char* end = block.data() + block.size();
+    uint64_t lines = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        for (const char* p = block.data(); (p = FindNewline(p, end)) != end; ++p)
+            ++lines;
+    }
+
+    BenchKeep(lines);
+    state.SetBytesPerIteration(kIngestBlock);
+}
+BENCH_CASE(Ingest_FindNewline, "ingest.find_newline", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// find_newline_bytewise — one compare per byte (baseline)
+// ───────────────────────────────────────────────────────────────
+static void Ingest_FindNewlineBytewise(BenchState& state)
+{
+    const std::string block = BuildBlock();
+    const char* volatile start = block.data();   // keep the loop from being vectorized away
+    const char* end = block.data() + block.size();
+    uint64_t lines = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        for (const char* p = start; p != end; ++p)
+        {
+            if (*p == '\n')
+                ++lines;
+        }
+    }
+
+    BenchKeep(lines);
+    state.SetBytesPerIteration(kIngestBlock);
+}
+BENCH_CASE(Ingest_FindNewlineBytewise, "ingest.find_newline_bytewise", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// find_newline_memchr — CRT memchr (reference)
+// ───────────────────────────────────────────────────────────────
+static void Ingest_FindNewlineMemchr(BenchState& state)
+{
+    const std::string block = BuildBlock();
+    const char* end = block.data() + block.size();
+    uint64_t lines = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const char* p = block.data();
+        while ((p = (const char*)memchr(p, '\n', (size_t)(end - p))) != NULL)
+        {
+            ++lines;
+            ++p;
+        }
+    }
+
+    BenchKeep(lines);
+    state.SetBytesPerIteration(kIngestBlock);
+}
+BENCH_CASE(Ingest_FindNewlineMemchr, "ingest.find_newline_memchr", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// merge_4src — push 4 × 4096 lines in 64 KB blocks, round robin,
+// draining after every block; late lines reported as a counter
+// ───────────────────────────────────────────────────────────────
+static void Ingest_Merge4Src(BenchState& state)
+{
+    std::vector<std::string> data;
+    for (uint32_t s = 0; s < kIngestSources; ++s)
+        data.push_back(BuildSource(s));
+
+    std::vector<IngestRecord> records(4096);
+    std::vector<char> text(256 * 1024);
+    LogIngest ingest;
+    uint64_t drained = 0;
+    uint64_t late = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        ingest.Reset();   // every round replays the same timestamps
+
+        uint32_t ids[kIngestSources];
+        size_t offsets[kIngestSources] = {};
+        for (uint32_t s = 0; s < kIngestSources; ++s)
+            ids[s] = ingest.Open(s);
+
+        bool more = true;
+        while (more)
+        {
+            more = false;
+            for (uint32_t s = 0; s < kIngestSources; ++s)
+            {
+                const size_t left = data[s].size() - offsets[s];
+                if (left == 0)
+                    continue;
+                // Odd block sizes so lines split at different points per source
+                const size_t n = left < kIngestBlock - s * 97 ? left : kIngestBlock - s * 97;
+                ingest.Push(ids[s], data[s].data() + offsets[s], n);
+                offsets[s] += n;
+                more = more || offsets[s] < data[s].size();
+
+                size_t got;
+                while ((got = ingest.Drain(&records[0], records.size(), &text[0], text.size())) != 0)
+                    drained += got;
+            }
+        }
+
+        for (uint32_t s = 0; s < kIngestSources; ++s)
+            ingest.Close(ids[s]);
+        size_t got;
+        while ((got = ingest.Flush(&records[0], records.size(), &text[0], text.size())) != 0)
+            drained += got;
+        late += ingest.Stats().late;
+    }
+
+    BenchKeep(drained);
+    state.SetItemsPerIteration(kIngestSources * kIngestLinesPerSource);
+    state.SetCounter("late_lines", (double)late);
+}
+BENCH_CASE(Ingest_Merge4Src, "ingest.merge_4src", Bench_Default);
@@ -0,0 +1,189 @@
+﻿// BenchInventory.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// InventorySnapshot benchmarks — per-tick bag refresh and metadata lookups
+//
+// A synthetic client with 512 objects: the player, four 16-slot bags and
+// 80 items filling backpack and bags, plus an item table of 1000 records.
+// refresh_unchanged is the steady state (every slot read, hashed, nothing
+// emitted); refresh_one_change changes one stack per tick (loot, a potion
+// used) — one event per refresh. item_info is a metadata lookup after the
+// first read, which is what vendor / destroy decisions pay per item.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "InventorySnapshot.h"
+#include "SyntheticClient.h"
+
+static const uint32_t kInventoryObjects = 512;
+static const uint32_t kInventoryPack = 16;
+static const uint32_t kInventoryBagSize = 16;
+static const uint32_t kInventoryItemBase = 1000;
+static const uint32_t kInventoryItemCount = 1000;
+
+// ───────────────────────────────────────────────────────────────
+// InventoryFixture — player + bags + items inside a SyntheticClient
+// ───────────────────────────────────────────────────────────────
+class InventoryFixture
+{
+public:
+    InventoryFixture()
+        : m_client(kInventoryObjects), m_directory(ListLayout(m_client.Layout())),
+          m_records(kInventoryItemCount * 64, 0), m_table(kInventoryItemCount, 0)
+    {
+        const SyntheticLayout& l = m_client.Layout();
+        memset(&m_layout, 0, sizeof(m_layout));
+        m_layout.itemTable = (uint64_t)(uintptr_t)m_table.data();
+        m_layout.itemTableMin = kInventoryItemBase;
+        m_layout.itemTableCount = kInventoryItemCount;
+        m_layout.objectDescriptors = l.objectDescriptors;
+        m_layout.playerPackSlots = 0x100;
+        m_layout.packSlotCount = kInventoryPack;
+        m_layout.playerBagSlots = 0x180;
+        m_layout.bagCount = 4;
+        m_layout.containerSlotCount = 0x08;
+        m_layout.containerSlots = 0x10;
+        m_layout.itemEntry = 0x0C;
+        m_layout.itemStackCount = 0x20;
+        m_layout.itemDurability = 0x28;
+        m_layout.itemFlags = 0x14;
+        m_layout.recordQuality = 0x00;
+        m_layout.recordClass = 0x04;
+        m_layout.recordSubClass = 0x08;
+        m_layout.recordSellPrice = 0x0C;
+        m_layout.recordMaxStack = 0x10;
+        m_layout.recordItemLevel = 0x14;
+        m_layout.recordName = 0x18;
+
+        static const char* const kNames[] = { "Linen Cloth", "Copper Ore", "Minor Healing Potion", "Broken Fang" };
+        for (uint32_t i = 0; i < kInventoryItemCount; ++i)
+        {
+            const uintptr_t record = (uintptr_t)&m_records[i * 64];
+            SyntheticClient::Put<uint32_t>(record + m_layout.recordQuality, i % 5);
+            SyntheticClient::Put<uint32_t>(record + m_layout.recordSellPrice, 5 + i);
+            SyntheticClient::Put<uint32_t>(record + m_layout.recordMaxStack, 20);
+            SyntheticClient::Put<uintptr_t>(record + m_layout.recordName, (uintptr_t)kNames[i % 4]);
+            m_table[i] = record;
+        }
+
+        // Object 0 = player, 1-4 = bags, 5.. = items
+        const uintptr_t player = Descriptors(0);
+        uint32_t item = 5;
+        for (uint32_t s = 0; s < kInventoryPack; ++s)
+            SyntheticClient::Put<uint64_t>(player + m_layout.playerPackSlots + s * 8, Item(item++));
+        for (uint32_t b = 0; b < 4; ++b)
+        {
+            SyntheticClient::Put<uint64_t>(player + m_layout.playerBagSlots + b * 8, m_client.Guid(1 + b));
+            const uintptr_t bag = Descriptors(1 + b);
+            SyntheticClient::Put<uint32_t>(bag + m_layout.containerSlotCount, kInventoryBagSize);
+            for (uint32_t s = 0; s < kInventoryBagSize; ++s)
+                SyntheticClient::Put<uint64_t>(bag + m_layout.containerSlots + s * 8, Item(item++));
+        }
+
+        m_directory.Refresh(m_client.Manager());
+    }
+
+    const InventoryLayout& Layout() const { return m_layout; }
+    ObjectDirectory& Directory() { return m_directory; }
+    uint64_t PlayerGuid() const { return m_client.Guid(0); }
+    uintptr_t Descriptors(size_t i) const
+    {
+        return SyntheticClient::Get<uintptr_t>(m_client.Object(i) + m_client.Layout().objectDescriptors);
+    }
+
+private:
+    static ObjectListLayout ListLayout(const SyntheticLayout& l)
+    {
+        ObjectListLayout layout;
+        layout.managerFirstObject = l.managerFirstObject;
+        layout.managerCount = l.managerCount;
+        layout.objectNext = l.objectNext;
+        layout.objectGuid = l.objectGuid;
+        return layout;
+    }
+
+    // Turns object i into an item; returns its GUID
+    uint64_t Item(uint32_t i)
+    {
+        const uintptr_t d = Descriptors(i);
+        SyntheticClient::Put<uint32_t>(d + m_layout.itemEntry, kInventoryItemBase + (i * 7) % kInventoryItemCount);
+        SyntheticClient::Put<uint32_t>(d + m_layout.itemStackCount, 1 + i % 20);
+        SyntheticClient::Put<uint32_t>(d + m_layout.itemDurability, 0);
+        SyntheticClient::Put<uint32_t>(d + m_layout.itemFlags, 0);
+        return m_client.Guid(i);
+    }
+
+    SyntheticClient m_client;
+    ObjectDirectory m_directory;
+    InventoryLayout m_layout;
+    std::vector<uint8_t> m_records;
+    std::vector<uintptr_t> m_table;
+};
+
+static void InventoryCounters(BenchState& state, const InventorySnapshot& inventory)
+{
+    InventoryStats stats;
+    inventory.Stats(stats);
+    const double refreshes = stats.refreshes ? (double)stats.refreshes : 1.0;
+    state.SetCounter("items", stats.lastItems);
+    state.SetCounter("events_per_refresh", (double)stats.events / refreshes);
+    state.SetCounter("info_cached", stats.infoCached);
+}
+
+static void Inventory_RefreshUnchanged(BenchState& state)
+{
+    InventoryFixture fixture;
+    InventorySnapshot inventory(fixture.Layout());
+    TickArena arena;
+    InventoryEvent* events = nullptr;
+    inventory.Refresh(fixture.Directory(), fixture.PlayerGuid(), arena, events);
+    inventory.ResetStats();
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        BenchKeep(inventory.Refresh(fixture.Directory(), fixture.PlayerGuid(), arena, events));
+        arena.Reset();
+    }
+
+    state.SetItemsPerIteration(inventory.ItemCount());
+    InventoryCounters(state, inventory);
+}
+BENCH_CASE(Inventory_RefreshUnchanged, "inventory.refresh_unchanged", Bench_Default);
+
+static void Inventory_RefreshOneChange(BenchState& state)
+{
+    InventoryFixture fixture;
+    InventorySnapshot inventory(fixture.Layout());
+    TickArena arena;
+    InventoryEvent* events = nullptr;
+    inventory.Refresh(fixture.Directory(), fixture.PlayerGuid(), arena, events);
+    inventory.ResetStats();
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uintptr_t item = fixture.Descriptors(5 + i % 80) + fixture.Layout().itemStackCount;
+        SyntheticClient::Put<uint32_t>(item, SyntheticClient::Get<uint32_t>(item) ^ 1u);
+        BenchKeep(inventory.Refresh(fixture.Directory(), fixture.PlayerGuid(), arena, events));
+        arena.Reset();
+    }
+
+    InventoryCounters(state, inventory);
+}
+BENCH_CASE(Inventory_RefreshOneChange, "inventory.refresh_one_change", Bench_Default);
+
+static void Inventory_ItemInfo(BenchState& state)
+{
+    InventoryFixture fixture;
+    InventorySnapshot inventory(fixture.Layout());
+    ItemInfoCache& cache = inventory.Info();
+    for (uint32_t e = 0; e < kInventoryItemCount; ++e)
+        cache.Lookup(kInventoryItemBase + e);
+
+    uint64_t price = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        price += cache.Lookup(kInventoryItemBase + (uint32_t)((i * 131) % kInventoryItemCount))->sellPrice;
+    BenchKeep(price);
+}
+BENCH_CASE(Inventory_ItemInfo, "inventory.item_info", Bench_Default);
@@ -0,0 +1,129 @@
+﻿// BenchLogRing.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// LogRing benchmarks — push/pop cost, cross-thread handoff latency, and
+// multi-producer throughput
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "LogRing.h"
+#include "Platform.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const char kLine[] = "[12:34:56.789] [Bot] Casting Frostbolt on target 0xF130000012345678";
+
+// ───────────────────────────────────────────────────────────────
+// push_pop — uncontended push + pop on one thread (fast path cost)
+// ───────────────────────────────────────────────────────────────
+static void LogRing_PushPop(BenchState& state)
+{
+    LogRing ring(1024);
+    LogRecord record = LogRecord();
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        ring.TryPushStamped(i, LogSource_RemoteAchiko, kLine, sizeof(kLine) - 1);
+        ring.TryPop(record);
+        BenchKeep(record.length);
+    }
+    state.SetItemsPerIteration(1);
+    state.SetBytesPerIteration(sizeof(kLine) - 1);
+}
+BENCH_CASE(LogRing_PushPop, "logring.push_pop", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// handoff_latency — one record in flight; producer stamps, consumer
+// measures now - stamp. Ping-pong keeps the queue empty so the
+// number is pure handoff latency, not queueing delay.
+// ───────────────────────────────────────────────────────────────
+static void LogRing_HandoffLatency(BenchState& state)
+{
+    static const uint32_t kRecords = 10000;
+    LogRing ring(1024);
+    std::atomic<uint32_t> consumed(0);
+
+    state.ReserveSamples(kRecords);
+    uint32_t waitSpins = 0;
+
+    std::thread consumer([&]()
+    {
+        LogRecord record;
+        uint32_t spins = 0;
+        for (uint32_t n = 0; n < kRecords; )
+        {
+            if (ring.TryPop(record))
+            {
+                state.RecordSample(PlatformNowNs() - record.timestampNs);
+                consumed.store(++n, std::memory_order_release);
+                spins = 0;
+            }
+            else if (++spins > 1000)
+            {
+                PlatformYield();   // single-core hosts: let the producer run
+            }
+            else
+            {
+                PlatformCpuRelax();
+            }
+        }
+    });
+
+    for (uint32_t n = 0; n < kRecords; ++n)
+    {
+        ring.TryPush(LogSource_RemoteAchiko, kLine, sizeof(kLine) - 1);
+        waitSpins = 0;
+        while (consumed.load(std::memory_order_acquire) <= n)
+        {
+            if (++waitSpins > 1000)
+                PlatformYield();
+            else
+                PlatformCpuRelax();
+        }
+    }
+
+    consumer.join();
+}
+BENCH_CASE(LogRing_HandoffLatency, "logring.handoff_latency", Bench_Samples);
+
+// ───────────────────────────────────────────────────────────────
+// mpsc_4p — four producers hammer one ring, calling thread drains.
+// Producers retry on full so every record is delivered exactly once.
+// ───────────────────────────────────────────────────────────────
+static void LogRing_Mpsc4(BenchState& state)
+{
+    static const uint32_t kProducers = 4;
+    const uint64_t perProducer = state.Iterations() / kProducers + 1;
+    LogRing ring(4096);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p)
+    {
+        producers.push_back(std::thread([&ring, perProducer]()
+        {
+            for (uint64_t i = 0; i < perProducer; ++i)
+            {
+                while (!ring.TryPushStamped(i, LogSource_AchikoDLL, kLine, sizeof(kLine) - 1))
+                    PlatformYield();
+            }
+        }));
+    }
+
+    LogRecord record;
+    const uint64_t total = perProducer * kProducers;
+    for (uint64_t n = 0; n < total; )
+    {
+        if (ring.TryPop(record))
+            ++n;
+        else
+            PlatformYield();
+    }
+
+    for (size_t p = 0; p < producers.size(); ++p)
+        producers[p].join();
+
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(LogRing_Mpsc4, "logring.mpsc_4p", Bench_Default);
@@ -0,0 +1,197 @@
+﻿// BenchLogView.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Saved log viewer benchmarks — index build, window reads, source filter
+//
+// All cases share one generated 256 MB Achikobuddy.log-style file in the
+// temp directory (written once per run, deleted at exit; page cache warm
+// after the first case). count_newlines is the inner loop of the index
+// on one 64 KB block, for comparison with ingest.find_newline*.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "LogView.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+static const uint64_t kViewFileBytes = 256ull << 20;
+static const size_t kViewWindowLines = 60;               // one screen of the viewer
+static const uint32_t kViewWindowSamples = 2000;
+
+static const char* const kViewBodies[] =
+{
+    "[Main] Launcher: client 4812 ready (injected, CLR up, managed ready)",
+    "[AchikoDLL] [Combat] Frostbolt hit Defias Thug for 212 (crit)",
+    "[AchikoDLL] [Nav] Waypoint 14 reached, 37 remaining on path Westfall-3",
+    "[RemoteAchiko] [12:00:00.000] RemoteAchiko: CLR started successfully",
+    "[AchikoDLL] [PipeClient] Received command: START",
+};
+
+// ───────────────────────────────────────────────────────────────
+// ViewBenchFile — path of the shared file, generated on first use
+// ───────────────────────────────────────────────────────────────
+class ViewBenchFile
+{
+public:
+    ViewBenchFile() : m_lines(0)
+    {
+#ifdef _WIN32
+        wchar_t dir[MAX_PATH];
+        GetTempPathW(MAX_PATH, dir);
+        m_path = std::wstring(dir) + L"AchikoViewBench.log";
+        FILE* f = _wfopen(m_path.c_str(), L"wb");
+#else
+        const char* dir = getenv("TMPDIR");
+        m_path = std::string(dir && *dir ? dir : "/tmp") + "/AchikoViewBench.log";
+        FILE* f = fopen(m_path.c_str(), "wb");
+#endif
+        if (!f)
+            return;
+
+        std::string chunk;
+        char prefix[kLinePrefixLength];
+        uint32_t ms = 12u * 3600u * 1000u;
+        for (uint64_t written = 0; written < kViewFileBytes; written += chunk.size())
+        {
+            chunk.clear();
+            for (int i = 0; i < 4096; ++i, ++m_lines)
+            {
+                EncodeLinePrefix(prefix, ms++ % kMsPerDay);
+                chunk.append(prefix, kLinePrefixLength);
+                chunk.append(kViewBodies[m_lines % 5]);
+                chunk.append("\r\n");
+            }
+            fwrite(chunk.data(), 1, chunk.size(), f);
+        }
+        fclose(f);
+    }
+
+    ~ViewBenchFile()
+    {
+#ifdef _WIN32
+        _wremove(m_path.c_str());
+#else
+        remove(m_path.c_str());
+#endif
+    }
+
+    const ViewPathChar* Path() const { return m_path.c_str(); }
+    uint64_t Lines() const { return m_lines; }
+
+private:
+    std::basic_string<ViewPathChar> m_path;
+    uint64_t m_lines;
+};
+
+static const ViewBenchFile& BenchFile()
+{
+    static ViewBenchFile s_file;
+    return s_file;
+}
+
+// Open + wait for the index (the case under test does not time this)
+static bool OpenIndexed(LogView& view)
+{
+    if (!view.Open(BenchFile().Path()))
+        return false;
+    while (!view.Status().done)
+        PlatformSleepMs(1);
+    return true;
+}
+
+// ───────────────────────────────────────────────────────────────
+// count_newlines — SSE2 count over one 64 KB block
+// ───────────────────────────────────────────────────────────────
+static void View_CountNewlines(BenchState& state)
+{
+    std::string block;
+    for (uint32_t i = 0; block.size() < 64 * 1024; ++i)
+        block.append(kViewBodies[i % 5]).append("\r\n");
+    block.resize(64 * 1024);
+    const char* volatile start = block.data();
+    uint64_t lines = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        lines += CountNewlines(start, start + block.size());
+
+    BenchKeep(lines);
+    state.SetBytesPerIteration(block.size());
+}
+BENCH_CASE(View_CountNewlines, "view.count_newlines", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// index_256mb — Open() until the background index is done
+// ───────────────────────────────────────────────────────────────
+static void View_Index(BenchState& state)
+{
+    BenchFile();
+    uint64_t lines = 0;
+    size_t indexBytes = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        LogView view;
+        if (!OpenIndexed(view))
+            return;
+        lines += view.Status().lines;
+        indexBytes = (size_t)(view.Status().lines / kViewStrideLines + 1) * sizeof(uint64_t);
+    }
+
+    BenchKeep(lines);
+    state.SetBytesPerIteration(kViewFileBytes);
+    state.SetCounter("index_kb", indexBytes / 1024.0);
+}
+BENCH_CASE(View_Index, "view.index_256mb", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// window_read — random 60-line windows (what one scroll costs)
+// ───────────────────────────────────────────────────────────────
+static void View_WindowRead(BenchState& state)
+{
+    LogView view;
+    if (!OpenIndexed(view))
+        return;
+
+    const uint64_t lines = view.Status().lines;
+    ViewLine out[kViewWindowLines];
+    static char text[64 * 1024];
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    uint64_t got = 0;
+
+    state.ReserveSamples(kViewWindowSamples);
+    for (uint32_t i = 0; i < kViewWindowSamples; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t first = (seed >> 16) % (lines - kViewWindowLines);
+
+        const uint64_t t0 = PlatformNowNs();
+        got += view.Read(first, out, kViewWindowLines, text, sizeof(text));
+        state.RecordSample(PlatformNowNs() - t0);
+    }
+    BenchKeep(got);
+}
+BENCH_CASE(View_WindowRead, "view.window_read", Bench_Samples);
+
+// ───────────────────────────────────────────────────────────────
+// filter_parallel — "[AchikoDLL]" over the whole file; items = lines
+// ───────────────────────────────────────────────────────────────
+static void View_FilterParallel(BenchState& state)
+{
+    LogView view;
+    if (!OpenIndexed(view))
+        return;
+
+    static const char kPattern[] = "[AchikoDLL]";
+    uint64_t matches = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        matches += view.Filter(kPattern, sizeof(kPattern) - 1);
+
+    BenchKeep(matches);
+    state.SetItemsPerIteration(view.Status().lines);
+}
+BENCH_CASE(View_FilterParallel, "view.filter_parallel", Bench_Default);
@@ -0,0 +1,114 @@
+﻿// BenchMain.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// RemoteAchikoBench — command line entry point
+//
+// Usage:
+//   RemoteAchikoBench [--filter SUBSTR] [--reps N] [--min-time-ms MS]
+//                     [--out FILE|-] [--compare BASELINE.json]
+//                     [--threshold PCT] [--list]
+//
+// Exit codes:
+//   0 - success (no regressions beyond threshold)
+//   1 - one or more regressions beyond threshold
+//   2 - bad arguments / unreadable baseline / unwritable output
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "Usage: RemoteAchikoBench [options]\n"
+        "  --filter SUBSTR     run only cases whose name contains SUBSTR\n"
+        "  --reps N            repetitions per case (default 7)\n"
+        "  --min-time-ms MS    minimum time per repetition (default 20)\n"
+        "  --out FILE|-        write JSON results to FILE or stdout\n"
+        "  --compare FILE      compare against a baseline JSON file\n"
+        "  --threshold PCT     regression threshold in percent (default 15)\n"
+        "  --list              list registered cases and exit\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+
+        if (strcmp(arg, "--list") == 0)
+            options.list = true;
+        else if (strcmp(arg, "--filter") == 0 && hasValue)
+            options.filter = argv[++i];
+        else if (strcmp(arg, "--reps") == 0 && hasValue)
+            options.repetitions = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(arg, "--min-time-ms") == 0 && hasValue)
+            options.minTimeNs = strtoull(argv[++i], nullptr, 10) * 1000000ULL;
+        else if (strcmp(arg, "--out") == 0 && hasValue)
+            options.outPath = argv[++i];
+        else if (strcmp(arg, "--compare") == 0 && hasValue)
+            options.comparePath = argv[++i];
+        else if (strcmp(arg, "--threshold") == 0 && hasValue)
+            options.thresholdPct = strtod(argv[++i], nullptr);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (options.list)
+    {
+        for (size_t i = 0; i < BenchRegistry().size(); ++i)
+            printf("%s\n", BenchRegistry()[i].name);
+        return 0;
+    }
+
+    if (options.repetitions == 0)
+        options.repetitions = 1;
+
+    // Load the baseline first — a bad path should fail before minutes of runs
+    std::vector<BenchResult> baseline;
+    if (!options.comparePath.empty())
+    {
+        std::string error;
+        if (!BenchLoadJson(options.comparePath, baseline, error))
+        {
+            fprintf(stderr, "[bench] Cannot load baseline %s: %s\n", options.comparePath.c_str(), error.c_str());
+            return 2;
+        }
+    }
+
+    const std::vector<BenchResult> results = BenchRunAll(options);
+
+    if (!options.outPath.empty())
+    {
+        const std::string json = BenchToJson(results);
+        if (options.outPath == "-")
+        {
+            fwrite(json.data(), 1, json.size(), stdout);
+        }
+        else
+        {
+            FILE* f = fopen(options.outPath.c_str(), "wb");
+            if (!f)
+            {
+                fprintf(stderr, "[bench] Cannot write %s\n", options.outPath.c_str());
+                return 2;
+            }
+            fwrite(json.data(), 1, json.size(), f);
+            fclose(f);
+            fprintf(stderr, "[bench] Results written to %s\n", options.outPath.c_str());
+        }
+    }
+
+    if (!options.comparePath.empty())
+        return BenchCompare(baseline, results, options.thresholdPct) > 0 ? 1 : 0;
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+﻿// BenchMemory.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// MemoryRead benchmarks — guarded reads against the synthetic client
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "MemoryRead.h"
+#include "SyntheticClient.h"
+
+// ───────────────────────────────────────────────────────────────
+// pointer_chain_4 — slot → manager → first → next → next → descriptors
+// ───────────────────────────────────────────────────────────────
+static void Memory_PointerChain4(BenchState& state)
+{
+    SyntheticClient client(1024);
+    const SyntheticLayout& l = client.Layout();
+    const uint32_t offsets[] = { l.managerFirstObject, l.objectNext, l.objectNext, l.objectDescriptors };
+    uintptr_t out = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        ReadPointerChain(client.ManagerSlot(), offsets, 4, out);
+        BenchKeep(out);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Memory_PointerChain4, "memory.pointer_chain_4", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// walk_objects — follow the whole linked list (cache-missing hops)
+// ───────────────────────────────────────────────────────────────
+static void Memory_WalkObjects(BenchState& state)
+{
+    SyntheticClient client(4096);
+    const SyntheticLayout& l = client.Layout();
+    const uint32_t first[] = { l.managerFirstObject };
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        uintptr_t obj = 0;
+        size_t visited = 0;
+        if (ReadPointerChain(client.ManagerSlot(), first, 1, obj))
+        {
+            // Null next pointer ends the list (ReadPointerChain returns false)
+            do
+                ++visited;
+            while (visited < client.Count() && ReadPointerChain(obj + l.objectNext, nullptr, 0, obj));
+        }
+        BenchKeep(visited);
+    }
+    state.SetItemsPerIteration(client.Count());
+}
+BENCH_CASE(Memory_WalkObjects, "memory.walk_objects_4096", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// read_cstring — unit name read into a local buffer
+// ───────────────────────────────────────────────────────────────
+static void Memory_ReadCString(BenchState& state)
+{
+    SyntheticClient client(256);
+    const SyntheticLayout& l = client.Layout();
+    char name[64];
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uintptr_t address = SyntheticClient::Get<uintptr_t>(client.Object(i & 255) + l.objectName);
+        const size_t n = ReadCString(address, name, sizeof(name));
+        BenchKeep(n);
+    }
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Memory_ReadCString, "memory.read_cstring", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// safe_copy_descriptors — one full descriptor block per iteration
+// ───────────────────────────────────────────────────────────────
+static void Memory_SafeCopyDescriptors(BenchState& state)
+{
+    SyntheticClient client(256);
+    const SyntheticLayout& l = client.Layout();
+    uint8_t block[0x200];
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uintptr_t desc = SyntheticClient::Get<uintptr_t>(client.Object(i & 255) + l.objectDescriptors);
+        SafeCopy(block, (const void*)desc, l.descriptorSize);
+        BenchKeep(block[0]);
+    }
+    state.SetItemsPerIteration(1);
+    state.SetBytesPerIteration(l.descriptorSize);
+}
+BENCH_CASE(Memory_SafeCopyDescriptors, "memory.safe_copy_descriptors", Bench_Default);
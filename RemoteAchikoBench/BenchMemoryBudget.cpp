@@ -0,0 +1,85 @@
+﻿// BenchMemoryBudget.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Memory budget benchmarks — what the monitor thread pays per scan
+//
+// scan_self walks this process's real address map (VirtualQuery on
+// Windows, /proc/self/maps here). evaluate_4000 summarizes a synthetic
+// fragmented 32-bit map — 4000 regions, free space chopped into small
+// holes the way a long session leaves it — and reports the resulting
+// largest free block, fragmentation and pressure.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "MemoryMonitor.h"
+
+#include <vector>
+
+static const uint32_t kBudgetRegions = 4000;
+
+static void MemoryBudget_ScanSelf(BenchState& state)
+{
+    std::vector<MemoryRegion> regions;
+    regions.reserve(1024);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        MemoryMonitor::Scan(regions);
+        BenchKeep(regions.size());
+    }
+    state.SetCounter("regions", (double)regions.size());
+}
+BENCH_CASE(MemoryBudget_ScanSelf, "memory_budget.scan_self", Bench_Default);
+
+// 2 GB user space: alternating committed / free regions, free holes of
+// 64 KB – 1 MB with one 24 MB block left — low, not yet critical
+static void BuildFragmentedMap(std::vector<MemoryRegion>& regions)
+{
+    uint64_t base = 0x10000;
+    uint32_t seed = 0x9E3779B9u;
+    for (uint32_t i = 0; i < kBudgetRegions; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+
+        MemoryRegion r;
+        r.base = base;
+        r.state = (i & 1) ? MemState_Free : (i % 5 == 0 ? MemState_Reserved : MemState_Committed);
+        r.owner = (i % 97 == 0) ? MemOwner_Clr : MemOwner_Game;
+        if (r.state == MemState_Free)
+            r.size = (i == kBudgetRegions / 2 + 1) ? 24 * kMemoryMB : (uint64_t)(64 * 1024) << (seed % 5);
+        else
+            r.size = (uint64_t)(4096) << (seed % 9);
+        regions.push_back(r);
+        base += r.size;
+    }
+}
+
+static void MemoryBudget_Evaluate(BenchState& state)
+{
+    std::vector<MemoryRegion> regions;
+    BuildFragmentedMap(regions);
+
+    MemoryBudget budget;
+    budget.SetBudget(MemOwner_Arena, 16 * kMemoryMB);
+    budget.SetBudget(MemOwner_Cache, 64 * kMemoryMB);
+    budget.ReportUsage(MemOwner_Arena, 8 * kMemoryMB);
+    budget.ReportUsage(MemOwner_Cache, 96 * kMemoryMB);
+
+    uint64_t target = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        BenchKeep(budget.Evaluate(regions.data(), regions.size(), 0));
+        BenchKeep(budget.TakeTrim(MemOwner_Cache, target));
+    }
+    state.SetItemsPerIteration(kBudgetRegions);
+
+    MemorySummary s;
+    budget.Summary(s);
+    state.SetCounter("largest_free_mb", (double)s.largestFree / kMemoryMB);
+    state.SetCounter("free_mb", (double)s.freeBytes / kMemoryMB);
+    state.SetCounter("fragmentation_pm", (double)s.fragmentationPermille);
+    state.SetCounter("pressure", (double)s.pressure);
+    state.SetCounter("cache_target_mb", (double)target / kMemoryMB);
+}
+BENCH_CASE(MemoryBudget_Evaluate, "memory_budget.evaluate_4000", Bench_Default);
@@ -0,0 +1,94 @@
+﻿// BenchObjects.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// ObjectDirectory benchmarks — full walk vs validating last tick's list
+//
+// full_walk is the from-scratch enumeration every tick (Invalidate first),
+// validate the steady state where nothing changed. churn reuses one
+// object's memory every 16th tick (new GUID at the same address) — the
+// validation fails and falls back to a walk, so the counters show what the
+// saving shrinks to when the list is not static.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "ObjectDirectory.h"
+#include "SyntheticClient.h"
+
+static const uint32_t kDirectoryObjects = 4096;
+
+static ObjectListLayout ListLayout(const SyntheticLayout& l)
+{
+    ObjectListLayout layout;
+    layout.managerFirstObject = l.managerFirstObject;
+    layout.managerCount = l.managerCount;
+    layout.objectNext = l.objectNext;
+    layout.objectGuid = l.objectGuid;
+    return layout;
+}
+
+static void DirectoryCounters(BenchState& state, const ObjectDirectory& directory)
+{
+    ObjectDirectoryStats stats;
+    directory.Stats(stats);
+    const double ticks = stats.ticks ? (double)stats.ticks : 1.0;
+    state.SetCounter("nodes_walked_per_tick", (double)stats.nodesWalked / ticks);
+    state.SetCounter("full_walk_pct", 100.0 * (double)stats.fullWalks / ticks);
+    state.SetCounter("saved_us_per_tick", (double)stats.savedNs / ticks / 1e3);
+}
+
+static void Objects_FullWalk(BenchState& state)
+{
+    SyntheticClient client(kDirectoryObjects);
+    ObjectDirectory directory(ListLayout(client.Layout()));
+    size_t seen = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        directory.Invalidate();
+        seen += directory.Refresh(client.Manager());
+    }
+
+    BenchKeep(seen);
+    state.SetItemsPerIteration(kDirectoryObjects);
+    DirectoryCounters(state, directory);
+}
+BENCH_CASE(Objects_FullWalk, "objects.full_walk_4096", Bench_Default);
+
+static void Objects_Validate(BenchState& state)
+{
+    SyntheticClient client(kDirectoryObjects);
+    ObjectDirectory directory(ListLayout(client.Layout()));
+    directory.Refresh(client.Manager());
+    size_t seen = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        seen += directory.Refresh(client.Manager());
+
+    BenchKeep(seen);
+    state.SetItemsPerIteration(kDirectoryObjects);
+    DirectoryCounters(state, directory);
+}
+BENCH_CASE(Objects_Validate, "objects.validate_4096", Bench_Default);
+
+static void Objects_Churn(BenchState& state)
+{
+    SyntheticClient client(kDirectoryObjects);
+    const SyntheticLayout& l = client.Layout();
+    ObjectDirectory directory(ListLayout(l));
+    uint64_t reused = 0xF140000000000000ULL;
+    size_t seen = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        if ((i & 15) == 0)
+            SyntheticClient::Put<uint64_t>(client.Object((size_t)(i * 7919) % kDirectoryObjects) + l.objectGuid, ++reused);
+        seen += directory.Refresh(client.Manager());
+    }
+
+    BenchKeep(seen);
+    state.SetItemsPerIteration(kDirectoryObjects);
+    DirectoryCounters(state, directory);
+}
+BENCH_CASE(Objects_Churn, "objects.churn_4096", Bench_Default);
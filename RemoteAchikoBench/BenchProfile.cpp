@@ -0,0 +1,83 @@
+﻿// BenchProfile.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// StackProfile benchmarks — per-sample aggregation and per-frame lookup
+//
+// aggregate_* is what the sampler pays after resuming a thread (the part
+// of a pass that is not the OS suspend/context round trip). lookup is the
+// per-unique-address cost at dump time.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "StackProfile.h"
+
+#include <stdio.h>
+
+// ───────────────────────────────────────────────────────────────
+// MakeStacks — 64 distinct 24-deep stacks sharing a common root,
+// like a bot loop sampled in a handful of leaf functions
+// ───────────────────────────────────────────────────────────────
+static void MakeStacks(std::vector<uintptr_t>& frames, uint32_t depth, uint32_t stacks)
+{
+    frames.resize((size_t)depth * stacks);
+    for (uint32_t s = 0; s < stacks; ++s)
+    {
+        for (uint32_t d = 0; d < depth; ++d)
+        {
+            // Leaf-first: the deepest frames differ, the root is shared
+            const uint32_t fromRoot = depth - 1 - d;
+            const uintptr_t variant = fromRoot < depth - 4 ? 0 : s;
+            frames[(size_t)s * depth + d] = 0x00400000 + fromRoot * 0x1000 + variant * 0x10;
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────
+// aggregate_hot — 24-frame sample into an existing stack (steady state)
+// ───────────────────────────────────────────────────────────────
+static void Profile_AggregateHot(BenchState& state)
+{
+    const uint32_t depth = 24, stacks = 64;
+    std::vector<uintptr_t> frames;
+    MakeStacks(frames, depth, stacks);
+
+    StackAggregator aggregator;
+    for (uint32_t s = 0; s < stacks; ++s)
+        aggregator.Add(1, &frames[(size_t)s * depth], depth);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        aggregator.Add(1, &frames[(size_t)(i & (stacks - 1)) * depth], depth);
+
+    state.SetItemsPerIteration(1);
+    state.SetCounter("unique", (double)aggregator.UniqueStacks());
+}
+BENCH_CASE(Profile_AggregateHot, "profile.aggregate_hot", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// symbol_lookup — address → name over 10k export-like symbols
+// ───────────────────────────────────────────────────────────────
+static void Profile_SymbolLookup(BenchState& state)
+{
+    const uint32_t symbols = 10000;
+    SymbolTable table;
+    char name[32];
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        snprintf(name, sizeof(name), "mod!fn%u", i);
+        table.Add(0x10000000 + (uintptr_t)i * 0x100, 0, name);
+    }
+    table.Seal();
+
+    uint64_t found = 0;
+    uint32_t x = 12345;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        const uintptr_t address = 0x10000000 + (uintptr_t)(x % (symbols * 0x100));
+        found += table.Find(address, 0x4000) != nullptr;
+    }
+    BenchKeep(found);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Profile_SymbolLookup, "profile.symbol_lookup", Bench_Default);
@@ -0,0 +1,23 @@
+﻿// BenchScheduler.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// TickPacer benchmark — wake-up jitter at a 5 ms tick
+//
+// Samples are lateness (wake time - deadline). The spin tail keeps p50
+// near zero; p99 shows how often the OS sleep overshoots the spin budget.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "TickPacer.h"
+
+static void Scheduler_TickJitter5ms(BenchState& state)
+{
+    static const uint32_t kTicks = 200;
+    TickPacer pacer(5000000ULL);
+
+    state.ReserveSamples(kTicks);
+    for (uint32_t t = 0; t < kTicks; ++t)
+        state.RecordSample(pacer.WaitNext());
+
+    state.SetCounter("skipped_ticks", (double)pacer.SkippedTicks());
+}
+BENCH_CASE(Scheduler_TickJitter5ms, "scheduler.tick_jitter_5ms", Bench_Samples);
@@ -0,0 +1,156 @@
+﻿// BenchWatch.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Process watcher benchmarks — model cost and OS event → diff latency
+//
+// model_drain is the consumer-side cost of one UI refresh.
+// exec_to_diff / exit_to_diff run real child processes through the Linux
+// backend (netlink, needs root) and time spawn / kill until the consumer
+// holds the Added / Removed diff — the latency the Launcher list now has
+// instead of "up to one second".
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "ClientModel.h"
+
+#ifdef __linux__
+#include "ProcessWatch.h"
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+static const uint32_t kWatchClients = 8;
+
+// ───────────────────────────────────────────────────────────────
+// model_drain — 8 clients start, each walks the bootstrap stages,
+// one drain (coalesces to 8 Added diffs)
+// ───────────────────────────────────────────────────────────────
+static void Watch_ModelDrain(BenchState& state)
+{
+    ClientModel model;
+    ClientDiff diffs[2 * kWatchClients];
+    uint64_t drained = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        const uint32_t base = (uint32_t)(i * kWatchClients) % 60000 + 100;
+        for (uint32_t c = 0; c < kWatchClients; ++c)
+        {
+            model.OnProcessStarted(base + c, Attach_None);
+            for (uint32_t stage = Bootstrap_Injected; stage <= Bootstrap_PipesConnected; ++stage)
+                model.SetBootstrap(base + c, stage);
+        }
+        drained += model.Drain(diffs, 2 * kWatchClients);
+
+        for (uint32_t c = 0; c < kWatchClients; ++c)
+            model.OnProcessExited(base + c);
+        drained += model.Drain(diffs, 2 * kWatchClients);
+    }
+
+    BenchKeep(drained);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Watch_ModelDrain, "watch.model_drain", Bench_Default);
+
+#ifdef __linux__
+
+static const int kWatchSpawns = 32;
+static const char* kWatchImage = "achikowatchbenc";   // comm is 15 chars max
+
+// ───────────────────────────────────────────────────────────────
+// SpawnWatched — fork + exec /bin/sleep under the watched comm name
+// (comm comes from the exec'd path, so a symlink renames it)
+// ───────────────────────────────────────────────────────────────
+static pid_t SpawnWatched(const char* link)
+{
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        execl(link, kWatchImage, "30", (char*)nullptr);
+        _exit(127);
+    }
+    return child;
+}
+
+// WaitForDiff — consumer loop until the diff for pid arrives (5 s cap)
+static bool WaitForDiff(ClientModel& model, uint32_t kind, pid_t pid)
+{
+    ClientDiff diffs[16];
+    const uint64_t deadline = PlatformNowNs() + 5000000000ULL;
+    while (PlatformNowNs() < deadline)
+    {
+        const size_t count = model.Wait(diffs, 16, 100);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (diffs[i].kind == kind && diffs[i].pid == (uint32_t)pid)
+                return true;
+        }
+    }
+    return false;
+}
+
+static void RunSpawnCycle(BenchState& state, bool measureExit)
+{
+    char link[64];
+    snprintf(link, sizeof(link), "/tmp/%s", kWatchImage);
+    unlink(link);
+    if (symlink("/bin/sleep", link) != 0)
+    {
+        fprintf(stderr, "watch: cannot create %s - skipped\n", link);
+        return;
+    }
+
+    ProcessWatch watch;
+    if (!watch.Start(kWatchImage))
+    {
+        fprintf(stderr, "watch: netlink proc connector unavailable (needs root) - skipped\n");
+        unlink(link);
+        return;
+    }
+
+    state.ReserveSamples(kWatchSpawns);
+    for (int i = 0; i < kWatchSpawns; ++i)
+    {
+        uint64_t startNs = PlatformNowNs();
+        const pid_t child = SpawnWatched(link);
+        if (child <= 0)
+            break;
+
+        const bool added = WaitForDiff(watch.Model(), ClientDiff_Added, child);
+        if (added && !measureExit)
+            state.RecordSample(PlatformNowNs() - startNs);
+
+        startNs = PlatformNowNs();
+        kill(child, SIGKILL);
+        const bool removed = WaitForDiff(watch.Model(), ClientDiff_Removed, child);
+        if (added && removed && measureExit)
+            state.RecordSample(PlatformNowNs() - startNs);
+        waitpid(child, nullptr, 0);
+    }
+
+    watch.Stop();
+    unlink(link);
+}
+
+// ───────────────────────────────────────────────────────────────
+// exec_to_diff — fork() until the consumer holds the Added diff
+// (includes fork + exec of the child itself)
+// ───────────────────────────────────────────────────────────────
+static void Watch_ExecToDiff(BenchState& state)
+{
+    RunSpawnCycle(state, false);
+}
+BENCH_CASE(Watch_ExecToDiff, "watch.exec_to_diff", Bench_Samples);
+
+// ───────────────────────────────────────────────────────────────
+// exit_to_diff — kill() until the consumer holds the Removed diff
+// ───────────────────────────────────────────────────────────────
+static void Watch_ExitToDiff(BenchState& state)
+{
+    RunSpawnCycle(state, true);
+}
+BENCH_CASE(Watch_ExitToDiff, "watch.exit_to_diff", Bench_Samples);
+
+#endif // __linux__
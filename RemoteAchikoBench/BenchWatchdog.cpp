@@ -0,0 +1,57 @@
+﻿// BenchWatchdog.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// Heartbeat benchmarks — what the watchdog costs the watched threads
+//
+// beat is paid by every watched loop iteration (must stay a plain store).
+// scan is the watchdog thread's cost per poll over all slots.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "Heartbeat.h"
+
+// ───────────────────────────────────────────────────────────────
+// beat — owner-side store into its slot
+// ───────────────────────────────────────────────────────────────
+static void Watchdog_Beat(BenchState& state)
+{
+    static HeartbeatSlot slot;
+    slot.generation.store(1, std::memory_order_relaxed);
+
+    uint32_t counter = 0;
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        slot.Beat(++counter);
+
+    BenchKeep(slot.beat.load(std::memory_order_relaxed));
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Watchdog_Beat, "watchdog.beat", Bench_Default);
+
+// ───────────────────────────────────────────────────────────────
+// scan — one poll over 16 live slots, all beating (steady state)
+// ───────────────────────────────────────────────────────────────
+static void Watchdog_Scan(BenchState& state)
+{
+    static HeartbeatSlot slots[kHeartbeatMaxSlots];
+    for (uint32_t i = 0; i < kHeartbeatMaxSlots; ++i)
+    {
+        slots[i].beat.store(0, std::memory_order_relaxed);
+        slots[i].timeoutMs = kHeartbeatDefaultTimeoutMs;
+        slots[i].generation.store(2 * i + 1, std::memory_order_relaxed);
+    }
+
+    HangDetector detector;
+    HangEvent events[kHeartbeatMaxSlots];
+    uint64_t reported = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        slots[i & (kHeartbeatMaxSlots - 1)].Beat((uint32_t)i);
+        reported += detector.Scan(slots, i, events);
+    }
+
+    BenchKeep(reported);
+    state.SetItemsPerIteration(1);
+}
+BENCH_CASE(Watchdog_Scan, "watchdog.scan", Bench_Default);
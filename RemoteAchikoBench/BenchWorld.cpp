@@ -0,0 +1,199 @@
+﻿// BenchWorld.cpp
+// ─────────────────────────────────────────────────────────────────────────────
+// World knowledge store benchmarks — queries against a long-lived store
+//
+// All cases share one store in the temp directory, filled once per run
+// with 200k sightings over 4 continents (mob spawns of 2000 entries,
+// vendors, herbs) through Record() and background compaction, then
+// compacted into a single mapped base. Queries run from random points.
+// open_200k is a fresh session: map the base, replay (empty) logs, start
+// the compactor — what startup pays, independent of the store's size.
+// ─────────────────────────────────────────────────────────────────────────────
+
+#include "Bench.h"
+#include "WorldStore.h"
+
+#include <stdlib.h>
+
+static const uint32_t kWorldMaps = 4;
+static const float kWorldExtent = 16000.0f;               // yards per continent side
+static const uint32_t kWorldSpawns = 190000;
+static const uint32_t kWorldVendors = 2000;
+static const uint32_t kWorldHerbs = 8000;
+static const uint32_t kWorldEntries = 2000;
+
+static uint32_t WorldRandom(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float WorldCoord(uint32_t& seed)
+{
+    return (float)(WorldRandom(seed) % 1000000u) * (kWorldExtent / 1000000.0f);
+}
+
+// ───────────────────────────────────────────────────────────────
+// WorldBenchStore — the shared, filled store (built on first use)
+// ───────────────────────────────────────────────────────────────
+class WorldBenchStore
+{
+public:
+    WorldBenchStore()
+    {
+#ifdef _WIN32
+        wchar_t dir[MAX_PATH];
+        GetTempPathW(MAX_PATH, dir);
+        m_dir = std::wstring(dir) + L"AchikoWorldBench";
+#else
+        const char* dir = getenv("TMPDIR");
+        m_dir = std::string(dir && *dir ? dir : "/tmp") + "/AchikoWorldBench";
+#endif
+        Clear();
+        m_store.Open(m_dir.c_str());
+
+        uint32_t seed = 0x5EED1234u;
+        const uint32_t total = kWorldSpawns + kWorldVendors + kWorldHerbs;
+        for (uint32_t i = 0; i < total; ++i)
+        {
+            WorldSighting s;
+            memset(&s, 0, sizeof(s));
+            s.map = i % kWorldMaps;
+            s.kind = i < kWorldSpawns ? WorldKind_MobSpawn
+                : i < kWorldSpawns + kWorldVendors ? WorldKind_Vendor
+                : WorldKind_Herb;
+            s.entry = 1 + WorldRandom(seed) % kWorldEntries;
+            s.x = WorldCoord(seed);
+            s.y = WorldCoord(seed);
+            s.seenAt = 1700000000u + i;
+            m_store.Record(s);
+        }
+        m_store.CompactNow();
+
+        WorldStoreStats stats;
+        m_store.Stats(stats);
+        m_compactNs = stats.lastCompactNs;
+    }
+
+    ~WorldBenchStore()
+    {
+        m_store.Close();
+        Clear();
+    }
+
+    WorldStore& Store() { return m_store; }
+    const WorldPathChar* Dir() const { return m_dir.c_str(); }
+    uint64_t CompactNs() const { return m_compactNs; }
+
+private:
+    void Clear()
+    {
+        const char* const extensions[] = { "dat", "log", "tmp" };
+        for (size_t e = 0; e < 3; ++e)
+        {
+            const std::vector<uint32_t> files = WorldListFiles(m_dir, extensions[e]);
+            for (size_t i = 0; i < files.size(); ++i)
+                WorldDeleteFile(WorldFileName(m_dir, files[i], extensions[e]));
+        }
+    }
+
+    WorldPath m_dir;
+    WorldStore m_store;
+    uint64_t m_compactNs;
+};
+
+static WorldBenchStore& SharedWorld()
+{
+    static WorldBenchStore s_world;
+    return s_world;
+}
+
+static void World_NearestVendor(BenchState& state)
+{
+    WorldStore& store = SharedWorld().Store();
+    uint32_t seed = 42;
+    uint64_t found = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        WorldSighting s;
+        found += store.Nearest((uint32_t)(i % kWorldMaps), WorldKind_Vendor, 0,
+                               WorldCoord(seed), WorldCoord(seed), 5000.0f, s) ? 1 : 0;
+    }
+    BenchKeep(found);
+    state.SetCounter("miss_rate", 1.0 - (double)found / (double)state.Iterations());
+}
+BENCH_CASE(World_NearestVendor, "world.nearest_vendor", Bench_Default);
+
+static void World_NearestSpawnEntry(BenchState& state)
+{
+    WorldStore& store = SharedWorld().Store();
+    uint32_t seed = 7;
+    uint64_t found = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        WorldSighting s;
+        const uint32_t entry = 1 + WorldRandom(seed) % kWorldEntries;
+        found += store.Nearest((uint32_t)(i % kWorldMaps), WorldKind_MobSpawn, entry,
+                               WorldCoord(seed), WorldCoord(seed), 4000.0f, s) ? 1 : 0;
+    }
+    BenchKeep(found);
+}
+BENCH_CASE(World_NearestSpawnEntry, "world.nearest_spawn_entry", Bench_Default);
+
+static void World_RadiusHerbs(BenchState& state)
+{
+    WorldStore& store = SharedWorld().Store();
+    WorldSighting out[64];
+    uint32_t seed = 99;
+    uint64_t hits = 0;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        hits += store.QueryRadius((uint32_t)(i % kWorldMaps), WorldKind_Herb, 0,
+                                  WorldCoord(seed), WorldCoord(seed), 500.0f, out, 64);
+    }
+    BenchKeep(hits);
+}
+BENCH_CASE(World_RadiusHerbs, "world.radius_herbs_500", Bench_Default);
+
+// A spot seen again within the refresh window: lookup only, not logged
+static void World_RecordKnown(BenchState& state)
+{
+    WorldStore& store = SharedWorld().Store();
+
+    WorldSighting s;
+    memset(&s, 0, sizeof(s));
+    s.map = 1;
+    s.kind = WorldKind_MobSpawn;
+    s.entry = 77;
+    s.x = 5000.0f;
+    s.y = 5000.0f;
+    s.seenAt = 1800000000u;
+    store.Record(s);
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+        BenchKeep(store.Record(s));
+}
+BENCH_CASE(World_RecordKnown, "world.record_known", Bench_Default);
+
+static void World_Open(BenchState& state)
+{
+    WorldBenchStore& shared = SharedWorld();
+    WorldStore session;
+
+    state.ResetTimer();
+    for (uint64_t i = 0; i < state.Iterations(); ++i)
+    {
+        session.Open(shared.Dir());
+        session.Close();
+    }
+
+    state.SetCounter("compact_ms", shared.CompactNs() / 1e6);
+}
+BENCH_CASE(World_Open, "world.open_200k", Bench_Default);
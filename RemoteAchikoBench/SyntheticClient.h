@@ -0,0 +1,157 @@
+﻿// SyntheticClient.h
+// ─────────────────────────────────────────────────────────────────────────────
+// Synthetic stand-in for the game client's memory — benchmark fixture
+//
+// Responsibilities:
+// • Builds an object manager + linked list of objects inside one arena
+// • Each object has a GUID, a type, a descriptor block and a name string
+// • Objects are scattered (shuffled) so list walks miss cache like the
+//   real client does
+// • Exposes a static "manager slot" so pointer chains start from a fixed
+//   address, exactly like a client global
+//
+// Architecture:
+// • Offsets come from SyntheticLayout — they describe THIS fixture only,
+//   not any real client build
+// • Pointers are native-width (8 bytes on the x64 bench, 4 on x86)
+//
+// Critical Design Decisions:
+// • Deterministic (fixed seed) — runs are comparable against baselines
+// • Whole arena is one std::vector — no dangling pointers between cases
+// ─────────────────────────────────────────────────────────────────────────────
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+struct SyntheticLayout
+{
+    uint32_t managerFirstObject;   // manager → first object pointer
+    uint32_t managerCount;         // manager → object count (uint32)
+    uint32_t objectNext;           // object → next object pointer
+    uint32_t objectGuid;           // object → uint64 GUID
+    uint32_t objectType;           // object → uint32 type id
+    uint32_t objectDescriptors;    // object → descriptor block pointer
+    uint32_t objectName;           // object → name string pointer
+    uint32_t objectSize;           // bytes reserved per object
+    uint32_t descriptorSize;       // bytes per descriptor block
+};
+
+class SyntheticClient
+{
+public:
+    static SyntheticLayout DefaultLayout()
+    {
+        SyntheticLayout l;
+        l.managerFirstObject = 0x10;
+        l.managerCount = 0x18;
+        l.objectNext = 0x20;
+        l.objectGuid = 0x30;
+        l.objectType = 0x38;
+        l.objectDescriptors = 0x40;
+        l.objectName = 0x48;
+        l.objectSize = 0x100;
+        l.descriptorSize = 0x200;
+        return l;
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Constructor — build `count` objects with fixed seed
+    // ───────────────────────────────────────────────────────────────
+    explicit SyntheticClient(uint32_t count, uint32_t seed = 0xAC41C0u)
+        : m_layout(DefaultLayout()), m_rng(seed)
+    {
+        const size_t objBytes = (size_t)count * m_layout.objectSize;
+        const size_t descBytes = (size_t)count * m_layout.descriptorSize;
+        const size_t nameBytes = (size_t)count * 32;
+        m_arena.assign(256 + objBytes + descBytes + nameBytes, 0);
+
+        uint8_t* base = m_arena.data();
+        m_managerSlot = (uintptr_t)base;         // static global holding the manager pointer
+        m_manager = (uintptr_t)(base + 64);      // manager struct
+
+        // Shuffle placement so list order != memory order
+        std::vector<uint32_t> place(count);
+        for (uint32_t i = 0; i < count; ++i)
+            place[i] = i;
+        for (uint32_t i = count; i > 1; --i)
+            std::swap(place[i - 1], place[Next() % i]);
+
+        uint8_t* objects = base + 256;
+        uint8_t* descriptors = objects + objBytes;
+        char* names = (char*)(descriptors + descBytes);
+
+        m_objects.resize(count);
+        m_guids.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uintptr_t obj = (uintptr_t)(objects + (size_t)place[i] * m_layout.objectSize);
+            const uintptr_t desc = (uintptr_t)(descriptors + (size_t)place[i] * m_layout.descriptorSize);
+            char* name = names + (size_t)place[i] * 32;
+
+            m_objects[i] = obj;
+            m_guids[i] = 0xF130000000000000ULL | ((uint64_t)(Next() & 0xFFFF) << 24) | (i + 1);
+
+            Put<uint64_t>(obj + m_layout.objectGuid, m_guids[i]);
+            Put<uint32_t>(obj + m_layout.objectType, 3 + (i % 3));
+            Put<uintptr_t>(obj + m_layout.objectDescriptors, desc);
+            Put<uintptr_t>(obj + m_layout.objectName, (uintptr_t)name);
+
+            snprintf(name, 32, "Synthetic Unit %u", i);
+            for (uint32_t f = 0; f < m_layout.descriptorSize / 4; ++f)
+                Put<uint32_t>(desc + f * 4, Next());
+        }
+
+        Relink();
+        Put<uintptr_t>(m_managerSlot, m_manager);
+    }
+
+    // ───────────────────────────────────────────────────────────────
+    // Relink — rebuild next pointers and count from m_objects order
+    // ───────────────────────────────────────────────────────────────
+    void Relink()
+    {
+        for (size_t i = 0; i < m_objects.size(); ++i)
+        {
+            const uintptr_t next = (i + 1 < m_objects.size()) ? m_objects[i + 1] : 0;
+            Put<uintptr_t>(m_objects[i] + m_layout.objectNext, next);
+        }
+        Put<uintptr_t>(m_manager + m_layout.managerFirstObject, m_objects.empty() ? 0 : m_objects[0]);
+        Put<uint32_t>(m_manager + m_layout.managerCount, (uint32_t)m_objects.size());
+    }
+
+    const SyntheticLayout& Layout() const { return m_layout; }
+    uintptr_t ManagerSlot() const { return m_managerSlot; }
+    uintptr_t Manager() const { return m_manager; }
+    size_t Count() const { return m_objects.size(); }
+    uintptr_t Object(size_t i) const { return m_objects[i]; }
+    uint64_t Guid(size_t i) const { return m_guids[i]; }
+    std::vector<uintptr_t>& Objects() { return m_objects; }
+
+    uint32_t Next()
+    {
+        m_rng ^= m_rng << 13;
+        m_rng ^= m_rng >> 17;
+        m_rng ^= m_rng << 5;
+        return m_rng;
+    }
+
+    template <class T>
+    static void Put(uintptr_t address, T value) { memcpy((void*)address, &value, sizeof(T)); }
+
+    template <class T>
+    static T Get(uintptr_t address) { T v; memcpy(&v, (const void*)address, sizeof(T)); return v; }
+
+private:
+    SyntheticLayout m_layout;
+    uint32_t m_rng;
+    std::vector<uint8_t> m_arena;
+    uintptr_t m_managerSlot;
+    uintptr_t m_manager;
+    std::vector<uintptr_t> m_objects;   // list order
+    std::vector<uint64_t> m_guids;      // by list index at construction
+};